@@ -14,6 +14,9 @@
 
 //#include "ablgen.h"
 #include "ablexec.h"
+#include "ablimage.h"
+#include "ablnative.h"
+#include "ablprof.h"
 //#include "ablsymt.h"
 //#include "ablenv.h"
 //#include "abldbug.h"
@@ -80,6 +83,10 @@ void ABLi_setRandomCallbacks(void (*seedRandomCallback)(size_t seed), int32_t (*
 void ABLi_setDebugPrintCallback(void (*ABLDebugPrintCallback)(const std::wstring_view& s));
 void ABLi_setGetTimeCallback(size_t (*ABLGetTimeCallback)(void));
 void ABLi_setEndlessStateCallback(void (*endlessStateCallback)(UserFile* log));
+void ABLi_setCompiledModuleCache(bool enabled, bool (*imageExistsCallback)(const std::wstring_view& fileName));
+void ABLi_getCompiledModuleStats(ABLImageStats* stats);
+void ABLi_registerNativeModule(const ABLNativeModule* nativeModule);
+void ABLi_getNativeModuleStats(ABLNativeStats* stats);
 
 wchar_t ABLi_popChar(void);
 int32_t ABLi_popInteger(void);
@@ -118,6 +125,21 @@ void ABLi_resetOrders(void);
 int32_t ABLi_getCurrentState(void);
 void ABLi_transState(int32_t newState);
 
+ABLExecContext* ABLi_createExecContext(int32_t commandBufferSize);
+void ABLi_destroyExecContext(ABLExecContext* context);
+ABLExecContext* ABLi_setExecContext(ABLExecContext* context);
+void ABLi_seedExecContext(ABLExecContext* context, uint32_t seed);
+void ABLi_resetExecContext(ABLExecContext* context, ABLCommandBuffer* commandBuffer, uint32_t seed);
+ABLCommandBuffer* ABLi_createCommandBuffer(int32_t size);
+void ABLi_destroyCommandBuffer(ABLCommandBuffer* buffer);
+int32_t ABLi_applyDeferredCalls(ABLCommandBuffer* commandBuffer);
+void ABLi_setFunctionMode(const std::wstring_view& name, FunctionMode mode, int32_t deferredResult = 0);
+
+void ABLi_enableProfiler(bool enabled, int32_t sampleInterval = ABL_PROFILE_DEFAULT_INTERVAL);
+void ABLi_resetProfiler(void);
+void ABLi_closeProfiler(void);
+int32_t ABLi_writeProfile(const std::wstring_view& stacksFileName, const std::wstring_view& tableFileName, int32_t topN = 50);
+
 //***************************************************************************
 
 } // namespace mclib::abl
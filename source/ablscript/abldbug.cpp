@@ -22,19 +22,12 @@ namespace mclib::abl {
 //----------
 // EXTERNALS
 
-extern int32_t level;
-extern int32_t execLineNumber;
 // extern int32_t				execStatementCount;
-extern TokenCodeType codeToken;
 
 extern const std::wstring_view& codeBuffer;
 extern const std::wstring_view& codeBufferPtr;
-extern const std::wstring_view& codeSegmentPtr;
-extern const std::wstring_view& statementStartPtr;
 
-extern const std::unique_ptr<StackItem>& tos;
 // extern const std::unique_ptr<StackItem>&		stackFrameBasePtr;
-extern const std::unique_ptr<SymTableNode>& CurRoutineIdPtr;
 extern const std::unique_ptr<SymTableNode>& symTableDisplay[];
 
 extern int32_t errorCount;
@@ -66,7 +59,6 @@ extern const std::wstring_view& TokenStrings[NUM_TOKENS];
 
 // extern StackItem*		stack;
 // extern const std::unique_ptr<StackItem>&		stackFrameBasePtr;
-extern const std::unique_ptr<StackItem>& StaticDataPtr;
 // extern const std::unique_ptr<SymTableNode>&	CurRoutineIdPtr;
 
 // extern int32_t				MaxLoopIterations;
@@ -600,7 +592,7 @@ Debugger::sprintStatement(const std::wstring_view& dest)
 	// First, rebuild the the current statement from the module code. Then,
 	// spit it out as we do so...
 	bool done = false;
-	const std::wstring_view& cp = statementStartPtr;
+	const std::wstring_view& cp = CurContext->statementStartPtr;
 	do
 	{
 		TokenCodeType token = (TokenCodeType)*cp;
@@ -723,8 +715,8 @@ Debugger::sprintSimpleValue(const std::wstring_view& dest, const std::unique_ptr
 		{
 		case VAR_TYPE_NORMAL:
 		{
-			const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)stackFrameBasePtr;
-			int32_t delta = level - symbol->level;
+			const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)CurContext->stackFrameBasePtr;
+			int32_t delta = CurContext->level - symbol->level;
 			while (delta-- > 0)
 				headerPtr = (const std::unique_ptr<StackFrameHeader>&)headerPtr->staticLink.address;
 			dataPtr = (const std::unique_ptr<StackItem>&)headerPtr + symbol->defn.info.data.offset;
@@ -734,7 +726,7 @@ Debugger::sprintSimpleValue(const std::wstring_view& dest, const std::unique_ptr
 			dataPtr = (const std::unique_ptr<StackItem>&)stack + symbol->defn.info.data.offset;
 			break;
 		case VAR_TYPE_STATIC:
-			dataPtr = (const std::unique_ptr<StackItem>&)StaticDataPtr + symbol->defn.info.data.offset;
+			dataPtr = (const std::unique_ptr<StackItem>&)CurContext->staticDataPtr + symbol->defn.info.data.offset;
 			break;
 		}
 		//---------------------------------------------------------------
@@ -779,8 +771,8 @@ Debugger::sprintArrayValue(const std::wstring_view& dest, const std::unique_ptr<
 		{
 		case VAR_TYPE_NORMAL:
 		{
-			const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)stackFrameBasePtr;
-			int32_t delta = level - symbol->level;
+			const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)CurContext->stackFrameBasePtr;
+			int32_t delta = CurContext->level - symbol->level;
 			while (delta-- > 0)
 				headerPtr = (const std::unique_ptr<StackFrameHeader>&)headerPtr->staticLink.address;
 			dataPtr = (const std::unique_ptr<StackItem>&)headerPtr + symbol->defn.info.data.offset;
@@ -790,7 +782,7 @@ Debugger::sprintArrayValue(const std::wstring_view& dest, const std::unique_ptr<
 			dataPtr = (const std::unique_ptr<StackItem>&)stack + symbol->defn.info.data.offset;
 			break;
 		case VAR_TYPE_STATIC:
-			dataPtr = (const std::unique_ptr<StackItem>&)StaticDataPtr + symbol->defn.info.data.offset;
+			dataPtr = (const std::unique_ptr<StackItem>&)CurContext->staticDataPtr + symbol->defn.info.data.offset;
 			break;
 		}
 		const std::unique_ptr<Type>& ptype = (const std::unique_ptr<Type>&)(symbol->ptype);
@@ -844,7 +836,7 @@ Debugger::sprintValue(const std::wstring_view& dest, const std::wstring_view& ex
 	{
 		//------------------------------------------
 		// Probably a simple variable or constant...
-		const std::unique_ptr<SymTableNode>& symbol = debugModule->findSymbol(exprString, CurRoutineIdPtr);
+		const std::unique_ptr<SymTableNode>& symbol = debugModule->findSymbol(exprString, CurContext->routineIdPtr);
 		if (!symbol)
 			return (1);
 		if (symbol->ptype->form != FRM_ARRAY)
@@ -862,7 +854,7 @@ Debugger::sprintValue(const std::wstring_view& dest, const std::wstring_view& ex
 		wchar_t subscriptString[255];
 		strcpy(subscriptString, subscript);
 		*subscript = nullptr;
-		const std::unique_ptr<SymTableNode>& symbol = debugModule->findSymbol(exprString, CurRoutineIdPtr);
+		const std::unique_ptr<SymTableNode>& symbol = debugModule->findSymbol(exprString, CurContext->routineIdPtr);
 		if (!symbol)
 			return (1);
 		sprintArrayValue(dest, symbol, subscriptString);
@@ -871,7 +863,7 @@ Debugger::sprintValue(const std::wstring_view& dest, const std::wstring_view& ex
 	{
 		//-------------------------
 		// Print the whole thing...
-		const std::unique_ptr<SymTableNode>& symbol = debugModule->findSymbol(exprString, CurRoutineIdPtr);
+		const std::unique_ptr<SymTableNode>& symbol = debugModule->findSymbol(exprString, CurContext->routineIdPtr);
 		if (!symbol)
 			return (1);
 		sprintArrayValue(dest, symbol, nullptr);
@@ -891,10 +883,10 @@ Debugger::traceStatementExecution(void)
 	// Do we have a breakpoint on this line?
 	if (breakPointManager)
 	{
-		if (breakPointManager->isBreakPoint(execLineNumber))
+		if (breakPointManager->isBreakPoint(CurContext->execLineNumber))
 		{
 			sprintf(message, "HIT BP: (%d) %s [%d]", module->getId(), module->getName(),
-				execLineNumber);
+				CurContext->execLineNumber);
 			print(message);
 			halt = true;
 		}
@@ -959,13 +951,13 @@ Debugger::traceDataStore(
 		sprintDataValue(valString, target, targetType);
 		if (idType->form == FRM_ARRAY)
 			sprintf(message, "STORE: (%d) %s [%d] -> %s[#] = %s\n", module->getId(),
-				module->getName(), execLineNumber, id->name, valString);
+				module->getName(), CurContext->execLineNumber, id->name, valString);
 		// else if (idType->form == FRM_RECORD)
 		//	sprintf(message, "STORE AT LINE %d - %s.# = %s\n", execLineNumber,
 		// id->name, valString);
 		else
 			sprintf(message, "STORE: (%d) %s [%d] -> %s = %s\n", module->getId(), module->getName(),
-				execLineNumber, id->name, valString);
+				CurContext->execLineNumber, id->name, valString);
 		print(message);
 		if (((WatchPtr)id->info)->breakOnStore)
 			debugMode();
@@ -985,13 +977,13 @@ Debugger::traceDataFetch(const std::unique_ptr<SymTableNode>& id, const std::uni
 		sprintDataValue(valString, data, idType);
 		if (idTypePtr->form == FRM_ARRAY)
 			sprintf(message, "FETCH: (%d) %s [%d] - %s[#] = %s\n", module->getId(),
-				module->getName(), execLineNumber, id->name, valString);
+				module->getName(), CurContext->execLineNumber, id->name, valString);
 		// else if (idTypePtr->form == FRM_RECORD)
 		//	sprintf(message, "STORE AT LINE %d - %s.# = %s\n", id->name,
 		// valString);
 		else
 			sprintf(message, "FETCH: (%d) %s [%d] - %s = %s\n", module->getId(), module->getName(),
-				execLineNumber, id->name, valString);
+				CurContext->execLineNumber, id->name, valString);
 		print(message);
 		if (((WatchPtr)id->info)->breakOnFetch)
 			debugMode();
@@ -1019,8 +1011,8 @@ Debugger::showValue(void)
 		const std::unique_ptr<Type>& ptype = expression();
 		if (errorCount > 0)
 			return;
-		const std::wstring_view& savedCodeSegmentPtr = codeSegmentPtr;
-		TokenCodeType savedCodeToken = codeToken;
+		const std::wstring_view& savedCodeSegmentPtr = CurContext->codeSegmentPtr;
+		TokenCodeType savedCodeToken = CurContext->codeToken;
 		execExpression();
 		if (ptype->form == FRM_ARRAY)
 		{
@@ -1029,13 +1021,13 @@ Debugger::showValue(void)
 		else
 		{
 			wchar_t message[255];
-			sprintDataValue(message, tos, ptype);
+			sprintDataValue(message, CurContext->tos, ptype);
 			strcat(message, "\n");
 			print(message);
 		}
 		pop();
-		codeSegmentPtr = savedCodeSegmentPtr;
-		codeToken = savedCodeToken;
+		CurContext->codeSegmentPtr = savedCodeSegmentPtr;
+		CurContext->codeToken = savedCodeToken;
 	}
 }
 
@@ -1059,16 +1051,16 @@ Debugger::assignVariable(void)
 			return;
 		//-------------------
 		// Now, execute it...
-		const std::wstring_view& savedCodeSegmentPtr = codeSegmentPtr;
-		int32_t savedCodeToken = codeToken;
-		codeSegmentPtr = codeBuffer + 1;
+		const std::wstring_view& savedCodeSegmentPtr = CurContext->codeSegmentPtr;
+		int32_t savedCodeToken = CurContext->codeToken;
+		CurContext->codeSegmentPtr = codeBuffer + 1;
 		getCodeToken();
 		idPtr = getSymTableCodePtr();
 		execAssignmentStatement(idPtr);
 		//----------------------------
 		// Restore the code segment...
-		codeSegmentPtr = savedCodeSegmentPtr;
-		codeToken = savedCodeToken;
+		CurContext->codeSegmentPtr = savedCodeSegmentPtr;
+		CurContext->codeToken = savedCodeToken;
 	}
 #endif
 }
@@ -32,28 +32,20 @@ ABLi_loadLibrary(const std::wstring_view& sourceFileName, int32_t* numErrors = n
 // EXTERNAL variables
 extern int32_t lineNumber;
 extern int32_t errorCount;
-extern int32_t execStatementCount;
 
 extern TokenCodeType curToken;
 extern wchar_t wordString[];
 extern const std::unique_ptr<SymTableNode>& symTableDisplay[];
-extern int32_t level;
 extern bool blockFlag;
 extern BlockType blockType;
 extern bool printFlag;
 extern const std::unique_ptr<SymTableNode>& CurModuleIdPtr;
-extern const std::unique_ptr<SymTableNode>& CurRoutineIdPtr;
-extern int32_t CurModuleHandle;
-extern bool CallModuleInit;
-extern int32_t FileNumber;
 
 extern Type DummyType;
 extern const std::wstring_view& codeBuffer;
 extern const std::wstring_view& codeBufferPtr;
 extern StackItem* stack;
 // extern StackItem*		eternalStack;
-extern const std::unique_ptr<StackItem>& tos;
-extern const std::unique_ptr<StackItem>& stackFrameBasePtr;
 extern int32_t eternalOffset;
 
 extern TokenCodeType statementStartList[];
@@ -81,10 +73,6 @@ extern const std::unique_ptr<Type>& IntegerTypePtr;
 extern const std::unique_ptr<Type>& RealTypePtr;
 extern const std::unique_ptr<Type>& BooleanTypePtr;
 
-extern uint32_t* OrderCompletionFlags;
-extern const std::unique_ptr<StackItem>& StaticDataPtr;
-extern StackItem returnValue;
-
 extern const std::unique_ptr<Debugger>& debugger;
 extern int32_t* EternalVariablesSizes;
 
@@ -101,17 +89,12 @@ int32_t NumModulesRegistered = 0;
 int32_t NumModuleInstances = 0;
 int32_t MaxWatchesPerModule = 20;
 int32_t MaxBreakPointsPerModule = 20;
-const std::unique_ptr<ABLModule>& CurModule = nullptr;
-const std::unique_ptr<ABLModule>& CurFSM = nullptr;
 const std::unique_ptr<ABLModule>& CurLibrary = nullptr;
 const std::unique_ptr<ABLModule>&* LibraryInstanceRegistry = nullptr;
-int32_t NumStateTransitions = 0;
 int32_t MaxLibraries = 0;
-bool NewStateSet = false;
 extern int32_t numLibrariesLoaded;
 
 extern int32_t NumExecutions;
-int32_t CallStackLevel = 0;
 
 #define MAX_PROFILE_LINELEN 128
 #define MAX_PROFILE_LINES 256
@@ -541,7 +524,7 @@ ABLModule::init(int32_t moduleHandle)
 		if (!startState)
 		{
 			wchar_t err[255];
-			sprintf(err, "ABL: FSM has no Start state [%s]", CurModule->getName());
+			sprintf(err, "ABL: FSM has no Start state [%s]", CurContext->module->getName());
 			ABL_Fatal(0, err);
 		}
 		prevState = nullptr;
@@ -739,6 +722,14 @@ ABLModule::isLibrary(void)
 
 //---------------------------------------------------------------------------
 
+bool
+ABLModule::isMainThreadOnly(void)
+{
+	return (ModuleRegistry[handle].mainThreadOnly);
+}
+
+//---------------------------------------------------------------------------
+
 void
 ABLModule::resetOrderCallFlags(void)
 {
@@ -796,37 +787,42 @@ ABLModule::getStateHandle(void)
 int32_t
 ABLModule::execute(const std::unique_ptr<ABLParam>& paramList)
 {
-	CurModule = this;
+	CurContext->module = this;
 	if (debugger)
 		debugger->setModule(this);
 	//--------------------------
 	// Execute the ABL module...
 	const std::unique_ptr<SymTableNode>& moduleIdPtr = ModuleRegistry[handle].moduleIdPtr;
 	if (moduleIdPtr->defn.info.routine.flags & ROUTINE_FLAG_FSM)
-		CurFSM = this;
+		CurContext->fsm = this;
 	else
-		CurFSM = nullptr;
-	NumStateTransitions = 0;
+		CurContext->fsm = nullptr;
+	CurContext->numStateTransitions = 0;
 	//--------------------------------------------
 	// Point to this module's static data space...
-	StaticDataPtr = staticData;
-	OrderCompletionFlags = orderCallFlags;
+	CurContext->staticDataPtr = staticData;
+	CurContext->orderCompletionFlags = orderCallFlags;
 	//---------------------------------
 	// Init some important variables...
-	CurModuleIdPtr = nullptr;
-	CurRoutineIdPtr = nullptr;
-	FileNumber = -1;
-	errorCount = 0;
-	execStatementCount = 0;
-	NumExecutions++;
+	if (CurContext == &MainExecContext)
+	{
+		//---------------------------------------------------
+		// Worker contexts leave the compiler's state alone...
+		CurModuleIdPtr = nullptr;
+		errorCount = 0;
+		NumExecutions++;
+	}
+	CurContext->routineIdPtr = nullptr;
+	CurContext->fileNumber = -1;
+	CurContext->execStatementCount = 0;
 	//------------------
 	// Init the stack...
-	stackFrameBasePtr = tos = (stack + eternalOffset);
+	CurContext->stackFrameBasePtr = CurContext->tos = getRuntimeStackBase();
 	//---------------------------------------
 	// Initialize the module's stack frame...
-	level = 1;
-	CallStackLevel = 0;
-	stackFrameBasePtr = tos + 1;
+	CurContext->level = 1;
+	CurContext->callStackLevel = 0;
+	CurContext->stackFrameBasePtr = CurContext->tos + 1;
 	//-------------------------
 	// Function return value...
 	pushInteger(0);
@@ -881,7 +877,7 @@ ABLModule::execute(const std::unique_ptr<ABLParam>& paramList)
 					// way to keep it clear. Once it's verified to work,
 					// optimize...
 					int32_t size = formalTypePtr->size;
-					const std::wstring_view& dest = (const std::wstring_view&)ABLStackMallocCallback((size_t)size);
+					const std::wstring_view& dest = (const std::wstring_view&)runtimeMalloc((size_t)size);
 					if (!dest)
 					{
 						wchar_t err[255];
@@ -891,10 +887,10 @@ ABLModule::execute(const std::unique_ptr<ABLParam>& paramList)
 							id);
 						ABL_Fatal(0, err);
 					}
-					const std::wstring_view& src = tos->address;
+					const std::wstring_view& src = CurContext->tos->address;
 					const std::wstring_view& savePtr = dest;
 					memcpy(dest, src, size);
-					tos->address = savePtr;
+					CurContext->tos->address = savePtr;
 				}
 			}
 			else
@@ -913,17 +909,21 @@ ABLModule::execute(const std::unique_ptr<ABLParam>& paramList)
 			curParam++;
 		}
 	}
-	CurModuleHandle = handle;
+	CurContext->moduleHandle = handle;
 	//--------------------------------------------------------------------
 	// No init function in FSM. Put all init stuff into the start state...
-	CallModuleInit = !initCalled;
+	CurContext->callModuleInit = !initCalled;
 	initCalled = true;
-	NewStateSet = false;
+	CurContext->newStateSet = false;
+	if (ProfilerEnabled)
+		profileModuleBegin();
 	::execute(moduleIdPtr);
-	memcpy(&returnVal, &returnValue, sizeof(StackItem));
+	if (ProfilerEnabled)
+		profileModuleEnd();
+	memcpy(&returnVal, &CurContext->returnValue, sizeof(StackItem));
 	//-----------
 	// Summary...
-	return (execStatementCount);
+	return (CurContext->execStatementCount);
 }
 
 //---------------------------------------------------------------------------
@@ -931,38 +931,43 @@ ABLModule::execute(const std::unique_ptr<ABLParam>& paramList)
 int32_t
 ABLModule::execute(const std::unique_ptr<ABLParam>& moduleParamList, const std::unique_ptr<SymTableNode>& functionIdPtr)
 {
-	CurModule = this;
+	CurContext->module = this;
 	if (debugger)
 		debugger->setModule(this);
 	//--------------------------
 	// Execute the ABL module...
 	const std::unique_ptr<SymTableNode>& moduleIdPtr = ModuleRegistry[handle].moduleIdPtr;
 	if (moduleIdPtr->defn.info.routine.flags & ROUTINE_FLAG_FSM)
-		CurFSM = this;
+		CurContext->fsm = this;
 	else
-		CurFSM = nullptr;
-	NumStateTransitions = 0;
+		CurContext->fsm = nullptr;
+	CurContext->numStateTransitions = 0;
 	//--------------------------------------------
 	// Point to this module's static data space...
-	StaticDataPtr = staticData;
-	OrderCompletionFlags = orderCallFlags;
+	CurContext->staticDataPtr = staticData;
+	CurContext->orderCompletionFlags = orderCallFlags;
 	//---------------------------------
 	// Init some important variables...
-	CurModuleIdPtr = nullptr;
-	CurRoutineIdPtr = nullptr;
-	FileNumber = -1;
-	errorCount = 0;
-	execStatementCount = 0;
-	NumExecutions++;
-	NewStateSet = false;
+	if (CurContext == &MainExecContext)
+	{
+		//---------------------------------------------------
+		// Worker contexts leave the compiler's state alone...
+		CurModuleIdPtr = nullptr;
+		errorCount = 0;
+		NumExecutions++;
+	}
+	CurContext->routineIdPtr = nullptr;
+	CurContext->fileNumber = -1;
+	CurContext->execStatementCount = 0;
+	CurContext->newStateSet = false;
 	//------------------
 	// Init the stack...
-	stackFrameBasePtr = tos = (stack + eternalOffset);
+	CurContext->stackFrameBasePtr = CurContext->tos = getRuntimeStackBase();
 	//---------------------------------------
 	// Initialize the module's stack frame...
-	level = 1;
-	CallStackLevel = 0;
-	stackFrameBasePtr = tos + 1;
+	CurContext->level = 1;
+	CurContext->callStackLevel = 0;
+	CurContext->stackFrameBasePtr = CurContext->tos + 1;
 	//-------------------------
 	// Function return value...
 	pushInteger(0);
@@ -1017,7 +1022,7 @@ ABLModule::execute(const std::unique_ptr<ABLParam>& moduleParamList, const std::
 					// way to keep it clear. Once it's verified to work,
 					// optimize...
 					int32_t size = formalTypePtr->size;
-					const std::wstring_view& dest = (const std::wstring_view&)ABLStackMallocCallback((size_t)size);
+					const std::wstring_view& dest = (const std::wstring_view&)runtimeMalloc((size_t)size);
 					if (!dest)
 					{
 						wchar_t err[255];
@@ -1027,10 +1032,10 @@ ABLModule::execute(const std::unique_ptr<ABLParam>& moduleParamList, const std::
 							id);
 						ABL_Fatal(0, err);
 					}
-					const std::wstring_view& src = tos->address;
+					const std::wstring_view& src = CurContext->tos->address;
 					const std::wstring_view& savePtr = dest;
 					memcpy(dest, src, size);
-					tos->address = savePtr;
+					CurContext->tos->address = savePtr;
 				}
 			}
 			else
@@ -1047,14 +1052,18 @@ ABLModule::execute(const std::unique_ptr<ABLParam>& moduleParamList, const std::
 			curParam++;
 		}
 	}
-	CurModuleHandle = handle;
-	CallModuleInit = !initCalled;
+	CurContext->moduleHandle = handle;
+	CurContext->callModuleInit = !initCalled;
 	initCalled = true;
+	if (ProfilerEnabled)
+		profileModuleBegin();
 	::executeChild(moduleIdPtr, functionIdPtr);
-	memcpy(&returnVal, &returnValue, sizeof(StackItem));
+	if (ProfilerEnabled)
+		profileModuleEnd();
+	memcpy(&returnVal, &CurContext->returnValue, sizeof(StackItem));
 	//-----------
 	// Summary...
-	return (execStatementCount);
+	return (CurContext->execStatementCount);
 }
 
 //---------------------------------------------------------------------------
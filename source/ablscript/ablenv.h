@@ -121,6 +121,7 @@ struct ModuleEntry
 	const std::unique_ptr<ABLModule>&* librariesUsed;
 	int32_t numStaticVars;
 	int32_t numOrderCalls;
+	bool mainThreadOnly; // calls a main thread function, or writes shared vars
 	int32_t numStateHandles;
 	const std::unique_ptr<StateHandleInfo>& stateHandles;
 	int32_t* sizeStaticVars;
@@ -178,6 +179,7 @@ public:
 	const std::unique_ptr<SymTableNode>& getState(void) { return (state); }
 	int32_t getStateHandle(void);
 	bool isLibrary(void);
+	bool isMainThreadOnly(void);
 	void resetOrderCallFlags(void);
 	void setOrderCallFlag(uint8_t dword, uint8_t bit);
 	void clearOrderCallFlag(uint8_t orderDWord, uint8_t orderBitMask);
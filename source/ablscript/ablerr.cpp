@@ -20,11 +20,9 @@ namespace mclib::abl {
 //----------
 // EXTERNALS
 extern const std::wstring_view& tokenp;
-extern int32_t execLineNumber;
 extern int32_t lineNumber;
 extern int32_t FileNumber;
 extern wchar_t SourceFiles[MAX_SOURCE_FILES][MAXLEN_FILENAME];
-extern const std::unique_ptr<ABLModule>& CurModule;
 extern wchar_t wordString[];
 
 //---------------------------------------------------------------------------
@@ -65,7 +63,7 @@ const std::wstring_view& syntaxErrorMessages[] = {"No syntax error", // 0
 
 const std::wstring_view& runtimeErrorMessages[] = {"Runtime stack overflow", "Infinite Loop", "Nested function call",
 	"Unimplemented feature", "value out of range", "Division by zero", "Invalid function argument",
-	"Invalid case value", "Abort", "No Previous State"};
+	"Invalid case value", "Abort", "No Previous State", "Shared variable written off the main context"};
 
 //---------------------------------------------------------------------------
 
@@ -126,19 +124,19 @@ runtimeError(int32_t errCode)
 	{
 		sprintf(message, "RUNTIME ERROR:  [%d] %s", errCode, runtimeErrorMessages[errCode]);
 		debugger->print(message);
-		sprintf(message, "MODULE %s", CurModule->getName());
+		sprintf(message, "MODULE %s", CurContext->module->getName());
 		debugger->print(message);
-		if (FileNumber > -1)
-			sprintf(message, "FILE %s", CurModule->getSourceFile(FileNumber));
+		if (CurContext->fileNumber > -1)
+			sprintf(message, "FILE %s", CurContext->module->getSourceFile(CurContext->fileNumber));
 		else
 			sprintf(message, "FILE %s: unavailable");
 		debugger->print(message);
-		sprintf(message, "LINE %d", execLineNumber);
+		sprintf(message, "LINE %d", CurContext->execLineNumber);
 		debugger->print(message);
 		debugger->debugMode();
 	}
 	sprintf(message, "ABL RUNTIME ERROR %s [line %d] - (type %d) %s\n",
-		(FileNumber > -1) ? CurModule->getSourceFile(FileNumber) : "unavailable", execLineNumber,
+		(CurContext->fileNumber > -1) ? CurContext->module->getSourceFile(CurContext->fileNumber) : "unavailable", CurContext->execLineNumber,
 		errCode, runtimeErrorMessages[errCode]);
 	ABL_Fatal(-ABL_ERR_RUNTIME_ABORT, message);
 }
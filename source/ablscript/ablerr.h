@@ -106,6 +106,7 @@ enum class RuntimeErrorType : uint32_t
 	ABL_ERR_RUNTIME_INVALID_CASE_VALUE,
 	ABL_ERR_RUNTIME_ABORT,
 	ABL_ERR_RUNTIME_NULL_PREVSTATE,
+	ABL_ERR_RUNTIME_SHARED_WRITE,
 	NUM_ABL_RUNTIME_ERRORS
 } RuntimeErrorType;
 
@@ -22,18 +22,8 @@ namespace mclib::abl {
 // GLOBALS
 const std::wstring_view& codeBuffer = nullptr;
 const std::wstring_view& codeBufferPtr = nullptr;
-const std::wstring_view& codeSegmentPtr = nullptr;
-const std::wstring_view& codeSegmentLimit = nullptr;
-const std::wstring_view& statementStartPtr = nullptr;
-
-TokenCodeType codeToken;
-int32_t execLineNumber;
-int32_t execStatementCount = 0;
 
 StackItem* stack = nullptr;
-const std::unique_ptr<StackItem>& tos = nullptr;
-const std::unique_ptr<StackItem>& stackFrameBasePtr = nullptr;
-const std::unique_ptr<StackItem>& StaticDataPtr = nullptr;
 int32_t* StaticVariablesSizes = nullptr;
 int32_t* EternalVariablesSizes = nullptr;
 int32_t eternalOffset = 0;
@@ -41,11 +31,11 @@ int32_t MaxStaticVariables = 0;
 int32_t MaxEternalVariables = 0;
 int32_t NumStaticVariables = 0;
 int32_t NumOrderCalls = 1;
+int32_t NumMainThreadCalls = 0;
+int32_t NumSharedWrites = 0;
 int32_t NumStateHandles = 0;
 StateHandleInfo StateHandleList[MAX_STATE_HANDLES_PER_MODULE];
-int32_t CurModuleHandle = 0;
 int32_t MaxCodeBufferSize = 0;
-bool CallModuleInit = false;
 bool AutoReturnFromOrders = false;
 int32_t MaxLoopIterations = 100001;
 bool AssertEnabled = false;
@@ -56,35 +46,30 @@ bool IncludeDebugInfo = true;
 bool ProfileABL = false;
 bool Crunch = true;
 
-wchar_t SetStateDebugStr[256];
+ABLExecContext MainExecContext;
+thread_local ABLExecContext* CurContext = &MainExecContext;
+
+//--------------------------------------------------------------------
+// The heap callbacks aren't reentrant, so array storage grabbed while
+// a worker context runs goes through this lock...
+std::mutex RuntimeHeapLock;
 
 //----------
 // EXTERNALS
 
-extern const std::unique_ptr<SymTableNode>& CurRoutineIdPtr;
-
 extern const std::unique_ptr<ModuleEntry>& ModuleRegistry;
 extern const std::unique_ptr<ABLModule>&* ModuleInstanceRegistry;
-extern const std::unique_ptr<ABLModule>& CurModule;
 extern const std::unique_ptr<ABLModule>& CurLibrary;
-extern int32_t NumStateTransitions;
 
 extern TokenCodeType curToken;
 extern int32_t lineNumber;
 extern int32_t FileNumber;
-extern int32_t level;
 extern const std::unique_ptr<Type>& IntegerTypePtr;
 extern const std::unique_ptr<Type>& CharTypePtr;
 extern const std::unique_ptr<Type>& RealTypePtr;
 extern const std::unique_ptr<Type>& BooleanTypePtr;
 
-extern StackItem returnValue;
-
-extern bool ExitWithReturn;
-extern bool ExitFromTacOrder;
-
 extern const std::unique_ptr<Debugger>& debugger;
-extern bool NewStateSet;
 
 extern void (*ABLEndlessStateCallback)(UserFile* log);
 
@@ -117,6 +102,7 @@ crunchSymTableNodePtr(const std::unique_ptr<SymTableNode>& nodePtr)
 		syntaxError(ABL_ERR_SYNTAX_CODE_SEGMENT_OVERFLOW);
 	else
 	{
+		recordCodeRelocation(codeBufferPtr - codeBuffer);
 		const std::unique_ptr<SymTableNode>&* nodePtrPtr = (const std::unique_ptr<SymTableNode>&*)codeBufferPtr;
 		*nodePtrPtr = nodePtr;
 		codeBufferPtr += sizeof(const std::unique_ptr<SymTableNode>&);
@@ -135,6 +121,7 @@ crunchStatementMarker(void)
 	else
 	{
 		wchar_t saveCode = *(--codeBufferPtr);
+		Address markerPtr = codeBufferPtr;
 		*codeBufferPtr = (wchar_t)TKN_STATEMENT_MARKER;
 		codeBufferPtr++;
 		if (IncludeDebugInfo)
@@ -144,6 +131,7 @@ crunchStatementMarker(void)
 			*((int32_t*)codeBufferPtr) = lineNumber;
 			codeBufferPtr += sizeof(int32_t);
 		}
+		shiftCodeRelocations(markerPtr - codeBuffer, codeBufferPtr - markerPtr);
 		*codeBufferPtr = saveCode;
 		codeBufferPtr++;
 	}
@@ -164,6 +152,7 @@ uncrunchStatementMarker(void)
 	//-------------------------------------
 	// Pull statement marker off the buffer
 	codeBufferPtr--;
+	truncateCodeRelocations(codeBufferPtr - codeBuffer);
 }
 
 //***************************************************************************
@@ -184,6 +173,7 @@ crunchAddressMarker(Address address)
 		saveCodeBufferPtr = codeBufferPtr;
 		*((Address*)codeBufferPtr) = address;
 		codeBufferPtr += sizeof(Address);
+		shiftCodeRelocations(saveCodeBufferPtr - 1 - codeBuffer, codeBufferPtr - saveCodeBufferPtr + 1);
 		*codeBufferPtr = saveCode;
 		codeBufferPtr++;
 	}
@@ -261,6 +251,10 @@ createCodeSegment(int32_t& codeSegmentSize)
 		ABL_Fatal(0, " ABL: Unable to AblCodeHeap->malloc code segment ");
 	for (size_t i = 0; i < codeSegmentSize; i++)
 		codeSegment[i] = codeBuffer[i];
+	//------------------------------------------------------------
+	// Hang onto where the symbol pointers landed, in case we're
+	// asked to write a compiled image of this module...
+	bindCodeRelocations(codeSegment, codeSegmentSize);
 	codeBufferPtr = codeBuffer;
 	return (codeSegment);
 }
@@ -270,9 +264,9 @@ createCodeSegment(int32_t& codeSegmentSize)
 const std::unique_ptr<SymTableNode>&
 getCodeSymTableNodePtr(void)
 {
-	const std::unique_ptr<SymTableNode>&* nodePtrPtr = (const std::unique_ptr<SymTableNode>&*)codeSegmentPtr;
+	const std::unique_ptr<SymTableNode>&* nodePtrPtr = (const std::unique_ptr<SymTableNode>&*)CurContext->codeSegmentPtr;
 	const std::unique_ptr<SymTableNode>& nodePtr = *nodePtrPtr;
-	codeSegmentPtr += sizeof(const std::unique_ptr<SymTableNode>&);
+	CurContext->codeSegmentPtr += sizeof(const std::unique_ptr<SymTableNode>&);
 	return (nodePtr);
 }
 
@@ -284,14 +278,14 @@ getCodeStatementMarker(void)
 	//------------------------------------------
 	// NOTE: If there's a problem, we return -1.
 	int32_t lineNum = -1;
-	if (codeToken == TKN_STATEMENT_MARKER)
+	if (CurContext->codeToken == TKN_STATEMENT_MARKER)
 	{
 		if (IncludeDebugInfo)
 		{
-			FileNumber = *((uint8_t*)codeSegmentPtr);
-			codeSegmentPtr += sizeof(uint8_t);
-			lineNum = *((int32_t*)codeSegmentPtr);
-			codeSegmentPtr += sizeof(int32_t);
+			CurContext->fileNumber = *((uint8_t*)CurContext->codeSegmentPtr);
+			CurContext->codeSegmentPtr += sizeof(uint8_t);
+			lineNum = *((int32_t*)CurContext->codeSegmentPtr);
+			CurContext->codeSegmentPtr += sizeof(int32_t);
 		}
 	}
 	return (lineNum);
@@ -303,10 +297,10 @@ const std::wstring_view&
 getCodeAddressMarker(void)
 {
 	Address address = nullptr;
-	if (codeToken == TKN_ADDRESS_MARKER)
+	if (CurContext->codeToken == TKN_ADDRESS_MARKER)
 	{
-		address = *((int32_t*)codeSegmentPtr) + codeSegmentPtr - 1;
-		codeSegmentPtr += sizeof(Address);
+		address = *((int32_t*)CurContext->codeSegmentPtr) + CurContext->codeSegmentPtr - 1;
+		CurContext->codeSegmentPtr += sizeof(Address);
 	}
 	return (address);
 }
@@ -316,8 +310,8 @@ getCodeAddressMarker(void)
 int32_t
 getCodeInteger(void)
 {
-	int32_t value = *((int32_t*)codeSegmentPtr);
-	codeSegmentPtr += sizeof(int32_t);
+	int32_t value = *((int32_t*)CurContext->codeSegmentPtr);
+	CurContext->codeSegmentPtr += sizeof(int32_t);
 	return (value);
 }
 
@@ -326,8 +320,8 @@ getCodeInteger(void)
 uint8_t
 getCodeByte(void)
 {
-	uint8_t value = *((uint8_t*)codeSegmentPtr);
-	codeSegmentPtr += sizeof(uint8_t);
+	uint8_t value = *((uint8_t*)CurContext->codeSegmentPtr);
+	CurContext->codeSegmentPtr += sizeof(uint8_t);
 	return (value);
 }
 
@@ -336,8 +330,8 @@ getCodeByte(void)
 const std::wstring_view&
 getCodeAddress(void)
 {
-	Address address = *((int32_t*)codeSegmentPtr) + codeSegmentPtr - 1;
-	codeSegmentPtr += sizeof(int32_t);
+	Address address = *((int32_t*)CurContext->codeSegmentPtr) + CurContext->codeSegmentPtr - 1;
+	CurContext->codeSegmentPtr += sizeof(int32_t);
 	return (address);
 }
 
@@ -348,7 +342,7 @@ getCodeAddress(void)
 void
 pop(void)
 {
-	--tos;
+	--CurContext->tos;
 }
 
 //***************************************************************************
@@ -356,8 +350,8 @@ pop(void)
 void
 getCodeToken(void)
 {
-	codeToken = (TokenCodeType)*codeSegmentPtr;
-	codeSegmentPtr++;
+	CurContext->codeToken = (TokenCodeType)*CurContext->codeSegmentPtr;
+	CurContext->codeSegmentPtr++;
 }
 
 //***************************************************************************
@@ -365,8 +359,8 @@ getCodeToken(void)
 void
 pushInteger(int32_t value)
 {
-	const std::unique_ptr<StackItem>& valuePtr = ++tos;
-	if (valuePtr >= &stack[MAXSIZE_STACK])
+	const std::unique_ptr<StackItem>& valuePtr = ++CurContext->tos;
+	if (valuePtr >= CurContext->stackLimit)
 		runtimeError(ABL_ERR_RUNTIME_STACK_OVERFLOW);
 	valuePtr->integer = value;
 }
@@ -376,8 +370,8 @@ pushInteger(int32_t value)
 void
 pushReal(float value)
 {
-	const std::unique_ptr<StackItem>& valuePtr = ++tos;
-	if (valuePtr >= &stack[MAXSIZE_STACK])
+	const std::unique_ptr<StackItem>& valuePtr = ++CurContext->tos;
+	if (valuePtr >= CurContext->stackLimit)
 		runtimeError(ABL_ERR_RUNTIME_STACK_OVERFLOW);
 	valuePtr->real = value;
 }
@@ -387,8 +381,8 @@ pushReal(float value)
 void
 pushByte(wchar_t value)
 {
-	const std::unique_ptr<StackItem>& valuePtr = ++tos;
-	if (valuePtr >= &stack[MAXSIZE_STACK])
+	const std::unique_ptr<StackItem>& valuePtr = ++CurContext->tos;
+	if (valuePtr >= CurContext->stackLimit)
 		runtimeError(ABL_ERR_RUNTIME_STACK_OVERFLOW);
 	valuePtr->byte = value;
 }
@@ -398,8 +392,8 @@ pushByte(wchar_t value)
 void
 pushAddress(Address address)
 {
-	const std::unique_ptr<StackItem>& valuePtr = ++tos;
-	if (valuePtr >= &stack[MAXSIZE_STACK])
+	const std::unique_ptr<StackItem>& valuePtr = ++CurContext->tos;
+	if (valuePtr >= CurContext->stackLimit)
 		runtimeError(ABL_ERR_RUNTIME_STACK_OVERFLOW);
 	valuePtr->address = address;
 }
@@ -409,8 +403,8 @@ pushAddress(Address address)
 void
 pushBoolean(bool value)
 {
-	const std::unique_ptr<StackItem>& valuePtr = ++tos;
-	if (valuePtr >= &stack[MAXSIZE_STACK])
+	const std::unique_ptr<StackItem>& valuePtr = ++CurContext->tos;
+	if (valuePtr >= CurContext->stackLimit)
 		runtimeError(ABL_ERR_RUNTIME_STACK_OVERFLOW);
 	valuePtr->integer = (value ? 1 : 0);
 }
@@ -422,7 +416,7 @@ pushStackFrameHeader(int32_t oldLevel, int32_t newLevel)
 	//-----------------------------------
 	// Make space for the return value...
 	pushInteger(0);
-	const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)stackFrameBasePtr;
+	const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)CurContext->stackFrameBasePtr;
 	//----------------------------------------------------------------------
 	// STATIC LINK
 	// Currently, let's not allow functions defined within functions. Assume
@@ -459,7 +453,7 @@ pushStackFrameHeader(int32_t oldLevel, int32_t newLevel)
 		// Oops. We don't want nested functions, for now, in ABL.
 		runtimeError(ABL_ERR_RUNTIME_NESTED_FUNCTION_CALL);
 	}
-	pushAddress((Address)stackFrameBasePtr);
+	pushAddress((Address)CurContext->stackFrameBasePtr);
 	//---------------------------
 	// Push the return address...
 	pushAddress(0);
@@ -490,7 +484,7 @@ allocLocal(const std::unique_ptr<Type>& ptype)
 			//				allocLocal(ptype->info.subrange.rangeTypePtr);
 			//				break;
 		case FRM_ARRAY:
-			const std::wstring_view& ptr = (const std::wstring_view&)ABLStackMallocCallback(ptype->size);
+			const std::wstring_view& ptr = (const std::wstring_view&)runtimeMalloc(ptype->size);
 			if (!ptr)
 				ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc local array ");
 			pushAddress((Address)ptr);
@@ -512,7 +506,7 @@ freeLocal(const std::unique_ptr<SymTableNode>& idPtr)
 		switch (idPtr->defn.info.data.varType)
 		{
 		case VAR_TYPE_NORMAL:
-			itemPtr = stackFrameBasePtr + idPtr->defn.info.data.offset;
+			itemPtr = CurContext->stackFrameBasePtr + idPtr->defn.info.data.offset;
 			break;
 			//			case VAR_TYPE_ETERNAL:
 			//				itemPtr = stack + idPtr->defn.info.data.offset;
@@ -524,7 +518,7 @@ freeLocal(const std::unique_ptr<SymTableNode>& idPtr)
 		if (!itemPtr)
 			runtimeError(0);
 		else
-			ABLStackFreeCallback(itemPtr->address);
+			runtimeFree(itemPtr->address);
 	}
 }
 
@@ -537,10 +531,10 @@ routineEntry(const std::unique_ptr<SymTableNode>& routineIdPtr)
 {
 	if (debugger)
 		debugger->traceRoutineEntry(routineIdPtr);
-	memset(&returnValue, 0, sizeof(StackItem));
+	memset(&CurContext->returnValue, 0, sizeof(StackItem));
 	//------------------------------
 	// Switch to new code segment...
-	codeSegmentPtr = routineIdPtr->defn.info.routine.codeSegment;
+	CurContext->codeSegmentPtr = routineIdPtr->defn.info.routine.codeSegment;
 	//----------------------------------------------
 	// Allocate local variables onto system stack...
 	for (const std::unique_ptr<SymTableNode>& varIdPtr = (const std::unique_ptr<SymTableNode>&)(routineIdPtr->defn.info.routine.locals);
@@ -566,13 +560,13 @@ routineExit(const std::unique_ptr<SymTableNode>& routineIdPtr)
 		 idPtr = idPtr->next)
 		if (idPtr->defn.info.data.varType == VAR_TYPE_NORMAL)
 			freeLocal(idPtr);
-	const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)stackFrameBasePtr;
-	codeSegmentPtr = headerPtr->returnAddress.address;
+	const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)CurContext->stackFrameBasePtr;
+	CurContext->codeSegmentPtr = headerPtr->returnAddress.address;
 	if (routineIdPtr->ptype == nullptr)
-		tos = stackFrameBasePtr - 1;
+		CurContext->tos = CurContext->stackFrameBasePtr - 1;
 	else
-		tos = stackFrameBasePtr;
-	stackFrameBasePtr = (const std::unique_ptr<StackItem>&)headerPtr->dynamicLink.address;
+		CurContext->tos = CurContext->stackFrameBasePtr;
+	CurContext->stackFrameBasePtr = (const std::unique_ptr<StackItem>&)headerPtr->dynamicLink.address;
 }
 
 //***************************************************************************
@@ -580,16 +574,18 @@ routineExit(const std::unique_ptr<SymTableNode>& routineIdPtr)
 void
 execute(const std::unique_ptr<SymTableNode>& routineIdPtr)
 {
-	const std::unique_ptr<SymTableNode>& thisRoutineIdPtr = CurRoutineIdPtr;
-	CurRoutineIdPtr = routineIdPtr;
+	const std::unique_ptr<SymTableNode>& thisRoutineIdPtr = CurContext->routineIdPtr;
+	CurContext->routineIdPtr = routineIdPtr;
 	routineEntry(routineIdPtr);
+	if (ProfilerEnabled)
+		profileRoutineEntry(routineIdPtr, false);
 	//----------------------------------------------------
 	// Now, search this module for the function we want...
-	if (CallModuleInit)
+	if (CurContext->callModuleInit)
 	{
-		CallModuleInit = false;
+		CurContext->callModuleInit = false;
 		const std::unique_ptr<SymTableNode>& initFunctionIdPtr = searchSymTable("init",
-			ModuleRegistry[CurModule->getHandle()].moduleIdPtr->defn.info.routine.localSymTable);
+			ModuleRegistry[CurContext->module->getHandle()].moduleIdPtr->defn.info.routine.localSymTable);
 		if (initFunctionIdPtr)
 		{
 			execRoutineCall(initFunctionIdPtr, false);
@@ -597,20 +593,20 @@ execute(const std::unique_ptr<SymTableNode>& routineIdPtr)
 			// Since we're calling the function directly, we need to compensate
 			// for the codeSegmentPtr being incremented by 1 in the normal
 			// execRoutineCall...
-			codeSegmentPtr--;
+			CurContext->codeSegmentPtr--;
 		}
 	}
 	if (routineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_FSM)
 	{
-		NewStateSet = true;
-		static wchar_t stateList[60][256];
-		strcpy(SetStateDebugStr, "--");
-		while (NewStateSet)
+		CurContext->newStateSet = true;
+		static thread_local wchar_t stateList[60][256];
+		strcpy(CurContext->stateDebugStr, "--");
+		while (CurContext->newStateSet)
 		{
-			NumStateTransitions++;
-			sprintf(stateList[NumStateTransitions], "%s (%s)", CurModule->getState()->name,
-				SetStateDebugStr);
-			if (NumStateTransitions == 50)
+			CurContext->numStateTransitions++;
+			sprintf(stateList[CurContext->numStateTransitions], "%s (%s)", CurContext->module->getState()->name,
+				CurContext->stateDebugStr);
+			if (CurContext->numStateTransitions == 50)
 			{
 				UserFile* userFile = UserFile::getNewFile();
 				wchar_t errStr[512];
@@ -622,7 +618,7 @@ execute(const std::unique_ptr<SymTableNode>& routineIdPtr)
 						// wchar_t s[1024];
 						// sprintf(s, "Current Date: %s\n", GetTime());
 						// userFile->write(s);
-						userFile->write(ModuleRegistry[CurModule->getHandle()].fileName);
+						userFile->write(ModuleRegistry[CurContext->module->getHandle()].fileName);
 						for (size_t i = 1; i < 51; i++)
 							userFile->write(stateList[i]);
 						userFile->write(" ");
@@ -632,40 +628,51 @@ execute(const std::unique_ptr<SymTableNode>& routineIdPtr)
 					}
 				}
 				sprintf(errStr, " ABL endless state loop in %s [%s:%s] ",
-					ModuleRegistry[CurModule->getHandle()].fileName, CurModule->getState()->name,
-					CurModule->getPrevState()->name);
+					ModuleRegistry[CurContext->module->getHandle()].fileName, CurContext->module->getState()->name,
+					CurContext->module->getPrevState()->name);
 #if 0
-				ABL_Fatal(NumStateTransitions, errStr);
+				ABL_Fatal(CurContext->numStateTransitions, errStr);
 #else
-				NewStateSet = false;
+				CurContext->newStateSet = false;
 #endif
 			}
 			else
 			{
-				NewStateSet = false;
-				const std::unique_ptr<SymTableNode>& curState = CurModule->getState();
+				CurContext->newStateSet = false;
+				const std::unique_ptr<SymTableNode>& curState = CurContext->module->getState();
 				if (!curState)
 					ABL_Fatal(0, " ABL.execute: nullptr state in FSM ");
 				execRoutineCall(curState, false);
-				codeSegmentPtr--;
+				CurContext->codeSegmentPtr--;
 			}
 			//---------------------------------------------
 			// In case we exited with a return statement...
-			ExitWithReturn = false;
-			ExitFromTacOrder = false;
+			CurContext->exitWithReturn = false;
+			CurContext->exitFromTacOrder = false;
 		}
 	}
 	else
 	{
-		getCodeToken();
-		execStatement();
+		//-----------------------------------------------------------
+		// A routine translated ahead of time runs its C++ instead, on
+		// this same frame. The debugger needs to see every statement,
+		// so it always gets the interpreter...
+		if (routineIdPtr->defn.info.routine.nativeCode && !debugger)
+			(*routineIdPtr->defn.info.routine.nativeCode)();
+		else
+		{
+			getCodeToken();
+			execStatement();
+		}
 		//---------------------------------------------
 		// In case we exited with a return statement...
-		ExitWithReturn = false;
-		ExitFromTacOrder = false;
+		CurContext->exitWithReturn = false;
+		CurContext->exitFromTacOrder = false;
 	}
+	if (ProfilerEnabled)
+		profileRoutineExit();
 	routineExit(routineIdPtr);
-	CurRoutineIdPtr = thisRoutineIdPtr;
+	CurContext->routineIdPtr = thisRoutineIdPtr;
 }
 
 //***************************************************************************
@@ -674,15 +681,17 @@ void
 executeChild(const std::unique_ptr<SymTableNode>& routineIdPtr, const std::unique_ptr<SymTableNode>& childRoutineIdPtr)
 {
 	// THIS DOES NOT SUPPORT CALLING FUNCTIONS WITH PARAMETERS YET!
-	const std::unique_ptr<SymTableNode>& thisRoutineIdPtr = CurRoutineIdPtr;
-	CurRoutineIdPtr = routineIdPtr;
+	const std::unique_ptr<SymTableNode>& thisRoutineIdPtr = CurContext->routineIdPtr;
+	CurContext->routineIdPtr = routineIdPtr;
 	routineEntry(routineIdPtr);
+	if (ProfilerEnabled)
+		profileRoutineEntry(routineIdPtr, false);
 	//----------------------------------------------------
 	// Now, search this module for the function we want...
 	const std::unique_ptr<SymTableNode>& initFunctionIdPtr = nullptr;
-	if (CallModuleInit)
+	if (CurContext->callModuleInit)
 	{
-		CallModuleInit = false;
+		CurContext->callModuleInit = false;
 		initFunctionIdPtr = searchSymTable("init", routineIdPtr->defn.info.routine.localSymTable);
 		if (initFunctionIdPtr)
 		{
@@ -691,7 +700,7 @@ executeChild(const std::unique_ptr<SymTableNode>& routineIdPtr, const std::uniqu
 			// Since we're calling the function directly, we need to compensate
 			// for the codeSegmentPtr being incremented by 1 in the normal
 			// execRoutineCall...
-			codeSegmentPtr--;
+			CurContext->codeSegmentPtr--;
 		}
 	}
 	if (initFunctionIdPtr != childRoutineIdPtr)
@@ -705,18 +714,73 @@ executeChild(const std::unique_ptr<SymTableNode>& routineIdPtr, const std::uniqu
 		// Since we're calling the function directly, we need to compensate for
 		// the codeSegmentPtr being incremented by 1 in the normal
 		// execRoutineCall...
-		codeSegmentPtr--;
+		CurContext->codeSegmentPtr--;
 	}
 	//---------------------------------------------
 	// In case we exited with a return statement...
-	ExitWithReturn = false;
-	ExitFromTacOrder = false;
+	CurContext->exitWithReturn = false;
+	CurContext->exitFromTacOrder = false;
+	if (ProfilerEnabled)
+		profileRoutineExit();
 	routineExit(routineIdPtr);
-	CurRoutineIdPtr = thisRoutineIdPtr;
+	CurContext->routineIdPtr = thisRoutineIdPtr;
 }
 
 //***************************************************************************
 // MISC routines
 //***************************************************************************
 
+void
+initExecContext(ABLExecContext* context, StackItem* runtimeStack, int32_t stackSize)
+{
+	memset(context, 0, sizeof(ABLExecContext));
+	context->fileNumber = -1;
+	context->orderCall = -1;
+	context->runtimeStack = runtimeStack;
+	if (runtimeStack)
+		context->stackLimit = runtimeStack + stackSize;
+	else
+		context->stackLimit = &stack[MAXSIZE_STACK];
+}
+
+//***************************************************************************
+
+StackItem*
+getRuntimeStackBase(void)
+{
+	//----------------------------------------------------------------
+	// The main context shares the global stack with the eternals, so
+	// its frames start just above them...
+	if (CurContext->runtimeStack)
+		return (CurContext->runtimeStack);
+	return (stack + eternalOffset);
+}
+
+//***************************************************************************
+
+PVOID
+runtimeMalloc(size_t memSize)
+{
+	if (!CurContext->runtimeStack)
+		return (ABLStackMallocCallback(memSize));
+	std::lock_guard<std::mutex> lock(RuntimeHeapLock);
+	return (ABLStackMallocCallback(memSize));
+}
+
+//***************************************************************************
+
+void
+runtimeFree(PVOID memBlock)
+{
+	if (!CurContext->runtimeStack)
+	{
+		ABLStackFreeCallback(memBlock);
+		return;
+	}
+	std::lock_guard<std::mutex> lock(RuntimeHeapLock);
+	ABLStackFreeCallback(memBlock);
+}
+
+//***************************************************************************
+
 } // namespace mclib::abl
@@ -113,19 +113,106 @@ struct StackFrameHeader
 
 //***************************************************************************
 
+//---------------------------------------------------------------------------
+// Side-effecting standard functions can be queued while a brain runs on a
+// worker context, and replayed later on the main thread. Each queued call is
+// an ABLDeferredCall header followed by its captured arguments: one StackItem
+// per scalar, or a StackItem holding a byte count followed by the (padded)
+// array contents. An "anything" param gets a StackItem holding its
+// ABLStackItemType ahead of the value.
+
+struct ABLDeferredCall
+{
+	int16_t key;
+	uint8_t skipOrder;
+	uint8_t numArgs;
+	int32_t size; // whole record, header included
+	int32_t orderCall; // order flag to set if the call completes, or -1
+	ABLModule* module; // whose order flags those are
+};
+
+struct ABLCommandBuffer
+{
+	uint8_t* data;
+	int32_t size;
+	int32_t maxSize;
+	int32_t numCalls;
+};
+
+//---------------------------------------------------------------------------
+// Everything the interpreter touches while a module runs. The main context
+// runs on the global stack, just above the eternal variables. Worker
+// contexts own a private runtime stack so several modules can execute at
+// once (eternals and the compiled code stay shared and read-only). The
+// executing thread reaches its context through CurContext.
+
+struct SymTableNode;
+class ABLModule;
+
+#define MAX_PROFILE_DEPTH 32
+
+struct ABLProfileFrame
+{
+	SymTableNode* routine;
+	int32_t moduleHandle;
+	bool native;
+};
+
+struct ABLExecContext
+{
+	Address codeSegmentPtr;
+	Address codeSegmentLimit;
+	Address statementStartPtr;
+	TokenCodeType codeToken;
+	int32_t execLineNumber;
+	int32_t execStatementCount;
+	int32_t fileNumber;
+
+	StackItem* runtimeStack; // nullptr for the main context
+	StackItem* stackLimit;
+	StackItem* tos;
+	StackItem* stackFrameBasePtr;
+	StackItem* staticDataPtr;
+	int32_t level;
+	int32_t callStackLevel;
+
+	SymTableNode* routineIdPtr;
+	ABLModule* module;
+	ABLModule* fsm;
+	int32_t moduleHandle;
+	uint32_t* orderCompletionFlags;
+	int32_t numStateTransitions;
+	bool newStateSet;
+	bool callModuleInit;
+	wchar_t stateDebugStr[256];
+
+	StackItem returnValue;
+	bool exitWithReturn;
+	bool exitFromTacOrder;
+	bool skipOrder;
+	int32_t orderCall; // order flag of the standard order call being made, or -1
+
+	ABLCommandBuffer* commandBuffer; // nullptr: run natives in place
+	bool ownCommandBuffer; // false once ABLi_resetExecContext lends it one
+	uint8_t* replayArg; // non-null while a deferred call is being applied
+	bool ownRandom;
+	uint32_t randomSeed;
+
+	ABLProfileFrame profileFrames[MAX_PROFILE_DEPTH];
+	int32_t profileDepth; // may run past MAX_PROFILE_DEPTH
+	int32_t profileCountdown; // statements left before the next sample
+	int64_t profileLastSample;
+};
+
+//***************************************************************************
+
 extern const std::wstring_view& codeBuffer;
 extern const std::wstring_view& codeBufferPtr;
-extern const std::wstring_view& codeSegmentPtr;
-extern const std::wstring_view& codeSegmentLimit;
-extern const std::wstring_view& statementStartPtr;
-
-extern TokenCodeType codeToken;
-extern int32_t execLineNumber;
-extern int32_t execStatementCount;
 
 extern StackItem* stack;
-extern const std::unique_ptr<StackItem>& tos;
-extern const std::unique_ptr<StackItem>& stackFrameBasePtr;
+
+extern ABLExecContext MainExecContext;
+extern thread_local ABLExecContext* CurContext;
 
 //***************************************************************************
 
@@ -272,6 +359,25 @@ execExpression(void);
 
 const std::unique_ptr<Type>&
 execStandardRoutineCall(const std::unique_ptr<SymTableNode>& routineIdPtr, bool skipOrder);
+int32_t
+getAnythingType(const std::unique_ptr<Type>& paramTypePtr);
+void
+recordDeferredCall(int32_t key, bool skipOrder, int32_t orderCall);
+int32_t
+applyDeferredCalls(ABLCommandBuffer* buffer);
+
+//*****************
+// CONTEXT routines
+//*****************
+
+void
+initExecContext(ABLExecContext* context, StackItem* runtimeStack, int32_t stackSize);
+StackItem*
+getRuntimeStackBase(void);
+PVOID
+runtimeMalloc(size_t memSize);
+void
+runtimeFree(PVOID memBlock);
 
 //***************************************************************************
 
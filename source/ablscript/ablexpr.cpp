@@ -34,10 +34,10 @@ extern Type DummyType;
 extern TokenCodeType statementEndList[];
 
 extern bool EnterStateSymbol;
-extern const std::unique_ptr<ABLModule>& CurFSM;
 const std::unique_ptr<SymTableNode>&
 forwardState(const std::wstring_view& stateName);
 extern const std::unique_ptr<SymTableNode>& CurModuleIdPtr;
+extern int32_t NumSharedWrites;
 
 //***************************************************************************
 
@@ -152,11 +152,37 @@ variable(const std::unique_ptr<SymTableNode>& variableIdPtr)
 		if (curToken == TKN_LBRACKET)
 			ptype = arraySubscriptList(ptype);
 	}
+	//-----------------------------------------------------------------
+	// A whole shared array handed to a routine may get written, so play
+	// it safe and count it as a write...
+	if ((ptype->form == FRM_ARRAY) && isSharedVariable(variableIdPtr))
+		NumSharedWrites++;
 	return (ptype);
 }
 
 //***************************************************************************
 
+bool
+isSharedVariable(const std::unique_ptr<SymTableNode>& idPtr)
+{
+	//-----------------------------------------------------------------
+	// Eternals, registered vars and library statics are seen by every
+	// module instance at once...
+	if (idPtr->defn.key != DFN_VAR)
+		return (false);
+	switch (idPtr->defn.info.data.varType)
+	{
+	case VAR_TYPE_ETERNAL:
+	case VAR_TYPE_REGISTERED:
+		return (true);
+	case VAR_TYPE_STATIC:
+		return (idPtr->library != nullptr);
+	}
+	return (false);
+}
+
+//***************************************************************************
+
 const std::unique_ptr<Type>&
 arraySubscriptList(const std::unique_ptr<Type>& ptype)
 {
@@ -0,0 +1,1243 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+//***************************************************************************
+//
+//								ABLIMAGE.CPP
+//
+//***************************************************************************
+#include "stdinc.h"
+
+//#include "ablgen.h"
+//#include "ablerr.h"
+//#include "ablscan.h"
+//#include "ablsymt.h"
+//#include "ablexec.h"
+//#include "ablenv.h"
+//#include "ablimage.h"
+
+namespace mclib::abl {
+
+//***************************************************************************
+
+//--------
+// GLOBALS
+ABLImageStats CompiledModuleStats = {0, 0, 0, 0};
+bool CompiledModuleCacheEnabled = false;
+bool (*ABLImageExistsCallback)(const std::wstring_view& fileName) = nullptr;
+
+//----------
+// EXTERNALS
+
+extern const std::unique_ptr<ModuleEntry>& ModuleRegistry;
+extern int32_t NumModulesRegistered;
+extern const std::unique_ptr<ABLModule>& CurLibrary;
+extern const std::unique_ptr<SymTableNode>& SymTableDisplay[MAX_NESTING_LEVEL];
+extern const std::unique_ptr<Type>& IntegerTypePtr;
+extern const std::unique_ptr<Type>& CharTypePtr;
+extern const std::unique_ptr<Type>& RealTypePtr;
+extern const std::unique_ptr<Type>& BooleanTypePtr;
+extern Type DummyType;
+
+extern StackItem* stack;
+extern int32_t eternalOffset;
+extern int32_t* EternalVariablesSizes;
+extern int32_t MaxEternalVariables;
+extern int32_t* StaticVariablesSizes;
+extern int32_t NumStaticVariables;
+extern int32_t MaxStaticVariables;
+extern int32_t NumOrderCalls;
+extern int32_t NumMainThreadCalls;
+extern int32_t NumSharedWrites;
+extern int32_t NumStateHandles;
+extern StateHandleInfo StateHandleList[MAX_STATE_HANDLES_PER_MODULE];
+extern int32_t NumSourceFiles;
+extern wchar_t SourceFiles[MAX_SOURCE_FILES][MAXLEN_FILENAME];
+extern int32_t NumLibrariesUsed;
+extern const std::unique_ptr<ABLModule>& LibrariesUsed[MAX_LIBRARIES_USED];
+extern bool IncludeDebugInfo;
+extern int32_t MaxCodeBufferSize;
+
+//---------------------------------------------------------------------------
+// Standard types are shared by every module, so they're written as a tag
+// rather than copied into the image...
+#define IMAGE_TYPE_INTEGER -1
+#define IMAGE_TYPE_CHAR -2
+#define IMAGE_TYPE_REAL -3
+#define IMAGE_TYPE_BOOLEAN -4
+#define IMAGE_TYPE_DUMMY -5
+
+#define IMAGE_SCOPE_GLOBAL -1
+#define IMAGE_SCOPE_UNKNOWN -2
+
+//***************************************************************************
+// RELOCATION routines
+//***************************************************************************
+
+//---------------------------------------------------------------------
+// Offsets (in code units) of every SymTableNode pointer crunched into
+// the code buffer since the last code segment was created, and the
+// finished lists for each code segment of the module being compiled.
+static std::vector<int32_t> PendingRelocations;
+static std::unordered_map<Address, std::vector<int32_t>> SegmentRelocations;
+
+void
+recordCodeRelocation(int32_t offset)
+{
+	PendingRelocations.push_back(offset);
+}
+
+//---------------------------------------------------------------------------
+
+void
+shiftCodeRelocations(int32_t fromOffset, int32_t delta)
+{
+	//-------------------------------------------------------------------
+	// Statement and address markers are slipped in ahead of the last
+	// code unit, so anything crunched at or beyond that point moves up.
+	for (auto& offset : PendingRelocations)
+		if (offset >= fromOffset)
+			offset += delta;
+}
+
+//---------------------------------------------------------------------------
+
+void
+truncateCodeRelocations(int32_t endOffset)
+{
+	while (!PendingRelocations.empty() && (PendingRelocations.back() >= endOffset))
+		PendingRelocations.pop_back();
+}
+
+//---------------------------------------------------------------------------
+
+void
+bindCodeRelocations(Address codeSegment, int32_t codeSegmentSize)
+{
+	truncateCodeRelocations(codeSegmentSize);
+	SegmentRelocations[codeSegment].swap(PendingRelocations);
+	PendingRelocations.clear();
+}
+
+//---------------------------------------------------------------------------
+
+void
+discardCodeRelocations(void)
+{
+	PendingRelocations.clear();
+	SegmentRelocations.clear();
+}
+
+//***************************************************************************
+// IMAGE FILE routines
+//***************************************************************************
+
+uint32_t
+hashABLSourceFile(const std::wstring_view& fileName)
+{
+	//------------------------------------------------------------
+	// FNV-1a over the raw file. Returns 0 if the file won't open,
+	// which never matches a stored hash...
+	ABLFile* sourceFile = new ABLFile;
+	if (!sourceFile)
+		ABL_Fatal(0, " ABL: Unable to AblSystemHeap->malloc source file ");
+	if (sourceFile->open(fileName) != ABL_NO_ERR)
+	{
+		delete sourceFile;
+		return (0);
+	}
+	uint32_t hash = 2166136261;
+	uint8_t buffer[4096];
+	int32_t bytesRead = 0;
+	do
+	{
+		bytesRead = sourceFile->read(buffer, sizeof(buffer));
+		for (size_t i = 0; i < bytesRead; i++)
+		{
+			hash ^= buffer[i];
+			hash *= 16777619;
+		}
+	} while ((bytesRead == sizeof(buffer)) && !sourceFile->eof());
+	sourceFile->close();
+	delete sourceFile;
+	return (hash ? hash : 1);
+}
+
+//---------------------------------------------------------------------------
+
+void
+makeABLImageFileName(const std::wstring_view& sourceFileName, wchar_t* imageFileName)
+{
+	wcsncpy(imageFileName, sourceFileName.data(), MAXLEN_FILENAME - 5);
+	imageFileName[MAXLEN_FILENAME - 5] = 0;
+	wchar_t* extension = wcsrchr(imageFileName, L'.');
+	if (extension && !wcschr(extension, L'\\') && !wcschr(extension, L'/'))
+		*extension = 0;
+	wcscat(imageFileName, ABL_IMAGE_EXTENSION);
+}
+
+//---------------------------------------------------------------------------
+
+static int32_t
+findLibraryModule(const std::wstring_view& fileName)
+{
+	for (size_t i = 0; i < NumModulesRegistered; i++)
+		if (ModuleRegistry[i].moduleIdPtr->library && (fileName == ModuleRegistry[i].fileName))
+			return (i);
+	return (-1);
+}
+
+//---------------------------------------------------------------------------
+
+static int32_t
+findLibraryModule(ABLModule* library)
+{
+	for (size_t i = 0; i < NumModulesRegistered; i++)
+		if (ModuleRegistry[i].moduleIdPtr->library == library)
+			return (i);
+	return (-1);
+}
+
+//---------------------------------------------------------------------------
+
+static SymTableNode*
+searchSymTableForKey(const std::wstring_view& name, DefinitionType key, SymTableNode* nodePtr)
+{
+	//-------------------------------------------------------------
+	// Unlike searchSymTable(), we don't dive into library modules
+	// hanging off the global table--the image already tells us
+	// which library (if any) owns the symbol...
+	nodePtr = searchSymTableIndex(findSymbolName(name), nodePtr);
+	while (nodePtr && (nodePtr->defn.key != key))
+		nodePtr = nodePtr->sameName;
+	return (nodePtr);
+}
+
+//***************************************************************************
+// IMAGE WRITER
+//***************************************************************************
+
+class ImageWriter
+{
+
+public:
+	std::vector<uint8_t> data;
+
+public:
+	void putByte(uint8_t value) { data.push_back(value); }
+
+	void putLong(int32_t value) { putBytes(&value, sizeof(int32_t)); }
+
+	void putBytes(const void* bytes, size_t length)
+	{
+		const uint8_t* src = (const uint8_t*)bytes;
+		data.insert(data.end(), src, src + length);
+	}
+
+	void putString(const std::wstring_view& s)
+	{
+		putLong((int32_t)s.size());
+		putBytes(s.data(), s.size() * sizeof(wchar_t));
+	}
+};
+
+//---------------------------------------------------------------------------
+
+class ImageBuilder
+{
+
+public:
+	struct ExternalSymbol
+	{
+		int32_t scope; // IMAGE_SCOPE_GLOBAL or index into libraries
+		SymTableNode* node;
+	};
+
+	SymTableNode* moduleIdPtr;
+	ABLModule* library;
+	int32_t eternalBase;
+
+	std::vector<SymTableNode*> nodes;
+	std::unordered_map<SymTableNode*, int32_t> nodeIndex;
+	std::vector<Type*> types;
+	std::unordered_map<Type*, int32_t> typeIndex;
+	std::vector<ExternalSymbol> externals;
+	std::unordered_map<SymTableNode*, int32_t> externalIndex;
+	std::vector<int32_t> libraries; // module handles
+	std::vector<Address> segments;
+	std::unordered_map<Address, int32_t> segmentIndex;
+
+public:
+	ImageBuilder(SymTableNode* module, int32_t base)
+	{
+		moduleIdPtr = module;
+		library = module->library;
+		eternalBase = base;
+	}
+
+	bool isOwned(SymTableNode* node);
+	int32_t libraryRef(int32_t moduleHandle);
+	int32_t nodeRef(SymTableNode* node);
+	int32_t typeRef(Type* type);
+	int32_t segmentRef(Address codeSegment);
+	bool collect(void);
+	void write(ImageWriter& image);
+};
+
+//---------------------------------------------------------------------------
+
+bool
+ImageBuilder::isOwned(SymTableNode* node)
+{
+	if (node == moduleIdPtr)
+		return (true);
+	if (node->library != library)
+		return (false);
+	if (node->level > 0)
+		return (true);
+	//--------------------------------------------------------------
+	// The only other level-0 symbols a module creates are its own
+	// eternal variables...
+	return ((node->defn.key == DFN_VAR) && (node->defn.info.data.varType == VAR_TYPE_ETERNAL) &&
+		(node->defn.info.data.offset >= eternalBase) && (node->defn.info.data.offset < eternalOffset));
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+ImageBuilder::libraryRef(int32_t moduleHandle)
+{
+	for (size_t i = 0; i < libraries.size(); i++)
+		if (libraries[i] == moduleHandle)
+			return (i);
+	libraries.push_back(moduleHandle);
+	return (libraries.size() - 1);
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+ImageBuilder::nodeRef(SymTableNode* node)
+{
+	if (!node)
+		return (0);
+	auto owned = nodeIndex.find(node);
+	if (owned != nodeIndex.end())
+		return (owned->second + 1);
+	auto external = externalIndex.find(node);
+	if (external != externalIndex.end())
+		return (-(external->second + 1));
+	if (isOwned(node))
+	{
+		nodeIndex[node] = nodes.size();
+		nodes.push_back(node);
+		return (nodes.size());
+	}
+	ExternalSymbol symbol;
+	symbol.scope = IMAGE_SCOPE_GLOBAL;
+	symbol.node = node;
+	if (node->library)
+	{
+		int32_t libraryHandle = findLibraryModule(node->library);
+		symbol.scope = (libraryHandle < 0) ? IMAGE_SCOPE_UNKNOWN : libraryRef(libraryHandle);
+	}
+	externalIndex[node] = externals.size();
+	externals.push_back(symbol);
+	return (-(int32_t)externals.size());
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+ImageBuilder::typeRef(Type* type)
+{
+	if (!type)
+		return (0);
+	if (type == IntegerTypePtr)
+		return (IMAGE_TYPE_INTEGER);
+	if (type == CharTypePtr)
+		return (IMAGE_TYPE_CHAR);
+	if (type == RealTypePtr)
+		return (IMAGE_TYPE_REAL);
+	if (type == BooleanTypePtr)
+		return (IMAGE_TYPE_BOOLEAN);
+	if (type == &DummyType)
+		return (IMAGE_TYPE_DUMMY);
+	auto found = typeIndex.find(type);
+	if (found != typeIndex.end())
+		return (found->second + 1);
+	typeIndex[type] = types.size();
+	types.push_back(type);
+	return (types.size());
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+ImageBuilder::segmentRef(Address codeSegment)
+{
+	if (!codeSegment)
+		return (-1);
+	auto found = segmentIndex.find(codeSegment);
+	if (found != segmentIndex.end())
+		return (found->second);
+	segmentIndex[codeSegment] = segments.size();
+	segments.push_back(codeSegment);
+	return (segments.size() - 1);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+ImageBuilder::collect(void)
+{
+	//--------------------------------------------------------------
+	// Walk everything reachable from the module node. Nodes and
+	// types get appended as they're discovered, so just keep going
+	// until both lists stop growing...
+	nodeRef(moduleIdPtr);
+	for (size_t i = 0; i < NumStateHandles; i++)
+		nodeRef(StateHandleList[i].state);
+	size_t curNode = 0;
+	size_t curType = 0;
+	size_t curSegment = 0;
+	while ((curNode < nodes.size()) || (curType < types.size()) || (curSegment < segments.size()))
+	{
+		for (; curNode < nodes.size(); curNode++)
+		{
+			SymTableNode* node = nodes[curNode];
+			if (node->level > 0)
+			{
+				nodeRef(node->left);
+				nodeRef(node->parent);
+				nodeRef(node->right);
+			}
+			nodeRef(node->next);
+			typeRef(node->ptype);
+			switch (node->defn.key)
+			{
+			case DFN_MODULE:
+			case DFN_PROCEDURE:
+			case DFN_FUNCTION:
+				nodeRef(node->defn.info.routine.params);
+				nodeRef(node->defn.info.routine.locals);
+				nodeRef(node->defn.info.routine.localSymTable);
+				segmentRef((Address)node->defn.info.routine.codeSegment);
+				break;
+			case DFN_VAR:
+				if (node->defn.info.data.varType == VAR_TYPE_REGISTERED)
+					return (false);
+				break;
+			}
+		}
+		for (; curType < types.size(); curType++)
+		{
+			Type* type = types[curType];
+			nodeRef(type->typeIdPtr);
+			if (type->form == FRM_ENUM)
+				nodeRef(type->info.enumeration.constIdPtr);
+			else if (type->form == FRM_ARRAY)
+			{
+				typeRef(type->info.array.indexTypePtr);
+				typeRef(type->info.array.elementTypePtr);
+			}
+		}
+		for (; curSegment < segments.size(); curSegment++)
+		{
+			auto relocations = SegmentRelocations.find(segments[curSegment]);
+			if (relocations == SegmentRelocations.end())
+				return (false);
+			for (auto offset : relocations->second)
+				nodeRef(*((SymTableNode**)(segments[curSegment] + offset)));
+		}
+	}
+	//------------------------------------------------------------
+	// A library member we couldn't trace back to its module means
+	// we can't rebind it later, so don't write the image...
+	for (auto& symbol : externals)
+		if (symbol.scope == IMAGE_SCOPE_UNKNOWN)
+			return (false);
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+
+void
+ImageBuilder::write(ImageWriter& image)
+{
+	int32_t i;
+	//-------
+	// Header
+	int32_t flags = 0;
+	if (library)
+		flags |= ABL_IMAGE_FLAG_LIBRARY;
+	if (IncludeDebugInfo)
+		flags |= ABL_IMAGE_FLAG_DEBUG_INFO;
+	image.putLong(ABL_IMAGE_MAGIC);
+	image.putLong(ABL_IMAGE_VERSION);
+	image.putLong(flags);
+	image.putLong(sizeof(Address));
+	image.putLong(sizeof(StackItem));
+	//--------------------------------------------------
+	// Source files (the module plus includes) and their
+	// hashes, so we know when the image is out of date.
+	image.putLong(NumSourceFiles);
+	for (i = 0; i < NumSourceFiles; i++)
+	{
+		image.putString(SourceFiles[i]);
+		image.putLong(hashABLSourceFile(SourceFiles[i]));
+	}
+	//----------------------------------------------------------------
+	// Libraries this module pulls symbols from. These must already be
+	// registered when the image loads, just as they are for a compile.
+	for (i = 0; i < NumLibrariesUsed; i++)
+		libraryRef(findLibraryModule(LibrariesUsed[i]));
+	image.putLong(libraries.size());
+	for (auto libraryHandle : libraries)
+		image.putString(ModuleRegistry[libraryHandle].fileName);
+	image.putLong(NumLibrariesUsed);
+	for (i = 0; i < NumLibrariesUsed; i++)
+		image.putLong(libraryRef(findLibraryModule(LibrariesUsed[i])));
+	//-----------------
+	// External symbols
+	image.putLong(externals.size());
+	for (auto& symbol : externals)
+	{
+		image.putLong(symbol.scope);
+		image.putByte((uint8_t)symbol.node->defn.key);
+		image.putString(symbol.node->name);
+	}
+	//------
+	// Types
+	image.putLong(types.size());
+	for (auto type : types)
+	{
+		image.putByte((uint8_t)type->form);
+		image.putLong(type->size);
+		image.putLong(nodeRef(type->typeIdPtr));
+		if (type->form == FRM_ENUM)
+		{
+			image.putLong(nodeRef(type->info.enumeration.constIdPtr));
+			image.putLong(type->info.enumeration.max);
+			image.putLong(0);
+		}
+		else if (type->form == FRM_ARRAY)
+		{
+			image.putLong(typeRef(type->info.array.indexTypePtr));
+			image.putLong(typeRef(type->info.array.elementTypePtr));
+			image.putLong(type->info.array.elementCount);
+		}
+		else
+		{
+			image.putLong(0);
+			image.putLong(0);
+			image.putLong(0);
+		}
+	}
+	//----------------------------------------------------------
+	// Code segments. Symbol pointers are zeroed in the dump and
+	// listed as relocations instead.
+	image.putLong(segments.size());
+	for (auto segment : segments)
+	{
+		int32_t segmentSize = 0;
+		for (auto node : nodes)
+			if (((node->defn.key == DFN_MODULE) || (node->defn.key == DFN_PROCEDURE) ||
+					(node->defn.key == DFN_FUNCTION)) &&
+				((Address)node->defn.info.routine.codeSegment == segment))
+				segmentSize = node->defn.info.routine.codeSegmentSize;
+		std::vector<wchar_t> code(segment, segment + segmentSize);
+		auto& relocations = SegmentRelocations[segment];
+		for (auto offset : relocations)
+			memset(&code[offset], 0, sizeof(SymTableNode*));
+		image.putLong(segmentSize);
+		image.putBytes(code.data(), segmentSize * sizeof(wchar_t));
+		image.putLong(relocations.size());
+		for (auto offset : relocations)
+		{
+			image.putLong(offset);
+			image.putLong(nodeRef(*((SymTableNode**)(segment + offset))));
+		}
+	}
+	//------
+	// Nodes
+	image.putLong(nodes.size());
+	for (auto node : nodes)
+	{
+		image.putString(node->name);
+		image.putByte(node->info.data() ? 1 : 0);
+		if (node->info.data())
+			image.putString(node->info);
+		image.putByte((uint8_t)node->defn.key);
+		image.putByte(node->level);
+		image.putLong(node->labelIndex);
+		image.putLong(typeRef(node->ptype));
+		image.putLong((node->level > 0) ? nodeRef(node->left) : 0);
+		image.putLong((node->level > 0) ? nodeRef(node->parent) : 0);
+		image.putLong((node->level > 0) ? nodeRef(node->right) : 0);
+		image.putLong(nodeRef(node->next));
+		switch (node->defn.key)
+		{
+		case DFN_MODULE:
+		case DFN_PROCEDURE:
+		case DFN_FUNCTION:
+		{
+			Routine& routine = node->defn.info.routine;
+			image.putByte((uint8_t)routine.key);
+			image.putByte(routine.flags);
+			image.putLong(routine.orderCallIndex);
+			image.putLong(routine.numOrderCalls);
+			image.putByte(routine.paramCount);
+			image.putByte(routine.totalParamSize);
+			image.putLong(routine.totalLocalSize);
+			image.putLong(nodeRef(routine.params));
+			image.putLong(nodeRef(routine.locals));
+			image.putLong(nodeRef(routine.localSymTable));
+			image.putLong(segmentRef((Address)routine.codeSegment));
+			image.putLong(routine.codeSegmentSize);
+		}
+		break;
+		case DFN_VAR:
+		case DFN_VALPARAM:
+		case DFN_REFPARAM:
+			image.putByte((uint8_t)node->defn.info.data.varType);
+			if (node->defn.info.data.varType == VAR_TYPE_ETERNAL)
+				image.putLong(node->defn.info.data.offset - eternalBase);
+			else
+				image.putLong(node->defn.info.data.offset);
+			break;
+		default:
+			if ((node->defn.key == DFN_CONST) && node->ptype && (node->ptype->form == FRM_ARRAY))
+			{
+				image.putByte(1);
+				image.putString(node->defn.info.constant.value.stringPtr);
+			}
+			else
+			{
+				int32_t rawValue = 0;
+				memcpy(&rawValue, &node->defn.info.constant.value, sizeof(int32_t));
+				image.putByte(0);
+				image.putLong(rawValue);
+			}
+			break;
+		}
+	}
+	//-------------------------------------
+	// Static and eternal variable layout...
+	image.putLong(NumStaticVariables);
+	for (i = 0; i < NumStaticVariables; i++)
+		image.putLong(StaticVariablesSizes[i]);
+	image.putLong(eternalOffset - eternalBase);
+	for (i = eternalBase; i < eternalOffset; i++)
+		image.putLong(EternalVariablesSizes[i]);
+	image.putLong(NumOrderCalls);
+	image.putLong(NumSharedWrites);
+	image.putLong(NumStateHandles);
+	for (i = 1; i < NumStateHandles; i++)
+		image.putLong(nodeRef(StateHandleList[i].state));
+	image.putLong(nodeRef(moduleIdPtr));
+}
+
+//***************************************************************************
+// IMAGE READER
+//***************************************************************************
+
+class ImageReader
+{
+
+public:
+	const uint8_t* data;
+	size_t size;
+	size_t pos;
+	bool ok;
+
+public:
+	ImageReader(const uint8_t* bytes, size_t length)
+	{
+		data = bytes;
+		size = length;
+		pos = 0;
+		ok = true;
+	}
+
+	bool getBytes(void* bytes, size_t length)
+	{
+		if (!ok || (length > (size - pos)))
+		{
+			ok = false;
+			memset(bytes, 0, length);
+			return (false);
+		}
+		memcpy(bytes, data + pos, length);
+		pos += length;
+		return (true);
+	}
+
+	uint8_t getByte(void)
+	{
+		uint8_t value;
+		getBytes(&value, sizeof(uint8_t));
+		return (value);
+	}
+
+	int32_t getLong(void)
+	{
+		int32_t value;
+		getBytes(&value, sizeof(int32_t));
+		return (value);
+	}
+
+	int32_t getCount(int32_t limit)
+	{
+		int32_t count = getLong();
+		if ((count < 0) || (count > limit))
+			ok = false;
+		return (ok ? count : 0);
+	}
+
+	std::wstring getString(void)
+	{
+		int32_t length = getCount(0x10000);
+		std::wstring s(length, L'\0');
+		if (length)
+			getBytes(&s[0], length * sizeof(wchar_t));
+		return (s);
+	}
+};
+
+//---------------------------------------------------------------------------
+
+struct ImageType
+{
+	FormType form;
+	int32_t size;
+	int32_t typeId;
+	int32_t a;
+	int32_t b;
+	int32_t c;
+};
+
+struct ImageSegment
+{
+	int32_t size;
+	std::vector<wchar_t> code;
+	std::vector<std::pair<int32_t, int32_t>> relocations;
+};
+
+struct ImageNode
+{
+	std::wstring name;
+	bool hasInfo;
+	std::wstring info;
+	DefinitionType key;
+	uint8_t level;
+	int32_t labelIndex;
+	int32_t type;
+	int32_t left;
+	int32_t parent;
+	int32_t right;
+	int32_t next;
+	// routines
+	uint8_t routineKey;
+	uint8_t flags;
+	int32_t orderCallIndex;
+	int32_t numOrderCalls;
+	uint8_t paramCount;
+	uint8_t totalParamSize;
+	int32_t totalLocalSize;
+	int32_t params;
+	int32_t locals;
+	int32_t localSymTable;
+	int32_t segment;
+	int32_t codeSegmentSize;
+	// data
+	VariableType varType;
+	int32_t offset;
+	// constants
+	bool isString;
+	std::wstring stringValue;
+	int32_t rawValue;
+};
+
+//---------------------------------------------------------------------------
+
+static bool
+readImageFile(const std::wstring_view& imageFileName, std::vector<uint8_t>& data)
+{
+	if (!ABLImageExistsCallback || !ABLImageExistsCallback(imageFileName))
+		return (false);
+	ABLFile* imageFile = new ABLFile;
+	if (!imageFile)
+		ABL_Fatal(0, " ABL: Unable to AblSystemHeap->malloc image file ");
+	if (imageFile->open(imageFileName) != ABL_NO_ERR)
+	{
+		delete imageFile;
+		return (false);
+	}
+	uint8_t buffer[4096];
+	int32_t bytesRead = 0;
+	do
+	{
+		bytesRead = imageFile->read(buffer, sizeof(buffer));
+		if (bytesRead > 0)
+			data.insert(data.end(), buffer, buffer + bytesRead);
+	} while ((bytesRead == sizeof(buffer)) && !imageFile->eof());
+	imageFile->close();
+	delete imageFile;
+	return (!data.empty());
+}
+
+//***************************************************************************
+
+bool
+compiledModuleCacheEnabled(void)
+{
+	return (CompiledModuleCacheEnabled && (ABLImageExistsCallback != nullptr));
+}
+
+//---------------------------------------------------------------------------
+
+SymTableNode*
+loadCompiledModule(const std::wstring_view& sourceFileName, int32_t eternalBase)
+{
+	wchar_t imageFileName[MAXLEN_FILENAME];
+	makeABLImageFileName(sourceFileName, imageFileName);
+	std::vector<uint8_t> data;
+	if (!readImageFile(imageFileName, data))
+		return (nullptr);
+	//-----------------------------------------------------------------
+	// First pass: parse and validate the whole image without touching
+	// the ABL heaps, so a stale or damaged image simply falls back to
+	// the parser...
+	ImageReader image(data.data(), data.size());
+	int32_t i;
+	bool isLibrary = (CurLibrary != nullptr);
+	int32_t flags = 0;
+	if (isLibrary)
+		flags |= ABL_IMAGE_FLAG_LIBRARY;
+	if (IncludeDebugInfo)
+		flags |= ABL_IMAGE_FLAG_DEBUG_INFO;
+	if ((image.getLong() != ABL_IMAGE_MAGIC) || (image.getLong() != ABL_IMAGE_VERSION) ||
+		(image.getLong() != flags) || (image.getLong() != sizeof(Address)) ||
+		(image.getLong() != sizeof(StackItem)))
+	{
+		CompiledModuleStats.numStale++;
+		return (nullptr);
+	}
+	int32_t numSourceFiles = image.getCount(MAX_SOURCE_FILES);
+	std::vector<std::wstring> sourceFiles;
+	for (i = 0; i < numSourceFiles; i++)
+	{
+		sourceFiles.push_back(image.getString());
+		uint32_t hash = (uint32_t)image.getLong();
+		if (!image.ok || (sourceFiles.back().size() >= MAXLEN_FILENAME) ||
+			(hashABLSourceFile(sourceFiles.back()) != hash))
+		{
+			CompiledModuleStats.numStale++;
+			return (nullptr);
+		}
+	}
+	//-------------------------------------------------------------
+	// Every library the image links against must already be here.
+	int32_t numLibraries = image.getCount(MAX_LIBRARIES_USED);
+	std::vector<int32_t> libraries;
+	for (i = 0; i < numLibraries; i++)
+	{
+		int32_t libraryHandle = findLibraryModule(image.getString());
+		if (libraryHandle < 0)
+			image.ok = false;
+		libraries.push_back(libraryHandle);
+	}
+	int32_t numLibrariesUsed = image.getCount(MAX_LIBRARIES_USED);
+	std::vector<int32_t> librariesUsed;
+	for (i = 0; i < numLibrariesUsed; i++)
+	{
+		int32_t libraryIndex = image.getLong();
+		if ((libraryIndex < 0) || (libraryIndex >= numLibraries))
+			image.ok = false;
+		librariesUsed.push_back(libraryIndex);
+	}
+	//---------------------------------------------------------------
+	// Rebind external symbols by name. If any went missing (say, a
+	// standard routine was renamed) the image is no good to us.
+	int32_t numExternals = image.getCount(0x100000);
+	int32_t numMainThreadCalls = 0;
+	std::vector<SymTableNode*> externals;
+	for (i = 0; (i < numExternals) && image.ok; i++)
+	{
+		int32_t scope = image.getLong();
+		DefinitionType key = (DefinitionType)image.getByte();
+		std::wstring name = image.getString();
+		SymTableNode* symbol = nullptr;
+		if (scope == IMAGE_SCOPE_GLOBAL)
+			symbol = searchSymTableForKey(name, key, SymTableDisplay[0]);
+		else if ((scope >= 0) && (scope < numLibraries))
+			symbol = searchSymTableForKey(name, key,
+				ModuleRegistry[libraries[scope]].moduleIdPtr->defn.info.routine.localSymTable);
+		if (!symbol)
+			image.ok = false;
+		//------------------------------------------------------------
+		// Function modes are set at startup, not baked into the image,
+		// so count main thread calls against the current table...
+		else if ((key == DFN_FUNCTION) && (symbol->defn.info.routine.key < NumStandardFunctions) &&
+			(FunctionInfoTable[symbol->defn.info.routine.key].mode == FUNCTION_MODE_MAIN))
+			numMainThreadCalls++;
+		externals.push_back(symbol);
+	}
+	int32_t numTypes = image.getCount(0x100000);
+	std::vector<ImageType> types(numTypes);
+	for (auto& type : types)
+	{
+		type.form = (FormType)image.getByte();
+		type.size = image.getLong();
+		type.typeId = image.getLong();
+		type.a = image.getLong();
+		type.b = image.getLong();
+		type.c = image.getLong();
+	}
+	int32_t numSegments = image.getCount(0x100000);
+	std::vector<ImageSegment> segments(numSegments);
+	for (auto& segment : segments)
+	{
+		segment.size = image.getCount(MaxCodeBufferSize);
+		segment.code.resize(segment.size);
+		if (segment.size)
+			image.getBytes(segment.code.data(), segment.size * sizeof(wchar_t));
+		int32_t numRelocations = image.getCount(segment.size);
+		for (size_t r = 0; r < numRelocations; r++)
+		{
+			int32_t offset = image.getLong();
+			int32_t ref = image.getLong();
+			if ((offset < 0) || ((offset * sizeof(wchar_t) + sizeof(SymTableNode*)) > (segment.size * sizeof(wchar_t))))
+				image.ok = false;
+			segment.relocations.push_back(std::make_pair(offset, ref));
+		}
+	}
+	int32_t numNodes = image.getCount(0x100000);
+	std::vector<ImageNode> nodes(numNodes);
+	for (auto& node : nodes)
+	{
+		node.name = image.getString();
+		node.hasInfo = (image.getByte() != 0);
+		if (node.hasInfo)
+			node.info = image.getString();
+		node.key = (DefinitionType)image.getByte();
+		node.level = image.getByte();
+		node.labelIndex = image.getLong();
+		node.type = image.getLong();
+		node.left = image.getLong();
+		node.parent = image.getLong();
+		node.right = image.getLong();
+		node.next = image.getLong();
+		switch (node.key)
+		{
+		case DFN_MODULE:
+		case DFN_PROCEDURE:
+		case DFN_FUNCTION:
+			node.routineKey = image.getByte();
+			node.flags = image.getByte();
+			node.orderCallIndex = image.getLong();
+			node.numOrderCalls = image.getLong();
+			node.paramCount = image.getByte();
+			node.totalParamSize = image.getByte();
+			node.totalLocalSize = image.getLong();
+			node.params = image.getLong();
+			node.locals = image.getLong();
+			node.localSymTable = image.getLong();
+			node.segment = image.getLong();
+			node.codeSegmentSize = image.getLong();
+			if ((node.segment < -1) || (node.segment >= numSegments))
+				image.ok = false;
+			break;
+		case DFN_VAR:
+		case DFN_VALPARAM:
+		case DFN_REFPARAM:
+			node.varType = (VariableType)image.getByte();
+			node.offset = image.getLong();
+			break;
+		default:
+			node.isString = (image.getByte() != 0);
+			if (node.isString)
+				node.stringValue = image.getString();
+			else
+				node.rawValue = image.getLong();
+			break;
+		}
+	}
+	int32_t numStaticVariables = image.getCount(MaxStaticVariables);
+	std::vector<int32_t> staticSizes(numStaticVariables);
+	for (auto& staticSize : staticSizes)
+		staticSize = image.getLong();
+	int32_t numEternals = image.getCount(MaxEternalVariables - eternalBase);
+	std::vector<int32_t> eternalSizes(numEternals);
+	for (auto& eternalSize : eternalSizes)
+		eternalSize = image.getLong();
+	int32_t numOrderCalls = image.getLong();
+	int32_t numSharedWrites = image.getLong();
+	int32_t numStateHandles = image.getCount(MAX_STATE_HANDLES_PER_MODULE);
+	std::vector<int32_t> stateHandles;
+	for (i = 1; i < numStateHandles; i++)
+		stateHandles.push_back(image.getLong());
+	int32_t moduleRef = image.getLong();
+	//-----------------------------------------------------
+	// Check every cross reference before we build a thing.
+	auto validNodeRef = [&](int32_t ref) {
+		return ((ref == 0) || ((ref > 0) && (ref <= numNodes)) || ((ref < 0) && (-ref <= numExternals)));
+	};
+	auto validTypeRef = [&](int32_t ref) {
+		return ((ref >= IMAGE_TYPE_DUMMY) && (ref <= numTypes));
+	};
+	for (auto& type : types)
+		if (!validNodeRef(type.typeId) ||
+			((type.form == FRM_ENUM) && !validNodeRef(type.a)) ||
+			((type.form == FRM_ARRAY) && (!validTypeRef(type.a) || !validTypeRef(type.b))))
+			image.ok = false;
+	for (auto& segment : segments)
+		for (auto& relocation : segment.relocations)
+			if (!validNodeRef(relocation.second))
+				image.ok = false;
+	for (auto& node : nodes)
+	{
+		if (!validTypeRef(node.type) || !validNodeRef(node.left) || !validNodeRef(node.parent) ||
+			!validNodeRef(node.right) || !validNodeRef(node.next))
+			image.ok = false;
+		if (((node.key == DFN_MODULE) || (node.key == DFN_PROCEDURE) || (node.key == DFN_FUNCTION)) &&
+			(!validNodeRef(node.params) || !validNodeRef(node.locals) || !validNodeRef(node.localSymTable)))
+			image.ok = false;
+		if ((node.key == DFN_VAR) && (node.varType == VAR_TYPE_ETERNAL) &&
+			((node.offset < 0) || (node.offset >= numEternals)))
+			image.ok = false;
+	}
+	for (auto ref : stateHandles)
+		if ((ref <= 0) || (ref > numNodes))
+			image.ok = false;
+	if ((moduleRef <= 0) || (moduleRef > numNodes))
+		image.ok = false;
+	if (!image.ok || (image.pos != image.size))
+	{
+		CompiledModuleStats.numStale++;
+		return (nullptr);
+	}
+	//--------------------------------------------------------------
+	// Second pass: materialize the module. From here on it's no
+	// different than what the parser would have allocated...
+	std::vector<SymTableNode*> nodePtrs(numNodes);
+	for (i = 0; i < numNodes; i++)
+	{
+		nodePtrs[i] = (SymTableNode*)ABLSymbolMallocCallback(sizeof(SymTableNode));
+		if (!nodePtrs[i])
+			ABL_Fatal(0, " ABL: Unable to AblSymTableHeap->malloc symbol ");
+		memset(nodePtrs[i], 0, sizeof(SymTableNode));
+	}
+	std::vector<Type*> typePtrs(numTypes);
+	for (i = 0; i < numTypes; i++)
+		typePtrs[i] = createType();
+	std::vector<Address> segmentPtrs(numSegments);
+	for (i = 0; i < numSegments; i++)
+	{
+		segmentPtrs[i] = (Address)ABLCodeMallocCallback(segments[i].size * sizeof(wchar_t));
+		if (!segmentPtrs[i])
+			ABL_Fatal(0, " ABL: Unable to AblCodeHeap->malloc code segment ");
+	}
+	auto nodeFromRef = [&](int32_t ref) -> SymTableNode* {
+		if (ref > 0)
+			return (nodePtrs[ref - 1]);
+		if (ref < 0)
+			return (externals[-ref - 1]);
+		return (nullptr);
+	};
+	auto typeFromRef = [&](int32_t ref) -> Type* {
+		switch (ref)
+		{
+		case 0:
+			return (nullptr);
+		case IMAGE_TYPE_INTEGER:
+			return (IntegerTypePtr);
+		case IMAGE_TYPE_CHAR:
+			return (CharTypePtr);
+		case IMAGE_TYPE_REAL:
+			return (RealTypePtr);
+		case IMAGE_TYPE_BOOLEAN:
+			return (BooleanTypePtr);
+		case IMAGE_TYPE_DUMMY:
+			return (&DummyType);
+		}
+		return (typePtrs[ref - 1]);
+	};
+	auto copyString = [](const std::wstring& s) -> std::wstring_view {
+		wchar_t* buffer = (wchar_t*)ABLSymbolMallocCallback((s.size() + 1) * sizeof(wchar_t));
+		if (!buffer)
+			ABL_Fatal(0, " ABL: Unable to AblSymTableHeap->malloc symbol name ");
+		memcpy(buffer, s.c_str(), (s.size() + 1) * sizeof(wchar_t));
+		return (std::wstring_view(buffer, s.size()));
+	};
+	for (i = 0; i < numTypes; i++)
+	{
+		Type* type = typePtrs[i];
+		type->form = types[i].form;
+		type->size = types[i].size;
+		type->typeIdPtr = nodeFromRef(types[i].typeId);
+		if (type->form == FRM_ENUM)
+		{
+			type->info.enumeration.constIdPtr = nodeFromRef(types[i].a);
+			type->info.enumeration.max = types[i].b;
+		}
+		else if (type->form == FRM_ARRAY)
+		{
+			type->info.array.indexTypePtr = typeFromRef(types[i].a);
+			type->info.array.elementTypePtr = typeFromRef(types[i].b);
+			type->info.array.elementCount = types[i].c;
+		}
+	}
+	for (i = 0; i < numSegments; i++)
+	{
+		memcpy(segmentPtrs[i], segments[i].code.data(), segments[i].size * sizeof(wchar_t));
+		for (auto& relocation : segments[i].relocations)
+			*((SymTableNode**)(segmentPtrs[i] + relocation.first)) = nodeFromRef(relocation.second);
+	}
+	for (i = 0; i < numNodes; i++)
+	{
+		ImageNode& src = nodes[i];
+		SymTableNode* node = nodePtrs[i];
+		node->name = internSymbolName(src.name);
+		if (src.hasInfo)
+			node->info = copyString(src.info);
+		node->defn.key = src.key;
+		node->level = src.level;
+		node->labelIndex = src.labelIndex;
+		node->ptype = typeFromRef(src.type);
+		if (node->ptype)
+			node->ptype->numInstances++;
+		node->library = CurLibrary;
+		node->left = nodeFromRef(src.left);
+		node->parent = nodeFromRef(src.parent);
+		node->right = nodeFromRef(src.right);
+		node->next = nodeFromRef(src.next);
+		switch (src.key)
+		{
+		case DFN_MODULE:
+		case DFN_PROCEDURE:
+		case DFN_FUNCTION:
+		{
+			Routine& routine = node->defn.info.routine;
+			routine.key = (RoutineKey)src.routineKey;
+			routine.flags = src.flags;
+			routine.orderCallIndex = src.orderCallIndex;
+			routine.numOrderCalls = src.numOrderCalls;
+			routine.paramCount = src.paramCount;
+			routine.totalParamSize = src.totalParamSize;
+			routine.totalLocalSize = src.totalLocalSize;
+			routine.params = nodeFromRef(src.params);
+			routine.locals = nodeFromRef(src.locals);
+			routine.localSymTable = nodeFromRef(src.localSymTable);
+			routine.codeSegment = (src.segment >= 0) ? segmentPtrs[src.segment] : nullptr;
+			routine.codeSegmentSize = src.codeSegmentSize;
+			routine.nativeCode = nullptr;
+		}
+		break;
+		case DFN_VAR:
+		case DFN_VALPARAM:
+		case DFN_REFPARAM:
+			node->defn.info.data.varType = src.varType;
+			node->defn.info.data.offset = src.offset;
+			if (src.varType == VAR_TYPE_ETERNAL)
+				node->defn.info.data.offset += eternalBase;
+			node->defn.info.data.registeredData = nullptr;
+			break;
+		default:
+			if (src.isString)
+				node->defn.info.constant.value.stringPtr = copyString(src.stringValue);
+			else
+				memcpy(&node->defn.info.constant.value, &src.rawValue, sizeof(int32_t));
+			break;
+		}
+	}
+	//------------------------------------------------------------
+	// Level-0 nodes (the module itself and its eternals) have to
+	// be hooked back into the global table...
+	for (i = 0; i < numNodes; i++)
+		if (nodePtrs[i]->level == 0)
+			insertSymTable(&SymTableDisplay[0], nodePtrs[i]);
+	//-----------------------------------------------------------------
+	// Set up the eternal variables just as varDeclarations() would...
+	for (i = 0; i < numEternals; i++)
+	{
+		StackItem* dataPtr = stack + eternalBase + i;
+		EternalVariablesSizes[eternalBase + i] = eternalSizes[i];
+		if (eternalSizes[i] > 0)
+		{
+			dataPtr->address = (Address)ABLStackMallocCallback((size_t)eternalSizes[i]);
+			if (!dataPtr->address)
+				ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc eternal array ");
+			memset(dataPtr->address, 0, eternalSizes[i]);
+		}
+		else
+			dataPtr->integer = 0;
+	}
+	eternalOffset = eternalBase + numEternals;
+	//--------------------------------------------------------------
+	// Finally, fill in the compile globals ABLi_preProcess registers
+	// the module from...
+	NumSourceFiles = numSourceFiles;
+	for (i = 0; i < numSourceFiles; i++)
+		wcscpy(SourceFiles[i], sourceFiles[i].c_str());
+	NumLibrariesUsed = numLibrariesUsed;
+	for (i = 0; i < numLibrariesUsed; i++)
+		LibrariesUsed[i] = ModuleRegistry[libraries[librariesUsed[i]]].moduleIdPtr->library;
+	NumStaticVariables = numStaticVariables;
+	for (i = 0; i < numStaticVariables; i++)
+		StaticVariablesSizes[i] = staticSizes[i];
+	NumOrderCalls = numOrderCalls;
+	NumSharedWrites = numSharedWrites;
+	NumMainThreadCalls = numMainThreadCalls;
+	NumStateHandles = numStateHandles;
+	for (i = 1; i < numStateHandles; i++)
+	{
+		SymTableNode* state = nodePtrs[stateHandles[i - 1] - 1];
+		wcsncpy(StateHandleList[i].name, state->name.data(), 127);
+		StateHandleList[i].name[127] = 0;
+		StateHandleList[i].state = state;
+	}
+	CompiledModuleStats.numLoaded++;
+	return (nodePtrs[moduleRef - 1]);
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+saveCompiledModule(int32_t moduleHandle, int32_t eternalBase)
+{
+	//-----------------------------------------------------------------
+	// Called right after a successful compile, while the module's
+	// compile globals (source files, statics, state handles) are still
+	// live. Returns ABL_NO_ERR, or -1 if this module can't be imaged.
+	SymTableNode* moduleIdPtr = ModuleRegistry[moduleHandle].moduleIdPtr;
+	ImageBuilder builder(moduleIdPtr, eternalBase);
+	if (!builder.collect())
+	{
+		discardCodeRelocations();
+		return (-1);
+	}
+	ImageWriter image;
+	builder.write(image);
+	discardCodeRelocations();
+	wchar_t imageFileName[MAXLEN_FILENAME];
+	makeABLImageFileName(ModuleRegistry[moduleHandle].fileName, imageFileName);
+	ABLFile* imageFile = new ABLFile;
+	if (!imageFile)
+		ABL_Fatal(0, " ABL: Unable to AblSystemHeap->malloc image file ");
+	if (imageFile->create(imageFileName) != ABL_NO_ERR)
+	{
+		delete imageFile;
+		return (-1);
+	}
+	imageFile->write(image.data.data(), image.data.size());
+	imageFile->close();
+	delete imageFile;
+	CompiledModuleStats.numWritten++;
+	return (ABL_NO_ERR);
+}
+
+//***************************************************************************
+
+} // namespace mclib::abl
@@ -0,0 +1,87 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+//***************************************************************************
+//
+//								ABLIMAGE.H
+//
+//***************************************************************************
+
+#pragma once
+
+#ifndef ABLIMAGE_H
+#define ABLIMAGE_H
+
+//#include "ablgen.h"
+//#include "ablsymt.h"
+//#include "ablenv.h"
+
+namespace mclib::abl {
+
+//***************************************************************************
+
+//---------------------------------------------------------------------------
+// A compiled module image (.abx) is a flat dump of everything
+// ABLi_preProcess builds for one module: its symbol nodes and types, the
+// crunched code segments, the static/eternal variable layout and the state
+// handle list. Symbol pointers inside the code are stored as relocations,
+// and symbols that live outside the module (level-0 standard routines,
+// types, registered variables and library members) are stored by name and
+// re-resolved at load time. The image records a hash of every source file
+// that went into it, so an edited .abl (or include) forces a recompile.
+
+#define ABL_IMAGE_MAGIC 0x58424C41 // "ABLX"
+#define ABL_IMAGE_VERSION 2
+#define ABL_IMAGE_EXTENSION L".abx"
+
+#define ABL_IMAGE_FLAG_LIBRARY 1
+#define ABL_IMAGE_FLAG_DEBUG_INFO 2
+
+struct ABLImageStats
+{
+	int32_t numLoaded; // images used in place of the parser
+	int32_t numStale; // images rejected by version or source hash
+	int32_t numWritten; // images (re)built after a compile
+	int32_t numCompiled; // modules that went through the parser
+};
+
+//***************************************************************************
+
+//----------
+// FUNCTIONS
+
+uint32_t
+hashABLSourceFile(const std::wstring_view& fileName);
+void
+makeABLImageFileName(const std::wstring_view& sourceFileName, wchar_t* imageFileName);
+
+//--------------------------------------------------------
+// Called by the crunch routines while a module compiles...
+void
+recordCodeRelocation(int32_t offset);
+void
+shiftCodeRelocations(int32_t fromOffset, int32_t delta);
+void
+truncateCodeRelocations(int32_t endOffset);
+void
+bindCodeRelocations(Address codeSegment, int32_t codeSegmentSize);
+void
+discardCodeRelocations(void);
+
+//-----------------------------------------
+// Called by ABLi_preProcess to use/refresh
+// the compiled image...
+bool
+compiledModuleCacheEnabled(void);
+SymTableNode*
+loadCompiledModule(const std::wstring_view& sourceFileName, int32_t eternalBase);
+int32_t
+saveCompiledModule(int32_t moduleHandle, int32_t eternalBase);
+
+//***************************************************************************
+
+extern ABLImageStats CompiledModuleStats;
+
+} // namespace mclib::abl
+
+#endif
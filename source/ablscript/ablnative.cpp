@@ -0,0 +1,308 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+//***************************************************************************
+//
+//								ABLNATIVE.CPP
+//
+//***************************************************************************
+#include "stdinc.h"
+
+//#include "ablgen.h"
+//#include "ablerr.h"
+//#include "ablscan.h"
+//#include "ablsymt.h"
+//#include "ablexec.h"
+//#include "ablenv.h"
+//#include "ablimage.h"
+//#include "ablnative.h"
+
+namespace mclib::abl {
+
+//***************************************************************************
+
+//--------
+// GLOBALS
+const ABLNativeModule* NativeModules[MAX_NATIVE_MODULES];
+int32_t NumNativeModules = 0;
+ABLNativeStats NativeModuleStats = {0, 0, 0, 0};
+
+//----------
+// EXTERNALS
+
+extern const std::unique_ptr<ModuleEntry>& ModuleRegistry;
+extern int32_t NumModulesRegistered;
+extern bool IncludeDebugInfo;
+extern bool AutoReturnFromOrders;
+extern int32_t MaxLoopIterations;
+
+//***************************************************************************
+// REGISTRY routines
+//***************************************************************************
+
+uint32_t
+hashABLModuleSources(int32_t moduleHandle)
+{
+	//-----------------------------------------------------------
+	// FNV-1a over the per-file hashes, in include order. A module
+	// whose files won't open hashes to something no native module
+	// was built from...
+	uint32_t hash = 2166136261;
+	for (size_t i = 0; i < ModuleRegistry[moduleHandle].numSourceFiles; i++)
+	{
+		uint32_t fileHash = hashABLSourceFile(ModuleRegistry[moduleHandle].sourceFiles[i]);
+		for (size_t j = 0; j < 4; j++)
+		{
+			hash ^= (fileHash >> (j * 8)) & 0xFF;
+			hash *= 16777619;
+		}
+	}
+	return (hash ? hash : 1);
+}
+
+//---------------------------------------------------------------------------
+
+SymTableNode*
+findNativeRoutine(const std::unique_ptr<SymTableNode>& moduleIdPtr, const wchar_t* name)
+{
+	if (moduleIdPtr->name == std::wstring_view(name))
+		return (moduleIdPtr);
+	const std::unique_ptr<SymTableNode>& routineIdPtr =
+		searchSymTable(name, moduleIdPtr->defn.info.routine.localSymTable);
+	if (!routineIdPtr || (routineIdPtr->defn.key != DFN_FUNCTION) || (routineIdPtr->defn.info.routine.key != RTN_DECLARED))
+		return (nullptr);
+	return (routineIdPtr);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+tryBindNativeModule(const ABLNativeModule* nativeModule, int32_t moduleHandle, uint32_t& sourceHash)
+{
+	const std::unique_ptr<SymTableNode>& moduleIdPtr = ModuleRegistry[moduleHandle].moduleIdPtr;
+	if (moduleIdPtr->name != std::wstring_view(nativeModule->name))
+		return (false);
+	//-------------------------------------------------------------
+	// Same module name. Now make sure it's the same module: every
+	// source file unchanged, the same statement marker layout, and
+	// every translated routine still there at the same size...
+	if (!sourceHash)
+		sourceHash = hashABLModuleSources(moduleHandle);
+	bool matches = (nativeModule->sourceHash == sourceHash) && (nativeModule->debugInfo == IncludeDebugInfo);
+	for (size_t i = 0; matches && (i < nativeModule->numRoutines); i++)
+	{
+		const SymTableNode* routineIdPtr = findNativeRoutine(moduleIdPtr, nativeModule->routines[i].name);
+		matches = routineIdPtr && (routineIdPtr->defn.info.routine.codeSegmentSize == nativeModule->routines[i].codeSegmentSize);
+	}
+	if (!matches)
+	{
+		NativeModuleStats.numStale++;
+		return (false);
+	}
+	for (size_t i = 0; i < nativeModule->numRoutines; i++)
+	{
+		SymTableNode* routineIdPtr = findNativeRoutine(moduleIdPtr, nativeModule->routines[i].name);
+		routineIdPtr->defn.info.routine.nativeCode = nativeModule->routines[i].code;
+	}
+	NativeModuleStats.numBound++;
+	NativeModuleStats.numRoutinesBound += nativeModule->numRoutines;
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+
+void
+registerNativeModule(const ABLNativeModule* nativeModule)
+{
+	if (NumNativeModules == MAX_NATIVE_MODULES)
+		ABL_Fatal(0, " ABL: too many native modules ");
+	NativeModules[NumNativeModules++] = nativeModule;
+	NativeModuleStats.numRegistered++;
+	//-----------------------------------------------------------
+	// Normally we're registered before any module compiles, but
+	// catch up on anything already loaded...
+	for (size_t i = 0; i < NumModulesRegistered; i++)
+	{
+		uint32_t sourceHash = 0;
+		tryBindNativeModule(nativeModule, i, sourceHash);
+	}
+}
+
+//---------------------------------------------------------------------------
+
+void
+bindNativeModule(int32_t moduleHandle)
+{
+	//-------------------------------------------------------------
+	// Called as each module is registered. Only hash the sources if
+	// some native module claims the same name...
+	uint32_t sourceHash = 0;
+	for (size_t i = 0; i < NumNativeModules; i++)
+		if (tryBindNativeModule(NativeModules[i], moduleHandle, sourceHash))
+			return;
+}
+
+//---------------------------------------------------------------------------
+
+void
+closeNativeModules(void)
+{
+	NumNativeModules = 0;
+	memset(&NativeModuleStats, 0, sizeof(ABLNativeStats));
+}
+
+//***************************************************************************
+// RUNTIME routines
+//***************************************************************************
+
+void
+nativeStatement(int32_t fileNumber, int32_t lineNumber, int32_t offset)
+{
+	//----------------------------------------------------------
+	// Same bookkeeping execStatement() does at a statement marker...
+	if (fileNumber >= 0)
+		CurContext->fileNumber = fileNumber;
+	CurContext->execLineNumber = lineNumber;
+	CurContext->execStatementCount++;
+	CurContext->statementStartPtr = CurContext->routineIdPtr->defn.info.routine.codeSegment + offset;
+	if (ProfilerEnabled && (--CurContext->profileCountdown <= 0))
+		profileSample();
+}
+
+//---------------------------------------------------------------------------
+
+void
+nativeExecStatement(int32_t offset)
+{
+	CurContext->codeSegmentPtr = CurContext->routineIdPtr->defn.info.routine.codeSegment + offset;
+	getCodeToken();
+	execStatement();
+}
+
+//---------------------------------------------------------------------------
+
+StackItem
+nativeEvalExpression(int32_t offset)
+{
+	CurContext->codeSegmentPtr = CurContext->routineIdPtr->defn.info.routine.codeSegment + offset;
+	getCodeToken();
+	execExpression();
+	StackItem value = *CurContext->tos;
+	pop();
+	return (value);
+}
+
+//---------------------------------------------------------------------------
+
+StackItem
+nativeEvalFactor(int32_t offset)
+{
+	CurContext->codeSegmentPtr = CurContext->routineIdPtr->defn.info.routine.codeSegment + offset;
+	getCodeToken();
+	execFactor();
+	StackItem value = *CurContext->tos;
+	pop();
+	return (value);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+nativeEnterCode(void)
+{
+	bool wasAutoReturnFromOrders = AutoReturnFromOrders;
+	AutoReturnFromOrders =
+		((CurContext->routineIdPtr->defn.info.routine.flags & (ROUTINE_FLAG_ORDER + ROUTINE_FLAG_STATE)) != 0);
+	return (wasAutoReturnFromOrders);
+}
+
+//---------------------------------------------------------------------------
+
+void
+nativeExitCode(bool wasAutoReturnFromOrders)
+{
+	//---------------------------------------------------------
+	// Like the interpreter, leave it alone if a state changed...
+	if (!CurContext->newStateSet)
+		AutoReturnFromOrders = wasAutoReturnFromOrders;
+}
+
+//---------------------------------------------------------------------------
+
+StackItem*
+nativeVariable(int32_t level, int32_t offset)
+{
+	StackFrameHeader* headerPtr = (StackFrameHeader*)CurContext->stackFrameBasePtr;
+	int32_t delta = CurContext->level - level;
+	while (delta-- > 0)
+		headerPtr = (StackFrameHeader*)headerPtr->staticLink.address;
+	return ((StackItem*)headerPtr + offset);
+}
+
+//---------------------------------------------------------------------------
+
+Address
+nativeSubscript(Address arrayPtr, int32_t index, int32_t elementCount, int32_t elementSize)
+{
+	if ((index < 0) || (index >= elementCount))
+		runtimeError(ABL_ERR_RUNTIME_VALUE_OUT_OF_RANGE);
+	return (arrayPtr + (index * elementSize));
+}
+
+//---------------------------------------------------------------------------
+
+void
+nativeLoopCheck(int32_t& iterations)
+{
+	if (++iterations == MaxLoopIterations)
+		runtimeError(ABL_ERR_RUNTIME_INFINITE_LOOP);
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+nativeDivide(int32_t dividend, int32_t divisor)
+{
+	if (divisor == 0)
+	{
+#ifdef _DEBUG
+		runtimeError(ABL_ERR_RUNTIME_DIVISION_BY_ZERO);
+#endif
+		return (0);
+	}
+	return (dividend / divisor);
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+nativeModulo(int32_t dividend, int32_t divisor)
+{
+	if (divisor == 0)
+	{
+#ifdef _DEBUG
+		runtimeError(ABL_ERR_RUNTIME_DIVISION_BY_ZERO);
+#endif
+		return (0);
+	}
+	return (dividend % divisor);
+}
+
+//---------------------------------------------------------------------------
+
+float
+nativeRealDivide(float dividend, float divisor)
+{
+	if (divisor == 0.0)
+	{
+#ifdef _DEBUG
+		runtimeError(ABL_ERR_RUNTIME_DIVISION_BY_ZERO);
+#endif
+		return (0.0);
+	}
+	return (dividend / divisor);
+}
+
+//***************************************************************************
+
+} // namespace mclib::abl
@@ -0,0 +1,110 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+//***************************************************************************
+//
+//								ABLNATIVE.H
+//
+//***************************************************************************
+
+#pragma once
+
+#ifndef ABLNATIVE_H
+#define ABLNATIVE_H
+
+//#include "ablgen.h"
+//#include "ablsymt.h"
+//#include "ablexec.h"
+
+namespace mclib::abl {
+
+//***************************************************************************
+
+//---------------------------------------------------------------------------
+// A native module is an ABL module translated to C++ ahead of time (ablt
+// -cpp). Each translated routine body runs on the interpreter's own stack
+// frames, so locals, statics and eternals stay where the executor expects
+// them. Control flow and arithmetic are compiled; calls and anything else
+// the translator can't prove equivalent are handed back to the interpreter
+// one statement (or expression) at a time, by code segment offset.
+//
+// A native module only binds to a compiled module whose sources hash the
+// same and whose routines have the same code segment sizes. Anything else
+// keeps running interpreted.
+
+#define MAX_NATIVE_MODULES 256
+
+struct ABLNativeRoutine
+{
+	const wchar_t* name;
+	int32_t codeSegmentSize;
+	ABLNativeCode code;
+};
+
+struct ABLNativeModule
+{
+	const wchar_t* name;
+	uint32_t sourceHash;
+	bool debugInfo; // statement markers carry file/line
+	int32_t numRoutines;
+	const ABLNativeRoutine* routines;
+};
+
+struct ABLNativeStats
+{
+	int32_t numRegistered;
+	int32_t numBound; // modules now running native code
+	int32_t numStale; // registered, but the module no longer matches
+	int32_t numRoutinesBound;
+};
+
+//***************************************************************************
+
+//----------
+// FUNCTIONS
+
+uint32_t
+hashABLModuleSources(int32_t moduleHandle);
+void
+registerNativeModule(const ABLNativeModule* nativeModule);
+void
+bindNativeModule(int32_t moduleHandle);
+void
+closeNativeModules(void);
+
+//------------------------------------------
+// Called by translated routine bodies. The
+// offsets are into the running routine's
+// code segment...
+void
+nativeStatement(int32_t fileNumber, int32_t lineNumber, int32_t offset);
+void
+nativeExecStatement(int32_t offset);
+StackItem
+nativeEvalExpression(int32_t offset);
+StackItem
+nativeEvalFactor(int32_t offset);
+bool
+nativeEnterCode(void);
+void
+nativeExitCode(bool wasAutoReturnFromOrders);
+StackItem*
+nativeVariable(int32_t level, int32_t offset);
+Address
+nativeSubscript(Address arrayPtr, int32_t index, int32_t elementCount, int32_t elementSize);
+void
+nativeLoopCheck(int32_t& iterations);
+int32_t
+nativeDivide(int32_t dividend, int32_t divisor);
+int32_t
+nativeModulo(int32_t dividend, int32_t divisor);
+float
+nativeRealDivide(float dividend, float divisor);
+
+//***************************************************************************
+
+extern ABLNativeStats NativeModuleStats;
+
+} // namespace mclib::abl
+
+#endif
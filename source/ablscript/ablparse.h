@@ -41,6 +41,8 @@ const std::unique_ptr<Type>&
 expression(void);
 const std::unique_ptr<Type>&
 variable(const std::unique_ptr<SymTableNode>& variableIdPtr);
+bool
+isSharedVariable(const std::unique_ptr<SymTableNode>& idPtr);
 const std::unique_ptr<Type>&
 arraySubscriptList(const std::unique_ptr<Type>& ptype);
 // const std::unique_ptr<Type>& routineCall (const std::unique_ptr<SymTableNode>& routineIdPtr, BOOL parmCheckFlag);
@@ -0,0 +1,431 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+//***************************************************************************
+//
+//								ABLPROF.CPP
+//
+//***************************************************************************
+#include "stdinc.h"
+
+//#include "ablgen.h"
+//#include "ablerr.h"
+//#include "ablscan.h"
+//#include "ablsymt.h"
+//#include "ablexec.h"
+//#include "ablenv.h"
+//#include "ablprof.h"
+
+namespace mclib::abl {
+
+//***************************************************************************
+
+//--------
+// GLOBALS
+bool ProfilerEnabled = false;
+ABLProfileStats ProfilerStats = {0, 0, 0, 0, 0};
+int32_t ProfileSampleInterval = ABL_PROFILE_DEFAULT_INTERVAL;
+ABLProfileNode* ProfileNodes = nullptr;
+ABLProfileSite* ProfileSites = nullptr;
+int64_t ProfileTicksPerSecond = 1;
+std::mutex ProfileLock;
+
+//----------
+// EXTERNALS
+
+extern const std::unique_ptr<ModuleEntry>& ModuleRegistry;
+extern int32_t NumModulesRegistered;
+
+//***************************************************************************
+// SAMPLING routines
+//***************************************************************************
+
+inline int64_t
+profileClock(void)
+{
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (counter.QuadPart);
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+findProfileChild(int32_t parent, const ABLProfileFrame& frame)
+{
+	int32_t child = ProfileNodes[parent].firstChild;
+	while (child != -1)
+	{
+		if ((ProfileNodes[child].routine == frame.routine) && (ProfileNodes[child].moduleHandle == frame.moduleHandle))
+			return (child);
+		child = ProfileNodes[child].nextSibling;
+	}
+	if (ProfilerStats.numNodes == MAX_PROFILE_NODES)
+		return (-1);
+	child = ProfilerStats.numNodes++;
+	ABLProfileNode* node = &ProfileNodes[child];
+	node->routine = frame.routine;
+	node->moduleHandle = frame.moduleHandle;
+	node->native = frame.native;
+	node->parent = parent;
+	node->firstChild = -1;
+	node->nextSibling = ProfileNodes[parent].firstChild;
+	node->ticks = 0;
+	node->samples = 0;
+	node->statements = 0;
+	ProfileNodes[parent].firstChild = child;
+	return (child);
+}
+
+//---------------------------------------------------------------------------
+
+ABLProfileSite*
+findProfileSite(SymTableNode* routine, int32_t moduleHandle, int32_t line, bool native)
+{
+	uint32_t hash = (uint32_t)((size_t)routine >> 4) ^ ((uint32_t)moduleHandle * 31) ^ ((uint32_t)line * 2654435761u);
+	for (size_t probe = 0; probe < MAX_PROFILE_SITES; probe++)
+	{
+		ABLProfileSite* site = &ProfileSites[(hash + probe) & (MAX_PROFILE_SITES - 1)];
+		if (!site->routine)
+		{
+			site->routine = routine;
+			site->moduleHandle = moduleHandle;
+			site->line = line;
+			site->native = native;
+			ProfilerStats.numSites++;
+			return (site);
+		}
+		if ((site->routine == routine) && (site->moduleHandle == moduleHandle) && (site->line == line))
+			return (site);
+	}
+	return (nullptr);
+}
+
+//---------------------------------------------------------------------------
+
+void
+profileSample(void)
+{
+	ABLExecContext* context = CurContext;
+	int64_t now = profileClock();
+	int64_t ticks = now - context->profileLastSample;
+	int32_t statements = ProfileSampleInterval - context->profileCountdown;
+	if (statements > ProfileSampleInterval)
+		statements = ProfileSampleInterval;
+	context->profileLastSample = now;
+	context->profileCountdown = ProfileSampleInterval;
+	int32_t depth = context->profileDepth;
+	if (depth > MAX_PROFILE_DEPTH)
+		depth = MAX_PROFILE_DEPTH;
+	if (depth == 0)
+		return;
+	std::lock_guard<std::mutex> lock(ProfileLock);
+	if (!ProfileNodes)
+		return;
+	ProfilerStats.numSamples++;
+	ProfilerStats.totalTicks += ticks;
+	//-----------------------------------------------------------
+	// Walk (and grow) the call tree down to where we are now. If
+	// the tree is full, the time stays with the deepest node we
+	// could reach...
+	int32_t curNode = 0;
+	for (size_t i = 0; i < depth; i++)
+	{
+		int32_t child = findProfileChild(curNode, context->profileFrames[i]);
+		if (child == -1)
+		{
+			ProfilerStats.numDropped++;
+			break;
+		}
+		curNode = child;
+	}
+	ProfileNodes[curNode].ticks += ticks;
+	ProfileNodes[curNode].samples++;
+	ProfileNodes[curNode].statements += statements;
+	//--------------------------------------------------------------
+	// The site is the line of the innermost script routine, or the
+	// native it's sitting in...
+	ABLProfileFrame* top = &context->profileFrames[depth - 1];
+	int32_t scriptFrame = depth - 1;
+	while ((scriptFrame > 0) && context->profileFrames[scriptFrame].native)
+		scriptFrame--;
+	ABLProfileSite* site = findProfileSite(top->native ? top->routine : context->profileFrames[scriptFrame].routine,
+		context->profileFrames[scriptFrame].moduleHandle, context->execLineNumber, top->native);
+	if (!site)
+	{
+		ProfilerStats.numDropped++;
+		return;
+	}
+	site->ticks += ticks;
+	site->samples++;
+	site->statements += statements;
+}
+
+//---------------------------------------------------------------------------
+
+void
+profileModuleBegin(void)
+{
+	CurContext->profileDepth = 0;
+	CurContext->profileCountdown = ProfileSampleInterval;
+	CurContext->profileLastSample = profileClock();
+}
+
+//---------------------------------------------------------------------------
+
+void
+profileModuleEnd(void)
+{
+	CurContext->profileDepth = 0;
+}
+
+//---------------------------------------------------------------------------
+
+void
+profileRoutineEntry(SymTableNode* routineIdPtr, bool native)
+{
+	//---------------------------------------------------------------
+	// Natives get a sample on each side, so their time is their own
+	// (and the caller's time up to the call isn't charged to them)...
+	if (native)
+		profileSample();
+	if (CurContext->profileDepth < MAX_PROFILE_DEPTH)
+	{
+		ABLProfileFrame* frame = &CurContext->profileFrames[CurContext->profileDepth];
+		frame->routine = routineIdPtr;
+		frame->moduleHandle = CurContext->moduleHandle;
+		frame->native = native;
+	}
+	CurContext->profileDepth++;
+}
+
+//---------------------------------------------------------------------------
+
+void
+profileRoutineExit(void)
+{
+	//-------------------------------------------------------------
+	// Close out a native's time, and whatever the module did since
+	// the last sample when it finishes...
+	if ((CurContext->profileDepth == 1) || ((CurContext->profileDepth > 0) && (CurContext->profileDepth <= MAX_PROFILE_DEPTH)
+		&& CurContext->profileFrames[CurContext->profileDepth - 1].native))
+		profileSample();
+	if (CurContext->profileDepth > 0)
+		CurContext->profileDepth--;
+}
+
+//***************************************************************************
+// REPORT routines
+//***************************************************************************
+
+void
+getProfileFrameName(ABLProfileNode* node, wchar_t* name)
+{
+	if (node->native)
+		sprintf(name, "%s [native]", node->routine->name);
+	else if ((node->moduleHandle >= 0) && (node->moduleHandle < NumModulesRegistered)
+		&& (node->routine != ModuleRegistry[node->moduleHandle].moduleIdPtr))
+		sprintf(name, "%s::%s", ModuleRegistry[node->moduleHandle].moduleIdPtr->name, node->routine->name);
+	else
+		sprintf(name, "%s", node->routine->name);
+}
+
+//---------------------------------------------------------------------------
+
+int64_t
+profileTicksToMicroseconds(int64_t ticks)
+{
+	return ((ticks * 1000000) / ProfileTicksPerSecond);
+}
+
+//---------------------------------------------------------------------------
+
+void
+writeProfileStacks(ABLFile* file, int32_t nodeIndex, wchar_t* stackName, size_t stackLen)
+{
+	ABLProfileNode* node = &ProfileNodes[nodeIndex];
+	wchar_t frameName[256];
+	getProfileFrameName(node, frameName);
+	size_t frameLen = strlen(frameName);
+	//--------------------------------------------------
+	// Stacks too deep for the buffer fold into their
+	// parent, which is fine for a flame graph...
+	size_t newLen = stackLen;
+	if ((stackLen + frameLen + 2) < 4096)
+	{
+		if (stackLen > 0)
+			stackName[newLen++] = ';';
+		strcpy(&stackName[newLen], frameName);
+		newLen += frameLen;
+	}
+	int64_t micros = profileTicksToMicroseconds(node->ticks);
+	if (micros > 0)
+	{
+		wchar_t s[4200];
+		sprintf(s, "%s %lld\n", stackName, micros);
+		file->writeString(s);
+	}
+	for (int32_t child = node->firstChild; child != -1; child = ProfileNodes[child].nextSibling)
+		writeProfileStacks(file, child, stackName, newLen);
+	stackName[stackLen] = nullptr;
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+writeProfileTable(ABLFile* file, int32_t topN)
+{
+	std::vector<ABLProfileSite*> sites;
+	sites.reserve(ProfilerStats.numSites);
+	for (size_t i = 0; i < MAX_PROFILE_SITES; i++)
+		if (ProfileSites[i].routine)
+			sites.push_back(&ProfileSites[i]);
+	std::sort(sites.begin(), sites.end(), [](ABLProfileSite* a, ABLProfileSite* b) { return (a->ticks > b->ticks); });
+	if ((topN <= 0) || (topN > (int32_t)sites.size()))
+		topN = (int32_t)sites.size();
+	wchar_t s[512];
+	sprintf(s, "ABL profile: %d samples, %lld ms, %d sites, %d dropped\n\n", ProfilerStats.numSamples,
+		profileTicksToMicroseconds(ProfilerStats.totalTicks) / 1000, ProfilerStats.numSites,
+		ProfilerStats.numDropped);
+	file->writeString(s);
+	sprintf(s, "%4s %7s %10s %8s %10s  %-24s %-32s %6s\n", "#", "time%", "ms", "samples", "statements",
+		"module", "routine", "line");
+	file->writeString(s);
+	float totalTime = (float)(ProfilerStats.totalTicks > 0 ? ProfilerStats.totalTicks : 1);
+	for (size_t i = 0; i < topN; i++)
+	{
+		ABLProfileSite* site = sites[i];
+		const wchar_t* moduleName = "?";
+		if ((site->moduleHandle >= 0) && (site->moduleHandle < NumModulesRegistered))
+			moduleName = ModuleRegistry[site->moduleHandle].moduleIdPtr->name;
+		wchar_t routineName[256];
+		if (site->native)
+			sprintf(routineName, "%s [native]", site->routine->name);
+		else
+			sprintf(routineName, "%s", site->routine->name);
+		sprintf(s, "%4d %6.2f%% %10.3f %8d %10d  %-24s %-32s %6d\n", (int32_t)(i + 1),
+			(float)site->ticks * 100.0 / totalTime, (float)profileTicksToMicroseconds(site->ticks) / 1000.0,
+			site->samples, site->statements, moduleName, routineName, site->line);
+		file->writeString(s);
+	}
+	return (topN);
+}
+
+//***************************************************************************
+// ABL library interface routines
+//***************************************************************************
+
+void
+ABLi_resetProfiler(void)
+{
+	std::lock_guard<std::mutex> lock(ProfileLock);
+	ProfilerStats.numSamples = 0;
+	ProfilerStats.numSites = 0;
+	ProfilerStats.numDropped = 0;
+	ProfilerStats.totalTicks = 0;
+	if (ProfileNodes)
+	{
+		//-----------------------------------------------
+		// Node 0 is the root every module hangs off of...
+		memset(&ProfileNodes[0], 0, sizeof(ABLProfileNode));
+		ProfileNodes[0].moduleHandle = -1;
+		ProfileNodes[0].parent = -1;
+		ProfileNodes[0].firstChild = -1;
+		ProfileNodes[0].nextSibling = -1;
+		ProfilerStats.numNodes = 1;
+	}
+	if (ProfileSites)
+		memset(ProfileSites, 0, sizeof(ABLProfileSite) * MAX_PROFILE_SITES);
+}
+
+//---------------------------------------------------------------------------
+
+void
+ABLi_enableProfiler(bool enabled, int32_t sampleInterval)
+{
+	if (enabled && !ProfileNodes)
+	{
+		ProfileNodes = (ABLProfileNode*)ABLSystemMallocCallback(sizeof(ABLProfileNode) * MAX_PROFILE_NODES);
+		if (!ProfileNodes)
+			ABL_Fatal(0, " ABL: Unable to malloc profiler call tree ");
+		ProfileSites = (ABLProfileSite*)ABLSystemMallocCallback(sizeof(ABLProfileSite) * MAX_PROFILE_SITES);
+		if (!ProfileSites)
+			ABL_Fatal(0, " ABL: Unable to malloc profiler site table ");
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		ProfileTicksPerSecond = frequency.QuadPart;
+		ABLi_resetProfiler();
+	}
+	if (sampleInterval < 1)
+		sampleInterval = 1;
+	ProfileSampleInterval = sampleInterval;
+	ProfilerEnabled = enabled;
+}
+
+//---------------------------------------------------------------------------
+
+void
+ABLi_closeProfiler(void)
+{
+	ProfilerEnabled = false;
+	std::lock_guard<std::mutex> lock(ProfileLock);
+	if (ProfileNodes)
+	{
+		ABLSystemFreeCallback(ProfileNodes);
+		ProfileNodes = nullptr;
+	}
+	if (ProfileSites)
+	{
+		ABLSystemFreeCallback(ProfileSites);
+		ProfileSites = nullptr;
+	}
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+ABLi_writeProfile(const std::wstring_view& stacksFileName, const std::wstring_view& tableFileName, int32_t topN)
+{
+	//-----------------------------------------------------------------
+	// Names come from the module registry, so this has to happen before
+	// ABLi_close() tears it down...
+	std::lock_guard<std::mutex> lock(ProfileLock);
+	if (!ProfileNodes)
+		return (-1);
+	if (stacksFileName)
+	{
+		ABLFile* stacksFile = new ABLFile;
+		if (!stacksFile)
+			ABL_Fatal(0, " unable to malloc ABL profile file ");
+		if (stacksFile->create(stacksFileName) != ABL_NO_ERR)
+		{
+			delete stacksFile;
+			return (-2);
+		}
+		wchar_t stackName[4096];
+		stackName[0] = nullptr;
+		for (int32_t child = ProfileNodes[0].firstChild; child != -1; child = ProfileNodes[child].nextSibling)
+			writeProfileStacks(stacksFile, child, stackName, 0);
+		stacksFile->close();
+		delete stacksFile;
+	}
+	if (tableFileName)
+	{
+		ABLFile* tableFile = new ABLFile;
+		if (!tableFile)
+			ABL_Fatal(0, " unable to malloc ABL profile file ");
+		if (tableFile->create(tableFileName) != ABL_NO_ERR)
+		{
+			delete tableFile;
+			return (-2);
+		}
+		writeProfileTable(tableFile, topN);
+		tableFile->close();
+		delete tableFile;
+	}
+	return (ABL_NO_ERR);
+}
+
+//***************************************************************************
+
+} // namespace mclib::abl
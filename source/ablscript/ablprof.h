@@ -0,0 +1,93 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+//***************************************************************************
+//
+//								ABLPROF.H
+//
+//***************************************************************************
+
+#pragma once
+
+#ifndef ABLPROF_H
+#define ABLPROF_H
+
+//#include "ablgen.h"
+//#include "ablexec.h"
+
+namespace mclib::abl {
+
+//***************************************************************************
+
+//---------------------------------------------------------------------------
+// The profiler keeps a call tree (module routine -> routine -> ... ->
+// native) and a flat table of (module, routine, line) sites, shared by
+// every module and exec context. Executing threads take a sample every
+// N statements, and again on each side of a native call, charging the time
+// since their last sample to wherever they are now. Between samples the
+// only cost is a counter decrement per statement and a frame push per call.
+
+#define ABL_PROFILE_DEFAULT_INTERVAL 32
+#define MAX_PROFILE_NODES 16384
+#define MAX_PROFILE_SITES 8192
+
+struct ABLProfileNode
+{
+	SymTableNode* routine;
+	int32_t moduleHandle;
+	bool native;
+	int32_t parent;
+	int32_t firstChild;
+	int32_t nextSibling;
+	int64_t ticks; // self time
+	int32_t samples;
+	int32_t statements;
+};
+
+struct ABLProfileSite
+{
+	SymTableNode* routine; // nullptr for an empty slot
+	int32_t moduleHandle;
+	int32_t line;
+	bool native;
+	int64_t ticks;
+	int32_t samples;
+	int32_t statements;
+};
+
+struct ABLProfileStats
+{
+	int32_t numSamples;
+	int32_t numNodes;
+	int32_t numSites;
+	int32_t numDropped; // samples that found the tables full
+	int64_t totalTicks;
+};
+
+//***************************************************************************
+
+//----------
+// FUNCTIONS
+
+//----------------------------------------
+// Called by the executor, only while
+// ProfilerEnabled is set...
+void
+profileModuleBegin(void);
+void
+profileModuleEnd(void);
+void
+profileRoutineEntry(SymTableNode* routineIdPtr, bool native);
+void
+profileRoutineExit(void);
+void
+profileSample(void);
+
+//***************************************************************************
+
+extern bool ProfilerEnabled;
+extern ABLProfileStats ProfilerStats;
+
+} // namespace mclib::abl
+
+#endif
@@ -36,17 +36,10 @@ extern int32_t NumModuleInstances;
 extern int32_t MaxWatchesPerModule;
 extern int32_t MaxBreakPointsPerModule;
 extern int32_t MaxCodeBufferSize;
-extern const std::unique_ptr<ABLModule>& CurModule;
 extern const std::unique_ptr<ABLModule>& CurLibrary;
 extern const std::wstring_view& codeBuffer;
 extern const std::wstring_view& codeBufferPtr;
-extern const std::wstring_view& codeSegmentPtr;
-extern const std::wstring_view& codeSegmentLimit;
-extern const std::wstring_view& statementStartPtr;
 extern StackItem* stack;
-extern const std::unique_ptr<StackItem>& tos;
-extern const std::unique_ptr<StackItem>& stackFrameBasePtr;
-extern const std::unique_ptr<StackItem>& StaticDataPtr;
 extern int32_t* StaticVariablesSizes;
 extern int32_t* EternalVariablesSizes;
 extern int32_t MaxEternalVariables;
@@ -54,10 +47,10 @@ extern int32_t eternalOffset;
 extern int32_t MaxStaticVariables;
 extern int32_t NumStaticVariables;
 extern int32_t NumOrderCalls;
+extern int32_t NumMainThreadCalls;
+extern int32_t NumSharedWrites;
 extern StateHandleInfo StateHandleList[MAX_STATE_HANDLES_PER_MODULE];
 extern int32_t NumStateHandles;
-extern int32_t CurModuleHandle;
-extern bool CallModuleInit;
 extern bool AutoReturnFromOrders;
 extern int32_t MaxLoopIterations;
 extern bool AssertEnabled;
@@ -88,16 +81,17 @@ extern int32_t lineCount;
 
 extern int32_t CurAlarm;
 
+extern ABLImageStats CompiledModuleStats;
+extern bool CompiledModuleCacheEnabled;
+extern bool (*ABLImageExistsCallback)(const std::wstring_view& fileName);
+
 extern bool eofFlag;
-extern bool ExitWithReturn;
-extern bool ExitFromTacOrder;
 
 extern int32_t dummyCount;
 
 extern int32_t lineNumber;
 extern int32_t FileNumber;
 extern int32_t errorCount;
-extern int32_t execStatementCount;
 extern int32_t NumSourceFiles;
 extern wchar_t SourceFiles[MAX_SOURCE_FILES][MAXLEN_FILENAME];
 
@@ -113,8 +107,6 @@ extern const std::unique_ptr<SymTableNode>& CurRoutineIdPtr;
 extern Type DummyType;
 extern StackItem* stack;
 // extern StackItem*		eternalStack;
-extern const std::unique_ptr<StackItem>& tos;
-extern const std::unique_ptr<StackItem>& stackFrameBasePtr;
 extern int32_t eternalOffset;
 
 extern TokenCodeType statementStartList[];
@@ -141,9 +133,6 @@ extern const std::unique_ptr<Type>& IntegerTypePtr;
 extern const std::unique_ptr<Type>& RealTypePtr;
 extern const std::unique_ptr<Type>& BooleanTypePtr;
 
-extern const std::unique_ptr<StackItem>& StaticDataPtr;
-extern StackItem returnValue;
-
 extern const std::unique_ptr<ModuleEntry>& ModuleRegistry;
 extern int32_t MaxModules;
 extern int32_t NumModulesRegistered;
@@ -161,12 +150,6 @@ extern const std::unique_ptr<Debugger>& debugger;
 bool ABLenabled = false;
 wchar_t buffer[MAXLEN_PRINTLINE];
 
-extern int32_t CallStackLevel;
-extern bool SkipOrder;
-
-extern const std::unique_ptr<ABLModule>& CurFSM;
-extern bool NewStateSet;
-
 extern void
 transState(const std::unique_ptr<SymTableNode>& newState);
 
@@ -277,6 +260,51 @@ ABLi_setEndlessStateCallback(void (*endlessStateCallback)(UserFile* log))
 
 //---------------------------------------------------------------------------
 
+void
+ABLi_setCompiledModuleCache(bool enabled, bool (*imageExistsCallback)(const std::wstring_view& fileName))
+{
+	//---------------------------------------------------------------
+	// When enabled, ABLi_preProcess() loads a module from its .abx
+	// image if every source file still hashes the same, and rewrites
+	// the image after any module it has to compile from source. The
+	// callback lets us probe for an image without tripping the
+	// file open callback's missing-file handling...
+	CompiledModuleCacheEnabled = enabled;
+	ABLImageExistsCallback = imageExistsCallback;
+}
+
+//---------------------------------------------------------------------------
+
+void
+ABLi_getCompiledModuleStats(ABLImageStats* stats)
+{
+	if (stats)
+		*stats = CompiledModuleStats;
+}
+
+//---------------------------------------------------------------------------
+
+void
+ABLi_registerNativeModule(const ABLNativeModule* nativeModule)
+{
+	//-------------------------------------------------------------
+	// Routines of any module matching this translation run its C++
+	// from now on. Register after ABLi_init(), before the modules
+	// are preprocessed...
+	registerNativeModule(nativeModule);
+}
+
+//---------------------------------------------------------------------------
+
+void
+ABLi_getNativeModuleStats(ABLNativeStats* stats)
+{
+	if (stats)
+		*stats = NativeModuleStats;
+}
+
+//---------------------------------------------------------------------------
+
 void
 ABLi_init(uint32_t runtimeStackSize, uint32_t maxCodeBufferSize, uint32_t maxRegisteredModules,
 	uint32_t maxStaticVariables, PVOID (*systemMallocCallback)(uint32_t memSize),
@@ -346,18 +374,18 @@ ABLi_init(uint32_t runtimeStackSize, uint32_t maxCodeBufferSize, uint32_t maxReg
 	NumModuleInstances = 0;
 	MaxWatchesPerModule = 20;
 	MaxBreakPointsPerModule = 20;
-	CurModule = nullptr;
+	CurContext->module = nullptr;
 	errorCount = 0;
 	codeBuffer = nullptr;
 	codeBufferPtr = nullptr;
-	codeSegmentPtr = nullptr;
-	codeSegmentLimit = nullptr;
-	statementStartPtr = nullptr;
-	execStatementCount = 0;
+	CurContext->codeSegmentPtr = nullptr;
+	CurContext->codeSegmentLimit = nullptr;
+	CurContext->statementStartPtr = nullptr;
+	CurContext->execStatementCount = 0;
 	stack = nullptr;
-	tos = nullptr;
-	stackFrameBasePtr = nullptr;
-	StaticDataPtr = nullptr;
+	CurContext->tos = nullptr;
+	CurContext->stackFrameBasePtr = nullptr;
+	CurContext->staticDataPtr = nullptr;
 	StaticVariablesSizes = nullptr;
 	EternalVariablesSizes = nullptr;
 	MaxEternalVariables = 5000;
@@ -365,9 +393,11 @@ ABLi_init(uint32_t runtimeStackSize, uint32_t maxCodeBufferSize, uint32_t maxReg
 	MaxStaticVariables = 0;
 	NumStaticVariables = 0;
 	NumOrderCalls = 0;
+	NumMainThreadCalls = 0;
+	NumSharedWrites = 0;
 	NumStateHandles = 1;
-	CurModuleHandle = 0;
-	CallModuleInit = false;
+	CurContext->moduleHandle = 0;
+	CurContext->callModuleInit = false;
 	AutoReturnFromOrders = false;
 	MaxLoopIterations = 100001;
 	AssertEnabled = false;
@@ -396,8 +426,8 @@ ABLi_init(uint32_t runtimeStackSize, uint32_t maxCodeBufferSize, uint32_t maxReg
 	pageNumber = 0;
 	lineCount = MAX_LINES_PER_PAGE;
 	eofFlag = false;
-	ExitWithReturn = false;
-	ExitFromTacOrder = false;
+	CurContext->exitWithReturn = false;
+	CurContext->exitFromTacOrder = false;
 	dummyCount = 0;
 	numLibrariesLoaded = 0;
 	//----------------------------------
@@ -426,8 +456,10 @@ ABLi_init(uint32_t runtimeStackSize, uint32_t maxCodeBufferSize, uint32_t maxReg
 	MaxStaticVariables = maxStaticVariables;
 	NumStaticVariables = 0;
 	NumOrderCalls = 0;
+	NumMainThreadCalls = 0;
+	NumSharedWrites = 0;
 	NumStateHandles = 1;
-	StaticDataPtr = nullptr;
+	CurContext->staticDataPtr = nullptr;
 	StaticVariablesSizes = nullptr;
 	if (MaxStaticVariables > 0)
 	{
@@ -442,6 +474,7 @@ ABLi_init(uint32_t runtimeStackSize, uint32_t maxCodeBufferSize, uint32_t maxReg
 		sizeof(StackItem) * (runtimeStackSize / sizeof(StackItem)));
 	if (!stack)
 		ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc stack ");
+	initExecContext(&MainExecContext, nullptr, 0);
 	//-----------------------------------
 	// Allocate Eternal Vars Size List...
 	if (MaxEternalVariables > 0)
@@ -492,6 +525,83 @@ ABLi_init(uint32_t runtimeStackSize, uint32_t maxCodeBufferSize, uint32_t maxReg
 
 //***************************************************************************
 
+static int32_t
+registerModule(const std::wstring_view& sourceFileName, const std::unique_ptr<SymTableNode>& moduleIdPtr)
+{
+	//--------------------------------------------------
+	// Register the new module in the ABL environment...
+	int32_t i;
+	ModuleRegistry[NumModulesRegistered].fileName =
+		(const std::wstring_view&)ABLStackMallocCallback(strlen(sourceFileName) + 1);
+	if (!ModuleRegistry[NumModulesRegistered].fileName)
+		ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc module filename ");
+	strcpy(ModuleRegistry[NumModulesRegistered].fileName, strlwr(sourceFileName));
+	ModuleRegistry[NumModulesRegistered].moduleIdPtr = moduleIdPtr;
+	indexSymTables(moduleIdPtr->defn.info.routine.localSymTable);
+	ModuleRegistry[NumModulesRegistered].numSourceFiles = NumSourceFiles;
+	ModuleRegistry[NumModulesRegistered].sourceFiles =
+		(const std::wstring_view&*)ABLStackMallocCallback(NumSourceFiles * sizeof(const std::wstring_view&));
+	if (!ModuleRegistry[NumModulesRegistered].sourceFiles)
+		ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc sourceFiles ");
+	for (i = 0; i < NumSourceFiles; i++)
+	{
+		ModuleRegistry[NumModulesRegistered].sourceFiles[i] =
+			(const std::wstring_view&)ABLStackMallocCallback(strlen(SourceFiles[i]) + 1);
+		strcpy(ModuleRegistry[NumModulesRegistered].sourceFiles[i], SourceFiles[i]);
+	}
+	if (NumLibrariesUsed > 0)
+	{
+		ModuleRegistry[NumModulesRegistered].numLibrariesUsed = NumLibrariesUsed;
+		ModuleRegistry[NumModulesRegistered].librariesUsed =
+			(const std::unique_ptr<ABLModule>&*)ABLStackMallocCallback(NumLibrariesUsed * sizeof(const std::unique_ptr<SymTableNode>&));
+		if (!ModuleRegistry[NumModulesRegistered].librariesUsed)
+			ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc librariesUsed ");
+		for (i = 0; i < NumLibrariesUsed; i++)
+			ModuleRegistry[NumModulesRegistered].librariesUsed[i] = LibrariesUsed[i];
+	}
+	ModuleRegistry[NumModulesRegistered].numStaticVars = NumStaticVariables;
+	ModuleRegistry[NumModulesRegistered].sizeStaticVars = nullptr;
+	ModuleRegistry[NumModulesRegistered].totalSizeStaticVars = 0;
+	if (NumStaticVariables)
+	{
+		ModuleRegistry[NumModulesRegistered].sizeStaticVars =
+			(int32_t*)ABLStackMallocCallback(sizeof(int32_t) * NumStaticVariables);
+		if (!ModuleRegistry[NumModulesRegistered].sizeStaticVars)
+			ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc module sizeStaticVars ");
+		memcpy(ModuleRegistry[NumModulesRegistered].sizeStaticVars, StaticVariablesSizes,
+			sizeof(int32_t) * NumStaticVariables);
+		ModuleRegistry[NumModulesRegistered].totalSizeStaticVars =
+			sizeof(int32_t) * NumStaticVariables;
+		for (size_t i = 0; i < ModuleRegistry[NumModulesRegistered].numStaticVars; i++)
+			ModuleRegistry[NumModulesRegistered].totalSizeStaticVars +=
+				ModuleRegistry[NumModulesRegistered].sizeStaticVars[i];
+	}
+	ModuleRegistry[NumModulesRegistered].numOrderCalls = NumOrderCalls;
+	//-------------------------------------------------------------------
+	// A module can think on a worker context only if neither it nor any
+	// library it uses calls a main thread function or writes shared vars...
+	ModuleRegistry[NumModulesRegistered].mainThreadOnly = (NumMainThreadCalls > 0) || (NumSharedWrites > 0);
+	for (i = 0; i < NumLibrariesUsed; i++)
+		if (LibrariesUsed[i] && (LibrariesUsed[i]->getHandle() > -1) && LibrariesUsed[i]->isMainThreadOnly())
+			ModuleRegistry[NumModulesRegistered].mainThreadOnly = true;
+	ModuleRegistry[NumModulesRegistered].numInstances = 0;
+	ModuleRegistry[NumModulesRegistered].numStateHandles = NumStateHandles;
+	if (NumStateHandles > 1)
+	{
+		ModuleRegistry[NumModulesRegistered].stateHandles =
+			(const std::unique_ptr<StateHandleInfo>&)ABLStackMallocCallback(sizeof(StateHandleInfo) * NumStateHandles);
+		memcpy(ModuleRegistry[NumModulesRegistered].stateHandles, StateHandleList,
+			sizeof(StateHandleInfo) * NumStateHandles);
+	}
+	NumModulesRegistered++;
+	//-----------------------------------------------------------------
+	// Switch it over to translated C++ if we have a matching build...
+	bindNativeModule(NumModulesRegistered - 1);
+	return (NumModulesRegistered - 1);
+}
+
+//***************************************************************************
+
 int32_t
 ABLi_preProcess(const std::wstring_view& sourceFileName, int32_t* numErrors, int32_t* numLinesProcessed,
 	int32_t* numFilesProcessed, bool printLines)
@@ -525,10 +635,12 @@ ABLi_preProcess(const std::wstring_view& sourceFileName, int32_t* numErrors, int
 	countError = false;
 	pageNumber = 0;
 	errorCount = 0;
-	execStatementCount = 0;
+	CurContext->execStatementCount = 0;
 	eofFlag = false;
 	NumStaticVariables = 0;
 	NumOrderCalls = 0;
+	NumMainThreadCalls = 0;
+	NumSharedWrites = 0;
 	NumStateHandles = 1;
 	for (i = 0; i < MAX_STATE_HANDLES_PER_MODULE; i++)
 	{
@@ -539,6 +651,23 @@ ABLi_preProcess(const std::wstring_view& sourceFileName, int32_t* numErrors, int
 		*numErrors = 0;
 	if (numLinesProcessed)
 		*numLinesProcessed = 0;
+	if (numFilesProcessed)
+		*numFilesProcessed = 0;
+	discardCodeRelocations();
+	int32_t eternalBase = eternalOffset;
+	//----------------------------------------------------------------
+	// If there's an up-to-date compiled image of this module, use it
+	// and skip the parser entirely...
+	if (compiledModuleCacheEnabled())
+	{
+		const std::unique_ptr<SymTableNode>& imageModuleIdPtr = loadCompiledModule(sourceFileName, eternalBase);
+		if (imageModuleIdPtr)
+		{
+			if (numFilesProcessed)
+				*numFilesProcessed = NumSourceFiles;
+			return (registerModule(sourceFileName, imageModuleIdPtr));
+		}
+	}
 	//---------------------------------------
 	// Now, let's open the ABL source file...
 	int32_t openErr = ABL_NO_ERR;
@@ -611,63 +740,11 @@ ABLi_preProcess(const std::wstring_view& sourceFileName, int32_t* numErrors, int
 	// Done with the source file, so close it...
 	closeSourceFile();
 	// extractSymTable(&SymTableDisplay[0], moduleIdPtr);
-	//--------------------------------------------------
-	// Register the new module in the ABL environment...
-	ModuleRegistry[NumModulesRegistered].fileName =
-		(const std::wstring_view&)ABLStackMallocCallback(strlen(sourceFileName) + 1);
-	if (!ModuleRegistry[NumModulesRegistered].fileName)
-		ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc module filename ");
-	strcpy(ModuleRegistry[NumModulesRegistered].fileName, strlwr(sourceFileName));
-	ModuleRegistry[NumModulesRegistered].moduleIdPtr = moduleIdPtr;
-	ModuleRegistry[NumModulesRegistered].numSourceFiles = NumSourceFiles;
-	ModuleRegistry[NumModulesRegistered].sourceFiles =
-		(const std::wstring_view&*)ABLStackMallocCallback(NumSourceFiles * sizeof(const std::wstring_view&));
-	if (!ModuleRegistry[NumModulesRegistered].sourceFiles)
-		ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc sourceFiles ");
-	for (i = 0; i < NumSourceFiles; i++)
-	{
-		ModuleRegistry[NumModulesRegistered].sourceFiles[i] =
-			(const std::wstring_view&)ABLStackMallocCallback(strlen(SourceFiles[i]) + 1);
-		strcpy(ModuleRegistry[NumModulesRegistered].sourceFiles[i], SourceFiles[i]);
-	}
-	if (NumLibrariesUsed > 0)
-	{
-		ModuleRegistry[NumModulesRegistered].numLibrariesUsed = NumLibrariesUsed;
-		ModuleRegistry[NumModulesRegistered].librariesUsed =
-			(const std::unique_ptr<ABLModule>&*)ABLStackMallocCallback(NumLibrariesUsed * sizeof(const std::unique_ptr<SymTableNode>&));
-		if (!ModuleRegistry[NumModulesRegistered].librariesUsed)
-			ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc librariesUsed ");
-		for (i = 0; i < NumLibrariesUsed; i++)
-			ModuleRegistry[NumModulesRegistered].librariesUsed[i] = LibrariesUsed[i];
-	}
-	ModuleRegistry[NumModulesRegistered].numStaticVars = NumStaticVariables;
-	ModuleRegistry[NumModulesRegistered].sizeStaticVars = nullptr;
-	ModuleRegistry[NumModulesRegistered].totalSizeStaticVars = 0;
-	if (NumStaticVariables)
-	{
-		ModuleRegistry[NumModulesRegistered].sizeStaticVars =
-			(int32_t*)ABLStackMallocCallback(sizeof(int32_t) * NumStaticVariables);
-		if (!ModuleRegistry[NumModulesRegistered].sizeStaticVars)
-			ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc module sizeStaticVars ");
-		memcpy(ModuleRegistry[NumModulesRegistered].sizeStaticVars, StaticVariablesSizes,
-			sizeof(int32_t) * NumStaticVariables);
-		ModuleRegistry[NumModulesRegistered].totalSizeStaticVars =
-			sizeof(int32_t) * NumStaticVariables;
-		for (size_t i = 0; i < ModuleRegistry[NumModulesRegistered].numStaticVars; i++)
-			ModuleRegistry[NumModulesRegistered].totalSizeStaticVars +=
-				ModuleRegistry[NumModulesRegistered].sizeStaticVars[i];
-	}
-	ModuleRegistry[NumModulesRegistered].numOrderCalls = NumOrderCalls;
-	ModuleRegistry[NumModulesRegistered].numInstances = 0;
-	ModuleRegistry[NumModulesRegistered].numStateHandles = NumStateHandles;
-	if (NumStateHandles > 1)
-	{
-		ModuleRegistry[NumModulesRegistered].stateHandles =
-			(const std::unique_ptr<StateHandleInfo>&)ABLStackMallocCallback(sizeof(StateHandleInfo) * NumStateHandles);
-		memcpy(ModuleRegistry[NumModulesRegistered].stateHandles, StateHandleList,
-			sizeof(StateHandleInfo) * NumStateHandles);
-	}
-	NumModulesRegistered++;
+	int32_t moduleHandle = registerModule(sourceFileName, moduleIdPtr);
+	CompiledModuleStats.numCompiled++;
+	if (compiledModuleCacheEnabled() && (errorCount == 0))
+		saveCompiledModule(moduleHandle, eternalBase);
+	discardCodeRelocations();
 	//---------------------------------------------------------------
 	// Now, exit with the number of source lines processed, if any...
 	if (numLinesProcessed)
@@ -676,7 +753,7 @@ ABLi_preProcess(const std::wstring_view& sourceFileName, int32_t* numErrors, int
 		*numFilesProcessed = FileNumber;
 	if (numErrors)
 		*numErrors = errorCount;
-	return (NumModulesRegistered - 1);
+	return (moduleHandle);
 }
 
 //***************************************************************************
@@ -700,23 +777,23 @@ ABLi_execute(const std::unique_ptr<SymTableNode>& moduleIdPtr, const std::unique
 	// blockFlag = false;
 	// blockType = BLOCK_MODULE;
 	CurModuleIdPtr = nullptr;
-	CurRoutineIdPtr = nullptr;
+	CurContext->routineIdPtr = nullptr;
 	// bufferOffset = 0;
 	// bufferp = sourceBuffer;
 	// tokenp = tokenString;
 	// digitCount = 0;
 	// countError = false;
 	errorCount = 0;
-	execStatementCount = 0;
+	CurContext->execStatementCount = 0;
 	NumExecutions++;
 	//------------------
 	// Init the stack...
-	stackFrameBasePtr = tos = (stack + eternalOffset);
+	CurContext->stackFrameBasePtr = CurContext->tos = getRuntimeStackBase();
 	//---------------------------------------
 	// Initialize the module's stack frame...
-	level = 1;
-	CallStackLevel = 0;
-	stackFrameBasePtr = tos + 1;
+	CurContext->level = 1;
+	CurContext->callStackLevel = 0;
+	CurContext->stackFrameBasePtr = CurContext->tos + 1;
 	//-------------------------
 	// Function return value...
 	pushInteger(0);
@@ -776,10 +853,10 @@ ABLi_execute(const std::unique_ptr<SymTableNode>& moduleIdPtr, const std::unique
 						ABL_Fatal(0,
 							" ABL: Unable to AblStackHeap->malloc "
 							"module formal array param ");
-					const std::wstring_view& src = tos->address;
+					const std::wstring_view& src = CurContext->tos->address;
 					const std::wstring_view& savePtr = dest;
 					memcpy(dest, src, size);
-					tos->address = savePtr;
+					CurContext->tos->address = savePtr;
 				}
 			}
 			else
@@ -800,11 +877,11 @@ ABLi_execute(const std::unique_ptr<SymTableNode>& moduleIdPtr, const std::unique
 	}
 	execute(moduleIdPtr);
 	if (returnVal)
-		memcpy(returnVal, &returnValue, sizeof(StackItem));
+		memcpy(returnVal, &CurContext->returnValue, sizeof(StackItem));
 	// extractSymTable(&SymTableDisplay[0], moduleIdPtr);
 	//-----------
 	// Summary...
-	return (execStatementCount);
+	return (CurContext->execStatementCount);
 }
 
 //***************************************************************************
@@ -850,6 +927,8 @@ ABLi_close(void)
 		debugger = nullptr;
 	}
 	ABL_CloseProfileLog();
+	ABLi_closeProfiler();
+	closeNativeModules();
 	ABLenabled = false;
 }
 
@@ -1020,7 +1099,7 @@ ABLi_registerReal(const std::wstring_view& name, float* address, int32_t /* numE
 bool
 ABLi_getSkipOrder(void)
 {
-	return (SkipOrder);
+	return (CurContext->skipOrder);
 }
 
 //***************************************************************************
@@ -1028,7 +1107,7 @@ ABLi_getSkipOrder(void)
 void
 ABLi_resetOrders(void)
 {
-	CurModule->resetOrderCallFlags();
+	CurContext->module->resetOrderCallFlags();
 }
 
 //***************************************************************************
@@ -1036,8 +1115,8 @@ ABLi_resetOrders(void)
 int32_t
 ABLi_getCurrentState(void)
 {
-	if (CurFSM)
-		return (CurFSM->getStateHandle());
+	if (CurContext->fsm)
+		return (CurContext->fsm->getStateHandle());
 	return (nullptr);
 }
 
@@ -1046,8 +1125,149 @@ ABLi_getCurrentState(void)
 void
 ABLi_transState(int32_t newStateHandle)
 {
-	if (CurFSM && (newStateHandle > 0) && (newStateHandle < ModuleRegistry[CurFSM->getHandle()].numStateHandles))
-		transState(ModuleRegistry[CurFSM->getHandle()].stateHandles[newStateHandle].state);
+	if (CurContext->fsm && (newStateHandle > 0) && (newStateHandle < ModuleRegistry[CurContext->fsm->getHandle()].numStateHandles))
+		transState(ModuleRegistry[CurContext->fsm->getHandle()].stateHandles[newStateHandle].state);
+}
+
+//***************************************************************************
+// EXEC CONTEXT routines
+//***************************************************************************
+
+ABLExecContext*
+ABLi_createExecContext(int32_t commandBufferSize)
+{
+	ABLExecContext* context = (ABLExecContext*)ABLSystemMallocCallback(sizeof(ABLExecContext));
+	if (!context)
+		ABL_Fatal(0, " ABL: Unable to AblSystemHeap->malloc exec context ");
+	StackItem* runtimeStack = (StackItem*)ABLStackMallocCallback(sizeof(StackItem) * MAXSIZE_STACK);
+	if (!runtimeStack)
+		ABL_Fatal(0, " ABL: Unable to AblStackHeap->malloc exec context stack ");
+	initExecContext(context, runtimeStack, MAXSIZE_STACK);
+	if (commandBufferSize > 0)
+	{
+		context->commandBuffer = ABLi_createCommandBuffer(commandBufferSize);
+		context->ownCommandBuffer = true;
+	}
+	return (context);
+}
+
+//***************************************************************************
+
+void
+ABLi_destroyExecContext(ABLExecContext* context)
+{
+	if (!context || (context == &MainExecContext))
+		return;
+	if (context->ownCommandBuffer)
+		ABLi_destroyCommandBuffer(context->commandBuffer);
+	ABLStackFreeCallback(context->runtimeStack);
+	ABLSystemFreeCallback(context);
+}
+
+//***************************************************************************
+
+void
+ABLi_resetExecContext(ABLExecContext* context, ABLCommandBuffer* commandBuffer, uint32_t seed)
+{
+	//-----------------------------------------------------------
+	// Lets one worker context run module after module, each with
+	// its calls queued in a buffer of its own and its own random
+	// numbers, without making a new context every time...
+	if (context->ownCommandBuffer)
+		ABLi_destroyCommandBuffer(context->commandBuffer);
+	context->commandBuffer = commandBuffer;
+	context->ownCommandBuffer = false;
+	if (commandBuffer)
+	{
+		commandBuffer->size = 0;
+		commandBuffer->numCalls = 0;
+	}
+	ABLi_seedExecContext(context, seed);
+}
+
+//***************************************************************************
+
+ABLCommandBuffer*
+ABLi_createCommandBuffer(int32_t size)
+{
+	ABLCommandBuffer* buffer = (ABLCommandBuffer*)ABLSystemMallocCallback(sizeof(ABLCommandBuffer));
+	if (!buffer)
+		ABL_Fatal(0, " ABL: Unable to AblSystemHeap->malloc command buffer ");
+	buffer->data = (uint8_t*)ABLSystemMallocCallback(size);
+	if (!buffer->data)
+		ABL_Fatal(0, " ABL: Unable to AblSystemHeap->malloc command buffer data ");
+	buffer->size = 0;
+	buffer->maxSize = size;
+	buffer->numCalls = 0;
+	return (buffer);
+}
+
+//***************************************************************************
+
+void
+ABLi_destroyCommandBuffer(ABLCommandBuffer* buffer)
+{
+	if (!buffer)
+		return;
+	ABLSystemFreeCallback(buffer->data);
+	ABLSystemFreeCallback(buffer);
+}
+
+//***************************************************************************
+
+ABLExecContext*
+ABLi_setExecContext(ABLExecContext* context)
+{
+	//-------------------------------------------------------
+	// Binds the context to the calling thread. nullptr goes
+	// back to the main context...
+	ABLExecContext* prevContext = CurContext;
+	CurContext = context ? context : &MainExecContext;
+	return (prevContext);
+}
+
+//***************************************************************************
+
+void
+ABLi_seedExecContext(ABLExecContext* context, uint32_t seed)
+{
+	context->ownRandom = true;
+	context->randomSeed = seed;
+}
+
+//***************************************************************************
+
+int32_t
+ABLi_applyDeferredCalls(ABLCommandBuffer* commandBuffer)
+{
+	if (CurContext != &MainExecContext)
+		ABL_Fatal(0, " ABL: deferred calls must be applied on the main context ");
+	if (!commandBuffer)
+		return (0);
+	return (applyDeferredCalls(commandBuffer));
+}
+
+//***************************************************************************
+
+void
+ABLi_setFunctionMode(const std::wstring_view& name, FunctionMode mode, int32_t deferredResult)
+{
+	const std::unique_ptr<SymTableNode>& routineIdPtr = searchSymTableForFunction(name, SymTableDisplay[0]);
+	if (!routineIdPtr || (routineIdPtr->defn.info.routine.key >= NumStandardFunctions))
+	{
+		wchar_t err[255];
+		sprintf(err, " ABLi_setFunctionMode: unknown function %s ", name);
+		ABL_Fatal(0, err);
+	}
+	int32_t key = routineIdPtr->defn.info.routine.key;
+	//-------------------------------------------------------------------
+	// A queued call hands the script deferredResult instead of its real
+	// result. Array params are copied when the call is queued, so a
+	// function that fills one in must never be deferred. Modes have to be
+	// set before any module is compiled, since the compiler records which
+	// modules call main thread functions...
+	FunctionInfoTable[key].mode = mode;
+	FunctionInfoTable[key].deferredResult = deferredResult;
 }
 
 //***************************************************************************
@@ -1086,6 +1306,7 @@ moduleHeader(void)
 		moduleIdPtr->defn.info.routine.locals = nullptr;
 		moduleIdPtr->defn.info.routine.localSymTable = nullptr;
 		moduleIdPtr->defn.info.routine.codeSegment = nullptr;
+		moduleIdPtr->defn.info.routine.nativeCode = nullptr;
 		moduleIdPtr->library = CurLibrary;
 		moduleIdPtr->ptype = &DummyType;
 		moduleIdPtr->labelIndex = 0;
@@ -1246,6 +1467,7 @@ forwardState(const std::wstring_view& stateName)
 	stateSymbol->defn.info.routine.locals = nullptr;
 	stateSymbol->defn.info.routine.localSymTable = nullptr;
 	stateSymbol->defn.info.routine.codeSegment = nullptr;
+	stateSymbol->defn.info.routine.nativeCode = nullptr;
 	stateSymbol->library = CurLibrary;
 	stateSymbol->ptype = nullptr;
 	stateSymbol->labelIndex = 0;
@@ -1288,6 +1510,7 @@ functionHeader(void)
 			functionIdPtr->defn.info.routine.locals = nullptr;
 			functionIdPtr->defn.info.routine.localSymTable = nullptr;
 			functionIdPtr->defn.info.routine.codeSegment = nullptr;
+			functionIdPtr->defn.info.routine.nativeCode = nullptr;
 			if (isOrder)
 				functionIdPtr->defn.info.routine.flags |= ROUTINE_FLAG_ORDER;
 			if (isState)
@@ -1522,6 +1745,8 @@ actualParamList(const std::unique_ptr<SymTableNode>& routineIdPtr, int32_t param
 				{
 					const std::unique_ptr<SymTableNode>& idPtr;
 					searchAndFindAllSymTables(idPtr);
+					if (isSharedVariable(idPtr))
+						NumSharedWrites++;
 					actualParamTypePtr = variable(idPtr);
 					if (formalParamTypePtr != actualParamTypePtr)
 						syntaxError(ABL_ERR_SYNTAX_INCOMPATIBLE_TYPES);
@@ -1558,18 +1783,16 @@ actualParamList(const std::unique_ptr<SymTableNode>& routineIdPtr, int32_t param
 
 //***************************************************************************
 
-extern wchar_t SetStateDebugStr[256];
-
 void
 transState(const std::unique_ptr<SymTableNode>& newState)
 {
-	if (CurFSM)
+	if (CurContext->fsm)
 	{
-		CurFSM->setPrevState(CurFSM->getState());
-		CurFSM->setState(newState);
-		sprintf(SetStateDebugStr, "%s:%s, line %d", CurModule->getFileName(), newState->name,
-			execLineNumber);
-		NewStateSet = true;
+		CurContext->fsm->setPrevState(CurContext->fsm->getState());
+		CurContext->fsm->setState(newState);
+		sprintf(CurContext->stateDebugStr, "%s:%s, line %d", CurContext->module->getFileName(), newState->name,
+			CurContext->execLineNumber);
+		CurContext->newStateSet = true;
 	}
 }
 
@@ -31,6 +31,7 @@ extern const std::unique_ptr<Type>& BooleanTypePtr;
 extern Type DummyType;
 
 extern const std::unique_ptr<SymTableNode>& CurRoutineIdPtr;
+extern int32_t NumMainThreadCalls;
 
 bool EnterStateSymbol = false;
 
@@ -145,6 +146,8 @@ standardRoutineCall(const std::unique_ptr<SymTableNode>& routineIdPtr)
 	default:
 		if (key >= NumStandardFunctions)
 			syntaxError(ABL_ERR_SYNTAX_UNEXPECTED_TOKEN);
+		else if (FunctionInfoTable[key].mode == FUNCTION_MODE_MAIN)
+			NumMainThreadCalls++;
 		if (numParams == 0)
 		{
 			if (curToken == TKN_LPAREN)
@@ -40,6 +40,8 @@ extern bool PrintEnabled;
 extern bool StringFunctionsEnabled;
 extern bool Crunch;
 extern int32_t NumOrderCalls;
+extern int32_t NumMainThreadCalls;
+extern int32_t NumSharedWrites;
 
 //--------
 // GLOBALS
@@ -58,6 +60,8 @@ assignmentStatement(const std::unique_ptr<SymTableNode>& varIdPtr)
 {
 	//-----------------------------------
 	// Grab the variable we're setting...
+	if (isSharedVariable(varIdPtr))
+		NumSharedWrites++;
 	const std::unique_ptr<Type>& varType = variable(varIdPtr);
 	ifTokenGetElseError(TKN_EQUAL, ABL_ERR_SYNTAX_MISSING_EQUAL);
 	//---------------------------------------------------------
@@ -175,6 +179,8 @@ forStatement(void)
 		crunchSymTableNodePtr(forIdPtr);
 		if (/*(forIdPtr->level != level) ||*/ (forIdPtr->defn.key != DFN_VAR))
 			syntaxError(ABL_ERR_SYNTAX_INVALID_FOR_CONTROL);
+		else if (isSharedVariable(forIdPtr))
+			NumSharedWrites++;
 		forType = forIdPtr->ptype;
 		getToken();
 		//------------------------------------------------------------------
@@ -47,6 +47,10 @@ StandardFunctionInfo FunctionInfoTable[MAX_STANDARD_FUNCTIONS];
 void (*FunctionCallbackTable[MAX_STANDARD_FUNCTIONS])();
 int32_t NumStandardFunctions = NUM_ABL_ROUTINES;
 
+std::wstring_view* SymbolNamePool = nullptr;
+int32_t SymbolNamePoolSlots = 0;
+int32_t NumSymbolNames = 0;
+
 void
 execStdRandom();
 
@@ -192,6 +196,333 @@ clearType(const std::unique_ptr<Type>&& type)
 	}
 }
 
+//***************************************************************************
+// SYMBOL NAME routines
+//***************************************************************************
+
+#define MIN_NAME_POOL_SLOTS 1024
+#define MIN_SCOPE_INDEX_SLOTS 8
+
+inline uint32_t
+hashSymbolName(const std::wstring_view& name)
+{
+	uint32_t hash = 2166136261u;
+	for (wchar_t c : name)
+		hash = (hash ^ (uint32_t)c) * 16777619u;
+	return (hash);
+}
+
+//---------------------------------------------------------------------------
+
+inline uint32_t
+hashSymbolPointer(const wchar_t* internedName)
+{
+	return ((uint32_t)((size_t)internedName >> 2) * 2654435761u);
+}
+
+//---------------------------------------------------------------------------
+
+void
+growSymbolNamePool(void)
+{
+	int32_t numSlots = SymbolNamePoolSlots ? (SymbolNamePoolSlots * 2) : MIN_NAME_POOL_SLOTS;
+	std::wstring_view* slots = (std::wstring_view*)ABLSymbolMallocCallback(sizeof(std::wstring_view) * numSlots);
+	if (!slots)
+		ABL_Fatal(0, " ABL: Unable to AblSymTableHeap->malloc symbol name pool ");
+	for (size_t i = 0; i < numSlots; i++)
+		new (&slots[i]) std::wstring_view();
+	for (size_t i = 0; i < SymbolNamePoolSlots; i++)
+		if (SymbolNamePool[i].data())
+		{
+			uint32_t slot = hashSymbolName(SymbolNamePool[i]) & (numSlots - 1);
+			while (slots[slot].data())
+				slot = (slot + 1) & (numSlots - 1);
+			slots[slot] = SymbolNamePool[i];
+		}
+	if (SymbolNamePool)
+		ABLSymbolFreeCallback(SymbolNamePool);
+	SymbolNamePool = slots;
+	SymbolNamePoolSlots = numSlots;
+}
+
+//---------------------------------------------------------------------------
+
+std::wstring_view
+internSymbolName(const std::wstring_view& symbolName)
+{
+	//------------------------------------------------------------------
+	// Names are taken up to the first null, the way strcmp() saw them,
+	// since some callers split a name buffer in place (lib.member)...
+	std::wstring_view name(symbolName.data());
+	if (((NumSymbolNames + 1) * 2) > SymbolNamePoolSlots)
+		growSymbolNamePool();
+	uint32_t slot = hashSymbolName(name) & (SymbolNamePoolSlots - 1);
+	while (SymbolNamePool[slot].data())
+	{
+		if (SymbolNamePool[slot] == name)
+			return (SymbolNamePool[slot]);
+		slot = (slot + 1) & (SymbolNamePoolSlots - 1);
+	}
+	//-----------------------------------------------------------
+	// Still null-terminated, since plenty of code treats names as
+	// plain strings...
+	wchar_t* newName = (wchar_t*)ABLSymbolMallocCallback((name.size() + 1) * sizeof(wchar_t));
+	if (!newName)
+		ABL_Fatal(0, " ABL: Unable to AblSymTableHeap->malloc symbol name ");
+	memcpy(newName, name.data(), name.size() * sizeof(wchar_t));
+	newName[name.size()] = 0;
+	SymbolNamePool[slot] = std::wstring_view(newName, name.size());
+	NumSymbolNames++;
+	return (SymbolNamePool[slot]);
+}
+
+//---------------------------------------------------------------------------
+
+const wchar_t*
+findSymbolName(const std::wstring_view& symbolName)
+{
+	//------------------------------------------------------------
+	// Unlike internSymbolName(), this never adds to the pool. A
+	// name that isn't there can't be in any scope, either...
+	if (!SymbolNamePool || !symbolName.data())
+		return (nullptr);
+	std::wstring_view name(symbolName.data());
+	uint32_t slot = hashSymbolName(name) & (SymbolNamePoolSlots - 1);
+	while (SymbolNamePool[slot].data())
+	{
+		if (SymbolNamePool[slot] == name)
+			return (SymbolNamePool[slot].data());
+		slot = (slot + 1) & (SymbolNamePoolSlots - 1);
+	}
+	return (nullptr);
+}
+
+//***************************************************************************
+// SCOPE INDEX routines
+//***************************************************************************
+
+void
+addToSymTableIndex(SymTableIndex* index, SymTableNode* node)
+{
+	node->sameName = nullptr;
+	uint32_t slot = hashSymbolPointer(node->name.data()) & (index->numSlots - 1);
+	while (index->slots[slot])
+	{
+		if (index->slots[slot]->name.data() == node->name.data())
+		{
+			//-----------------------------------------------
+			// Duplicate name, so it goes at the end of the
+			// chain, just as it would sit right of the others
+			// in the tree...
+			SymTableNode* lastNode = index->slots[slot];
+			while (lastNode->sameName)
+				lastNode = lastNode->sameName;
+			lastNode->sameName = node;
+			return;
+		}
+		slot = (slot + 1) & (index->numSlots - 1);
+	}
+	index->slots[slot] = node;
+	index->numNames++;
+}
+
+//---------------------------------------------------------------------------
+
+void
+fillSymTableIndex(SymTableIndex* index, SymTableNode* tableRoot)
+{
+	//-----------------------------------------------------------------
+	// In-order, so duplicates chain up oldest first. The trees can be
+	// badly unbalanced (symbols tend to be declared in order), so
+	// don't recurse...
+	std::vector<SymTableNode*> pending;
+	SymTableNode* node = tableRoot;
+	while (node || !pending.empty())
+	{
+		while (node)
+		{
+			pending.push_back(node);
+			node = node->left;
+		}
+		node = pending.back();
+		pending.pop_back();
+		addToSymTableIndex(index, node);
+		node = node->right;
+	}
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+countSymTableNodes(SymTableNode* tableRoot)
+{
+	int32_t numNodes = 0;
+	std::vector<SymTableNode*> pending;
+	if (tableRoot)
+		pending.push_back(tableRoot);
+	while (!pending.empty())
+	{
+		SymTableNode* node = pending.back();
+		pending.pop_back();
+		numNodes++;
+		if (node->left)
+			pending.push_back(node->left);
+		if (node->right)
+			pending.push_back(node->right);
+	}
+	return (numNodes);
+}
+
+//---------------------------------------------------------------------------
+
+void
+resizeSymTableIndex(SymTableIndex* index, SymTableNode* tableRoot, int32_t numNodes)
+{
+	int32_t numSlots = MIN_SCOPE_INDEX_SLOTS;
+	while (numSlots < (numNodes * 2))
+		numSlots *= 2;
+	if (index->slots)
+		ABLSymbolFreeCallback(index->slots);
+	index->slots = (SymTableNode**)ABLSymbolMallocCallback(sizeof(SymTableNode*) * numSlots);
+	if (!index->slots)
+		ABL_Fatal(0, " ABL: Unable to AblSymTableHeap->malloc scope index ");
+	memset(index->slots, 0, sizeof(SymTableNode*) * numSlots);
+	index->numSlots = numSlots;
+	index->numNames = 0;
+	fillSymTableIndex(index, tableRoot);
+}
+
+//---------------------------------------------------------------------------
+
+SymTableIndex*
+buildSymTableIndex(SymTableNode* tableRoot)
+{
+	if (!tableRoot->index)
+	{
+		SymTableIndex* index = (SymTableIndex*)ABLSymbolMallocCallback(sizeof(SymTableIndex));
+		if (!index)
+			ABL_Fatal(0, " ABL: Unable to AblSymTableHeap->malloc scope index ");
+		index->slots = nullptr;
+		resizeSymTableIndex(index, tableRoot, countSymTableNodes(tableRoot));
+		tableRoot->index = index;
+	}
+	return (tableRoot->index);
+}
+
+//---------------------------------------------------------------------------
+
+void
+indexNewSymbol(SymTableNode* tableRoot, SymTableNode* newNode)
+{
+	//-------------------------------------------------------------
+	// Entering symbols is compile (or load) time work, so keep the
+	// scope's index current here and searches never have to...
+	newNode->index = nullptr;
+	newNode->sameName = nullptr;
+	if (!tableRoot)
+	{
+		buildSymTableIndex(newNode);
+		return;
+	}
+	if (!tableRoot->index)
+	{
+		buildSymTableIndex(tableRoot);
+		return;
+	}
+	SymTableIndex* index = tableRoot->index;
+	if (((index->numNames + 1) * 2) > index->numSlots)
+		resizeSymTableIndex(index, tableRoot, index->numNames * 2);
+	else
+		addToSymTableIndex(index, newNode);
+}
+
+//---------------------------------------------------------------------------
+
+void
+dropSymTableIndex(SymTableNode* tableRoot)
+{
+	if (tableRoot && tableRoot->index)
+	{
+		ABLSymbolFreeCallback(tableRoot->index->slots);
+		ABLSymbolFreeCallback(tableRoot->index);
+		tableRoot->index = nullptr;
+	}
+}
+
+//---------------------------------------------------------------------------
+
+void
+indexSymTables(SymTableNode* tableRoot)
+{
+	//-----------------------------------------------------------------
+	// Called when a module is linked. Scopes built by the image loader
+	// don't go through enterSymTable, so make sure every scope in the
+	// module (its routines' included) has its index now, before brains
+	// start searching them from worker contexts...
+	std::vector<SymTableNode*> scopes;
+	if (tableRoot)
+		scopes.push_back(tableRoot);
+	while (!scopes.empty())
+	{
+		SymTableNode* scopeRoot = scopes.back();
+		scopes.pop_back();
+		buildSymTableIndex(scopeRoot);
+		std::vector<SymTableNode*> pending;
+		pending.push_back(scopeRoot);
+		while (!pending.empty())
+		{
+			SymTableNode* node = pending.back();
+			pending.pop_back();
+			if (((node->defn.key == DFN_MODULE) || (node->defn.key == DFN_FUNCTION)) && node->defn.info.routine.localSymTable)
+				scopes.push_back(node->defn.info.routine.localSymTable);
+			if (node->left)
+				pending.push_back(node->left);
+			if (node->right)
+				pending.push_back(node->right);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+
+SymTableNode*
+searchSymTableIndex(const wchar_t* internedName, SymTableNode* tableRoot)
+{
+	//---------------------------------------------------------------
+	// Read only, since brains search from worker contexts. A scope
+	// without an index (there shouldn't be one) gets the slow walk...
+	if (!tableRoot || !internedName)
+		return (nullptr);
+	SymTableIndex* index = tableRoot->index;
+	if (!index)
+	{
+		std::vector<SymTableNode*> pending;
+		SymTableNode* node = tableRoot;
+		while (node || !pending.empty())
+		{
+			while (node)
+			{
+				pending.push_back(node);
+				node = node->left;
+			}
+			node = pending.back();
+			pending.pop_back();
+			if (node->name.data() == internedName)
+				return (node);
+			node = node->right;
+		}
+		return (nullptr);
+	}
+	uint32_t slot = hashSymbolPointer(internedName) & (index->numSlots - 1);
+	while (index->slots[slot])
+	{
+		if (index->slots[slot]->name.data() == internedName)
+			return (index->slots[slot]);
+		slot = (slot + 1) & (index->numSlots - 1);
+	}
+	return (nullptr);
+}
+
 //***************************************************************************
 // SYMBOL TABLE routines
 //***************************************************************************
@@ -218,17 +549,7 @@ recordLibraryUsed(const std::unique_ptr<SymTableNode>& memberNodePtr)
 const std::unique_ptr<SymTableNode>&
 searchSymTable(const std::wstring_view& name, const std::unique_ptr<SymTableNode>& nodePtr)
 {
-	while (nodePtr)
-	{
-		int32_t compareResult = strcmp(name, nodePtr->name);
-		if (compareResult == 0)
-			return (nodePtr);
-		if (compareResult < 0)
-			nodePtr = nodePtr->left;
-		else
-			nodePtr = nodePtr->right;
-	}
-	return (nullptr);
+	return (searchSymTableIndex(findSymbolName(name), nodePtr));
 }
 
 //***************************************************************************
@@ -236,20 +557,13 @@ searchSymTable(const std::wstring_view& name, const std::unique_ptr<SymTableNode
 const std::unique_ptr<SymTableNode>&
 searchSymTableForFunction(const std::wstring_view& name, const std::unique_ptr<SymTableNode>& nodePtr)
 {
+	nodePtr = searchSymTableIndex(findSymbolName(name), nodePtr);
 	while (nodePtr)
 	{
-		int32_t compareResult = strcmp(name, nodePtr->name);
-		if (compareResult == 0)
-		{
-			if (nodePtr->ptype == nullptr)
-				if (nodePtr->defn.key == DFN_FUNCTION)
-					return (nodePtr);
-			nodePtr = nodePtr->right;
-		}
-		else if (compareResult < 0)
-			nodePtr = nodePtr->left;
-		else
-			nodePtr = nodePtr->right;
+		if (nodePtr->ptype == nullptr)
+			if (nodePtr->defn.key == DFN_FUNCTION)
+				return (nodePtr);
+		nodePtr = nodePtr->sameName;
 	}
 	return (nullptr);
 }
@@ -259,21 +573,14 @@ searchSymTableForFunction(const std::wstring_view& name, const std::unique_ptr<S
 const std::unique_ptr<SymTableNode>&
 searchSymTableForState(const std::wstring_view& name, const std::unique_ptr<SymTableNode>& nodePtr)
 {
+	nodePtr = searchSymTableIndex(findSymbolName(name), nodePtr);
 	while (nodePtr)
 	{
-		int32_t compareResult = strcmp(name, nodePtr->name);
-		if (compareResult == 0)
-		{
-			if (nodePtr->ptype == nullptr)
-				if (nodePtr->defn.key == DFN_FUNCTION)
-					if (nodePtr->defn.info.routine.flags & ROUTINE_FLAG_STATE)
-						return (nodePtr);
-			nodePtr = nodePtr->right;
-		}
-		else if (compareResult < 0)
-			nodePtr = nodePtr->left;
-		else
-			nodePtr = nodePtr->right;
+		if (nodePtr->ptype == nullptr)
+			if (nodePtr->defn.key == DFN_FUNCTION)
+				if (nodePtr->defn.info.routine.flags & ROUTINE_FLAG_STATE)
+					return (nodePtr);
+		nodePtr = nodePtr->sameName;
 	}
 	return (nullptr);
 }
@@ -283,59 +590,40 @@ searchSymTableForState(const std::wstring_view& name, const std::unique_ptr<SymT
 const std::unique_ptr<SymTableNode>&
 searchSymTableForString(const std::wstring_view& name, const std::unique_ptr<SymTableNode>& nodePtr)
 {
+	nodePtr = searchSymTableIndex(findSymbolName(name), nodePtr);
 	while (nodePtr)
 	{
-		int32_t compareResult = strcmp(name, nodePtr->name);
-		if (compareResult == 0)
-		{
-			if (nodePtr->ptype)
-				if (nodePtr->ptype->form == FRM_ARRAY)
-					if (nodePtr->ptype->info.array.elementTypePtr == CharTypePtr)
-						return (nodePtr);
-			nodePtr = nodePtr->right;
-		}
-		else if (compareResult < 0)
-			nodePtr = nodePtr->left;
-		else
-			nodePtr = nodePtr->right;
+		if (nodePtr->ptype)
+			if (nodePtr->ptype->form == FRM_ARRAY)
+				if (nodePtr->ptype->info.array.elementTypePtr == CharTypePtr)
+					return (nodePtr);
+		nodePtr = nodePtr->sameName;
 	}
 	return (nullptr);
 }
 
 //***************************************************************************
 
-const std::unique_ptr<SymTableNode>&
-searchLibrarySymTable(const std::wstring_view& name, const std::unique_ptr<SymTableNode>& nodePtr)
+SymTableNode*
+searchLibraryScopes(const wchar_t* internedName, SymTableNode* nodePtr)
 {
-	//-------------------------------------------------------------
-	// Since all libraries are at the symbol display 0-level, we'll
-	// check the local symbol table of all libraries. WARNING: This
-	// will find the FIRST instance of a symbol with that name,
-	// so don't load two libraries with a similarly named function
-	// or variable, otherwise you may not get the one you want
-	// unless you explicitly reference the library you want
-	// (e.g. testLib.fudge, rather than just fudge). This is WAY
-	// inefficient compared to simply knowing the library we want,
-	// so any ABL programmer that causes this function to be called
-	// should be shot --gd 9/29/97
 	if (nodePtr)
 	{
-		int32_t compareResult = strcmp(name, nodePtr->name);
-		if (compareResult == 0)
+		if (nodePtr->name.data() == internedName)
 			return (nodePtr);
 		else
 		{
 			if (nodePtr->library && (nodePtr->defn.key == DFN_MODULE))
 			{
-				const std::unique_ptr<SymTableNode>& memberNodePtr =
-					searchSymTable(name, nodePtr->defn.info.routine.localSymTable);
+				SymTableNode* memberNodePtr =
+					searchSymTableIndex(internedName, nodePtr->defn.info.routine.localSymTable);
 				if (memberNodePtr)
 					return (memberNodePtr);
 			}
-			const std::unique_ptr<SymTableNode>& nodeFoundPtr = searchLibrarySymTable(name, nodePtr->left);
+			SymTableNode* nodeFoundPtr = searchLibraryScopes(internedName, nodePtr->left);
 			if (nodeFoundPtr)
 				return (nodeFoundPtr);
-			nodeFoundPtr = searchLibrarySymTable(name, nodePtr->right);
+			nodeFoundPtr = searchLibraryScopes(internedName, nodePtr->right);
 			if (nodeFoundPtr)
 				return (nodeFoundPtr);
 		}
@@ -343,6 +631,28 @@ searchLibrarySymTable(const std::wstring_view& name, const std::unique_ptr<SymTa
 	return (nullptr);
 }
 
+//---------------------------------------------------------------------------
+
+const std::unique_ptr<SymTableNode>&
+searchLibrarySymTable(const std::wstring_view& name, const std::unique_ptr<SymTableNode>& nodePtr)
+{
+	//-------------------------------------------------------------
+	// Since all libraries are at the symbol display 0-level, we'll
+	// check the local symbol table of all libraries. WARNING: This
+	// will find the FIRST instance of a symbol with that name,
+	// so don't load two libraries with a similarly named function
+	// or variable, otherwise you may not get the one you want
+	// unless you explicitly reference the library you want
+	// (e.g. testLib.fudge, rather than just fudge). This is WAY
+	// inefficient compared to simply knowing the library we want,
+	// so any ABL programmer that causes this function to be called
+	// should be shot --gd 9/29/97
+	const wchar_t* internedName = findSymbolName(name);
+	if (!internedName)
+		return (nullptr);
+	return (searchLibraryScopes(internedName, nodePtr));
+}
+
 //***************************************************************************
 
 const std::unique_ptr<SymTableNode>&
@@ -379,9 +689,12 @@ searchSymTableDisplay(const std::wstring_view& name)
 	}
 	else
 	{
+		const wchar_t* internedName = findSymbolName(name);
+		if (!internedName)
+			return (nullptr);
 		for (size_t i = level; i >= 0; i--)
 		{
-			const std::unique_ptr<SymTableNode>& nodePtr = searchSymTable(name, SymTableDisplay[i]);
+			const std::unique_ptr<SymTableNode>& nodePtr = searchSymTableIndex(internedName, SymTableDisplay[i]);
 			if (nodePtr)
 				return (nodePtr);
 		}
@@ -395,7 +708,7 @@ searchSymTableDisplay(const std::wstring_view& name)
 		// or variable, otherwise you may not get the one you want
 		// unless you explicitly reference the library you want
 		// (e.g. testLib.fudge, rather than just fudge)...
-		nodePtr = searchLibrarySymTableDisplay(name);
+		nodePtr = searchLibraryScopes(internedName, SymTableDisplay[0]);
 		if (nodePtr)
 			recordLibraryUsed(nodePtr);
 	}
@@ -412,10 +725,7 @@ enterSymTable(const std::wstring_view& name, const std::unique_ptr<SymTableNode>
 	const std::unique_ptr<SymTableNode>& newNode = (const std::unique_ptr<SymTableNode>&)ABLSymbolMallocCallback(sizeof(SymTableNode));
 	if (!newNode)
 		ABL_Fatal(0, " ABL: Unable to AblSymTableHeap->malloc symbol ");
-	newNode->name = (const std::wstring_view&)ABLSymbolMallocCallback(strlen(name) + 1);
-	if (!newNode->name)
-		ABL_Fatal(0, " ABL: Unable to AblSymTableHeap->malloc symbol name ");
-	strcpy(newNode->name, name);
+	newNode->name = internSymbolName(name);
 	newNode->left = nullptr;
 	newNode->parent = nullptr;
 	newNode->right = nullptr;
@@ -429,6 +739,7 @@ enterSymTable(const std::wstring_view& name, const std::unique_ptr<SymTableNode>
 	newNode->labelIndex = 0;
 	//-------------------------------------
 	// Find where to put this new symbol...
+	const std::unique_ptr<SymTableNode>& tableRoot = *ptrToNodePtr;
 	const std::unique_ptr<SymTableNode>& curNode = *ptrToNodePtr;
 	const std::unique_ptr<SymTableNode>& parentNode = nullptr;
 	while (curNode)
@@ -442,6 +753,7 @@ enterSymTable(const std::wstring_view& name, const std::unique_ptr<SymTableNode>
 	}
 	newNode->parent = parentNode;
 	*ptrToNodePtr = newNode;
+	indexNewSymbol(tableRoot, newNode);
 	return (newNode);
 }
 
@@ -455,6 +767,7 @@ insertSymTable(const std::unique_ptr<SymTableNode>&* tableRoot, const std::uniqu
 	newNode->right = nullptr;
 	//------------------------------------
 	// Find where to insert this symbol...
+	const std::unique_ptr<SymTableNode>& rootNode = *tableRoot;
 	const std::unique_ptr<SymTableNode>& curNode = *tableRoot;
 	const std::unique_ptr<SymTableNode>& parentNode = nullptr;
 	while (curNode)
@@ -468,6 +781,7 @@ insertSymTable(const std::unique_ptr<SymTableNode>&* tableRoot, const std::uniqu
 	}
 	newNode->parent = parentNode;
 	*tableRoot = newNode;
+	indexNewSymbol(rootNode, newNode);
 	return (newNode);
 }
 
@@ -484,6 +798,10 @@ extractSymTable(const std::unique_ptr<SymTableNode>&* tableRoot, const std::uniq
 	// 0 in the SymTable Display. Do we want to eliminate the use of the
 	// parent pointer, and just hardcode something that may be more efficient
 	// for this level-0 special case?
+	//
+	// The root (and the scope's index with it) may move, so the index
+	// is thrown away and rebuilt once the node is out...
+	dropSymTableIndex(*tableRoot);
 	const std::unique_ptr<SymTableNode>& nodeX = nullptr;
 	const std::unique_ptr<SymTableNode>& nodeY = nullptr;
 	if ((nodeKill->left == nullptr) || (nodeKill->right == nullptr))
@@ -514,6 +832,8 @@ extractSymTable(const std::unique_ptr<SymTableNode>&* tableRoot, const std::uniq
 		nodeKill->level = nodeY->level;
 		nodeKill->labelIndex = nodeY->labelIndex;
 	}
+	if (*tableRoot)
+		buildSymTableIndex(*tableRoot);
 	return (nodeY);
 }
 
@@ -537,6 +857,7 @@ enterStandardRoutine(const std::wstring_view& name, int32_t routineKey, bool isO
 	routineIdPtr->defn.info.routine.flags = isOrder ? ROUTINE_FLAG_ORDER : 0;
 	routineIdPtr->defn.info.routine.params = nullptr;
 	routineIdPtr->defn.info.routine.localSymTable = nullptr;
+	routineIdPtr->defn.info.routine.nativeCode = nullptr;
 	routineIdPtr->library = nullptr;
 	routineIdPtr->ptype = nullptr;
 	FunctionInfoTable[tableIndex].numParams = 0;
@@ -613,6 +934,8 @@ enterStandardRoutine(const std::wstring_view& name, int32_t routineKey, bool isO
 			NODEFAULT;
 		}
 		}
+	FunctionInfoTable[tableIndex].mode = FUNCTION_MODE_CONCURRENT;
+	FunctionInfoTable[tableIndex].deferredResult = 0;
 	FunctionCallbackTable[tableIndex] = callback;
 }
 
@@ -644,6 +967,9 @@ initSymTable(void)
 	//---------------------------------
 	// Init the level-0 symbol table...
 	SymTableDisplay[0] = nullptr;
+	SymbolNamePool = nullptr;
+	SymbolNamePoolSlots = 0;
+	NumSymbolNames = 0;
 	//----------------------------------------------------------------------
 	// Set up the basic variable types as identifiers in the symbol table...
 	const std::unique_ptr<SymTableNode>& integerIdPtr;
@@ -85,6 +85,10 @@ struct StateHandleInfo
 #define ROUTINE_FLAG_FSM 2
 #define ROUTINE_FLAG_STATE 4
 
+//----------------------------------------------------------------
+// Body of a routine translated to C++ ahead of time (see ablnative.h)...
+typedef void (*ABLNativeCode)(void);
+
 struct Routine
 {
 	RoutineKey key;
@@ -99,6 +103,7 @@ struct Routine
 	const std::unique_ptr<SymTableNode>& localSymTable;
 	const std::wstring_view& codeSegment;
 	int32_t codeSegmentSize;
+	ABLNativeCode nativeCode; // nullptr: interpret codeSegment
 };
 
 struct Data
@@ -127,6 +132,23 @@ struct Definition
 //------------------
 // SYMBOL TABLE node
 
+//---------------------------------------------------------------------------
+// Symbol names are interned, so two nodes with the same name share one
+// string. Each scope's root node also owns an open-addressed hash of the
+// names entered in that scope, keyed by the interned pointer. The tree
+// links are still kept for the code that walks a scope. Duplicate names
+// in a scope are chained through sameName, oldest first (the order the
+// tree search used to find them in).
+
+struct SymTableNode;
+
+struct SymTableIndex
+{
+	int32_t numSlots; // always a power of 2
+	int32_t numNames;
+	SymTableNode** slots;
+};
+
 struct SymTableNode
 {
 	std::unique_ptr<SymTableNode> left;
@@ -140,6 +162,8 @@ struct SymTableNode
 	Definition defn;
 	uint8_t level;
 	int32_t labelIndex; // really for compiling only...
+	SymTableIndex* index; // root node only, kept up as symbols are entered
+	SymTableNode* sameName;
 };
 
 enum class FunctionParamType : uint8_t
@@ -166,6 +190,23 @@ enum class FunctionReturnType : uint8_t
 	NUM_RETURN_TYPES
 };
 
+//---------------------------------------------------------------------------
+// How a standard function may run when its caller is on a worker context
+// (see ABLExecContext). Concurrent functions only read game state, or write
+// state owned by the calling object. Deferred ones are queued and replayed
+// on the main thread once the batch is done; if they return a value, the
+// script gets the provisional result given to ABLi_setFunctionMode. Main
+// thread functions need the real result right away, so any module that
+// calls one never runs on a worker context at all.
+
+enum class FunctionMode : uint8_t
+{
+	FUNCTION_MODE_CONCURRENT,
+	FUNCTION_MODE_DEFERRED,
+	FUNCTION_MODE_MAIN,
+	NUM_FUNCTION_MODES
+};
+
 #define MAX_STANDARD_FUNCTIONS 256
 #define MAX_FUNCTION_PARAMS 20
 
@@ -175,6 +216,8 @@ typedef struct
 	int32_t numParams;
 	FunctionParamType params[MAX_FUNCTION_PARAMS];
 	FunctionReturnType returnType;
+	FunctionMode mode;
+	int32_t deferredResult; // what a deferred call returns to the script
 } StandardFunctionInfo;
 
 //***************************************************************************
@@ -243,6 +286,17 @@ searchAndEnterThisTable(const std::unique_ptr<SymTableNode>&& IdPtr, const std::
 inline const std::unique_ptr<SymTableNode>&
 symTableSuccessor(const std::unique_ptr<SymTableNode>& nodeX);
 
+std::wstring_view
+internSymbolName(const std::wstring_view& name);
+const wchar_t*
+findSymbolName(const std::wstring_view& name);
+SymTableIndex*
+buildSymTableIndex(SymTableNode* tableRoot);
+void
+indexSymTables(SymTableNode* tableRoot);
+SymTableNode*
+searchSymTableIndex(const wchar_t* internedName, SymTableNode* tableRoot);
+
 const std::unique_ptr<SymTableNode>&
 searchSymTable(const std::wstring_view& name, const std::unique_ptr<SymTableNode>& nodePtr);
 const std::unique_ptr<SymTableNode>&
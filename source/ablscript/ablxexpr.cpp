@@ -23,16 +23,7 @@ namespace mclib::abl {
 //----------
 // EXTERNALS
 
-extern int32_t level;
-extern const std::wstring_view& codeSegmentPtr;
-extern TokenCodeType codeToken;
-
 extern StackItem* stack;
-extern const std::unique_ptr<StackItem>& tos;
-extern const std::unique_ptr<StackItem>& stackFrameBasePtr;
-extern const std::unique_ptr<StackItem>& StaticDataPtr;
-extern const std::unique_ptr<SymTableNode>& CurRoutineIdPtr;
-extern const std::unique_ptr<ABLModule>& CurModule;
 
 extern const std::unique_ptr<Type>& IntegerTypePtr;
 extern const std::unique_ptr<Type>& CharTypePtr;
@@ -60,24 +51,24 @@ execSubscripts(const std::unique_ptr<Type>& ptype)
 {
 	//----------------------------------------
 	// Loop to execute bracketed subscripts...
-	while (codeToken == TKN_LBRACKET)
+	while (CurContext->codeToken == TKN_LBRACKET)
 	{
 		do
 		{
 			getCodeToken();
 			execExpression();
-			int32_t subscriptValue = tos->integer;
+			int32_t subscriptValue = CurContext->tos->integer;
 			pop();
 			//-------------------------
 			// Range check the index...
 			if ((subscriptValue < 0) || (subscriptValue >= ptype->info.array.elementCount))
 				runtimeError(ABL_ERR_RUNTIME_VALUE_OUT_OF_RANGE);
-			tos->address += (subscriptValue * ptype->info.array.elementTypePtr->size);
-			if (codeToken == TKN_COMMA)
+			CurContext->tos->address += (subscriptValue * ptype->info.array.elementTypePtr->size);
+			if (CurContext->codeToken == TKN_COMMA)
 				ptype = ptype->info.array.elementTypePtr;
-		} while (codeToken == TKN_COMMA);
+		} while (CurContext->codeToken == TKN_COMMA);
 		getCodeToken();
-		if (codeToken == TKN_LBRACKET)
+		if (CurContext->codeToken == TKN_LBRACKET)
 			ptype = ptype->info.array.elementTypePtr;
 	}
 	return (ptype->info.array.elementTypePtr);
@@ -98,7 +89,7 @@ execConstant(const std::unique_ptr<SymTableNode>& idPtr)
 	else if (ptype->form == FRM_ARRAY)
 		pushAddress(idPtr->defn.info.constant.value.stringPtr);
 	if (debugger)
-		debugger->traceDataFetch(idPtr, ptype, tos);
+		debugger->traceDataFetch(idPtr, ptype, CurContext->tos);
 	getCodeToken();
 	return (ptype);
 }
@@ -114,12 +105,18 @@ execVariable(const std::unique_ptr<SymTableNode>& idPtr, UseType use)
 	// to the proper stack frame base...
 	const std::unique_ptr<StackItem>& dataPtr = nullptr;
 	StackItem tempStackItem;
+	//-------------------------------------------------------------
+	// Shared vars are read-only while brains think on worker
+	// contexts. The compiler keeps writers on the main context, so
+	// this only trips if that bookkeeping is wrong...
+	if ((use == USE_TARGET) && (CurContext != &MainExecContext) && isSharedVariable(idPtr))
+		runtimeError(ABL_ERR_RUNTIME_SHARED_WRITE);
 	switch (idPtr->defn.info.data.varType)
 	{
 	case VAR_TYPE_NORMAL:
 	{
-		const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)stackFrameBasePtr;
-		int32_t delta = level - idPtr->level;
+		const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)CurContext->stackFrameBasePtr;
+		int32_t delta = CurContext->level - idPtr->level;
 		while (delta-- > 0)
 			headerPtr = (const std::unique_ptr<StackFrameHeader>&)headerPtr->staticLink.address;
 		dataPtr = (const std::unique_ptr<StackItem>&)headerPtr + idPtr->defn.info.data.offset;
@@ -132,11 +129,11 @@ execVariable(const std::unique_ptr<SymTableNode>& idPtr, UseType use)
 		//---------------------------------------------------------
 		// If we're referencing a library's static variable, we may
 		// need to shift to its static data space temporarily...
-		if (idPtr->library && (idPtr->library != CurModule))
-			StaticDataPtr = idPtr->library->getStaticData();
-		dataPtr = (const std::unique_ptr<StackItem>&)StaticDataPtr + idPtr->defn.info.data.offset;
-		if (idPtr->library && (idPtr->library != CurModule))
-			StaticDataPtr = CurModule->getStaticData();
+		if (idPtr->library && (idPtr->library != CurContext->module))
+			CurContext->staticDataPtr = idPtr->library->getStaticData();
+		dataPtr = (const std::unique_ptr<StackItem>&)CurContext->staticDataPtr + idPtr->defn.info.data.offset;
+		if (idPtr->library && (idPtr->library != CurContext->module))
+			CurContext->staticDataPtr = CurContext->module->getStaticData();
 		break;
 	case VAR_TYPE_REGISTERED:
 		tempStackItem.address = (const std::wstring_view&)idPtr->defn.info.data.registeredData;
@@ -166,7 +163,7 @@ execVariable(const std::unique_ptr<SymTableNode>& idPtr, UseType use)
 	// in ABL) then modify the address to point to the proper element of the
 	// array (or record)...
 	getCodeToken();
-	while ((codeToken == TKN_LBRACKET) /*|| (codeTOken == TKN_PERIOD)*/)
+	while ((CurContext->codeToken == TKN_LBRACKET) /*|| (codeTOken == TKN_PERIOD)*/)
 	{
 		// if (codeToken == TKN_LBRACKET)
 		ptype = execSubscripts(ptype);
@@ -183,21 +180,21 @@ execVariable(const std::unique_ptr<SymTableNode>& idPtr, UseType use)
 	{
 		if ((ptype == IntegerTypePtr) || (ptype->form == FRM_ENUM))
 		{
-			tos->integer = *((int32_t*)tos->address);
+			CurContext->tos->integer = *((int32_t*)CurContext->tos->address);
 		}
 		else if (ptype == CharTypePtr)
-			tos->byte = *((const std::wstring_view&)tos->address);
+			CurContext->tos->byte = *((const std::wstring_view&)CurContext->tos->address);
 		else
-			tos->real = *((float*)tos->address);
+			CurContext->tos->real = *((float*)CurContext->tos->address);
 	}
 	if (debugger)
 	{
 		if ((use != USE_TARGET) && (use != USE_REFPARAM))
 		{
 			if (ptype->form == FRM_ARRAY)
-				debugger->traceDataFetch(idPtr, ptype, (const std::unique_ptr<StackItem>&)tos->address);
+				debugger->traceDataFetch(idPtr, ptype, (const std::unique_ptr<StackItem>&)CurContext->tos->address);
 			else
-				debugger->traceDataFetch(idPtr, ptype, tos);
+				debugger->traceDataFetch(idPtr, ptype, CurContext->tos);
 		}
 	}
 	return (ptype);
@@ -209,16 +206,16 @@ const std::unique_ptr<Type>&
 execFactor(void)
 {
 	const std::unique_ptr<Type>& resultTypePtr = nullptr;
-	switch (codeToken)
+	switch (CurContext->codeToken)
 	{
 	case TKN_IDENTIFIER:
 	{
 		const std::unique_ptr<SymTableNode>& idPtr = getCodeSymTableNodePtr();
 		if (idPtr->defn.key == DFN_FUNCTION)
 		{
-			const std::unique_ptr<SymTableNode>& thisRoutineIdPtr = CurRoutineIdPtr;
+			const std::unique_ptr<SymTableNode>& thisRoutineIdPtr = CurContext->routineIdPtr;
 			resultTypePtr = execRoutineCall(idPtr, false);
-			CurRoutineIdPtr = thisRoutineIdPtr;
+			CurContext->routineIdPtr = thisRoutineIdPtr;
 		}
 		else if (idPtr->defn.key == DFN_CONST)
 			resultTypePtr = execConstant(idPtr);
@@ -269,7 +266,7 @@ execFactor(void)
 		resultTypePtr = execFactor();
 		//--------------------------------------
 		// Following flips 1 to 0, and 0 to 1...
-		tos->integer = 1 - tos->integer;
+		CurContext->tos->integer = 1 - CurContext->tos->integer;
 		break;
 	case TKN_LPAREN:
 		getCodeToken();
@@ -292,13 +289,13 @@ execTerm(void)
 	const std::unique_ptr<Type>& resultTypePtr = execFactor();
 	//----------------------------------------------
 	// Process the factors separated by operators...
-	while ((codeToken == TKN_STAR) || (codeToken == TKN_FSLASH) || (codeToken == TKN_DIV) || (codeToken == TKN_MOD) || (codeToken == TKN_AND))
+	while ((CurContext->codeToken == TKN_STAR) || (CurContext->codeToken == TKN_FSLASH) || (CurContext->codeToken == TKN_DIV) || (CurContext->codeToken == TKN_MOD) || (CurContext->codeToken == TKN_AND))
 	{
-		op = codeToken;
+		op = CurContext->codeToken;
 		getCodeToken();
 		type2Ptr = execFactor();
-		operand1Ptr = tos - 1;
-		operand2Ptr = tos;
+		operand1Ptr = CurContext->tos - 1;
+		operand2Ptr = CurContext->tos;
 		if (op == TKN_AND)
 		{
 			operand1Ptr->integer = operand1Ptr->integer && operand2Ptr->integer;
@@ -401,9 +398,9 @@ execSimpleExpression(void)
 	TokenCodeType unaryOp = TKN_PLUS;
 	//------------------------------------------------------
 	// If there's a + or - before the expression, save it...
-	if ((codeToken == TKN_PLUS) || (codeToken == TKN_MINUS))
+	if ((CurContext->codeToken == TKN_PLUS) || (CurContext->codeToken == TKN_MINUS))
 	{
-		unaryOp = codeToken;
+		unaryOp = CurContext->codeToken;
 		getCodeToken();
 	}
 	const std::unique_ptr<Type>& resultTypePtr = execTerm();
@@ -412,17 +409,17 @@ execSimpleExpression(void)
 	if (unaryOp == TKN_MINUS)
 	{
 		if (resultTypePtr == IntegerTypePtr)
-			tos->integer = -(tos->integer);
+			CurContext->tos->integer = -(CurContext->tos->integer);
 		else
-			tos->real = -(tos->real);
+			CurContext->tos->real = -(CurContext->tos->real);
 	}
-	while ((codeToken == TKN_PLUS) || (codeToken == TKN_MINUS) || (codeToken == TKN_OR))
+	while ((CurContext->codeToken == TKN_PLUS) || (CurContext->codeToken == TKN_MINUS) || (CurContext->codeToken == TKN_OR))
 	{
-		TokenCodeType op = codeToken;
+		TokenCodeType op = CurContext->codeToken;
 		getCodeToken();
 		const std::unique_ptr<Type>& type2Ptr = execTerm();
-		const std::unique_ptr<StackItem>& operand1Ptr = tos - 1;
-		const std::unique_ptr<StackItem>& operand2Ptr = tos;
+		const std::unique_ptr<StackItem>& operand1Ptr = CurContext->tos - 1;
+		const std::unique_ptr<StackItem>& operand2Ptr = CurContext->tos;
 		if (op == TKN_OR)
 		{
 			operand1Ptr->integer = operand1Ptr->integer || operand2Ptr->integer;
@@ -471,15 +468,15 @@ execExpression(void)
 	//-----------------------------------------------------------
 	// If there is a relational operator, save it and process the
 	// second simple expression...
-	if ((codeToken == TKN_EQUALEQUAL) || (codeToken == TKN_LT) || (codeToken == TKN_GT) || (codeToken == TKN_NE) || (codeToken == TKN_LE) || (codeToken == TKN_GE))
+	if ((CurContext->codeToken == TKN_EQUALEQUAL) || (CurContext->codeToken == TKN_LT) || (CurContext->codeToken == TKN_GT) || (CurContext->codeToken == TKN_NE) || (CurContext->codeToken == TKN_LE) || (CurContext->codeToken == TKN_GE))
 	{
-		op = codeToken;
+		op = CurContext->codeToken;
 		getCodeToken();
 		//---------------------------------
 		// Get the 2nd simple expression...
 		type2Ptr = execSimpleExpression();
-		operand1Ptr = tos - 1;
-		operand2Ptr = tos;
+		operand1Ptr = CurContext->tos - 1;
+		operand2Ptr = CurContext->tos;
 		//-----------------------------------------------------
 		// Both operands are integer, boolean or enumeration...
 		if (((resultTypePtr == IntegerTypePtr) && (type2Ptr == IntegerTypePtr)) || (resultTypePtr->form == FRM_ENUM))
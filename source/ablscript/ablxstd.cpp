@@ -24,34 +24,18 @@ inline int32_t double2long(double _in)
 //----------
 // EXTERNALS
 
-extern int32_t level;
-extern int32_t execLineNumber;
-extern int32_t FileNumber;
-extern const std::wstring_view& codeSegmentPtr;
-extern TokenCodeType codeToken;
 extern StackItem* stack;
-extern const std::unique_ptr<StackItem>& tos;
-extern const std::unique_ptr<StackItem>& stackFrameBasePtr;
-extern const std::unique_ptr<SymTableNode>& CurRoutineIdPtr;
-extern int32_t CurModuleHandle;
 extern const std::unique_ptr<Type>& IntegerTypePtr;
 extern const std::unique_ptr<Type>& RealTypePtr;
 extern const std::unique_ptr<Type>& BooleanTypePtr;
 extern const std::unique_ptr<Type>& CharTypePtr;
-extern const std::unique_ptr<ABLModule>& CurModule;
-extern const std::unique_ptr<ABLModule>& CurFSM;
 extern int32_t MaxLoopIterations;
 extern const std::unique_ptr<Debugger>& debugger;
-extern bool NewStateSet;
 
 //--------
 // GLOBALS
 
-StackItem returnValue;
 bool eofFlag = false;
-bool ExitWithReturn = false;
-bool ExitFromTacOrder = false;
-bool SkipOrder = false;
 TokenCodeType ExitRoutineCodeSegment[2] = {TKN_END_FUNCTION, TKN_SEMICOLON};
 TokenCodeType ExitOrderCodeSegment[2] = {TKN_END_ORDER, TKN_SEMICOLON};
 TokenCodeType ExitStateCodeSegment[2] = {TKN_END_STATE, TKN_SEMICOLON};
@@ -60,12 +44,37 @@ TokenCodeType ExitStateCodeSegment[2] = {TKN_END_STATE, TKN_SEMICOLON};
 // USEFUL ABL HELP ROUTINES
 //***************************************************************************
 
+//---------------------------------------------------------------------------
+// While a deferred call is being applied, the pop/peek routines read the
+// arguments captured by recordDeferredCall instead of the code stream...
+
+inline StackItem*
+nextDeferredArg(void)
+{
+	StackItem* arg = (StackItem*)CurContext->replayArg;
+	CurContext->replayArg += sizeof(StackItem);
+	return (arg);
+}
+
+inline Address
+nextDeferredArray(void)
+{
+	int32_t size = nextDeferredArg()->integer;
+	Address data = (Address)CurContext->replayArg;
+	CurContext->replayArg += size;
+	return (data);
+}
+
+//---------------------------------------------------------------------------
+
 wchar_t
 ABLi_popChar(void)
 {
+	if (CurContext->replayArg)
+		return ((wchar_t)nextDeferredArg()->integer);
 	getCodeToken();
 	execExpression();
-	wchar_t val = (wchar_t)tos->integer;
+	wchar_t val = (wchar_t)CurContext->tos->integer;
 	pop();
 	return (val);
 }
@@ -75,9 +84,11 @@ ABLi_popChar(void)
 int32_t
 ABLi_popInteger(void)
 {
+	if (CurContext->replayArg)
+		return (nextDeferredArg()->integer);
 	getCodeToken();
 	execExpression();
-	int32_t val = tos->integer;
+	int32_t val = CurContext->tos->integer;
 	pop();
 	return (val);
 }
@@ -87,9 +98,11 @@ ABLi_popInteger(void)
 float
 ABLi_popReal(void)
 {
+	if (CurContext->replayArg)
+		return (nextDeferredArg()->real);
 	getCodeToken();
 	execExpression();
-	float val = tos->real;
+	float val = CurContext->tos->real;
 	pop();
 	return (val);
 }
@@ -99,13 +112,15 @@ ABLi_popReal(void)
 float
 ABLi_popIntegerReal(void)
 {
+	if (CurContext->replayArg)
+		return (nextDeferredArg()->real);
 	getCodeToken();
 	const std::unique_ptr<Type>& paramTypePtr = execExpression();
 	float val = 0.0;
 	if (paramTypePtr == IntegerTypePtr)
-		val = (float)tos->integer;
+		val = (float)CurContext->tos->integer;
 	else
-		val = tos->real;
+		val = CurContext->tos->real;
 	pop();
 	return (val);
 }
@@ -115,9 +130,11 @@ ABLi_popIntegerReal(void)
 bool
 ABLi_popBoolean(void)
 {
+	if (CurContext->replayArg)
+		return (nextDeferredArg()->integer == 1);
 	getCodeToken();
 	execExpression();
-	int32_t val = tos->integer;
+	int32_t val = CurContext->tos->integer;
 	pop();
 	return (val == 1);
 }
@@ -127,11 +144,13 @@ ABLi_popBoolean(void)
 const std::wstring_view&
 ABLi_popCharPtr(void)
 {
+	if (CurContext->replayArg)
+		return ((const std::wstring_view&)nextDeferredArray());
 	//--------------------------
 	// Get destination string...
 	getCodeToken();
 	execExpression();
-	const std::wstring_view& charPtr = (const std::wstring_view&)tos->address;
+	const std::wstring_view& charPtr = (const std::wstring_view&)CurContext->tos->address;
 	pop();
 	return (charPtr);
 }
@@ -141,10 +160,12 @@ ABLi_popCharPtr(void)
 int32_t*
 ABLi_popIntegerPtr(void)
 {
+	if (CurContext->replayArg)
+		return ((int32_t*)nextDeferredArray());
 	getCodeToken();
 	const std::unique_ptr<SymTableNode>& idPtr = getCodeSymTableNodePtr();
 	execVariable(idPtr, USE_REFPARAM);
-	int32_t* integerPtr = (int32_t*)(&((const std::unique_ptr<StackItem>&)tos->address)->integer);
+	int32_t* integerPtr = (int32_t*)(&((const std::unique_ptr<StackItem>&)CurContext->tos->address)->integer);
 	pop();
 	return (integerPtr);
 }
@@ -154,10 +175,12 @@ ABLi_popIntegerPtr(void)
 float*
 ABLi_popRealPtr(void)
 {
+	if (CurContext->replayArg)
+		return ((float*)nextDeferredArray());
 	getCodeToken();
 	const std::unique_ptr<SymTableNode>& idPtr = getCodeSymTableNodePtr();
 	execVariable(idPtr, USE_REFPARAM);
-	float* realPtr = (float*)(&((const std::unique_ptr<StackItem>&)tos->address)->real);
+	float* realPtr = (float*)(&((const std::unique_ptr<StackItem>&)CurContext->tos->address)->real);
 	pop();
 	return (realPtr);
 }
@@ -167,11 +190,13 @@ ABLi_popRealPtr(void)
 const std::wstring_view&
 ABLi_popBooleanPtr(void)
 {
+	if (CurContext->replayArg)
+		return ((const std::wstring_view&)nextDeferredArray());
 	//--------------------------
 	// Get destination string...
 	getCodeToken();
 	execExpression();
-	const std::wstring_view& charPtr = (const std::wstring_view&)tos->address;
+	const std::wstring_view& charPtr = (const std::wstring_view&)CurContext->tos->address;
 	pop();
 	return (charPtr);
 }
@@ -179,55 +204,86 @@ ABLi_popBooleanPtr(void)
 //---------------------------------------------------------------------------
 
 int32_t
-ABLi_popAnything(ABLStackItem* value)
+getAnythingType(const std::unique_ptr<Type>& paramTypePtr)
 {
-	getCodeToken();
-	const std::unique_ptr<Type>& paramTypePtr = execExpression();
-	int32_t type = -1;
 	if (paramTypePtr == IntegerTypePtr)
+		return (ABL_STACKITEM_INTEGER);
+	if (paramTypePtr == BooleanTypePtr)
+		return (ABL_STACKITEM_BOOLEAN);
+	if (paramTypePtr == CharTypePtr)
+		return (ABL_STACKITEM_CHAR);
+	if (paramTypePtr == RealTypePtr)
+		return (ABL_STACKITEM_REAL);
+	if (paramTypePtr->form == FRM_ARRAY)
 	{
-		value->type = type = ABL_STACKITEM_INTEGER;
-		value->data.integer = tos->integer;
-	}
-	else if (paramTypePtr == BooleanTypePtr)
-	{
-		value->type = type = ABL_STACKITEM_BOOLEAN;
-		value->data.boolean = (tos->integer ? true : false);
+		if (paramTypePtr->info.array.elementTypePtr == CharTypePtr)
+			return (ABL_STACKITEM_CHAR_PTR);
+		if (paramTypePtr->info.array.elementTypePtr == IntegerTypePtr)
+			return (ABL_STACKITEM_INTEGER_PTR);
+		if (paramTypePtr->info.array.elementTypePtr == RealTypePtr)
+			return (ABL_STACKITEM_REAL_PTR);
+		if (paramTypePtr->info.array.elementTypePtr == BooleanTypePtr)
+			return (ABL_STACKITEM_BOOLEAN_PTR);
 	}
-	else if (paramTypePtr == CharTypePtr)
+	return (-1);
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+ABLi_popAnything(ABLStackItem* value)
+{
+	int32_t type = -1;
+	StackItem liveItem;
+	StackItem* item = &liveItem;
+	Address data = nullptr;
+	if (CurContext->replayArg)
 	{
-		value->type = type = ABL_STACKITEM_CHAR;
-		value->data.character = tos->byte;
+		//------------------------------------------------------------
+		// recordDeferredCall kept the type, then the value or array...
+		type = nextDeferredArg()->integer;
+		if (type >= ABL_STACKITEM_CHAR_PTR)
+			data = nextDeferredArray();
+		else if (type != -1)
+			item = nextDeferredArg();
 	}
-	else if (paramTypePtr == RealTypePtr)
+	else
 	{
-		value->type = type = ABL_STACKITEM_REAL;
-		value->data.real = tos->real;
+		getCodeToken();
+		type = getAnythingType(execExpression());
+		liveItem = *CurContext->tos;
+		data = liveItem.address;
+		pop();
 	}
-	else if (paramTypePtr->form == FRM_ARRAY)
+	switch (type)
 	{
-		if (paramTypePtr->info.array.elementTypePtr == CharTypePtr)
-		{
-			value->type = type = ABL_STACKITEM_CHAR_PTR;
-			value->data.characterPtr = (const std::wstring_view&)tos->address;
-		}
-		else if (paramTypePtr->info.array.elementTypePtr == IntegerTypePtr)
-		{
-			value->type = type = ABL_STACKITEM_INTEGER_PTR;
-			value->data.integerPtr = (int32_t*)tos->address;
-		}
-		else if (paramTypePtr->info.array.elementTypePtr == RealTypePtr)
-		{
-			value->type = type = ABL_STACKITEM_REAL_PTR;
-			value->data.realPtr = (float*)tos->address;
-		}
-		else if (paramTypePtr->info.array.elementTypePtr == BooleanTypePtr)
-		{
-			value->type = type = ABL_STACKITEM_BOOLEAN_PTR;
-			value->data.booleanPtr = (bool*)tos->address;
-		}
+	case ABL_STACKITEM_INTEGER:
+		value->data.integer = item->integer;
+		break;
+	case ABL_STACKITEM_BOOLEAN:
+		value->data.boolean = (item->integer ? true : false);
+		break;
+	case ABL_STACKITEM_CHAR:
+		value->data.character = item->byte;
+		break;
+	case ABL_STACKITEM_REAL:
+		value->data.real = item->real;
+		break;
+	case ABL_STACKITEM_CHAR_PTR:
+		value->data.characterPtr = (const std::wstring_view&)data;
+		break;
+	case ABL_STACKITEM_INTEGER_PTR:
+		value->data.integerPtr = (int32_t*)data;
+		break;
+	case ABL_STACKITEM_REAL_PTR:
+		value->data.realPtr = (float*)data;
+		break;
+	case ABL_STACKITEM_BOOLEAN_PTR:
+		value->data.booleanPtr = (bool*)data;
+		break;
 	}
-	pop();
+	if (type != -1)
+		value->type = type;
 	return (type);
 }
 
@@ -236,8 +292,8 @@ ABLi_popAnything(ABLStackItem* value)
 void
 ABLi_pushBoolean(bool value)
 {
-	const std::unique_ptr<StackItem>& valuePtr = ++tos;
-	if (valuePtr >= &stack[MAXSIZE_STACK])
+	const std::unique_ptr<StackItem>& valuePtr = ++CurContext->tos;
+	if (valuePtr >= CurContext->stackLimit)
 		runtimeError(ABL_ERR_RUNTIME_STACK_OVERFLOW);
 	valuePtr->integer = value ? 1 : 0;
 }
@@ -247,8 +303,8 @@ ABLi_pushBoolean(bool value)
 void
 ABLi_pushInteger(int32_t value)
 {
-	const std::unique_ptr<StackItem>& valuePtr = ++tos;
-	if (valuePtr >= &stack[MAXSIZE_STACK])
+	const std::unique_ptr<StackItem>& valuePtr = ++CurContext->tos;
+	if (valuePtr >= CurContext->stackLimit)
 		runtimeError(ABL_ERR_RUNTIME_STACK_OVERFLOW);
 	valuePtr->integer = value;
 }
@@ -258,8 +314,8 @@ ABLi_pushInteger(int32_t value)
 void
 ABLi_pushReal(float value)
 {
-	const std::unique_ptr<StackItem>& valuePtr = ++tos;
-	if (valuePtr >= &stack[MAXSIZE_STACK])
+	const std::unique_ptr<StackItem>& valuePtr = ++CurContext->tos;
+	if (valuePtr >= CurContext->stackLimit)
 		runtimeError(ABL_ERR_RUNTIME_STACK_OVERFLOW);
 	valuePtr->real = value;
 }
@@ -269,8 +325,8 @@ ABLi_pushReal(float value)
 void
 ABLi_pushChar(wchar_t value)
 {
-	const std::unique_ptr<StackItem>& valuePtr = ++tos;
-	if (valuePtr >= &stack[MAXSIZE_STACK])
+	const std::unique_ptr<StackItem>& valuePtr = ++CurContext->tos;
+	if (valuePtr >= CurContext->stackLimit)
 		runtimeError(ABL_ERR_RUNTIME_STACK_OVERFLOW);
 	valuePtr->integer = value;
 }
@@ -280,9 +336,11 @@ ABLi_pushChar(wchar_t value)
 int32_t
 ABLi_peekInteger(void)
 {
+	if (CurContext->replayArg)
+		return (nextDeferredArg()->integer);
 	getCodeToken();
 	execExpression();
-	return (tos->integer);
+	return (CurContext->tos->integer);
 }
 
 //---------------------------------------------------------------------------
@@ -290,9 +348,11 @@ ABLi_peekInteger(void)
 float
 ABLi_peekReal(void)
 {
+	if (CurContext->replayArg)
+		return (nextDeferredArg()->real);
 	getCodeToken();
 	execExpression();
-	return (tos->real);
+	return (CurContext->tos->real);
 }
 
 //---------------------------------------------------------------------------
@@ -300,9 +360,11 @@ ABLi_peekReal(void)
 bool
 ABLi_peekBoolean(void)
 {
+	if (CurContext->replayArg)
+		return (nextDeferredArg()->integer == 1);
 	getCodeToken();
 	execExpression();
-	return (tos->integer == 1);
+	return (CurContext->tos->integer == 1);
 }
 
 //---------------------------------------------------------------------------
@@ -310,9 +372,11 @@ ABLi_peekBoolean(void)
 const std::wstring_view&
 ABLi_peekCharPtr(void)
 {
+	if (CurContext->replayArg)
+		return ((const std::wstring_view&)nextDeferredArray());
 	getCodeToken();
 	execExpression();
-	return ((const std::wstring_view&)tos->address);
+	return ((const std::wstring_view&)CurContext->tos->address);
 }
 
 //---------------------------------------------------------------------------
@@ -320,10 +384,12 @@ ABLi_peekCharPtr(void)
 int32_t*
 ABLi_peekIntegerPtr(void)
 {
+	if (CurContext->replayArg)
+		return ((int32_t*)nextDeferredArray());
 	getCodeToken();
 	const std::unique_ptr<SymTableNode>& idPtr = getCodeSymTableNodePtr();
 	execVariable(idPtr, USE_REFPARAM);
-	return ((int32_t*)(&((const std::unique_ptr<StackItem>&)tos->address)->integer));
+	return ((int32_t*)(&((const std::unique_ptr<StackItem>&)CurContext->tos->address)->integer));
 }
 
 //---------------------------------------------------------------------------
@@ -331,10 +397,12 @@ ABLi_peekIntegerPtr(void)
 float*
 ABLi_peekRealPtr(void)
 {
+	if (CurContext->replayArg)
+		return ((float*)nextDeferredArray());
 	getCodeToken();
 	const std::unique_ptr<SymTableNode>& idPtr = getCodeSymTableNodePtr();
 	execVariable(idPtr, USE_REFPARAM);
-	return ((float*)(&((const std::unique_ptr<StackItem>&)tos->address)->real));
+	return ((float*)(&((const std::unique_ptr<StackItem>&)CurContext->tos->address)->real));
 }
 
 //---------------------------------------------------------------------------
@@ -342,7 +410,7 @@ ABLi_peekRealPtr(void)
 void
 ABLi_pokeChar(int32_t val)
 {
-	tos->integer = val;
+	CurContext->tos->integer = val;
 }
 
 //---------------------------------------------------------------------------
@@ -350,7 +418,7 @@ ABLi_pokeChar(int32_t val)
 void
 ABLi_pokeInteger(int32_t val)
 {
-	tos->integer = val;
+	CurContext->tos->integer = val;
 }
 
 //---------------------------------------------------------------------------
@@ -358,7 +426,7 @@ ABLi_pokeInteger(int32_t val)
 void
 ABLi_pokeReal(float val)
 {
-	tos->real = val;
+	CurContext->tos->real = val;
 }
 
 //---------------------------------------------------------------------------
@@ -366,7 +434,7 @@ ABLi_pokeReal(float val)
 void
 ABLi_pokeBoolean(bool val)
 {
-	tos->integer = val ? 1 : 0;
+	CurContext->tos->integer = val ? 1 : 0;
 }
 
 //***************************************************************************
@@ -376,24 +444,24 @@ execOrderReturn(int32_t returnVal)
 {
 	//-----------------------------
 	// Assignment to function id...
-	const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)stackFrameBasePtr;
-	int32_t delta = level - CurRoutineIdPtr->level - 1;
+	const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)CurContext->stackFrameBasePtr;
+	int32_t delta = CurContext->level - CurContext->routineIdPtr->level - 1;
 	while (delta-- > 0)
 		headerPtr = (const std::unique_ptr<StackFrameHeader>&)headerPtr->staticLink.address;
-	if (CurRoutineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_STATE)
+	if (CurContext->routineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_STATE)
 	{
 		//----------------------------------
 		// Return in a state function, so...
 		if (debugger)
-			debugger->traceDataStore(CurRoutineIdPtr, CurRoutineIdPtr->ptype,
-				(const std::unique_ptr<StackItem>&)headerPtr, CurRoutineIdPtr->ptype);
-		ExitWithReturn = true;
-		ExitFromTacOrder = true;
+			debugger->traceDataStore(CurContext->routineIdPtr, CurContext->routineIdPtr->ptype,
+				(const std::unique_ptr<StackItem>&)headerPtr, CurContext->routineIdPtr->ptype);
+		CurContext->exitWithReturn = true;
+		CurContext->exitFromTacOrder = true;
 		if (returnVal == 0)
 		{
 			//----------------------------------------------------------
 			// Use the "eject" code only if called for a failed Order...
-			codeSegmentPtr = (const std::wstring_view&)ExitStateCodeSegment;
+			CurContext->codeSegmentPtr = (const std::wstring_view&)ExitStateCodeSegment;
 			getCodeToken();
 		}
 	}
@@ -407,17 +475,17 @@ execOrderReturn(int32_t returnVal)
 		targetPtr->integer = returnVal;
 		//----------------------------------------------------------------------
 		// Preserve the return value, in case we need it for the calling user...
-		memcpy(&returnValue, targetPtr, sizeof(StackItem));
+		memcpy(&CurContext->returnValue, targetPtr, sizeof(StackItem));
 		if (debugger)
-			debugger->traceDataStore(CurRoutineIdPtr, CurRoutineIdPtr->ptype,
-				(const std::unique_ptr<StackItem>&)headerPtr, CurRoutineIdPtr->ptype);
-		ExitWithReturn = true;
-		ExitFromTacOrder = true;
+			debugger->traceDataStore(CurContext->routineIdPtr, CurContext->routineIdPtr->ptype,
+				(const std::unique_ptr<StackItem>&)headerPtr, CurContext->routineIdPtr->ptype);
+		CurContext->exitWithReturn = true;
+		CurContext->exitFromTacOrder = true;
 		if (returnVal == 0)
 		{
 			//----------------------------------------------------------
 			// Use the "eject" code only if called for a failed Order...
-			codeSegmentPtr = (const std::wstring_view&)ExitOrderCodeSegment;
+			CurContext->codeSegmentPtr = (const std::wstring_view&)ExitOrderCodeSegment;
 			getCodeToken();
 		}
 	}
@@ -428,17 +496,17 @@ execOrderReturn(int32_t returnVal)
 void
 execStdReturn(void)
 {
-	memset(&returnValue, 0, sizeof(StackItem));
-	if (CurRoutineIdPtr->ptype)
+	memset(&CurContext->returnValue, 0, sizeof(StackItem));
+	if (CurContext->routineIdPtr->ptype)
 	{
 		//-----------------------------
 		// Assignment to function id...
-		const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)stackFrameBasePtr;
-		int32_t delta = level - CurRoutineIdPtr->level - 1;
+		const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)CurContext->stackFrameBasePtr;
+		int32_t delta = CurContext->level - CurContext->routineIdPtr->level - 1;
 		while (delta-- > 0)
 			headerPtr = (const std::unique_ptr<StackFrameHeader>&)headerPtr->staticLink.address;
 		const std::unique_ptr<StackItem>& targetPtr = (const std::unique_ptr<StackItem>&)headerPtr;
-		const std::unique_ptr<Type>& targetTypePtr = (const std::unique_ptr<Type>&)(CurRoutineIdPtr->ptype);
+		const std::unique_ptr<Type>& targetTypePtr = (const std::unique_ptr<Type>&)(CurContext->routineIdPtr->ptype);
 		getCodeToken();
 		//---------------------------------------------------------------
 		// Routine execExpression() leaves the expression value on top of
@@ -451,14 +519,14 @@ execStdReturn(void)
 		{
 			//-------------------------
 			// integer assigned to real
-			targetPtr->real = (float)(tos->integer);
+			targetPtr->real = (float)(CurContext->tos->integer);
 		}
 		else if (targetTypePtr->form == FRM_ARRAY)
 		{
 			//-------------------------
 			// Copy the array/record...
 			const std::wstring_view& dest = (const std::wstring_view&)targetPtr;
-			const std::wstring_view& src = tos->address;
+			const std::wstring_view& src = CurContext->tos->address;
 			int32_t size = targetTypePtr->size;
 			memcpy(dest, src, size);
 		}
@@ -466,34 +534,34 @@ execStdReturn(void)
 		{
 			//------------------------------------------------------
 			// Range check assignment to integer or enum subrange...
-			targetPtr->integer = tos->integer;
+			targetPtr->integer = CurContext->tos->integer;
 		}
 		else
 		{
 			//-----------------------
 			// Assign real to real...
-			targetPtr->real = tos->real;
+			targetPtr->real = CurContext->tos->real;
 		}
 		//-----------------------------
 		// Grab the expression value...
 		pop();
 		//----------------------------------------------------------------------
 		// Preserve the return value, in case we need it for the calling user...
-		memcpy(&returnValue, targetPtr, sizeof(StackItem));
+		memcpy(&CurContext->returnValue, targetPtr, sizeof(StackItem));
 		if (debugger)
 			debugger->traceDataStore(
-				CurRoutineIdPtr, CurRoutineIdPtr->ptype, targetPtr, targetTypePtr);
+				CurContext->routineIdPtr, CurContext->routineIdPtr->ptype, targetPtr, targetTypePtr);
 	}
 	//-----------------------
 	// Grab the semi-colon...
 	getCodeToken();
-	if (CurRoutineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_ORDER)
-		codeSegmentPtr = (const std::wstring_view&)ExitOrderCodeSegment;
-	else if (CurRoutineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_STATE)
-		codeSegmentPtr = (const std::wstring_view&)ExitStateCodeSegment;
+	if (CurContext->routineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_ORDER)
+		CurContext->codeSegmentPtr = (const std::wstring_view&)ExitOrderCodeSegment;
+	else if (CurContext->routineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_STATE)
+		CurContext->codeSegmentPtr = (const std::wstring_view&)ExitStateCodeSegment;
 	else
-		codeSegmentPtr = (const std::wstring_view&)ExitRoutineCodeSegment;
-	ExitWithReturn = true;
+		CurContext->codeSegmentPtr = (const std::wstring_view&)ExitRoutineCodeSegment;
+	CurContext->exitWithReturn = true;
 	getCodeToken();
 }
 
@@ -512,26 +580,26 @@ execStdPrint(void)
 	wchar_t buffer[20];
 	const std::wstring_view& s = buffer;
 	if (paramTypePtr == IntegerTypePtr)
-		sprintf(buffer, "%d", tos->integer);
+		sprintf(buffer, "%d", CurContext->tos->integer);
 	else if (paramTypePtr == BooleanTypePtr)
-		sprintf(buffer, "%s", tos->integer ? "true" : "false");
+		sprintf(buffer, "%s", CurContext->tos->integer ? "true" : "false");
 	else if (paramTypePtr == CharTypePtr)
-		sprintf(buffer, "%c", tos->byte);
+		sprintf(buffer, "%c", CurContext->tos->byte);
 	else if (paramTypePtr == RealTypePtr)
-		sprintf(buffer, "%.4f", tos->real);
+		sprintf(buffer, "%.4f", CurContext->tos->real);
 	else if ((paramTypePtr->form == FRM_ARRAY) && (paramTypePtr->info.array.elementTypePtr == CharTypePtr))
-		s = (const std::wstring_view&)tos->address;
+		s = (const std::wstring_view&)CurContext->tos->address;
 	pop();
 	if (debugger)
 	{
 		wchar_t message[512];
 		sprintf(message, "PRINT:  \"%s\"", s);
 		debugger->print(message);
-		sprintf(message, "   MODULE %s", CurModule->getName());
+		sprintf(message, "   MODULE %s", CurContext->module->getName());
 		debugger->print(message);
-		sprintf(message, "   FILE %s", CurModule->getSourceFile(FileNumber));
+		sprintf(message, "   FILE %s", CurContext->module->getSourceFile(CurContext->fileNumber));
 		debugger->print(message);
-		sprintf(message, "   LINE %d", execLineNumber);
+		sprintf(message, "   LINE %d", CurContext->execLineNumber);
 		debugger->print(message);
 	}
 	/*	else if (TACMAP) {
@@ -568,7 +636,7 @@ execStdConcat(void)
 	// Get destination string...
 	getCodeToken();
 	execExpression();
-	const std::wstring_view& dest = (const std::wstring_view&)tos->address;
+	const std::wstring_view& dest = (const std::wstring_view&)CurContext->tos->address;
 	pop();
 	//----------------------
 	// Get item to append...
@@ -577,27 +645,27 @@ execStdConcat(void)
 	wchar_t buffer[20];
 	if (paramTypePtr == IntegerTypePtr)
 	{
-		sprintf(buffer, "%d", tos->integer);
+		sprintf(buffer, "%d", CurContext->tos->integer);
 		strcat(dest, buffer);
 	}
 	else if (paramTypePtr == CharTypePtr)
 	{
-		sprintf(buffer, "%c", tos->byte);
+		sprintf(buffer, "%c", CurContext->tos->byte);
 		strcat(dest, buffer);
 	}
 	else if (paramTypePtr == RealTypePtr)
 	{
-		sprintf(buffer, "%.2f", tos->real);
+		sprintf(buffer, "%.2f", CurContext->tos->real);
 		strcat(dest, buffer);
 	}
 	else if (paramTypePtr == BooleanTypePtr)
 	{
-		sprintf(buffer, "%s", tos->integer ? "true" : "false");
+		sprintf(buffer, "%s", CurContext->tos->integer ? "true" : "false");
 		strcat(dest, buffer);
 	}
 	else if ((paramTypePtr->form == FRM_ARRAY) && (paramTypePtr->info.array.elementTypePtr == CharTypePtr))
-		strcat(dest, (const std::wstring_view&)tos->address);
-	tos->integer = 0;
+		strcat(dest, (const std::wstring_view&)CurContext->tos->address);
+	CurContext->tos->integer = 0;
 	getCodeToken();
 	return (IntegerTypePtr);
 }
@@ -695,9 +763,9 @@ execStdGetModule(void)
 	// Return the handle of the current module being executed...
 	const std::wstring_view& curBuffer = ABLi_popCharPtr();
 	const std::wstring_view& fsmBuffer = ABLi_popCharPtr();
-	strcpy(curBuffer, CurModule->getFileName());
-	strcpy(fsmBuffer, CurFSM ? CurFSM->getFileName() : "none");
-	ABLi_pushInteger(CurModuleHandle);
+	strcpy(curBuffer, CurContext->module->getFileName());
+	strcpy(fsmBuffer, CurContext->fsm ? CurContext->fsm->getFileName() : "none");
+	ABLi_pushInteger(CurContext->moduleHandle);
 }
 
 //***************************************************************************
@@ -747,11 +815,11 @@ execStdFatal(void)
 	{
 		sprintf(message, "FATAL:  [%d] \"%s\"", code, s);
 		debugger->print(message);
-		sprintf(message, "   MODULE (%d) %s", CurModule->getId(), CurModule->getName());
+		sprintf(message, "   MODULE (%d) %s", CurContext->module->getId(), CurContext->module->getName());
 		debugger->print(message);
-		sprintf(message, "   FILE %s", CurModule->getSourceFile(FileNumber));
+		sprintf(message, "   FILE %s", CurContext->module->getSourceFile(CurContext->fileNumber));
 		debugger->print(message);
-		sprintf(message, "   LINE %d", execLineNumber);
+		sprintf(message, "   LINE %d", CurContext->execLineNumber);
 		debugger->print(message);
 		debugger->debugMode();
 	}
@@ -796,11 +864,11 @@ execStdAssert(void)
 		{
 			sprintf(message, "ASSERT:  [%d] \"%s\"", code, s);
 			debugger->print(message);
-			sprintf(message, "   MODULE (%d) %s", CurModule->getId(), CurModule->getName());
+			sprintf(message, "   MODULE (%d) %s", CurContext->module->getId(), CurContext->module->getName());
 			debugger->print(message);
-			sprintf(message, "   FILE %s", CurModule->getSourceFile(FileNumber));
+			sprintf(message, "   FILE %s", CurContext->module->getSourceFile(CurContext->fileNumber));
 			debugger->print(message);
-			sprintf(message, "   LINE %d", execLineNumber);
+			sprintf(message, "   LINE %d", CurContext->execLineNumber);
 			debugger->print(message);
 			debugger->debugMode();
 		}
@@ -814,6 +882,20 @@ execStdAssert(void)
 
 //-----------------------------------------------------------------------------
 
+inline int32_t
+contextRandom(int32_t range)
+{
+	//-------------------------------------------------------------------
+	// A worker context can't share the game's generator, so it steps its
+	// own, seeded by whoever scheduled the module...
+	CurContext->randomSeed = CurContext->randomSeed * 214013 + 2531011;
+	if (range <= 0)
+		return (0);
+	return ((int32_t)((CurContext->randomSeed >> 16) & 0x7fff) % range);
+}
+
+//-----------------------------------------------------------------------------
+
 void
 execStdRandom(void)
 {
@@ -823,7 +905,10 @@ execStdRandom(void)
 	// Once we know which pseudo-random number algorithm we want to use, we
 	// should plug it in here. The range for the random number (r), given a
 	// param of (n), should be: 0 <= r <= (n-1).
-	ABLi_pokeInteger(ABLRandomCallback(n));
+	if (CurContext->ownRandom)
+		ABLi_pokeInteger(contextRandom(n));
+	else
+		ABLi_pokeInteger(ABLRandomCallback(n));
 }
 
 //-----------------------------------------------------------------------------
@@ -832,7 +917,9 @@ void
 execStdSeedRandom(void)
 {
 	int32_t seed = ABLi_popInteger();
-	if (seed == -1)
+	if (CurContext->ownRandom)
+		CurContext->randomSeed = (seed == -1) ? (uint32_t)time(nullptr) : (uint32_t)seed;
+	else if (seed == -1)
 		ABLSeedRandomCallback(time(nullptr));
 	else
 		ABLSeedRandomCallback(seed);
@@ -845,16 +932,16 @@ execStdResetOrders(void)
 {
 	int32_t scope = ABLi_popInteger();
 	if (scope == 0)
-		CurModule->resetOrderCallFlags();
+		CurContext->module->resetOrderCallFlags();
 	else if (scope == 1)
 	{
-		int32_t startIndex = CurRoutineIdPtr->defn.info.routine.orderCallIndex;
-		int32_t endIndex = startIndex + CurRoutineIdPtr->defn.info.routine.numOrderCalls;
+		int32_t startIndex = CurContext->routineIdPtr->defn.info.routine.orderCallIndex;
+		int32_t endIndex = startIndex + CurContext->routineIdPtr->defn.info.routine.numOrderCalls;
 		for (size_t i = startIndex; i < endIndex; i++)
 		{
 			uint8_t orderDWord = (uint8_t)(i / 32);
 			uint8_t orderBitMask = (uint8_t)(i % 32);
-			CurModule->clearOrderCallFlag(orderDWord, orderBitMask);
+			CurContext->module->clearOrderCallFlag(orderDWord, orderBitMask);
 		}
 	}
 }
@@ -865,7 +952,7 @@ void
 execStdGetStateHandle(void)
 {
 	const std::wstring_view& name = ABLi_popCharPtr();
-	int32_t stateHandle = CurFSM->findStateHandle(_strlwr(name));
+	int32_t stateHandle = CurContext->fsm->findStateHandle(_strlwr(name));
 	ABLi_pushInteger(stateHandle);
 }
 
@@ -874,7 +961,7 @@ execStdGetStateHandle(void)
 void
 execStdGetCurrentStateHandle(void)
 {
-	int32_t stateHandle = CurFSM->getStateHandle();
+	int32_t stateHandle = CurContext->fsm->getStateHandle();
 	ABLi_pushInteger(stateHandle);
 }
 
@@ -882,8 +969,6 @@ execStdGetCurrentStateHandle(void)
 
 extern const std::unique_ptr<ModuleEntry>& ModuleRegistry;
 
-extern wchar_t SetStateDebugStr[256];
-
 void
 execStdSetState(void)
 {
@@ -891,12 +976,12 @@ execStdSetState(void)
 	if (stateHandle > 0)
 	{
 		const std::unique_ptr<SymTableNode>& stateFunction =
-			ModuleRegistry[CurFSM->getHandle()].stateHandles[stateHandle].state;
-		CurFSM->setPrevState(CurFSM->getState());
-		CurFSM->setState(stateFunction);
-		sprintf(SetStateDebugStr, "%s:%s, line %d", CurFSM->getFileName(), stateFunction->name,
-			execLineNumber);
-		NewStateSet = true;
+			ModuleRegistry[CurContext->fsm->getHandle()].stateHandles[stateHandle].state;
+		CurContext->fsm->setPrevState(CurContext->fsm->getState());
+		CurContext->fsm->setState(stateFunction);
+		sprintf(CurContext->stateDebugStr, "%s:%s, line %d", CurContext->fsm->getFileName(), stateFunction->name,
+			CurContext->execLineNumber);
+		CurContext->newStateSet = true;
 	}
 }
 
@@ -906,7 +991,7 @@ void
 execStdGetFunctionHandle(void)
 {
 	const std::wstring_view& name = ABLi_popCharPtr();
-	const std::unique_ptr<SymTableNode>& function = CurModule->findFunction(name, false);
+	const std::unique_ptr<SymTableNode>& function = CurContext->module->findFunction(name, false);
 	if (function)
 		ABLi_pushInteger((uint32_t)function);
 	else
@@ -990,6 +1075,8 @@ const std::unique_ptr<Type>&
 execStandardRoutineCall(const std::unique_ptr<SymTableNode>& routineIdPtr, bool skipOrder)
 {
 	int32_t key = routineIdPtr->defn.info.routine.key;
+	int32_t orderCall = CurContext->orderCall;
+	CurContext->orderCall = -1;
 	switch (key)
 	{
 	case RTN_RETURN:
@@ -1005,22 +1092,39 @@ execStandardRoutineCall(const std::unique_ptr<SymTableNode>& routineIdPtr, bool
 		if (key >= NumStandardFunctions)
 		{
 			wchar_t err[255];
-			sprintf(err, " ABL: Undefined ABL RoutineKey in %s:%d", CurModule->getName(),
-				execLineNumber);
+			sprintf(err, " ABL: Undefined ABL RoutineKey in %s:%d", CurContext->module->getName(),
+				CurContext->execLineNumber);
 			ABL_Fatal(0, err);
 		}
 		if (FunctionInfoTable[key].numParams > 0)
 			getCodeToken();
-		SkipOrder = skipOrder;
-		if (FunctionCallbackTable[key])
+		CurContext->skipOrder = skipOrder;
+		if (!FunctionCallbackTable[key])
+		{
+			wchar_t err[255];
+			sprintf(err, " ABL: Undefined ABL RoutineKey %d in %s:%d", key, CurContext->module->getName(),
+				CurContext->execLineNumber);
+			ABL_Fatal(key, err);
+		}
+		if (ProfilerEnabled)
+			profileRoutineEntry(routineIdPtr, true);
+		if ((CurContext == &MainExecContext) || (FunctionInfoTable[key].mode == FUNCTION_MODE_CONCURRENT))
 			(*FunctionCallbackTable[key])();
+		else if ((FunctionInfoTable[key].mode == FUNCTION_MODE_DEFERRED) && CurContext->commandBuffer)
+			recordDeferredCall(key, skipOrder, orderCall);
 		else
 		{
+			//------------------------------------------------------------
+			// Modules that call main thread functions never leave the main
+			// context (see ABLModule::isMainThreadOnly), so we shouldn't be
+			// here...
 			wchar_t err[255];
-			sprintf(err, " ABL: Undefined ABL RoutineKey %d in %s:%d", key, CurModule->getName(),
-				execLineNumber);
+			sprintf(err, " ABL: main thread function %s called off the main context in %s:%d",
+				routineIdPtr->name, CurContext->module->getName(), CurContext->execLineNumber);
 			ABL_Fatal(key, err);
 		}
+		if (ProfilerEnabled)
+			profileRoutineExit();
 		getCodeToken();
 		switch (FunctionInfoTable[key].returnType)
 		{
@@ -1038,6 +1142,167 @@ execStandardRoutineCall(const std::unique_ptr<SymTableNode>& routineIdPtr, bool
 	return (nullptr);
 }
 
+//***************************************************************************
+// DEFERRED CALL routines
+//***************************************************************************
+
+uint8_t*
+reserveDeferredBytes(int32_t numBytes)
+{
+	ABLCommandBuffer* buffer = CurContext->commandBuffer;
+	if ((buffer->size + numBytes) > buffer->maxSize)
+	{
+		wchar_t err[255];
+		sprintf(err, " ABL: deferred call buffer overflow in %s:%d", CurContext->module->getName(),
+			CurContext->execLineNumber);
+		ABL_Fatal(0, err);
+	}
+	uint8_t* bytes = buffer->data + buffer->size;
+	buffer->size += numBytes;
+	return (bytes);
+}
+
+//---------------------------------------------------------------------------
+
+void
+recordDeferredArray(Address data, int32_t size)
+{
+	//-----------------------------------------------------------------
+	// Keep every record StackItem aligned, so round the copy up and let
+	// the replay skip the padding...
+	int32_t paddedSize = (size + sizeof(StackItem) - 1) & ~(int32_t)(sizeof(StackItem) - 1);
+	StackItem* arg = (StackItem*)reserveDeferredBytes(sizeof(StackItem) + paddedSize);
+	arg->integer = paddedSize;
+	memcpy(arg + 1, data, size);
+}
+
+//---------------------------------------------------------------------------
+
+void
+recordDeferredCall(int32_t key, bool skipOrder, int32_t orderCall)
+{
+	//-------------------------------------------------------------------
+	// Evaluate the actual params exactly as the ABLi_pop routines would,
+	// but keep copies of the values (and of any arrays, since the locals
+	// they live in are gone by the time the call is applied)...
+	ABLCommandBuffer* buffer = CurContext->commandBuffer;
+	int32_t start = buffer->size;
+	reserveDeferredBytes(sizeof(ABLDeferredCall));
+	int32_t numParams = FunctionInfoTable[key].numParams;
+	for (size_t i = 0; i < numParams; i++)
+	{
+		getCodeToken();
+		switch (FunctionInfoTable[key].params[i])
+		{
+		case PARAM_TYPE_INTEGER_ARRAY:
+		case PARAM_TYPE_REAL_ARRAY:
+		{
+			const std::unique_ptr<SymTableNode>& idPtr = getCodeSymTableNodePtr();
+			const std::unique_ptr<Type>& paramTypePtr = execVariable(idPtr, USE_REFPARAM);
+			recordDeferredArray(CurContext->tos->address, paramTypePtr->size);
+		}
+		break;
+		case PARAM_TYPE_CHAR_ARRAY:
+		case PARAM_TYPE_BOOLEAN_ARRAY:
+		{
+			const std::unique_ptr<Type>& paramTypePtr = execExpression();
+			recordDeferredArray(CurContext->tos->address, paramTypePtr->size);
+		}
+		break;
+		case PARAM_TYPE_ANYTHING:
+		{
+			const std::unique_ptr<Type>& paramTypePtr = execExpression();
+			int32_t type = getAnythingType(paramTypePtr);
+			StackItem* arg = (StackItem*)reserveDeferredBytes(sizeof(StackItem));
+			arg->integer = type;
+			if (type >= ABL_STACKITEM_CHAR_PTR)
+				recordDeferredArray(CurContext->tos->address, paramTypePtr->size);
+			else if (type != -1)
+				*((StackItem*)reserveDeferredBytes(sizeof(StackItem))) = *CurContext->tos;
+		}
+		break;
+		case PARAM_TYPE_INTEGER_REAL:
+		{
+			const std::unique_ptr<Type>& paramTypePtr = execExpression();
+			StackItem* arg = (StackItem*)reserveDeferredBytes(sizeof(StackItem));
+			if (paramTypePtr == IntegerTypePtr)
+				arg->real = (float)CurContext->tos->integer;
+			else
+				arg->real = CurContext->tos->real;
+		}
+		break;
+		default:
+		{
+			execExpression();
+			StackItem* arg = (StackItem*)reserveDeferredBytes(sizeof(StackItem));
+			*arg = *CurContext->tos;
+		}
+		break;
+		}
+		pop();
+	}
+	ABLDeferredCall* call = (ABLDeferredCall*)(buffer->data + start);
+	call->key = (int16_t)key;
+	call->skipOrder = skipOrder ? 1 : 0;
+	call->numArgs = (uint8_t)numParams;
+	call->size = buffer->size - start;
+	call->orderCall = orderCall;
+	call->module = CurContext->module;
+	buffer->numCalls++;
+	//--------------------------------------------------------------
+	// The script carries on with the provisional result. The real one
+	// is thrown away when the call is replayed...
+	switch (FunctionInfoTable[key].returnType)
+	{
+	case RETURN_TYPE_INTEGER:
+		ABLi_pushInteger(FunctionInfoTable[key].deferredResult);
+		break;
+	case RETURN_TYPE_REAL:
+		ABLi_pushReal((float)FunctionInfoTable[key].deferredResult);
+		break;
+	case RETURN_TYPE_BOOLEAN:
+		ABLi_pushBoolean(FunctionInfoTable[key].deferredResult != 0);
+		break;
+	}
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+applyDeferredCalls(ABLCommandBuffer* buffer)
+{
+	//------------------------------------------------------------------
+	// Runs on the main context, in the order the calls were queued. The
+	// callbacks see their captured args through the pop/peek routines,
+	// and get one scratch slot to poke a result into...
+	StackItem* saveTos = CurContext->tos;
+	bool saveSkipOrder = CurContext->skipOrder;
+	uint8_t* callPtr = buffer->data;
+	uint8_t* endPtr = buffer->data + buffer->size;
+	while (callPtr < endPtr)
+	{
+		ABLDeferredCall* call = (ABLDeferredCall*)callPtr;
+		CurContext->tos = getRuntimeStackBase();
+		pushInteger(0);
+		CurContext->skipOrder = (call->skipOrder != 0);
+		CurContext->replayArg = callPtr + sizeof(ABLDeferredCall);
+		(*FunctionCallbackTable[call->key])();
+		//--------------------------------------------------------------
+		// The script saw the provisional result and stopped at this
+		// order. If it's done now, the next tick will move past it...
+		if ((call->orderCall > -1) && (CurContext->tos->integer != 0))
+			call->module->setOrderCallFlag((uint8_t)(call->orderCall / 32), (uint8_t)(call->orderCall % 32));
+		callPtr += call->size;
+	}
+	CurContext->replayArg = nullptr;
+	CurContext->skipOrder = saveSkipOrder;
+	CurContext->tos = saveTos;
+	int32_t numCalls = buffer->numCalls;
+	buffer->size = 0;
+	buffer->numCalls = 0;
+	return (numCalls);
+}
+
 //***************************************************************************
 
 } // namespace mclib::abl
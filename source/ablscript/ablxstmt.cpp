@@ -23,46 +23,26 @@ namespace mclib::abl {
 //----------
 // EXTERNALS
 
-extern int32_t level;
-extern int32_t CallStackLevel;
-extern int32_t execLineNumber;
-extern int32_t execStatementCount;
-extern const std::wstring_view& codeSegmentPtr;
-extern const std::wstring_view& statementStartPtr;
-extern TokenCodeType codeToken;
 extern int32_t NumExecutions;
 
 extern StackItem* stack;
-extern const std::unique_ptr<StackItem>& tos;
-extern const std::unique_ptr<StackItem>& stackFrameBasePtr;
-extern const std::unique_ptr<SymTableNode>& CurRoutineIdPtr;
 
 extern const std::unique_ptr<Type>& IntegerTypePtr;
 extern const std::unique_ptr<Type>& CharTypePtr;
 extern const std::unique_ptr<Type>& RealTypePtr;
 extern const std::unique_ptr<Type>& BooleanTypePtr;
 
-extern bool ExitWithReturn;
-extern bool ExitFromTacOrder;
 extern bool AutoReturnFromOrders;
 
 extern int32_t MaxLoopIterations;
 
 extern const std::unique_ptr<Debugger>& debugger;
-extern const std::unique_ptr<ABLModule>& CurModule;
-extern const std::unique_ptr<ABLModule>& CurFSM;
 extern const std::unique_ptr<SymTableNode>& CurModuleIdPtr;
-extern int32_t CurModuleHandle;
-extern bool CallModuleInit;
-extern const std::unique_ptr<StackItem>& StaticDataPtr;
-uint32_t* OrderCompletionFlags = nullptr;
 extern const std::unique_ptr<ModuleEntry>& ModuleRegistry;
 extern const std::unique_ptr<ABLModule>&* ModuleInstanceRegistry;
-extern const std::unique_ptr<ABLModule>& CurModule;
 extern const std::unique_ptr<ABLModule>& CurLibrary;
 extern int32_t ProfileLogFunctionTimeLimit;
 extern ABLFile* ProfileLog;
-extern bool NewStateSet;
 
 int32_t dummyCount = 0;
 
@@ -80,16 +60,18 @@ transState(const std::unique_ptr<SymTableNode>& newState);
 void
 execStatement(void)
 {
-	if (codeToken == TKN_STATEMENT_MARKER)
+	if (CurContext->codeToken == TKN_STATEMENT_MARKER)
 	{
-		execLineNumber = getCodeStatementMarker();
-		execStatementCount++;
-		statementStartPtr = codeSegmentPtr;
+		CurContext->execLineNumber = getCodeStatementMarker();
+		CurContext->execStatementCount++;
+		CurContext->statementStartPtr = CurContext->codeSegmentPtr;
+		if (ProfilerEnabled && (--CurContext->profileCountdown <= 0))
+			profileSample();
 		if (debugger)
 			debugger->traceStatementExecution();
 		getCodeToken();
 	}
-	switch (codeToken)
+	switch (CurContext->codeToken)
 	{
 	case TKN_IDENTIFIER:
 	{
@@ -100,13 +82,19 @@ execStatement(void)
 			bool skipOrder = false;
 			uint8_t orderDWord = 0;
 			uint8_t orderBitMask = 0;
-			if ((idPtr->defn.info.routine.flags & ROUTINE_FLAG_ORDER) && CurModule->getOrderCallFlags())
+			if ((idPtr->defn.info.routine.flags & ROUTINE_FLAG_ORDER) && CurContext->module->getOrderCallFlags())
 			{
 				orderDWord = getCodeByte();
 				orderBitMask = getCodeByte();
-				skipOrder = !CurModule->isLibrary() && CurModule->getOrderCallFlag(orderDWord, orderBitMask);
+				skipOrder = !CurContext->module->isLibrary() && CurContext->module->getOrderCallFlag(orderDWord, orderBitMask);
+				//--------------------------------------------------------------
+				// A deferred order call can't report back until it's replayed,
+				// so let it know which flag to set if it completes then...
+				if (AutoReturnFromOrders && !CurContext->module->isLibrary() && (idPtr->defn.info.routine.key != RTN_DECLARED))
+					CurContext->orderCall = orderDWord * 32 + orderBitMask;
 			}
 			const std::unique_ptr<Type>& returnType = execRoutineCall(idPtr, skipOrder);
+			CurContext->orderCall = -1;
 			if (idPtr->defn.info.routine.flags & ROUTINE_FLAG_ORDER)
 			{
 				if (AutoReturnFromOrders)
@@ -114,13 +102,13 @@ execStatement(void)
 					//-----------------------------------------------------------------
 					// We called an Order function, and we're in an Orders/State
 					// block, so do we continue the flow of orders or stop here?
-					int32_t returnVal = tos->integer;
+					int32_t returnVal = CurContext->tos->integer;
 					pop();
 					if (returnVal == 0)
 						execOrderReturn(returnVal);
-					else if (CurModule->getOrderCallFlags())
+					else if (CurContext->module->getOrderCallFlags())
 					{
-						CurModule->setOrderCallFlag(orderDWord, orderBitMask);
+						CurContext->module->setOrderCallFlag(orderDWord, orderBitMask);
 					}
 				}
 			}
@@ -139,21 +127,21 @@ execStatement(void)
 	case TKN_CODE:
 	{
 		bool wasAutoReturnFromOrders = AutoReturnFromOrders;
-		AutoReturnFromOrders = ((CurRoutineIdPtr->defn.info.routine.flags & (ROUTINE_FLAG_ORDER + ROUTINE_FLAG_STATE)) != 0);
+		AutoReturnFromOrders = ((CurContext->routineIdPtr->defn.info.routine.flags & (ROUTINE_FLAG_ORDER + ROUTINE_FLAG_STATE)) != 0);
 		getCodeToken();
 		TokenCodeType endToken = TKN_END_FUNCTION;
-		if (CurRoutineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_ORDER)
+		if (CurContext->routineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_ORDER)
 			endToken = TKN_END_ORDER;
-		else if (CurRoutineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_STATE)
+		else if (CurContext->routineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_STATE)
 			endToken = TKN_END_STATE;
 		TokenCodeType endTokenFinal = TKN_END_MODULE;
 		if (CurLibrary)
 			endTokenFinal = TKN_END_LIBRARY;
-		else if (CurRoutineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_FSM)
+		else if (CurContext->routineIdPtr->defn.info.routine.flags & ROUTINE_FLAG_FSM)
 			endTokenFinal = TKN_END_FSM;
-		while ((codeToken != endToken) && (codeToken != endTokenFinal) && !NewStateSet)
+		while ((CurContext->codeToken != endToken) && (CurContext->codeToken != endTokenFinal) && !CurContext->newStateSet)
 			execStatement();
-		if (NewStateSet)
+		if (CurContext->newStateSet)
 			return;
 		getCodeToken();
 		AutoReturnFromOrders = wasAutoReturnFromOrders;
@@ -188,7 +176,7 @@ execStatement(void)
 		// runtimeError(ABL_ERR_RUNTIME_UNIMPLEMENTED_FEATURE);
 		NODEFAULT;
 	}
-	while (codeToken == TKN_SEMICOLON)
+	while (CurContext->codeToken == TKN_SEMICOLON)
 		getCodeToken();
 }
 
@@ -203,7 +191,7 @@ execAssignmentStatement(const std::unique_ptr<SymTableNode>& idPtr)
 	//--------------------------
 	// Assignment to variable...
 	targetTypePtr = execVariable(idPtr, USE_TARGET);
-	targetPtr = (const std::unique_ptr<StackItem>&)tos->address;
+	targetPtr = (const std::unique_ptr<StackItem>&)CurContext->tos->address;
 	//------------------------------
 	// Pop off the target address...
 	pop();
@@ -222,14 +210,14 @@ execAssignmentStatement(const std::unique_ptr<SymTableNode>& idPtr)
 	{
 		//-------------------------
 		// integer assigned to real
-		targetPtr->real = (float)(tos->integer);
+		targetPtr->real = (float)(CurContext->tos->integer);
 	}
 	else if (targetTypePtr->form == FRM_ARRAY)
 	{
 		//-------------------------
 		// Copy the array/record...
 		const std::wstring_view& dest = (const std::wstring_view&)targetPtr;
-		const std::wstring_view& src = tos->address;
+		const std::wstring_view& src = CurContext->tos->address;
 		int32_t size = targetTypePtr->size;
 		memcpy(dest, src, size);
 	}
@@ -237,15 +225,15 @@ execAssignmentStatement(const std::unique_ptr<SymTableNode>& idPtr)
 	{
 		//------------------------------------------------------
 		// Range check assignment to integer or enum subrange...
-		targetPtr->integer = tos->integer;
+		targetPtr->integer = CurContext->tos->integer;
 	}
 	else if (targetTypePtr == CharTypePtr)
-		targetPtr->byte = tos->byte;
+		targetPtr->byte = CurContext->tos->byte;
 	else
 	{
 		//-----------------------
 		// Assign real to real...
-		targetPtr->real = tos->real;
+		targetPtr->real = CurContext->tos->real;
 	}
 	//-----------------------------
 	// Grab the expression value...
@@ -272,28 +260,28 @@ execDeclaredRoutineCall(const std::unique_ptr<SymTableNode>& routineIdPtr, bool
 {
 	if (skipOrder)
 	{
-		const std::unique_ptr<StackItem>& curStackFrameBase = tos;
+		const std::unique_ptr<StackItem>& curStackFrameBase = CurContext->tos;
 		//----------------------------------------
 		// Push parameter values onto the stack...
 		getCodeToken();
-		if (codeToken == TKN_LPAREN)
+		if (CurContext->codeToken == TKN_LPAREN)
 		{
 			execActualParams(routineIdPtr);
 			getCodeToken();
 		}
 		getCodeToken();
-		tos = curStackFrameBase;
+		CurContext->tos = curStackFrameBase;
 		pushInteger(1);
 		return ((const std::unique_ptr<Type>&)(routineIdPtr->ptype));
 	}
-	int32_t oldLevel = level; // level of caller
-	int32_t newLevel = routineIdPtr->level + 1; // level of callee
-	CallStackLevel++;
+	int32_t oldLevel = CurContext->level; // CurContext->level of caller
+	int32_t newLevel = routineIdPtr->level + 1; // CurContext->level of callee
+	CurContext->callStackLevel++;
 	//-------------------------------------------
 	// First, set up the stack frame of callee...
-	const std::unique_ptr<StackItem>& newStackFrameBasePtr = tos + 1;
+	const std::unique_ptr<StackItem>& newStackFrameBasePtr = CurContext->tos + 1;
 	bool isLibraryCall =
-		(routineIdPtr->library && (routineIdPtr->library != CurRoutineIdPtr->library));
+		(routineIdPtr->library && (routineIdPtr->library != CurContext->routineIdPtr->library));
 	if (isLibraryCall)
 		pushStackFrameHeader(-1, -1);
 	else
@@ -301,31 +289,31 @@ execDeclaredRoutineCall(const std::unique_ptr<SymTableNode>& routineIdPtr, bool
 	//----------------------------------------
 	// Push parameter values onto the stack...
 	getCodeToken();
-	if (codeToken == TKN_LPAREN)
+	if (CurContext->codeToken == TKN_LPAREN)
 	{
 		execActualParams(routineIdPtr);
 		getCodeToken();
 	}
 	//-------------------------------------------------
 	// Set the return address in the new stack frame...
-	level = newLevel;
-	stackFrameBasePtr = newStackFrameBasePtr;
-	const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)stackFrameBasePtr;
-	headerPtr->returnAddress.address = codeSegmentPtr - 1;
+	CurContext->level = newLevel;
+	CurContext->stackFrameBasePtr = newStackFrameBasePtr;
+	const std::unique_ptr<StackFrameHeader>& headerPtr = (const std::unique_ptr<StackFrameHeader>&)CurContext->stackFrameBasePtr;
+	headerPtr->returnAddress.address = CurContext->codeSegmentPtr - 1;
 	//---------------------------------------------------------
 	// If we're calling a library function, we need to set some
 	// module-specific info...
 	const std::unique_ptr<ABLModule>& PrevModule = nullptr;
 	if (isLibraryCall)
 	{
-		PrevModule = CurModule;
-		CurModule = routineIdPtr->library;
-		CurModuleHandle = CurModule->getHandle();
+		PrevModule = CurContext->module;
+		CurContext->module = routineIdPtr->library;
+		CurContext->moduleHandle = CurContext->module->getHandle();
 		if (debugger)
-			debugger->setModule(CurModule);
-		StaticDataPtr = CurModule->getStaticData();
-		CallModuleInit = !CurModule->getInitCalled();
-		CurModule->setInitCalled(true);
+			debugger->setModule(CurContext->module);
+		CurContext->staticDataPtr = CurContext->module->getStaticData();
+		CurContext->callModuleInit = !CurContext->module->getInitCalled();
+		CurContext->module->setInitCalled(true);
 		//	routineEntry(ModuleRegistry[CurModule->getHandle()].moduleIdPtr);
 	}
 	if (ProfileLog)
@@ -337,7 +325,7 @@ execDeclaredRoutineCall(const std::unique_ptr<SymTableNode>& routineIdPtr, bool
 		{
 			wchar_t s[512];
 			sprintf_s(s, _countof(s), "[%08d] ", NumExecutions);
-			for (size_t i = 0; i < CallStackLevel; i++)
+			for (size_t i = 0; i < CurContext->callStackLevel; i++)
 				strcat(s, " ");
 			wchar_t s1[512];
 			sprintf_s(s1, _countof(s1), "%s (%d)\n", routineIdPtr->name, functionExecTime);
@@ -353,18 +341,18 @@ execDeclaredRoutineCall(const std::unique_ptr<SymTableNode>& routineIdPtr, bool
 	if (isLibraryCall)
 	{
 		//	routineExit(ModuleRegistry[CurModule->getHandle()].moduleIdPtr);
-		CurModule = PrevModule;
-		CurModuleHandle = CurModule->getHandle();
+		CurContext->module = PrevModule;
+		CurContext->moduleHandle = CurContext->module->getHandle();
 		if (debugger)
-			debugger->setModule(CurModule);
-		StaticDataPtr = CurModule->getStaticData();
+			debugger->setModule(CurContext->module);
+		CurContext->staticDataPtr = CurContext->module->getStaticData();
 	}
 	//-------------------------------------------------------
 	// Return from the callee, and grab the first token after
 	// the return...
-	level = oldLevel;
+	CurContext->level = oldLevel;
 	getCodeToken();
-	CallStackLevel--;
+	CurContext->callStackLevel--;
 	return ((const std::unique_ptr<Type>&)(routineIdPtr->ptype));
 }
 
@@ -401,7 +389,7 @@ execActualParams(const std::unique_ptr<SymTableNode>& routineIdPtr)
 			{
 				//---------------------------------------------
 				// Real formal parameter, but integer actual...
-				tos->real = (float)(tos->integer);
+				CurContext->tos->real = (float)(CurContext->tos->integer);
 			}
 			//----------------------------------------------------------
 			// Formal parameter is an array or record, so make a copy...
@@ -411,20 +399,20 @@ execActualParams(const std::unique_ptr<SymTableNode>& routineIdPtr)
 				// The following is a little inefficient, but is kept this way
 				// to keep it clear. Once it's verified to work, optimize...
 				int32_t size = formalTypePtr->size;
-				const std::wstring_view& src = tos->address;
-				const std::wstring_view& dest = (const std::wstring_view&)ABLStackMallocCallback((size_t)size);
+				const std::wstring_view& src = CurContext->tos->address;
+				const std::wstring_view& dest = (const std::wstring_view&)runtimeMalloc((size_t)size);
 				if (!dest)
 				{
 					wchar_t err[255];
 					sprintf(err,
 						" ABL: Unable to AblStackHeap->malloc actual array "
 						"param in module %s)",
-						CurModule->getName());
+						CurContext->module->getName());
 					ABL_Fatal(0, err);
 				}
 				const std::wstring_view& savePtr = dest;
 				memcpy(dest, src, size);
-				tos->address = savePtr;
+				CurContext->tos->address = savePtr;
 			}
 		}
 		else
@@ -448,13 +436,13 @@ execSwitchStatement(void)
 	const std::unique_ptr<Type>& switchExpressionTypePtr = execExpression();
 	int32_t switchExpressionValue;
 	if ((switchExpressionTypePtr == IntegerTypePtr) || (switchExpressionTypePtr->form == FRM_ENUM))
-		switchExpressionValue = tos->integer;
+		switchExpressionValue = CurContext->tos->integer;
 	else
-		switchExpressionValue = tos->byte;
+		switchExpressionValue = CurContext->tos->byte;
 	pop();
 	//---------------------------------------------------------
 	// Now, search the branch table for the expression value...
-	codeSegmentPtr = branchTableLocation;
+	CurContext->codeSegmentPtr = branchTableLocation;
 	getCodeToken();
 	int32_t caseLabelCount = getCodeInteger();
 	bool done = false;
@@ -469,20 +457,20 @@ execSwitchStatement(void)
 	// If found, go to the aprropriate branch code...
 	if (caseLabelCount >= 0)
 	{
-		codeSegmentPtr = caseBranchLocation;
+		CurContext->codeSegmentPtr = caseBranchLocation;
 		getCodeToken();
-		if (codeToken != TKN_END_CASE)
+		if (CurContext->codeToken != TKN_END_CASE)
 			do
 			{
 				execStatement();
-				if (ExitWithReturn)
+				if (CurContext->exitWithReturn)
 					return;
-			} while (codeToken != TKN_END_CASE);
+			} while (CurContext->codeToken != TKN_END_CASE);
 		//----------------------------------
 		// Grab the end case and semi-colon...
 		getCodeToken();
 		getCodeToken();
-		codeSegmentPtr = getCodeAddressMarker();
+		CurContext->codeSegmentPtr = getCodeAddressMarker();
 		getCodeToken();
 	}
 	else
@@ -511,7 +499,7 @@ execForStatement(void)
 	getCodeToken();
 	const std::unique_ptr<SymTableNode>& controlIdPtr = getCodeSymTableNodePtr();
 	const std::unique_ptr<Type>& controlTypePtr = execVariable(controlIdPtr, USE_TARGET);
-	const std::unique_ptr<StackItem>& targetPtr = (const std::unique_ptr<StackItem>&)tos->address;
+	const std::unique_ptr<StackItem>& targetPtr = (const std::unique_ptr<StackItem>&)CurContext->tos->address;
 	//------------------------------------
 	// Control variable address...
 	pop();
@@ -521,14 +509,14 @@ execForStatement(void)
 	execExpression();
 	int32_t initialValue;
 	if (controlTypePtr == IntegerTypePtr)
-		initialValue = tos->integer;
+		initialValue = CurContext->tos->integer;
 	else
-		initialValue = tos->byte;
+		initialValue = CurContext->tos->byte;
 	//---------------------
 	// The initial value...
 	pop();
 	int32_t deltaValue;
-	if (codeToken == TKN_TO)
+	if (CurContext->codeToken == TKN_TO)
 		deltaValue = 1;
 	else
 		deltaValue = -1;
@@ -538,15 +526,15 @@ execForStatement(void)
 	execExpression();
 	int32_t finalValue;
 	if (controlTypePtr == IntegerTypePtr)
-		finalValue = tos->integer;
+		finalValue = CurContext->tos->integer;
 	else
-		finalValue = tos->byte;
+		finalValue = CurContext->tos->byte;
 	//-------------------
 	// The final value...
 	pop();
 	//----------------------------
 	// Address of start of loop...
-	const std::wstring_view& loopStartLocation = codeSegmentPtr;
+	const std::wstring_view& loopStartLocation = CurContext->codeSegmentPtr;
 	int32_t controlValue = initialValue;
 	//-----------------------------
 	// Now, execute the FOR loop...
@@ -559,19 +547,19 @@ execForStatement(void)
 			else
 				targetPtr->byte = (uint8_t)controlValue;
 			getCodeToken();
-			if (codeToken != TKN_END_FOR)
+			if (CurContext->codeToken != TKN_END_FOR)
 				do
 				{
 					execStatement();
-					if (ExitWithReturn)
+					if (CurContext->exitWithReturn)
 						return;
-				} while (codeToken != TKN_END_FOR);
+				} while (CurContext->codeToken != TKN_END_FOR);
 			//---------------------------
 			// Check for infinite loop...
 			if (++iterations == MaxLoopIterations)
 				runtimeError(ABL_ERR_RUNTIME_INFINITE_LOOP);
 			controlValue++;
-			codeSegmentPtr = loopStartLocation;
+			CurContext->codeSegmentPtr = loopStartLocation;
 		}
 	else
 		while (controlValue >= finalValue)
@@ -581,21 +569,21 @@ execForStatement(void)
 			else
 				targetPtr->byte = (uint8_t)controlValue;
 			getCodeToken();
-			if (codeToken != TKN_END_FOR)
+			if (CurContext->codeToken != TKN_END_FOR)
 				do
 				{
 					execStatement();
-					if (ExitWithReturn)
+					if (CurContext->exitWithReturn)
 						return;
-				} while (codeToken != TKN_END_FOR);
+				} while (CurContext->codeToken != TKN_END_FOR);
 			//---------------------------
 			// Check for infinite loop...
 			if (++iterations == MaxLoopIterations)
 				runtimeError(ABL_ERR_RUNTIME_INFINITE_LOOP);
 			controlValue--;
-			codeSegmentPtr = loopStartLocation;
+			CurContext->codeSegmentPtr = loopStartLocation;
 		}
-	codeSegmentPtr = loopEndLocation;
+	CurContext->codeSegmentPtr = loopEndLocation;
 	getCodeToken();
 }
 
@@ -616,7 +604,7 @@ execTransStatement(void)
 void
 execTransBackStatement(void)
 {
-	const std::unique_ptr<SymTableNode>& prevState = CurModule->getPrevState();
+	const std::unique_ptr<SymTableNode>& prevState = CurContext->module->getPrevState();
 	if (!prevState)
 		runtimeError(ABL_ERR_RUNTIME_NULL_PREVSTATE);
 	transState(prevState);
@@ -637,24 +625,24 @@ execIfStatement(void)
 	// want to change this?
 	getCodeToken();
 	execExpression();
-	bool test = (tos->integer == 1);
+	bool test = (CurContext->tos->integer == 1);
 	pop();
 	if (test)
 	{
 		//---------------------------
 		// execute the TRUE branch...
 		getCodeToken();
-		if ((codeToken != TKN_END_IF) && (codeToken != TKN_ELSE))
+		if ((CurContext->codeToken != TKN_END_IF) && (CurContext->codeToken != TKN_ELSE))
 			do
 			{
 				execStatement();
-				if (ExitWithReturn)
+				if (CurContext->exitWithReturn)
 					return;
-			} while ((codeToken != TKN_END_IF) && (codeToken != TKN_ELSE));
-		if (codeToken == TKN_ELSE)
+			} while ((CurContext->codeToken != TKN_END_IF) && (CurContext->codeToken != TKN_ELSE));
+		if (CurContext->codeToken == TKN_ELSE)
 		{
 			getCodeToken();
-			codeSegmentPtr = getCodeAddressMarker();
+			CurContext->codeSegmentPtr = getCodeAddressMarker();
 			getCodeToken();
 		}
 	}
@@ -662,20 +650,20 @@ execIfStatement(void)
 	{
 		//----------------------------
 		// Execute the FALSE branch...
-		codeSegmentPtr = falseLocation;
+		CurContext->codeSegmentPtr = falseLocation;
 		getCodeToken();
-		if (codeToken == TKN_ELSE)
+		if (CurContext->codeToken == TKN_ELSE)
 		{
 			getCodeToken();
 			getCodeAddressMarker();
 			getCodeToken();
-			if (codeToken != TKN_END_IF)
+			if (CurContext->codeToken != TKN_END_IF)
 				do
 				{
 					execStatement();
-					if (ExitWithReturn)
+					if (CurContext->exitWithReturn)
 						return;
-				} while (codeToken != TKN_END_IF);
+				} while (CurContext->codeToken != TKN_END_IF);
 		}
 	}
 	getCodeToken();
@@ -686,18 +674,18 @@ execIfStatement(void)
 void
 execRepeatStatement(void)
 {
-	const std::wstring_view& loopStartLocation = codeSegmentPtr;
+	const std::wstring_view& loopStartLocation = CurContext->codeSegmentPtr;
 	int32_t iterations = 0;
 	do
 	{
 		getCodeToken();
-		if (codeToken != TKN_UNTIL)
+		if (CurContext->codeToken != TKN_UNTIL)
 			do
 			{
 				execStatement();
-				if (ExitWithReturn)
+				if (CurContext->exitWithReturn)
 					return;
-			} while (codeToken != TKN_UNTIL);
+			} while (CurContext->codeToken != TKN_UNTIL);
 		//---------------------------
 		// Check for infinite loop...
 		iterations++;
@@ -707,12 +695,12 @@ execRepeatStatement(void)
 		// Eval the boolean expression...
 		getCodeToken();
 		execExpression();
-		if (tos->integer == 0)
-			codeSegmentPtr = loopStartLocation;
+		if (CurContext->tos->integer == 0)
+			CurContext->codeSegmentPtr = loopStartLocation;
 		//--------------------------
 		// Grab the boolean value...
 		pop();
-	} while (codeSegmentPtr == loopStartLocation);
+	} while (CurContext->codeSegmentPtr == loopStartLocation);
 }
 
 //***************************************************************************
@@ -722,7 +710,7 @@ execWhileStatement(void)
 {
 	getCodeToken();
 	const std::wstring_view& loopEndLocation = getCodeAddressMarker();
-	const std::wstring_view& testLocation = codeSegmentPtr;
+	const std::wstring_view& testLocation = CurContext->codeSegmentPtr;
 	bool loopDone = false;
 	int32_t iterations = 0;
 	do
@@ -731,9 +719,9 @@ execWhileStatement(void)
 		// Eval the boolean expression...
 		getCodeToken();
 		execExpression();
-		if (tos->integer == 0)
+		if (CurContext->tos->integer == 0)
 		{
-			codeSegmentPtr = loopEndLocation;
+			CurContext->codeSegmentPtr = loopEndLocation;
 			loopDone = true;
 		}
 		//-------------------------
@@ -744,14 +732,14 @@ execWhileStatement(void)
 		if (!loopDone)
 		{
 			getCodeToken();
-			if (codeToken != TKN_END_WHILE)
+			if (CurContext->codeToken != TKN_END_WHILE)
 				do
 				{
 					execStatement();
-					if (ExitWithReturn)
+					if (CurContext->exitWithReturn)
 						return;
-				} while (codeToken != TKN_END_WHILE);
-			codeSegmentPtr = testLocation;
+				} while (CurContext->codeToken != TKN_END_WHILE);
+			CurContext->codeSegmentPtr = testLocation;
 			//---------------------------
 			// Check for infinite loop...
 			iterations++;
@@ -33,7 +33,7 @@ Appearance::operator new(size_t mySize)
 	PVOID result = nullptr;
 	if (AppearanceTypeList::appearanceHeap && AppearanceTypeList::appearanceHeap->heapReady())
 	{
-		result = AppearanceTypeList::appearanceHeap->Malloc(mySize);
+		result = AppearanceTypeList::appearanceHeap->Malloc(mySize, HEAP_CALLER());
 	}
 	return (result);
 }
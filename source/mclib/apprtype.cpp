@@ -35,7 +35,7 @@ AppearanceType::operator new(size_t memSize)
 	PVOID result = nullptr;
 	if (AppearanceTypeList::appearanceHeap && AppearanceTypeList::appearanceHeap->heapReady())
 	{
-		result = AppearanceTypeList::appearanceHeap->Malloc(memSize);
+		result = AppearanceTypeList::appearanceHeap->Malloc(memSize, HEAP_CALLER());
 	}
 	return (result);
 }
@@ -44,7 +44,7 @@ int32_t MasterComponent::innerSphereAntiMissileSystemID = 106;
 PVOID
 MasterComponent::operator new(size_t mySize)
 {
-	PVOID result = systemHeap->Malloc(mySize);
+	PVOID result = systemHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
@@ -40,12 +40,70 @@
 
 #undef isspace // Macro Chokes under Intel Compiler!!
 
+bool CSVFileUseCells = true;
+wchar_t CSVCachePath[80] = {0};
+CSVFileStats CSVFileStatistics = {0, 0, 0, 0, 0};
+
+//---------------------------------------------------------------------------
+// FNV-1a over the whole file.  Only says whether a sidecar is stale.
+static uint32_t
+CSVHash(const char* text, size_t length)
+{
+	uint32_t hash = 2166136261U;
+	for (size_t i = 0; i < length; i++)
+		hash = (hash ^ (uint8_t)text[i]) * 16777619U;
+	return (hash);
+}
+
+//---------------------------------------------------------------------------
+// The word getNextWord would copy out of text[start, end).
+static int16_t
+CSVFindWord(const char* text, uint32_t start, uint32_t end, CSVCell& cell)
+{
+	if ((start == end) || (text[start] == '/') || (text[start] == ','))
+		return (-1);
+	while ((start < end) && ((text[start] == ' ') || (text[start] == '\t') || (text[start] == ',')))
+		start++;
+	if ((start == end) || (text[start] == '/'))
+		return (-1);
+	uint32_t wordEnd = start;
+	while ((wordEnd < end) && (text[wordEnd] != ','))
+		wordEnd++;
+	if ((wordEnd - start) > 2047)
+		return (-2);
+	cell.offset = start;
+	cell.length = (uint16_t)(wordEnd - start);
+	return (NO_ERROR);
+}
+
+//---------------------------------------------------------------------------
+static bool
+CSVCacheRead(const uint8_t*& data, const uint8_t* dataEnd, void* dest, size_t size)
+{
+	if ((size_t)(dataEnd - data) < size)
+		return false;
+	memcpy(dest, data, size);
+	data += size;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+static void
+CSVCacheWrite(std::vector<uint8_t>& image, const void* src, size_t size)
+{
+	const uint8_t* bytes = (const uint8_t*)src;
+	image.insert(image.end(), bytes, bytes + size);
+}
+
 //---------------------------------------------------------------------------
 // class CSVIniFile
 CSVFile::CSVFile(void) :
 	MechFile()
 {
 	totalRows = totalCols = 0L;
+	m_numCellCols = 0;
+	m_textHash = 0;
+	m_cacheDirty = false;
 }
 
 //---------------------------------------------------------------------------
@@ -158,13 +216,267 @@ CSVFile::afterOpen(void)
 	else
 	{
 		//------------------------------------------------------
-		// Find out how many Rows and cols we have
-		totalRows = countRows();
-		totalCols = countCols();
+		// Find out how many Rows and cols we have.  A sidecar
+		// that matches the text already knows, and has the
+		// cells split out too.
+		clearCells();
+		if (!CSVFileUseCells || !readText() || !loadCache())
+		{
+			totalRows = countRows();
+			totalCols = countCols();
+			if (!m_text.empty())
+				buildCells();
+		}
 	}
 	return (NO_ERROR);
 }
 
+//---------------------------------------------------------------------------
+bool
+CSVFile::readText(void)
+{
+	size_t length = getLength();
+	if (!length || (length >= 0x7FFFFFFF))
+		return false;
+	size_t oldPosition = logicalPosition;
+	m_text.resize(length + 1);
+	seek(0);
+	size_t bytesRead = read((uint8_t*)m_text.data(), length);
+	seek(oldPosition);
+	if (bytesRead != length)
+	{
+		m_text.clear();
+		return false;
+	}
+	m_text[length] = '\0';
+	m_textHash = CSVHash(m_text.data(), length);
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Splits the text into rows and cells the way seekRowCol would find them,
+// so it never has to read a line again.
+void
+CSVFile::buildCells(void)
+{
+	const char* text = m_text.data();
+	uint32_t length = (uint32_t)(m_text.size() - 1);
+	m_numCellCols = totalCols ? totalCols : 1;
+	CSVCell noCell = {0, 0, -1};
+	m_rowOffsets.assign(totalRows, length);
+	m_cells.assign((size_t)totalRows * m_numCellCols, noCell);
+	m_columns.clear();
+	m_columns.resize(m_numCellCols);
+	uint32_t lineStart = 0;
+	for (uint32_t row = 0; (row < totalRows) && (lineStart < length); row++)
+	{
+		//-------------------------------------------------------
+		// The same steps readLine takes.  A line stops at a '\r'
+		// or after 2047 bytes, the byte after it is used up
+		// either way, and so is a '\n' after that.
+		uint32_t lineEnd = lineStart;
+		while (((lineEnd - lineStart) < 2047) && (lineEnd < length) && (text[lineEnd] != '\r'))
+			lineEnd++;
+		uint32_t nextLine = lineEnd + 1;
+		if ((nextLine < length) && (text[nextLine] == '\n'))
+			nextLine++;
+		m_rowOffsets[row] = lineStart;
+		//-------------------------------------------------------
+		// A nullptr in the line ends it as far as strstr knows.
+		for (uint32_t i = lineStart; i < lineEnd; i++)
+		{
+			if (text[i] == '\0')
+			{
+				lineEnd = i;
+				break;
+			}
+		}
+		uint32_t cellStart = lineStart;
+		for (uint32_t col = 0; col < m_numCellCols; col++)
+		{
+			if (col)
+			{
+				while ((cellStart < lineEnd) && (text[cellStart] != ','))
+					cellStart++;
+				if (cellStart == lineEnd)
+					break; // no more commas, the rest stay empty
+				cellStart++;
+			}
+			CSVCell& cell = m_cells[(size_t)col * totalRows + row];
+			cell.result = CSVFindWord(text, cellStart, lineEnd, cell);
+		}
+		lineStart = nextLine;
+	}
+	m_cacheDirty = true;
+	CSVFileStatistics.numFilesSplit++;
+}
+
+//---------------------------------------------------------------------------
+void
+CSVFile::clearCells(void)
+{
+	m_text.clear();
+	m_rowOffsets.clear();
+	m_cells.clear();
+	m_columns.clear();
+	m_numCellCols = 0;
+	m_textHash = 0;
+	m_cacheDirty = false;
+}
+
+//---------------------------------------------------------------------------
+void
+CSVFile::getCacheName(wchar_t* cacheName)
+{
+	sprintf(cacheName, "%s%s.csc", CSVCachePath, getFilename());
+	for (wchar_t* c = cacheName + strlen(CSVCachePath); *c; c++)
+	{
+		if ((*c == '\\') || (*c == '/') || (*c == ':'))
+			*c = '_';
+	}
+}
+
+//---------------------------------------------------------------------------
+bool
+CSVFile::loadCache(void)
+{
+	if (!CSVCachePath[0] || getFilename().empty())
+		return false;
+	wchar_t cacheName[1024];
+	getCacheName(cacheName);
+	MechFile cacheFile;
+	if (cacheFile.open(cacheName) != NO_ERROR)
+		return false;
+	size_t cacheLength = cacheFile.getLength();
+	std::vector<uint8_t> image(cacheLength);
+	bool readOK = (cacheLength >= sizeof(CSVCacheHeader)) && (cacheFile.read(image.data(), cacheLength) == cacheLength);
+	cacheFile.close();
+	if (!readOK)
+		return false;
+	const uint8_t* data = image.data();
+	const uint8_t* dataEnd = data + cacheLength;
+	CSVCacheHeader header;
+	CSVCacheRead(data, dataEnd, &header, sizeof(header));
+	uint32_t length = (uint32_t)(m_text.size() - 1);
+	if ((header.id != CSV_CACHE_ID) || (header.version != CSV_CACHE_VERSION) || (header.sourceHash != m_textHash) ||
+		(header.sourceLength != length))
+		return false;
+	//---------------------------------------------------
+	// Anything that doesn't add up means a stale or bad
+	// sidecar.  Split the text instead and write it over.
+	uint32_t numCellCols = header.totalCols ? header.totalCols : 1;
+	size_t numCells = (size_t)header.totalRows * numCellCols;
+	m_rowOffsets.resize(header.totalRows);
+	m_cells.resize(numCells);
+	m_columns.resize(numCellCols);
+	bool cacheOK = CSVCacheRead(data, dataEnd, m_rowOffsets.data(), header.totalRows * sizeof(uint32_t)) &&
+		CSVCacheRead(data, dataEnd, m_cells.data(), numCells * sizeof(CSVCell));
+	for (size_t i = 0; cacheOK && (i < numCells); i++)
+	{
+		if ((m_cells[i].result == NO_ERROR) && ((m_cells[i].offset + m_cells[i].length) > length))
+			cacheOK = false;
+	}
+	for (size_t col = 0; cacheOK && (col < numCellCols); col++)
+	{
+		uint32_t converted = 0;
+		cacheOK = CSVCacheRead(data, dataEnd, &converted, sizeof(converted));
+		if (cacheOK && (converted & 1))
+		{
+			m_columns[col].floats.resize(header.totalRows);
+			cacheOK = CSVCacheRead(data, dataEnd, m_columns[col].floats.data(), header.totalRows * sizeof(float));
+		}
+		if (cacheOK && (converted & 2))
+		{
+			m_columns[col].longs.resize(header.totalRows);
+			cacheOK = CSVCacheRead(data, dataEnd, m_columns[col].longs.data(), header.totalRows * sizeof(int32_t));
+		}
+	}
+	if (!cacheOK)
+	{
+		m_rowOffsets.clear();
+		m_cells.clear();
+		m_columns.clear();
+		return false;
+	}
+	totalRows = header.totalRows;
+	totalCols = header.totalCols;
+	m_numCellCols = numCellCols;
+	m_cacheDirty = false;
+	CSVFileStatistics.numCacheHits++;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+void
+CSVFile::saveCache(void)
+{
+	if (!CSVCachePath[0] || getFilename().empty() || m_text.empty())
+		return;
+	CSVCacheHeader header;
+	header.id = CSV_CACHE_ID;
+	header.version = CSV_CACHE_VERSION;
+	header.sourceHash = m_textHash;
+	header.sourceLength = (uint32_t)(m_text.size() - 1);
+	header.totalRows = totalRows;
+	header.totalCols = totalCols;
+	std::vector<uint8_t> image;
+	CSVCacheWrite(image, &header, sizeof(header));
+	CSVCacheWrite(image, m_rowOffsets.data(), m_rowOffsets.size() * sizeof(uint32_t));
+	CSVCacheWrite(image, m_cells.data(), m_cells.size() * sizeof(CSVCell));
+	for (size_t col = 0; col < m_numCellCols; col++)
+	{
+		uint32_t converted = (m_columns[col].floats.empty() ? 0 : 1) | (m_columns[col].longs.empty() ? 0 : 2);
+		CSVCacheWrite(image, &converted, sizeof(converted));
+		CSVCacheWrite(image, m_columns[col].floats.data(), m_columns[col].floats.size() * sizeof(float));
+		CSVCacheWrite(image, m_columns[col].longs.data(), m_columns[col].longs.size() * sizeof(int32_t));
+	}
+	wchar_t cacheName[1024];
+	getCacheName(cacheName);
+	MechFile cacheFile;
+	if (cacheFile.create(cacheName) == NO_ERROR)
+	{
+		if (cacheFile.write(image.data(), image.size()) == image.size())
+			CSVFileStatistics.numCacheWrites++;
+		cacheFile.close();
+	}
+	m_cacheDirty = false;
+}
+
+//---------------------------------------------------------------------------
+// What seekRowCol would say about the cell, without copying it out.  The
+// converted columns hold 0 for an empty cell, so this is what tells an
+// empty cell from a 0.
+int32_t
+CSVFile::cellResult(uint32_t row, uint32_t col)
+{
+	return (m_cells[(size_t)(col ? col - 1 : 0) * totalRows + (row - 1)].result);
+}
+
+//---------------------------------------------------------------------------
+// Converts every row of a column the first time it is read as a number.
+CSVColumn*
+CSVFile::convertColumn(uint32_t col, bool floats)
+{
+	CSVColumn& column = m_columns[col ? col - 1 : 0];
+	if (floats ? !column.floats.empty() : !column.longs.empty())
+		return (&column);
+	if (floats)
+		column.floats.resize(totalRows);
+	else
+		column.longs.resize(totalRows);
+	for (uint32_t row = 1; row <= totalRows; row++)
+	{
+		bool found = (seekRowCol(row, col) == NO_ERROR);
+		if (floats)
+			column.floats[row - 1] = found ? textToFloat(dataBuffer) : 0.0f;
+		else
+			column.longs[row - 1] = found ? textToLong(dataBuffer) : 0;
+	}
+	m_cacheDirty = true;
+	CSVFileStatistics.numColumnsConverted++;
+	return (&column);
+}
+
 //---------------------------------------------------------------------------
 void
 CSVFile::atClose(void)
@@ -175,6 +487,9 @@ CSVFile::atClose(void)
 	{
 		STOP(("Cannot write CSV files at present."));
 	}
+	if (m_cacheDirty)
+		saveCache();
+	clearCells();
 	totalRows = totalCols = 0;
 }
 
@@ -654,6 +969,19 @@ CSVFile::seekRowCol(uint32_t row, uint32_t col)
 {
 	if ((row > totalRows) || (col > totalCols))
 		return -1;
+	if (!m_cells.empty())
+	{
+		if (!row)
+			return -1;
+		CSVFileStatistics.numCellReads++;
+		const CSVCell& cell = m_cells[(size_t)(col ? col - 1 : 0) * totalRows + (row - 1)];
+		if (cell.result != NO_ERROR)
+			return cell.result;
+		for (size_t i = 0; i < cell.length; i++)
+			dataBuffer[i] = m_text[cell.offset + i];
+		dataBuffer[cell.length] = '\0';
+		return (NO_ERROR);
+	}
 	uint32_t rowCount = 0;
 	seek(0); // Start at the top.
 	wchar_t tmp[2048];
@@ -695,6 +1023,15 @@ CSVFile::seekRowCol(uint32_t row, uint32_t col)
 int32_t
 CSVFile::readFloat(uint32_t row, uint32_t col, float& value)
 {
+	if (!m_cells.empty() && row && (row <= totalRows) && (col <= totalCols))
+	{
+		int32_t result = cellResult(row, col);
+		value = (result == NO_ERROR) ? convertColumn(col, true)->floats[row - 1] : 0.0f;
+		return (result);
+	}
+	//---------------------------------------------------
+	// Empty cells come back as 0 with the error, so the
+	// caller can tell them from a real 0 and default.
 	int32_t result = seekRowCol(row, col);
 	if (result == NO_ERROR)
 	{
@@ -702,21 +1039,27 @@ CSVFile::readFloat(uint32_t row, uint32_t col, float& value)
 	}
 	else
 		value = 0.0f;
-	return (NO_ERROR);
+	return (result);
 }
 
 //---------------------------------------------------------------------------
 int32_t
 CSVFile::readLong(uint32_t row, uint32_t col, int32_t& value)
 {
+	if (!m_cells.empty() && row && (row <= totalRows) && (col <= totalCols))
+	{
+		int32_t result = cellResult(row, col);
+		value = (result == NO_ERROR) ? convertColumn(col, false)->longs[row - 1] : 0;
+		return (result);
+	}
 	int32_t result = seekRowCol(row, col);
 	if (result == NO_ERROR)
 	{
 		value = textToLong(dataBuffer);
 	}
 	else
-		value = 0.0f;
-	return (NO_ERROR);
+		value = 0;
+	return (result);
 }
 
 //---------------------------------------------------------------------------
@@ -22,12 +22,57 @@
 //---------------------------------------------------------------------------
 // Macro Definitions
 
+#define CSV_CACHE_ID 0x43535643 // 'CSVC'
+#define CSV_CACHE_VERSION 1
+
 //---------------------------------------------------------------------------
 // Enums
 
 //---------------------------------------------------------------------------
 // Structs
 
+//---------------------------------------------------------------------------
+// The file is split once on open.  Every cell seekRowCol can reach is kept
+// as a span of the file text (or the error getNextWord would have given),
+// stored a column at a time.  Numbers are converted a whole column at a
+// time, the first time anybody reads that column as a number.
+//
+// With CSVCachePath set, the spans and any converted columns are written to
+// a sidecar file there, keyed on a hash of the text, and the next run loads
+// them instead of splitting the text again.
+
+typedef struct _CSVCell
+{
+	uint32_t offset; // of the word in the file text
+	uint16_t length;
+	int16_t result; // NO_ERROR, or what getNextWord returned
+} CSVCell;
+
+typedef struct _CSVColumn
+{
+	std::vector<float> floats; // empty until the first readFloat
+	std::vector<int32_t> longs; // empty until the first readLong
+} CSVColumn;
+
+typedef struct _CSVCacheHeader
+{
+	uint32_t id;
+	uint32_t version;
+	uint32_t sourceHash;
+	uint32_t sourceLength;
+	uint32_t totalRows;
+	uint32_t totalCols;
+} CSVCacheHeader;
+
+typedef struct _CSVFileStats
+{
+	uint32_t numFilesSplit; // text split on open
+	uint32_t numCacheHits; // spans loaded from a sidecar
+	uint32_t numCacheWrites;
+	uint32_t numCellReads;
+	uint32_t numColumnsConverted;
+} CSVFileStats;
+
 //---------------------------------------------------------------------------
 //									CSVFile
 class CSVFile 
@@ -64,6 +109,8 @@ public:
 
 	int32_t readString(uint32_t row, uint32_t col, const std::wstring_view& result, size_t bufferSize);
 
+	static bool TestClass(void);
+
 protected:
 	int32_t afterOpen(void);
 	void atClose(void);
@@ -73,6 +120,15 @@ protected:
 
 	int32_t getNextWord(const std::wstring_view&& line, const std::wstring_view& buffer, size_t bufLen);
 
+	bool readText(void);
+	void buildCells(void);
+	void clearCells(void);
+	bool loadCache(void);
+	void saveCache(void);
+	void getCacheName(wchar_t* cacheName);
+	int32_t cellResult(uint32_t row, uint32_t col);
+	CSVColumn* convertColumn(uint32_t col, bool floats);
+
 	float textToFloat(const std::wstring_view& num);
 
 	int32_t textToLong(const std::wstring_view& num);
@@ -105,7 +161,20 @@ protected:
 
 	wchar_t dataBuffer[2048];
 
+	std::vector<char> m_text; // whole file, the cell spans point in here
+	std::vector<uint32_t> m_rowOffsets; // start of each row in m_text
+	std::vector<CSVCell> m_cells; // totalRows cells per column
+	std::vector<CSVColumn> m_columns;
+	uint32_t m_numCellCols; // columns in m_cells, col 0 reads col 1
+	uint32_t m_textHash;
+	bool m_cacheDirty; // sidecar is missing or behind m_columns
+
 };
 
+//---------------------------------------------------------------------------
+extern bool CSVFileUseCells;
+extern wchar_t CSVCachePath[];
+extern CSVFileStats CSVFileStatistics;
+
 //---------------------------------------------------------------------------
 #endif
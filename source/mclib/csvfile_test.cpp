@@ -0,0 +1,71 @@
+//===========================================================================//
+// File:	csvfile_test.cpp                                                 //
+// Contents: test function for CSVFile number reads                          //
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#include "stdinc.h"
+#include "csvfile.h"
+
+#define CSV_TEST_FILE "csvtest.csv"
+
+//---------------------------------------------------------------------------
+// An empty cell reads as 0 but says so, a real 0 reads as 0 with no error.
+
+static bool
+CSVTestReads(void)
+{
+	CSVFile csvFile;
+	Test_Assumption(csvFile.open(CSV_TEST_FILE) == NO_ERROR);
+	float scale = -1.0f;
+	int32_t id = -1;
+	Test_Assumption(csvFile.readFloat(2, 2, scale) == NO_ERROR);
+	Test_Assumption(scale == 1.5f);
+	Test_Assumption(csvFile.readLong(2, 3, id) == NO_ERROR);
+	Test_Assumption(id == 17);
+	Test_Assumption(csvFile.readFloat(3, 2, scale) != NO_ERROR);
+	Test_Assumption(scale == 0.0f);
+	Test_Assumption(csvFile.readLong(3, 3, id) != NO_ERROR);
+	Test_Assumption(id == 0);
+	Test_Assumption(csvFile.readFloat(4, 2, scale) == NO_ERROR);
+	Test_Assumption(scale == 0.0f);
+	Test_Assumption(csvFile.readLong(4, 3, id) == NO_ERROR);
+	Test_Assumption(id == 0);
+	//--------------------------------------
+	// Past the last column of a short row...
+	Test_Assumption(csvFile.readLong(5, 3, id) != NO_ERROR);
+	Test_Assumption(id == 0);
+	csvFile.close();
+	return true;
+}
+
+//---------------------------------------------------------------------------
+
+bool
+CSVFile::TestClass(void)
+{
+	SPEW((GROUP_STUFF_TEST, "Starting CSVFile test..."));
+	static const char csvText[] = "Name,Scale,ID\r\n"
+								  "MECH,1.5,17\r\n"
+								  "TANK,,\r\n"
+								  "ZERO,0,0\r\n"
+								  "SHORT,2.0\r\n";
+	FILE* testFile = fopen(CSV_TEST_FILE, "wb");
+	Test_Assumption(testFile != nullptr);
+	fwrite(csvText, 1, sizeof(csvText) - 1, testFile);
+	fclose(testFile);
+	//-------------------------------------------------
+	// Cells split on open, and the old line scanning,
+	// have to agree on every one of them.
+	bool useCells = CSVFileUseCells;
+	CSVFileUseCells = true;
+	bool cellsOK = CSVTestReads();
+	CSVFileUseCells = false;
+	bool linesOK = CSVTestReads();
+	CSVFileUseCells = useCells;
+	remove(CSV_TEST_FILE);
+	Test_Assumption(cellsOK);
+	Test_Assumption(linesOK);
+	return true;
+}
@@ -30,7 +30,7 @@ int32_t GameDebugWindow::fontheight = 0;
 PVOID
 GameDebugWindow::operator new(size_t ourSize)
 {
-	PVOID result = systemHeap->Malloc(ourSize);
+	PVOID result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
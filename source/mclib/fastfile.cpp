@@ -14,8 +14,148 @@
 
 int32_t ffLastError = 0;
 
+//-----------------------------------------------------------------------------------
+// Merged directory of every open fastfile.  One open addressed table maps each
+// normalized name to the fastfile and entry it lives in, so finding a file is a
+// hash and a probe or two instead of a walk through every directory of every
+// fastfile.  A name in more than one fastfile keeps the first one opened, same
+// as the old linear search did.
+typedef struct _FastFileIndexEntry
+{
+	uint32_t hash;
+	int32_t fastFile; // -1 if the slot is empty
+	ffindex entry;
+} FastFileIndexEntry;
+
+FastFileIndexEntry* fastFileIndex = nullptr;
+uint32_t fastFileIndexSize = 0; // always a power of 2
+uint32_t fastFileIndexCount = 0;
+
 // #define NO_ERROR 0
 //-----------------------------------------------------------------------------------
+inline wchar_t
+normalizeFastFileChar(wchar_t c)
+{
+	if (c == L'/')
+		return L'\\';
+	return towlower(c);
+}
+
+//-----------------------------------------------------------------------------------
+// Lower case, back slashes, and no leading ".\"
+size_t
+normalizeFastFileName(const std::wstring_view& name, wchar_t* normalName, size_t maxLength)
+{
+	size_t start = 0;
+	if ((name.size() > 1) && (name[0] == L'.') && ((name[1] == L'\\') || (name[1] == L'/')))
+		start = 2;
+	size_t length = 0;
+	for (size_t i = start; (i < name.size()) && name[i] && (length < (maxLength - 1)); i++)
+		normalName[length++] = normalizeFastFileChar(name[i]);
+	normalName[length] = 0;
+	return length;
+}
+
+//-----------------------------------------------------------------------------------
+bool
+fastFileNamesMatch(const wchar_t* normalName, const wchar_t* entryName)
+{
+	if ((entryName[0] == L'.') && ((entryName[1] == L'\\') || (entryName[1] == L'/')))
+		entryName += 2;
+	while (*normalName && (*normalName == normalizeFastFileChar(*entryName)))
+	{
+		normalName++;
+		entryName++;
+	}
+	return ((*normalName == 0) && (*entryName == 0));
+}
+
+//-----------------------------------------------------------------------------------
+void
+FastFileIndexGrow(uint32_t numEntries)
+{
+	//---------------------------------------------------
+	//-- Keep the table no more than half full.
+	uint32_t newSize = 1024;
+	while (newSize < (numEntries * 2))
+		newSize <<= 1;
+	if (newSize <= fastFileIndexSize)
+		return;
+	FastFileIndexEntry* oldIndex = fastFileIndex;
+	uint32_t oldSize = fastFileIndexSize;
+	fastFileIndex = (FastFileIndexEntry*)malloc(newSize * sizeof(FastFileIndexEntry));
+	gosASSERT(fastFileIndex != nullptr);
+	fastFileIndexSize = newSize;
+	for (size_t i = 0; i < fastFileIndexSize; i++)
+		fastFileIndex[i].fastFile = -1;
+	//---------------------------------------------------
+	//-- No two entries share a name, so just drop each
+	//-- one in the first free slot from its hash.
+	uint32_t mask = fastFileIndexSize - 1;
+	for (size_t i = 0; i < oldSize; i++)
+		if (oldIndex[i].fastFile != -1)
+		{
+			uint32_t slot = oldIndex[i].hash & mask;
+			while (fastFileIndex[slot].fastFile != -1)
+				slot = (slot + 1) & mask;
+			fastFileIndex[slot] = oldIndex[i];
+		}
+	free(oldIndex);
+}
+
+//-----------------------------------------------------------------------------------
+bool
+FastFileIndexInsert(int32_t fastFile, ffindex entry)
+{
+	wchar_t normalName[UCHAR_MAX];
+	normalizeFastFileName(fastFiles[fastFile]->getEntry(entry).name, normalName, UCHAR_MAX);
+	uint32_t hash = elfHash(normalName);
+	uint32_t mask = fastFileIndexSize - 1;
+	for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask)
+	{
+		FastFileIndexEntry& indexEntry = fastFileIndex[slot];
+		if (indexEntry.fastFile == -1)
+		{
+			indexEntry.hash = hash;
+			indexEntry.fastFile = fastFile;
+			indexEntry.entry = entry;
+			fastFileIndexCount++;
+			return true;
+		}
+		//---------------------------------------------------
+		//-- Already in an earlier fastfile, which wins.
+		if ((indexEntry.hash == hash) && fastFileNamesMatch(normalName, fastFiles[indexEntry.fastFile]->getEntry(indexEntry.entry).name))
+			return false;
+	}
+}
+
+//-----------------------------------------------------------------------------------
+bool
+FastFileLookup(const std::wstring_view& fname, int32_t& fastFile, ffindex& entry)
+{
+	FastFileStatistics.numLookups++;
+	if (!fastFileIndex)
+		return false;
+	wchar_t normalName[UCHAR_MAX];
+	normalizeFastFileName(fname, normalName, UCHAR_MAX);
+	uint32_t hash = elfHash(normalName);
+	uint32_t mask = fastFileIndexSize - 1;
+	for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask)
+	{
+		FastFileStatistics.numLookupProbes++;
+		FastFileIndexEntry& indexEntry = fastFileIndex[slot];
+		if (indexEntry.fastFile == -1)
+			return false;
+		if ((indexEntry.hash == hash) && fastFileNamesMatch(normalName, fastFiles[indexEntry.fastFile]->getEntry(indexEntry.entry).name))
+		{
+			FastFileStatistics.numLookupHits++;
+			fastFile = indexEntry.fastFile;
+			entry = indexEntry.entry;
+			return true;
+		}
+	}
+}
+//-----------------------------------------------------------------------------------
 bool
 FastFileInit(const std::wstring_view& fname)
 {
@@ -33,6 +173,17 @@ FastFileInit(const std::wstring_view& fname)
 		ffLastError = result;
 		return false;
 	}
+	//-----------------------------------------------------------------------------
+	//-- Add its directory to the merged index, behind everything opened before it.
+	FastFile* fastFile = fastFiles[numFastFiles];
+	FastFileIndexGrow(fastFileIndexCount + fastFile->getNumFiles());
+	for (size_t i = 0; i < fastFile->getNumFiles(); i++)
+	{
+		if (FastFileIndexInsert(numFastFiles, i))
+			FastFileStatistics.numIndexed++;
+		else
+			FastFileStatistics.numShadowed++;
+	}
 	numFastFiles++;
 	return TRUE;
 }
@@ -58,29 +209,47 @@ FastFileFini(void)
 	free(fastFiles);
 	fastFiles = nullptr;
 	numFastFiles = 0;
+	free(fastFileIndex);
+	fastFileIndex = nullptr;
+	fastFileIndexSize = 0;
+	fastFileIndexCount = 0;
 }
 
 //-----------------------------------------------------------------------------------
 FastFile*
 FastFileFind(const std::wstring_view& fname, int32_t& fastFileHandle)
 {
-	if (fastFiles)
-	{
-		uint32_t thisHash = elfHash(fname);
-		uint32_t currentFastFile = 0;
-		int32_t tempHandle = -1;
-		while (currentFastFile < numFastFiles)
-		{
-			tempHandle = fastFiles[currentFastFile]->openFast(thisHash, fname);
-			if (tempHandle != -1)
-			{
-				fastFileHandle = tempHandle;
-				return fastFiles[currentFastFile];
-			}
-			currentFastFile++;
-		}
-	}
-	return nullptr;
+	int32_t fastFile = -1;
+	ffindex entry = 0;
+	if (!fastFiles || !FastFileLookup(fname, fastFile, entry))
+		return nullptr;
+	fastFiles[fastFile]->openFast(entry);
+	fastFileHandle = (int32_t)entry;
+	return fastFiles[fastFile];
+}
+
+//-----------------------------------------------------------------------------------
+// Same lookup as FastFileFind, without opening the entry.
+bool
+FastFileExists(const std::wstring_view& fname)
+{
+	int32_t fastFile = -1;
+	ffindex entry = 0;
+	return (fastFiles && FastFileLookup(fname, fastFile, entry));
+}
+
+//-----------------------------------------------------------------------------------
+// Uncompressed size of a file in a fastfile, straight from the directory.
+// Nothing is opened, so no entry anybody is reading gets reset.
+bool
+FastFileSize(const std::wstring_view& fname, size_t& realSize)
+{
+	int32_t fastFile = -1;
+	ffindex entry = 0;
+	if (!fastFiles || !FastFileLookup(fname, fastFile, entry))
+		return false;
+	realSize = fastFiles[fastFile]->getEntry(entry).realSize;
+	return true;
 }
 
 //------------------------------------------------------------------
@@ -22,5 +22,7 @@
 extern bool __stdcall FastFileInit(const std::wstring_view& fname);
 extern void __stdcall FastFileFini(void);
 extern FastFile* __stdcall FastFileFind(const std::wstring_view& fname, int32_t& fastFileHandle);
+extern bool __stdcall FastFileExists(const std::wstring_view& fname);
+extern bool __stdcall FastFileSize(const std::wstring_view& fname, size_t& realSize);
 extern uint32_t __stdcall elfHash(const std::wstring_view& name);
 //-----------------------------------------------------------------------------------
@@ -25,6 +25,9 @@ union {
 std::unique_ptr<uint8_t> LZPacketBuffer;
 size_t LZPacketBufferSize = 512000;
 
+bool FastFileUseMapping = true;
+FastFileStats FastFileStatistics = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+
 extern wchar_t CDInstallPath[];
 void __stdcall EnterWindowMode();
 void __stdcall EnterFullScreenMode();
@@ -94,10 +97,12 @@ FastFile::open(const std::wstring_view& fileName)
 	m_stream.seekg(std::ios::beg);
 	m_stream.read(readtype32.buffer, sizeof(readtype32.numval));
 
-	if ((readtype32.numval != FASTFILE_VERSION) && (readtype32.numval != FASTFILE_VERSION_LZ))
+	if ((readtype32.numval != FASTFILE_VERSION) && (readtype32.numval != FASTFILE_VERSION_LZ) && (readtype32.numval != FASTFILE_VERSION_LZB))
 		throw std::system_error(EILSEQ, std::system_category(), __func__);
 	if (readtype32.numval == FASTFILE_VERSION_LZ)
 		m_useLZCompress = true;
+	if (readtype32.numval == FASTFILE_VERSION_LZB)
+		m_useLZBCompress = true;
 
 	//---------------------------------------------
 	//-- Second Long is number of filenames present.
@@ -110,9 +115,70 @@ FastFile::open(const std::wstring_view& fileName)
 
 	m_files.resize(readtype32.numval);
 
+	//---------------------------------------------
+	//-- Map the whole thing once.  If we can't, every
+	//-- read goes through the stream like it always did.
+	if (FastFileUseMapping)
+		mapFile();
+
 	return S_OK;
 }
 
+//---------------------------------------------------------------------------
+void
+FastFile::close(void)
+{
+	unmapFile();
+	if (m_stream.is_open())
+		m_stream.close();
+}
+
+//---------------------------------------------------------------------------
+bool
+FastFile::mapFile(void)
+{
+	std::wstring path(m_fileName);
+	m_mapFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (m_mapFile == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_mapFile, &fileSize) || (fileSize.QuadPart == 0) || (fileSize.QuadPart > SIZE_MAX))
+	{
+		unmapFile();
+		return false;
+	}
+	m_mapping = CreateFileMappingW(m_mapFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping)
+		m_mapView = (const uint8_t*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!m_mapView)
+	{
+		//--------------------------------------------------
+		//-- Most likely out of address space.  Not fatal.
+		unmapFile();
+		return false;
+	}
+	m_mapSize = (size_t)fileSize.QuadPart;
+	FastFileStatistics.numMappedFiles++;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+void
+FastFile::unmapFile(void)
+{
+	if (m_mapView)
+		UnmapViewOfFile(m_mapView);
+	m_mapView = nullptr;
+	m_mapSize = 0;
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	m_mapping = nullptr;
+	if (m_mapFile != INVALID_HANDLE_VALUE)
+		CloseHandle(m_mapFile);
+	m_mapFile = INVALID_HANDLE_VALUE;
+}
+
 //---------------------------------------------------------------------------
 // void FastFile::close(void)
 //{
@@ -167,6 +233,18 @@ FastFile::openFast(uint32_t hash, const std::wstring_view& fileName, ffindex& in
 	// somehow would be equal to the index
 }
 
+//---------------------------------------------------------------------------
+// Open an entry already found through the merged index (FastFileFind).
+HRESULT
+FastFile::openFast(ffindex index)
+{
+	if (index >= m_files.size())
+		return E_FAIL;
+	m_files[index].inuse = true;
+	m_files[index].pos = 0;
+	return S_OK;
+}
+
 //---------------------------------------------------------------------------
 HRESULT
 FastFile::closeFast(ffindex index)
@@ -220,6 +298,66 @@ FastFile::seekFast(ffindex index, size_t position, int32_t how)
 	return (FILE_NOT_OPEN);
 }
 
+//---------------------------------------------------------------------------
+const uint8_t*
+FastFile::viewFastRAW(int32_t fastFileHandle, size_t& size)
+{
+	size = 0;
+	if (!m_mapView || (fastFileHandle < 0) || (fastFileHandle >= (int32_t)m_files.size()) || !m_files[fastFileHandle].inuse)
+		return nullptr;
+	//---------------------------------------------
+	//-- A truncated fastfile is the stream path's problem.
+	const FILEENTRY& fentry = m_files[fastFileHandle].fentry;
+	if ((fentry.position > m_mapSize) || (fentry.size > (m_mapSize - fentry.position)))
+		return nullptr;
+	size = fentry.size;
+	return (m_mapView + fentry.position);
+}
+
+//---------------------------------------------------------------------------
+int32_t
+FastFile::decompressFast(int32_t fastFileHandle, PVOID bfr, const uint8_t* packet)
+{
+	//--------------------------------------------------------
+	// USED to LZ Compress here.  It is NOW zLib Compression.
+	//  We should not try to use old fastfiles becuase version check
+	//  above should fail when trying to open!!
+	const FILEENTRY& fentry = m_files[fastFileHandle].fentry;
+	size_t decompLength = 0;
+	if (m_useLZCompress)
+	{
+		decompLength = LZDecomp((uint8_t*)bfr, fentry.realSize, packet, fentry.size);
+	}
+	else if (m_useLZBCompress)
+	{
+		//--------------------------------------------------------
+		// Repacked fastfile.  Anything that didn't get smaller was
+		// stored as is, so the sizes tell us which this one is.
+		if (fentry.size == fentry.realSize)
+		{
+			memcpy(bfr, packet, fentry.size);
+			decompLength = fentry.size;
+		}
+		else
+		{
+			decompLength = LZBDecomp((uint8_t*)bfr, fentry.realSize, packet, fentry.size);
+			if (!decompLength)
+				STOP(("Error UnCompressing File %s from FastFile %s", fentry.name, m_fileName));
+		}
+	}
+	else
+	{
+		decompLength = fentry.realSize;
+		int32_t error = uncompress((uint8_t*)bfr, &decompLength, packet, fentry.size);
+		if (error != Z_OK)
+			STOP(("Error %d UnCompressing File %s from FastFile %s", error, fentry.name,
+				m_fileName));
+	}
+	if (decompLength != fentry.realSize)
+		return 0;
+	return decompLength;
+}
+
 //---------------------------------------------------------------------------
 int32_t
 FastFile::readFast(int32_t fastFileHandle, PVOID bfr, int32_t size)
@@ -228,6 +366,18 @@ FastFile::readFast(int32_t fastFileHandle, PVOID bfr, int32_t size)
 	int32_t result = 0;
 	if ((fastFileHandle >= 0) && (fastFileHandle < numFiles) && m_files[fastFileHandle].inuse)
 	{
+		//---------------------------------------------------------
+		// Mapped?  Then decompress straight out of the view.  No
+		// seek, no copy into LZPacketBuffer and no CD to go missing.
+		size_t packetSize = 0;
+		const uint8_t* packet = viewFastRAW(fastFileHandle, packetSize);
+		if (packet)
+		{
+			FastFileStatistics.numMappedReads++;
+			return decompressFast(fastFileHandle, bfr, packet);
+		}
+		FastFileStatistics.numStreamReads++;
+		FastFileStatistics.bytesStreamed += m_files[fastFileHandle].fentry.size;
 		logicalPosition = fseek(m_stream,
 			m_files[fastFileHandle].pos + m_files[fastFileHandle].fentry->position, SEEK_SET);
 		// ALL files in the fast file are now zLib compressed. NO EXCEPTIONS!!
@@ -297,29 +447,7 @@ FastFile::readFast(int32_t fastFileHandle, PVOID bfr, int32_t size)
 					if (openFailed && (Environment.fullScreen == 0) && alreadyFullScreen)
 						EnterFullScreenMode();
 				}
-				//--------------------------------------------------------
-				// USED to LZ Compress here.  It is NOW zLib Compression.
-				//  We should not try to use old fastfiles becuase version check
-				//  above should fail when trying to open!!
-				size_t decompLength = 0;
-				if (m_useLZCompress)
-				{
-					decompLength = LZDecomp(
-						(uint8_t*)bfr, LZPacketBuffer, m_files[fastFileHandle].fentry.size);
-				}
-				else
-				{
-					decompLength = m_files[fastFileHandle].fentry->realSize;
-					int32_t error = uncompress((uint8_t*)bfr, &decompLength, LZPacketBuffer,
-						m_files[fastFileHandle].fentry.size);
-					if (error != Z_OK)
-						STOP(("Error %d UnCompressing File %s from FastFile %s", error,
-							m_files[fastFileHandle].fentry->name, m_fileName));
-				}
-				if ((int32_t)decompLength != m_files[fastFileHandle].fentry->realSize)
-					result = 0;
-				else
-					result = decompLength;
+				result = decompressFast(fastFileHandle, bfr, LZPacketBuffer);
 			}
 		}
 		return result;
@@ -338,6 +466,18 @@ FastFile::readFastRAW(int32_t fastFileHandle, PVOIDbfr, int32_t size)
 	int32_t result = 0;
 	if ((fastFileHandle >= 0) && (fastFileHandle < numFiles) && m_files[fastFileHandle].inuse)
 	{
+		size_t packetSize = 0;
+		const uint8_t* packet = viewFastRAW(fastFileHandle, packetSize);
+		if (packet)
+		{
+			FastFileStatistics.numMappedReads++;
+			if (size < (int32_t)packetSize)
+				return 0;
+			memcpy(bfr, packet, packetSize);
+			return packetSize;
+		}
+		FastFileStatistics.numStreamReads++;
+		FastFileStatistics.bytesStreamed += m_files[fastFileHandle].fentry.size;
 		logicalPosition = fseek(m_stream,
 			m_files[fastFileHandle].pos + m_files[fastFileHandle].fentry->position, SEEK_SET);
 		if (size >= m_files[fastFileHandle].fentry.size)
@@ -26,7 +26,8 @@
 enum fastfile_versions : uint32_t
 {
 	FASTFILE_VERSION = 0xCADDECAF,
-	FASTFILE_VERSION_LZ = 0xFADDECAF
+	FASTFILE_VERSION_LZ = 0xFADDECAF,
+	FASTFILE_VERSION_LZB = 0xBADDECAF // LZ block entries, raw when size == realSize
 };
 
 //#pragma pack(1)
@@ -50,6 +51,19 @@ typedef struct FILE_HANDLE
 
 typedef size_t ffindex;
 
+typedef struct _FastFileStats
+{
+	uint32_t numMappedFiles; // .fst files read through a mapped view
+	uint32_t numMappedReads; // entries read out of a mapped view
+	uint32_t numStreamReads; // entries read through the stream
+	uint32_t bytesStreamed; // compressed bytes the stream path had to copy
+	uint32_t numIndexed; // names in the merged fastfile index
+	uint32_t numShadowed; // names hidden by the same name in an earlier fastfile
+	uint32_t numLookups;
+	uint32_t numLookupHits;
+	uint32_t numLookupProbes; // index slots looked at, over all lookups
+} FastFileStats;
+
 //---------------------------------------------------------------------------
 // Class FastFile
 class FastFile
@@ -59,14 +73,25 @@ protected:
 	std::fstream m_stream;
 	const std::wstring_view& m_fileName;
 
+	//------------------------------------------------------------
+	// The whole .fst mapped once at open, if we could. Entries are
+	// then handed out (or decompressed) straight from the view...
+	HANDLE m_mapFile;
+	HANDLE m_mapping;
+	const uint8_t* m_mapView;
+	size_t m_mapSize;
+
 	size_t numFiles;
 	size_t length;
 	size_t logicalPosition;
 	bool m_useLZCompress;
+	bool m_useLZBCompress;
 
 public:
 	FastFile(void) :
-		numFiles(0), length(0), logicalPosition(0), m_useLZCompress(false) {}
+		m_mapFile(INVALID_HANDLE_VALUE), m_mapping(nullptr), m_mapView(nullptr), m_mapSize(0),
+		numFiles(0), length(0), logicalPosition(0), m_useLZCompress(false),
+		m_useLZBCompress(false) {}
 	~FastFile(void)
 	{
 		close();
@@ -87,26 +112,41 @@ public:
 		return open(fileName);
 	};
 	HRESULT openFast(uint32_t hash, const std::wstring_view& fileName, ffindex& index);
+	HRESULT openFast(ffindex index);
 	HRESULT closeFast(ffindex index);
 
-	void close(void) { return m_stream.close(); }
-	bool isOpen(void) { return m_stream.is_open(); }
+	void close(void);
+	bool isOpen(void) { return (m_stream.is_open() || (m_mapView != nullptr)); }
+	bool isMapped(void) { return (m_mapView != nullptr); }
 
 	size_t getNumFiles(void) { return m_files.size(); }
+	const FILEENTRY& getEntry(ffindex index) { return m_files[index].fentry; }
 
 	HRESULT seekFast(ffindex index, size_t position, int32_t how = SEEK_SET);
 	int32_t readFast(int32_t fastFileHandle, PVOID bfr, int32_t size);
 	int32_t readFastRAW(int32_t fastFileHandle, PVOID bfr, int32_t size);
+	// Zero-copy. Points at the entry's bytes as stored (still compressed)
+	// in the mapped view, valid until the FastFile closes. nullptr if the
+	// file isn't mapped...
+	const uint8_t* viewFastRAW(int32_t fastFileHandle, size_t& size);
 	int32_t tellFast(int32_t fastFileHandle);
 	int32_t sizeFast(int32_t fastFileHandle);
 	int32_t lzSizeFast(int32_t fastFileHandle);
 
 	bool isLZCompressed(void) { return m_useLZCompress; }
+	bool isLZBCompressed(void) { return m_useLZBCompress; }
+
+protected:
+	bool mapFile(void);
+	void unmapFile(void);
+	int32_t decompressFast(int32_t fastFileHandle, PVOID bfr, const uint8_t* packet);
 };
 
 //---------------------------------------------------------------------------
 extern FastFile** fastFiles;
 extern uint32_t numFastFiles;
 extern uint32_t maxFastFiles;
+extern bool FastFileUseMapping;
+extern FastFileStats FastFileStatistics;
 //---------------------------------------------------------------------------
 #endif
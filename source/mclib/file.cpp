@@ -41,6 +41,7 @@
 // Static Variables
 // HRESULT MechFile::lastError  = NO_ERROR;
 // bool MechFile::logFileTraffic = false;
+FileReadStats FileReadStatistics = {0, 0, 0, 0};
 
 #if CONSIDERED_OBSOLETE
 File* fileTrafficLog = nullptr;
@@ -79,9 +80,7 @@ int32_t __stdcall fileExists(const std::wstring_view& filename)
 		return 1;
 	}
 
-	int32_t fastFileHandle = -1;
-	FastFile* fastFile = FastFileFind(filename, fastFileHandle);
-	if (fastFile)
+	if (FastFileExists(filename))
 		return 2;
 	return 0;
 }
@@ -643,6 +642,23 @@ MechFile::seek(int32_t pos, int32_t from)
 		}
 		break;
 	}
+	if (readBufferLength)
+	{
+		//--------------------------------------------------
+		// Moves inside the read window just move.  Anything
+		// else puts the file back where we think it is first.
+		int32_t target = -1;
+		if (from == SEEK_SET)
+			target = pos;
+		else if (from == SEEK_CUR)
+			target = logicalPosition + pos;
+		if ((target >= (int32_t)readBufferStart) && (target <= (int32_t)(readBufferStart + readBufferLength)))
+		{
+			logicalPosition = target;
+			return (NO_ERROR);
+		}
+		flushReadBuffer();
+	}
 	if (inRAM && fileImage)
 	{
 		if (m_parent)
@@ -726,6 +742,7 @@ int32_t
 MechFile::read(uint32_t pos, uint8_t* buffer, int32_t length)
 {
 	int32_t result = 0;
+	flushReadBuffer();
 	if (inRAM && fileImage)
 	{
 		const std::wstring_view& readAddress = ((const std::wstring_view&)fileImage) + pos;
@@ -768,24 +785,21 @@ MechFile::readByte(void)
 		memcpy((const std::wstring_view&)&value, readAddress, sizeof(value));
 		logicalPosition += sizeof(value);
 	}
-	else if (fastFile)
-	{
-		result = fastFile->readFast(fastFileHandle, (const std::wstring_view&)&value, sizeof(value));
-		logicalPosition += sizeof(value);
-	}
-	else
+	else if (fastFile || isOpen())
 	{
-		if (isOpen())
+		size_t bytesAvailable;
+		uint8_t* data = fillReadBuffer(sizeof(value), bytesAvailable);
+		if (bytesAvailable)
 		{
-			result = _read(handle, (&value), sizeof(value));
+			value = *data;
 			logicalPosition += sizeof(value);
-			if (result != sizeof(value))
-				lastError = errno;
 		}
 		else
-		{
-			lastError = FILE_NOT_OPEN;
-		}
+			lastError = READ_PAST_EOF_ERR;
+	}
+	else
+	{
+		lastError = FILE_NOT_OPEN;
 	}
 	return value;
 }
@@ -796,6 +810,7 @@ MechFile::readWord(void)
 {
 	int16_t value = 0;
 	int32_t result = 0;
+	flushReadBuffer();
 	if (inRAM && fileImage)
 	{
 		const std::wstring_view& readAddress = (const std::wstring_view&)fileImage + logicalPosition;
@@ -837,6 +852,7 @@ MechFile::readLong(void)
 {
 	int32_t value = 0;
 	uint32_t result = 0;
+	flushReadBuffer();
 	if (inRAM && fileImage)
 	{
 		const std::wstring_view& readAddress = (const std::wstring_view&)fileImage + logicalPosition;
@@ -894,6 +910,7 @@ MechFile::readFloat(void)
 {
 	float value = 0;
 	uint32_t result = 0;
+	flushReadBuffer();
 	if (inRAM && fileImage)
 	{
 		const std::wstring_view& readAddress = (const std::wstring_view&)fileImage + logicalPosition;
@@ -932,7 +949,33 @@ int32_t
 MechFile::readString(uint8_t* buffer)
 {
 	int32_t last = 0;
-	if (isOpen())
+	if (isOpen() && !inRAM)
+	{
+		//--------------------------------------------
+		// A window at a time, up to and past the nul.
+		for (;;)
+		{
+			size_t bytesAvailable;
+			uint8_t* data = fillReadBuffer(1, bytesAvailable);
+			if (!bytesAvailable)
+			{
+				buffer[last] = 0;
+				break;
+			}
+			uint8_t* end = (uint8_t*)memchr(data, 0, bytesAvailable);
+			size_t count = end ? (end - data) : bytesAvailable;
+			memcpy(buffer + last, data, count);
+			last += count;
+			logicalPosition += count;
+			if (end)
+			{
+				buffer[last] = 0;
+				logicalPosition++;
+				break;
+			}
+		}
+	}
+	else if (isOpen())
 	{
 		for (;;)
 		{
@@ -956,6 +999,7 @@ int32_t
 MechFile::read(uint8_t* buffer, int32_t length)
 {
 	int32_t result = 0;
+	flushReadBuffer();
 	if (inRAM && fileImage)
 	{
 		const std::wstring_view& readAddress = (const std::wstring_view&)fileImage + logicalPosition;
@@ -991,6 +1035,7 @@ int32_t
 MechFile::readRAW(uint32_t*& buffer, UserHeapPtr heap)
 {
 	int32_t result = 0;
+	flushReadBuffer();
 	if (fastFile && heap && fastFile->isLZCompressed())
 	{
 		int32_t lzSizeNeeded = fastFile->lzSizeFast(fastFileHandle);
@@ -1027,40 +1072,29 @@ MechFile::readLine(uint8_t* buffer, int32_t maxLength)
 			lastError = FILE_NOT_OPEN;
 		}
 	}
-	else if (fastFile)
-	{
-		int32_t bytesread;
-		bytesread = fastFile->readFast(fastFileHandle, buffer, maxLength);
-		if (maxLength > bytesread)
-			maxLength = bytesread;
-		while ((i < maxLength) && (buffer[i] != '\r'))
-			i++;
+	else if (fastFile || isOpen())
+	{
+		//---------------------------------------------------------
+		// Straight out of the read window.  One more byte than the
+		// line can hold, so we can see the '\n' after a '\r'.
+		size_t bytesAvailable;
+		uint8_t* line = fillReadBuffer(maxLength + 1, bytesAvailable);
+		if (maxLength > (int32_t)bytesAvailable)
+			maxLength = bytesAvailable;
+		uint8_t* end = (uint8_t*)memchr(line, '\r', maxLength);
+		i = end ? (end - line) : maxLength;
+		memcpy(buffer, line, i);
 		buffer[i++] = 0;
-		logicalPosition += i;
-		if (buffer[i] == '\n')
+		if (end && (i < (int32_t)bytesAvailable) && (line[i] == '\n'))
 			logicalPosition += 1;
-		fastFile->seekFast(fastFileHandle, logicalPosition);
+		logicalPosition += i;
+		if (logicalPosition > readBufferStart + readBufferLength)
+			logicalPosition = readBufferStart + readBufferLength;
+		FileReadStatistics.numBufferedLines++;
 	}
 	else
 	{
-		if (isOpen())
-		{
-			int32_t bytesread;
-			bytesread = _read(handle, buffer, maxLength);
-			if (maxLength > bytesread)
-				maxLength = bytesread;
-			while (i < maxLength && buffer[i] != '\r')
-				i++;
-			buffer[i++] = 0;
-			logicalPosition += i;
-			if (buffer[i] == '\n')
-				logicalPosition += 1;
-			seek(logicalPosition);
-		}
-		else
-		{
-			lastError = FILE_NOT_OPEN;
-		}
+		lastError = FILE_NOT_OPEN;
 	}
 	return i;
 }
@@ -1087,46 +1121,102 @@ MechFile::readLineEx(uint8_t* buffer, int32_t maxLength)
 			lastError = FILE_NOT_OPEN;
 		}
 	}
-	else if (fastFile)
+	else if (fastFile || isOpen())
 	{
-		int32_t bytesread;
-		bytesread = fastFile->readFast(fastFileHandle, buffer, maxLength);
-		if (maxLength > bytesread)
-			maxLength = bytesread;
-		while ((i < maxLength) && (buffer[i] != '\n'))
-			i++;
+		size_t bytesAvailable;
+		uint8_t* line = fillReadBuffer(maxLength, bytesAvailable);
+		if (maxLength > (int32_t)bytesAvailable)
+			maxLength = bytesAvailable;
+		uint8_t* end = (uint8_t*)memchr(line, '\n', maxLength);
+		i = end ? (end - line) : maxLength;
 		i++; // Include Newline
+		memcpy(buffer, line, min(i, maxLength));
 		buffer[i++] = 0;
 		logicalPosition += (i - 1);
-		fastFile->seekFast(fastFileHandle, logicalPosition);
+		if (logicalPosition > readBufferStart + readBufferLength)
+			logicalPosition = readBufferStart + readBufferLength;
+		FileReadStatistics.numBufferedLines++;
 	}
 	else
 	{
-		if (isOpen())
-		{
-			int32_t bytesread = _read(handle, buffer, maxLength);
-			if (maxLength > bytesread)
-				maxLength = bytesread;
-			while (i < maxLength && buffer[i] != '\n')
-				i++;
-			i++;
-			buffer[i++] = 0;
-			logicalPosition += (i - 1);
-			seek(logicalPosition);
-		}
-		else
-		{
-			lastError = FILE_NOT_OPEN;
-		}
+		lastError = FILE_NOT_OPEN;
 	}
 	return i;
 }
 
+//---------------------------------------------------------------------------
+// Makes sure the read window holds bytesNeeded bytes from logicalPosition
+// on (or everything up to the end of the file, if that's less) and returns
+// them.  bytesAvailable is everything the window has from there on.
+uint8_t*
+MechFile::fillReadBuffer(size_t bytesNeeded, size_t& bytesAvailable)
+{
+	if (!readBuffer)
+	{
+		readBuffer.reset(new uint8_t[FILE_READ_BUFFER_SIZE]);
+		readBufferSize = FILE_READ_BUFFER_SIZE;
+	}
+	if (!readBufferLength)
+		readBufferStart = logicalPosition;
+	size_t offset = logicalPosition - readBufferStart;
+	bytesAvailable = readBufferLength - offset;
+	size_t windowEnd = readBufferStart + readBufferLength;
+	if ((bytesAvailable >= bytesNeeded) || (windowEnd >= getLength()))
+		return (readBuffer.get() + offset);
+	//----------------------------------------------------
+	// Slide what's left to the front and fill behind it.
+	if (bytesNeeded > readBufferSize)
+	{
+		size_t newSize = bytesNeeded;
+		std::unique_ptr<uint8_t[]> newBuffer(new uint8_t[newSize]);
+		if (bytesAvailable)
+			memcpy(newBuffer.get(), readBuffer.get() + offset, bytesAvailable);
+		readBuffer = std::move(newBuffer);
+		readBufferSize = newSize;
+	}
+	else if (offset)
+		memmove(readBuffer.get(), readBuffer.get() + offset, bytesAvailable);
+	readBufferStart = logicalPosition;
+	readBufferLength = bytesAvailable;
+	size_t bytesToRead = min(readBufferSize - readBufferLength, getLength() - windowEnd);
+	int32_t bytesRead;
+	if (fastFile)
+		bytesRead = fastFile->readFast(fastFileHandle, readBuffer.get() + readBufferLength, bytesToRead);
+	else
+		bytesRead = _read(handle, readBuffer.get() + readBufferLength, bytesToRead);
+	if (bytesRead > 0)
+	{
+		readBufferLength += bytesRead;
+		FileReadStatistics.bytesFilled += bytesRead;
+	}
+	else
+		lastError = errno;
+	FileReadStatistics.numFills++;
+	bytesAvailable = readBufferLength;
+	return (readBuffer.get());
+}
+
+//---------------------------------------------------------------------------
+// Drops the read window and puts the file back at logicalPosition.
+void
+MechFile::flushReadBuffer(void)
+{
+	if (!readBufferLength)
+		return;
+	readBufferLength = 0;
+	if (fastFile)
+		fastFile->seekFast(fastFileHandle, logicalPosition);
+	else
+		_lseek(handle, logicalPosition + parentOffset, SEEK_SET);
+	FileReadStatistics.numFlushes++;
+}
+
 //---------------------------------------------------------------------------
 int32_t
 MechFile::write(uint32_t pos, uint8_t* buffer, int32_t bytes)
 {
 	uint32_t result = 0;
+	flushReadBuffer();
 	if (m_parent == nullptr)
 	{
 		if (isOpen())
@@ -1164,6 +1254,7 @@ int32_t
 MechFile::writeByte(byte value)
 {
 	int32_t result = 0;
+	flushReadBuffer();
 	if (m_parent == nullptr)
 	{
 		if (isOpen())
@@ -1204,6 +1295,7 @@ int32_t
 MechFile::writeWord(int16_t value)
 {
 	uint32_t result = 0;
+	flushReadBuffer();
 	if (m_parent == nullptr)
 	{
 		if (isOpen())
@@ -1252,6 +1344,7 @@ int32_t
 MechFile::writeLong(int32_t value)
 {
 	uint32_t result = 0;
+	flushReadBuffer();
 	if (m_parent == nullptr)
 	{
 		if (isOpen())
@@ -1293,6 +1386,7 @@ MechFile::writeFloat(float value)
 {
 	uint32_t result = 0;
 	gosASSERT(!isNAN(&value));
+	flushReadBuffer();
 	if (m_parent == nullptr)
 	{
 		if (isOpen())
@@ -1388,6 +1482,7 @@ int32_t
 MechFile::write(uint8_t* buffer, int32_t bytes)
 {
 	int32_t result = 0;
+	flushReadBuffer();
 	if (m_parent == nullptr)
 	{
 		if (isOpen())
@@ -63,6 +63,20 @@ enum __file_constants : uint32_t
 	COULD_NOT_MAP_FILE = 0xBADF0014,
 };
 
+// Text reads from files that aren't in RAM go through a read window of at
+// least this many bytes.
+#define FILE_READ_BUFFER_SIZE 8192
+
+typedef struct _FileReadStats
+{
+	uint32_t numBufferedLines; // readLine/readLineEx calls the window served
+	uint32_t numFills; // reads into the window
+	uint32_t bytesFilled;
+	uint32_t numFlushes; // windows dropped for an unbuffered read, seek or write
+} FileReadStats;
+
+extern FileReadStats FileReadStatistics;
+
 //---------------------------------------------------------------------------
 // Function Declarations
 // Returns 1 if file is on HardDrive and 2 if file is in FastFile
@@ -171,6 +185,8 @@ public:
 
 protected:
 	void setup(void);
+	uint8_t* fillReadBuffer(size_t bytesNeeded, size_t& bytesAvailable);
+	void flushReadBuffer(void);
 
 protected:
 	std::wstring_view m_fileName;
@@ -178,6 +194,15 @@ protected:
 	std::fstream m_stream;
 	std::unique_ptr<MechFile> m_parent;
 
+	// readLine, readLineEx, readString and readByte are served from a read
+	// window when the file isn't in RAM.  While the window holds anything
+	// the file itself is positioned at its end, not at logicalPosition;
+	// anything else that reads, seeks or writes flushes it first.
+	std::unique_ptr<uint8_t[]> readBuffer;
+	size_t readBufferSize = 0;
+	size_t readBufferStart = 0; // logical position of readBuffer[0]
+	size_t readBufferLength = 0;
+
 	// fileMode		= NOMODE;
 	// handle			= -1;
 	// length			= 0;
@@ -0,0 +1,244 @@
+//---------------------------------------------------------------------------
+//
+// FrameArena.cpp -- Bump allocator for data that only lasts a frame
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//---------------------------------------------------------------------------
+// Include Files
+#include "stdinc.h"
+
+#ifndef FRAMEARENA_H
+#include "framearena.h"
+#endif
+
+//---------------------------------------------------------------------------
+// Static Globals
+
+FrameArenaPtr frameArena = nullptr;
+
+// A thread's piece of the current buffer in each arena.  The stamp says
+// which frame it was taken in; a zeroed one never matches.
+typedef struct _FrameSubArena
+{
+	uint32_t stamp;
+	uint8_t* next;
+	uint8_t* end;
+} FrameSubArena;
+
+static thread_local FrameSubArena frameSubArenas[MAX_FRAME_ARENAS];
+static FrameArenaPtr frameArenaList[MAX_FRAME_ARENAS] = {nullptr};
+static std::atomic<uint32_t> frameArenaStamp(0);
+
+//---------------------------------------------------------------------------
+static uint32_t
+nextFrameStamp(void)
+{
+	uint32_t newStamp = ++frameArenaStamp;
+	if (newStamp == 0)
+		newStamp = ++frameArenaStamp;
+	return (newStamp);
+}
+
+//---------------------------------------------------------------------------
+// class FrameArena
+FrameArena::FrameArena(void)
+{
+	for (size_t i = 0; i < FRAME_ARENA_BUFFERS; i++)
+		buffers[i] = nullptr;
+	bufferSize = 0;
+	current = 0;
+	arenaIndex = -1;
+	stamp = 0;
+	bufferUsed = 0;
+	frameBytes = 0;
+	numMallocs = 0;
+	numOverflows = 0;
+	overflowBytes = 0;
+	memset(&stats, 0, sizeof(FrameArenaStats));
+	arenaName[0] = 0;
+}
+
+//---------------------------------------------------------------------------
+int32_t
+FrameArena::init(uint32_t frameSize, uint32_t overflowSize, const std::wstring_view& arenaId)
+{
+	destroy();
+	for (size_t i = 0; i < MAX_FRAME_ARENAS; i++)
+		if (!frameArenaList[i])
+		{
+			frameArenaList[i] = this;
+			arenaIndex = (int32_t)i;
+			break;
+		}
+	gosASSERT(arenaIndex != -1);
+	if (arenaId)
+	{
+		strncpy(arenaName, arenaId, 31);
+		arenaName[31] = 0;
+	}
+	bufferSize = (frameSize + FRAME_ARENA_ALIGN - 1) & ~(FRAME_ARENA_ALIGN - 1);
+	int32_t result = createHeap(bufferSize * FRAME_ARENA_BUFFERS);
+	if (result)
+		STOP(("Could not create Frame Arena %s.  Error:%x", arenaId, result));
+	result = commitHeap();
+	if (result)
+		STOP(("Could not create Frame Arena %s.  Error:%x", arenaId, result));
+	for (size_t i = 0; i < FRAME_ARENA_BUFFERS; i++)
+		buffers[i] = heap + bufferSize * i;
+	//------------------------------------------------------
+	// Overflow heap fails quietly.  The arena counts it.
+	overflowHeap.init(overflowSize, "FrameOverflow");
+	overflowHeap.setMallocFatals(false);
+	current = 0;
+	stamp = nextFrameStamp();
+	return (NO_ERROR);
+}
+
+//---------------------------------------------------------------------------
+void
+FrameArena::destroy(void)
+{
+	if (arenaIndex != -1)
+	{
+		frameArenaList[arenaIndex] = nullptr;
+		arenaIndex = -1;
+	}
+	for (size_t i = 0; i < FRAME_ARENA_BUFFERS; i++)
+	{
+		if (overflowHeap.heapReady())
+			freeOverflow((int32_t)i);
+		buffers[i] = nullptr;
+	}
+	overflowHeap.destroy();
+	HeapManager::destroy();
+	bufferSize = 0;
+	stamp = 0;
+	bufferUsed = 0;
+	frameBytes = 0;
+	numMallocs = 0;
+	numOverflows = 0;
+}
+
+//---------------------------------------------------------------------------
+// Retires the frame just finished and moves to the other buffer, whose
+// contents are two frames old.
+void
+FrameArena::newFrame(void)
+{
+	if (!bufferSize)
+		return;
+	stats.numFrames++;
+	stats.numMallocs = numMallocs;
+	stats.frameBytes = (uint32_t)frameBytes;
+	stats.numOverflows = numOverflows;
+	stats.overflowBytes = (uint32_t)overflowBytes;
+	if (stats.numOverflows)
+	{
+		stats.numOverflowFrames++;
+		if (stats.frameBytes > stats.peakFrameBytes)
+			SPEW((0, "Frame Arena %s overflowed: high water now %u bytes, %u from the heap, arena is %u\n",
+				arenaName, stats.frameBytes, stats.overflowBytes, (uint32_t)bufferSize));
+	}
+	if (stats.frameBytes > stats.peakFrameBytes)
+		stats.peakFrameBytes = stats.frameBytes;
+	current = (current + 1) % FRAME_ARENA_BUFFERS;
+	stamp = nextFrameStamp();
+	freeOverflow(current);
+	bufferUsed = 0;
+	frameBytes = 0;
+	numMallocs = 0;
+	numOverflows = 0;
+	overflowBytes = 0;
+#ifdef _DEBUG
+	//--------------------------------------------------------
+	// Anyone still holding memory from two frames ago reads
+	// garbage right away, not only when it gets handed out.
+	FillMemory(buffers[current], bufferSize, 0xff);
+#endif
+}
+
+//---------------------------------------------------------------------------
+PVOID
+FrameArena::Malloc(size_t memSize)
+{
+	memSize = (memSize + FRAME_ARENA_ALIGN - 1) & ~(size_t)(FRAME_ARENA_ALIGN - 1);
+	if (!memSize)
+		memSize = FRAME_ARENA_ALIGN;
+	numMallocs++;
+	frameBytes += memSize;
+	//----------------------------------------------------
+	// Most mallocs fit in what's left of this thread's
+	// chunk.
+	FrameSubArena& subArena = frameSubArenas[arenaIndex];
+	if ((subArena.stamp == stamp) && ((size_t)(subArena.end - subArena.next) >= memSize))
+	{
+		PVOID result = subArena.next;
+		subArena.next += memSize;
+		return (result);
+	}
+	//----------------------------------------------------
+	// Big ones get carved off alone so the chunk isn't
+	// thrown away for them.
+	if (memSize > (FRAME_ARENA_CHUNK / 4))
+	{
+		PVOID result = carve(memSize);
+		return (result ? result : overflowMalloc(memSize));
+	}
+	uint8_t* chunk = (uint8_t*)carve(FRAME_ARENA_CHUNK);
+	if (chunk)
+	{
+		subArena.stamp = stamp;
+		subArena.next = chunk + memSize;
+		subArena.end = chunk + FRAME_ARENA_CHUNK;
+		return (chunk);
+	}
+	//----------------------------------------------------
+	// Not a whole chunk left.  Take what the malloc needs
+	// from the end of the buffer, if that much is there.
+	PVOID result = carve(memSize);
+	return (result ? result : overflowMalloc(memSize));
+}
+
+//---------------------------------------------------------------------------
+PVOID
+FrameArena::carve(size_t memSize)
+{
+	size_t offset = bufferUsed.load();
+	do
+	{
+		if ((offset + memSize) > bufferSize)
+			return (nullptr);
+	} while (!bufferUsed.compare_exchange_weak(offset, offset + memSize));
+	return (buffers[current] + offset);
+}
+
+//---------------------------------------------------------------------------
+PVOID
+FrameArena::overflowMalloc(size_t memSize)
+{
+	std::lock_guard<std::mutex> lock(overflowLock);
+	PVOID result = overflowHeap.Malloc(memSize);
+	if (!result)
+	{
+		stats.numFailedMallocs++;
+		return (nullptr);
+	}
+	overflowBlocks[current].push_back(result);
+	overflowBytes += memSize;
+	numOverflows++;
+	return (result);
+}
+
+//---------------------------------------------------------------------------
+void
+FrameArena::freeOverflow(int32_t buffer)
+{
+	for (size_t i = 0; i < overflowBlocks[buffer].size(); i++)
+		overflowHeap.Free(overflowBlocks[buffer][i]);
+	overflowBlocks[buffer].clear();
+}
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,110 @@
+//---------------------------------------------------------------------------
+//
+// FrameArena.h -- Bump allocator for data that only lasts a frame
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#pragma once
+
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+//---------------------------------------------------------------------------
+// Include Files
+
+#ifndef HEAP_H
+#include "heap.h"
+#endif
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// The arena has two buffers and newFrame switches between them, so what
+// was handed out last frame is still good all through this one and only
+// gets reused the frame after.  Nothing is freed.  Mission::update calls
+// newFrame first thing, as do the logistics cameras when no mission is
+// running.  newFrame may not be called while other threads are using the
+// arena.
+//
+// Each thread bumps through a chunk of the current buffer it took for
+// itself, so brain workers allocate without locking.  A request too big
+// for a chunk is carved off on its own.  Once the buffer is used up,
+// mallocs go to the arena's overflow heap, and those blocks are freed
+// when their buffer comes around again.  A frame that overflows past the
+// last high water mark is SPEWed with how much it needed.
+
+#define FRAME_ARENA_BUFFERS 2
+#define FRAME_ARENA_ALIGN 16
+#define FRAME_ARENA_CHUNK (32 * 1024) // what a thread takes from the buffer at a time
+#define MAX_FRAME_ARENAS 4
+
+class FrameArena;
+typedef FrameArena* FrameArenaPtr;
+
+typedef struct _FrameArenaStats
+{
+	uint32_t numFrames;
+	uint32_t numMallocs; // last frame
+	uint32_t frameBytes; // last frame, overflow included
+	uint32_t peakFrameBytes; // high water mark, overflow included
+	uint32_t numOverflows; // last frame's mallocs that went to the overflow heap
+	uint32_t overflowBytes;
+	uint32_t numOverflowFrames;
+	uint32_t numFailedMallocs; // the overflow heap was full too
+} FrameArenaStats;
+
+//---------------------------------------------------------------------------
+class FrameArena : public HeapManager
+{
+	// Data Members
+	//-------------
+protected:
+	uint8_t* buffers[FRAME_ARENA_BUFFERS];
+	size_t bufferSize;
+	int32_t current;
+	int32_t arenaIndex; // which of each thread's sub arenas is this one's
+	uint32_t stamp; // new every frame, so sub arenas from old frames are stale
+	std::atomic<size_t> bufferUsed;
+	std::atomic<size_t> frameBytes;
+	std::atomic<uint32_t> numMallocs;
+	std::atomic<uint32_t> numOverflows;
+	std::mutex overflowLock;
+	UserHeap overflowHeap;
+	std::vector<PVOID> overflowBlocks[FRAME_ARENA_BUFFERS];
+	size_t overflowBytes;
+	FrameArenaStats stats;
+	wchar_t arenaName[32];
+
+	// Member Functions
+	//-----------------
+public:
+	FrameArena(void);
+	~FrameArena(void) { destroy(); }
+
+	int32_t init(uint32_t frameSize, uint32_t overflowSize, const std::wstring_view& arenaId = nullptr);
+	void destroy(void);
+
+	void newFrame(void);
+
+	PVOID Malloc(size_t memSize);
+
+	size_t size(void) { return bufferSize; }
+	FrameArenaStats getStatistics(void) { return stats; }
+
+	static bool TestClass(void);
+
+protected:
+	PVOID carve(size_t memSize);
+	PVOID overflowMalloc(size_t memSize);
+	void freeOverflow(int32_t buffer);
+};
+
+//---------------------------------------------------------------------------
+extern FrameArenaPtr frameArena;
+
+//---------------------------------------------------------------------------
+#endif
@@ -0,0 +1,134 @@
+//===========================================================================//
+// File:	framearena_test.cpp                                              //
+// Contents: test function for the frame arena                               //
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#include "stdinc.h"
+#include "framearena.h"
+
+#include <thread>
+
+#define FRAME_ARENA_TEST_SIZE (256 * 1024)
+#define FRAME_ARENA_TEST_OVERFLOW (64 * 1024)
+#define FRAME_ARENA_TEST_THREADS 4
+
+//---------------------------------------------------------------------------
+// Mallocs numBlocks blocks of assorted sizes and fills each with mark, so
+// a block handed out twice shows up when they're checked.
+
+static void
+FrameArenaTestFill(FrameArena& arena, std::vector<std::pair<uint8_t*, size_t>>& blocks, uint8_t mark, size_t numBlocks)
+{
+	blocks.clear();
+	for (size_t i = 0; i < numBlocks; i++)
+	{
+		size_t blockSize = 1 + ((i * 37) % 700);
+		uint8_t* block = (uint8_t*)arena.Malloc(blockSize);
+		if (block)
+			memset(block, mark, blockSize);
+		blocks.push_back(std::make_pair(block, blockSize));
+	}
+}
+
+//---------------------------------------------------------------------------
+
+static bool
+FrameArenaTestCheck(const std::vector<std::pair<uint8_t*, size_t>>& blocks, uint8_t mark)
+{
+	for (size_t i = 0; i < blocks.size(); i++)
+	{
+		Test_Assumption(blocks[i].first != nullptr);
+		Test_Assumption(((uintptr_t)blocks[i].first & (FRAME_ARENA_ALIGN - 1)) == 0);
+		for (size_t j = 0; j < blocks[i].second; j++)
+			Test_Assumption(blocks[i].first[j] == mark);
+	}
+	return true;
+}
+
+//---------------------------------------------------------------------------
+
+bool
+FrameArena::TestClass(void)
+{
+	SPEW((GROUP_STUFF_TEST, "Starting FrameArena test..."));
+	FrameArena arena;
+	Test_Assumption(arena.init(FRAME_ARENA_TEST_SIZE, FRAME_ARENA_TEST_OVERFLOW, "TEST") == NO_ERROR);
+	Test_Assumption(arena.size() == FRAME_ARENA_TEST_SIZE);
+	std::vector<std::pair<uint8_t*, size_t>> lastFrame;
+	std::vector<std::pair<uint8_t*, size_t>> thisFrame;
+	//-------------------------------------------------------------
+	// Small mallocs bump through one chunk, and a zero byte malloc
+	// still gets a block of its own...
+	uint8_t* first = (uint8_t*)arena.Malloc(1);
+	uint8_t* second = (uint8_t*)arena.Malloc(0);
+	Test_Assumption(second == first + FRAME_ARENA_ALIGN);
+	Test_Assumption((first >= arena.buffers[0]) && (first < arena.buffers[0] + FRAME_ARENA_TEST_SIZE));
+	//-------------------------------------------------------------
+	// Last frame's blocks are left alone all through this one, and
+	// what this frame hands out is in the other buffer...
+	FrameArenaTestFill(arena, lastFrame, 0x11, 100);
+	arena.newFrame();
+	FrameArenaTestFill(arena, thisFrame, 0x22, 100);
+	Test_Assumption(FrameArenaTestCheck(lastFrame, 0x11));
+	Test_Assumption(FrameArenaTestCheck(thisFrame, 0x22));
+	for (size_t i = 0; i < thisFrame.size(); i++)
+		Test_Assumption((thisFrame[i].first >= arena.buffers[1]) && (thisFrame[i].first < arena.buffers[1] + FRAME_ARENA_TEST_SIZE));
+	//-------------------------------------------------------------
+	// ...and the frame after that gets the first buffer back.
+	arena.newFrame();
+	uint8_t* reused = (uint8_t*)arena.Malloc(16);
+	Test_Assumption(reused == first);
+	Test_Assumption(FrameArenaTestCheck(thisFrame, 0x22));
+	Test_Assumption(arena.getStatistics().numFrames == 2);
+	Test_Assumption(arena.getStatistics().numMallocs == 100);
+	//------------------------------------------------------------
+	// A block bigger than a quarter chunk is carved off alone, and
+	// small mallocs after it carry on in their own chunk...
+	uint8_t* big = (uint8_t*)arena.Malloc(FRAME_ARENA_CHUNK);
+	uint8_t* small = (uint8_t*)arena.Malloc(16);
+	Test_Assumption(big >= first + FRAME_ARENA_CHUNK);
+	Test_Assumption(small == reused + FRAME_ARENA_ALIGN);
+	//--------------------------------------------------------------
+	// A frame that runs past the end of its buffer goes to the
+	// overflow heap, and once that's full too mallocs fail cleanly.
+	arena.newFrame();
+	FrameArenaTestFill(arena, thisFrame, 0x33, 800);
+	Test_Assumption(FrameArenaTestCheck(thisFrame, 0x33));
+	uint32_t numFailedMallocs = arena.getStatistics().numFailedMallocs;
+	Test_Assumption(arena.Malloc(FRAME_ARENA_TEST_OVERFLOW * 2) == nullptr);
+	Test_Assumption(arena.getStatistics().numFailedMallocs == numFailedMallocs + 1);
+	arena.newFrame();
+	FrameArenaStats stats = arena.getStatistics();
+	Test_Assumption(stats.numOverflows > 0);
+	Test_Assumption(stats.numOverflowFrames == 1);
+	Test_Assumption(stats.peakFrameBytes > FRAME_ARENA_TEST_SIZE);
+	Test_Assumption(FrameArenaTestCheck(thisFrame, 0x33));
+	//--------------------------------------------------------------
+	// The overflow blocks go back when their buffer comes round
+	// again, so frame after frame can overflow just as far.
+	for (size_t frame = 0; frame < 4; frame++)
+	{
+		FrameArenaTestFill(arena, thisFrame, (uint8_t)(0x40 + frame), 800);
+		Test_Assumption(FrameArenaTestCheck(thisFrame, (uint8_t)(0x40 + frame)));
+		arena.newFrame();
+	}
+	Test_Assumption(arena.getStatistics().numOverflowFrames == 5);
+	//---------------------------------------------------------
+	// Threads mallocing at once never get each other's blocks.
+	arena.newFrame();
+	std::vector<std::pair<uint8_t*, size_t>> threadBlocks[FRAME_ARENA_TEST_THREADS];
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < FRAME_ARENA_TEST_THREADS; t++)
+		threads.emplace_back([&arena, &threadBlocks, t]() { FrameArenaTestFill(arena, threadBlocks[t], (uint8_t)(0x50 + t), 80); });
+	for (size_t t = 0; t < FRAME_ARENA_TEST_THREADS; t++)
+		threads[t].join();
+	for (size_t t = 0; t < FRAME_ARENA_TEST_THREADS; t++)
+		Test_Assumption(FrameArenaTestCheck(threadBlocks[t], (uint8_t)(0x50 + t)));
+	arena.newFrame();
+	Test_Assumption(arena.getStatistics().numMallocs == FRAME_ARENA_TEST_THREADS * 80);
+	Test_Assumption(arena.getStatistics().numOverflows == 0);
+	arena.destroy();
+	return true;
+}
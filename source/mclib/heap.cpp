@@ -27,6 +27,10 @@
 
 //#include "gameos.hpp"
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 //---------------------------------------------------------------------------
 // Static Globals
 static wchar_t CorruptMsg[] = "Heap check failed.\n";
@@ -44,6 +48,54 @@ uint32_t totalLeft = 0;
 
 bool HeapList::heapInstrumented = 0;
 
+bool UserHeapThreadCaches = false;
+wchar_t HeapTracePath[80];
+
+#define HEAP_TRACE_BUFFER_SIZE (64 * 1024)
+
+static std::mutex heapTraceLock;
+static std::atomic<bool> heapTracing(false);
+static MechFile* heapTraceFile = nullptr;
+static std::vector<uint8_t> heapTraceBuffer;
+static std::unordered_map<PVOID, uint32_t> heapTraceIds; // blocks out, by trace id
+static uint32_t heapTraceNextId = 0;
+static uint32_t heapTraceNumHeaps = 0;
+static uint32_t heapTraceGeneration = 0;
+
+bool UserHeapTagging = false;
+wchar_t HeapTelemetryPath[80];
+uint32_t HeapTelemetryInterval = 60; // seconds
+
+#define HEAP_CALLSITE_CACHE 256 // callsite ids each thread remembers
+#define HEAP_LEAK_REPORT_GROWTH 50 // heap growth lines in a leak report
+
+typedef struct _HeapCallsiteCache
+{
+	uintptr_t address;
+	uint16_t id;
+} HeapCallsiteCache;
+
+static thread_local uint8_t heapTagSubsystem = HEAP_TAG_NONE;
+static thread_local HeapCallsiteCache heapCallsiteCache[HEAP_CALLSITE_CACHE];
+static std::mutex heapCallsiteLock;
+static std::unordered_map<uintptr_t, uint16_t> heapCallsiteIds;
+static std::vector<uintptr_t> heapCallsites; // by id
+static std::atomic<uint8_t> heapTagEpoch(0);
+static uint32_t heapMissionNumber = 0;
+static HeapSnapshot heapMissionStart;
+
+static MechFile* heapTelemetryFile = nullptr;
+static bool heapTelemetryJSON = false;
+static uint32_t heapTelemetryInterval = 0;
+static uint32_t heapTelemetryStart = 0;
+static uint32_t heapTelemetryLast = 0;
+static uint32_t heapTelemetryCount = 0;
+static HeapSnapshot heapTelemetryPrevious;
+static std::vector<uint8_t> heapTelemetryText;
+
+static const wchar_t* heapTagNames[NUM_HEAP_TAG_SUBSYSTEMS] = {"None", "Mission", "Interface",
+	"Terrain", "Objects", "Textures", "Script", "Logistics", "Multiplayer", "Sound"};
+
 //
 // Returns a context ready for stack walking from current address
 //
@@ -75,8 +127,6 @@ DecodeAddress(uint32_t Address, bool brief);
 
 //---------------------------------------------------------------------------
 // Macro definitions
-#define USE_BEST_FIT
-
 #ifdef _DEBUG
 #define SAFE_HEAP
 #endif
@@ -103,9 +153,8 @@ HeapManager::destroy(void)
 	int32_t result = 0;
 	//-----------------------------
 	// Remove this from the UEBER HEAP
-#ifdef CHECK_HEAP
-	globalHeapList->removeHeap(this);
-#endif
+	if (globalHeapList)
+		globalHeapList->removeHeap(this);
 	if (committedSize)
 	{
 		result = VirtualFree(heap, totalSize, MEM_DECOMMIT);
@@ -191,26 +240,17 @@ HeapManager::commitHeap(uint32_t commitSize)
 	{
 		int32_t actualSize = commitSize;
 		committedSize += actualSize;
-#ifdef CHECK_HEAP
 		//-----------------------------
-		// Add this to the UEBER HEAP
-		globalHeapList->addHeap(this);
-#endif
+		// Add this to the UEBER HEAP.
+		// Every build, for telemetry.
+		if (globalHeapList)
+			globalHeapList->addHeap(this);
 		//------------------------------
 		// Store off who called this.
 		// If this was a UserHeap,
 		// the UserHeap class will
 		// do its own unwind.
-		uint32_t currentEbp;
-		uint32_t prevEbp;
-		uint32_t retAddr;
-		__asm
-			{
-			mov currentEbp, esp
-			}
-		prevEbp = *((uint32_t*)currentEbp);
-		retAddr = *((uint32_t*)(currentEbp + 4));
-		whoMadeMe = retAddr;
+		whoMadeMe = (uintptr_t)HEAP_CALLER();
 		return NO_ERROR;
 	}
 	gosASSERT(false);
@@ -222,17 +262,22 @@ int32_t
 HeapManager::decommitHeap(uint32_t decommitSize)
 {
 	int32_t result = 0;
-	if (decommitSize == 0)
-		decommitSize = totalSize;
-	if (decommitSize > committedSize)
+	//------------------------------------------------
+	// Heaps are only ever committed whole, so they are
+	// only ever decommitted whole too.
+	if ((decommitSize == 0) || (decommitSize > committedSize))
 		decommitSize = committedSize;
 	if (decommitSize < committedSize)
-		decommitSize = totalSize;
-	uint32_t decommitAddress = decommitSize;
-	committedSize -= decommitAddress;
-	result = VirtualFree((PVOID)committedSize, decommitSize, MEM_DECOMMIT);
+		return COULDNT_COMMIT;
+	if (!decommitSize)
+		return NO_ERROR;
+	committedSize -= decommitSize;
+	result = VirtualFree(heap + committedSize, decommitSize, MEM_DECOMMIT);
 	if (result == false)
 		result = GetLastError();
+#ifdef CHECK_HEAP
+	globalHeapList->removeHeap(this);
+#endif
 	return NO_ERROR;
 }
 
@@ -243,10 +288,9 @@ HeapManager::decommitHeap(uint32_t decommitSize)
 UserHeap::UserHeap(void) :
 	HeapManager()
 {
-	heapStart = nullptr;
-	heapEnd = nullptr;
-	firstNearBlock = nullptr;
 	heapSize = 0;
+	traceHeap = -1;
+	traceGeneration = 0;
 #ifdef CHECK_HEAP
 	mallocFatals = TRUE;
 #else
@@ -279,42 +323,16 @@ UserHeap::init(uint32_t memSize, const std::wstring_view& heapId, bool useGOS)
 		// If this was a UserHeap,
 		// the UserHeap class will
 		// do its own unwind.
-		uint32_t currentEbp;
-		uint32_t prevEbp;
-		uint32_t retAddr;
-		__asm
-			{
-			mov currentEbp, esp
-			}
-		prevEbp = *((uint32_t*)currentEbp);
-		retAddr = *((uint32_t*)(currentEbp + 4));
-		whoMadeMe = retAddr;
-		//------------------------------------------------------------------------
-		// Now that we have a pointer to the memory, setup the HEAP.
-		uint32_t heapTop = (uint32_t)heap;
-		heapTop += memSize;
-		heapTop -= 16;
-		heapTop &= ~3; // Force top to be uint32_t boundary.
-		uint32_t heapBottom = (uint32_t)heap;
-		heapStart = (HeapBlockPtr)heapBottom;
-		heapEnd = (HeapBlockPtr)heapTop;
-		heapStart->blockSize = heapTop - heapBottom;
-		heapStart->upperBlock = 0; // Nothing above this in memory.
-		heapEnd->blockSize = 1; // Mark as last block.
-		heapEnd->previous = (HeapBlockPtr)0x1572; // Mark as last block.
-		heapEnd->upperBlock = (HeapBlockPtr)heapBottom;
+		whoMadeMe = (uintptr_t)HEAP_CALLER();
 		//--------------------------------
 		//	Set all free memory to -1.
 		// Any access before ready and Exception city.
-		uint8_t* start = (uint8_t*)heapBottom;
-		start += sizeof(HeapBlock);
-		uint32_t length = heapTop - heapBottom;
-		length -= sizeof(HeapBlock);
-		FillMemory(start, length, 0xff);
-		//----------------------------------
-		// linkup heap blocks
-		firstNearBlock = nullptr;
-		relink(heapStart);
+		FillMemory(heap, memSize, 0xff);
+		//------------------------------------------------------------------------
+		// Now that we have a pointer to the memory, setup the HEAP.
+		if (!blocks.init(heap, memSize))
+			STOP(("Could not create Heap %s.  Size:%d", heapId, memSize));
+		blocks.setThreadCaches(UserHeapThreadCaches);
 		heapSize = memSize;
 #ifdef _DEBUG
 		recordArray = nullptr;
@@ -327,9 +345,6 @@ UserHeap::init(uint32_t memSize, const std::wstring_view& heapId, bool useGOS)
 	{
 		gosHeap = gos_CreateMemoryHeap(heapId, memSize, ParentClientHeap);
 		useGOSGuardPage = true;
-		heapStart = nullptr;
-		heapEnd = nullptr;
-		firstNearBlock = nullptr;
 		heapSize = 0;
 		heapName = nullptr;
 		heapState = NO_ERROR;
@@ -410,9 +425,7 @@ UserHeap::destroy(void)
 	HeapManager::destroy();
 	if (!gosHeap)
 	{
-		heapStart = nullptr;
-		heapEnd = nullptr;
-		firstNearBlock = nullptr;
+		blocks.destroy();
 		heapSize = 0;
 		if (heapName)
 		{
@@ -439,141 +452,30 @@ UserHeap::destroy(void)
 uint32_t
 UserHeap::totalCoreLeft(void)
 {
-	uint32_t result = 0;
-	if (gosHeap)
-		return result;
-#ifdef SAFE_HEAP
-	int32_t localHeapState = heapState;
-#endif
-	HeapBlockPtr localFirst = firstNearBlock;
-	int32_t heapBlockSize = -(int32_t)allocatedBlockSize;
-	if (!firstNearBlock)
-	{
-#ifdef _DEBUG
-		PAUSE(("Heap %s firstNearBlock is nullptr.", heapName));
-#endif
-		return 0;
-	}
-#ifdef SAFE_HEAP
-	__asm
-	{
-		cmp		localHeapState, 0
-		jne		error1
-	}
-#endif
-	__asm
-		{
-		xor     eax, eax
-		mov		edi, 10000
-		mov		ecx, heapBlockSize
-		mov     ebx, localFirst
-		mov     edx, ebx // edx = is place holder for first node
-		}
-	BytesLoop : __asm
-				{
-		mov     ebx, [ebx].next
-		add     eax, [ebx].blockSize
-		add		eax, ecx
-		dec		edi
-		je		int16_t error1
-		cmp     ebx, edx
-		jne     int16_t BytesLoop
-		jmp		int16_t DoneTC
-				}
-				error1 : __asm
-						 {
-		xor		eax, eax
-						 }
-						 DoneTC : __asm
-	{
-		mov		result, eax
-	}
-	return (result);
+	if (gosHeap || !heapSize)
+		return (0);
+	return ((uint32_t)blocks.totalFree());
 }
 
 //---------------------------------------------------------------------------
 uint32_t
 UserHeap::coreLeft(void)
 {
-	uint32_t result = 0;
-	if (gosHeap)
-		return result;
-#ifdef SAFE_HEAP
-	int32_t localHeapState = heapState;
-#endif
-	HeapBlockPtr localFirst = firstNearBlock;
-	int32_t heapBlockSize = -(int32_t)allocatedBlockSize;
-#ifdef USE_BEST_FIT
-	__asm
-	{
-		xor		eax, eax
-	}
-#ifdef SAFE_HEAP
-	__asm
-	{
-		cmp localHeapState, 0 jne int16_t DoneCL
-	}
-#endif
-	__asm
-		{
-		mov     ebx, localFirst
-		or		ebx, ebx
-		je		int16_t DoneCL
-		mov		ebx, [ebx].previous
-		mov		eax, [ebx].blockSize // size of last block in list
-		add		eax, heapBlockSize
-		}
-DoneCL:
-	__asm {
-		mov		result, eax
-	}
-	return (result);
-#else // !DEFINED BEST_FIT
-	__asm
-	{
-		xor		eax, eax
-	}
-#ifdef SAFE_HEAP
-	__asm
-	{
-		cmp localHeapState, 0 jne int16_t DoneCL
-	}
-#endif
-	__asm
-		{
-		mov     ebx, localFirst
-		or		ebx, ebx
-		je		int16_t DoneCL
-		mov		ecx, 10000
-		}
-TopLoop:
-	__asm
-		{
-		cmp		[ebx].blockSize, eax
-		jb		Next
-		mov		eax, [ebx].blockSize
-		}
-Next:
-	__asm
-		{
-		dec		ecx
-		jle		DoneCL
-		mov		ebx, [ebx].next
-		cmp		ebx, localFirst
-		jne		TopLoop
-		add		eax, heapBlockSize
-		}
-DoneCL:
-	__asm {
-		mov		result, eax
-	}
-	return (result);
-#endif
+	if (gosHeap || !heapSize)
+		return (0);
+	return ((uint32_t)blocks.largestFree());
+}
+
+//---------------------------------------------------------------------------
+PVOID
+UserHeap::Malloc(size_t memSize)
+{
+	return (Malloc(memSize, HEAP_CALLER()));
 }
 
 //---------------------------------------------------------------------------
 PVOID
-UserHeap::Malloc(uint32_t memSize)
+UserHeap::Malloc(size_t memSize, PVOID returnAddress)
 {
 	PVOID result = nullptr;
 	if (gosHeap)
@@ -583,326 +485,40 @@ UserHeap::Malloc(uint32_t memSize)
 #ifdef _GAMEOS_HPP_
 		gos_PopCurrentHeap();
 #endif
-
+		if (heapTracing)
+			traceMalloc(result, memSize);
 		return result;
 	}
-	HeapBlockPtr blockOffs = nullptr;
-	HeapBlockPtr localFirst = firstNearBlock;
-	int32_t heapBlockSize = sizeof(HeapBlock);
-	bool mf = mallocFatals;
-#ifdef _DEBUG
-	heapBlockSize += 4;
-#endif
-	int32_t errorResult = 0;
-	__asm
-	{
-		mov     eax, memSize
-		or	    eax, eax
-		je	    Alloc_zero
-	}
-#ifdef _DEBUG
-	__asm
-	{
-		add eax, 4 // extra space for who made me pointer
-	}
-#endif
-	__asm
-		{
-		add     eax, 11 // force minimum allocation 8+3
-		and 	al, 0xfc // NOT 3						//force dword alignment
-		cmp		eax, heapBlockSize
-		jae		int16_t SizeDone
-		mov		eax, heapBlockSize
-		}
-SizeDone:
-	__asm
-		{
-		cmp		eax, memSize
-		jb      Alloc_Overflow
-
-						 // search free list for first available block
-
-		mov     ebx, localFirst
-		or	    ebx, ebx
-		je	    Zero_Free
-		mov		edx, ebx // marker to beginning of list
-		}
-SearchLoop:
-	__asm
-		{
-		mov     ecx, [ebx].blockSize
-		sub     ecx, eax // uint32_t math
-		jnb     int16_t FoundBlock
-		mov     ebx, [ebx].next
-		cmp     edx, ebx
-		jne     SearchLoop // have we come back to first node?
-
-					// else block was not found
-
-		add		ecx, eax // ECX = biggest block
-		mov		edx, [memSize] // EDX = bytes asked for
-		mov		eax, OUT_OF_MEMORY // EAX = Out of memory error number
-		jmp		Alloc_error
-		}
-FoundBlock:
-	// ebx = offset of found block
-	// ecx = size of leftover block
-	// eax = size of block to allocate
-	__asm {
-		mov		blockOffs, ebx
-		cmp 	ecx, heapBlockSize // any memory left to reallocate?
-		jae		int16_t UnlinkNormal
-		or		[ebx].blockSize, 1 // mark allocated
-	}
-	// This code is the unlink macro.
-	__asm
-		{
-		cmp		[ebx].next, ebx
-		jne		int16_t ULine1
-
-							   //else list is now empty
-
-		mov		localFirst, 0
-		jmp		int16_t ULine3
-		}
-	ULine1 :
-		__asm
-		{
-		mov     edx, localFirst
-		cmp     ebx, edx
-		jne     int16_t ULine2 //unlinking first element?
-		mov     eax, [ebx].next
-		mov     localFirst, eax
-		}
-		ULine2 :
-		__asm
-		{
-		mov		edi, [ebx].next //edi = ebx.next
-		mov		ebx, [ebx].previous
-		mov		[edi].previous, ebx //ebx.next.prev = ebx.prev
-		mov		[ebx].next, edi //ebx.prev.next = ebx.next
-		}
-		ULine3 : //End of Unlink code
-				 __asm
-				 {
-		mov		eax, blockOffs
-		jmp		int16_t Alloc_Done
-				 }
-				 UnlinkNormal : __asm
+	if (memSize)
 	{
-		mov		edi, ebx
-		add		edi, [ebx].blockSize // edi -> lower block
-		add		[edi].upperBlock, ecx // update lower pointer to the new block
-
-		mov		[ebx].blockSize, ecx
-		mov		edi, ebx
-		add		edi, ecx // edi -> newblock
-		or		al, 1 // mark new block as allocated
-		mov		[edi].blockSize, eax
-		mov		[edi].upperBlock, ebx
-	}
-	//-------------------------------------------------------------------------------------
-	// SORT Routine
-#ifdef USE_BEST_FIT
-	__asm
+		if (UserHeapTagging)
 		{
-		pushad
+			//-------------------------------------------
+			// The tag takes the place the caller's
+			// memory would have started.
+			result = blocks.Malloc(memSize + HEAP_TAG_SIZE);
+			if (result)
+				result = tagBlock(result, returnAddress);
 		}
-	//-------------------------------------
-	// see if we have to do any work at all
-	HeapBlockPtr localFirstSort = firstNearBlock;
-	__asm
-		{
-		mov		edx, localFirstSort
-		mov		ecx, [ebx].blockSize
-		mov		edi, [ebx].next
-
-		cmp		edi, [ebx].previous
-		jne		int16_t __Line1 // either 1 or two members in list
-		cmp		edi, ebx
-		je		__Done // only one member in list
-
-					// else there are only two
-
-		mov		localFirstSort, ebx // assume we are the smaller block
-		cmp		ecx, [edi].blockSize
-		jbe		__Done // we were right
-		mov		localFirstSort, edi // else other guy is smaller
-		jmp		__Done
-		}
-__Line1: // else see if we are not in the correct order
-	__asm
-		{
-		cmp		ecx, [edi].blockSize
-		jbe		int16_t __Line2
-
-						 // else see if next guy in line is the localFirst
-
-		cmp		edi, edx // did we just compare with Beginning of list?
-		jne		int16_t __Line3 // no
-		}
-__Line2:
-	__asm {
-		mov		edi, [ebx].previous
-		cmp	    ecx, [edi].blockSize
-		jae		int16_t __Done
-
-				// else we are less than guy to our left
-
-		cmp		ebx, edx // are we the first block in list?
-		je		int16_t __Done
-
-		__Line3: // else we must unlink our block, saving a pointer to lower
-			// neighbor
-
-		push	edi
-		push	ebx
-
-					// Unlink Routine inline here
-
-		cmp		[ebx].next, ebx
-		jne		int16_t _ULine1
-
-				// else list is now empty
-
-		mov		localFirstSort, 0
-		jmp		int16_t _ULine3
-	}
-_ULine1:
-	__asm
-		{
-		mov     edx, localFirstSort
-		cmp     ebx, edx
-		jne     int16_t _ULine2 // unlinking first element?
-		mov     eax, [ebx].next
-		mov     localFirstSort, eax
-		}
-_ULine2:
-	__asm
-		{
-		mov		edi, [ebx].next // edi = ebx.next
-		mov		ebx, [ebx].previous
-		mov		[edi].previous, ebx // ebx.next.prev = ebx.prev
-		mov		[ebx].next, edi // ebx.prev.next = ebx.next
-		}
-_ULine3:
-	__asm
-		{
-			// ecx = unchanged, the size of our block
-		pop		ebx // ebx -> our block we have just unlinked.
-		pop		edi // edi -> block to start our search on.
-
-		mov 	edx, localFirstSort
-
-		cmp		[ebx].previous, edi
-		je		int16_t __Line4 // search previous nodes
-		}
-// stop when guy to the right is higher than us, or is the FirstMemBlock
-__Loop1:
-	__asm
-		{
-		mov		esi, edi
-		mov		edi, [edi].next
-		cmp		edi, edx // have we wrapped around?
-		je		int16_t __FoundPlace
-		cmp		[edi].blockSize, ecx
-		jae		int16_t __FoundPlace
-		jmp		__Loop1
-		}
-__Line4:
-// stop when guy to the left is lower than us, or we stopped on the
-// FirstMemBlock
-__Loop2:
-	__asm
-		{
-		mov		esi, edi
-		mov		edi, [edi].previous
-		cmp		esi, edx // have we wrapped around?
-		je		int16_t __Line5
-		cmp		[edi].blockSize, ecx
-		ja		__Loop2
-		}
-__Line5:
-	__asm
-		{
-		xchg		esi, edi
-		}
-__FoundPlace: // esi-> first block, edi->second block, ebx -> us
-	// ebx = offset of new block
-	__asm
-		{
-		mov		[ebx].previous, esi
-		mov		[ebx].next, edi
-		mov		[esi].next, ebx
-		mov		[edi].previous, ebx
-
-		mov		edi, edx
-		cmp		ecx, [edi].blockSize // see if we are now smallest
-		jae		int16_t __Done
-		mov		localFirstSort, ebx // we are smallest
-		}
-__Done:
-	firstNearBlock = localFirstSort;
-	//-------------------------------------------------------------------------------------
-	// SORT Routine
-	__asm
-	{
-		POPAD
+		else
+			result = blocks.Malloc(memSize);
 	}
-#endif
-	__asm {mov eax, edi jmp int16_t Alloc_Done}
-	//-----------------------------------------error handling
-	Alloc_zero : __asm {mov eax, ALLOC_ZERO jmp int16_t Alloc_error} Zero_Free : __asm {mov eax, NULL_FREE_LIST jmp int16_t Alloc_error} Alloc_Overflow : __asm {mov eax, ALLOC_OVERFLOW} Alloc_error : __asm {mov errorResult, eax cmp mf, 0
-	//		cmp		[this].mallocFatals,0
-
 #ifdef CHECK_HEAP
-																																																			je noFatal
-#else
-																																																			jmp noFatal
-#endif
-
-																																																		} memCoreLeft = totalCoreLeft();
-	memTotalLeft = coreLeft();
-	walkHeap(TRUE, false);
-	if (memSize)
-		STOP(("Heap %s is Out Of RAM.  HeapSize %d, CoreLeft %d, TotalLeft %d, "
-			  "SizeTried %d",
-			heapName, heapSize, memCoreLeft, memTotalLeft, memSize));
-	else
-		STOP(("Heap %s Tried to Malloc Zero Bytes!"));
-noFatal:
-	__asm
-		{
-		mov		eax, -8
-#ifdef _DEBUG
-		mov		eax, -12 // Make that extra room for who made me
-#endif
-		}
-Alloc_Done:
-	__asm
-	{
-		add		eax, 8 // skip over header
-#ifdef _DEBUG
-		add		eax, 4 // Skip over extra for debugging
-#endif
-	}
-#ifdef _DEBUG
-	__asm {
-		// if we allocated memory, store pointer to caller
-		or eax, eax je NoAllocation mov ebx, ebp mov edx,
-		dword ptr[ebx + 4] // get caller
-		mov[eax - 4],
-		edx // Store caller in HeapBlock
-	} NoAllocation :
-#endif
-#ifdef HEAP_CHECK
-		__asm {push eax} WalkHeap();
-	__asm
+	if (!result && mallocFatals)
 	{
-		pop 	eax
+		memCoreLeft = totalCoreLeft();
+		memTotalLeft = coreLeft();
+		walkHeap(TRUE, false);
+		if (memSize)
+			STOP(("Heap %s is Out Of RAM.  HeapSize %d, CoreLeft %d, TotalLeft %d, "
+				  "SizeTried %d",
+				heapName, heapSize, memCoreLeft, memTotalLeft, memSize));
+		else
+			STOP(("Heap %s Tried to Malloc Zero Bytes!", heapName));
 	}
 #endif
-	__asm {mov result, eax} firstNearBlock = localFirst;
+	if (heapTracing)
+		traceMalloc(result, memSize);
 #ifdef _DEBUG
 	if (logMallocs)
 	{
@@ -924,10 +540,13 @@ Alloc_Done:
 }
 
 //---------------------------------------------------------------------------
-int32_t UserHeap::Free(PVOIDmemBlock)
+int32_t
+UserHeap::Free(PVOID memBlock)
 {
 	if (gosHeap)
 	{
+		if (heapTracing)
+			traceFree(memBlock);
 		gos_PushCurrentHeap(gosHeap);
 		gos_Free(memBlock);
 #ifdef _GAMEOS_HPP_
@@ -936,9 +555,7 @@ int32_t UserHeap::Free(PVOIDmemBlock)
 
 		return 0;
 	}
-	HeapBlockPtr blockOffs = (HeapBlockPtr)memBlock;
-	int32_t result = 0;
-	HeapBlockPtr sortBlock = nullptr;
+	int32_t result = NO_ERROR;
 	//------------------------------------------
 	// If freeing a nullptr, we do nothing
 	//------------------------------------------
@@ -954,215 +571,28 @@ int32_t UserHeap::Free(PVOIDmemBlock)
 #endif
 		return (NO_ERROR);
 	}
-	__asm
-		{
-		cmp		blockOffs, 0
-		je		Dealloc_Done
-
-		sub		blockOffs, 8 // compensate for heading
-
-#ifdef _DEBUG
-		sub		blockOffs, 4 // extra return pointer
-#endif
-
-		}
-	// merge this block with lower one if possible
-	int32_t mergeResult = mergeWithLower(blockOffs);
-	__asm
+	if (heapTracing)
+		traceFree(memBlock);
+	//-------------------------------------------------------------------
+	// A tagged block's header is in front of its tag.  The mark comes
+	// off, so the block doesn't look tagged from a thread cache.
+	PVOID heapBlock = memBlock;
+	HeapTag* tag = (HeapTag*)((uint8_t*)memBlock - HEAP_TAG_SIZE);
+	if (((uint8_t*)tag >= getHeapPtr()) && (tag->tagMark == HEAP_TAG_MARK))
 	{
-		mov 	eax, mergeResult
-
-#ifdef SAFE_HEAP
-		or		eax, eax // return 0 on error
-		je      Dealloc_Done
-#endif
-
-				// if block above is "free", add our size to it. no relinking is
-				// needed
-
-		mov     ebx, [blockOffs]
-		mov     edi, [ebx].upperBlock
-		or	    edi, edi
-		je	    int16_t Relink_needed // no block above this one
-
-		test    [edi].blockSize, 1
-		jne     int16_t Relink_needed // block above is allocated
-
-			// else just add size
-
-		mov     eax, [ebx].blockSize
-		and		eax, 0xfffffffe // NOT 1
-		add     [edi].blockSize, eax // add to size of above block
-
-			// inform new lower neighbor about the change
-
-		mov		ebx, edi
-		add		ebx, [edi].blockSize
-		mov		[ebx].upperBlock, edi
-
-#ifdef USE_BEST_FIT
-		mov		ebx, edi
+		tag->tagMark = 0;
+		heapBlock = tag;
 	}
-	//-------------------------------------------------------------------------------------
-	// SORT Routine
-	__asm {pushad} //-------------------------------------
-	// see if we have to do any work at all
-	HeapBlockPtr localFirstSort = firstNearBlock;
-	__asm
-		{
-		mov		edx, localFirstSort
-		mov		ecx, [ebx].blockSize
-		mov		edi, [ebx].next
-
-		cmp		edi, [ebx].previous
-		jne		int16_t __Line1 // either 1 or two members in list
-		cmp		edi, ebx
-		je		__Done // only one member in list
-
-					// else there are only two
-
-		mov		localFirstSort, ebx // assume we are the smaller block
-		cmp		ecx, [edi].blockSize
-		jbe		__Done // we were right
-		mov		localFirstSort, edi // else other guy is smaller
-		jmp		__Done
-		}
-__Line1: // else see if we are not in the correct order
-	__asm
-		{
-		cmp		ecx, [edi].blockSize
-		jbe		int16_t __Line2
-
-						 // else see if next guy in line is the localFirst
-
-		cmp		edi, edx // did we just compare with Beginning of list?
-		jne		int16_t __Line3 // no
-		}
-__Line2:
-	__asm {
-		mov		edi, [ebx].previous
-		cmp	    ecx, [edi].blockSize
-		jae		int16_t __Done
-
-				// else we are less than guy to our left
-
-		cmp		ebx, edx // are we the first block in list?
-		je		int16_t __Done
-
-		__Line3: // else we must unlink our block, saving a pointer to lower
-			// neighbor
-
-		push	edi
-		push	ebx
-
-					// Unlink Routine inline here
-
-		cmp		[ebx].next, ebx
-		jne		int16_t _ULine1
-
-				// else list is now empty
-
-		mov		localFirstSort, 0
-		jmp		int16_t _ULine3
-	}
-_ULine1:
-	__asm
-		{
-		mov     edx, localFirstSort
-		cmp     ebx, edx
-		jne     int16_t _ULine2 // unlinking first element?
-		mov     eax, [ebx].next
-		mov     localFirstSort, eax
-		}
-_ULine2:
-	__asm
-		{
-		mov		edi, [ebx].next // edi = ebx.next
-		mov		ebx, [ebx].previous
-		mov		[edi].previous, ebx // ebx.next.prev = ebx.prev
-		mov		[ebx].next, edi // ebx.prev.next = ebx.next
-		}
-_ULine3:
-	__asm
-		{
-			// ecx = unchanged, the size of our block
-		pop		ebx // ebx -> our block we have just unlinked.
-		pop		edi // edi -> block to start our search on.
-
-		mov 	edx, localFirstSort
-
-		cmp		[ebx].previous, edi
-		je		int16_t __Line4 // search previous nodes
-		}
-// stop when guy to the right is higher than us, or is the FirstMemBlock
-__Loop1:
-	__asm
-		{
-		mov		esi, edi
-		mov		edi, [edi].next
-		cmp		edi, edx // have we wrapped around?
-		je		int16_t __FoundPlace
-		cmp		[edi].blockSize, ecx
-		jae		int16_t __FoundPlace
-		jmp		__Loop1
-		}
-__Line4:
-// stop when guy to the left is lower than us, or we stopped on the
-// FirstMemBlock
-__Loop2:
-	__asm
-		{
-		mov		esi, edi
-		mov		edi, [edi].previous
-		cmp		esi, edx // have we wrapped around?
-		je		int16_t __Line5
-		cmp		[edi].blockSize, ecx
-		ja		__Loop2
-		}
-__Line5:
-	__asm
-		{
-		xchg		esi, edi
-		}
-__FoundPlace: // esi-> first block, edi->second block, ebx -> us
-	// ebx = offset of new block
-	__asm
-		{
-		mov		[ebx].previous, esi
-		mov		[ebx].next, edi
-		mov		[esi].next, ebx
-		mov		[edi].previous, ebx
-
-		mov		edi, edx
-		cmp		ecx, [edi].blockSize // see if we are now smallest
-		jae		int16_t __Done
-		mov		localFirstSort, ebx // we are smallest
-		}
-__Done:
-	firstNearBlock = localFirstSort;
-	//-------------------------------------------------------------------------------------
-	// SORT Routine
-	__asm
+	if (!blocks.Free(heapBlock))
 	{
-		POPAD
-	}
-	__asm {
-#endif
-		jmp     int16_t Dealloc_Done
-	}
-	Relink_needed : __asm
-					{
-		mov     ebx, [blockOffs]
-		and		[ebx].blockSize, 0xfffffffe // NOT 1
-		mov		sortBlock, ebx
-					} relink(sortBlock);
-Dealloc_Done:
-#ifdef HEAP_CHECK
-	walkHeap(false, FALSE, " Free Heap Ck ");
+		//---------------------------------------------------
+		// Not a block this heap has out.  Walk it to see if
+		// it's the pointer or the heap that has gone bad.
+#ifdef SAFE_HEAP
+		walkHeap(false, false);
+		PAUSE(("Heap %s was asked to free %08X, which it doesn't have out.", heapName, memBlock));
 #endif
-	__asm
-	{
-		mov		result, eax
+		result = BAD_FREED_PTR;
 	}
 #ifdef _DEBUG
 	if (logMallocs)
@@ -1185,8 +615,9 @@ Dealloc_Done:
 PVOID
 UserHeap::calloc(uint32_t memSize)
 {
-	PVOID result = malloc(memSize);
-	memset(result, 0, memSize);
+	PVOID result = Malloc(memSize, HEAP_CALLER());
+	if (result)
+		memset(result, 0, memSize);
 	return result;
 }
 
@@ -1199,59 +630,30 @@ UserHeap::walkHeap(bool printIt, bool skipAllocated)
 		gos_WalkMemoryHeap(gosHeap);
 		return;
 	}
-	HeapBlockPtr walker = heapStart;
-	bool valid, allocated;
-	uint32_t bSize;
+	HeapBlockPtr walker = blocks.firstBlock();
+	bool allocated;
 	if (!walker || (heapState != NO_ERROR))
 		return;
 #ifdef _DEBUG
 	MechFile logFile;
 	logFile.create("walkdump.log");
 #endif
-	while (walker->blockSize != 1)
+	for (; walker; walker = blocks.nextBlock(walker))
 	{
 		//--------------------
 		// check for validity
 		//--------------------
-		valid = TRUE;
-		if (walker->upperBlock)
-		{
-			bSize = (walker->upperBlock->blockSize & ~1);
-			bSize += (uint32_t)walker->upperBlock;
-			valid = (bSize == (uint32_t)walker);
-		}
-		if (valid)
-		{
-			bSize = (uint32_t)walker + (walker->blockSize & ~1);
-			valid = (HeapBlockPtr(bSize)->upperBlock == walker);
-		}
-		else
+		switch (blocks.checkBlock(walker))
 		{
-			//--------------------------
-			//	Failed upper block check
-			//--------------------------
+		case HEAP_BLOCK_BAD_UPPER:
 			heapState = HEAP_CORRUPTED;
 			STOP(("Heap %s Upper Block Check Failed", heapName));
 			return;
-		}
-		if (valid && !(walker->blockSize & 1)) // if free block
-		{
-			valid = ((walker->previous->next == walker) && (walker->next->previous == walker));
-		}
-		else if (!valid)
-		{
-			//--------------------------
-			// Failed lower block check
-			//--------------------------
+		case HEAP_BLOCK_BAD_LOWER:
 			heapState = HEAP_CORRUPTED;
 			STOP(("Heap %s Lower Block Check Failed", heapName));
 			return;
-		}
-		if (!valid)
-		{
-			//--------------------------
-			//	Failed linked list check
-			//--------------------------
+		case HEAP_BLOCK_BAD_LINKS:
 			heapState = HEAP_CORRUPTED;
 			STOP(("Heap %s LinkedList Check Failed", heapName));
 			return;
@@ -1260,40 +662,16 @@ UserHeap::walkHeap(bool printIt, bool skipAllocated)
 		if ((printIt && !allocated) || (printIt && !skipAllocated))
 		{
 			wchar_t errMessage[256];
-#ifdef _DEBUG
-			if (allocated)
-			{
-				sprintf(errMessage, "Allocated block at DS:%08X, size = %u, owner at CS:%08X\n",
-					walker, (walker->blockSize & ~1), walker->previous);
-				//--------------------------------------------------------------------------------------------
-				// A size and/or address check can be put here to inspect the
-				// block and determine other info
-				int32_t magicNumber = 0x6726FB;
-				if ((walker->previous) == (PVOID)magicNumber)
-					printf("magicNumber");
-				//--------------------------------------------------------------------------------------------
-			}
-			else
-			{
-				sprintf(errMessage, "Free block at DS:%08X, size = %u \n", walker,
-					(walker->blockSize & ~1));
-			}
-#ifndef _CONSOLE
-			logFile.writeLine(errMessage);
-#else
-			printf(errMessage);
-#endif
-#else
 			sprintf(errMessage, "%s block at DS:%08X, size = %u \n",
 				(allocated) ? "Allocated" : "Free", walker, (walker->blockSize & ~1));
-#ifndef _CONSOLE
-			OutputDebugString(errMessage);
-#else
+#ifdef _CONSOLE
 			printf(errMessage);
-#endif
+#elif defined(_DEBUG)
+			logFile.writeLine(errMessage);
+#else
+			OutputDebugString(errMessage);
 #endif
 		}
-		walker = HeapBlockPtr((uint32_t)walker + (walker->blockSize & ~1));
 	}
 }
 
@@ -1304,189 +682,274 @@ UserHeap::getLastError(void)
 	return heapState;
 }
 
+//---------------------------------------------------------------------------
+HeapStats
+UserHeap::getStatistics(void)
+{
+	if (gosHeap)
+	{
+		HeapStats noStats;
+		memset(&noStats, 0, sizeof(noStats));
+		return (noStats);
+	}
+	return (blocks.getStatistics());
+}
+
 //---------------------------------------------------------------------------
 void
-UserHeap::relink(HeapBlockPtr newBlock)
+UserHeap::setThreadCaches(bool useCaches)
 {
-	HeapBlockPtr localFirst = firstNearBlock;
-	// empty list?
-	__asm
-		{
-		mov		ebx, newBlock
-		cmp		localFirst, 0
-		jne		int16_t Line1
+	if (!gosHeap)
+		blocks.setThreadCaches(useCaches);
+}
 
-												  // else this is the only block in the list
+//---------------------------------------------------------------------------
+// Allocation tags.  Each thread remembers the callsite ids it looked up
+// last, so most tagged mallocs don't take the lock.
+static uint16_t
+heapCallsiteId(PVOID returnAddress)
+{
+	uintptr_t address = (uintptr_t)returnAddress;
+	HeapCallsiteCache& cached =
+		heapCallsiteCache[(address ^ (address >> 8)) & (HEAP_CALLSITE_CACHE - 1)];
+	if (cached.address == address)
+		return (cached.id);
+	std::lock_guard<std::mutex> lock(heapCallsiteLock);
+	if (heapCallsites.empty())
+		heapCallsites.push_back(0);
+	uint16_t id = 0;
+	auto found = heapCallsiteIds.find(address);
+	if (found != heapCallsiteIds.end())
+		id = found->second;
+	else if (heapCallsites.size() < MAX_HEAP_CALLSITES)
+	{
+		id = (uint16_t)heapCallsites.size();
+		heapCallsites.push_back(address);
+		heapCallsiteIds[address] = id;
+	}
+	cached.address = address;
+	cached.id = id;
+	return (id);
+}
 
-		mov     localFirst, ebx
-		mov     [ebx].previous, ebx
-		mov     [ebx].next, ebx
-		jmp     int16_t Line2
-		}
-Line1:
-	__asm
-		{// ebx = address of new block
-		mov     edi, localFirst
-
-#ifdef USE_BEST_FIT
-		mov		edx, edi
-		mov		ecx, [ebx].blockSize
-		cmp		ecx, [edi].blockSize
-		jae		int16_t Line3
-		mov		localFirst, ebx
-		jmp		int16_t Line4
-		}
-Line3:
-	__asm
-		{
-		mov		edi, [edi].next
-		cmp		edi, edx
-		je		int16_t Line4
-		cmp		ecx, [edi].blockSize
-		ja		Line3
-		}
-Line4:
-	__asm
-		{
-		mov		edi, [edi].previous
-#endif
+//---------------------------------------------------------------------------
+static uintptr_t
+heapCallsiteAddress(uint16_t callsite)
+{
+	std::lock_guard<std::mutex> lock(heapCallsiteLock);
+	if (callsite < heapCallsites.size())
+		return (heapCallsites[callsite]);
+	return (0);
+}
 
-		mov		eax, [edi].next
-		mov		[ebx].next, eax
-		mov		[ebx].previous, edi
-		mov		[edi].next, ebx
-		mov		edi, [ebx].next
-		mov		[edi].previous, ebx
-		}
-Line2:
-	firstNearBlock = localFirst;
+//---------------------------------------------------------------------------
+static void
+heapCallsiteText(uint8_t subsystem, uint16_t callsite, wchar_t* text)
+{
+	uintptr_t address = 0;
+	if (subsystem != HEAP_TAG_ALL)
+		address = heapCallsiteAddress(callsite);
+	if (address)
+		sprintf(text, "%p", (PVOID)address);
+	else if (subsystem != HEAP_TAG_ALL)
+		strcpy(text, "Other");
+	else
+		text[0] = 0;
 }
 
 //---------------------------------------------------------------------------
-void
-UserHeap::unlink(HeapBlockPtr oldBlock)
+static const wchar_t*
+heapTagName(uint8_t subsystem)
 {
-	HeapBlockPtr localFirst = firstNearBlock;
-	__asm
-		{
-		mov 	ebx, oldBlock
-		cmp		[ebx].next, ebx
-		jne		int16_t ULine1
+	if (subsystem == HEAP_TAG_ALL)
+		return ("All");
+	if (subsystem < NUM_HEAP_TAG_SUBSYSTEMS)
+		return (heapTagNames[subsystem]);
+	return ("Unknown");
+}
 
-												 // else list is now empty
+//---------------------------------------------------------------------------
+// Epoch 0 is everything made before the first mission.
+static void
+nextHeapTagEpoch(void)
+{
+	uint8_t epoch = heapTagEpoch + 1;
+	heapTagEpoch = epoch ? epoch : 1;
+}
 
-		mov		localFirst, 0
-		jmp		int16_t ULine3
-		}
-ULine1:
-	__asm
-		{
-		mov     edx, localFirst
-		cmp     ebx, edx
-		jne     int16_t ULine2 // unlinking first element?
-		mov     eax, [ebx].next
-		mov     localFirst, eax
-		}
-ULine2:
-	__asm
-		{
-		mov		edi, [ebx].next // edi = ebx.next
-		mov		ebx, [ebx].previous
-		mov		[edi].previous, ebx // ebx.next.prev = ebx.prev
-		mov		[ebx].next, edi // ebx.prev.next = ebx.next
-		}
-ULine3:
-	firstNearBlock = localFirst;
+//---------------------------------------------------------------------------
+HeapTagScope::HeapTagScope(uint8_t subsystem)
+{
+	previous = heapTagSubsystem;
+	heapTagSubsystem = subsystem;
 }
 
 //---------------------------------------------------------------------------
-bool
-UserHeap::mergeWithLower(HeapBlockPtr block)
+HeapTagScope::~HeapTagScope(void)
+{
+	heapTagSubsystem = previous;
+}
+
+//---------------------------------------------------------------------------
+PVOID
+UserHeap::tagBlock(PVOID memBlock, PVOID returnAddress)
 {
-	HeapBlockPtr localFirst = firstNearBlock;
-	bool result = FALSE;
-	__asm
+	HeapTag* tag = (HeapTag*)memBlock;
+	tag->tagMark = HEAP_TAG_MARK;
+	tag->callsite = heapCallsiteId(returnAddress);
+	tag->subsystem = heapTagSubsystem;
+	tag->epoch = heapTagEpoch.load(std::memory_order_relaxed);
+	return ((uint8_t*)memBlock + HEAP_TAG_SIZE);
+}
+
+//---------------------------------------------------------------------------
+void
+UserHeap::addTagTotals(std::vector<HeapTagTotal>& totals, uint16_t heapNumber, int32_t epoch)
+{
+	if (gosHeap || !heapSize)
+		return;
+	std::unordered_map<uint32_t, size_t> found; // subsystem and callsite, to its total
+	for (HeapBlockPtr walker = blocks.firstBlock(); walker; walker = blocks.nextBlock(walker))
 	{
-		mov     edi, block
-		mov     ebx, [edi].blockSize
+		if (!(walker->blockSize & 1))
+			continue;
+		HeapTag* tag = (HeapTag*)((uint8_t*)walker + HEAP_HEADER_SIZE);
+		if ((tag->tagMark != HEAP_TAG_MARK) || ((epoch >= 0) && (tag->epoch != epoch)))
+			continue;
+		uint32_t key = ((uint32_t)tag->subsystem << 16) | tag->callsite;
+		auto total = found.find(key);
+		if (total == found.end())
+		{
+			HeapTagTotal newTotal;
+			newTotal.heap = heapNumber;
+			newTotal.callsite = tag->callsite;
+			newTotal.subsystem = tag->subsystem;
+			newTotal.blocks = 0;
+			newTotal.bytes = 0;
+			total = found.emplace(key, totals.size()).first;
+			totals.push_back(newTotal);
+		}
+		totals[total->second].blocks++;
+		totals[total->second].bytes += (uint32_t)(walker->blockSize & ~1);
 	}
-#ifdef SAFE_HEAP
-	__asm {test ebx,
-		1 je int16_t Fatal1 // else failed alloc check
-			cmp[edi + ebx - 1]
-				.upperBlock,
-		edi jne int16_t Fatal1 // else failed lower check
-			mov esi,
-		[edi].upperBlock or esi, esi je int16_t check_ok add esi, [esi].blockSize and esi,
-		0xfffffffe // NOT 1
-		cmp esi,
-		edi je int16_t check_ok} Fatal1 : walkHeap(FALSE, FALSE);
-	// Fatal(HEAP_CORRUPTED);
-	__asm
-		{
-		xor		eax, eax // In theory, this will never execute since the Fatal Exits
-		jmp		DoneML // Maybe if Fatal is not operating?
-		}
-check_ok:
-#endif
-	__asm {
-		and     ebx, 0xfffffffe // NOT 1					//make size be acurate
-		mov     esi, ebx
-		add     esi, edi // esi = offset of lower neighbor
-		mov     ecx, [esi].blockSize
-		test    ecx, 1
-		jne     int16_t NoMerge // lower block is allocated
-		add     ebx, ecx // ebx = new size of block
-		mov     [edi].blockSize, ebx
-		or		[edi].blockSize, 1 // dealloc() expects allocated block
-		mov		eax, edi
-		add		ebx, eax // ebx -> new lower neigbor
-		mov		[ebx].upperBlock, edi // inform new neighbor about the change
-		mov     ebx, esi // ebx = offset of old lower neighbor
+}
+
+//---------------------------------------------------------------------------
+// Allocation trace.  Records are gathered up and written a buffer at a
+// time.  The trace file itself allocates from the system heap when it is
+// opened and closed, so that happens with the trace off.
+static void
+heapTraceWrite(const void* data, size_t size)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	heapTraceBuffer.insert(heapTraceBuffer.end(), bytes, bytes + size);
+	if (heapTraceBuffer.size() >= HEAP_TRACE_BUFFER_SIZE)
+	{
+		heapTraceFile->write(heapTraceBuffer.data(), heapTraceBuffer.size());
+		heapTraceBuffer.clear();
 	}
-	// This is the UNLINK routine directly.
-	__asm
-		{
-		cmp		[ebx].next, ebx
-		jne		int16_t ULine1
+}
 
-							   //else list is now empty
+//---------------------------------------------------------------------------
+bool
+UserHeapTraceStart(const std::wstring_view& fileName)
+{
+	UserHeapTraceStop();
+	MechFile* traceFile = new MechFile;
+	if (traceFile->create(fileName) != NO_ERROR)
+	{
+		delete traceFile;
+		return (false);
+	}
+	std::lock_guard<std::mutex> lock(heapTraceLock);
+	heapTraceFile = traceFile;
+	heapTraceBuffer.clear();
+	heapTraceBuffer.reserve(HEAP_TRACE_BUFFER_SIZE + sizeof(HeapTraceRecord) + HEAP_TRACE_NAME_LENGTH);
+	heapTraceIds.clear();
+	heapTraceNextId = 0;
+	heapTraceNumHeaps = 0;
+	heapTraceGeneration++;
+	uint32_t version = HEAP_TRACE_VERSION;
+	heapTraceWrite("MC2HEAPT", 8);
+	heapTraceWrite(&version, sizeof(version));
+	heapTracing = true;
+	return (true);
+}
 
-		mov     localFirst, 0
-		jmp     int16_t ULine3
-		}
-	ULine1 :
-		__asm
-		{
-		mov     edx, localFirst
-		cmp     ebx, edx
-		jne     int16_t ULine2 //unlinking first element?
-		mov     eax, [ebx].next
-		mov     localFirst, eax
-		}
-		ULine2 :
-		__asm
-		{
-		mov		edi, [ebx].next //edi = bx.next
-		mov		ebx, [ebx].previous
-		mov		[edi].previous, ebx //ebx.next.prev = ebx.prev
-		mov		[ebx].next, edi //ebx.prev.next = bx.next
-		}
-		ULine3 :
-		NoMerge :
-		__asm
+//---------------------------------------------------------------------------
+void
+UserHeapTraceStop(void)
+{
+	MechFile* traceFile = nullptr;
 	{
-		mov		eax, 1 // Return TRUE
+		std::lock_guard<std::mutex> lock(heapTraceLock);
+		if (!heapTraceFile)
+			return;
+		heapTracing = false;
+		if (heapTraceBuffer.size())
+			heapTraceFile->write(heapTraceBuffer.data(), heapTraceBuffer.size());
+		heapTraceBuffer.clear();
+		heapTraceIds.clear();
+		traceFile = heapTraceFile;
+		heapTraceFile = nullptr;
 	}
-#ifdef SAFE_HEAP
-DoneML:
-#endif
-	__asm
-		{
-		mov		result, al // Move eax into result
-		}
-	firstNearBlock = localFirst;
-	return (result);
+	traceFile->close();
+	delete traceFile;
+}
+
+//---------------------------------------------------------------------------
+void
+UserHeap::traceMalloc(PVOID memBlock, size_t memSize)
+{
+	if (!memBlock)
+		return;
+	std::lock_guard<std::mutex> lock(heapTraceLock);
+	if (!heapTracing)
+		return;
+	HeapTraceRecord record;
+	if ((traceHeap < 0) || (traceGeneration != heapTraceGeneration))
+	{
+		//-----------------------------------------------
+		// First time this heap shows up in this trace.
+		// GOS heaps have no size of their own.
+		traceHeap = heapTraceNumHeaps++;
+		traceGeneration = heapTraceGeneration;
+		record.op = HEAP_TRACE_HEAP;
+		record.heap = (uint16_t)traceHeap;
+		record.id = 0;
+		record.size = (uint32_t)heapSize;
+		char name[HEAP_TRACE_NAME_LENGTH];
+		memset(name, 0, sizeof(name));
+		if (heapName)
+			strncpy(name, heapName, HEAP_TRACE_NAME_LENGTH - 1);
+		heapTraceWrite(&record, sizeof(record));
+		heapTraceWrite(name, HEAP_TRACE_NAME_LENGTH);
+	}
+	record.op = HEAP_TRACE_MALLOC;
+	record.heap = (uint16_t)traceHeap;
+	record.id = heapTraceNextId++;
+	record.size = (uint32_t)memSize;
+	heapTraceIds[memBlock] = record.id;
+	heapTraceWrite(&record, sizeof(record));
+}
+
+//---------------------------------------------------------------------------
+void
+UserHeap::traceFree(PVOID memBlock)
+{
+	std::lock_guard<std::mutex> lock(heapTraceLock);
+	if (!heapTracing || (traceHeap < 0) || (traceGeneration != heapTraceGeneration))
+		return;
+	auto id = heapTraceIds.find(memBlock);
+	if (id == heapTraceIds.end())
+		return; // out before the trace started
+	HeapTraceRecord record;
+	record.op = HEAP_TRACE_FREE;
+	record.heap = (uint16_t)traceHeap;
+	record.id = id->second;
+	record.size = 0;
+	heapTraceIds.erase(id);
+	heapTraceWrite(&record, sizeof(record));
 }
 
 //---------------------------------------------------------------------------
@@ -1547,6 +1010,18 @@ HeapList::initializeStatistics()
 			sprintf(heapString, "Heap %d - CoreLeft", i);
 			AddStatistic(heapString, "bytes", gos_DWORD, &(heapRecords[i].coreLeft),
 				Stat_AutoReset | Stat_Total);
+			sprintf(heapString, "Heap %d - Mallocs", i);
+			AddStatistic(heapString, "blocks", gos_DWORD, &(heapRecords[i].numMallocs),
+				Stat_AutoReset | Stat_Total);
+			sprintf(heapString, "Heap %d - Frees", i);
+			AddStatistic(heapString, "blocks", gos_DWORD, &(heapRecords[i].numFrees),
+				Stat_AutoReset | Stat_Total);
+			sprintf(heapString, "Heap %d - InUse", i);
+			AddStatistic(heapString, "bytes", gos_DWORD, &(heapRecords[i].bytesInUse),
+				Stat_AutoReset | Stat_Total);
+			sprintf(heapString, "Heap %d - PeakInUse", i);
+			AddStatistic(heapString, "bytes", gos_DWORD, &(heapRecords[i].peakBytesInUse),
+				Stat_AutoReset | Stat_Total);
 			StatisticFormat("");
 		}
 		heapInstrumented = true;
@@ -1568,6 +1043,11 @@ HeapList::update(void)
 			totalLeft += heapRecords[i].coreLeft;
 			heapRecords[i].totalCoreLeft = ((UserHeapPtr)heapRecords[i].thisHeap)->totalCoreLeft();
 			totalCoreLeft += heapRecords[i].totalCoreLeft;
+			HeapStats heapStats = ((UserHeapPtr)heapRecords[i].thisHeap)->getStatistics();
+			heapRecords[i].numMallocs = heapStats.numMallocs;
+			heapRecords[i].numFrees = heapStats.numFrees;
+			heapRecords[i].bytesInUse = heapStats.bytesInUse;
+			heapRecords[i].peakBytesInUse = heapStats.peakBytesInUse;
 		}
 		else if (heapRecords[i].thisHeap)
 		{
@@ -1575,6 +1055,8 @@ HeapList::update(void)
 			totalSize += heapRecords[i].heapSize;
 			heapRecords[i].coreLeft = 0;
 			heapRecords[i].totalCoreLeft = 0;
+			heapRecords[i].numMallocs = heapRecords[i].numFrees = 0;
+			heapRecords[i].bytesInUse = heapRecords[i].peakBytesInUse = 0;
 		}
 	}
 }
@@ -1626,17 +1108,20 @@ longToText(const std::wstring_view& result, int32_t num, uint32_t bufLen)
 
 //--------------------------------------------------------------------------
 int32_t
-getStringFromMap(MechFile& mapFile, uint32_t addr, const std::wstring_view& result)
+getStringFromMap(MechFile& mapFile, uintptr_t addr, const std::wstring_view& result)
 {
 	//----------------------------------------
-	// Convert function address to raw offset
-#ifdef TERRAINEDIT
-	uint32_t offsetAdd = 0x00601000;
+	// Convert function address to raw offset.
+	// x64 images load wherever they're put, so
+	// the code starts a page into this one.
+#if defined(_WIN64)
+	uintptr_t offsetAdd = (uintptr_t)GetModuleHandle(nullptr) + 0x1000;
+#elif defined(TERRAINEDIT)
+	uintptr_t offsetAdd = 0x00601000;
 #else
-	uint32_t offsetAdd = 0x00601000;
+	uintptr_t offsetAdd = 0x00601000;
 #endif
-	uint32_t function = addr;
-	function -= offsetAdd;
+	uint32_t function = (uint32_t)(addr - offsetAdd);
 	wchar_t actualAddr[10];
 	longToText(actualAddr, function, 9);
 	//------------------------------------
@@ -1704,8 +1189,8 @@ HeapList::dumpLog(void)
 		currentHeap = heapRecords[i].thisHeap;
 		if (currentHeap)
 		{
-			sprintf(msg, "ListNo: %d     Heap: %d     Type: %d     Made by: %08X", i, heapNumber,
-				currentHeap->heapType(), currentHeap->owner());
+			sprintf(msg, "ListNo: %d     Heap: %d     Type: %d     Made by: %p", i, heapNumber,
+				currentHeap->heapType(), (PVOID)currentHeap->owner());
 			logFile.writeLine(msg);
 			if (mapResult == NO_ERROR)
 			{
@@ -1723,6 +1208,15 @@ HeapList::dumpLog(void)
 			if (currentHeap->heapType() == 1)
 			{
 				UserHeapPtr userHeap = (UserHeapPtr)currentHeap;
+				HeapStats heapStats = userHeap->getStatistics();
+				sprintf(msg, "Name: %s     Mallocs: %d     Frees: %d     Failed: %d     CacheHits: %d",
+					userHeap->getHeapName() ? userHeap->getHeapName() : "", heapStats.numMallocs,
+					heapStats.numFrees, heapStats.numFailedMallocs, heapStats.numCacheHits);
+				logFile.writeLine(msg);
+				sprintf(msg, "Blocks: %d     InUse: %d     PeakInUse: %d     FreeBlocks: %d",
+					heapStats.blocksInUse, heapStats.bytesInUse, heapStats.peakBytesInUse,
+					heapStats.numFreeBlocks);
+				logFile.writeLine(msg);
 				sprintf(msg, "TotalCoreLeft: %d     CoreLeft: %d", userHeap->totalCoreLeft(),
 					userHeap->coreLeft());
 				logFile.writeLine(msg);
@@ -1751,6 +1245,336 @@ HeapList::dumpLog(void)
 	logFile.close();
 }
 
+//---------------------------------------------------------------------------
+// Heap telemetry.
+void
+HeapList::takeSnapshot(HeapSnapshot& snapshot, int32_t epoch)
+{
+	snapshot.number = 0;
+	snapshot.time = timeGetTime() - heapTelemetryStart;
+	snapshot.heaps.clear();
+	snapshot.totals.clear();
+	for (size_t i = 0; i < MAX_HEAPS; i++)
+	{
+		if (!heapRecords[i].thisHeap || (heapRecords[i].thisHeap->heapType() != USER_HEAP))
+			continue;
+		UserHeapPtr userHeap = (UserHeapPtr)heapRecords[i].thisHeap;
+		HeapStats heapStats = userHeap->getStatistics();
+		HeapSnapshotHeap heap;
+		memset(&heap, 0, sizeof(heap));
+		if (userHeap->getHeapName())
+			strncpy(heap.name, userHeap->getHeapName(), HEAP_TRACE_NAME_LENGTH - 1);
+		else
+			sprintf(heap.name, "Heap%d", i);
+		heap.heapSize = (uint32_t)userHeap->size();
+		heap.blocksInUse = heapStats.blocksInUse;
+		heap.bytesInUse = heapStats.bytesInUse;
+		heap.peakBytesInUse = heapStats.peakBytesInUse;
+		heap.coreLeft = userHeap->totalCoreLeft();
+		uint16_t heapNumber = (uint16_t)snapshot.heaps.size();
+		snapshot.heaps.push_back(heap);
+		if (epoch < 0)
+		{
+			HeapTagTotal all;
+			all.heap = heapNumber;
+			all.callsite = 0;
+			all.subsystem = HEAP_TAG_ALL;
+			all.blocks = heapStats.blocksInUse;
+			all.bytes = heapStats.bytesInUse;
+			snapshot.totals.push_back(all);
+		}
+		userHeap->addTagTotals(snapshot.totals, heapNumber, epoch);
+	}
+	std::sort(snapshot.totals.begin(), snapshot.totals.end(),
+		[](const HeapTagTotal& a, const HeapTagTotal& b) { return (a.bytes > b.bytes); });
+}
+
+//---------------------------------------------------------------------------
+// Heaps are matched by name, since mission heaps come and go between
+// snapshots.  What grew most comes first, what shrank most last.
+void
+HeapList::diffSnapshots(const HeapSnapshot& before, const HeapSnapshot& after, std::vector<HeapTagDelta>& deltas)
+{
+	deltas.clear();
+	std::vector<size_t> heapMatch(before.heaps.size());
+	for (size_t i = 0; i < before.heaps.size(); i++)
+	{
+		heapMatch[i] = after.heaps.size() + i; // not in after
+		for (size_t j = 0; j < after.heaps.size(); j++)
+			if (strcmp(before.heaps[i].name, after.heaps[j].name) == 0)
+			{
+				heapMatch[i] = j;
+				break;
+			}
+	}
+	auto key = [](size_t heap, const HeapTagTotal& total) {
+		return (((uint64_t)heap << 24) | ((uint64_t)total.subsystem << 16) | total.callsite);
+	};
+	std::unordered_map<uint64_t, size_t> found;
+	for (size_t i = 0; i < after.totals.size(); i++)
+	{
+		const HeapTagTotal& total = after.totals[i];
+		HeapTagDelta delta;
+		delta.heapName = after.heaps[total.heap].name;
+		delta.callsite = total.callsite;
+		delta.subsystem = total.subsystem;
+		delta.blocks = (int32_t)total.blocks;
+		delta.bytes = (int32_t)total.bytes;
+		found[key(total.heap, total)] = deltas.size();
+		deltas.push_back(delta);
+	}
+	for (size_t i = 0; i < before.totals.size(); i++)
+	{
+		const HeapTagTotal& total = before.totals[i];
+		auto match = found.find(key(heapMatch[total.heap], total));
+		if (match != found.end())
+		{
+			deltas[match->second].blocks -= (int32_t)total.blocks;
+			deltas[match->second].bytes -= (int32_t)total.bytes;
+			continue;
+		}
+		HeapTagDelta delta;
+		delta.heapName = before.heaps[total.heap].name;
+		delta.callsite = total.callsite;
+		delta.subsystem = total.subsystem;
+		delta.blocks = -(int32_t)total.blocks;
+		delta.bytes = -(int32_t)total.bytes;
+		deltas.push_back(delta);
+	}
+	deltas.erase(std::remove_if(deltas.begin(), deltas.end(),
+					 [](const HeapTagDelta& delta) { return (!delta.blocks && !delta.bytes); }),
+		deltas.end());
+	std::sort(deltas.begin(), deltas.end(),
+		[](const HeapTagDelta& a, const HeapTagDelta& b) { return (a.bytes > b.bytes); });
+}
+
+//---------------------------------------------------------------------------
+static void
+heapTelemetryAppend(const wchar_t* format, ...)
+{
+	wchar_t line[512];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(line, 511, format, args);
+	va_end(args);
+	line[511] = 0;
+	heapTelemetryText.insert(heapTelemetryText.end(), (uint8_t*)line, (uint8_t*)line + strlen(line));
+}
+
+//---------------------------------------------------------------------------
+// A snapshot goes to the file in one write.  CSV rows are snapshot, ms,
+// heap, subsystem, callsite, blocks, bytes; a heap's All row is the whole
+// heap, tagged or not.
+static void
+heapTelemetryWrite(const HeapSnapshot& snapshot)
+{
+	wchar_t callsite[32];
+	heapTelemetryText.clear();
+	if (heapTelemetryJSON)
+	{
+		heapTelemetryAppend("{\"snapshot\":%u,\"ms\":%u,\"heaps\":[", snapshot.number, snapshot.time);
+		for (size_t i = 0; i < snapshot.heaps.size(); i++)
+		{
+			const HeapSnapshotHeap& heap = snapshot.heaps[i];
+			heapTelemetryAppend("%s{\"name\":\"%s\",\"size\":%u,\"blocks\":%u,\"inUse\":%u,\"peak\":%u,\"free\":%u}",
+				i ? "," : "", heap.name, heap.heapSize, heap.blocksInUse, heap.bytesInUse,
+				heap.peakBytesInUse, heap.coreLeft);
+		}
+		heapTelemetryAppend("],\"tags\":[");
+		bool first = true;
+		for (size_t i = 0; i < snapshot.totals.size(); i++)
+		{
+			const HeapTagTotal& total = snapshot.totals[i];
+			if (total.subsystem == HEAP_TAG_ALL)
+				continue;
+			heapCallsiteText(total.subsystem, total.callsite, callsite);
+			heapTelemetryAppend("%s{\"heap\":\"%s\",\"subsystem\":\"%s\",\"callsite\":\"%s\",\"blocks\":%u,\"bytes\":%u}",
+				first ? "" : ",", snapshot.heaps[total.heap].name, heapTagName(total.subsystem),
+				callsite, total.blocks, total.bytes);
+			first = false;
+		}
+		heapTelemetryAppend("]}\r\n");
+	}
+	else
+	{
+		for (size_t i = 0; i < snapshot.totals.size(); i++)
+		{
+			const HeapTagTotal& total = snapshot.totals[i];
+			heapCallsiteText(total.subsystem, total.callsite, callsite);
+			heapTelemetryAppend("%u,%u,%s,%s,%s,%u,%u\r\n", snapshot.number, snapshot.time,
+				snapshot.heaps[total.heap].name, heapTagName(total.subsystem), callsite,
+				total.blocks, total.bytes);
+		}
+	}
+	heapTelemetryFile->write(heapTelemetryText.data(), heapTelemetryText.size());
+	heapTelemetryText.clear();
+}
+
+//---------------------------------------------------------------------------
+bool
+HeapList::startTelemetry(const std::wstring_view& fileName, uint32_t interval)
+{
+	stopTelemetry();
+	MechFile* telemetryFile = new MechFile;
+	if (telemetryFile->create(fileName) != NO_ERROR)
+	{
+		delete telemetryFile;
+		return (false);
+	}
+	size_t nameLength = strlen(fileName);
+	heapTelemetryJSON = (nameLength > 5) && (_stricmp(&(fileName[nameLength - 5]), ".json") == 0);
+	heapTelemetryFile = telemetryFile;
+	heapTelemetryInterval = interval;
+	heapTelemetryStart = timeGetTime();
+	heapTelemetryLast = heapTelemetryStart - interval; // first update takes one
+	heapTelemetryCount = 0;
+	if (!heapTelemetryJSON)
+		heapTelemetryFile->writeLine("snapshot,ms,heap,subsystem,callsite,blocks,bytes");
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+void
+HeapList::stopTelemetry(void)
+{
+	if (!heapTelemetryFile)
+		return;
+	//-----------------------------------------------
+	// The series ends with the heaps as they are at
+	// shutdown.
+	heapTelemetryLast = timeGetTime() - heapTelemetryInterval;
+	updateTelemetry();
+	heapTelemetryFile->close();
+	delete heapTelemetryFile;
+	heapTelemetryFile = nullptr;
+	heapTelemetryPrevious.heaps.clear();
+	heapTelemetryPrevious.totals.clear();
+}
+
+//---------------------------------------------------------------------------
+void
+HeapList::updateTelemetry(void)
+{
+	if (!heapTelemetryFile)
+		return;
+	uint32_t now = timeGetTime();
+	if ((now - heapTelemetryLast) < heapTelemetryInterval)
+		return;
+	heapTelemetryLast = now;
+	HeapSnapshot snapshot;
+	takeSnapshot(snapshot);
+	snapshot.number = heapTelemetryCount++;
+	heapTelemetryWrite(snapshot);
+	if (snapshot.number)
+	{
+		//-----------------------------------------------
+		// SPEW what grew most since the last snapshot.
+		std::vector<HeapTagDelta> deltas;
+		diffSnapshots(heapTelemetryPrevious, snapshot, deltas);
+		wchar_t callsite[32];
+		for (size_t i = 0; (i < deltas.size()) && (i < 3) && (deltas[i].bytes > 0); i++)
+		{
+			heapCallsiteText(deltas[i].subsystem, deltas[i].callsite, callsite);
+			SPEW((0, "Heap %s grew %d bytes, %d blocks, for %s %s\n", deltas[i].heapName,
+				deltas[i].bytes, deltas[i].blocks, heapTagName(deltas[i].subsystem), callsite));
+		}
+	}
+	heapTelemetryPrevious = std::move(snapshot);
+}
+
+//---------------------------------------------------------------------------
+void
+HeapList::markMission(void)
+{
+	if (!UserHeapTagging)
+		return;
+	nextHeapTagEpoch();
+	heapMissionNumber++;
+	takeSnapshot(heapMissionStart);
+}
+
+//---------------------------------------------------------------------------
+// Anything tagged in the mission's epoch that is still out once the
+// mission is torn down is a leak, or at least something that outlives it.
+// The report also lists how every heap grew over the mission.
+void
+HeapList::leakReport(void)
+{
+	if (!UserHeapTagging || heapMissionStart.heaps.empty())
+		return;
+	HeapSnapshot leaks;
+	takeSnapshot(leaks, heapTagEpoch);
+	HeapSnapshot missionEnd;
+	takeSnapshot(missionEnd);
+	std::vector<HeapTagDelta> growth;
+	diffSnapshots(heapMissionStart, missionEnd, growth);
+	heapMissionStart.heaps.clear();
+	heapMissionStart.totals.clear();
+	//-----------------------------------------------
+	// What's made from here on isn't the mission's.
+	nextHeapTagEpoch();
+	wchar_t fileName[64];
+	sprintf(fileName, "heapleaks%03d.log", heapMissionNumber);
+	MechFile logFile;
+	if (logFile.create(fileName) != NO_ERROR)
+		return;
+	MechFile mapFile;
+	int32_t mapResult = -1;
+#ifdef _DEBUG
+#ifdef TERRAINEDIT
+	mapResult = mapFile.open("teditor.map");
+#else
+	mapResult = mapFile.open("mechcmdrdbg.map");
+#endif
+#endif
+	wchar_t msg[1024];
+	wchar_t mapInfo[513];
+	wchar_t callsite[32];
+	uint32_t leakedBlocks = 0;
+	uint32_t leakedBytes = 0;
+	sprintf(msg, "Mission %d: blocks tagged during the mission still out after it", heapMissionNumber);
+	logFile.writeLine(msg);
+	sprintf(msg, "---------------------------");
+	logFile.writeLine(msg);
+	for (size_t i = 0; i < leaks.totals.size(); i++)
+	{
+		const HeapTagTotal& total = leaks.totals[i];
+		heapCallsiteText(total.subsystem, total.callsite, callsite);
+		sprintf(msg, "Heap: %s     Subsystem: %s     Callsite: %s     Blocks: %d     Bytes: %d",
+			leaks.heaps[total.heap].name, heapTagName(total.subsystem), callsite, total.blocks,
+			total.bytes);
+		logFile.writeLine(msg);
+		uintptr_t address = heapCallsiteAddress(total.callsite);
+		if ((mapResult == NO_ERROR) && address && getStringFromMap(mapFile, address, mapInfo))
+		{
+			sprintf(msg, "Made in Function : %s", mapInfo);
+			logFile.writeLine(msg);
+		}
+		leakedBlocks += total.blocks;
+		leakedBytes += total.bytes;
+	}
+	sprintf(msg, "Total Left: %d blocks     %d bytes", leakedBlocks, leakedBytes);
+	logFile.writeLine(msg);
+	sprintf(msg, "---------------------------");
+	logFile.writeLine(msg);
+	sprintf(msg, "Growth over the mission");
+	logFile.writeLine(msg);
+	sprintf(msg, "---------------------------");
+	logFile.writeLine(msg);
+	for (size_t i = 0; (i < growth.size()) && (i < HEAP_LEAK_REPORT_GROWTH); i++)
+	{
+		heapCallsiteText(growth[i].subsystem, growth[i].callsite, callsite);
+		sprintf(msg, "Heap: %s     Subsystem: %s     Callsite: %s     Blocks: %+d     Bytes: %+d",
+			growth[i].heapName, heapTagName(growth[i].subsystem), callsite, growth[i].blocks,
+			growth[i].bytes);
+		logFile.writeLine(msg);
+	}
+	logFile.close();
+	if (leakedBlocks)
+		SPEW((0, "Mission %d left %d tagged blocks, %d bytes, on the heaps.  See %s\n",
+			heapMissionNumber, leakedBlocks, leakedBytes, fileName));
+}
+
 bool UserHeap::pointerOnHeap(PVOIDptr)
 {
 	if (IsBadReadPtr(getHeapPtr(), totalSize))
@@ -19,9 +19,25 @@
 //#include <memory.h>
 ////#include "gameos.hpp"
 
+#ifndef SIZEHEAP_H
+#include "sizeheap.h"
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <vector>
+
 //---------------------------------------------------------------------------
 // Macro Definitions
 
+// Where the current function was called from, for tagging allocations.
+#ifdef _MSC_VER
+#define HEAP_CALLER() _ReturnAddress()
+#else
+#define HEAP_CALLER() __builtin_return_address(0)
+#endif
+
 #define OUT_OF_MEMORY 0xBADD0001
 #define ALLOC_ZERO 0xBADD0002
 #define ALLOC_OVERFLOW 0xBADD0003
@@ -32,11 +48,7 @@
 #define COULDNT_COMMIT 0xBADD0008
 #define COULDNT_CREATE 0xBADD0009
 
-#ifdef _DEBUG
-#define allocatedBlockSize 12
-#else
-#define allocatedBlockSize 8
-#endif
+#define allocatedBlockSize HEAP_HEADER_SIZE
 
 #define BASE_HEAP 0
 #define USER_HEAP 1
@@ -72,8 +84,105 @@ typedef struct _GlobalHeapRec
 	size_t heapSize;
 	uint32_t totalCoreLeft;
 	uint32_t coreLeft;
+	uint32_t numMallocs;
+	uint32_t numFrees;
+	uint32_t bytesInUse;
+	uint32_t peakBytesInUse;
 } GlobalHeapRec;
 
+//---------------------------------------------------------------------------
+// Allocation tags.  With UserHeapTagging on, every block a User Heap hands
+// out carries a HeapTag between its header and the caller's memory: the
+// subsystem the thread was working for (see HeapTagScope), a callsite id
+// for the return address that asked for it and the epoch it was made in.
+// HeapList::markMission starts a new epoch.  Tagging costs every block
+// HEAP_TAG_SIZE more, so heaps sized tight in system.cfg may need room.
+//
+// A tag starts with HEAP_TAG_MARK, which is even, where an untagged block
+// has its blockSize with the low bit set.  That is how Free tells them
+// apart, so tagging can be switched on and off at any time.
+#define HEAP_TAG_MARK ((size_t)0x4d433254) // "MC2T"
+#define HEAP_TAG_SIZE HEAP_HEADER_SIZE
+#define MAX_HEAP_CALLSITES 0x10000 // callsite 0 is every one past the last
+#define HEAP_TAG_ALL 0xff // snapshot row for a whole heap, tagged or not
+
+enum _heap_tag_subsystem : uint8_t
+{
+	HEAP_TAG_NONE,
+	HEAP_TAG_MISSION, // mission load, and anything in Mission::update not below
+	HEAP_TAG_INTERFACE,
+	HEAP_TAG_TERRAIN,
+	HEAP_TAG_OBJECTS,
+	HEAP_TAG_TEXTURES,
+	HEAP_TAG_SCRIPT,
+	HEAP_TAG_LOGISTICS,
+	HEAP_TAG_MULTIPLAYER,
+	HEAP_TAG_SOUND,
+	NUM_HEAP_TAG_SUBSYSTEMS
+};
+
+typedef struct _HeapTag
+{
+	size_t tagMark;
+	uint16_t callsite;
+	uint8_t subsystem;
+	uint8_t epoch;
+} HeapTag;
+
+static_assert(sizeof(HeapTag) <= HEAP_TAG_SIZE, "HeapTag must fit where a block header would");
+
+//---------------------------------------------------------------------------
+// Sets the subsystem this thread's allocations are tagged with until it
+// goes out of scope.
+class HeapTagScope
+{
+protected:
+	uint8_t previous;
+
+public:
+	HeapTagScope(uint8_t subsystem);
+	~HeapTagScope(void);
+};
+
+//---------------------------------------------------------------------------
+// Heap snapshots.  A HeapTagTotal adds up the blocks out on one heap for
+// one subsystem and callsite, or the whole heap for HEAP_TAG_ALL.
+typedef struct _HeapSnapshotHeap
+{
+	wchar_t name[HEAP_TRACE_NAME_LENGTH];
+	uint32_t heapSize;
+	uint32_t blocksInUse;
+	uint32_t bytesInUse;
+	uint32_t peakBytesInUse;
+	uint32_t coreLeft;
+} HeapSnapshotHeap;
+
+typedef struct _HeapTagTotal
+{
+	uint16_t heap; // in the snapshot's heaps
+	uint16_t callsite;
+	uint8_t subsystem;
+	uint32_t blocks;
+	uint32_t bytes; // whole blocks, headers and tags included
+} HeapTagTotal;
+
+typedef struct _HeapSnapshot
+{
+	uint32_t number;
+	uint32_t time; // milliseconds since telemetry started
+	std::vector<HeapSnapshotHeap> heaps;
+	std::vector<HeapTagTotal> totals; // biggest first
+} HeapSnapshot;
+
+typedef struct _HeapTagDelta
+{
+	const wchar_t* heapName; // points into the snapshots diffed
+	uint16_t callsite;
+	uint8_t subsystem;
+	int32_t blocks;
+	int32_t bytes;
+} HeapTagDelta;
+
 //---------------------------------------------------------------------------
 // Class Definitions
 class HeapManager
@@ -85,7 +194,7 @@ protected:
 	bool memReserved;
 	size_t totalSize;
 	size_t committedSize;
-	uint32_t whoMadeMe;
+	uintptr_t whoMadeMe;
 
 	//		BOOL	VMQuery (PVOID pvAddress, PVMQUERY pVMQ);
 	//		const std::wstring_view&   GetMemStorageText (uint32_t dwStorage);
@@ -117,35 +226,26 @@ public:
 
 	virtual uint8_t heapType(void) { return BASE_HEAP; }
 
-	uint32_t owner(void) { return whoMadeMe; }
+	uintptr_t owner(void) { return whoMadeMe; }
 
 	size_t tSize(void) { return committedSize; }
 };
 
-//---------------------------------------------------------------------------
-typedef struct HeapBlock
-{
-	size_t blockSize;
-	HeapBlockPtr upperBlock;
-	HeapBlockPtr previous;
-	HeapBlockPtr next;
-} HeapBlock;
-
 //---------------------------------------------------------------------------
 class UserHeap : public HeapManager
 {
 	// Data Members
 	//-------------
 protected:
-	HeapBlockPtr heapStart;
-	HeapBlockPtr heapEnd;
-	HeapBlockPtr firstNearBlock;
+	SizeClassHeap blocks;
 	size_t heapSize;
 	bool mallocFatals;
 	int32_t heapState;
 	const std::wstring_view& heapName;
 	bool useGOSGuardPage;
 	HGOSHEAP gosHeap;
+	int32_t traceHeap; // number in the current trace, -1 if not in one
+	uint32_t traceGeneration;
 
 #ifdef _DEBUG
 	memRecord* recordArray;
@@ -155,11 +255,6 @@ protected:
 
 	// Member Functions
 	//-----------------
-protected:
-	void relink(HeapBlockPtr newBlock);
-	void unlink(HeapBlockPtr oldBlock);
-	bool mergeWithLower(HeapBlockPtr block);
-
 public:
 	UserHeap(void);
 	int32_t init(uint32_t memSize, const std::wstring_view& heapId = nullptr, bool useGOS = false);
@@ -171,7 +266,11 @@ public:
 	uint32_t coreLeft(void);
 	size_t size(void) { return heapSize; }
 
+	// A tagged block's callsite is whoever called Malloc.  Wrappers, like
+	// calloc and the classes' operator news, pass their own return address
+	// so the tag names their caller and not the wrapper.
 	PVOID Malloc(size_t memSize);
+	PVOID Malloc(size_t memSize, PVOID returnAddress);
 	int32_t Free(PVOID memBlock);
 
 	PVOID calloc(size_t memSize);
@@ -190,6 +289,20 @@ public:
 
 	bool pointerOnHeap(PVOID ptr);
 
+	HeapStats getStatistics(void);
+
+	// Thread caches may only be turned on or off while one thread is
+	// using the heap.  A thread done with the heap can hand its cached
+	// blocks back with flushThreadCache.
+	void setThreadCaches(bool useCaches);
+	void flushThreadCache(void) { blocks.flushThreadCache(); }
+
+	// Adds up this heap's tagged blocks, or only those from one epoch,
+	// onto totals.  The heap may not be in use on another thread.
+	void addTagTotals(std::vector<HeapTagTotal>& totals, uint16_t heapNumber, int32_t epoch = -1);
+
+	static bool TestClass(void);
+
 #ifdef _DEBUG
 	void startHeapMallocLog(void); // This function will start recoding each malloc and
 	// free to insure that there are no leaks.
@@ -208,6 +321,11 @@ public:
 
 	void dumpRecordLog(void) {}
 #endif
+
+protected:
+	PVOID tagBlock(PVOID memBlock, PVOID returnAddress);
+	void traceMalloc(PVOID memBlock, size_t memSize);
+	void traceFree(PVOID memBlock);
 };
 
 //---------------------------------------------------------------------------
@@ -245,12 +363,42 @@ public:
 	void dumpLog(void);
 
 	static void initializeStatistics(void);
+
+	//------------------------------------------------------------------
+	// Telemetry.  Snapshots walk every heap, so all of these are for
+	// the main thread between frames.  The time series is CSV, or one
+	// JSON object a line if its file name ends in .json.
+	void takeSnapshot(HeapSnapshot& snapshot, int32_t epoch = -1);
+	static void diffSnapshots(const HeapSnapshot& before, const HeapSnapshot& after, std::vector<HeapTagDelta>& deltas);
+
+	bool startTelemetry(const std::wstring_view& fileName, uint32_t interval);
+	void stopTelemetry(void);
+	void updateTelemetry(void); // snapshots when the interval is up
+
+	// With tagging on, markMission starts a mission's epoch and
+	// leakReport, once the mission is torn down, writes what it left.
+	void markMission(void);
+	void leakReport(void);
+
+	static bool TestClass(void);
 };
 
 //---------------------------------------------------------------------------
 typedef HeapList* HeapListPtr;
 extern HeapListPtr globalHeapList;
 
+//---------------------------------------------------------------------------
+// Allocation traces.  While one is running every malloc and free on every
+// heap is written to it, for heapbench to replay.
+bool UserHeapTraceStart(const std::wstring_view& fileName);
+void UserHeapTraceStop(void);
+
+extern bool UserHeapThreadCaches;
+extern wchar_t HeapTracePath[];
+extern bool UserHeapTagging;
+extern wchar_t HeapTelemetryPath[];
+extern uint32_t HeapTelemetryInterval;
+
 //---------------------------------------------------------------------------
 #endif
 
@@ -0,0 +1,161 @@
+//===========================================================================//
+// File:	heap_test.cpp                                                    //
+// Contents: test functions for allocation tags and heap snapshots           //
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#include "stdinc.h"
+#include "heap.h"
+
+#define HEAP_TEST_SIZE (256 * 1024)
+#define HEAP_TEST_BLOCKS 20
+
+//---------------------------------------------------------------------------
+
+static HeapTag*
+HeapTestTag(PVOID memBlock)
+{
+	return ((HeapTag*)((uint8_t*)memBlock - HEAP_TAG_SIZE));
+}
+
+//---------------------------------------------------------------------------
+// Blocks made with tagging on and off are freed right whichever way it is
+// set at the time, and a wrapper's blocks are tagged with its caller.
+
+bool
+UserHeap::TestClass(void)
+{
+	SPEW((GROUP_STUFF_TEST, "Starting UserHeap tag test..."));
+	bool wasTagging = UserHeapTagging;
+	UserHeap heap;
+	Test_Assumption(heap.init(HEAP_TEST_SIZE, "TAGTEST") == NO_ERROR);
+	heap.setThreadCaches(false); // so what's freed merges straight back
+	uint32_t emptyLeft = heap.coreLeft();
+	PVOID untagged[HEAP_TEST_BLOCKS];
+	PVOID tagged[HEAP_TEST_BLOCKS];
+	size_t i;
+	UserHeapTagging = false;
+	for (i = 0; i < HEAP_TEST_BLOCKS; i++)
+	{
+		untagged[i] = heap.Malloc(24 + i);
+		Test_Assumption(untagged[i] != nullptr);
+		Test_Assumption(HeapTestTag(untagged[i])->tagMark != HEAP_TAG_MARK);
+		memset(untagged[i], 0xff, 24 + i);
+	}
+	UserHeapTagging = true;
+	{
+		HeapTagScope scope(HEAP_TAG_SOUND);
+		for (i = 0; i < HEAP_TEST_BLOCKS; i++)
+		{
+			tagged[i] = heap.Malloc(24 + i);
+			Test_Assumption(tagged[i] != nullptr);
+			memset(tagged[i], 0, 24 + i);
+		}
+	}
+	for (i = 0; i < HEAP_TEST_BLOCKS; i++)
+	{
+		HeapTag* tag = HeapTestTag(tagged[i]);
+		Test_Assumption(tag->tagMark == HEAP_TAG_MARK);
+		Test_Assumption(tag->subsystem == HEAP_TAG_SOUND);
+		Test_Assumption(tag->callsite == HeapTestTag(tagged[0])->callsite);
+	}
+	Test_Assumption(HeapTestTag(tagged[0])->callsite != 0);
+	//------------------------------------------------------------
+	// Two callocs from two places get two callsites, not calloc's
+	// own, and come back zeroed...
+	uint8_t* zeroed = (uint8_t*)heap.calloc(64);
+	uint8_t* zeroedElsewhere = (uint8_t*)heap.calloc(64);
+	Test_Assumption(zeroed && zeroedElsewhere);
+	Test_Assumption(HeapTestTag(zeroed)->callsite != HeapTestTag(zeroedElsewhere)->callsite);
+	Test_Assumption(HeapTestTag(zeroed)->subsystem == HEAP_TAG_NONE);
+	for (i = 0; i < 64; i++)
+		Test_Assumption(zeroed[i] == 0);
+	//----------------------------------------------------------
+	// The heap's totals find every tagged block and nothing else.
+	std::vector<HeapTagTotal> totals;
+	heap.addTagTotals(totals, 0);
+	uint32_t soundBlocks = 0;
+	uint32_t otherBlocks = 0;
+	for (i = 0; i < totals.size(); i++)
+		if (totals[i].subsystem == HEAP_TAG_SOUND)
+			soundBlocks += totals[i].blocks;
+		else
+			otherBlocks += totals[i].blocks;
+	Test_Assumption(soundBlocks == HEAP_TEST_BLOCKS);
+	Test_Assumption(otherBlocks == 2);
+	//-----------------------------------------------------------
+	// Untagged blocks freed with tagging on, and tagged ones with
+	// it off, all go back.  Nothing is left out afterwards.
+	for (i = 0; i < HEAP_TEST_BLOCKS; i++)
+		Test_Assumption(heap.Free(untagged[i]) == NO_ERROR);
+	UserHeapTagging = false;
+	for (i = 0; i < HEAP_TEST_BLOCKS; i++)
+		Test_Assumption(heap.Free(tagged[i]) == NO_ERROR);
+	Test_Assumption(heap.Free(zeroed) == NO_ERROR);
+	Test_Assumption(heap.Free(zeroedElsewhere) == NO_ERROR);
+	Test_Assumption(heap.getStatistics().blocksInUse == 0);
+	Test_Assumption(heap.coreLeft() == emptyLeft);
+	UserHeapTagging = wasTagging;
+	heap.destroy();
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Snapshots made up by hand: heap B goes away, C turns up and A moves in
+// the list, so the diff has to match heaps by name.
+
+bool
+HeapList::TestClass(void)
+{
+	SPEW((GROUP_STUFF_TEST, "Starting HeapList snapshot diff test..."));
+	auto addHeap = [](HeapSnapshot& snapshot, const wchar_t* name) {
+		HeapSnapshotHeap heap;
+		memset(&heap, 0, sizeof(heap));
+		strcpy(heap.name, name);
+		snapshot.heaps.push_back(heap);
+	};
+	auto addTotal = [](HeapSnapshot& snapshot, uint16_t heap, uint8_t subsystem, uint16_t callsite,
+						uint32_t blocks, uint32_t bytes) {
+		HeapTagTotal total;
+		total.heap = heap;
+		total.callsite = callsite;
+		total.subsystem = subsystem;
+		total.blocks = blocks;
+		total.bytes = bytes;
+		snapshot.totals.push_back(total);
+	};
+	HeapSnapshot before;
+	addHeap(before, "A");
+	addHeap(before, "B");
+	addTotal(before, 0, HEAP_TAG_ALL, 0, 10, 1000);
+	addTotal(before, 0, HEAP_TAG_SOUND, 5, 4, 400);
+	addTotal(before, 1, HEAP_TAG_ALL, 0, 2, 200);
+	HeapSnapshot after;
+	addHeap(after, "C");
+	addHeap(after, "A");
+	addTotal(after, 1, HEAP_TAG_ALL, 0, 12, 1300);
+	addTotal(after, 0, HEAP_TAG_ALL, 0, 3, 350);
+	addTotal(after, 1, HEAP_TAG_SOUND, 5, 4, 400);
+	addTotal(after, 1, HEAP_TAG_OBJECTS, 7, 2, 200);
+	std::vector<HeapTagDelta> deltas;
+	diffSnapshots(before, after, deltas);
+	//------------------------------------------------------------
+	// What didn't change is left out, and the rest is biggest
+	// growth first: C arriving, A growing, A's new callsite, then
+	// B going away.
+	Test_Assumption(deltas.size() == 4);
+	Test_Assumption((strcmp(deltas[0].heapName, "C") == 0) && (deltas[0].subsystem == HEAP_TAG_ALL));
+	Test_Assumption((deltas[0].blocks == 3) && (deltas[0].bytes == 350));
+	Test_Assumption((strcmp(deltas[1].heapName, "A") == 0) && (deltas[1].subsystem == HEAP_TAG_ALL));
+	Test_Assumption((deltas[1].blocks == 2) && (deltas[1].bytes == 300));
+	Test_Assumption((strcmp(deltas[2].heapName, "A") == 0) && (deltas[2].subsystem == HEAP_TAG_OBJECTS));
+	Test_Assumption((deltas[2].callsite == 7) && (deltas[2].blocks == 2) && (deltas[2].bytes == 200));
+	Test_Assumption((strcmp(deltas[3].heapName, "B") == 0) && (deltas[3].subsystem == HEAP_TAG_ALL));
+	Test_Assumption((deltas[3].blocks == -2) && (deltas[3].bytes == -200));
+	//------------------------------------------------
+	// A snapshot against itself has nothing to show.
+	diffSnapshots(after, after, deltas);
+	Test_Assumption(deltas.empty());
+	return true;
+}
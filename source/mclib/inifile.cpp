@@ -41,6 +41,45 @@ constexpr const std::wstring_view& fitIniFooter = "FITend";
 constexpr const std::wstring_view& fitIniHeaderLE = "FITini\r\n";
 constexpr const std::wstring_view& fitIniFooterLE = "FITend\r\n";
 
+bool FitIniUseIndex = true;
+FitIniFileStats FitIniFileStatistics = {0, 0, 0, 0, 0, 0};
+
+static const wchar_t* iniFieldPrefix[] = {"f", "f", "b", "l", "ul", "s", "us", "c", "uc", "st"};
+
+//---------------------------------------------------------------------------
+// FNV-1a, a byte at a time.  Ids are hashed lower cased (the old scan used
+// strnicmp), block names as they are (it used strcmp).
+static inline uint32_t
+IniHash(uint32_t hash, uint32_t c)
+{
+	return ((hash ^ (c & 0xFF)) * 16777619U);
+}
+
+//---------------------------------------------------------------------------
+static inline uint32_t
+IniHashBlockNum(size_t blockNum)
+{
+	uint32_t hash = 2166136261U;
+	for (size_t i = 0; i < 4; i++)
+		hash = IniHash(hash, (uint32_t)(blockNum >> (i * 8)));
+	return (hash);
+}
+
+//---------------------------------------------------------------------------
+static bool
+IniKeyMatch(const char* key, const std::wstring_view& type, const std::wstring_view& varName)
+{
+	for (auto c : type)
+		if (*key++ != (char)towlower(c))
+			return false;
+	if (*key++ != ' ')
+		return false;
+	for (auto c : varName)
+		if (*key++ != (char)towlower(c))
+			return false;
+	return true;
+}
+
 //---------------------------------------------------------------------------
 // class FitIniFile
 // FitIniFile::FitIniFile(void) : File()
@@ -213,10 +252,160 @@ FitIniFile::afterOpen(void)
 		// If we didn't read in enough, CD-ROM error?
 		if (currentBlockNum != m_totalBlocks)
 			return (NOT_ENOUGH_BLOCKS);
+		buildIndex();
 	}
 	return (NO_ERROR);
 }
 
+//---------------------------------------------------------------------------
+// Reads the whole file once and hashes every block name and every
+// "type name = value" line in it.  Lookups after this never scan.
+void
+FitIniFile::buildIndex(void)
+{
+	clearIndex();
+	if (!FitIniUseIndex || !m_totalBlocks)
+		return;
+	size_t length = getLength();
+	size_t oldPosition = logicalPosition;
+	m_fileText.resize(length + 1);
+	seek(0);
+	size_t bytesRead = read((uint8_t*)m_fileText.data(), length);
+	seek(oldPosition);
+	if (bytesRead != length)
+	{
+		clearIndex();
+		return;
+	}
+	m_fileText[length] = '\0';
+	const char* text = m_fileText.data();
+	//------------------------------------------------------
+	// Block names.  Of two blocks with the same name the
+	// first one wins, as it did with the linear search.
+	size_t numSlots = 16;
+	while (numSlots < (m_totalBlocks * 2))
+		numSlots <<= 1;
+	m_blockIndex.assign(numSlots, 0);
+	for (size_t blockNum = 0; blockNum < m_totalBlocks; blockNum++)
+	{
+		uint32_t hash = 2166136261U;
+		for (size_t i = 0; m_fileBlocks[blockNum].blockId[i]; i++)
+			hash = IniHash(hash, m_fileBlocks[blockNum].blockId[i]);
+		size_t slot = hash & (numSlots - 1);
+		while (m_blockIndex[slot] &&
+			(strcmp(m_fileBlocks[m_blockIndex[slot] - 1].blockId, m_fileBlocks[blockNum].blockId) != 0))
+			slot = (slot + 1) & (numSlots - 1);
+		if (!m_blockIndex[slot])
+		{
+			m_blockIndex[slot] = (uint32_t)(blockNum + 1);
+			FitIniFileStatistics.numIndexedBlocks++;
+		}
+	}
+	//------------------------------------------------------
+	// Ids.  One table for the whole file, keyed on block
+	// number and id, at most half full.
+	size_t numLines = 1;
+	for (size_t i = 0; i < length; i++)
+		if (text[i] == '\n')
+			numLines++;
+	numSlots = 16;
+	while (numSlots < (numLines * 2))
+		numSlots <<= 1;
+	IniIdNode emptyNode = {0, 0, 0, 0, 0, 0, 0};
+	m_idIndex.assign(numSlots, emptyNode);
+	m_keyText.reserve(length);
+	for (size_t blockNum = 0; blockNum < m_totalBlocks; blockNum++)
+	{
+		size_t blockEnd = ((blockNum + 1) < m_totalBlocks) ? m_fileBlocks[blockNum + 1].blockOffset : length;
+		size_t lineStart = m_fileBlocks[blockNum].blockOffset;
+		while (lineStart < blockEnd)
+		{
+			size_t lineEnd = lineStart;
+			while ((lineEnd < length) && (text[lineEnd] != '\n'))
+				lineEnd++;
+			//--------------------------------------------------
+			// The scan gave up once it had read to the end of
+			// the block, so a line reaching it was never found.
+			if ((lineEnd + 1) >= blockEnd)
+				break;
+			size_t equalSign = lineStart;
+			while ((equalSign < lineEnd) && (text[equalSign] != '='))
+				equalSign++;
+			size_t keyEnd = equalSign;
+			while ((keyEnd > lineStart) && isspace((uint8_t)text[keyEnd - 1]))
+				keyEnd--;
+			if ((equalSign < lineEnd) && (keyEnd > lineStart))
+			{
+				//--------------------------------------------
+				// Lower case the key and drop the count from
+				// an array type: "f[3] Foo" is "f[] foo".
+				uint32_t keyOffset = (uint32_t)m_keyText.size();
+				bool inType = true;
+				bool inCount = false;
+				for (size_t i = lineStart; i < keyEnd; i++)
+				{
+					char c = (char)tolower((uint8_t)text[i]);
+					if (inCount && (c != ']'))
+						continue;
+					inCount = inType && (c == '[');
+					if (c == ' ')
+						inType = false;
+					m_keyText.push_back(c);
+				}
+				uint32_t keyLength = (uint32_t)(m_keyText.size() - keyOffset);
+				uint32_t hash = IniHashBlockNum(blockNum);
+				for (size_t i = 0; i < keyLength; i++)
+					hash = IniHash(hash, m_keyText[keyOffset + i]);
+				if (!hash)
+					hash = 1;
+				size_t slot = hash & (numSlots - 1);
+				while (m_idIndex[slot].hash &&
+					((m_idIndex[slot].hash != hash) || (m_idIndex[slot].blockNum != blockNum) ||
+						(m_idIndex[slot].keyLength != keyLength) ||
+						memcmp(&m_keyText[m_idIndex[slot].keyOffset], &m_keyText[keyOffset], keyLength)))
+					slot = (slot + 1) & (numSlots - 1);
+				if (m_idIndex[slot].hash)
+				{
+					//-----------------------------------------
+					// Same id twice in a block.  The scan only
+					// ever found the first.
+					m_keyText.resize(keyOffset);
+				}
+				else
+				{
+					size_t valueEnd = lineEnd;
+					if ((valueEnd > equalSign + 1) && (text[valueEnd - 1] == '\r'))
+						valueEnd--;
+					IniIdNode& node = m_idIndex[slot];
+					node.hash = hash;
+					node.blockNum = (uint32_t)blockNum;
+					node.keyOffset = keyOffset;
+					node.keyLength = keyLength;
+					node.lineOffset = (uint32_t)lineStart;
+					node.valueOffset = (uint32_t)(equalSign + 1);
+					node.valueLength = (uint32_t)(valueEnd - equalSign - 1);
+					FitIniFileStatistics.numIndexedIds++;
+				}
+			}
+			lineStart = lineEnd + 1;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+void
+FitIniFile::clearIndex(void)
+{
+	m_fileText.clear();
+	m_fileText.shrink_to_fit();
+	m_keyText.clear();
+	m_keyText.shrink_to_fit();
+	m_blockIndex.clear();
+	m_blockIndex.shrink_to_fit();
+	m_idIndex.clear();
+	m_idIndex.shrink_to_fit();
+}
+
 #if CONSIDERED_OBSOLETE
 //---------------------------------------------------------------------------
 void
@@ -719,6 +908,7 @@ FitIniFile::close(void)
 	if (isOpen())
 	{
 		atClose();
+		clearIndex();
 		MechFile::close();
 	}
 }
@@ -728,9 +918,24 @@ HRESULT
 FitIniFile::seekBlock(const std::wstring_view& blockId)
 {
 	uint32_t blockNum = 0;
-	while ((blockNum < m_totalBlocks) && (strcmp(m_fileBlocks[blockNum].blockId, blockId) != 0))
+	FitIniFileStatistics.numBlockLookups++;
+	if (!m_blockIndex.empty())
+	{
+		uint32_t hash = 2166136261U;
+		for (auto c : blockId)
+			hash = IniHash(hash, c);
+		size_t mask = m_blockIndex.size() - 1;
+		size_t slot = hash & mask;
+		while (m_blockIndex[slot] && (strcmp(m_fileBlocks[m_blockIndex[slot] - 1].blockId, blockId) != 0))
+			slot = (slot + 1) & mask;
+		blockNum = m_blockIndex[slot] ? (m_blockIndex[slot] - 1) : m_totalBlocks;
+	}
+	else
 	{
-		blockNum++;
+		while ((blockNum < m_totalBlocks) && (strcmp(m_fileBlocks[blockNum].blockId, blockId) != 0))
+		{
+			blockNum++;
+		}
 	}
 	if (blockNum == m_totalBlocks)
 	{
@@ -743,6 +948,7 @@ FitIniFile::seekBlock(const std::wstring_view& blockId)
 	// Setup all current Block Info
 	m_currentBlockId = m_fileBlocks[blockNum].blockId;
 	m_currentBlockOffset = m_fileBlocks[blockNum].blockOffset;
+	m_currentBlockNum = blockNum;
 	blockNum++;
 	if (blockNum == m_totalBlocks)
 	{
@@ -755,6 +961,84 @@ FitIniFile::seekBlock(const std::wstring_view& blockId)
 	return (NO_ERROR);
 }
 
+//---------------------------------------------------------------------------
+const IniIdNode*
+FitIniFile::findId(const std::wstring_view& type, const std::wstring_view& varName)
+{
+	FitIniFileStatistics.numIdLookups++;
+	uint32_t keyLength = (uint32_t)(type.size() + 1 + varName.size());
+	uint32_t hash = IniHashBlockNum(m_currentBlockNum);
+	for (auto c : type)
+		hash = IniHash(hash, towlower(c));
+	hash = IniHash(hash, ' ');
+	for (auto c : varName)
+		hash = IniHash(hash, towlower(c));
+	if (!hash)
+		hash = 1;
+	size_t mask = m_idIndex.size() - 1;
+	for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+	{
+		FitIniFileStatistics.numIdProbes++;
+		const IniIdNode& node = m_idIndex[slot];
+		if (!node.hash)
+			break;
+		if ((node.hash == hash) && (node.blockNum == m_currentBlockNum) && (node.keyLength == keyLength) &&
+			IniKeyMatch(&m_keyText[node.keyOffset], type, varName))
+			return (&node);
+	}
+	FitIniFileStatistics.numIdMisses++;
+	return nullptr;
+}
+
+//---------------------------------------------------------------------------
+// Positions the file for the line by line readers below: on the id's line
+// if it's indexed, at the end of the block if it isn't there (so the scan
+// gives up on its first line), or at the top of the block with no index.
+void
+FitIniFile::seekId(const std::wstring_view& type, const std::wstring_view& varName)
+{
+	if (!m_idIndex.empty())
+	{
+		const IniIdNode* node = findId(type, varName);
+		if (node)
+		{
+			seek(node->lineOffset);
+			return;
+		}
+		//--------------------------------------------------------
+		// The old scan matched arrays more loosely than the index
+		// does ("f[" and "] name" anywhere on the line), so a
+		// missing array still gets looked for the long way.
+		if (type.back() != ']')
+		{
+			seek(m_currentBlockOffset + m_currentBlockSize);
+			return;
+		}
+	}
+	seek(m_currentBlockOffset);
+}
+
+//---------------------------------------------------------------------------
+// Copies the text after the '=' straight out of the index.  ID_NOT_INDEXED
+// if there is no index, and the caller has to read it the old way.
+HRESULT
+FitIniFile::getIdValue(
+	const std::wstring_view& type, const std::wstring_view& varName, wchar_t* value, size_t valueLen)
+{
+	if (m_idIndex.empty())
+		return (ID_NOT_INDEXED);
+	const IniIdNode* node = findId(type, varName);
+	if (!node)
+		return (VARIABLE_NOT_FOUND);
+	if (node->valueLength >= valueLen)
+		return (BUFFER_TOO_SMALL);
+	const char* text = &m_fileText[node->valueOffset];
+	for (size_t i = 0; i < node->valueLength; i++)
+		value[i] = (uint8_t)text[i];
+	value[node->valueLength] = '\0';
+	return (NO_ERROR);
+}
+
 //---------------------------------------------------------------------------
 HRESULT
 FitIniFile::readIdFloat(const std::wstring_view& varName, float& value)
@@ -762,8 +1046,8 @@ FitIniFile::readIdFloat(const std::wstring_view& varName, float& value)
 	wchar_t line[BUFFERSIZE];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("f", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------
 	// Put prefix on varName.
@@ -809,8 +1093,8 @@ FitIniFile::readIdDouble(const std::wstring_view& varName, double& value)
 	wchar_t line[BUFFERSIZE];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("f", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------
 	// Put prefix on varName.
@@ -863,8 +1147,8 @@ HRESULT FitIniFile::readIdLong(const std::wstring_view& varName, long32_t& value
 	wchar_t line[BUFFERSIZE];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("l", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------
 	// Put prefix on varName.
@@ -910,8 +1194,8 @@ FitIniFile::readIdBoolean(const std::wstring_view& varName, bool& value)
 	wchar_t line[BUFFERSIZE];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("b", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------
 	// Put prefix on varName.
@@ -957,8 +1241,8 @@ FitIniFile::readIdShort(const std::wstring_view& varName, int16_t& value)
 	wchar_t line[BUFFERSIZE];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("s", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------
 	// Put prefix on varName.
@@ -999,13 +1283,13 @@ FitIniFile::readIdShort(const std::wstring_view& varName, int16_t& value)
 
 //---------------------------------------------------------------------------
 HRESULT
-FitIniFile::readIdChar(const std::wstring_view& varName, wchar_t& value)
+FitIniFile::readIdChar(const std::wstring_view& varName, int8_t& value)
 {
 	wchar_t line[BUFFERSIZE];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("c", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------
 	// Put prefix on varName.
@@ -1035,7 +1319,7 @@ FitIniFile::readIdChar(const std::wstring_view& varName, wchar_t& value)
 	if (equalSign)
 	{
 		equalSign++;
-		value = textToChar(equalSign);
+		value = (int8_t)textToChar(equalSign);
 	}
 	else
 	{
@@ -1051,8 +1335,8 @@ FitIniFile::readIdULong(const std::wstring_view& varName, ulong32_t& value)
 	wchar_t line[BUFFERSIZE];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("ul", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------
 	// Put prefix on varName.
@@ -1098,8 +1382,8 @@ FitIniFile::readIdUShort(const std::wstring_view& varName, uint16_t& value)
 	wchar_t line[BUFFERSIZE];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("us", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------
 	// Put prefix on varName.
@@ -1145,8 +1429,8 @@ FitIniFile::readIdUChar(const std::wstring_view& varName, uint8_t& value)
 	wchar_t line[BUFFERSIZE];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("uc", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------
 	// Put prefix on varName.
@@ -1224,8 +1508,8 @@ FitIniFile::readIdString(const std::wstring_view& varName, const std::wstring_vi
 	wchar_t line[2048];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("st", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------
 	// Put prefix on varName.
@@ -1295,8 +1579,8 @@ FitIniFile::getIdStringLength(const std::wstring_view& varName)
 	wchar_t line[BUFFERSIZE];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("st", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------
 	// Put prefix on varName.
@@ -1344,8 +1628,8 @@ FitIniFile::readIdFloatArray(const std::wstring_view& varName, float* result, ui
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("f[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -1422,8 +1706,8 @@ FitIniFile::readIdLongArray(const std::wstring_view& varName, int32_t* result, u
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("l[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -1500,8 +1784,8 @@ FitIniFile::readIdULongArray(const std::wstring_view& varName, uint32_t* result,
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("ul[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -1578,8 +1862,8 @@ FitIniFile::readIdShortArray(const std::wstring_view& varName, int16_t* result,
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("s[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -1656,8 +1940,8 @@ FitIniFile::readIdUShortArray(const std::wstring_view& varName, uint16_t* result
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("us[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -1734,8 +2018,8 @@ FitIniFile::readIdCharArray(const std::wstring_view& varName, const std::wstring
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("c[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -1812,8 +2096,8 @@ FitIniFile::readIdUCharArray(const std::wstring_view& varName, uint8_t* result,
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("uc[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -1890,8 +2174,8 @@ FitIniFile::getIdFloatArrayElements(const std::wstring_view& varName)
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("f[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -1933,8 +2217,8 @@ FitIniFile::getIdLongArrayElements(const std::wstring_view& varName)
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("l[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -1976,8 +2260,8 @@ FitIniFile::getIdULongArrayElements(const std::wstring_view& varName)
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("ul[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -2019,8 +2303,8 @@ FitIniFile::getIdShortArrayElements(const std::wstring_view& varName)
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("s[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -2062,8 +2346,8 @@ FitIniFile::getIdUShortArrayElements(const std::wstring_view& varName)
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("us[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -2105,8 +2389,8 @@ FitIniFile::getIdCharArrayElements(const std::wstring_view& varName)
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("c[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -2148,8 +2432,8 @@ FitIniFile::getIdUCharArrayElements(const std::wstring_view& varName)
 	wchar_t frontSearch[10];
 	wchar_t searchString[BUFFERSIZE];
 	//--------------------------------
-	// Always read from top of Block.
-	seek(m_currentBlockOffset);
+	// Start on the id's line if it's indexed.
+	seekId("uc[]", varName);
 	uint32_t endOfBlock = m_currentBlockOffset + m_currentBlockSize;
 	//------------------------------------------------------------------
 	// Create two search strings so that we can match any number in []
@@ -2183,6 +2467,144 @@ FitIniFile::getIdUCharArrayElements(const std::wstring_view& varName)
 	return (actualElements);
 }
 
+//---------------------------------------------------------------------------
+static void
+IniSetField(uint8_t* member, IniFieldType type, double value)
+{
+	switch (type)
+	{
+	case INI_FIELD_FLOAT:
+		*(float*)member = (float)value;
+		break;
+	case INI_FIELD_DOUBLE:
+		*(double*)member = value;
+		break;
+	case INI_FIELD_BOOLEAN:
+		*(bool*)member = (value != 0.0);
+		break;
+	case INI_FIELD_LONG:
+		*(int32_t*)member = (int32_t)value;
+		break;
+	case INI_FIELD_ULONG:
+		*(uint32_t*)member = (uint32_t)value;
+		break;
+	case INI_FIELD_SHORT:
+		*(int16_t*)member = (int16_t)value;
+		break;
+	case INI_FIELD_USHORT:
+		*(uint16_t*)member = (uint16_t)value;
+		break;
+	case INI_FIELD_CHAR:
+		*(int8_t*)member = (int8_t)value;
+		break;
+	case INI_FIELD_UCHAR:
+		*(uint8_t*)member = (uint8_t)value;
+		break;
+	case INI_FIELD_STRING:
+		*(wchar_t*)member = '\0';
+		break;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Reads a table of fields out of the current block into object.  With the
+// index each value is parsed straight from the text, no seeks and no line
+// reads.  Every field is read; the first required field that failed is
+// what comes back.
+HRESULT
+FitIniFile::readFields(const IniField* fields, size_t numFields, PVOID object)
+{
+	HRESULT firstError = NO_ERROR;
+	for (size_t i = 0; i < numFields; i++)
+	{
+		const IniField& field = fields[i];
+		uint8_t* member = (uint8_t*)field.member(object);
+		wchar_t valueText[BUFFERSIZE];
+		HRESULT result;
+		if (field.type == INI_FIELD_STRING)
+			result = readIdString(field.name, (wchar_t*)member, field.size);
+		else
+			result = getIdValue(iniFieldPrefix[field.type], field.name, valueText, BUFFERSIZE);
+		if ((result == NO_ERROR) && (field.type != INI_FIELD_STRING))
+		{
+			switch (field.type)
+			{
+			case INI_FIELD_FLOAT:
+				*(float*)member = textToFloat(valueText);
+				break;
+			case INI_FIELD_DOUBLE:
+				*(double*)member = textToDouble(valueText);
+				break;
+			case INI_FIELD_BOOLEAN:
+				*(bool*)member = booleanToLong(valueText);
+				break;
+			case INI_FIELD_LONG:
+				*(int32_t*)member = textToLong(valueText);
+				break;
+			case INI_FIELD_ULONG:
+				*(uint32_t*)member = textToULong(valueText);
+				break;
+			case INI_FIELD_SHORT:
+				*(int16_t*)member = textToShort(valueText);
+				break;
+			case INI_FIELD_USHORT:
+				*(uint16_t*)member = textToUShort(valueText);
+				break;
+			case INI_FIELD_CHAR:
+				*(int8_t*)member = (int8_t)textToChar(valueText);
+				break;
+			case INI_FIELD_UCHAR:
+				*(uint8_t*)member = textToUChar(valueText);
+				break;
+			}
+		}
+		else if (result == ID_NOT_INDEXED)
+		{
+			switch (field.type)
+			{
+			case INI_FIELD_FLOAT:
+				result = readIdFloat(field.name, *(float*)member);
+				break;
+			case INI_FIELD_DOUBLE:
+				result = readIdDouble(field.name, *(double*)member);
+				break;
+			case INI_FIELD_BOOLEAN:
+				result = readIdBoolean(field.name, *(bool*)member);
+				break;
+			case INI_FIELD_LONG:
+				result = readIdLong(field.name, *(long32_t*)member);
+				break;
+			case INI_FIELD_ULONG:
+				result = readIdULong(field.name, *(ulong32_t*)member);
+				break;
+			case INI_FIELD_SHORT:
+				result = readIdShort(field.name, *(int16_t*)member);
+				break;
+			case INI_FIELD_USHORT:
+				result = readIdUShort(field.name, *(uint16_t*)member);
+				break;
+			case INI_FIELD_CHAR:
+				result = readIdChar(field.name, *(int8_t*)member);
+				break;
+			case INI_FIELD_UCHAR:
+				result = readIdUChar(field.name, *(uint8_t*)member);
+				break;
+			}
+		}
+		if (result != NO_ERROR)
+		{
+			if (field.required)
+			{
+				if (firstError == NO_ERROR)
+					firstError = result;
+			}
+			else
+				IniSetField(member, field.type, field.defaultValue);
+		}
+	}
+	return (firstError);
+}
+
 auto format = "your %x format %d string %s";
 auto size = std::snprintf(nullptr, 0, format /* Arguments go here*/);
 std::string output(size + 1, '\0');
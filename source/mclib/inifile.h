@@ -41,6 +41,21 @@ enum __inifile_constants : uint32_t
 	GET_NEXT_LINE = 0xFADA000C,
 	USER_ARRAY_TOO_SMALL = 0xFADA000D,
 	TOO_MANY_ELEMENTS = 0xFADA000E,
+	ID_NOT_INDEXED = 0xFADA000F,
+};
+
+enum IniFieldType : uint8_t
+{
+	INI_FIELD_FLOAT,
+	INI_FIELD_DOUBLE,
+	INI_FIELD_BOOLEAN,
+	INI_FIELD_LONG,
+	INI_FIELD_ULONG,
+	INI_FIELD_SHORT,
+	INI_FIELD_USHORT,
+	INI_FIELD_CHAR,
+	INI_FIELD_UCHAR,
+	INI_FIELD_STRING,
 };
 
 /*
@@ -58,6 +73,52 @@ struct IniBlockNode
 	size_t blockOffset;
 };
 
+//---------------------------------------------------------------------------
+// One "type name = value" line, found on open.  The key is the lower cased
+// text in front of the '=' with any array count dropped ("f[3] Foo" is
+// "f[] foo"), so a lookup is one hash probe instead of a scan of the block.
+struct IniIdNode
+{
+	uint32_t hash; // of blockNum and key, zero for an empty slot
+	uint32_t blockNum;
+	uint32_t keyOffset; // into m_keyText
+	uint32_t keyLength;
+	uint32_t lineOffset; // start of the line in the file
+	uint32_t valueOffset; // past the '=' up to the end of the line
+	uint32_t valueLength;
+};
+
+//---------------------------------------------------------------------------
+// One entry of a readFields table.  member hands back where the field lives
+// in the object read into; INI_FIELD_MEMBER makes one, which works for
+// classes with virtuals where offsetof doesn't.  size is the buffer size of
+// a string.  A field that isn't in the block fails the read if it's
+// required and gets defaultValue if not.
+typedef PVOID (*IniFieldMember)(PVOID object);
+
+struct IniField
+{
+	const wchar_t* name;
+	IniFieldType type;
+	IniFieldMember member;
+	size_t size;
+	bool required;
+	double defaultValue;
+};
+
+#define INI_FIELD_MEMBER(objectClass, field) \
+	[](PVOID object) -> PVOID { return &(((objectClass*)object)->field); }
+
+typedef struct _FitIniFileStats
+{
+	uint32_t numIndexedBlocks;
+	uint32_t numIndexedIds;
+	uint32_t numBlockLookups;
+	uint32_t numIdLookups;
+	uint32_t numIdMisses;
+	uint32_t numIdProbes; // index slots looked at, over all lookups
+} FitIniFileStats;
+
 //---------------------------------------------------------------------------
 //									FitIniFile
 class FitIniFile 
@@ -84,6 +145,8 @@ public:
 
 	HRESULT seekBlock(const std::wstring_view& blockId);
 
+	HRESULT readFields(const IniField* fields, size_t numFields, PVOID object);
+
 	HRESULT readIdFloat(const std::wstring_view& varName, float& value);
 	HRESULT readIdDouble(const std::wstring_view& varName, double& value);
 	HRESULT readIdBoolean(const std::wstring_view& varName, bool& value);
@@ -135,6 +198,12 @@ protected:
 	HRESULT findNextBlockStart(const std::wstring_view& line = nullptr, size_t lineLen = 0);
 	size_t countBlocks(void);
 
+	void buildIndex(void);
+	void clearIndex(void);
+	const IniIdNode* findId(const std::wstring_view& type, const std::wstring_view& varName);
+	void seekId(const std::wstring_view& type, const std::wstring_view& varName);
+	HRESULT getIdValue(const std::wstring_view& type, const std::wstring_view& varName, wchar_t* value, size_t valueLen);
+
 	HRESULT getNextWord(const std::wstring_view&& line, const std::wstring_view& buffer, size_t bufLen);
 
 	float textToFloat(const std::wstring_view& num);
@@ -175,8 +244,18 @@ protected:
 	size_t m_totalBlocks = 0; // Total number of blocks in file
 	size_t m_currentBlockOffset = 0; // Offset into file of block start
 	size_t m_currentBlockSize = 0; // Length of current block
+	size_t m_currentBlockNum = 0;
+
+	std::vector<char> m_fileText; // whole file, the value spans point in here
+	std::vector<char> m_keyText; // lower cased keys
+	std::vector<uint32_t> m_blockIndex; // block number + 1, zero for an empty slot
+	std::vector<IniIdNode> m_idIndex;
 
 };
 
+//---------------------------------------------------------------------------
+extern bool FitIniUseIndex;
+extern FitIniFileStats FitIniFileStatistics;
+
 //---------------------------------------------------------------------------
 #endif
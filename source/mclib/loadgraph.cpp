@@ -0,0 +1,442 @@
+//---------------------------------------------------------------------------
+//
+// LoadGraph.cpp -- Load steps as a graph of tasks
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//---------------------------------------------------------------------------
+// Include Files
+#include "stdinc.h"
+
+#ifndef LOADGRAPH_H
+#include "loadgraph.h"
+#endif
+
+#ifndef FILE_H
+#include "file.h"
+#endif
+
+//---------------------------------------------------------------------------
+// Static Globals
+
+bool LoadGraphSerial = false;
+int32_t LoadGraphWorkers = -1; // -1 is one less than the machine has
+wchar_t LoadTimelinePath[80] = {0};
+LoadGraphStats LoadGraphStatistics = {0, 0, 0, 0, 0, 0, 0, 0};
+
+//---------------------------------------------------------------------------
+// class LoadGraph
+LoadGraph::LoadGraph(void)
+{
+	numWorkers = 0;
+	running = false;
+	serial = false;
+	progress = nullptr;
+	progressStart = 0.0f;
+	progressRange = 0.0f;
+	totalWeight = 0.0f;
+	doneWeight = 0.0f;
+	startCycles = 0;
+	endCycles = 0;
+}
+
+//---------------------------------------------------------------------------
+void
+LoadGraph::destroy(void)
+{
+	if (running)
+		finish();
+	tasks.clear();
+	readyTasks.clear();
+}
+
+//---------------------------------------------------------------------------
+// A step the loading thread runs itself, between beginTask and finishTask.
+int32_t
+LoadGraph::addTask(const char* name, float weight)
+{
+	return (addTask(name, weight, std::function<void(void)>()));
+}
+
+//---------------------------------------------------------------------------
+// A task the pool may run.  The work must not touch the heaps, the file
+// system tables or any game global -- it gets its own files and buffers.
+int32_t
+LoadGraph::addTask(const char* name, float weight, std::function<void(void)> work)
+{
+	gosASSERT(!running);
+	LoadTask task;
+	task.name = name;
+	task.work = std::move(work);
+	task.weight = weight;
+	task.numDependencies = 0;
+	task.numWaiting = 0;
+	task.state = LOAD_TASK_WAITING;
+	task.thread = -1;
+	task.startCycles = 0;
+	task.endCycles = 0;
+	task.pathCycles = 0;
+	task.pathPrev = -1;
+	task.critical = false;
+	tasks.push_back(std::move(task));
+	return ((int32_t)tasks.size() - 1);
+}
+
+//---------------------------------------------------------------------------
+void
+LoadGraph::addDependency(int32_t task, int32_t dependsOn)
+{
+	gosASSERT(!running);
+	gosASSERT((task >= 0) && (task < (int32_t)tasks.size()));
+	gosASSERT((dependsOn >= 0) && (dependsOn < task));
+	LoadTask& loadTask = tasks[task];
+	gosASSERT(loadTask.numDependencies < MAX_LOAD_DEPENDENCIES);
+	loadTask.dependencies[loadTask.numDependencies++] = dependsOn;
+}
+
+//---------------------------------------------------------------------------
+void
+LoadGraph::start(float& loadProgress, float start, float range)
+{
+	gosASSERT(!running);
+	serial = LoadGraphSerial;
+	progress = &loadProgress;
+	progressStart = start;
+	progressRange = range;
+	totalWeight = 0.0f;
+	doneWeight = 0.0f;
+	int32_t numWorkTasks = 0;
+	for (auto& task : tasks)
+	{
+		task.numWaiting = task.numDependencies;
+		task.state = LOAD_TASK_WAITING;
+		totalWeight += task.weight;
+		if (task.work)
+			numWorkTasks++;
+	}
+	//-----------------------------------------------------
+	// No point starting threads for a graph with no work
+	// of its own, or on a machine with nothing to spare.
+	numWorkers = 0;
+	if (!serial && numWorkTasks)
+	{
+		numWorkers = LoadGraphWorkers;
+		if (numWorkers < 0)
+			numWorkers = (int32_t)std::thread::hardware_concurrency() - 1;
+		if (numWorkers > numWorkTasks)
+			numWorkers = numWorkTasks;
+		if (numWorkers > MAX_LOAD_WORKERS)
+			numWorkers = MAX_LOAD_WORKERS;
+		if (numWorkers < 0)
+			numWorkers = 0;
+	}
+	LoadGraphStatistics.numDependencyStalls = 0;
+	LoadGraphStatistics.stallCycles = 0;
+	running = true;
+	startCycles = GetCycles();
+	for (size_t i = 0; i < numWorkers; i++)
+		workers[i] = std::thread(&LoadGraph::workerThread, this, (int32_t)i);
+	std::unique_lock<std::mutex> lock(graphLock);
+	for (size_t i = 0; i < tasks.size(); i++)
+		if (tasks[i].work && !tasks[i].numWaiting)
+		{
+			tasks[i].state = LOAD_TASK_READY;
+			readyTasks.push_back((int32_t)i);
+		}
+	if (numWorkers)
+		workWake.notify_all();
+	else
+		while (runReadyTask(lock))
+			;
+	lock.unlock();
+	*progress = progressStart;
+}
+
+//---------------------------------------------------------------------------
+// The loading thread is about to run one of its steps.  Anything the step
+// needs from the pool is waited for here; while it waits the loading
+// thread picks up ready work itself rather than sit idle.
+void
+LoadGraph::beginTask(int32_t task)
+{
+	gosASSERT(running);
+	gosASSERT((task >= 0) && (task < (int32_t)tasks.size()));
+	LoadTask& loadTask = tasks[task];
+	gosASSERT(!loadTask.work && (loadTask.state == LOAD_TASK_WAITING));
+	std::unique_lock<std::mutex> lock(graphLock);
+	if (loadTask.numWaiting)
+	{
+		//------------------------------------------------------
+		// Only the pool can finish what's left.  A step of our
+		// own still outstanding means the caller's order is off.
+		for (size_t i = 0; i < loadTask.numDependencies; i++)
+		{
+			LoadTask& dependency = tasks[loadTask.dependencies[i]];
+			gosASSERT(dependency.work || (dependency.state == LOAD_TASK_DONE));
+		}
+		int64_t stallStart = GetCycles();
+		while (loadTask.numWaiting)
+			if (!runReadyTask(lock))
+				doneWake.wait(lock);
+		LoadGraphStatistics.numDependencyStalls++;
+		LoadGraphStatistics.stallCycles += GetCycles() - stallStart;
+	}
+	loadTask.state = LOAD_TASK_RUNNING;
+	loadTask.thread = -1;
+	lock.unlock();
+	updateProgress();
+	loadTask.startCycles = GetCycles();
+}
+
+//---------------------------------------------------------------------------
+void
+LoadGraph::finishTask(int32_t task)
+{
+	gosASSERT(running);
+	gosASSERT((task >= 0) && (task < (int32_t)tasks.size()));
+	LoadTask& loadTask = tasks[task];
+	gosASSERT(!loadTask.work && (loadTask.state == LOAD_TASK_RUNNING));
+	loadTask.endCycles = GetCycles();
+	std::unique_lock<std::mutex> lock(graphLock);
+	completeTask(task);
+	if (!numWorkers)
+		while (runReadyTask(lock))
+			;
+	lock.unlock();
+	updateProgress();
+}
+
+//---------------------------------------------------------------------------
+// Waits out the pool, stops it and works out where the time went.
+void
+LoadGraph::finish(void)
+{
+	gosASSERT(running);
+	std::unique_lock<std::mutex> lock(graphLock);
+	for (;;)
+	{
+		bool outstanding = false;
+		for (auto& task : tasks)
+			if (task.state != LOAD_TASK_DONE)
+			{
+				gosASSERT(task.work);
+				outstanding = true;
+			}
+		if (!outstanding)
+			break;
+		if (!runReadyTask(lock))
+			doneWake.wait(lock);
+	}
+	running = false;
+	workWake.notify_all();
+	lock.unlock();
+	for (size_t i = 0; i < numWorkers; i++)
+		workers[i].join();
+	endCycles = GetCycles();
+	findCriticalPath();
+	*progress = progressStart + progressRange;
+}
+
+//---------------------------------------------------------------------------
+int64_t
+LoadGraph::getTaskCycles(int32_t task)
+{
+	gosASSERT((task >= 0) && (task < (int32_t)tasks.size()));
+	return (tasks[task].endCycles - tasks[task].startCycles);
+}
+
+//---------------------------------------------------------------------------
+// One line per task in the order they were added: who ran it, when it
+// started and ended (kilocycles from the start of the load), and a star
+// if it is on the critical path.
+int32_t
+LoadGraph::writeTimeline(const std::wstring_view& fileName)
+{
+	MechFile timelineFile;
+	int32_t result = timelineFile.create(fileName);
+	if (result != NO_ERROR)
+		return (result);
+	wchar_t dataLine[256];
+	sprintf(dataLine, "// %d tasks, %d workers, %lld kcycles total, %lld kcycles critical path",
+		(int32_t)tasks.size(), numWorkers, (endCycles - startCycles) / 1000,
+		LoadGraphStatistics.criticalPathCycles / 1000);
+	timelineFile.writeLine(dataLine);
+	for (auto& task : tasks)
+	{
+		wchar_t threadName[16];
+		if (task.thread < 0)
+			sprintf(threadName, "main");
+		else
+			sprintf(threadName, "worker%d", task.thread);
+		sprintf(dataLine, "%-24s %-8s %10lld %10lld %10lld %c", task.name, threadName,
+			(task.startCycles - startCycles) / 1000, (task.endCycles - startCycles) / 1000,
+			(task.endCycles - task.startCycles) / 1000, task.critical ? '*' : ' ');
+		timelineFile.writeLine(dataLine);
+	}
+	timelineFile.close();
+	return (NO_ERROR);
+}
+
+//---------------------------------------------------------------------------
+// Pool work for a load: reads a loose file through once, so the step that
+// parses it later finds it in the OS cache.  Uses nothing but its own
+// handle and buffer.  A file that only lives in a fastfile isn't found,
+// and doesn't need it -- the fastfile is mapped.  Returns the bytes read.
+size_t
+LoadGraphWarmFile(const std::wstring_view& fileName)
+{
+	int32_t handle = _open(fileName, _O_RDONLY);
+	if (handle == -1)
+		return (0);
+	uint8_t buffer[64 * 1024];
+	size_t bytesRead = 0;
+	int32_t result;
+	while ((result = _read(handle, buffer, sizeof(buffer))) > 0)
+		bytesRead += result;
+	_close(handle);
+	return (bytesRead);
+}
+
+//---------------------------------------------------------------------------
+void
+LoadGraph::workerThread(int32_t worker)
+{
+	std::unique_lock<std::mutex> lock(graphLock);
+	for (;;)
+	{
+		while (running && readyTasks.empty())
+			workWake.wait(lock);
+		if (readyTasks.empty())
+			break;
+		int32_t task = readyTasks.front();
+		readyTasks.pop_front();
+		tasks[task].state = LOAD_TASK_RUNNING;
+		lock.unlock();
+		runTask(task, worker);
+		lock.lock();
+	}
+}
+
+//---------------------------------------------------------------------------
+// Called without the lock.
+void
+LoadGraph::runTask(int32_t task, int32_t thread)
+{
+	LoadTask& loadTask = tasks[task];
+	loadTask.thread = thread;
+	loadTask.startCycles = GetCycles();
+	loadTask.work();
+	loadTask.endCycles = GetCycles();
+	{
+		std::lock_guard<std::mutex> lock(graphLock);
+		completeTask(task);
+	}
+	doneWake.notify_all();
+}
+
+//---------------------------------------------------------------------------
+// Called with the lock held.  Pool tasks this was the last dependency of
+// are queued; steps of the loading thread are left for beginTask.
+void
+LoadGraph::completeTask(int32_t task)
+{
+	tasks[task].state = LOAD_TASK_DONE;
+	doneWeight += tasks[task].weight;
+	for (size_t i = task + 1; i < tasks.size(); i++)
+	{
+		LoadTask& dependent = tasks[i];
+		for (size_t j = 0; j < dependent.numDependencies; j++)
+			if (dependent.dependencies[j] == task)
+			{
+				dependent.numWaiting--;
+				if (!dependent.numWaiting && dependent.work)
+				{
+					dependent.state = LOAD_TASK_READY;
+					readyTasks.push_back((int32_t)i);
+					workWake.notify_one();
+				}
+			}
+	}
+}
+
+//---------------------------------------------------------------------------
+// Called with the lock held, on the loading thread.  Runs one ready pool
+// task there; false if there weren't any.
+bool
+LoadGraph::runReadyTask(std::unique_lock<std::mutex>& lock)
+{
+	if (readyTasks.empty())
+		return (false);
+	int32_t task = readyTasks.front();
+	readyTasks.pop_front();
+	tasks[task].state = LOAD_TASK_RUNNING;
+	lock.unlock();
+	runTask(task, -1);
+	lock.lock();
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+// Progress is the weight of the tasks done so far.  Steps that move the
+// bar themselves in between are never pushed back.
+void
+LoadGraph::updateProgress(void)
+{
+	float done;
+	{
+		std::lock_guard<std::mutex> lock(graphLock);
+		done = doneWeight;
+	}
+	float value = progressStart;
+	if (totalWeight > 0.0f)
+		value += progressRange * done / totalWeight;
+	if (value > *progress)
+		*progress = value;
+}
+
+//---------------------------------------------------------------------------
+// The longest chain of dependent tasks by the time each one took.  Tasks
+// are added dependencies first, so one pass in order does it.
+void
+LoadGraph::findCriticalPath(void)
+{
+	int32_t last = -1;
+	int64_t workerCycles = 0;
+	uint32_t numWorkerTasks = 0;
+	for (size_t i = 0; i < tasks.size(); i++)
+	{
+		LoadTask& task = tasks[i];
+		task.pathPrev = -1;
+		task.critical = false;
+		int64_t longest = 0;
+		for (size_t j = 0; j < task.numDependencies; j++)
+		{
+			int32_t dependency = task.dependencies[j];
+			if ((task.pathPrev == -1) || (tasks[dependency].pathCycles > longest))
+			{
+				task.pathPrev = dependency;
+				longest = tasks[dependency].pathCycles;
+			}
+		}
+		task.pathCycles = longest + (task.endCycles - task.startCycles);
+		if ((last == -1) || (task.pathCycles > tasks[last].pathCycles))
+			last = (int32_t)i;
+		if (task.thread >= 0)
+		{
+			numWorkerTasks++;
+			workerCycles += task.endCycles - task.startCycles;
+		}
+	}
+	for (int32_t i = last; i != -1; i = tasks[i].pathPrev)
+		tasks[i].critical = true;
+	LoadGraphStatistics.numTasks = (uint32_t)tasks.size();
+	LoadGraphStatistics.numWorkerTasks = numWorkerTasks;
+	LoadGraphStatistics.numWorkers = numWorkers;
+	LoadGraphStatistics.totalCycles = endCycles - startCycles;
+	LoadGraphStatistics.criticalPathCycles = (last == -1) ? 0 : tasks[last].pathCycles;
+	LoadGraphStatistics.workerCycles = workerCycles;
+}
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+//---------------------------------------------------------------------------
+//
+// LoadGraph.h -- Load steps as a graph of tasks
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#pragma once
+
+#ifndef LOADGRAPH_H
+#define LOADGRAPH_H
+
+//---------------------------------------------------------------------------
+// Include Files
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// A load is a list of tasks and what each one needs done first.  Tasks
+// with work of their own are run by a small pool as soon as their
+// dependencies are done.  Tasks without are steps the loading thread runs
+// itself, in its own order, between beginTask and finishTask; those touch
+// the heaps and the game globals, which nothing else may do at the time.
+// Every loader in the game today is a step: the graph does not run them
+// side by side, it checks their order, times them and drives the progress
+// bar.  Pool work is limited to reading ahead for the steps.
+//
+// Dependencies must be added after the task they name, so the order tasks
+// are added in is always a good serial order.  With LoadGraphSerial set
+// (or no workers) every task runs on the loading thread as soon as it can.
+
+#define MAX_LOAD_WORKERS 4
+#define MAX_LOAD_DEPENDENCIES 8
+
+enum _load_task_state : int32_t
+{
+	LOAD_TASK_WAITING,
+	LOAD_TASK_READY,
+	LOAD_TASK_RUNNING,
+	LOAD_TASK_DONE
+};
+
+typedef struct _LoadTask
+{
+	const char* name;
+	std::function<void(void)> work; // empty for steps the loading thread runs
+	float weight; // share of the load progress bar
+	int32_t numDependencies;
+	int32_t dependencies[MAX_LOAD_DEPENDENCIES];
+	int32_t numWaiting; // dependencies not done yet
+	int32_t state;
+	int32_t thread; // -1 is the loading thread
+	int64_t startCycles;
+	int64_t endCycles;
+	int64_t pathCycles; // longest chain of tasks ending with this one
+	int32_t pathPrev;
+	bool critical;
+} LoadTask;
+
+typedef struct _LoadGraphStats
+{
+	uint32_t numTasks;
+	uint32_t numWorkerTasks; // tasks the pool ran
+	uint32_t numWorkers;
+	uint32_t numDependencyStalls; // the loading thread waited on a worker
+	int64_t totalCycles;
+	int64_t criticalPathCycles;
+	int64_t workerCycles;
+	int64_t stallCycles;
+} LoadGraphStats;
+
+//---------------------------------------------------------------------------
+class LoadGraph
+{
+protected:
+	std::vector<LoadTask> tasks;
+	std::mutex graphLock;
+	std::condition_variable workWake; // a task became ready
+	std::condition_variable doneWake; // a task finished
+	std::deque<int32_t> readyTasks;
+	std::thread workers[MAX_LOAD_WORKERS];
+	int32_t numWorkers;
+	bool running;
+	bool serial;
+	float* progress;
+	float progressStart;
+	float progressRange;
+	float totalWeight;
+	float doneWeight;
+	int64_t startCycles;
+	int64_t endCycles;
+
+public:
+	LoadGraph(void);
+	~LoadGraph(void) { destroy(); }
+
+	void destroy(void);
+
+	int32_t addTask(const char* name, float weight);
+	int32_t addTask(const char* name, float weight, std::function<void(void)> work);
+	void addDependency(int32_t task, int32_t dependsOn);
+
+	void start(float& loadProgress, float start, float range);
+	void beginTask(int32_t task);
+	void finishTask(int32_t task);
+	void finish(void);
+
+	int64_t getTaskCycles(int32_t task);
+	int32_t writeTimeline(const std::wstring_view& fileName);
+
+protected:
+	void workerThread(int32_t worker);
+	void runTask(int32_t task, int32_t thread);
+	void completeTask(int32_t task);
+	bool runReadyTask(std::unique_lock<std::mutex>& lock);
+	void updateProgress(void);
+	void findCriticalPath(void);
+};
+
+//---------------------------------------------------------------------------
+size_t LoadGraphWarmFile(const std::wstring_view& fileName);
+
+extern bool LoadGraphSerial;
+extern int32_t LoadGraphWorkers;
+extern wchar_t LoadTimelinePath[];
+extern LoadGraphStats LoadGraphStatistics;
+
+//---------------------------------------------------------------------------
+#endif
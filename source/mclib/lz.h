@@ -13,8 +13,26 @@
 typedef uint8_t* uint8_t*;
 size_t
 LZDecomp(uint8_t* dest, uint8_t* src, size_t srcLen);
+// Bounds checked both ways.  Use this one when the unpacked size is known.
+size_t
+LZDecomp(uint8_t* dest, size_t destLen, const uint8_t* src, size_t srcLen);
+// The original decoder, for checking the one above against.
+size_t
+LZDecompReference(uint8_t* dest, uint8_t* src, size_t srcLen);
 size_t
 LZCompress(uint8_t* dest, uint8_t* src, size_t len);
 
+//---------------------------------------------------------------------------
+// LZ block codec (lzblock.cpp).  Bounds checked both ways, returns zero on
+// failure.  Compress into at least LZBCompressBound(len) bytes to never fail.
+size_t
+LZBCompressBound(size_t len);
+size_t
+LZBCompress(uint8_t* dest, size_t destLen, const uint8_t* src, size_t srcLen);
+size_t
+LZBDecomp(uint8_t* dest, size_t destLen, const uint8_t* src, size_t srcLen);
+bool
+LZBTestClass(void);
+
 //---------------------------------------------------------------------------
 #endif
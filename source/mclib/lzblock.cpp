@@ -0,0 +1,239 @@
+//--------------------------------------------------------------------------
+// LZ Block Compress/Decompress Routines
+//
+// Byte aligned LZ77 blocks (the LZ4 block layout).  Every sequence is a
+// token byte (literal count in the high nibble, match length - 4 in the
+// low), extra length bytes when a nibble is 15, the literals, then a two
+// byte little endian back offset.  The last sequence is literals only.
+// Nothing to rebuild on the decode side, no bit reader, no tables: just
+// copies.  Slower to pack than zLib, much faster to unpack.
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//#include "stdinc.h"
+#include "lz.h"
+
+#include <string.h>
+
+//---------------------------------------------------------------------------
+// Static Globals
+
+enum __lzblock_const : uint32_t
+{
+	LZB_MIN_MATCH = 4,
+	LZB_MAX_OFFSET = 65535,
+	LZB_LAST_LITERALS = 5, // the last 5 bytes are always literals
+	LZB_MATCH_LIMIT = 12, // no match may start in the last 12 bytes
+	LZB_HASH_BITS = 12,
+	LZB_HASH_SIZE = (1 << LZB_HASH_BITS),
+	LZB_SKIP_SHIFT = 6, // step up the search after 64 misses in a row
+};
+
+//---------------------------------------------------------------------------
+static inline uint32_t
+LZBRead32(const uint8_t* p)
+{
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+//---------------------------------------------------------------------------
+static inline uint32_t
+LZBHash(uint32_t sequence)
+{
+	return ((sequence * 2654435761U) >> (32 - LZB_HASH_BITS));
+}
+
+//---------------------------------------------------------------------------
+static inline uint8_t*
+LZBWriteLength(uint8_t* op, size_t length)
+{
+	while (length >= 255)
+	{
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (uint8_t)length;
+	return op;
+}
+
+//-------------------------------------------------------------------------------
+// Worst case packed size of len bytes.  A dest buffer this big never fails.
+size_t
+LZBCompressBound(size_t len)
+{
+	return (len + (len / 255) + 16);
+}
+
+//-------------------------------------------------------------------------------
+// LZ Block Compress Routine
+// Takes a pointer to dest buffer and its size, a pointer to source buffer and
+// len of source.  Returns length of packed image or zero if it didn't fit.
+size_t
+LZBCompress(uint8_t* dest, size_t destLen, const uint8_t* src, size_t srcLen)
+{
+	if (!dest || !src || (srcLen > 0x7E000000))
+		return 0;
+	uint32_t hashTable[LZB_HASH_SIZE];
+	memset(hashTable, 0, sizeof(hashTable));
+	const uint8_t* ip = src;
+	const uint8_t* anchor = src;
+	const uint8_t* iend = src + srcLen;
+	uint8_t* op = dest;
+	uint8_t* oend = dest + destLen;
+	if (srcLen > LZB_MATCH_LIMIT)
+	{
+		const uint8_t* mflimit = iend - LZB_MATCH_LIMIT;
+		const uint8_t* matchlimit = iend - LZB_LAST_LITERALS;
+		ip++;
+		while (ip < mflimit)
+		{
+			//-------------------------------------------------
+			// Only the most recent position per hash is kept.
+			// Good enough, and the table stays in L1.
+			uint32_t sequence = LZBRead32(ip);
+			uint32_t hash = LZBHash(sequence);
+			const uint8_t* ref = src + hashTable[hash];
+			hashTable[hash] = (uint32_t)(ip - src);
+			if (((size_t)(ip - ref) > LZB_MAX_OFFSET) || (ref >= ip) || (LZBRead32(ref) != sequence))
+			{
+				ip += 1 + ((ip - anchor) >> LZB_SKIP_SHIFT);
+				continue;
+			}
+			while ((ip > anchor) && (ref > src) && (ip[-1] == ref[-1]))
+			{
+				ip--;
+				ref--;
+			}
+			const uint8_t* matchEnd = ip + LZB_MIN_MATCH;
+			const uint8_t* refEnd = ref + LZB_MIN_MATCH;
+			while ((matchEnd < matchlimit) && (*matchEnd == *refEnd))
+			{
+				matchEnd++;
+				refEnd++;
+			}
+			size_t literals = ip - anchor;
+			size_t matchLength = (matchEnd - ip) - LZB_MIN_MATCH;
+			size_t worstCase = 1 + literals + (literals / 255) + 1 + 2 + (matchLength / 255) + 1;
+			if (worstCase > (size_t)(oend - op))
+				return 0;
+			uint8_t* token = op++;
+			*token = (uint8_t)(((literals >= 15) ? 15 : literals) << 4);
+			if (literals >= 15)
+				op = LZBWriteLength(op, literals - 15);
+			memcpy(op, anchor, literals);
+			op += literals;
+			size_t offset = ip - ref;
+			*op++ = (uint8_t)(offset & 0xFF);
+			*op++ = (uint8_t)(offset >> 8);
+			*token |= (uint8_t)((matchLength >= 15) ? 15 : matchLength);
+			if (matchLength >= 15)
+				op = LZBWriteLength(op, matchLength - 15);
+			ip = anchor = matchEnd;
+			//-------------------------------------------------
+			// Seed the table from inside the match so the next
+			// repeat of this run is found right away.
+			if (ip < mflimit)
+				hashTable[LZBHash(LZBRead32(ip - 2))] = (uint32_t)(ip - 2 - src);
+		}
+	}
+	//----------------------------------
+	// Whatever is left goes as literals.
+	size_t literals = iend - anchor;
+	if ((1 + literals + (literals / 255) + 1) > (size_t)(oend - op))
+		return 0;
+	*op++ = (uint8_t)(((literals >= 15) ? 15 : literals) << 4);
+	if (literals >= 15)
+		op = LZBWriteLength(op, literals - 15);
+	memcpy(op, anchor, literals);
+	op += literals;
+	return (op - dest);
+}
+
+//-------------------------------------------------------------------------------
+// LZ Block DeCompress Routine
+// Takes a pointer to dest buffer and its size, a pointer to source buffer and
+// len of source.  Returns length of decompressed image.  Never reads or writes
+// outside either buffer; returns zero on a damaged block.
+size_t
+LZBDecomp(uint8_t* dest, size_t destLen, const uint8_t* src, size_t srcLen)
+{
+	if (!dest || !src || !srcLen)
+		return 0;
+	const uint8_t* ip = src;
+	const uint8_t* iend = src + srcLen;
+	uint8_t* op = dest;
+	uint8_t* oend = dest + destLen;
+	for (;;)
+	{
+		uint32_t token = *ip++;
+		size_t literals = token >> 4;
+		if (literals == 15)
+		{
+			uint32_t extra;
+			do
+			{
+				if (ip >= iend)
+					return 0;
+				extra = *ip++;
+				literals += extra;
+			} while (extra == 255);
+		}
+		if ((literals > (size_t)(iend - ip)) || (literals > (size_t)(oend - op)))
+			return 0;
+		//--------------------------------------------------------
+		// Short runs are the common case.  With room on both sides
+		// copy a fixed 16 bytes and let the next sequence overwrite
+		// the tail.
+		if ((literals <= 16) && ((iend - ip) >= 16) && ((oend - op) >= 16))
+			memcpy(op, ip, 16);
+		else
+			memcpy(op, ip, literals);
+		op += literals;
+		ip += literals;
+		if (ip == iend)
+			break; // last sequence has no match
+		if ((iend - ip) < 2)
+			return 0;
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if ((offset == 0) || (offset > (size_t)(op - dest)))
+			return 0;
+		size_t matchLength = token & 15;
+		if (matchLength == 15)
+		{
+			uint32_t extra;
+			do
+			{
+				if (ip >= iend)
+					return 0;
+				extra = *ip++;
+				matchLength += extra;
+			} while (extra == 255);
+		}
+		matchLength += LZB_MIN_MATCH;
+		if (matchLength > (size_t)(oend - op))
+			return 0;
+		const uint8_t* ref = op - offset;
+		if ((offset >= 8) && ((size_t)(oend - op) >= (matchLength + 7)))
+		{
+			//------------------------------------------------
+			// Eight bytes at a time.  An offset of at least 8
+			// means every chunk read is already written.
+			for (size_t copied = 0; copied < matchLength; copied += 8)
+				memcpy(op + copied, ref + copied, 8);
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; i++)
+				op[i] = ref[i];
+		}
+		op += matchLength;
+		if (ip >= iend)
+			return 0; // a block always ends in literals
+	}
+	return (op - dest);
+}
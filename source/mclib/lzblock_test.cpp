@@ -0,0 +1,86 @@
+//===========================================================================//
+// File:	lzblock_test.cpp                                                 //
+// Contents: test function for the LZ block codec                            //
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#include "stdinc.h"
+#include "lz.h"
+
+#define LZB_TEST_SIZE 200000
+
+//---------------------------------------------------------------------------
+// Packs src, checks the bound held, unpacks into a buffer of exactly the
+// right size and compares.
+
+static bool
+LZBRoundTrip(const uint8_t* src, size_t srcLen)
+{
+	std::vector<uint8_t> packed(LZBCompressBound(srcLen));
+	std::vector<uint8_t> unpacked(srcLen + 1);
+	size_t packedLen = LZBCompress(packed.data(), packed.size(), src, srcLen);
+	Test_Assumption(packedLen > 0);
+	Test_Assumption(packedLen <= packed.size());
+	Test_Assumption(LZBDecomp(unpacked.data(), srcLen, packed.data(), packedLen) == srcLen);
+	Test_Assumption(memcmp(src, unpacked.data(), srcLen) == 0);
+	return true;
+}
+
+//---------------------------------------------------------------------------
+
+bool
+LZBTestClass(void)
+{
+	SPEW((GROUP_STUFF_TEST, "Starting LZ block codec test..."));
+	std::vector<uint8_t> src(LZB_TEST_SIZE);
+	std::vector<uint8_t> packed(LZBCompressBound(LZB_TEST_SIZE));
+	std::vector<uint8_t> unpacked(LZB_TEST_SIZE);
+	uint32_t seed = 12345;
+	auto nextRandom = [&seed]() {
+		seed = seed * 1103515245 + 12345;
+		return ((seed >> 16) & 0xFF);
+	};
+	size_t i;
+	//------------------------------------------------------
+	// Nothing at all packs to a lone token, and a handful of
+	// bytes is all literals...
+	Test_Assumption(LZBCompress(packed.data(), packed.size(), src.data(), 0) == 1);
+	Test_Assumption(LZBRoundTrip((const uint8_t*)"MechCommander", 13));
+	//-------------------------------------------------------------
+	// A long run needs extra length bytes, and should pack to next
+	// to nothing...
+	Test_Assumption(LZBRoundTrip(src.data(), LZB_TEST_SIZE));
+	Test_Assumption(LZBCompress(packed.data(), packed.size(), src.data(), LZB_TEST_SIZE) < (LZB_TEST_SIZE / 100));
+	//----------------------------------------
+	// Noise doesn't pack, but stays in bound...
+	for (i = 0; i < LZB_TEST_SIZE; i++)
+		src[i] = (uint8_t)nextRandom();
+	Test_Assumption(LZBRoundTrip(src.data(), LZB_TEST_SIZE));
+	//------------------------------------------------------------
+	// Text with repeats close by and just inside the 64K offset...
+	for (i = 0; i < LZB_TEST_SIZE; i++)
+	{
+		if ((i >= 65000) && ((nextRandom() & 3) == 0))
+			src[i] = src[i - 65000];
+		else if ((i >= 20) && (nextRandom() & 1))
+			src[i] = src[i - 1 - (nextRandom() & 15)];
+		else
+			src[i] = (uint8_t)('a' + (nextRandom() % 26));
+	}
+	Test_Assumption(LZBRoundTrip(src.data(), LZB_TEST_SIZE));
+	//---------------------------------------------------------------
+	// Too little room fails cleanly both ways, as does a block that's
+	// been cut short...
+	size_t packedLen = LZBCompress(packed.data(), packed.size(), src.data(), LZB_TEST_SIZE);
+	Test_Assumption(packedLen > 0);
+	Test_Assumption(LZBCompress(packed.data(), packedLen / 2, src.data(), LZB_TEST_SIZE) == 0);
+	packedLen = LZBCompress(packed.data(), packed.size(), src.data(), LZB_TEST_SIZE);
+	Test_Assumption(LZBDecomp(unpacked.data(), LZB_TEST_SIZE - 1, packed.data(), packedLen) == 0);
+	Test_Assumption(LZBDecomp(unpacked.data(), LZB_TEST_SIZE, packed.data(), packedLen - 1) == 0);
+	//-------------------------------------------------------
+	// A back reference to before the start of the block, too...
+	uint8_t badBlock[] = {0x14, 'a', 0x10, 0x00, 0x10, 'b'};
+	Test_Assumption(LZBDecomp(unpacked.data(), LZB_TEST_SIZE, badBlock, sizeof(badBlock)) == 0);
+	return true;
+}
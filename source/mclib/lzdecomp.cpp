@@ -8,6 +8,8 @@
 //#include "stdinc.h"
 #include "lz.h"
 
+#include <string.h>
+
 //---------------------------------------------------------------------------
 // Static Globals
 
@@ -17,7 +19,9 @@ enum class __lzdecomp_const
 	HASH_EOF = 257, // End Of Data command code
 	HASH_FREE = 258, // First Hash Table Chain Offset value
 	BASE_BITS = 9,
+	MAX_BITS = 12,
 	MAX_BIT_INDEX = (1 << BASE_BITS),
+	MAX_CODES = (1 << MAX_BITS),
 	NO_RAM_FOR_LZ_DECOMP = 0xCBCB0002,
 };
 
@@ -47,11 +51,13 @@ wchar_t LZOldSuffix = 0; // Current Suffix value found
 //-----------------------------
 
 //-------------------------------------------------------------------------------
-// LZ DeCompress Routine
-// Takes a pointer to dest buffer, a pointer to source buffer and len of source.
-// returns length of decompressed image.
+// Reference LZ DeCompress Routine
+// The original decoder, one code at a time, walking each chain backwards onto
+// the stack.  Trusts its input completely.  Only kept so the codec benchmark
+// can check LZDecomp against it.
+#if defined(_M_IX86)
 size_t
-LZDecomp(uint8_t* dest, uint8_t* src, size_t srcLen)
+LZDecompReference(uint8_t* dest, uint8_t* src, size_t srcLen)
 {
 	size_t result = 0;
 	__asm {
@@ -259,4 +265,236 @@ LZDecomp(uint8_t* dest, uint8_t* src, size_t srcLen)
 		mov		result, edi
 	}
 	return (result);
-}
\ No newline at end of file
+}
+#else
+//-------------------------------------------------------------------------------
+// Same thing in C for targets without inline assembly.
+static inline uint32_t
+LZReadCode(const uint8_t* src, size_t bitPos, uint32_t numBits)
+{
+	const uint8_t* p = src + (bitPos >> 3);
+	uint32_t bits = p[0] | (p[1] << 8) | (p[2] << 16);
+	return ((bits >> (bitPos & 7)) & ((1 << numBits) - 1));
+}
+
+size_t
+LZDecompReference(uint8_t* dest, uint8_t* src, size_t srcLen)
+{
+	static uint16_t chain[MAX_CODES];
+	static uint8_t suffix[MAX_CODES];
+	static uint8_t stack[MAX_CODES];
+	uint8_t* op = dest;
+	size_t bitPos = 0;
+	uint32_t numBits = BASE_BITS;
+	uint32_t maxIndex = MAX_BIT_INDEX;
+	uint32_t freeIndex = HASH_FREE;
+	uint32_t oldChain = 0;
+	uint8_t oldSuffix = 0;
+	for (;;)
+	{
+		if (((bitPos >> 3) + 3) > srcLen)
+			break;
+		uint32_t code = LZReadCode(src, bitPos, numBits);
+		bitPos += numBits;
+		if (code == HASH_EOF)
+			break;
+		if (code == HASH_CLEAR)
+		{
+			numBits = BASE_BITS;
+			maxIndex = MAX_BIT_INDEX;
+			freeIndex = HASH_FREE;
+			if (((bitPos >> 3) + 3) > srcLen)
+				break;
+			code = LZReadCode(src, bitPos, numBits);
+			bitPos += numBits;
+			oldChain = code;
+			oldSuffix = (uint8_t)code;
+			*op++ = (uint8_t)code;
+			continue;
+		}
+		uint32_t newChain = code;
+		size_t depth = 0;
+		if (code >= freeIndex)
+		{
+			stack[depth++] = oldSuffix;
+			code = oldChain;
+		}
+		while ((code > 0xFF) && (depth < (MAX_CODES - 1)))
+		{
+			stack[depth++] = suffix[code];
+			code = chain[code];
+		}
+		oldSuffix = (uint8_t)code;
+		stack[depth++] = oldSuffix;
+		while (depth)
+			*op++ = stack[--depth];
+		if (freeIndex < MAX_CODES)
+		{
+			suffix[freeIndex] = oldSuffix;
+			chain[freeIndex] = (uint16_t)oldChain;
+		}
+		freeIndex++;
+		oldChain = newChain;
+		if ((freeIndex >= maxIndex) && (numBits != MAX_BITS))
+		{
+			numBits++;
+			maxIndex <<= 1;
+		}
+	}
+	return (op - dest);
+}
+#endif
+
+//-------------------------------------------------------------------------------
+// LZ DeCompress Routine
+// Takes a pointer to dest buffer and its size, a pointer to source buffer and
+// len of source.  Returns length of decompressed image, zero if the source is
+// damaged.  Output is identical to the reference decoder's on anything
+// LZCompress wrote.
+//
+// Codes come out of a 64 bit bit buffer refilled eight bytes at a time.  No
+// chains are walked: every table entry is some earlier stretch of the output
+// (the previous string plus the next one's first byte), so it's kept as an
+// offset and length and decoded with one copy, eight bytes at a go when the
+// copy doesn't overlap itself closer than that.
+static inline void
+LZCopyMatch(uint8_t* op, size_t distance, size_t length, size_t room)
+{
+	const uint8_t* ref = op - distance;
+	if ((distance >= 8) && (room >= (length + 7)))
+	{
+		for (size_t copied = 0; copied < length; copied += 8)
+			memcpy(op + copied, ref + copied, 8);
+	}
+	else
+	{
+		for (size_t i = 0; i < length; i++)
+			op[i] = ref[i];
+	}
+}
+
+size_t
+LZDecomp(uint8_t* dest, size_t destLen, const uint8_t* src, size_t srcLen)
+{
+	uint32_t entryOffset[MAX_CODES];
+	uint16_t entryLength[MAX_CODES];
+	size_t written = 0;
+	uint64_t bitBuffer = 0;
+	uint32_t bitCount = 0;
+	size_t readPos = 0;
+	size_t bitPos = 0; // bits used so far, for the reference's end check
+	uint32_t numBits = BASE_BITS;
+	uint32_t codeMask = MAX_BIT_INDEX - 1;
+	uint32_t maxIndex = MAX_BIT_INDEX;
+	uint32_t freeIndex = HASH_FREE;
+	size_t prevOffset = 0;
+	size_t prevLength = 0; // zero until the first CLEAR
+	for (;;)
+	{
+		//------------------------------------------------------
+		// The reference stops when fewer than three bytes are
+		// left at the current code.  So do we, at the same code.
+		if (((bitPos >> 3) + 3) > srcLen)
+			break;
+		if (bitCount < MAX_BITS)
+		{
+			if ((srcLen - readPos) >= 8)
+			{
+				uint64_t word;
+				memcpy(&word, src + readPos, sizeof(word));
+				bitBuffer |= word << bitCount;
+				uint32_t bytesUsed = (63 - bitCount) >> 3;
+				readPos += bytesUsed;
+				bitCount += bytesUsed << 3;
+			}
+			else
+			{
+				while ((bitCount <= 56) && (readPos < srcLen))
+				{
+					bitBuffer |= (uint64_t)src[readPos++] << bitCount;
+					bitCount += 8;
+				}
+			}
+		}
+		uint32_t code = (uint32_t)bitBuffer & codeMask;
+		bitBuffer >>= numBits;
+		bitCount -= numBits;
+		bitPos += numBits;
+		if (code == HASH_EOF)
+			break;
+		if (code == HASH_CLEAR)
+		{
+			numBits = BASE_BITS;
+			codeMask = MAX_BIT_INDEX - 1;
+			maxIndex = MAX_BIT_INDEX;
+			freeIndex = HASH_FREE;
+			prevLength = 0;
+			continue;
+		}
+		size_t length;
+		if (!prevLength)
+		{
+			//---------------------------------------------
+			// First code after a CLEAR is a plain byte.
+			if ((code > 0xFF) || (written == destLen))
+				return 0;
+			dest[written] = (uint8_t)code;
+			prevOffset = written++;
+			prevLength = 1;
+			continue;
+		}
+		if (code <= 0xFF)
+		{
+			if (written == destLen)
+				return 0;
+			dest[written] = (uint8_t)code;
+			length = 1;
+		}
+		else if ((code < freeIndex) && (code < MAX_CODES))
+		{
+			length = entryLength[code];
+			if (length > (destLen - written))
+				return 0;
+			LZCopyMatch(dest + written, written - entryOffset[code], length, destLen - written);
+		}
+		else if (code == freeIndex)
+		{
+			//---------------------------------------------
+			// Not in the table yet: previous string plus
+			// its own first byte, which is the same as
+			// copying one past the end of it.
+			length = prevLength + 1;
+			if (length > (destLen - written))
+				return 0;
+			LZCopyMatch(dest + written, written - prevOffset, length, destLen - written);
+		}
+		else
+		{
+			return 0;
+		}
+		if (freeIndex < MAX_CODES)
+		{
+			entryOffset[freeIndex] = (uint32_t)prevOffset;
+			entryLength[freeIndex] = (uint16_t)(prevLength + 1);
+		}
+		freeIndex++;
+		if ((freeIndex >= maxIndex) && (numBits != MAX_BITS))
+		{
+			numBits++;
+			codeMask = (codeMask << 1) | 1;
+			maxIndex <<= 1;
+		}
+		prevOffset = written;
+		prevLength = length;
+		written += length;
+	}
+	return (written);
+}
+
+//-------------------------------------------------------------------------------
+// Old entry point, for callers that don't know how big dest is.
+size_t
+LZDecomp(uint8_t* dest, uint8_t* src, size_t srcLen)
+{
+	return LZDecomp(dest, SIZE_MAX, src, srcLen);
+}
@@ -83,7 +83,7 @@ float cloudScrollY = 0.0f;
 
 PVOIDMapData::operator new(size_t mySize)
 {
-	PVOID result = Terrain::terrainHeap->Malloc(mySize);
+	PVOID result = Terrain::terrainHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
@@ -98,6 +98,12 @@ MapData::operator delete(PVOID us)
 void
 MapData::destroy(void)
 {
+	if (tiles)
+	{
+		delete tiles;
+		tiles = nullptr;
+	}
+	blocks = nullptr;
 	HeapManager::destroy();
 	if (blankVertex)
 	{
@@ -116,6 +122,7 @@ MapData::newInit(uint32_t numVertices)
 	gosASSERT(result == NO_ERROR);
 	result = commitHeap();
 	gosASSERT(result == NO_ERROR);
+	mapSide = Terrain::realVerticesMapSide;
 	//-----------------------------------------------------------
 	// There is one (1) block of memory for the ENTIRE terrain now.
 	// Since we no longer cache any aspect of the terrain, this is
@@ -142,6 +149,13 @@ MapData::newInit(PacketFile* newFile, uint32_t numVertices)
 {
 	newInit(numVertices);
 	newFile->readPacket(newFile->getCurrentPacket(), (uint8_t*)blocks);
+	//-------------------------------------------------------------
+	// The map comes off disk as one flat packet.  A big one goes
+	// into tiles as soon as it is in, and every pass from here on
+	// (transitions, water, lighting) pages the tiles it needs in a
+	// row at a time rather than put the flat map back.
+	if (MapDataUseTiles)
+		packMap();
 	calcTransitions();
 }
 
@@ -149,8 +163,65 @@ MapData::newInit(PacketFile* newFile, uint32_t numVertices)
 int32_t
 MapData::save(PacketFile* file, int32_t whichPacket)
 {
-	return file->writePacket(whichPacket, (uint8_t*)blocks,
+	bool unpacked = unpackMap();
+	int32_t result = file->writePacket(whichPacket, (uint8_t*)blocks,
 		Terrain::realVerticesMapSide * Terrain::realVerticesMapSide * sizeof(PostcompVertex));
+	if (unpacked)
+		packMap();
+	return (result);
+}
+
+//---------------------------------------------------------------------------
+// Saving writes the map out as one flat packet, so on a tiled map it is
+// put back together for the save and cut up again afterwards.  Nothing
+// else flattens a tiled map; the passes below go through getVertex.
+bool
+MapData::unpackMap(void)
+{
+	if (!isTiled())
+		return (false);
+	int32_t result = commitHeap();
+	gosASSERT(result == NO_ERROR);
+	blocks = (PostcompVertexPtr)getHeapPtr();
+	tiles->unpack(blocks);
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+void
+MapData::packMap(void)
+{
+	if (!tiles)
+	{
+		tiles = new MapTiles;
+		gosASSERT(tiles != nullptr);
+		if (tiles->init(blocks, mapSide, MapTileBudget, Terrain::terrainHeap) != NO_ERROR)
+		{
+			//-------------------------------------
+			// No room for the tiles.  Stay flat.
+			delete tiles;
+			tiles = nullptr;
+			MapDataUseTiles = false;
+			return;
+		}
+	}
+	else
+		tiles->pack(blocks);
+	blocks = nullptr;
+	decommitHeap();
+}
+
+//---------------------------------------------------------------------------
+void
+MapData::requestArea(const Stuff::Vector3D& position, int32_t radius)
+{
+	if (!isTiled())
+		return;
+	int32_t vertexX =
+		float2long((position.x - Terrain::mapTopLeft3d.x) * Terrain::oneOverWorldUnitsPerVertex);
+	int32_t vertexY =
+		float2long((Terrain::mapTopLeft3d.y - position.y) * Terrain::oneOverWorldUnitsPerVertex);
+	tiles->requestArea(vertexX, vertexY, radius);
 }
 
 //---------------------------------------------------------------------------
@@ -158,32 +229,30 @@ void
 MapData::highlightAllTransitionsOver2(void)
 {
 	unhighlightAll();
-	PostcompVertexPtr currentVertex = blocks;
 	//--------------------------------------------------------------------------
 	// This pass is used to mark the transitions over the value of 2
 	for (size_t y = 0; y < (Terrain::realVerticesMapSide - 1); y++)
 	{
+		nextPassRow();
 		for (size_t x = 0; x < (Terrain::realVerticesMapSide - 1); x++)
 		{
 			//-----------------------------------------------
 			// Get the data needed to make this terrain quad
-			PostcompVertex* pVertex1 = currentVertex;
-			PostcompVertex* pVertex2 = currentVertex + 1;
-			PostcompVertex* pVertex3 = currentVertex + Terrain::realVerticesMapSide + 1;
-			PostcompVertex* pVertex4 = currentVertex + Terrain::realVerticesMapSide;
+			PostcompVertex* pVertex1 = getVertex(x, y);
+			PostcompVertex* pVertex2 = getVertex(x + 1, y);
+			PostcompVertex* pVertex3 = getVertex(x + 1, y + 1);
+			PostcompVertex* pVertex4 = getVertex(x, y + 1);
 			//-------------------------------------------------------------------------------
 			int32_t totalNotEqual1 = abs((pVertex1->terrainType != pVertex2->terrainType) + (pVertex3->terrainType != pVertex4->terrainType) + (pVertex2->terrainType != pVertex4->terrainType));
 			int32_t totalNotEqual2 = abs((pVertex2->terrainType != pVertex3->terrainType) + (pVertex1->terrainType != pVertex4->terrainType) + (pVertex1->terrainType != pVertex3->terrainType));
 			if ((totalNotEqual1 >= 2) && (totalNotEqual2 >= 2))
 			{
-				pVertex1->highlighted = true;
-				pVertex2->highlighted = true;
-				pVertex3->highlighted = true;
-				pVertex4->highlighted = true;
+				getVertex(x, y, true)->highlighted = true;
+				getVertex(x + 1, y, true)->highlighted = true;
+				getVertex(x + 1, y + 1, true)->highlighted = true;
+				getVertex(x, y + 1, true)->highlighted = true;
 			}
-			currentVertex++;
 		}
-		currentVertex++;
 	}
 }
 
@@ -191,19 +260,19 @@ MapData::highlightAllTransitionsOver2(void)
 void
 MapData::calcTransitions()
 {
-	PostcompVertexPtr currentVertex = blocks;
 	//--------------------------------------------------------------------------
 	// This pass is used to calc the transitions.
 	for (size_t y = 0; y < (Terrain::realVerticesMapSide - 1); y++)
 	{
+		nextPassRow();
 		for (size_t x = 0; x < (Terrain::realVerticesMapSide - 1); x++)
 		{
 			//-----------------------------------------------
 			// Get the data needed to make this terrain quad
-			PostcompVertex* pVertex1 = currentVertex;
-			PostcompVertex* pVertex2 = currentVertex + 1;
-			PostcompVertex* pVertex3 = currentVertex + Terrain::realVerticesMapSide + 1;
-			PostcompVertex* pVertex4 = currentVertex + Terrain::realVerticesMapSide;
+			PostcompVertex* pVertex1 = getVertex(x, y, true);
+			PostcompVertex* pVertex2 = getVertex(x + 1, y);
+			PostcompVertex* pVertex3 = getVertex(x + 1, y + 1);
+			PostcompVertex* pVertex4 = getVertex(x, y + 1);
 			//-------------------------------------------------------------------------------
 			// Store texture in bottom part from TxmIndex provided by
 			// TerrainTextureManager
@@ -219,9 +288,7 @@ MapData::calcTransitions()
 			uint32_t txmResult = Terrain::terrainTextures->setTexture(terrainType, overlayType);
 			pVertex1->textureData += txmResult;
 			gosASSERT((pVertex1->textureData & 0x0000ffff) != 0xffff);
-			currentVertex++;
 		}
-		currentVertex++;
 	}
 	uint32_t terrainType = MC_BLUEWATER_TYPE + (MC_BLUEWATER_TYPE << 8) + (MC_BLUEWATER_TYPE << 16) + (MC_BLUEWATER_TYPE << 24);
 	WaterTXMData = Terrain::terrainTextures->setTexture(terrainType, 0xffff);
@@ -236,7 +303,6 @@ int32_t waterTest = 0; // Stores the water test elevation.  Everything at or
 void
 MapData::calcWater(float wDepth, float sDepth, float aDepth)
 {
-	PostcompVertexPtr currentVertex = blocks;
 	//---------------------------------------------------------------------------
 	// BETTER.  Store bits in top to indicate which way water goes.  Store 2
 	// bits so water doesn't have to animate either! Try random.  May look way
@@ -246,8 +312,10 @@ MapData::calcWater(float wDepth, float sDepth, float aDepth)
 	uint8_t marker = 0;
 	for (size_t y = 0; y < (Terrain::realVerticesMapSide - 1); y++)
 	{
+		nextPassRow();
 		for (size_t x = 0; x < (Terrain::realVerticesMapSide - 1); x++)
 		{
+			PostcompVertexPtr currentVertex = getVertex(x, y, true);
 			if (currentVertex->elevation < wDepth)
 			{
 				currentVertex->water = 1 + marker;
@@ -256,7 +324,6 @@ MapData::calcWater(float wDepth, float sDepth, float aDepth)
 			{
 				currentVertex->water = 0 + marker;
 			}
-			currentVertex++;
 			if (RollDice(50))
 				odd1 ^= true;
 			if (RollDice(50))
@@ -264,8 +331,8 @@ MapData::calcWater(float wDepth, float sDepth, float aDepth)
 			marker = (odd1 ? 0x80 : 0x0);
 			marker += (odd2 ? 0x40 : 0x0);
 		}
-		currentVertex++; // Do not flip odd here so each row starts opposite the
-			// previous
+		// Do not flip odd here so each row starts opposite the
+		// previous
 	}
 	Terrain::waterElevation = wDepth + sDepth;
 	waterDepth = wDepth;
@@ -277,14 +344,15 @@ MapData::calcWater(float wDepth, float sDepth, float aDepth)
 void
 MapData::recalcWater(void)
 {
-	PostcompVertexPtr currentVertex = blocks;
 	bool odd1 = false;
 	bool odd2 = false;
 	uint8_t marker = 0;
 	for (size_t y = 0; y < (Terrain::realVerticesMapSide - 1); y++)
 	{
+		nextPassRow();
 		for (size_t x = 0; x < (Terrain::realVerticesMapSide - 1); x++)
 		{
+			PostcompVertexPtr currentVertex = getVertex(x, y, true);
 			if (currentVertex->elevation < waterDepth)
 			{
 				currentVertex->water = 1 + marker;
@@ -293,7 +361,6 @@ MapData::recalcWater(void)
 			{
 				currentVertex->water = 0 + marker;
 			}
-			currentVertex++;
 			if (RollDice(50))
 				odd1 ^= true;
 			if (RollDice(50))
@@ -301,8 +368,8 @@ MapData::recalcWater(void)
 			marker = (odd1 ? 0x80 : 0x0);
 			marker += (odd2 ? 0x40 : 0x0);
 		}
-		currentVertex++; // Do not flip odd here so each row starts opposite the
-			// previous
+		// Do not flip odd here so each row starts opposite the
+		// previous
 	}
 }
 
@@ -311,9 +378,9 @@ float
 MapData::getTopLeftElevation(void)
 {
 	float result = 0.0;
-	if (blocks)
+	if (blocks || tiles)
 	{
-		result = blocks->elevation;
+		result = getVertex(0, 0)->elevation;
 	}
 	return (result);
 }
@@ -329,14 +396,14 @@ float SCROLL_RATE = 0.005f;
 void
 MapData::setVertexheight(int32_t VertexIndex, float Val)
 {
-	blocks[VertexIndex].elevation = Val;
+	getVertex(VertexIndex % mapSide, VertexIndex / mapSide, true)->elevation = Val;
 }
 
 //---------------------------------------------------------------------------
 float
 MapData::getVertexheight(int32_t VertexIndex)
 {
-	return blocks[VertexIndex].elevation;
+	return getVertex(VertexIndex % mapSide, VertexIndex / mapSide)->elevation;
 }
 
 #define ContrastEnhance 1.0f
@@ -358,12 +425,13 @@ MapData::calcLight(void)
 	lightDir *= 64.0f;
 	//---------------------
 	// Lighting Pass Here
-	PostcompVertexPtr currentVertex = blocks;
 	for (size_t i = 0; i < totalVertices; i++)
 	{
 		int32_t diskMapIndex = i;
 		int32_t x = i % Terrain::realVerticesMapSide;
 		int32_t y = i / Terrain::realVerticesMapSide;
+		if (x == 0)
+			nextPassRow();
 		//------------------------------------------------
 		// Check Bounds to make sure we don't go off map
 		if (((diskMapIndex - Terrain::realVerticesMapSide - 1) < 0) || ((diskMapIndex - Terrain::realVerticesMapSide) < 0) || ((diskMapIndex - 1) < 0))
@@ -384,15 +452,15 @@ MapData::calcLight(void)
 			// No problem
 			// Generate at will!
 			PostcompVertexPtr v0, v1, v2, v3, v4, v5, v6, v7, v8;
-			v0 = currentVertex;
-			v1 = currentVertex - Terrain::realVerticesMapSide - 1;
-			v2 = currentVertex - Terrain::realVerticesMapSide;
-			v3 = currentVertex - Terrain::realVerticesMapSide + 1;
-			v4 = currentVertex + 1;
-			v5 = currentVertex + Terrain::realVerticesMapSide + 1;
-			v6 = currentVertex + Terrain::realVerticesMapSide;
-			v7 = currentVertex + Terrain::realVerticesMapSide - 1;
-			v8 = currentVertex - 1;
+			v0 = getVertexAt(diskMapIndex, true);
+			v1 = getVertexAt(diskMapIndex - Terrain::realVerticesMapSide - 1);
+			v2 = getVertexAt(diskMapIndex - Terrain::realVerticesMapSide);
+			v3 = getVertexAt(diskMapIndex - Terrain::realVerticesMapSide + 1);
+			v4 = getVertexAt(diskMapIndex + 1);
+			v5 = getVertexAt(diskMapIndex + Terrain::realVerticesMapSide + 1);
+			v6 = getVertexAt(diskMapIndex + Terrain::realVerticesMapSide);
+			v7 = getVertexAt(diskMapIndex + Terrain::realVerticesMapSide - 1);
+			v8 = getVertexAt(diskMapIndex - 1);
 			//-----------------------------------------------------
 			// Try and project shadow lines.
 			if (Terrain::recalcShadows)
@@ -508,15 +576,14 @@ MapData::calcLight(void)
 			normals[7].Cross(triVect[0], triVect[1]);
 			gosASSERT(normals[7].z > 0.0);
 			normals[7].Normalize(normals[7]);
-			currentVertex->vertexNormal.x = normals[0].x + normals[1].x + normals[2].x + normals[3].x + normals[4].x + normals[5].x + normals[6].x + normals[7].x;
-			currentVertex->vertexNormal.y = normals[0].y + normals[1].y + normals[2].y + normals[3].y + normals[4].y + normals[5].y + normals[6].y + normals[7].y;
-			currentVertex->vertexNormal.z = normals[0].z + normals[1].z + normals[2].z + normals[3].z + normals[4].z + normals[5].z + normals[6].z + normals[7].z;
-			currentVertex->vertexNormal.x /= 8.0;
-			currentVertex->vertexNormal.y /= 8.0;
-			currentVertex->vertexNormal.z /= 8.0;
-			gosASSERT(currentVertex->vertexNormal.z > 0.0);
+			v0->vertexNormal.x = normals[0].x + normals[1].x + normals[2].x + normals[3].x + normals[4].x + normals[5].x + normals[6].x + normals[7].x;
+			v0->vertexNormal.y = normals[0].y + normals[1].y + normals[2].y + normals[3].y + normals[4].y + normals[5].y + normals[6].y + normals[7].y;
+			v0->vertexNormal.z = normals[0].z + normals[1].z + normals[2].z + normals[3].z + normals[4].z + normals[5].z + normals[6].z + normals[7].z;
+			v0->vertexNormal.x /= 8.0;
+			v0->vertexNormal.y /= 8.0;
+			v0->vertexNormal.z /= 8.0;
+			gosASSERT(v0->vertexNormal.z > 0.0);
 		}
-		currentVertex++;
 	}
 	Terrain::recalcShadows = false;
 }
@@ -530,11 +597,11 @@ MapData::clearShadows()
 	int32_t height, width;
 	height = width = Terrain::verticesBlockSide * Terrain::blocksMapSide;
 	int32_t totalVertices = height * width;
-	PostcompVertexPtr currentVertex = blocks;
 	for (size_t i = 0; i < totalVertices; i++)
 	{
-		currentVertex->shadow = 0;
-		currentVertex++;
+		if ((i % mapSide) == 0)
+			nextPassRow();
+		getVertexAt(i, true)->shadow = 0;
 	}
 }
 
@@ -589,6 +656,14 @@ MapData::update(void)
 	}
 	if (Terrain::recalcLight && eye)
 		calcLight();
+	//-----------------------------------------------------
+	// A tiled map only keeps what is around the camera (and
+	// the movers, who ask for themselves) unpacked.
+	if (isTiled())
+	{
+		tiles->beginFrame();
+		tiles->requestArea(PVx, PVy, (Terrain::visibleVerticesPerSide >> 1) + MAP_TILE_SIDE);
+	}
 	// Used to scroll the water texture.
 	{
 		cloudScrollX += frameLength * cloudScrollSpeedX;
@@ -673,7 +748,7 @@ MapData::makeLists(
 			}
 			else
 			{
-				Pvertex = &blocks[topLeftX + (topLeftY * Terrain::realVerticesMapSide)];
+				Pvertex = getVertex(topLeftX, topLeftY);
 				currentVertex->vertexNum = topLeftX + (topLeftY * Terrain::realVerticesMapSide);
 			}
 			gosASSERT(Pvertex != nullptr);
@@ -790,9 +865,9 @@ MapData::setOverlayTile(int32_t block, int32_t vertex, int32_t offset)
 	int32_t vertexY = (vertex / Terrain::verticesBlockSide);
 	int32_t indexX = blockX * Terrain::verticesBlockSide + vertexX;
 	int32_t indexY = blockY * Terrain::verticesBlockSide + vertexY;
-	int32_t index = indexX + indexY * Terrain::realVerticesMapSide;
-	PostcompVertexPtr ourBlock = &blocks[index];
-	ourBlock[vertex].textureData += (offset << 16);
+	int32_t index = indexX + indexY * Terrain::realVerticesMapSide + vertex;
+	PostcompVertexPtr ourBlock = getVertex(index % mapSide, index / mapSide, true);
+	ourBlock->textureData += (offset << 16);
 	setTerrain(indexY, indexX, -1);
 }
 
@@ -800,8 +875,7 @@ MapData::setOverlayTile(int32_t block, int32_t vertex, int32_t offset)
 void
 MapData::setOverlay(int32_t indexY, int32_t indexX, Overlays type, uint32_t offset)
 {
-	int32_t index = indexX + indexY * Terrain::realVerticesMapSide;
-	PostcompVertexPtr ourBlock = &blocks[index];
+	PostcompVertexPtr ourBlock = getVertex(indexX, indexY, true);
 	ourBlock->textureData &= 0x0000ffff;
 	ourBlock->textureData |= Terrain::terrainTextures->getOverlayHandle(type, offset);
 	setTerrain(indexY, indexX, -1);
@@ -813,8 +887,7 @@ MapData::getTexture(int32_t indexY, int32_t indexX)
 {
 	gosASSERT(indexX > -1 && indexX < Terrain::realVerticesMapSide);
 	gosASSERT(indexY > -1 && indexY < Terrain::realVerticesMapSide);
-	int32_t index = indexX + indexY * Terrain::realVerticesMapSide;
-	return blocks[index].textureData;
+	return getVertex(indexX, indexY)->textureData;
 }
 
 //---------------------------------------------------------------------------
@@ -823,8 +896,7 @@ MapData::terrainElevation(int32_t indexY, int32_t indexX)
 {
 	gosASSERT(indexX > -1 && indexX < Terrain::realVerticesMapSide);
 	gosASSERT(indexY > -1 && indexY < Terrain::realVerticesMapSide);
-	int32_t index = indexX + indexY * Terrain::realVerticesMapSide;
-	return blocks[index].elevation;
+	return getVertex(indexX, indexY)->elevation;
 }
 
 //---------------------------------------------------------------------------
@@ -846,17 +918,16 @@ MapData::setTerrain(int32_t indexY, int32_t indexX, int32_t Type)
 	{
 		if ((indexX > -1 && indexX < Terrain::realVerticesMapSide - 1) && (indexY > -1 && indexY < Terrain::realVerticesMapSide - 1))
 		{
-			int32_t index = Vertices[i][x] + Vertices[i][y] * Terrain::realVerticesMapSide;
-			PostcompVertexPtr currentVertex = &blocks[index];
+			PostcompVertexPtr currentVertex = getVertex(Vertices[i][x], Vertices[i][y], true);
 			currentVertex->textureData &= 0xffff0000;
 			if (i == 0 && Type > 0)
 				currentVertex->terrainType = Type;
 			//-----------------------------------------------
 			// Get the data needed to make this terrain quad
 			PostcompVertex* pVertex1 = currentVertex;
-			PostcompVertex* pVertex2 = currentVertex + 1;
-			PostcompVertex* pVertex3 = currentVertex + Terrain::realVerticesMapSide + 1;
-			PostcompVertex* pVertex4 = currentVertex + Terrain::realVerticesMapSide;
+			PostcompVertex* pVertex2 = getVertex(Vertices[i][x] + 1, Vertices[i][y]);
+			PostcompVertex* pVertex3 = getVertex(Vertices[i][x] + 1, Vertices[i][y] + 1);
+			PostcompVertex* pVertex4 = getVertex(Vertices[i][x], Vertices[i][y] + 1);
 			//-------------------------------------------------------------------------------
 			// Store texture in bottom part from TxmIndex provided by
 			// TerrainTextureManager
@@ -881,8 +952,7 @@ MapData::getTerrain(int32_t tileR, int32_t tileC)
 {
 	gosASSERT(tileR < Terrain::realVerticesMapSide && tileR > -1);
 	gosASSERT(tileC < Terrain::realVerticesMapSide && tileC > -1);
-	int32_t index = tileC + tileR * Terrain::realVerticesMapSide;
-	return blocks[index].terrainType;
+	return getVertex(tileC, tileR)->terrainType;
 }
 
 //---------------------------------------------------------------------------
@@ -891,8 +961,8 @@ MapData::getOverlay(int32_t tileR, int32_t tileC, Overlays& type, uint32_t& Offs
 {
 	gosASSERT(tileR < Terrain::realVerticesMapSide && tileR > -1);
 	gosASSERT(tileC < Terrain::realVerticesMapSide && tileC > -1);
-	int32_t index = tileC + tileR * Terrain::realVerticesMapSide;
-	Terrain::terrainTextures->getOverlayInfoFromHandle(blocks[index].textureData, type, Offset);
+	Terrain::terrainTextures->getOverlayInfoFromHandle(
+		getVertex(tileC, tileR)->textureData, type, Offset);
 }
 //---------------------------------------------------------------------------
 int32_t
@@ -904,9 +974,9 @@ MapData::getOverlayTile(int32_t block, int32_t vertex)
 	int32_t vertexY = (vertex / Terrain::verticesBlockSide);
 	int32_t indexX = blockX * Terrain::verticesBlockSide + vertexX;
 	int32_t indexY = blockY * Terrain::verticesBlockSide + vertexY;
-	int32_t index = indexX + indexY * Terrain::realVerticesMapSide;
-	PostcompVertexPtr ourBlock = &blocks[index];
-	return (ourBlock[vertex].textureData >> 16);
+	int32_t index = indexX + indexY * Terrain::realVerticesMapSide + vertex;
+	PostcompVertexPtr ourBlock = getVertex(index % mapSide, index / mapSide);
+	return (ourBlock->textureData >> 16);
 }
 
 //---------------------------------------------------------------------------
@@ -951,14 +1021,10 @@ MapData::terrainAngle(Stuff::Vector3D& position, Stuff::Vector3D* normal)
 	// bright
 	if (((meshOffset.x + 1) >= Terrain::realVerticesMapSide) || ((meshOffset.y + 1) >= Terrain::realVerticesMapSide) || (meshOffset.x < 0) || (meshOffset.y < 0))
 		return (0.0f);
-	PostcompVertexPtr pVertex1 =
-		&blocks[meshOffset.x + (meshOffset.y * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex2 =
-		&blocks[(meshOffset.x + 1) + (meshOffset.y * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex3 =
-		&blocks[(meshOffset.x + 1) + ((meshOffset.y + 1) * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex4 =
-		&blocks[meshOffset.x + ((meshOffset.y + 1) * Terrain::realVerticesMapSide)];
+	PostcompVertexPtr pVertex1 = getVertex(meshOffset.x, meshOffset.y);
+	PostcompVertexPtr pVertex2 = getVertex(meshOffset.x + 1, meshOffset.y);
+	PostcompVertexPtr pVertex3 = getVertex(meshOffset.x + 1, meshOffset.y + 1);
+	PostcompVertexPtr pVertex4 = getVertex(meshOffset.x, meshOffset.y + 1);
 	triPos.x = Terrain::worldUnitsPerVertex * floor(_upperLeft.x);
 	triPos.y = Terrain::worldUnitsPerVertex * floor(_upperLeft.y);
 	triPos.z = pVertex1->elevation;
@@ -1110,10 +1176,10 @@ MapData::terrainLight(Stuff::Vector3D& position)
 	// bright
 	if (((PVx + 1) >= Terrain::realVerticesMapSide) || ((PVy + 1) >= Terrain::realVerticesMapSide) || (PVx < 0) || (PVy < 0))
 		return 1.0f;
-	PostcompVertexPtr pVertex1 = &blocks[PVx + (PVy * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex2 = &blocks[(PVx + 1) + (PVy * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex3 = &blocks[(PVx + 1) + ((PVy + 1) * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex4 = &blocks[PVx + ((PVy + 1) * Terrain::realVerticesMapSide)];
+	PostcompVertexPtr pVertex1 = getVertex(PVx, PVy);
+	PostcompVertexPtr pVertex2 = getVertex(PVx + 1, PVy);
+	PostcompVertexPtr pVertex3 = getVertex(PVx + 1, PVy + 1);
+	PostcompVertexPtr pVertex4 = getVertex(PVx, PVy + 1);
 	Stuff::Vector3D vPos1, vPos2, vPos3, vPos4;
 	vPos1.x = (PVx * Terrain::worldUnitsPerVertex) + Terrain::mapTopLeft3d.x;
 	vPos1.y = Terrain::mapTopLeft3d.y - (PVy * Terrain::worldUnitsPerVertex);
@@ -1192,14 +1258,10 @@ MapData::terrainNormal(Stuff::Vector3D& position)
 	// bright
 	if (((meshOffset.x + 1) >= Terrain::realVerticesMapSide) || ((meshOffset.y + 1) >= Terrain::realVerticesMapSide) || (meshOffset.x < 0) || (meshOffset.y < 0))
 		return (Stuff::Vector3D(0.0f, 0.0f, 1.0f));
-	PostcompVertexPtr pVertex1 =
-		&blocks[meshOffset.x + (meshOffset.y * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex2 =
-		&blocks[(meshOffset.x + 1) + (meshOffset.y * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex3 =
-		&blocks[(meshOffset.x + 1) + ((meshOffset.y + 1) * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex4 =
-		&blocks[meshOffset.x + ((meshOffset.y + 1) * Terrain::realVerticesMapSide)];
+	PostcompVertexPtr pVertex1 = getVertex(meshOffset.x, meshOffset.y);
+	PostcompVertexPtr pVertex2 = getVertex(meshOffset.x + 1, meshOffset.y);
+	PostcompVertexPtr pVertex3 = getVertex(meshOffset.x + 1, meshOffset.y + 1);
+	PostcompVertexPtr pVertex4 = getVertex(meshOffset.x, meshOffset.y + 1);
 	triPos.x = Terrain::worldUnitsPerVertex * floor(_upperLeft.x);
 	triPos.y = Terrain::worldUnitsPerVertex * floor(_upperLeft.y);
 	triPos.z = pVertex1->elevation;
@@ -1366,14 +1428,10 @@ MapData::terrainElevation(Stuff::Vector3D& position)
 		return 0.0f;
 	if ((meshOffset.y >= (verticesMapSide - 1)))
 		return 0.0f;
-	PostcompVertexPtr pVertex1 =
-		&blocks[meshOffset.x + (meshOffset.y * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex2 =
-		&blocks[(meshOffset.x + 1) + (meshOffset.y * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex3 =
-		&blocks[(meshOffset.x + 1) + ((meshOffset.y + 1) * Terrain::realVerticesMapSide)];
-	PostcompVertexPtr pVertex4 =
-		&blocks[meshOffset.x + ((meshOffset.y + 1) * Terrain::realVerticesMapSide)];
+	PostcompVertexPtr pVertex1 = getVertex(meshOffset.x, meshOffset.y);
+	PostcompVertexPtr pVertex2 = getVertex(meshOffset.x + 1, meshOffset.y);
+	PostcompVertexPtr pVertex3 = getVertex(meshOffset.x + 1, meshOffset.y + 1);
+	PostcompVertexPtr pVertex4 = getVertex(meshOffset.x, meshOffset.y + 1);
 	triPos.x = Terrain::worldUnitsPerVertex * floor(_upperLeft.x);
 	triPos.y = Terrain::worldUnitsPerVertex * floor(_upperLeft.y);
 	triPos.z = pVertex1->elevation;
@@ -1516,7 +1574,9 @@ MapData::unselectAll()
 {
 	for (size_t i = 0; i < Terrain::realVerticesMapSide * Terrain::realVerticesMapSide; ++i)
 	{
-		blocks[i].selected = false;
+		if ((i % mapSide) == 0)
+			nextPassRow();
+		getVertexAt(i, true)->selected = false;
 	}
 	hasSelection = 0;
 }
@@ -1527,7 +1587,9 @@ MapData::unhighlightAll()
 {
 	for (size_t i = 0; i < Terrain::realVerticesMapSide * Terrain::realVerticesMapSide; ++i)
 	{
-		blocks[i].highlighted = false;
+		if ((i % mapSide) == 0)
+			nextPassRow();
+		getVertexAt(i, true)->highlighted = false;
 	}
 }
 
@@ -1540,9 +1602,9 @@ MapData::selectVertex(uint32_t tileRow, uint32_t tileCol, bool bSelect, bool bTo
 		return;
 	if (tileCol >= Terrain::realVerticesMapSide)
 		return;
-	uint32_t index = tileRow * Terrain::realVerticesMapSide + tileCol;
-	blocks[index].selected = bToggle ? !blocks[index].selected : bSelect;
-	if (blocks[index].selected)
+	PostcompVertexPtr vertex = getVertex(tileCol, tileRow, true);
+	vertex->selected = bToggle ? !vertex->selected : bSelect;
+	if (vertex->selected)
 		hasSelection++;
 	else
 		hasSelection--;
@@ -1556,8 +1618,7 @@ MapData::isVertexSelected(uint32_t tileRow, uint32_t tileCol)
 {
 	gosASSERT(tileRow < Terrain::realVerticesMapSide);
 	gosASSERT(tileCol < Terrain::realVerticesMapSide);
-	uint32_t index = tileRow * Terrain::realVerticesMapSide + tileCol;
-	return blocks[index].selected ? true : false;
+	return getVertex(tileCol, tileRow)->selected ? true : false;
 }
 
 //---------------------------------------------------------------------------
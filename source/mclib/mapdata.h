@@ -33,6 +33,10 @@
 #include "quad.h"
 #endif
 
+#ifndef MAPTILES_H
+#include "maptiles.h"
+#endif
+
 #include "stuff/stuff.h"
 
 //---------------------------------------------------------------------------
@@ -66,9 +70,11 @@ class MapData : public HeapManager
 	// Data Members
 	//-------------
 protected:
-	PostcompVertexPtr blocks;
+	PostcompVertexPtr blocks; // the whole map, flat, unless it is tiled
 	PostcompVertexPtr blankVertex;
 	int32_t hasSelection;
+	MapTiles* tiles;
+	int32_t mapSide;
 
 public:
 	Stuff::Vector2DOf<float> topLeftVertex;
@@ -91,6 +97,8 @@ public:
 		blocks = nullptr;
 		blankVertex = nullptr;
 		hasSelection = false;
+		tiles = nullptr;
+		mapSide = 0;
 		shallowDepth = 0.0f;
 		waterDepth = 0.0f;
 		alphaDepth = 0.0f;
@@ -115,6 +123,19 @@ public:
 
 	Stuff::Vector2DOf<float> getTopLeftVertex(void) { return topLeftVertex; }
 
+	//------------------------------------------------------------
+	// Use these to get at a vertex.  They work whether the map is
+	// flat or tiled.  Pass write if you are going to change it.
+	PostcompVertexPtr getVertex(int32_t vertexX, int32_t vertexY, bool write = false)
+	{
+		if (blocks)
+			return (&blocks[vertexX + (vertexY * mapSide)]);
+		return (tiles->getVertex(vertexX, vertexY, write));
+	}
+
+	bool isTiled(void) { return (blocks == nullptr) && (tiles != nullptr); }
+	void requestArea(const Stuff::Vector3D& position, int32_t radius);
+
 	void calcLight(void);
 	void clearShadows(void);
 
@@ -140,7 +161,7 @@ public:
 	void setVertexheight(int32_t vertexIndex, float value);
 	float getVertexheight(int32_t vertexIndex);
 
-	PostcompVertexPtr getData(void) { return blocks; }
+	PostcompVertexPtr getData(void) { return blocks; } // nullptr once tiled
 
 	uint32_t getTexture(int32_t tileR, int32_t tileC);
 
@@ -162,6 +183,19 @@ public:
 	bool isVertexSelected(uint32_t tileRow, uint32_t tileCol);
 
 	void calcTransitions(void);
+
+protected:
+	bool unpackMap(void);
+	void packMap(void);
+	PostcompVertexPtr getVertexAt(int32_t index, bool write = false)
+	{
+		return (getVertex(index % mapSide, index / mapSide, write));
+	}
+	void nextPassRow(void)
+	{
+		if (isTiled())
+			tiles->advanceFrame();
+	}
 };
 
 //-----------------------------------------------------------------------------------------------
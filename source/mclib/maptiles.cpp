@@ -0,0 +1,434 @@
+//---------------------------------------------------------------------------
+//
+// MapTiles.cpp -- Packed, paged storage for the Terrain Mesh
+//
+//	MechCommander 2
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//---------------------------------------------------------------------------
+// Include Files
+#include "stdinc.h"
+
+#ifndef MAPTILES_H
+#include "maptiles.h"
+#endif
+
+#ifndef LZ_H
+#include "lz.h"
+#endif
+
+//---------------------------------------------------------------------------
+// Static Globals
+
+bool MapDataUseTiles = false;
+size_t MapTileBudget = DEFAULT_MAP_TILE_BUDGET;
+MapTileStats MapTileStatistics = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+//---------------------------------------------------------------------------
+// Tiles are packed a byte plane at a time: byte 0 of every vertex, then
+// byte 1, and so on.  Elevations, normals and texture handles change
+// slowly from one vertex to the next, so each plane is mostly runs.
+static void
+MapTileShuffle(uint8_t* dest, const PostcompVertex* vertices)
+{
+	const uint8_t* src = (const uint8_t*)vertices;
+	for (size_t b = 0; b < sizeof(PostcompVertex); b++)
+	{
+		const uint8_t* in = src + b;
+		for (size_t i = 0; i < MAP_TILE_VERTICES; i++, in += sizeof(PostcompVertex))
+			*dest++ = *in;
+	}
+}
+
+//---------------------------------------------------------------------------
+static void
+MapTileUnshuffle(PostcompVertex* vertices, const uint8_t* src)
+{
+	uint8_t* dest = (uint8_t*)vertices;
+	for (size_t b = 0; b < sizeof(PostcompVertex); b++)
+	{
+		uint8_t* out = dest + b;
+		for (size_t i = 0; i < MAP_TILE_VERTICES; i++, out += sizeof(PostcompVertex))
+			*out = *src++;
+	}
+}
+
+//---------------------------------------------------------------------------
+// class MapTiles
+MapTiles::MapTiles(void)
+{
+	tileHeap = nullptr;
+	tiles = nullptr;
+	verticesSide = 0;
+	tilesSide = 0;
+	numTiles = 0;
+	budget = 0;
+	numSlots = 0;
+	frame = 1;
+	tileBuffer = nullptr;
+	shuffleBuffer = nullptr;
+	packBuffer = nullptr;
+	loaderBuffer = nullptr;
+	loaderRunning = false;
+}
+
+//---------------------------------------------------------------------------
+int32_t
+MapTiles::init(PostcompVertexPtr vertices, int32_t side, size_t memoryBudget, UserHeapPtr heap)
+{
+	destroy();
+	tileHeap = heap;
+	verticesSide = side;
+	tilesSide = (side + MAP_TILE_MASK) >> MAP_TILE_SHIFT;
+	numTiles = tilesSide * tilesSide;
+	budget = memoryBudget;
+	tiles = new MapTile[numTiles];
+	gosASSERT(tiles != nullptr);
+	for (size_t i = 0; i < numTiles; i++)
+	{
+		tiles[i].packed = nullptr;
+		tiles[i].packedSize = 0;
+		tiles[i].vertices = nullptr;
+		tiles[i].state = MAP_TILE_PACKED;
+		tiles[i].lastUsed = 0;
+		tiles[i].dirty = false;
+	}
+	tileBuffer = (PostcompVertexPtr)tileHeap->Malloc(MAP_TILE_BYTES);
+	shuffleBuffer = (uint8_t*)tileHeap->Malloc(MAP_TILE_BYTES);
+	packBuffer = (uint8_t*)tileHeap->Malloc(LZBCompressBound(MAP_TILE_BYTES));
+	loaderBuffer = (uint8_t*)tileHeap->Malloc(MAP_TILE_BYTES);
+	if (!tileBuffer || !shuffleBuffer || !packBuffer || !loaderBuffer)
+	{
+		destroy();
+		return (OUT_OF_MEMORY);
+	}
+	MapTileStatistics.numTiles = numTiles;
+	MapTileStatistics.numResident = 0;
+	MapTileStatistics.residentBytes = 0;
+	MapTileStatistics.packedBytes = 0;
+	pack(vertices);
+	loaderRunning = true;
+	loaderThread = std::thread(&MapTiles::loaderMain, this);
+	return (NO_ERROR);
+}
+
+//---------------------------------------------------------------------------
+void
+MapTiles::destroy(void)
+{
+	if (loaderRunning)
+	{
+		flushLoader();
+		{
+			std::lock_guard<std::mutex> lock(loaderLock);
+			loaderRunning = false;
+		}
+		loaderWake.notify_all();
+		loaderThread.join();
+	}
+	if (tiles)
+	{
+		for (size_t i = 0; i < numTiles; i++)
+		{
+			if (tiles[i].packed)
+				tileHeap->Free(tiles[i].packed);
+			if (tiles[i].vertices)
+				tileHeap->Free(tiles[i].vertices);
+		}
+		delete[] tiles;
+		tiles = nullptr;
+	}
+	for (auto slot : freeSlots)
+		tileHeap->Free(slot);
+	freeSlots.clear();
+	numSlots = 0;
+	numTiles = 0;
+	if (tileBuffer)
+		tileHeap->Free(tileBuffer);
+	if (shuffleBuffer)
+		tileHeap->Free(shuffleBuffer);
+	if (packBuffer)
+		tileHeap->Free(packBuffer);
+	if (loaderBuffer)
+		tileHeap->Free(loaderBuffer);
+	tileBuffer = nullptr;
+	shuffleBuffer = nullptr;
+	packBuffer = nullptr;
+	loaderBuffer = nullptr;
+}
+
+//---------------------------------------------------------------------------
+// Replaces every tile with the matching piece of a whole, flat map.  Tiles
+// that were in come back out; nothing written to them is kept.
+void
+MapTiles::pack(PostcompVertexPtr vertices)
+{
+	flushLoader();
+	for (size_t tileY = 0; tileY < tilesSide; tileY++)
+	{
+		for (size_t tileX = 0; tileX < tilesSide; tileX++)
+		{
+			MapTile& tile = tiles[tileX + (tileY * tilesSide)];
+			int32_t firstX = tileX << MAP_TILE_SHIFT;
+			int32_t firstY = tileY << MAP_TILE_SHIFT;
+			int32_t width = min(MAP_TILE_SIDE, verticesSide - firstX);
+			int32_t height = min(MAP_TILE_SIDE, verticesSide - firstY);
+			memset(tileBuffer, 0, MAP_TILE_BYTES);
+			for (size_t y = 0; y < height; y++)
+				memcpy(&tileBuffer[y << MAP_TILE_SHIFT],
+					&vertices[firstX + ((firstY + y) * verticesSide)], width * sizeof(PostcompVertex));
+			packTile(tile, tileBuffer);
+			if (tile.vertices)
+			{
+				freeSlots.push_back(tile.vertices);
+				tile.vertices = nullptr;
+				tile.state = MAP_TILE_PACKED;
+			}
+			tile.dirty = false;
+		}
+	}
+	MapTileStatistics.numResident = 0;
+}
+
+//---------------------------------------------------------------------------
+// Writes the whole map out flat, tiles in or not.
+void
+MapTiles::unpack(PostcompVertexPtr vertices)
+{
+	flushLoader();
+	for (size_t tileY = 0; tileY < tilesSide; tileY++)
+	{
+		for (size_t tileX = 0; tileX < tilesSide; tileX++)
+		{
+			MapTile& tile = tiles[tileX + (tileY * tilesSide)];
+			PostcompVertexPtr source = tile.vertices;
+			if (tile.state != MAP_TILE_RESIDENT)
+			{
+				unpackTile(tile, tileBuffer, shuffleBuffer);
+				source = tileBuffer;
+			}
+			int32_t firstX = tileX << MAP_TILE_SHIFT;
+			int32_t firstY = tileY << MAP_TILE_SHIFT;
+			int32_t width = min(MAP_TILE_SIDE, verticesSide - firstX);
+			int32_t height = min(MAP_TILE_SIDE, verticesSide - firstY);
+			for (size_t y = 0; y < height; y++)
+				memcpy(&vertices[firstX + ((firstY + y) * verticesSide)],
+					&source[y << MAP_TILE_SHIFT], width * sizeof(PostcompVertex));
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// Hands the loader every tile within radius vertices of a spot.  Tiles
+// that don't fit the budget are skipped; they come in on the spot if
+// anybody touches them.
+void
+MapTiles::requestArea(int32_t vertexX, int32_t vertexY, int32_t radius)
+{
+	int32_t firstX = max(0, (vertexX - radius) >> MAP_TILE_SHIFT);
+	int32_t firstY = max(0, (vertexY - radius) >> MAP_TILE_SHIFT);
+	int32_t lastX = min(tilesSide - 1, (vertexX + radius) >> MAP_TILE_SHIFT);
+	int32_t lastY = min(tilesSide - 1, (vertexY + radius) >> MAP_TILE_SHIFT);
+	bool queued = false;
+	for (size_t tileY = firstY; (int32_t)tileY <= lastY; tileY++)
+	{
+		for (size_t tileX = firstX; (int32_t)tileX <= lastX; tileX++)
+		{
+			int32_t index = tileX + (tileY * tilesSide);
+			MapTile& tile = tiles[index];
+			tile.lastUsed = frame;
+			if (tile.state != MAP_TILE_PACKED)
+				continue;
+			tile.vertices = getSlot(false);
+			if (!tile.vertices)
+			{
+				MapTileStatistics.numPrefetchesDropped++;
+				continue;
+			}
+			std::lock_guard<std::mutex> lock(loaderLock);
+			tile.state = MAP_TILE_QUEUED;
+			loadQueue.push_back(index);
+			queued = true;
+		}
+	}
+	if (queued)
+		loaderWake.notify_one();
+	MapTileStatistics.numResident = numSlots - (int32_t)freeSlots.size();
+}
+
+//---------------------------------------------------------------------------
+// Somebody touched a tile that isn't in.  Take it off the loader if it
+// hasn't started on it, wait for it if it has, otherwise unpack it here.
+void
+MapTiles::pageIn(MapTile& tile)
+{
+	int64_t startCycles = GetCycles();
+	int32_t state;
+	{
+		std::unique_lock<std::mutex> lock(loaderLock);
+		state = tile.state;
+		if (state == MAP_TILE_LOADING)
+		{
+			while (tile.state != MAP_TILE_RESIDENT)
+				loaderDone.wait(lock);
+		}
+		else if (state == MAP_TILE_QUEUED)
+			tile.state = MAP_TILE_LOADING;
+	}
+	if (state != MAP_TILE_LOADING)
+	{
+		if (!tile.vertices)
+			tile.vertices = getSlot(true);
+		unpackTile(tile, tile.vertices, shuffleBuffer);
+		tile.state.store(MAP_TILE_RESIDENT, std::memory_order_release);
+	}
+	int64_t cycles = GetCycles() - startCycles;
+	MapTileStatistics.numDemandPageIns++;
+	MapTileStatistics.demandCycles += cycles;
+	if (cycles > MapTileStatistics.maxDemandCycles)
+		MapTileStatistics.maxDemandCycles = cycles;
+	MapTileStatistics.numResident = numSlots - (int32_t)freeSlots.size();
+}
+
+//---------------------------------------------------------------------------
+// A free slot, making one if the budget allows or a tile can go.  With
+// overBudget set there is always one.
+PostcompVertexPtr
+MapTiles::getSlot(bool overBudget)
+{
+	if (freeSlots.empty() && (((size_t)(numSlots + 1) * MAP_TILE_BYTES) > budget) && !evictTile())
+	{
+		if (!overBudget)
+			return (nullptr);
+		MapTileStatistics.numOverBudget++;
+	}
+	if (freeSlots.empty())
+	{
+		PostcompVertexPtr slot = (PostcompVertexPtr)tileHeap->Malloc(MAP_TILE_BYTES);
+		gosASSERT(slot != nullptr);
+		numSlots++;
+		MapTileStatistics.residentBytes = numSlots * MAP_TILE_BYTES;
+		if (MapTileStatistics.residentBytes > MapTileStatistics.peakResidentBytes)
+			MapTileStatistics.peakResidentBytes = MapTileStatistics.residentBytes;
+		return (slot);
+	}
+	PostcompVertexPtr slot = freeSlots.back();
+	freeSlots.pop_back();
+	return (slot);
+}
+
+//---------------------------------------------------------------------------
+// Sends the tile used longest ago back to its packed copy.  Nothing used
+// this frame or last can go.
+bool
+MapTiles::evictTile(void)
+{
+	int32_t victim = -1;
+	for (size_t i = 0; i < numTiles; i++)
+	{
+		MapTile& tile = tiles[i];
+		if ((tile.state == MAP_TILE_RESIDENT) && ((tile.lastUsed + 1) < frame))
+			if ((victim == -1) || (tile.lastUsed < tiles[victim].lastUsed))
+				victim = i;
+	}
+	if (victim == -1)
+		return (false);
+	MapTile& tile = tiles[victim];
+	if (tile.dirty)
+	{
+		packTile(tile, tile.vertices);
+		MapTileStatistics.numRepacks++;
+	}
+	tile.state = MAP_TILE_PACKED;
+	freeSlots.push_back(tile.vertices);
+	tile.vertices = nullptr;
+	tile.dirty = false;
+	MapTileStatistics.numEvictions++;
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+void
+MapTiles::packTile(MapTile& tile, PostcompVertexPtr vertices)
+{
+	MapTileShuffle(shuffleBuffer, vertices);
+	size_t packedSize =
+		LZBCompress(packBuffer, LZBCompressBound(MAP_TILE_BYTES), shuffleBuffer, MAP_TILE_BYTES);
+	gosASSERT(packedSize != 0);
+	if (tile.packed)
+	{
+		MapTileStatistics.packedBytes -= tile.packedSize;
+		tileHeap->Free(tile.packed);
+	}
+	tile.packed = (uint8_t*)tileHeap->Malloc(packedSize);
+	gosASSERT(tile.packed != nullptr);
+	memcpy(tile.packed, packBuffer, packedSize);
+	tile.packedSize = (int32_t)packedSize;
+	MapTileStatistics.packedBytes += tile.packedSize;
+}
+
+//---------------------------------------------------------------------------
+// Runs on either thread, each with its own scratch.
+void
+MapTiles::unpackTile(MapTile& tile, PostcompVertexPtr vertices, uint8_t* scratch)
+{
+	size_t unpackedSize = LZBDecomp(scratch, MAP_TILE_BYTES, tile.packed, tile.packedSize);
+	gosASSERT(unpackedSize == MAP_TILE_BYTES);
+	MapTileUnshuffle(vertices, scratch);
+}
+
+//---------------------------------------------------------------------------
+// Takes back everything still queued and waits out whatever the loader has
+// in hand, so every tile is either in or packed.
+void
+MapTiles::flushLoader(void)
+{
+	std::unique_lock<std::mutex> lock(loaderLock);
+	for (auto index : loadQueue)
+	{
+		MapTile& tile = tiles[index];
+		if (tile.state == MAP_TILE_QUEUED)
+		{
+			tile.state = MAP_TILE_PACKED;
+			freeSlots.push_back(tile.vertices);
+			tile.vertices = nullptr;
+		}
+	}
+	loadQueue.clear();
+	for (size_t i = 0; i < numTiles; i++)
+		while (tiles[i].state == MAP_TILE_LOADING)
+			loaderDone.wait(lock);
+}
+
+//---------------------------------------------------------------------------
+void
+MapTiles::loaderMain(void)
+{
+	std::unique_lock<std::mutex> lock(loaderLock);
+	for (;;)
+	{
+		while (loaderRunning && loadQueue.empty())
+			loaderWake.wait(lock);
+		if (!loaderRunning)
+			break;
+		MapTile& tile = tiles[loadQueue.front()];
+		loadQueue.pop_front();
+		//-------------------------------------------------
+		// Already taken (or taken and dropped again) by the
+		// caller.  Nothing to do.
+		if (tile.state != MAP_TILE_QUEUED)
+			continue;
+		tile.state = MAP_TILE_LOADING;
+		lock.unlock();
+		unpackTile(tile, tile.vertices, loaderBuffer);
+		lock.lock();
+		tile.state.store(MAP_TILE_RESIDENT, std::memory_order_release);
+		MapTileStatistics.numPrefetches++;
+		loaderDone.notify_all();
+	}
+}
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,166 @@
+//---------------------------------------------------------------------------
+//
+// MapTiles.h -- Packed, paged storage for the Terrain Mesh
+//
+//	MechCommander 2
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#pragma once
+
+#ifndef MAPTILES_H
+#define MAPTILES_H
+
+//---------------------------------------------------------------------------
+// Include Files
+
+#ifndef HEAP_H
+#include "heap.h"
+#endif
+
+#ifndef VERTEX_H
+#include "vertex.h"
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// The map's vertices cut into square tiles.  Every tile is kept LZ packed;
+// only the ones in use are unpacked, each into a slot of its own.  Slots
+// are held to a budget: when one is needed and the budget is spent, the
+// tile used longest ago goes back to its packed copy (packed again first
+// if it was written to).  A tile touched this frame or last is never
+// dropped, so vertex pointers handed out stay good until the frame after.
+//
+// A loader thread unpacks tiles asked for ahead of time (around the camera,
+// under the movers).  Anything touched before it gets there is unpacked on
+// the spot.  Only the loader thread and the thread calling in here ever
+// touch the tiles; slots and packed copies are only ever allocated and
+// freed by the caller.
+
+#define MAP_TILE_SHIFT 5
+#define MAP_TILE_SIDE (1 << MAP_TILE_SHIFT) // vertices a side
+#define MAP_TILE_MASK (MAP_TILE_SIDE - 1)
+#define MAP_TILE_VERTICES (MAP_TILE_SIDE * MAP_TILE_SIDE)
+#define MAP_TILE_BYTES (MAP_TILE_VERTICES * sizeof(PostcompVertex))
+#define DEFAULT_MAP_TILE_BUDGET (4 * 1024 * 1024)
+
+enum _map_tile_state : int32_t
+{
+	MAP_TILE_PACKED,
+	MAP_TILE_QUEUED, // waiting on the loader
+	MAP_TILE_LOADING,
+	MAP_TILE_RESIDENT
+};
+
+typedef struct _MapTile
+{
+	uint8_t* packed;
+	int32_t packedSize;
+	PostcompVertexPtr vertices; // its slot, once it has one
+	std::atomic<int32_t> state;
+	uint32_t lastUsed; // frame it was last touched
+	bool dirty; // written since it was unpacked
+} MapTile;
+
+typedef struct _MapTileStats
+{
+	uint32_t numTiles;
+	uint32_t numResident;
+	uint32_t residentBytes; // slots, in use or not
+	uint32_t peakResidentBytes;
+	uint32_t packedBytes; // every tile, packed
+	uint32_t numPrefetches; // tiles the loader unpacked ahead of time
+	uint32_t numPrefetchesDropped; // asked for with no room in the budget
+	uint32_t numDemandPageIns; // tiles unpacked on the spot
+	uint32_t numEvictions;
+	uint32_t numRepacks; // dirty tiles packed again on the way out
+	uint32_t numOverBudget; // slots added because nothing could go
+	int64_t demandCycles; // time spent on the spot this frame
+	int64_t maxDemandCycles; // worst single one
+} MapTileStats;
+
+extern bool MapDataUseTiles;
+extern size_t MapTileBudget;
+extern MapTileStats MapTileStatistics;
+
+//---------------------------------------------------------------------------
+class MapTiles
+{
+protected:
+	UserHeapPtr tileHeap;
+	MapTile* tiles;
+	int32_t verticesSide;
+	int32_t tilesSide;
+	int32_t numTiles;
+	size_t budget;
+	std::vector<PostcompVertexPtr> freeSlots;
+	int32_t numSlots;
+	uint32_t frame;
+	PostcompVertexPtr tileBuffer; // caller's scratch
+	uint8_t* shuffleBuffer;
+	uint8_t* packBuffer;
+	uint8_t* loaderBuffer; // the loader thread's scratch
+
+	std::thread loaderThread;
+	std::mutex loaderLock;
+	std::condition_variable loaderWake; // something to unpack
+	std::condition_variable loaderDone; // a tile came in
+	std::deque<int32_t> loadQueue;
+	bool loaderRunning;
+
+public:
+	MapTiles(void);
+	~MapTiles(void) { destroy(); }
+
+	int32_t init(PostcompVertexPtr vertices, int32_t side, size_t memoryBudget, UserHeapPtr heap);
+	void destroy(void);
+
+	void pack(PostcompVertexPtr vertices);
+	void unpack(PostcompVertexPtr vertices);
+
+	PostcompVertexPtr getVertex(int32_t vertexX, int32_t vertexY, bool write = false)
+	{
+		MapTile& tile = tiles[(vertexX >> MAP_TILE_SHIFT) + ((vertexY >> MAP_TILE_SHIFT) * tilesSide)];
+		int32_t offset = (vertexX & MAP_TILE_MASK) + ((vertexY & MAP_TILE_MASK) << MAP_TILE_SHIFT);
+		if (tile.state.load(std::memory_order_acquire) != MAP_TILE_RESIDENT)
+			pageIn(tile);
+		tile.lastUsed = frame;
+		if (write)
+			tile.dirty = true;
+		return (&tile.vertices[offset]);
+	}
+
+	void beginFrame(void)
+	{
+		frame++;
+		MapTileStatistics.demandCycles = 0;
+	}
+	//---------------------------------------------------------------
+	// A whole map pass calls this each row as it goes, so the tiles
+	// behind it can go back to packed and it never needs more than a
+	// couple of rows of tiles in at once.
+	void advanceFrame(void) { frame++; }
+	void requestArea(int32_t vertexX, int32_t vertexY, int32_t radius);
+
+	static bool TestClass(void);
+
+protected:
+	void pageIn(MapTile& tile);
+	PostcompVertexPtr getSlot(bool overBudget);
+	bool evictTile(void);
+	void packTile(MapTile& tile, PostcompVertexPtr vertices);
+	void unpackTile(MapTile& tile, PostcompVertexPtr vertices, uint8_t* scratch);
+	void flushLoader(void);
+	void loaderMain(void);
+};
+
+//---------------------------------------------------------------------------
+#endif
@@ -0,0 +1,110 @@
+//===========================================================================//
+// File:	maptiles_test.cpp                                                //
+// Contents: test function for the packed, paged terrain mesh                //
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#include "stdinc.h"
+#include "maptiles.h"
+
+#define MAP_TILE_TEST_SIDE 100 // not a whole number of tiles
+#define MAP_TILE_TEST_SLOTS 8 // two rows of tiles across the test map
+
+//---------------------------------------------------------------------------
+// Smooth enough to pack the way a real map does, different everywhere.
+
+static void
+MapTileTestVertex(PostcompVertex& vertex, int32_t x, int32_t y)
+{
+	memset(&vertex, 0, sizeof(PostcompVertex));
+	vertex.vertexNormal.z = 1.0f;
+	vertex.elevation = (float)((x * 3) + (y * 7));
+	vertex.textureData = 0xffff0000 | ((x / 8) + (y / 8));
+	vertex.localRGBLight = 0xffffffff;
+	vertex.terrainType = (x / 20) + (y / 30);
+	vertex.water = (x + y) & 1;
+}
+
+//---------------------------------------------------------------------------
+// Reads the whole map a row at a time, the way a pass does, and checks it
+// against flat.
+
+static bool
+MapTileTestWalk(MapTiles& tiles, const std::vector<PostcompVertex>& flat)
+{
+	for (size_t y = 0; y < MAP_TILE_TEST_SIDE; y++)
+	{
+		tiles.advanceFrame();
+		for (size_t x = 0; x < MAP_TILE_TEST_SIDE; x++)
+			Test_Assumption(memcmp(tiles.getVertex(x, y), &flat[x + (y * MAP_TILE_TEST_SIDE)], sizeof(PostcompVertex)) == 0);
+	}
+	return true;
+}
+
+//---------------------------------------------------------------------------
+
+bool
+MapTiles::TestClass(void)
+{
+	SPEW((GROUP_STUFF_TEST, "Starting MapTiles test..."));
+	int32_t numVertices = MAP_TILE_TEST_SIDE * MAP_TILE_TEST_SIDE;
+	std::vector<PostcompVertex> flat(numVertices);
+	std::vector<PostcompVertex> unpacked(numVertices);
+	size_t x, y;
+	for (y = 0; y < MAP_TILE_TEST_SIDE; y++)
+		for (x = 0; x < MAP_TILE_TEST_SIDE; x++)
+			MapTileTestVertex(flat[x + (y * MAP_TILE_TEST_SIDE)], x, y);
+	UserHeap heap;
+	Test_Assumption(heap.init(4 * 1024 * 1024, "TILETEST") == NO_ERROR);
+	MapTiles tiles;
+	Test_Assumption(tiles.init(flat.data(), MAP_TILE_TEST_SIDE, MAP_TILE_TEST_SLOTS * MAP_TILE_BYTES, &heap) == NO_ERROR);
+	Test_Assumption(MapTileStatistics.numTiles == 16);
+	Test_Assumption(MapTileStatistics.packedBytes < (numVertices * sizeof(PostcompVertex)));
+	//------------------------------------------------------------
+	// Every vertex comes back as it went in, edge tiles included,
+	// and a pass a row at a time never needs more than the budget.
+	uint32_t numOverBudget = MapTileStatistics.numOverBudget;
+	Test_Assumption(MapTileTestWalk(tiles, flat));
+	Test_Assumption(MapTileStatistics.numOverBudget == numOverBudget);
+	Test_Assumption(MapTileStatistics.numEvictions > 0);
+	//---------------------------------------------------------------
+	// Writes survive their tile being evicted and packed again...
+	uint32_t numRepacks = MapTileStatistics.numRepacks;
+	for (y = 0; y < MAP_TILE_TEST_SIDE; y += 9)
+	{
+		tiles.advanceFrame();
+		for (x = 0; x < MAP_TILE_TEST_SIDE; x += 11)
+		{
+			PostcompVertexPtr vertex = tiles.getVertex(x, y, true);
+			vertex->elevation += 100.0f;
+			vertex->shadow = 1;
+			flat[x + (y * MAP_TILE_TEST_SIDE)] = *vertex;
+		}
+	}
+	Test_Assumption(MapTileTestWalk(tiles, flat));
+	Test_Assumption(MapTileStatistics.numRepacks > numRepacks);
+	//----------------------------------------------------------
+	// ...as do tiles the loader brought in ahead of time, and
+	// the last vertex of the last, partial tile...
+	tiles.advanceFrame();
+	tiles.advanceFrame();
+	tiles.requestArea(MAP_TILE_TEST_SIDE / 2, MAP_TILE_TEST_SIDE / 2, MAP_TILE_SIDE / 2);
+	Test_Assumption(memcmp(tiles.getVertex(MAP_TILE_TEST_SIDE / 2, MAP_TILE_TEST_SIDE / 2), &flat[(MAP_TILE_TEST_SIDE / 2) * (MAP_TILE_TEST_SIDE + 1)], sizeof(PostcompVertex)) == 0);
+	Test_Assumption(memcmp(tiles.getVertex(MAP_TILE_TEST_SIDE - 1, MAP_TILE_TEST_SIDE - 1), &flat[numVertices - 1], sizeof(PostcompVertex)) == 0);
+	//-----------------------------------------------------
+	// Flat and back: unpack puts out the whole map, tiles
+	// in or not, and pack replaces every tile.
+	tiles.unpack(unpacked.data());
+	Test_Assumption(memcmp(unpacked.data(), flat.data(), numVertices * sizeof(PostcompVertex)) == 0);
+	for (y = 0; y < MAP_TILE_TEST_SIDE; y++)
+		for (x = 0; x < MAP_TILE_TEST_SIDE; x++)
+			MapTileTestVertex(flat[x + (y * MAP_TILE_TEST_SIDE)], y, x);
+	tiles.pack(flat.data());
+	Test_Assumption(MapTileTestWalk(tiles, flat));
+	tiles.unpack(unpacked.data());
+	Test_Assumption(memcmp(unpacked.data(), flat.data(), numVertices * sizeof(PostcompVertex)) == 0);
+	tiles.destroy();
+	heap.destroy();
+	return true;
+}
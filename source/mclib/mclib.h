@@ -20,6 +20,18 @@
 #include "packet.h"
 #endif
 
+#ifndef PACKETIO_H
+#include "packetio.h"
+#endif
+
+#ifndef LOADGRAPH_H
+#include "loadgraph.h"
+#endif
+
+#ifndef MAPTILES_H
+#include "maptiles.h"
+#endif
+
 #ifndef LZ_H
 #include "lz.h"
 #endif
@@ -44,10 +56,22 @@
 #include "err.h"
 #endif
 
+#ifndef SIZEHEAP_H
+#include "sizeheap.h"
+#endif
+
 #ifndef HEAP_H
 #include "heap.h"
 #endif
 
+#ifndef FRAMEARENA_H
+#include "framearena.h"
+#endif
+
+#ifndef OBJPOOL_H
+#include "objpool.h"
+#endif
+
 #ifndef PATHS_H
 #include "paths.h"
 #endif
@@ -620,7 +620,7 @@ MOVE_cleanup(void)
 PVOID
 MissionMap::operator new(size_t ourSize)
 {
-	PVOID result = systemHeap->Malloc(ourSize);
+	PVOID result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -1093,7 +1093,7 @@ PVOID
 MovePath::operator new(size_t ourSize)
 {
 	PVOID result;
-	result = systemHeap->Malloc(ourSize);
+	result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -1310,7 +1310,7 @@ MovePath::crossesClosedGate(int32_t start, int32_t range)
 PVOID
 GlobalMap::operator new(size_t ourSize)
 {
-	PVOID result = systemHeap->Malloc(ourSize);
+	PVOID result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -1404,26 +1404,37 @@ GlobalMap::init(PacketFilePtr packetFile, int32_t whichPacket)
 		return (13 + numDoorInfos + (numDoors + NUM_DOOR_OFFSETS) * 2);
 #endif
 	}
+	//--------------------------------------------------------------
+	// Everything from here on goes through the packet reader.  Only
+	// the areas and doors have to land before the packets hanging off
+	// them can be placed; the rest is waited for at the end, so the
+	// area map unpacks while everything after it is read.
+	std::vector<PacketRequestPtr> mapRequests;
 	areaMap = (int16_t*)systemHeap->Malloc(sizeof(int16_t) * height * width);
 	gosASSERT(areaMap != nullptr);
-	result = packetFile->readPacket(whichPacket++, (uint8_t*)areaMap);
-	if (result == 0)
-		Fatal(result, " GlobalMap.init: unable to read areaMap packet ");
+	mapRequests.push_back(packetFile->readPacketAsync(whichPacket++, (uint8_t*)areaMap));
 	areas = (GlobalMapAreaPtr)systemHeap->Malloc(sizeof(GlobalMapArea) * numAreas);
 	gosASSERT(areas != nullptr);
-	result = packetFile->readPacket(whichPacket++, (uint8_t*)areas);
+	result = packetFile->waitPacket(packetFile->readPacketAsync(whichPacket++, (uint8_t*)areas));
 	if (result == 0)
 		Fatal(result, " GlobalMap.init: unable to read areas packet ");
 	doorInfos = (DoorInfoPtr)systemHeap->Malloc(sizeof(DoorInfo) * numDoorInfos);
 	gosASSERT(doorInfos != nullptr);
 	int32_t curDoorInfo = 0;
 	int32_t i;
+	//-----------------------------------------------------------
+	// The links can't be placed until the doors are in, so hint
+	// them now and let the reader get them in meanwhile.  One
+	// door info packet per area with doors, then the doors.
+	int32_t numDoorInfoPackets = 0;
+	for (i = 0; i < numAreas; i++)
+		if (areas[i].numDoors)
+			numDoorInfoPackets++;
+	packetFile->prefetchPackets(whichPacket + numDoorInfoPackets + 1, (numDoors + NUM_DOOR_OFFSETS) * 2);
 	for (i = 0; i < numAreas; i++)
 		if (areas[i].numDoors)
 		{
-			result = packetFile->readPacket(whichPacket++, (uint8_t*)&doorInfos[curDoorInfo]);
-			if (result == 0)
-				Fatal(result, " GlobalMap.init: unable to read doorInfos packet ");
+			mapRequests.push_back(packetFile->readPacketAsync(whichPacket++, (uint8_t*)&doorInfos[curDoorInfo]));
 			curDoorInfo += areas[i].numDoors;
 		}
 	Assert(numDoorInfos == curDoorInfo, 0, " GlobalMap.init: bad doorInfo count ");
@@ -1438,7 +1449,7 @@ GlobalMap::init(PacketFilePtr packetFile, int32_t whichPacket)
 	doors =
 		(GlobalMapDoorPtr)systemHeap->Malloc(sizeof(GlobalMapDoor) * (numDoors + NUM_DOOR_OFFSETS));
 	gosASSERT(doors != nullptr);
-	result = packetFile->readPacket(whichPacket++, (uint8_t*)doors);
+	result = packetFile->waitPacket(packetFile->readPacketAsync(whichPacket++, (uint8_t*)doors));
 	if (result == 0)
 		Fatal(result, " GlobalMap.init: unable to read doors packet ");
 	//--------------
@@ -1450,20 +1461,25 @@ GlobalMap::init(PacketFilePtr packetFile, int32_t whichPacket)
 	{
 		int32_t numLinks = doors[i].numLinks[0] + NUM_EXTRA_DOOR_LINKS;
 		gosASSERT(numLinks >= 2);
-		result = packetFile->readPacket(whichPacket++, (uint8_t*)&doorLinks[numLinksRead]);
-		if (result <= 0)
-			Fatal(result, " GlobalMap.init: Unable to write doorLinks packet ");
+		mapRequests.push_back(packetFile->readPacketAsync(whichPacket++, (uint8_t*)&doorLinks[numLinksRead]));
 		doors[i].links[0] = &doorLinks[numLinksRead];
 		numLinksRead += numLinks;
 		numLinks = doors[i].numLinks[1] + NUM_EXTRA_DOOR_LINKS;
 		gosASSERT(numLinks >= 2);
-		result = packetFile->readPacket(whichPacket++, (uint8_t*)&doorLinks[numLinksRead]);
-		if (result <= 0)
-			Fatal(result, " GlobalMap.init: Unable to write doorLinks packet ");
+		mapRequests.push_back(packetFile->readPacketAsync(whichPacket++, (uint8_t*)&doorLinks[numLinksRead]));
 		doors[i].links[1] = &doorLinks[numLinksRead];
 		numLinksRead += numLinks;
 	}
 	Assert(numLinksRead == numDoorLinks, 0, " GlobalMap.init: Incorrect Links count ");
+	//-------------------------------------------------------------
+	// The area map, door infos and links all have to be in before
+	// the areas are opened and anything looks at them...
+	for (auto request : mapRequests)
+	{
+		result = packetFile->waitPacket(request);
+		if (result <= 0)
+			Fatal(result, " GlobalMap.init: unable to read areaMap, doorInfos or doorLinks packet ");
+	}
 	numOffMapAreas = 0;
 	for (i = 0; i < numAreas; i++)
 		if (areas[i].offMap)
@@ -3913,7 +3929,7 @@ GlobalMap::writeLog(const std::wstring_view& s)
 PVOID
 MoveMap::operator new(size_t ourSize)
 {
-	PVOID result = systemHeap->Malloc(ourSize);
+	PVOID result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
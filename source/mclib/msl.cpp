@@ -99,7 +99,7 @@ extern bool silentMode; // Used for automated builds to keep errors from popping
 // TG_TypeMultiShape
 PVOIDTG_TypeMultiShape::operator new(size_t mySize)
 {
-	PVOID result = TG_Shape::tglHeap->Malloc(mySize);
+	PVOID result = TG_Shape::tglHeap->Malloc(mySize, HEAP_CALLER());
 	return result;
 }
 
@@ -817,7 +817,7 @@ TG_TypeMultiShape::LoadTGMultiShapeFromASE(
 PVOID
 TG_MultiShape::operator new(size_t mySize)
 {
-	PVOID result = TG_Shape::tglHeap->Malloc(mySize);
+	PVOID result = TG_Shape::tglHeap->Malloc(mySize, HEAP_CALLER());
 	return result;
 }
 
@@ -1671,7 +1671,7 @@ TG_MultiShape::isChildOf(const std::wstring_view& nodeName, const std::wstring_v
 //-------------------------------------------------------------------------------
 PVOIDTG_AnimateShape::operator new(size_t mySize)
 {
-	PVOID result = TG_Shape::tglHeap->Malloc(mySize);
+	PVOID result = TG_Shape::tglHeap->Malloc(mySize, HEAP_CALLER());
 	return result;
 }
 
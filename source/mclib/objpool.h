@@ -0,0 +1,239 @@
+//---------------------------------------------------------------------------
+//
+// ObjPool.h -- Fixed size pools of game objects
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#pragma once
+
+#ifndef OBJPOOL_H
+#define OBJPOOL_H
+
+//---------------------------------------------------------------------------
+// Include Files
+
+#include <unordered_map>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// Hands out objects from an array made up front, the way the Object
+// Manager keeps its weapon bolts, carnage, lights and artillery.  Free
+// slots sit on a stack and the slots in use are kept packed together, so
+// acquiring, releasing and walking the objects in use never touch a free
+// slot.  An empty pool SPEWs the first time and returns nullptr; it never
+// takes an object back from whoever has it.
+//
+// A handle is a slot and the generation it was handed out in.  Releasing
+// a slot moves its generation on, so a handle kept past its object's
+// release gets nullptr from get.
+//
+// Releasing moves the last object in use into the released one's place,
+// so a walk that releases as it goes runs from the back.
+
+typedef uint32_t ObjectPoolHandle;
+
+#define OBJECT_POOL_SLOT_BITS 16
+#define MAX_OBJECT_POOL_SLOTS (1 << OBJECT_POOL_SLOT_BITS)
+#define INVALID_POOL_HANDLE 0 // generations start at 1
+
+typedef struct _ObjectPoolStats
+{
+	uint32_t capacity;
+	uint32_t numActive;
+	uint32_t peakActive;
+	uint32_t numAcquires;
+	uint32_t numReleases;
+	uint32_t numExhausted; // acquires turned away with nothing free
+} ObjectPoolStats;
+
+//---------------------------------------------------------------------------
+template <class T>
+class ObjectPool
+{
+	// Data Members
+	//-------------
+protected:
+	T** objects; // not the pool's, it only hands them out
+	uint32_t capacity;
+	std::vector<uint16_t> generations;
+	std::vector<uint32_t> freeSlots;
+	std::vector<uint32_t> active;
+	std::vector<uint32_t> activeIndex; // where each slot in use is in active
+	std::unordered_map<T*, uint32_t> slots;
+	ObjectPoolStats ownStats;
+	ObjectPoolStats* stats;
+	wchar_t poolName[32];
+
+	// Member Functions
+	//-----------------
+public:
+	ObjectPool(void)
+	{
+		objects = nullptr;
+		capacity = 0;
+		memset(&ownStats, 0, sizeof(ObjectPoolStats));
+		stats = &ownStats;
+		poolName[0] = 0;
+	}
+
+	~ObjectPool(void) { destroy(); }
+
+	//---------------------------------------------------------------
+	// Objects that already exist, as after loading a save, start out
+	// in use.  The stats can be kept somewhere the debugger screen
+	// can watch.
+	void init(T** poolObjects, uint32_t poolCapacity, const std::wstring_view& poolId,
+		ObjectPoolStats* poolStats = nullptr)
+	{
+		destroy();
+		gosASSERT(poolCapacity < MAX_OBJECT_POOL_SLOTS);
+		objects = poolObjects;
+		capacity = poolObjects ? poolCapacity : 0;
+		stats = poolStats ? poolStats : &ownStats;
+		memset(stats, 0, sizeof(ObjectPoolStats));
+		if (poolId)
+		{
+			strncpy(poolName, poolId, 31);
+			poolName[31] = 0;
+		}
+		generations.assign(capacity, 1);
+		activeIndex.assign(capacity, 0);
+		freeSlots.reserve(capacity);
+		active.reserve(capacity);
+		//-------------------------------------------
+		// Backwards, so slot 0 is the first handed
+		// out.
+		for (uint32_t slot = capacity; slot-- > 0;)
+		{
+			slots[objects[slot]] = slot;
+			if (objects[slot]->getExists())
+			{
+				activeIndex[slot] = (uint32_t)active.size();
+				active.push_back(slot);
+			}
+			else
+				freeSlots.push_back(slot);
+		}
+		stats->capacity = capacity;
+		stats->numActive = stats->peakActive = (uint32_t)active.size();
+	}
+
+	void destroy(void)
+	{
+		if (stats->numExhausted)
+			SPEW((0, "Object pool %s peaked at %u of %u, %u turned away\n", poolName,
+				stats->peakActive, capacity, stats->numExhausted));
+		objects = nullptr;
+		capacity = 0;
+		generations.clear();
+		freeSlots.clear();
+		active.clear();
+		activeIndex.clear();
+		slots.clear();
+		//-------------------------------------------
+		// Whoever was watching the stats still sees
+		// the peak.
+		stats->numActive = 0;
+		stats = &ownStats;
+		memset(&ownStats, 0, sizeof(ObjectPoolStats));
+	}
+
+	T* acquire(ObjectPoolHandle* handle = nullptr)
+	{
+		if (freeSlots.empty())
+		{
+			if (!stats->numExhausted++)
+				SPEW((0, "Object pool %s is out of objects, all %u are in use\n", poolName, capacity));
+			if (handle)
+				*handle = INVALID_POOL_HANDLE;
+			return (nullptr);
+		}
+		uint32_t slot = freeSlots.back();
+		freeSlots.pop_back();
+		activeIndex[slot] = (uint32_t)active.size();
+		active.push_back(slot);
+		stats->numAcquires++;
+		stats->numActive = (uint32_t)active.size();
+		if (stats->numActive > stats->peakActive)
+			stats->peakActive = stats->numActive;
+		if (handle)
+			*handle = makeHandle(slot);
+		return (objects[slot]);
+	}
+
+	bool release(T* object)
+	{
+		auto found = slots.find(object);
+		if (found == slots.end())
+			return (false);
+		return (releaseSlot(found->second));
+	}
+
+	bool release(ObjectPoolHandle handle)
+	{
+		if (!get(handle))
+			return (false);
+		return (releaseSlot(handle & (MAX_OBJECT_POOL_SLOTS - 1)));
+	}
+
+	T* get(ObjectPoolHandle handle)
+	{
+		uint32_t slot = handle & (MAX_OBJECT_POOL_SLOTS - 1);
+		if ((slot >= capacity) || !inUse(slot) || (generations[slot] != (handle >> OBJECT_POOL_SLOT_BITS)))
+			return (nullptr);
+		return (objects[slot]);
+	}
+
+	ObjectPoolHandle getHandle(T* object)
+	{
+		auto found = slots.find(object);
+		if ((found == slots.end()) || !inUse(found->second))
+			return (INVALID_POOL_HANDLE);
+		return (makeHandle(found->second));
+	}
+
+	uint32_t getNumActive(void) { return ((uint32_t)active.size()); }
+
+	T* getActive(uint32_t index) { return (objects[active[index]]); }
+
+	uint32_t getCapacity(void) { return (capacity); }
+
+	ObjectPoolStats getStatistics(void) { return (*stats); }
+
+protected:
+	ObjectPoolHandle makeHandle(uint32_t slot)
+	{
+		return (((ObjectPoolHandle)generations[slot] << OBJECT_POOL_SLOT_BITS) | slot);
+	}
+
+	bool inUse(uint32_t slot)
+	{
+		uint32_t index = activeIndex[slot];
+		return ((index < active.size()) && (active[index] == slot));
+	}
+
+	bool releaseSlot(uint32_t slot)
+	{
+		if (!inUse(slot))
+			return (false);
+		uint32_t index = activeIndex[slot];
+		uint32_t last = active.back();
+		active[index] = last;
+		activeIndex[last] = index;
+		active.pop_back();
+		freeSlots.push_back(slot);
+		if (++generations[slot] == 0)
+			generations[slot] = 1;
+		stats->numReleases++;
+		stats->numActive = (uint32_t)active.size();
+		return (true);
+	}
+};
+
+bool
+ObjectPoolTestClass(void);
+
+//---------------------------------------------------------------------------
+#endif
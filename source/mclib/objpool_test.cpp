@@ -0,0 +1,145 @@
+//===========================================================================//
+// File:	objpool_test.cpp                                                 //
+// Contents: test function for the object pools                              //
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#include "stdinc.h"
+#include "objpool.h"
+
+#define OBJECT_POOL_TEST_SIZE 8
+
+//---------------------------------------------------------------------------
+// All a pool asks of its objects.
+
+class ObjectPoolTestObject
+{
+public:
+	bool exists = false;
+
+	bool getExists(void) { return exists; }
+};
+
+//---------------------------------------------------------------------------
+// The objects in use, walked the way the Object Manager walks them, are
+// exactly the ones expected.
+
+static bool
+ObjectPoolTestActive(ObjectPool<ObjectPoolTestObject>& pool, const std::vector<ObjectPoolTestObject*>& expected)
+{
+	Test_Assumption(pool.getNumActive() == expected.size());
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		bool found = false;
+		for (uint32_t j = 0; j < pool.getNumActive(); j++)
+			found = found || (pool.getActive(j) == expected[i]);
+		Test_Assumption(found);
+	}
+	return true;
+}
+
+//---------------------------------------------------------------------------
+
+bool
+ObjectPoolTestClass(void)
+{
+	SPEW((GROUP_STUFF_TEST, "Starting ObjectPool test..."));
+	ObjectPoolTestObject storage[OBJECT_POOL_TEST_SIZE];
+	ObjectPoolTestObject* objects[OBJECT_POOL_TEST_SIZE];
+	size_t i;
+	for (i = 0; i < OBJECT_POOL_TEST_SIZE; i++)
+		objects[i] = &storage[i];
+	//-------------------------------------------------------
+	// An object that already exists, as after a save, starts
+	// out in use and has a handle...
+	storage[3].exists = true;
+	ObjectPoolStats stats;
+	ObjectPool<ObjectPoolTestObject> pool;
+	pool.init(objects, OBJECT_POOL_TEST_SIZE, "TEST", &stats);
+	Test_Assumption(ObjectPoolTestActive(pool, {objects[3]}));
+	Test_Assumption((stats.numActive == 1) && (stats.peakActive == 1));
+	ObjectPoolHandle loaded = pool.getHandle(objects[3]);
+	Test_Assumption(loaded != INVALID_POOL_HANDLE);
+	Test_Assumption(pool.get(loaded) == objects[3]);
+	Test_Assumption(pool.getHandle(objects[0]) == INVALID_POOL_HANDLE);
+	//------------------------------------------------------------
+	// The rest hand out slot 0 first, each with a handle that gets
+	// it back, until the pool runs dry and turns the next one away.
+	ObjectPoolHandle handles[OBJECT_POOL_TEST_SIZE];
+	std::vector<ObjectPoolTestObject*> inUse = {objects[3]};
+	for (i = 0; i < OBJECT_POOL_TEST_SIZE - 1; i++)
+	{
+		ObjectPoolTestObject* object = pool.acquire(&handles[i]);
+		Test_Assumption(object != nullptr);
+		Test_Assumption(object != objects[3]);
+		Test_Assumption(pool.get(handles[i]) == object);
+		Test_Assumption(pool.getHandle(object) == handles[i]);
+		inUse.push_back(object);
+	}
+	Test_Assumption(pool.get(handles[0]) == objects[0]);
+	Test_Assumption(ObjectPoolTestActive(pool, inUse));
+	ObjectPoolHandle exhausted = loaded;
+	Test_Assumption(pool.acquire(&exhausted) == nullptr);
+	Test_Assumption(exhausted == INVALID_POOL_HANDLE);
+	Test_Assumption(pool.get(INVALID_POOL_HANDLE) == nullptr);
+	Test_Assumption((stats.numExhausted == 1) && (stats.peakActive == OBJECT_POOL_TEST_SIZE));
+	//------------------------------------------------------------
+	// Released by handle or by pointer, a slot's old handles stop
+	// working, a second release is refused, and the rest carry on.
+	ObjectPoolTestObject* first = pool.get(handles[0]);
+	ObjectPoolTestObject* second = pool.get(handles[1]);
+	Test_Assumption(pool.release(handles[0]));
+	Test_Assumption(!pool.release(handles[0]));
+	Test_Assumption(!pool.release(first));
+	Test_Assumption(pool.get(handles[0]) == nullptr);
+	Test_Assumption(pool.getHandle(first) == INVALID_POOL_HANDLE);
+	Test_Assumption(pool.release(second));
+	Test_Assumption(pool.get(handles[1]) == nullptr);
+	Test_Assumption(!pool.release(handles[1]));
+	inUse.erase(std::remove(inUse.begin(), inUse.end(), first), inUse.end());
+	inUse.erase(std::remove(inUse.begin(), inUse.end(), second), inUse.end());
+	Test_Assumption(ObjectPoolTestActive(pool, inUse));
+	for (i = 2; i < OBJECT_POOL_TEST_SIZE - 1; i++)
+		Test_Assumption(pool.get(handles[i]) != nullptr);
+	//-------------------------------------------------------------
+	// The same slot handed out again has a new generation, so the
+	// handle from before still gets nothing and can't release it.
+	ObjectPoolHandle again;
+	ObjectPoolTestObject* reused = pool.acquire(&again);
+	Test_Assumption(reused == second);
+	Test_Assumption(again != handles[1]);
+	Test_Assumption((again & (MAX_OBJECT_POOL_SLOTS - 1)) == (handles[1] & (MAX_OBJECT_POOL_SLOTS - 1)));
+	Test_Assumption(pool.get(handles[1]) == nullptr);
+	Test_Assumption(!pool.release(handles[1]));
+	Test_Assumption(pool.get(again) == reused);
+	//------------------------------------------------------------
+	// Around and around one slot, past where the generation wraps,
+	// it never comes back as 0 and the last handle always goes dead.
+	ObjectPoolHandle previous = again;
+	for (i = 0; i < 70000; i++)
+	{
+		Test_Assumption(pool.release(previous));
+		ObjectPoolHandle next;
+		Test_Assumption(pool.acquire(&next) == reused);
+		Test_Assumption((next >> OBJECT_POOL_SLOT_BITS) != 0);
+		Test_Assumption(next != previous);
+		Test_Assumption(pool.get(previous) == nullptr);
+		Test_Assumption(pool.get(next) == reused);
+		previous = next;
+	}
+	Test_Assumption(pool.get(again) == nullptr);
+	//---------------------------------------------------------
+	// A walk that releases as it goes, from the back, gets all of
+	// them, the loaded one too, which was never acquired.  What's
+	// watching the stats keeps the peak.
+	for (uint32_t index = pool.getNumActive(); index-- > 0;)
+		Test_Assumption(pool.release(pool.getActive(index)));
+	Test_Assumption(pool.getNumActive() == 0);
+	Test_Assumption(pool.get(loaded) == nullptr);
+	Test_Assumption(stats.numReleases == stats.numAcquires + 1);
+	Test_Assumption(!pool.release(objects[0]));
+	pool.destroy();
+	Test_Assumption((stats.numActive == 0) && (stats.peakActive == OBJECT_POOL_TEST_SIZE));
+	return true;
+}
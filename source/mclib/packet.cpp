@@ -20,6 +20,10 @@
 #include "lz.h"
 #endif
 
+#ifndef PACKETIO_H
+#include "packetio.h"
+#endif
+
 #include "zlib.h"
 
 #ifndef _MBCS
@@ -234,6 +238,7 @@ PacketFile::createWithCase(const std::wstring_view& filename)
 void
 PacketFile::close(void)
 {
+	PacketReaderForget(this);
 	atClose();
 	MechFile::close();
 }
@@ -259,6 +264,21 @@ int32_t
 PacketFile::readPacket(int32_t packet, uint8_t* buffer)
 {
 	int32_t result = 0;
+	if (packet >= 0)
+	{
+		//-----------------------------------------------------
+		// Prefetched?  Then it's read already, or on its way.
+		PacketRequestPtr prefetched = PacketReaderTakePrefetch(this, packet, buffer);
+		if (prefetched)
+		{
+			result = PacketReaderWait(prefetched);
+			if (result)
+			{
+				seekPacket(packet);
+				return result;
+			}
+		}
+	}
 	if ((packet == -1) || (packet == currentPacket) || (seekPacket(packet) == NO_ERROR))
 	{
 		if ((getStorageType() == STORAGE_TYPE_RAW) || (getStorageType() == STORAGE_TYPE_FWF))
@@ -288,8 +308,8 @@ PacketFile::readPacket(int32_t packet, uint8_t* buffer)
 				if (LZPacketBuffer)
 				{
 					read(LZPacketBuffer, (packetSize - sizeof(int32_t)));
-					int32_t decompLength =
-						LZDecomp(buffer, LZPacketBuffer, packetSize - sizeof(int32_t));
+					int32_t decompLength = LZDecomp(
+						buffer, packetUnpackedSize, LZPacketBuffer, packetSize - sizeof(int32_t));
 					if (decompLength != packetUnpackedSize)
 						result = 0;
 					else
@@ -325,6 +345,33 @@ PacketFile::readPacket(int32_t packet, uint8_t* buffer)
 				}
 			}
 			break;
+			case STORAGE_TYPE_LZB:
+			{
+				seek(packetBase + sizeof(int32_t));
+				if (!LZPacketBuffer)
+				{
+					LZPacketBuffer = (uint8_t*)malloc(LZPacketBufferSize);
+					gosASSERT(LZPacketBuffer);
+				}
+				if ((int32_t)LZPacketBufferSize < packetSize)
+				{
+					LZPacketBufferSize = packetSize;
+					free(LZPacketBuffer);
+					LZPacketBuffer = (uint8_t*)malloc(LZPacketBufferSize);
+					gosASSERT(LZPacketBuffer);
+				}
+				if (LZPacketBuffer)
+				{
+					read(LZPacketBuffer, (packetSize - sizeof(int32_t)));
+					size_t decompLength = LZBDecomp(
+						buffer, packetUnpackedSize, LZPacketBuffer, packetSize - sizeof(int32_t));
+					if ((int32_t)decompLength != packetUnpackedSize)
+						result = 0;
+					else
+						result = decompLength;
+				}
+			}
+			break;
 			case STORAGE_TYPE_HF:
 				STOP(("Tried to read a Huffman Compressed Packet.  No Longer "
 					  "Supported!!"));
@@ -335,6 +382,82 @@ PacketFile::readPacket(int32_t packet, uint8_t* buffer)
 	return result;
 }
 
+//---------------------------------------------------------------------------
+// Starts reading packet into buffer on the packet reader.  Child files have
+// no name of their own to reopen, so they (and everything when the reader
+// isn't running) are read right here and handed back finished.
+PacketRequestPtr
+PacketFile::readPacketAsync(int32_t packet, uint8_t* buffer)
+{
+	PacketRequestPtr request = nullptr;
+	if (!m_parent)
+	{
+		request = PacketReaderTakePrefetch(this, packet, buffer);
+		if (!request)
+			request = PacketReaderRequest(this, packet, buffer, false);
+	}
+	if (!request)
+		request = PacketReaderFinished(readPacket(packet, buffer));
+	return (request);
+}
+
+//---------------------------------------------------------------------------
+int32_t
+PacketFile::waitPacket(PacketRequestPtr request)
+{
+	return (PacketReaderWait(request));
+}
+
+//---------------------------------------------------------------------------
+// A hint that packets firstPacket on are wanted soon.  The reader reads and
+// unpacks them ahead if it has the memory; readPacket picks them up.
+void
+PacketFile::prefetchPackets(int32_t firstPacket, int32_t count)
+{
+	if (m_parent || !PacketReaderRunning())
+		return;
+	for (int32_t packet = firstPacket; (packet < (firstPacket + count)) && (packet < numPackets); packet++)
+		PacketReaderRequest(this, packet, nullptr, true);
+}
+
+//---------------------------------------------------------------------------
+// The stored bytes of packet in a file held in RAM (anything opened out of
+// a fastfile), past the size long if it's compressed.  Only looks at the
+// seek table and the image, never the current packet, so the packet reader
+// can call it from its own thread.  nullptr if the file isn't in RAM.
+const uint8_t*
+PacketFile::viewPacket(int32_t packet, int32_t& storageType, int32_t& packedSize, int32_t& unpackedSize)
+{
+	storageType = STORAGE_TYPE_NUL;
+	packedSize = unpackedSize = 0;
+	if (!isInRAM() || !seekTable || (packet < 0) || (packet >= numPackets))
+		return nullptr;
+	int32_t offset = GetPacketOffset(seekTable[packet]);
+	int32_t next = (int32_t)physicalLength;
+	if (packet < (numPackets - 1))
+		next = GetPacketOffset(seekTable[packet + 1]);
+	if ((offset <= 0) || (next < offset) || (next > (int32_t)physicalLength))
+		return nullptr;
+	storageType = GetPacketType(seekTable[packet]);
+	packedSize = next - offset;
+	const uint8_t* stored = fileImage + offset;
+	switch (storageType)
+	{
+	case STORAGE_TYPE_LZD:
+	case STORAGE_TYPE_ZLIB:
+	case STORAGE_TYPE_LZB:
+		if (packedSize < (int32_t)sizeof(int32_t))
+			return nullptr;
+		memcpy(&unpackedSize, stored, sizeof(int32_t));
+		return (stored + sizeof(int32_t));
+	case STORAGE_TYPE_RAW:
+	case STORAGE_TYPE_FWF:
+		unpackedSize = packedSize;
+		return (stored);
+	}
+	return nullptr;
+}
+
 //---------------------------------------------------------------------------
 int32_t
 PacketFile::readPackedPacket(int32_t packet, uint8_t* buffer)
@@ -363,6 +486,12 @@ PacketFile::readPackedPacket(int32_t packet, uint8_t* buffer)
 				read(buffer, packetSize);
 			}
 			break;
+			case STORAGE_TYPE_LZB:
+			{
+				seek(packetBase + sizeof(int32_t));
+				read(buffer, packetSize);
+			}
+			break;
 			}
 		}
 	}
@@ -397,6 +526,10 @@ PacketFile::seekPacket(int32_t packet)
 		// the first uint32_t of a compressed packet is the unpacked length
 		packetUnpackedSize = readLong();
 		break;
+	case STORAGE_TYPE_LZB:
+		// the first uint32_t of a compressed packet is the unpacked length
+		packetUnpackedSize = readLong();
+		break;
 	case STORAGE_TYPE_RAW:
 		packetUnpackedSize = packetSize;
 		break;
@@ -520,7 +653,7 @@ PacketFile::writePacket(int32_t packet, uint8_t* buffer, int32_t nbytes, uint8_t
 	// right now doesn't allow anything but same size.
 	int32_t result = 0;
 	uint8_t* workBuffer = nullptr;
-	if (pType == ANY_PACKET_TYPE || pType == STORAGE_TYPE_LZD || pType == STORAGE_TYPE_ZLIB)
+	if (pType == ANY_PACKET_TYPE || pType == STORAGE_TYPE_LZD || pType == STORAGE_TYPE_ZLIB || pType == STORAGE_TYPE_LZB)
 	{
 		if ((nbytes << 1) < 4096)
 			workBuffer = (uint8_t*)malloc(4096);
@@ -536,7 +669,35 @@ PacketFile::writePacket(int32_t packet, uint8_t* buffer, int32_t nbytes, uint8_t
 	// Code goes in here to pick the best compressed
 	// version of the packet.  Otherwise, default
 	// to RAW.
-	if ((pType == ANY_PACKET_TYPE) || (pType == STORAGE_TYPE_LZD) || (pType == STORAGE_TYPE_ZLIB))
+	if (pType == STORAGE_TYPE_LZB)
+	{
+		//-----------------------------------------------
+		// Only asked for explicitly (the repacker).  Kept
+		// only if it's smaller, otherwise the packet goes
+		// RAW, same as zLib does for ANY_PACKET_TYPE.
+		uint32_t actualSize = nbytes << 1;
+		if (actualSize < 4096)
+			actualSize = 4096;
+		size_t workBufferSize = LZBCompress(workBuffer, actualSize, buffer, nbytes);
+		if (workBufferSize && ((int32_t)workBufferSize < nbytes))
+		{
+			//------------------------------------------------
+			// Check the round trip off to the side, so a bad
+			// one can't clobber the caller's packet...
+			uint8_t* checkBuffer = (uint8_t*)malloc(nbytes);
+			gosASSERT(checkBuffer != nullptr);
+			if (((int32_t)LZBDecomp(checkBuffer, nbytes, workBuffer, workBufferSize) != nbytes) ||
+				(memcmp(checkBuffer, buffer, nbytes) != 0))
+				STOP(("Packet %d of file %s did not survive compression", packet, m_fileName));
+			free(checkBuffer);
+			packetSize = workBufferSize;
+		}
+		else
+		{
+			pType = STORAGE_TYPE_RAW;
+		}
+	}
+	else if ((pType == ANY_PACKET_TYPE) || (pType == STORAGE_TYPE_LZD) || (pType == STORAGE_TYPE_ZLIB))
 	{
 		if (pType == ANY_PACKET_TYPE)
 			pType = STORAGE_TYPE_RAW;
@@ -566,7 +727,7 @@ PacketFile::writePacket(int32_t packet, uint8_t* buffer, int32_t nbytes, uint8_t
 	}
 	packetType = pType;
 	seek(packetBase);
-	if (packetType == STORAGE_TYPE_ZLIB)
+	if ((packetType == STORAGE_TYPE_ZLIB) || (packetType == STORAGE_TYPE_LZB))
 	{
 		writeLong(packetUnpackedSize);
 		result = write(workBuffer, packetSize);
@@ -706,7 +867,7 @@ PacketFile::writePacket(int32_t packet, uint8_t* buffer)
 		return 0;
 	}
 	seekPacket(packet);
-	if (packetType == STORAGE_TYPE_LZD || packetType == STORAGE_TYPE_HF || packetType == STORAGE_TYPE_ZLIB)
+	if (packetType == STORAGE_TYPE_LZD || packetType == STORAGE_TYPE_HF || packetType == STORAGE_TYPE_ZLIB || packetType == STORAGE_TYPE_LZB)
 	{
 		return (PACKET_WRONG_SIZE);
 	}
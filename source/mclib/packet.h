@@ -34,6 +34,7 @@ enum _packet_storage_type : uint32_t
 	STORAGE_TYPE_LZD = 0x02, // LZ Compressed Packet
 	STORAGE_TYPE_HF = 0x03, // Huffman Compressed Packet
 	STORAGE_TYPE_ZLIB = 0x04, // zLib Compressed Packet
+	STORAGE_TYPE_LZB = 0x05, // LZ Block Compressed Packet
 	STORAGE_TYPE_NUL = 0x07, // nullptr packet.
 };
 #define DEFAULT_PACKET_TYPE STORAGE_TYPE_RAW
@@ -51,6 +52,8 @@ enum _packet_storage_type : uint32_t
 //---------------------------------------------------------------------------
 // Structure and Class Definitions
 
+typedef struct _PacketRequest* PacketRequestPtr;
+
 //---------------------------------------------------------------------------
 class PacketFile : public MechFile
 {
@@ -88,6 +91,7 @@ public:
 	virtual void close(void);
 
 	void forceUseCheckSum(void) { usesCheckSum = true; }
+	bool getUsesCheckSum(void) { return usesCheckSum; }
 
 	int32_t readPacketOffset(int32_t packet, int32_t* lastType = 0);
 	int32_t readPacket(int32_t packet, uint8_t* buffer);
@@ -95,6 +99,16 @@ public:
 
 	int32_t seekPacket(int32_t packet);
 
+	//-------------------------------------------
+	// Background reads (see packetio.h).  buffer
+	// must hold the unpacked packet and stay put
+	// until waitPacket, which returns its size.
+	PacketRequestPtr readPacketAsync(int32_t packet, uint8_t* buffer);
+	int32_t waitPacket(PacketRequestPtr request);
+	void prefetchPackets(int32_t firstPacket, int32_t count);
+	const uint8_t* viewPacket(int32_t packet, int32_t& storageType, int32_t& packedSize, int32_t& unpackedSize);
+	bool isInRAM(void) { return (inRAM && (fileImage != nullptr)); }
+
 	void operator++(void);
 	void operator--(void);
 
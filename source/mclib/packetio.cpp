@@ -0,0 +1,685 @@
+//---------------------------------------------------------------------------
+//
+// PacketIO.cpp -- Background reads and prefetch for Packet Files
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//---------------------------------------------------------------------------
+// Include Files
+#include "stdinc.h"
+
+#ifndef PACKET_H
+#include "packet.h"
+#endif
+
+#ifndef PACKETIO_H
+#include "packetio.h"
+#endif
+
+#ifndef LZ_H
+#include "lz.h"
+#endif
+
+#include "zlib.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+//---------------------------------------------------------------------------
+// Static Globals
+
+typedef struct _ShadowFile
+{
+	PacketFile* owner;
+	PacketFile* shadow;
+	int32_t numActive; // requests queued or in progress
+} ShadowFile;
+
+PacketReaderStats PacketReaderStatistics = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+//---------------------------------------------------------------------------
+// Everything below is guarded by readerLock.  The I/O thread and the
+// workers drop it only around the actual read or unpack.
+static std::mutex readerLock;
+static std::condition_variable readerWake; // something to read
+static std::condition_variable unpackWake; // something to unpack
+static std::condition_variable readerIdle; // a request finished or memory came back
+static std::deque<PacketRequestPtr> readQueue;
+static std::deque<PacketRequestPtr> prefetchQueue; // only read when readQueue is empty
+static std::deque<PacketRequestPtr> unpackQueue;
+static std::vector<PacketRequestPtr> prefetchedRequests; // hints nobody has asked for yet
+static std::vector<ShadowFile> shadowFiles;
+static std::thread readerThread;
+static std::thread unpackThreads[MAX_PACKET_WORKERS];
+static int32_t numUnpackThreads = 0;
+static int32_t numUnpacking = 0; // queued for, or on, an unpack thread
+static size_t readerBudget = 0;
+static size_t readerBytes = 0;
+static bool readerRunning = false;
+static bool readerQuit = false;
+static std::atomic<int32_t> numPrefetched(0); // so readPacket can skip the lock
+
+//---------------------------------------------------------------------------
+static ShadowFile*
+PacketReaderFindShadow(PacketFile* owner)
+{
+	for (auto& shadowFile : shadowFiles)
+	{
+		if (shadowFile.owner == owner)
+			return &shadowFile;
+	}
+	return nullptr;
+}
+
+//---------------------------------------------------------------------------
+static void
+PacketReaderUnreserve(size_t bytes)
+{
+	readerBytes -= bytes;
+	PacketReaderStatistics.bytesInFlight = (uint32_t)readerBytes;
+	readerIdle.notify_all();
+}
+
+//---------------------------------------------------------------------------
+static void
+PacketReaderFree(PacketRequestPtr request)
+{
+	if (request->ownsData && request->data)
+	{
+		free(request->data);
+		PacketReaderUnreserve(request->unpackedSize);
+	}
+	delete request;
+}
+
+//---------------------------------------------------------------------------
+// A demand read may throw out prefetches that finished but were never
+// asked for.  Never ones still on their way: somebody may be about to
+// take them.
+static void
+PacketReaderEvictPrefetches(void)
+{
+	for (size_t i = 0; i < prefetchedRequests.size();)
+	{
+		PacketRequestPtr request = prefetchedRequests[i];
+		if (request->state >= PACKET_REQUEST_DONE)
+		{
+			prefetchedRequests.erase(prefetchedRequests.begin() + i);
+			numPrefetched--;
+			PacketReaderFree(request);
+		}
+		else
+			i++;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Prefetches only get what's free.  A demand read throws out finished
+// prefetches nobody claimed and waits out unpacks in progress, since those
+// give memory back on their own.  What's left belongs to prefetches the
+// caller claimed but hasn't waited on, and it may well be waiting on this
+// read first, so the read goes over the budget instead.
+static bool
+PacketReaderReserve(size_t bytes, bool demand, std::unique_lock<std::mutex>& lock)
+{
+	//----------------------------------------------------------
+	// Anything fits when nothing else is out, so one packet
+	// bigger than the whole budget still gets read.
+	while (readerBytes && ((readerBytes + bytes) > readerBudget) && !readerQuit)
+	{
+		if (!demand)
+			return false;
+		PacketReaderEvictPrefetches();
+		if (!readerBytes || ((readerBytes + bytes) <= readerBudget))
+			break;
+		if (!numUnpacking)
+		{
+			PacketReaderStatistics.numBudgetOverruns++;
+			break;
+		}
+		PacketReaderStatistics.numBudgetStalls++;
+		readerIdle.wait(lock);
+	}
+	readerBytes += bytes;
+	PacketReaderStatistics.bytesInFlight = (uint32_t)readerBytes;
+	if (PacketReaderStatistics.peakBytesInFlight < PacketReaderStatistics.bytesInFlight)
+		PacketReaderStatistics.peakBytesInFlight = PacketReaderStatistics.bytesInFlight;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+static void
+PacketReaderComplete(PacketRequestPtr request, int32_t result)
+{
+	ShadowFile* shadowFile = PacketReaderFindShadow(request->packetFile);
+	if (shadowFile)
+		shadowFile->numActive--;
+	if (request->packed)
+	{
+		if (!request->viewed)
+		{
+			free(request->packed);
+			PacketReaderUnreserve(request->packedSize);
+		}
+		request->packed = nullptr;
+	}
+	request->result = result;
+	PacketReaderStatistics.bytesUnpacked += result;
+	request->state = result ? PACKET_REQUEST_DONE : PACKET_REQUEST_FAILED;
+	if (request->released)
+		PacketReaderFree(request);
+	readerIdle.notify_all();
+}
+
+//---------------------------------------------------------------------------
+static int32_t
+PacketReaderUnpack(PacketRequestPtr request)
+{
+	size_t result = 0;
+	size_t packedLength = request->packedSize - sizeof(int32_t);
+	switch (request->storageType)
+	{
+	case STORAGE_TYPE_LZD:
+		result = LZDecomp(request->data, request->unpackedSize, request->packed, packedLength);
+		break;
+	case STORAGE_TYPE_ZLIB:
+	{
+		uint32_t decompLength = request->unpackedSize;
+		if (uncompress(request->data, &decompLength, request->packed, packedLength) == Z_OK)
+			result = decompLength;
+	}
+	break;
+	case STORAGE_TYPE_LZB:
+		result = LZBDecomp(request->data, request->unpackedSize, request->packed, packedLength);
+		break;
+	}
+	if ((int32_t)result != request->unpackedSize)
+		return 0;
+	return ((int32_t)result);
+}
+
+//---------------------------------------------------------------------------
+static void
+PacketReaderIOThread(void)
+{
+	std::unique_lock<std::mutex> lock(readerLock);
+	for (;;)
+	{
+		readerWake.wait(lock, [] { return readerQuit || !readQueue.empty() || !prefetchQueue.empty(); });
+		if (readerQuit)
+			break;
+		PacketRequestPtr request;
+		if (!readQueue.empty())
+		{
+			request = readQueue.front();
+			readQueue.pop_front();
+		}
+		else
+		{
+			request = prefetchQueue.front();
+			prefetchQueue.pop_front();
+		}
+		request->state = PACKET_REQUEST_READING;
+		PacketFile* shadow = request->shadow;
+		const uint8_t* image = nullptr;
+		int32_t seekResult = NO_ERROR;
+		if (shadow)
+		{
+			lock.unlock();
+			seekResult = shadow->seekPacket(request->packet);
+			lock.lock();
+			request->storageType = shadow->getStorageType();
+			request->packedSize = shadow->getPackedPacketSize();
+			request->unpackedSize = shadow->getPacketSize();
+		}
+		else
+		{
+			//-----------------------------------------------------
+			// Held in RAM, so the packet is already sitting in the
+			// owner's image.  Nothing to read and nothing to stage.
+			image = request->packetFile->viewPacket(
+				request->packet, request->storageType, request->packedSize, request->unpackedSize);
+			if (!image)
+				seekResult = PACKET_OUT_OF_RANGE;
+		}
+		bool compressed = (request->storageType == STORAGE_TYPE_LZD) ||
+			(request->storageType == STORAGE_TYPE_ZLIB) || (request->storageType == STORAGE_TYPE_LZB);
+		bool raw = (request->storageType == STORAGE_TYPE_RAW) || (request->storageType == STORAGE_TYPE_FWF);
+		if ((seekResult != NO_ERROR) || (request->unpackedSize <= 0) || (!compressed && !raw))
+		{
+			//---------------------------------------------
+			// Empty, nullptr or Huffman.  Let the ordinary
+			// read deal with those.
+			PacketReaderComplete(request, 0);
+			continue;
+		}
+		size_t staging = (compressed && !image) ? request->packedSize : 0;
+		if (request->prefetch)
+		{
+			if (!PacketReaderReserve(request->unpackedSize + staging, false, lock))
+			{
+				PacketReaderStatistics.numPrefetchesDropped++;
+				PacketReaderComplete(request, 0);
+				continue;
+			}
+			//-------------------------------------------
+			// Reserved as one, but given back as two.
+			request->data = (uint8_t*)malloc(request->unpackedSize);
+			request->ownsData = true;
+		}
+		else if (staging)
+			PacketReaderReserve(staging, true, lock);
+		if (readerQuit)
+		{
+			PacketReaderComplete(request, 0);
+			break;
+		}
+		if (staging)
+			request->packed = (uint8_t*)malloc(staging);
+		else if (image && compressed)
+		{
+			request->packed = (uint8_t*)image;
+			request->viewed = true;
+		}
+		lock.unlock();
+		int32_t result = 0;
+		if (!compressed && image)
+		{
+			memcpy(request->data, image, request->unpackedSize);
+			result = request->unpackedSize;
+		}
+		else if (!compressed)
+		{
+			result = shadow->readPacket(request->packet, request->data);
+			if (result != request->unpackedSize)
+				result = 0;
+		}
+		else if (!image)
+			shadow->readPackedPacket(request->packet, request->packed);
+		lock.lock();
+		if (!image)
+			PacketReaderStatistics.bytesRead += compressed ? request->packedSize : result;
+		if (!compressed)
+			PacketReaderComplete(request, result);
+		else if (numUnpackThreads)
+		{
+			request->state = PACKET_REQUEST_UNPACKING;
+			unpackQueue.push_back(request);
+			numUnpacking++;
+			unpackWake.notify_one();
+		}
+		else
+		{
+			request->state = PACKET_REQUEST_UNPACKING;
+			lock.unlock();
+			result = PacketReaderUnpack(request);
+			lock.lock();
+			PacketReaderComplete(request, result);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+static void
+PacketReaderUnpackThread(void)
+{
+	std::unique_lock<std::mutex> lock(readerLock);
+	for (;;)
+	{
+		unpackWake.wait(lock, [] { return readerQuit || !unpackQueue.empty(); });
+		if (readerQuit)
+			break;
+		PacketRequestPtr request = unpackQueue.front();
+		unpackQueue.pop_front();
+		lock.unlock();
+		int32_t result = PacketReaderUnpack(request);
+		lock.lock();
+		numUnpacking--;
+		PacketReaderComplete(request, result);
+	}
+}
+
+//---------------------------------------------------------------------------
+static PacketRequestPtr
+PacketReaderNewRequest(PacketFile* packetFile, int32_t packet)
+{
+	PacketRequestPtr request = new PacketRequest;
+	request->packetFile = packetFile;
+	request->shadow = nullptr;
+	request->packet = packet;
+	request->storageType = STORAGE_TYPE_NUL;
+	request->packedSize = 0;
+	request->unpackedSize = 0;
+	request->packed = nullptr;
+	request->viewed = false;
+	request->data = nullptr;
+	request->target = nullptr;
+	request->ownsData = false;
+	request->prefetch = false;
+	request->released = false;
+	request->state = PACKET_REQUEST_QUEUED;
+	request->result = 0;
+	return (request);
+}
+
+//---------------------------------------------------------------------------
+// Public Functions
+//---------------------------------------------------------------------------
+bool
+PacketReaderInit(int32_t numWorkers, size_t memoryBudget)
+{
+	if (readerRunning)
+		return true;
+	//------------------------------------------------------
+	// -1 picks for this machine: one core for the game,
+	// one for the I/O thread, the rest unpack.
+	if (numWorkers < 0)
+		numWorkers = (int32_t)std::thread::hardware_concurrency() - 2;
+	if (numWorkers > MAX_PACKET_WORKERS)
+		numWorkers = MAX_PACKET_WORKERS;
+	if (numWorkers < 0)
+		numWorkers = 0;
+	readerBudget = memoryBudget ? memoryBudget : DEFAULT_PACKET_READ_BUDGET;
+	readerBytes = 0;
+	readerQuit = false;
+	memset(&PacketReaderStatistics, 0, sizeof(PacketReaderStatistics));
+	readerThread = std::thread(PacketReaderIOThread);
+	//------------------------------------------------------
+	// With no workers the I/O thread unpacks as it goes,
+	// which still keeps it all off the caller's thread.
+	for (numUnpackThreads = 0; numUnpackThreads < numWorkers; numUnpackThreads++)
+		unpackThreads[numUnpackThreads] = std::thread(PacketReaderUnpackThread);
+	readerRunning = true;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+void
+PacketReaderFini(void)
+{
+	if (!readerRunning)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(readerLock);
+		readerQuit = true;
+	}
+	readerWake.notify_all();
+	unpackWake.notify_all();
+	readerIdle.notify_all();
+	readerThread.join();
+	for (int32_t i = 0; i < numUnpackThreads; i++)
+		unpackThreads[i].join();
+	numUnpackThreads = 0;
+	std::vector<PacketFile*> shadows;
+	{
+		std::lock_guard<std::mutex> lock(readerLock);
+		//----------------------------------------------
+		// Anything still queued fails, and whoever is
+		// waiting on it wakes up with nothing.
+		for (auto request : readQueue)
+			PacketReaderComplete(request, 0);
+		for (auto request : prefetchQueue)
+			PacketReaderComplete(request, 0);
+		for (auto request : unpackQueue)
+			PacketReaderComplete(request, 0);
+		readQueue.clear();
+		prefetchQueue.clear();
+		unpackQueue.clear();
+		numUnpacking = 0;
+		for (auto request : prefetchedRequests)
+			PacketReaderFree(request);
+		prefetchedRequests.clear();
+		numPrefetched = 0;
+		for (auto& shadowFile : shadowFiles)
+			shadows.push_back(shadowFile.shadow);
+		shadowFiles.clear();
+		readerRunning = false;
+	}
+	for (auto shadow : shadows)
+	{
+		if (shadow)
+		{
+			shadow->close();
+			delete shadow;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+bool
+PacketReaderRunning(void)
+{
+	return (readerRunning);
+}
+
+//---------------------------------------------------------------------------
+// Queues a read of packet.  buffer must hold the whole unpacked packet and
+// stay put until the wait; prefetches pass nullptr and the reader keeps
+// what it read until somebody asks for it.  Returns nullptr if it can't be
+// read in the background (the caller should read it the ordinary way), or
+// for a prefetch already on its way.
+PacketRequestPtr
+PacketReaderRequest(PacketFile* packetFile, int32_t packet, uint8_t* buffer, bool prefetch)
+{
+	if (!readerRunning || (packet < 0) || (packet >= packetFile->getNumPackets()))
+		return nullptr;
+	if (!prefetch && !buffer)
+		return nullptr;
+	std::unique_lock<std::mutex> lock(readerLock);
+	if (prefetch)
+	{
+		for (auto request : prefetchedRequests)
+		{
+			if ((request->packetFile == packetFile) && (request->packet == packet))
+				return nullptr;
+		}
+	}
+	ShadowFile* shadowFile = PacketReaderFindShadow(packetFile);
+	if (!shadowFile)
+	{
+		//------------------------------------------------------
+		// First background read of this file.  Open its twin
+		// here, on the caller's thread, so the heap the seek
+		// table comes out of is never touched by the reader.
+		// A file in RAM came out of a fastfile: reopening it
+		// would unpack the whole thing again, here, and the
+		// twin's close would shut the entry the owner is using.
+		// Its image is all the reader needs.
+		PacketFile* shadow = nullptr;
+		if (!packetFile->isInRAM())
+		{
+			lock.unlock();
+			shadow = new PacketFile;
+			if (shadow->open(packetFile->getFilename()) != NO_ERROR)
+			{
+				delete shadow;
+				return nullptr;
+			}
+			lock.lock();
+		}
+		ShadowFile newShadow = {packetFile, shadow, 0};
+		shadowFiles.push_back(newShadow);
+		shadowFile = &shadowFiles.back();
+	}
+	PacketRequestPtr request = PacketReaderNewRequest(packetFile, packet);
+	request->shadow = shadowFile->shadow;
+	request->data = buffer;
+	request->prefetch = prefetch;
+	shadowFile->numActive++;
+	if (prefetch)
+	{
+		prefetchQueue.push_back(request);
+		prefetchedRequests.push_back(request);
+		numPrefetched++;
+		PacketReaderStatistics.numPrefetches++;
+	}
+	else
+	{
+		readQueue.push_back(request);
+		PacketReaderStatistics.numRequests++;
+	}
+	readerWake.notify_one();
+	return (request);
+}
+
+//---------------------------------------------------------------------------
+// A request that is already done.  For reads that couldn't go through the
+// reader, so the caller still gets something to wait on.
+PacketRequestPtr
+PacketReaderFinished(int32_t result)
+{
+	PacketRequestPtr request = PacketReaderNewRequest(nullptr, -1);
+	request->result = result;
+	request->state = result ? PACKET_REQUEST_DONE : PACKET_REQUEST_FAILED;
+	return (request);
+}
+
+//---------------------------------------------------------------------------
+// Claims an earlier prefetch of packet for buffer.  One still waiting in
+// line is moved to the front and reads straight into buffer; one already
+// read is copied over by the wait.  nullptr if there was no such prefetch,
+// or it was dropped.
+PacketRequestPtr
+PacketReaderTakePrefetch(PacketFile* packetFile, int32_t packet, uint8_t* buffer)
+{
+	if (!numPrefetched || !buffer)
+		return nullptr;
+	std::lock_guard<std::mutex> lock(readerLock);
+	PacketRequestPtr request = nullptr;
+	for (size_t i = 0; i < prefetchedRequests.size(); i++)
+	{
+		if ((prefetchedRequests[i]->packetFile == packetFile) && (prefetchedRequests[i]->packet == packet))
+		{
+			request = prefetchedRequests[i];
+			prefetchedRequests.erase(prefetchedRequests.begin() + i);
+			numPrefetched--;
+			break;
+		}
+	}
+	if (!request)
+		return nullptr;
+	if (request->state == PACKET_REQUEST_FAILED)
+	{
+		PacketReaderFree(request);
+		return nullptr;
+	}
+	PacketReaderStatistics.numPrefetchHits++;
+	if (!request->ownsData)
+	{
+		//------------------------------------------------------
+		// The reader hasn't sized it up yet, so it can still
+		// become an ordinary read: no budget check, no copy.
+		auto queued = std::find(prefetchQueue.begin(), prefetchQueue.end(), request);
+		if (queued != prefetchQueue.end())
+		{
+			prefetchQueue.erase(queued);
+			readQueue.push_front(request);
+		}
+		request->prefetch = false;
+		request->data = buffer;
+		return (request);
+	}
+	request->target = buffer;
+	return (request);
+}
+
+//---------------------------------------------------------------------------
+bool
+PacketReaderDone(PacketRequestPtr request)
+{
+	return (!request || (request->state >= PACKET_REQUEST_DONE));
+}
+
+//---------------------------------------------------------------------------
+// Waits for the request, hands back the bytes unpacked (zero if it failed)
+// and frees it.  The request is gone after this.
+int32_t
+PacketReaderWait(PacketRequestPtr request)
+{
+	if (!request)
+		return 0;
+	std::unique_lock<std::mutex> lock(readerLock);
+	if (request->state < PACKET_REQUEST_DONE)
+	{
+		PacketReaderStatistics.numWaitStalls++;
+		readerIdle.wait(lock, [request] { return request->state >= PACKET_REQUEST_DONE; });
+	}
+	int32_t result = request->result;
+	if (result && request->target && (request->target != request->data))
+	{
+		lock.unlock();
+		memcpy(request->target, request->data, result);
+		lock.lock();
+	}
+	PacketReaderFree(request);
+	return (result);
+}
+
+//---------------------------------------------------------------------------
+// Gives up on a request without waiting.  Its buffer must still stay put
+// until the reader is done with it.
+void
+PacketReaderRelease(PacketRequestPtr request)
+{
+	if (!request)
+		return;
+	std::lock_guard<std::mutex> lock(readerLock);
+	if (request->state >= PACKET_REQUEST_DONE)
+		PacketReaderFree(request);
+	else
+		request->released = true;
+}
+
+//---------------------------------------------------------------------------
+// Called when packetFile closes.  Cancels what hasn't started, waits out
+// what has, drops its prefetches and closes its twin.
+void
+PacketReaderForget(PacketFile* packetFile)
+{
+	if (!readerRunning)
+		return;
+	std::unique_lock<std::mutex> lock(readerLock);
+	if (!PacketReaderFindShadow(packetFile))
+		return;
+	for (auto queue : {&readQueue, &prefetchQueue})
+	{
+		for (size_t i = 0; i < queue->size();)
+		{
+			PacketRequestPtr request = (*queue)[i];
+			if (request->packetFile == packetFile)
+			{
+				queue->erase(queue->begin() + i);
+				PacketReaderComplete(request, 0);
+			}
+			else
+				i++;
+		}
+	}
+	readerIdle.wait(lock, [packetFile] { return !PacketReaderFindShadow(packetFile)->numActive; });
+	for (size_t i = 0; i < prefetchedRequests.size();)
+	{
+		PacketRequestPtr request = prefetchedRequests[i];
+		if (request->packetFile == packetFile)
+		{
+			prefetchedRequests.erase(prefetchedRequests.begin() + i);
+			numPrefetched--;
+			PacketReaderFree(request);
+		}
+		else
+			i++;
+	}
+	ShadowFile* shadowFile = PacketReaderFindShadow(packetFile);
+	PacketFile* shadow = shadowFile->shadow;
+	shadowFiles.erase(shadowFiles.begin() + (shadowFile - shadowFiles.data()));
+	lock.unlock();
+	if (shadow)
+	{
+		shadow->close();
+		delete shadow;
+	}
+}
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+//---------------------------------------------------------------------------
+//
+// PacketIO.h -- Background reads and prefetch for Packet Files
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#pragma once
+
+#ifndef PACKETIO_H
+#define PACKETIO_H
+
+//---------------------------------------------------------------------------
+// Include Files
+
+//#include "packet.h"
+
+//---------------------------------------------------------------------------
+// One I/O thread reads the stored bytes of a packet, a few workers unpack
+// them.  Every PacketFile read this way off disk gets a read only twin,
+// opened on the caller's thread, which is the only file the I/O thread ever
+// touches; the caller's current packet and file position are left alone.
+// A file held in RAM (one out of a fastfile) needs no twin: its packets are
+// unpacked straight out of the image it already has.
+//
+// Memory the reader owns (staging for compressed packets, whole packets
+// read ahead on a prefetch hint) is held to a budget.  A prefetch that
+// doesn't fit is dropped and read normally later.  A demand read comes
+// first: it evicts unclaimed prefetches and waits out unpacks in progress,
+// then goes over the budget rather than wait on memory only its caller
+// can give back.
+
+#define MAX_PACKET_WORKERS 4
+#define DEFAULT_PACKET_READ_BUDGET (8 * 1024 * 1024)
+
+enum _packet_request_state : int32_t
+{
+	PACKET_REQUEST_QUEUED,
+	PACKET_REQUEST_READING,
+	PACKET_REQUEST_UNPACKING,
+	PACKET_REQUEST_DONE,
+	PACKET_REQUEST_FAILED
+};
+
+typedef struct _PacketRequest
+{
+	PacketFile* packetFile;
+	PacketFile* shadow; // the twin the I/O thread reads from, nullptr if in RAM
+	int32_t packet;
+	int32_t storageType;
+	int32_t packedSize; // bytes as stored, size long included
+	int32_t unpackedSize;
+	uint8_t* packed; // staging for compressed packets, or the owner's image
+	bool viewed; // packed is the owner's image, not ours
+	uint8_t* data; // where it unpacks to
+	uint8_t* target; // caller's buffer, if it isn't data
+	bool ownsData; // data is ours (a prefetch)
+	bool prefetch;
+	bool released; // nobody will wait, free it when done
+	std::atomic<int32_t> state;
+	int32_t result; // bytes unpacked, zero if it failed
+} PacketRequest;
+
+typedef struct _PacketReaderStats
+{
+	uint32_t numRequests; // demand reads queued
+	uint32_t numPrefetches; // prefetch hints queued
+	uint32_t numPrefetchHits; // reads an earlier prefetch answered
+	uint32_t numPrefetchesDropped; // hints that didn't fit the budget
+	uint32_t numBudgetStalls; // reads that waited for memory
+	uint32_t numBudgetOverruns; // demand reads let past a full budget
+	uint32_t numWaitStalls; // waits that had to block
+	uint32_t bytesInFlight; // reader owned memory right now
+	uint32_t peakBytesInFlight;
+	uint32_t bytesRead;
+	uint32_t bytesUnpacked;
+} PacketReaderStats;
+
+//---------------------------------------------------------------------------
+bool PacketReaderInit(int32_t numWorkers = -1, size_t memoryBudget = DEFAULT_PACKET_READ_BUDGET);
+void PacketReaderFini(void);
+bool PacketReaderRunning(void);
+
+PacketRequestPtr PacketReaderRequest(PacketFile* packetFile, int32_t packet, uint8_t* buffer, bool prefetch);
+PacketRequestPtr PacketReaderFinished(int32_t result);
+PacketRequestPtr PacketReaderTakePrefetch(PacketFile* packetFile, int32_t packet, uint8_t* buffer);
+bool PacketReaderDone(PacketRequestPtr request);
+int32_t PacketReaderWait(PacketRequestPtr request);
+void PacketReaderRelease(PacketRequestPtr request);
+void PacketReaderForget(PacketFile* packetFile);
+
+extern PacketReaderStats PacketReaderStatistics;
+
+//---------------------------------------------------------------------------
+#endif
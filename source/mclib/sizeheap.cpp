@@ -0,0 +1,654 @@
+//---------------------------------------------------------------------------
+//
+// SizeHeap.cpp -- Size class block allocator behind the User Heaps
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+//---------------------------------------------------------------------------
+// Include Files
+#include "stdinc.h"
+
+#ifndef SIZEHEAP_H
+#include "sizeheap.h"
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//---------------------------------------------------------------------------
+// Static Globals
+
+// Thread cache slots, a bit per slot some thread has.  A thread gives its
+// slot back when it exits; whoever gets it next inherits the blocks the
+// last owner cached, which are still good free blocks of the same heaps.
+static std::atomic<uint32_t> heapThreadSlots(0);
+
+struct HeapThreadSlot
+{
+	int32_t slot; // -1 not asked for yet, -2 none were left
+	HeapThreadSlot(void) { slot = -1; }
+	~HeapThreadSlot(void)
+	{
+		if (slot >= 0)
+			heapThreadSlots.fetch_and(~(1u << slot));
+	}
+};
+
+static thread_local HeapThreadSlot heapThreadSlot;
+
+//---------------------------------------------------------------------------
+static int32_t
+getHeapThreadSlot(void)
+{
+	if (heapThreadSlot.slot != -1)
+		return (heapThreadSlot.slot);
+	heapThreadSlot.slot = -2;
+	uint32_t slots = heapThreadSlots.load();
+	for (size_t i = 0; i < MAX_HEAP_THREADS; i++)
+	{
+		uint32_t bit = 1u << i;
+		if (slots & bit)
+			continue;
+		if (heapThreadSlots.compare_exchange_strong(slots, slots | bit))
+		{
+			heapThreadSlot.slot = (int32_t)i;
+			break;
+		}
+		i = (size_t)-1; // somebody else got one first, look again
+	}
+	return (heapThreadSlot.slot);
+}
+
+//---------------------------------------------------------------------------
+static inline uint32_t
+lowestBit(uint64_t mask)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, mask);
+	return (index);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanForward(&index, (uint32_t)mask))
+		return (index);
+	_BitScanForward(&index, (uint32_t)(mask >> 32));
+	return (index + 32);
+#else
+	return (__builtin_ctzll(mask));
+#endif
+}
+
+//---------------------------------------------------------------------------
+static inline uint32_t
+highestBit(uint64_t mask)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanReverse64(&index, mask);
+	return (index);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanReverse(&index, (uint32_t)(mask >> 32)))
+		return (index + 32);
+	_BitScanReverse(&index, (uint32_t)mask);
+	return (index);
+#else
+	return (63 - __builtin_clzll(mask));
+#endif
+}
+
+//---------------------------------------------------------------------------
+// class SizeClassHeap
+SizeClassHeap::SizeClassHeap(void)
+{
+	memory = nullptr;
+	memorySize = 0;
+	heapStart = nullptr;
+	heapEnd = nullptr;
+	threadCaches = false;
+	destroy();
+}
+
+//---------------------------------------------------------------------------
+bool
+SizeClassHeap::init(PVOID heapMemory, size_t heapSize)
+{
+	destroy();
+	//------------------------------------------------------
+	// The first block starts on a granule, the end marker
+	// (a header's worth) goes at the top, granule aligned.
+	uintptr_t bottom = ((uintptr_t)heapMemory + HEAP_GRANULE - 1) & ~(uintptr_t)(HEAP_GRANULE - 1);
+	uintptr_t top = ((uintptr_t)heapMemory + heapSize - HEAP_HEADER_SIZE) & ~(uintptr_t)(HEAP_GRANULE - 1);
+	if ((heapSize < (HEAP_MIN_BLOCK + 2 * HEAP_GRANULE)) || (heapSize > MAX_SIZE_HEAP) || (top < bottom + HEAP_MIN_BLOCK))
+		return (false);
+	memory = (uint8_t*)heapMemory;
+	memorySize = heapSize;
+	heapStart = (HeapBlockPtr)bottom;
+	heapEnd = (HeapBlockPtr)top;
+	heapStart->blockSize = top - bottom;
+	heapStart->upperBlock = nullptr; // Nothing above this in memory.
+	heapEnd->blockSize = 1; // allocated, so nothing merges with it
+	heapEnd->upperBlock = heapStart;
+	linkFree(heapStart);
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+void
+SizeClassHeap::destroy(void)
+{
+	memory = nullptr;
+	memorySize = 0;
+	heapStart = nullptr;
+	heapEnd = nullptr;
+	memset(smallLists, 0, sizeof(smallLists));
+	smallMask = 0;
+	largeRoot = nullptr;
+	memset(&stats, 0, sizeof(stats));
+	for (size_t i = 0; i < MAX_HEAP_THREADS; i++)
+	{
+		memset(caches[i].lists, 0, sizeof(caches[i].lists));
+		memset(caches[i].counts, 0, sizeof(caches[i].counts));
+		caches[i].numMallocs = 0;
+		caches[i].numFrees = 0;
+		caches[i].blocksCached = 0;
+		caches[i].bytesCached = 0;
+	}
+}
+
+//---------------------------------------------------------------------------
+PVOID
+SizeClassHeap::Malloc(size_t memSize)
+{
+	if (!memSize || (memSize > memorySize))
+	{
+		if (threadCaches)
+		{
+			std::lock_guard<std::mutex> lock(heapLock);
+			stats.numFailedMallocs++;
+		}
+		else
+			stats.numFailedMallocs++;
+		return (nullptr);
+	}
+	size_t blockSize = (memSize + HEAP_HEADER_SIZE + HEAP_GRANULE - 1) & ~(HEAP_GRANULE - 1);
+	if (blockSize < HEAP_MIN_BLOCK)
+		blockSize = HEAP_MIN_BLOCK;
+	HeapBlockPtr block = nullptr;
+	if (!threadCaches)
+	{
+		block = allocBlock(blockSize);
+	}
+	else
+	{
+		size_t sizeClass = blockSize / HEAP_GRANULE;
+		int32_t slot = getHeapThreadSlot();
+		if ((slot >= 0) && (sizeClass < HEAP_CACHED_CLASSES))
+		{
+			ThreadCache& cache = caches[slot];
+			block = cache.lists[sizeClass];
+			if (block)
+			{
+				cache.lists[sizeClass] = block->next;
+				cache.counts[sizeClass]--;
+				cache.numMallocs.fetch_add(1, std::memory_order_relaxed);
+				cache.blocksCached.fetch_sub(1, std::memory_order_relaxed);
+				cache.bytesCached.fetch_sub((uint32_t)blockSize, std::memory_order_relaxed);
+				return ((uint8_t*)block + HEAP_HEADER_SIZE);
+			}
+		}
+		std::lock_guard<std::mutex> lock(heapLock);
+		block = allocBlock(blockSize);
+	}
+	return (block ? ((uint8_t*)block + HEAP_HEADER_SIZE) : nullptr);
+}
+
+//---------------------------------------------------------------------------
+bool
+SizeClassHeap::Free(PVOID memBlock)
+{
+	HeapBlockPtr block = (HeapBlockPtr)((uint8_t*)memBlock - HEAP_HEADER_SIZE);
+	if (!threadCaches)
+	{
+		if (!isAllocatedBlock(block))
+			return (false);
+		stats.numFrees++;
+		freeBlock(block);
+		return (true);
+	}
+	//------------------------------------------------------------
+	// Only this block's own size is safe to look at without the
+	// lock, its neighbours may be splitting or merging right now.
+	if ((block < heapStart) || (block >= heapEnd) || ((uintptr_t)block & (HEAP_GRANULE - 1)) || !(block->blockSize & 1))
+		return (false);
+	size_t blockSize = block->blockSize & ~1;
+	size_t sizeClass = blockSize / HEAP_GRANULE;
+	int32_t slot = getHeapThreadSlot();
+	if ((slot >= 0) && (sizeClass < HEAP_CACHED_CLASSES))
+	{
+		ThreadCache& cache = caches[slot];
+		if (cache.counts[sizeClass] == HEAP_CACHE_DEPTH)
+		{
+			std::lock_guard<std::mutex> lock(heapLock);
+			flushCache(cache, HEAP_CACHE_DEPTH / 2);
+		}
+		block->next = cache.lists[sizeClass];
+		cache.lists[sizeClass] = block;
+		cache.counts[sizeClass]++;
+		cache.numFrees.fetch_add(1, std::memory_order_relaxed);
+		cache.blocksCached.fetch_add(1, std::memory_order_relaxed);
+		cache.bytesCached.fetch_add((uint32_t)blockSize, std::memory_order_relaxed);
+		return (true);
+	}
+	std::lock_guard<std::mutex> lock(heapLock);
+	if (!isAllocatedBlock(block))
+		return (false);
+	stats.numFrees++;
+	freeBlock(block);
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+size_t
+SizeClassHeap::totalFree(void)
+{
+	//---------------------------------------------------
+	// What could be handed out if every free block were
+	// asked for whole: each one loses its header.
+	HeapStats current = getStatistics();
+	size_t headers = (size_t)current.numFreeBlocks * HEAP_HEADER_SIZE;
+	return ((current.bytesFree > headers) ? (current.bytesFree - headers) : 0);
+}
+
+//---------------------------------------------------------------------------
+size_t
+SizeClassHeap::largestFree(void)
+{
+	std::unique_lock<std::mutex> lock(heapLock, std::defer_lock);
+	if (threadCaches)
+		lock.lock();
+	//---------------------------------------------------------
+	// Everything under child[1] is bigger than everything
+	// under child[0], so the biggest block is on the path that
+	// goes right whenever it can.
+	size_t largest = 0;
+	for (HeapTreeNodePtr node = largeRoot; node; node = node->child[1] ? node->child[1] : node->child[0])
+	{
+		if (node->blockSize > largest)
+			largest = node->blockSize;
+	}
+	if (!largest && smallMask)
+		largest = highestBit(smallMask) * HEAP_GRANULE;
+	return ((largest > HEAP_HEADER_SIZE) ? (largest - HEAP_HEADER_SIZE) : 0);
+}
+
+//---------------------------------------------------------------------------
+HeapStats
+SizeClassHeap::getStatistics(void)
+{
+	std::unique_lock<std::mutex> lock(heapLock, std::defer_lock);
+	if (threadCaches)
+		lock.lock();
+	//------------------------------------------------------
+	// Cached blocks are allocated as far as the heap knows;
+	// to everybody else they are free.
+	HeapStats result = stats;
+	for (size_t i = 0; i < MAX_HEAP_THREADS; i++)
+	{
+		uint32_t cacheHits = caches[i].numMallocs.load(std::memory_order_relaxed);
+		uint32_t blocksCached = caches[i].blocksCached.load(std::memory_order_relaxed);
+		uint32_t bytesCached = caches[i].bytesCached.load(std::memory_order_relaxed);
+		result.numMallocs += cacheHits;
+		result.numCacheHits += cacheHits;
+		result.numFrees += caches[i].numFrees.load(std::memory_order_relaxed);
+		result.blocksInUse -= blocksCached;
+		result.bytesInUse -= bytesCached;
+		result.numFreeBlocks += blocksCached;
+		result.bytesFree += bytesCached;
+	}
+	return (result);
+}
+
+//---------------------------------------------------------------------------
+void
+SizeClassHeap::setThreadCaches(bool useCaches)
+{
+	//-------------------------------------------------------
+	// Only safe while no other thread is using the heap.
+	if (!useCaches && threadCaches)
+	{
+		for (size_t i = 0; i < MAX_HEAP_THREADS; i++)
+			flushCache(caches[i], 0);
+	}
+	threadCaches = useCaches;
+}
+
+//---------------------------------------------------------------------------
+void
+SizeClassHeap::flushThreadCache(void)
+{
+	int32_t slot = getHeapThreadSlot();
+	if (!threadCaches || (slot < 0))
+		return;
+	std::lock_guard<std::mutex> lock(heapLock);
+	flushCache(caches[slot], 0);
+}
+
+//---------------------------------------------------------------------------
+int32_t
+SizeClassHeap::checkBlock(HeapBlockPtr block)
+{
+	if (block->upperBlock && ((uint8_t*)block->upperBlock + (block->upperBlock->blockSize & ~1)) != (uint8_t*)block)
+		return (HEAP_BLOCK_BAD_UPPER);
+	if (!block->upperBlock && (block != heapStart))
+		return (HEAP_BLOCK_BAD_UPPER);
+	HeapBlockPtr lower = (HeapBlockPtr)((uint8_t*)block + (block->blockSize & ~1));
+	if ((lower <= block) || (lower > heapEnd) || (lower->upperBlock != block))
+		return (HEAP_BLOCK_BAD_LOWER);
+	if (block->blockSize & 1)
+		return (HEAP_BLOCK_OK);
+	if (block->blockSize < HEAP_SMALL_LIMIT)
+	{
+		size_t sizeClass = block->blockSize / HEAP_GRANULE;
+		if (block->previous ? (block->previous->next != block) : (smallLists[sizeClass] != block))
+			return (HEAP_BLOCK_BAD_LINKS);
+		if (block->next && (block->next->previous != block))
+			return (HEAP_BLOCK_BAD_LINKS);
+		return (HEAP_BLOCK_OK);
+	}
+	HeapTreeNodePtr node = (HeapTreeNodePtr)block;
+	if ((node->previous->next != node) || (node->next->previous != node))
+		return (HEAP_BLOCK_BAD_LINKS);
+	if (node->parent && (node->parent != (HeapTreeNodePtr)&largeRoot) && (node->parent->child[0] != node) && (node->parent->child[1] != node))
+		return (HEAP_BLOCK_BAD_LINKS);
+	return (HEAP_BLOCK_OK);
+}
+
+//---------------------------------------------------------------------------
+HeapBlockPtr
+SizeClassHeap::allocBlock(size_t blockSize)
+{
+	HeapBlockPtr block = nullptr;
+	size_t sizeClass = blockSize / HEAP_GRANULE;
+	if (sizeClass < HEAP_SMALL_CLASSES)
+	{
+		uint64_t mask = smallMask >> sizeClass;
+		if (mask)
+			block = smallLists[sizeClass + lowestBit(mask)];
+	}
+	if (!block)
+	{
+		block = (HeapBlockPtr)findTree(blockSize);
+		if (!block)
+		{
+			stats.numFailedMallocs++;
+			return (nullptr);
+		}
+		stats.numTreeMallocs++;
+	}
+	unlinkFree(block);
+	//---------------------------------------------
+	// Split off the rest if it makes a block.
+	size_t rest = block->blockSize - blockSize;
+	if (rest >= HEAP_MIN_BLOCK)
+	{
+		HeapBlockPtr restBlock = (HeapBlockPtr)((uint8_t*)block + blockSize);
+		restBlock->blockSize = rest;
+		restBlock->upperBlock = block;
+		((HeapBlockPtr)((uint8_t*)restBlock + rest))->upperBlock = restBlock;
+		block->blockSize = blockSize;
+		linkFree(restBlock);
+	}
+	block->blockSize |= 1;
+	stats.numMallocs++;
+	stats.blocksInUse++;
+	stats.bytesInUse += (uint32_t)(block->blockSize & ~1);
+	if (stats.bytesInUse > stats.peakBytesInUse)
+		stats.peakBytesInUse = stats.bytesInUse;
+	return (block);
+}
+
+//---------------------------------------------------------------------------
+void
+SizeClassHeap::freeBlock(HeapBlockPtr block)
+{
+	size_t blockSize = block->blockSize & ~1;
+	stats.blocksInUse--;
+	stats.bytesInUse -= (uint32_t)blockSize;
+	block->blockSize = blockSize;
+	//---------------------------------------
+	// merge with the block below if it's free
+	HeapBlockPtr lower = (HeapBlockPtr)((uint8_t*)block + blockSize);
+	if (!(lower->blockSize & 1))
+	{
+		unlinkFree(lower);
+		block->blockSize += lower->blockSize;
+	}
+	//---------------------------------------
+	// and into the block above if that is
+	HeapBlockPtr upper = block->upperBlock;
+	if (upper && !(upper->blockSize & 1))
+	{
+		unlinkFree(upper);
+		upper->blockSize += block->blockSize;
+		block = upper;
+	}
+	((HeapBlockPtr)((uint8_t*)block + block->blockSize))->upperBlock = block;
+	linkFree(block);
+}
+
+//---------------------------------------------------------------------------
+bool
+SizeClassHeap::isAllocatedBlock(HeapBlockPtr block)
+{
+	if ((block < heapStart) || (block >= heapEnd) || ((uintptr_t)block & (HEAP_GRANULE - 1)))
+		return (false);
+	size_t blockSize = block->blockSize;
+	if (!(blockSize & 1))
+		return (false);
+	HeapBlockPtr lower = (HeapBlockPtr)((uint8_t*)block + (blockSize & ~1));
+	return ((lower > block) && (lower <= heapEnd) && (lower->upperBlock == block));
+}
+
+//---------------------------------------------------------------------------
+void
+SizeClassHeap::linkFree(HeapBlockPtr block)
+{
+	stats.numFreeBlocks++;
+	stats.bytesFree += (uint32_t)block->blockSize;
+	if (block->blockSize >= HEAP_SMALL_LIMIT)
+	{
+		insertTree((HeapTreeNodePtr)block);
+		return;
+	}
+	size_t sizeClass = block->blockSize / HEAP_GRANULE;
+	block->previous = nullptr;
+	block->next = smallLists[sizeClass];
+	if (block->next)
+		block->next->previous = block;
+	smallLists[sizeClass] = block;
+	smallMask |= (uint64_t)1 << sizeClass;
+}
+
+//---------------------------------------------------------------------------
+void
+SizeClassHeap::unlinkFree(HeapBlockPtr block)
+{
+	stats.numFreeBlocks--;
+	stats.bytesFree -= (uint32_t)block->blockSize;
+	if (block->blockSize >= HEAP_SMALL_LIMIT)
+	{
+		removeTree((HeapTreeNodePtr)block);
+		return;
+	}
+	size_t sizeClass = block->blockSize / HEAP_GRANULE;
+	if (block->previous)
+		block->previous->next = block->next;
+	else
+		smallLists[sizeClass] = block->next;
+	if (block->next)
+		block->next->previous = block->previous;
+	if (!smallLists[sizeClass])
+		smallMask &= ~((uint64_t)1 << sizeClass);
+}
+
+//---------------------------------------------------------------------------
+// A node's children split on the next bit of size down from the bit its
+// parent split on; the node itself can be any size that matches its
+// parents' bits.  The root's parent is the root pointer itself, so only
+// ring members have none.
+void
+SizeClassHeap::insertTree(HeapTreeNodePtr node)
+{
+	uint32_t key = (uint32_t)node->blockSize;
+	node->child[0] = nullptr;
+	node->child[1] = nullptr;
+	if (!largeRoot)
+	{
+		largeRoot = node;
+		node->parent = (HeapTreeNodePtr)&largeRoot;
+		node->previous = node->next = node;
+		return;
+	}
+	HeapTreeNodePtr tree = largeRoot;
+	for (int32_t bit = 31;; bit--)
+	{
+		if (tree->blockSize == node->blockSize)
+		{
+			node->parent = nullptr;
+			node->previous = tree;
+			node->next = tree->next;
+			tree->next->previous = node;
+			tree->next = node;
+			return;
+		}
+		gosASSERT(bit >= 0);
+		HeapTreeNodePtr& child = tree->child[(key >> bit) & 1];
+		if (!child)
+		{
+			child = node;
+			node->parent = tree;
+			node->previous = node->next = node;
+			return;
+		}
+		tree = child;
+	}
+}
+
+//---------------------------------------------------------------------------
+void
+SizeClassHeap::removeTree(HeapTreeNodePtr node)
+{
+	HeapTreeNodePtr parent = node->parent;
+	HeapTreeNodePtr replacement = nullptr;
+	if (node->next != node)
+	{
+		//------------------------------------------
+		// Another block the same size takes over.
+		replacement = node->previous;
+		node->next->previous = replacement;
+		replacement->next = node->next;
+	}
+	else
+	{
+		//------------------------------------------
+		// Any leaf under us can, it fits our bits.
+		HeapTreeNodePtr* link = &node->child[1];
+		if ((replacement = *link) != nullptr || (replacement = *(link = &node->child[0])) != nullptr)
+		{
+			HeapTreeNodePtr* childLink;
+			while (*(childLink = &replacement->child[1]) != nullptr || *(childLink = &replacement->child[0]) != nullptr)
+				replacement = *(link = childLink);
+			*link = nullptr;
+		}
+	}
+	if (!parent)
+		return; // was only in a ring
+	if (node == largeRoot)
+		largeRoot = replacement;
+	else if (parent->child[0] == node)
+		parent->child[0] = replacement;
+	else
+		parent->child[1] = replacement;
+	if (replacement)
+	{
+		replacement->parent = parent;
+		for (size_t i = 0; i < 2; i++)
+		{
+			replacement->child[i] = node->child[i];
+			if (node->child[i])
+				node->child[i]->parent = replacement;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+HeapTreeNodePtr
+SizeClassHeap::findTree(size_t blockSize)
+{
+	HeapTreeNodePtr best = nullptr;
+	size_t bestRest = (size_t)-1;
+	HeapTreeNodePtr tree = largeRoot;
+	HeapTreeNodePtr biggerTree = nullptr;
+	uint32_t key = (uint32_t)blockSize;
+	//--------------------------------------------------------
+	// Walk down the path our size takes.  Each time it goes
+	// left, everything to the right is bigger; remember the
+	// last such subtree, the one with the least in it.
+	for (int32_t bit = 31; tree; bit--)
+	{
+		if (tree->blockSize >= blockSize)
+		{
+			size_t rest = tree->blockSize - blockSize;
+			if (rest < bestRest)
+			{
+				best = tree;
+				bestRest = rest;
+				if (!rest)
+					return (best);
+			}
+		}
+		HeapTreeNodePtr right = tree->child[1];
+		tree = tree->child[(key >> bit) & 1];
+		if (right && (right != tree))
+			biggerTree = right;
+		if (!tree)
+		{
+			tree = biggerTree;
+			break;
+		}
+	}
+	//--------------------------------------------------------
+	// The smallest block in a subtree is on the path that goes
+	// left whenever it can.
+	for (; tree; tree = tree->child[0] ? tree->child[0] : tree->child[1])
+	{
+		if ((tree->blockSize >= blockSize) && ((tree->blockSize - blockSize) < bestRest))
+		{
+			best = tree;
+			bestRest = tree->blockSize - blockSize;
+		}
+	}
+	return (best);
+}
+
+//---------------------------------------------------------------------------
+void
+SizeClassHeap::flushCache(ThreadCache& cache, uint32_t keep)
+{
+	for (size_t i = 0; i < HEAP_CACHED_CLASSES; i++)
+	{
+		while (cache.counts[i] > keep)
+		{
+			HeapBlockPtr block = cache.lists[i];
+			cache.lists[i] = block->next;
+			cache.counts[i]--;
+			cache.blocksCached.fetch_sub(1, std::memory_order_relaxed);
+			cache.bytesCached.fetch_sub((uint32_t)(block->blockSize & ~1), std::memory_order_relaxed);
+			freeBlock(block);
+		}
+	}
+}
@@ -0,0 +1,188 @@
+//---------------------------------------------------------------------------
+//
+// SizeHeap.h -- Size class block allocator behind the User Heaps
+//
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#pragma once
+
+#ifndef SIZEHEAP_H
+#define SIZEHEAP_H
+
+//---------------------------------------------------------------------------
+// Include Files
+
+#include <atomic>
+#include <mutex>
+
+//---------------------------------------------------------------------------
+// Carves up one block of memory the way the User Heaps always have: every
+// block starts with its size (low bit set while it is allocated) and a
+// pointer to the block above it, so a freed block merges straight back
+// into free neighbours on either side.
+//
+// Free blocks under HEAP_SMALL_LIMIT sit on exact size lists, one list per
+// HEAP_GRANULE of size, with a bit per list saying which are not empty.  A
+// request takes the first list at or above its size and splits off what
+// is left over.  Bigger free blocks sit in a tree keyed on their size a bit
+// at a time from the top, which a request walks once to find the smallest
+// block that fits.  Neither search gets slower as the heap fragments.
+//
+// With thread caches on, each thread keeps a few freed small blocks of
+// every size for itself and everything else takes the heap's lock.  With
+// them off (the default) the heap belongs to one thread at a time and
+// never locks.
+
+#define HEAP_GRANULE (2 * sizeof(size_t))
+#define HEAP_HEADER_SIZE (2 * sizeof(size_t)) // blockSize and upperBlock
+#define HEAP_SMALL_CLASSES 64
+#define HEAP_SMALL_LIMIT (HEAP_SMALL_CLASSES * HEAP_GRANULE)
+#define HEAP_CACHED_CLASSES 32 // sizes the thread caches keep
+#define HEAP_CACHE_DEPTH 16 // blocks of each size a thread keeps
+#define MAX_HEAP_THREADS 8 // threads past this always lock
+#define MAX_SIZE_HEAP 0xfffffff0 // tree keys are 32 bits
+
+struct HeapBlock;
+typedef HeapBlock* HeapBlockPtr;
+struct HeapTreeNode;
+typedef HeapTreeNode* HeapTreeNodePtr;
+
+//---------------------------------------------------------------------------
+// An allocated block is only the first two fields.  A free one links
+// into its size list through the other two.
+typedef struct HeapBlock
+{
+	size_t blockSize;
+	HeapBlockPtr upperBlock;
+	HeapBlockPtr previous;
+	HeapBlockPtr next;
+} HeapBlock;
+
+#define HEAP_MIN_BLOCK sizeof(HeapBlock)
+
+//---------------------------------------------------------------------------
+// A free block too big for the size lists.  Blocks the same size as one
+// already in the tree hang off it in a ring, with no parent.
+typedef struct HeapTreeNode
+{
+	size_t blockSize;
+	HeapBlockPtr upperBlock;
+	HeapTreeNodePtr previous; // same size ring
+	HeapTreeNodePtr next;
+	HeapTreeNodePtr child[2];
+	HeapTreeNodePtr parent;
+} HeapTreeNode;
+
+enum _heap_block_check : int32_t
+{
+	HEAP_BLOCK_OK,
+	HEAP_BLOCK_BAD_UPPER, // block above doesn't end where this one starts
+	HEAP_BLOCK_BAD_LOWER, // block below doesn't point back at this one
+	HEAP_BLOCK_BAD_LINKS // free block isn't linked in properly
+};
+
+typedef struct _HeapStats
+{
+	uint32_t numMallocs;
+	uint32_t numFrees;
+	uint32_t numFailedMallocs;
+	uint32_t numCacheHits; // mallocs a thread cache answered
+	uint32_t numTreeMallocs; // mallocs that went to the large block tree
+	uint32_t blocksInUse;
+	uint32_t bytesInUse; // block bytes, headers included
+	uint32_t peakBytesInUse;
+	uint32_t numFreeBlocks; // cached blocks included
+	uint32_t bytesFree;
+} HeapStats;
+
+//---------------------------------------------------------------------------
+// Heap traces: "MC2HEAPT", the version, then records.  A HEAP_TRACE_HEAP
+// record is followed by HEAP_TRACE_NAME_LENGTH bytes of heap name.
+#define HEAP_TRACE_VERSION 1
+#define HEAP_TRACE_NAME_LENGTH 32
+
+enum _heap_trace_op : uint16_t
+{
+	HEAP_TRACE_HEAP, // size is the heap's size
+	HEAP_TRACE_MALLOC, // id is the allocation's number
+	HEAP_TRACE_FREE
+};
+
+typedef struct _HeapTraceRecord
+{
+	uint16_t op;
+	uint16_t heap;
+	uint32_t id;
+	uint32_t size;
+} HeapTraceRecord;
+
+//---------------------------------------------------------------------------
+class SizeClassHeap
+{
+protected:
+	typedef struct _ThreadCache
+	{
+		HeapBlockPtr lists[HEAP_CACHED_CLASSES];
+		uint32_t counts[HEAP_CACHED_CLASSES];
+		std::atomic<uint32_t> numMallocs;
+		std::atomic<uint32_t> numFrees;
+		std::atomic<uint32_t> blocksCached;
+		std::atomic<uint32_t> bytesCached;
+	} ThreadCache;
+
+	uint8_t* memory;
+	size_t memorySize;
+	HeapBlockPtr heapStart;
+	HeapBlockPtr heapEnd; // allocated, zero sized block marking the end
+	HeapBlockPtr smallLists[HEAP_SMALL_CLASSES];
+	uint64_t smallMask; // a bit per list that isn't empty
+	HeapTreeNodePtr largeRoot;
+	HeapStats stats; // everything but the thread caches
+	bool threadCaches;
+	std::mutex heapLock;
+	ThreadCache caches[MAX_HEAP_THREADS];
+
+public:
+	SizeClassHeap(void);
+	~SizeClassHeap(void) { destroy(); }
+
+	bool init(PVOID heapMemory, size_t heapSize);
+	void destroy(void);
+
+	PVOID Malloc(size_t memSize);
+	bool Free(PVOID memBlock);
+
+	size_t totalFree(void);
+	size_t largestFree(void);
+	HeapStats getStatistics(void);
+
+	void setThreadCaches(bool useCaches);
+	bool getThreadCaches(void) { return threadCaches; }
+	void flushThreadCache(void);
+
+	HeapBlockPtr firstBlock(void) { return heapStart; }
+	HeapBlockPtr nextBlock(HeapBlockPtr block)
+	{
+		HeapBlockPtr lower = (HeapBlockPtr)((uint8_t*)block + (block->blockSize & ~1));
+		return ((lower == heapEnd) ? nullptr : lower);
+	}
+	int32_t checkBlock(HeapBlockPtr block);
+
+	static bool TestClass(void);
+
+protected:
+	HeapBlockPtr allocBlock(size_t blockSize);
+	void freeBlock(HeapBlockPtr block);
+	bool isAllocatedBlock(HeapBlockPtr block);
+	void linkFree(HeapBlockPtr block);
+	void unlinkFree(HeapBlockPtr block);
+	void insertTree(HeapTreeNodePtr node);
+	void removeTree(HeapTreeNodePtr node);
+	HeapTreeNodePtr findTree(size_t blockSize);
+	void flushCache(ThreadCache& cache, uint32_t keep);
+};
+
+//---------------------------------------------------------------------------
+#endif
@@ -0,0 +1,161 @@
+//===========================================================================//
+// File:	sizeheap_test.cpp                                                //
+// Contents: test function for the size class heap                           //
+//---------------------------------------------------------------------------//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+#include "stdinc.h"
+#include "sizeheap.h"
+
+#include <thread>
+
+#define SIZE_HEAP_TEST_SIZE (4 * 1024 * 1024)
+#define SIZE_HEAP_TEST_BLOCKS 2000
+#define SIZE_HEAP_TEST_THREADS 4
+
+//---------------------------------------------------------------------------
+// Walks every block from the bottom of the heap and checks its links, and
+// that the walk covers what the stats say is used and free.  What's free
+// to hand out is that less a header a block.
+
+static bool
+SizeHeapTestWalk(SizeClassHeap& heap)
+{
+	HeapStats stats = heap.getStatistics();
+	size_t bytesUsed = 0;
+	size_t bytesFree = 0;
+	for (HeapBlockPtr block = heap.firstBlock(); block; block = heap.nextBlock(block))
+	{
+		Test_Assumption(heap.checkBlock(block) == HEAP_BLOCK_OK);
+		if (block->blockSize & 1)
+			bytesUsed += block->blockSize & ~1;
+		else
+			bytesFree += block->blockSize;
+	}
+	Test_Assumption(bytesUsed + bytesFree == stats.bytesInUse + stats.bytesFree);
+	Test_Assumption(heap.totalFree() == stats.bytesFree - (stats.numFreeBlocks * HEAP_HEADER_SIZE));
+	return true;
+}
+
+//---------------------------------------------------------------------------
+
+bool
+SizeClassHeap::TestClass(void)
+{
+	SPEW((GROUP_STUFF_TEST, "Starting SizeClassHeap test..."));
+	std::vector<uint8_t> memory(SIZE_HEAP_TEST_SIZE);
+	SizeClassHeap heap;
+	Test_Assumption(!heap.init(memory.data(), HEAP_MIN_BLOCK));
+	Test_Assumption(heap.init(memory.data(), SIZE_HEAP_TEST_SIZE));
+	size_t emptyFree = heap.totalFree();
+	Test_Assumption(emptyFree == heap.largestFree());
+	Test_Assumption(emptyFree > SIZE_HEAP_TEST_SIZE - (4 * HEAP_GRANULE));
+	uint32_t seed = 12345;
+	auto nextRandom = [&seed]() {
+		seed = seed * 1103515245 + 12345;
+		return ((seed >> 16) & 0x7fff);
+	};
+	//-----------------------------------------------------------
+	// Small blocks from every size list and big ones for the tree,
+	// each filled so an overlap shows up as a bad block...
+	std::vector<uint8_t*> blocks(SIZE_HEAP_TEST_BLOCKS);
+	std::vector<size_t> sizes(SIZE_HEAP_TEST_BLOCKS);
+	size_t i;
+	for (i = 0; i < SIZE_HEAP_TEST_BLOCKS; i++)
+	{
+		sizes[i] = (i & 7) ? (1 + (nextRandom() % HEAP_SMALL_LIMIT)) : (HEAP_SMALL_LIMIT + (nextRandom() % 4000));
+		blocks[i] = (uint8_t*)heap.Malloc(sizes[i]);
+		Test_Assumption(blocks[i] != nullptr);
+		Test_Assumption(((uintptr_t)blocks[i] & (HEAP_GRANULE - 1)) == 0);
+		memset(blocks[i], (int32_t)(i & 0xff), sizes[i]);
+	}
+	Test_Assumption(heap.getStatistics().blocksInUse == SIZE_HEAP_TEST_BLOCKS);
+	Test_Assumption(heap.getStatistics().numTreeMallocs > 0);
+	Test_Assumption(SizeHeapTestWalk(heap));
+	//------------------------------------------------------------
+	// Free every other one, then fill the holes back up, which has
+	// to come out of the size lists and the tree without touching
+	// the blocks still held...
+	for (i = 0; i < SIZE_HEAP_TEST_BLOCKS; i += 2)
+	{
+		Test_Assumption(heap.Free(blocks[i]));
+		blocks[i] = nullptr;
+	}
+	Test_Assumption(SizeHeapTestWalk(heap));
+	for (i = 0; i < SIZE_HEAP_TEST_BLOCKS; i += 2)
+	{
+		sizes[i] = 1 + (nextRandom() % (HEAP_SMALL_LIMIT * 2));
+		blocks[i] = (uint8_t*)heap.Malloc(sizes[i]);
+		Test_Assumption(blocks[i] != nullptr);
+		memset(blocks[i], (int32_t)(i & 0xff), sizes[i]);
+	}
+	for (i = 0; i < SIZE_HEAP_TEST_BLOCKS; i++)
+		for (size_t j = 0; j < sizes[i]; j++)
+			Test_Assumption(blocks[i][j] == (uint8_t)(i & 0xff));
+	Test_Assumption(SizeHeapTestWalk(heap));
+	//------------------------------------------------------------
+	// Freeing something twice, or something that was never handed
+	// out, is caught, and asking for too much fails cleanly...
+	uint8_t* freed = blocks[1];
+	Test_Assumption(heap.Free(freed));
+	Test_Assumption(!heap.Free(freed));
+	Test_Assumption(!heap.Free(blocks[2] + HEAP_GRANULE));
+	blocks[1] = nullptr;
+	uint32_t numFailedMallocs = heap.getStatistics().numFailedMallocs;
+	Test_Assumption(heap.Malloc(SIZE_HEAP_TEST_SIZE) == nullptr);
+	Test_Assumption(heap.Malloc(0) == nullptr);
+	Test_Assumption(heap.getStatistics().numFailedMallocs == numFailedMallocs + 2);
+	//--------------------------------------------------------
+	// Everything freed in a shuffled order merges back into
+	// the one block the heap started with.
+	for (i = SIZE_HEAP_TEST_BLOCKS - 1; i > 0; i--)
+		std::swap(blocks[i], blocks[nextRandom() % (i + 1)]);
+	for (i = 0; i < SIZE_HEAP_TEST_BLOCKS; i++)
+		if (blocks[i])
+			Test_Assumption(heap.Free(blocks[i]));
+	Test_Assumption(heap.getStatistics().blocksInUse == 0);
+	Test_Assumption(heap.totalFree() == emptyFree);
+	Test_Assumption(heap.largestFree() == emptyFree);
+	//------------------------------------------------------------
+	// With thread caches on, threads allocating and freeing at once
+	// keep each other's blocks intact, and once the caches are given
+	// back the heap is one free block again.
+	heap.setThreadCaches(true);
+	bool threadsPassed[SIZE_HEAP_TEST_THREADS];
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < SIZE_HEAP_TEST_THREADS; t++)
+	{
+		threads.emplace_back([&heap, &threadsPassed, t]() {
+			uint8_t* held[64] = {nullptr};
+			bool passed = true;
+			for (size_t n = 0; n < 20000; n++)
+			{
+				size_t slot = (n * 7 + t) & 63;
+				if (held[slot])
+				{
+					passed = passed && (held[slot][0] == (uint8_t)t) && heap.Free(held[slot]);
+					held[slot] = nullptr;
+				}
+				else if ((held[slot] = (uint8_t*)heap.Malloc(8 + ((n + t) % 300))) != nullptr)
+					held[slot][0] = (uint8_t)t;
+			}
+			for (size_t slot = 0; slot < 64; slot++)
+				if (held[slot])
+					passed = passed && heap.Free(held[slot]);
+			heap.flushThreadCache();
+			threadsPassed[t] = passed;
+		});
+	}
+	for (size_t t = 0; t < SIZE_HEAP_TEST_THREADS; t++)
+		threads[t].join();
+	for (size_t t = 0; t < SIZE_HEAP_TEST_THREADS; t++)
+		Test_Assumption(threadsPassed[t]);
+	Test_Assumption(heap.getStatistics().numCacheHits > 0);
+	heap.setThreadCaches(false);
+	Test_Assumption(heap.getStatistics().blocksInUse == 0);
+	Test_Assumption(heap.largestFree() == emptyFree);
+	Test_Assumption(SizeHeapTestWalk(heap));
+	heap.destroy();
+	return true;
+}
@@ -92,13 +92,21 @@ ascendingCompare(PCVOID arg1, PCVOID arg2)
 
 void
 SortList::sort(bool descendingOrder)
+{
+	sortNodes(list, numItems, descendingOrder);
+}
+
+//---------------------------------------------------------------------------
+
+void
+SortList::sortNodes(SortListNode* nodes, uint32_t numNodes, bool descendingOrder)
 {
 	//------------------------------------------------------------------
 	// For now, just use ANSI C's built-in qsort (ugly, but functional).
 	if (descendingOrder)
-		qsort((PVOID)list, (size_t)numItems, sizeof(SortListNode), descendingCompare);
+		qsort((PVOID)nodes, (size_t)numNodes, sizeof(SortListNode), descendingCompare);
 	else
-		qsort((PVOID)list, (size_t)numItems, sizeof(SortListNode), ascendingCompare);
+		qsort((PVOID)nodes, (size_t)numNodes, sizeof(SortListNode), ascendingCompare);
 }
 
 //---------------------------------------------------------------------------
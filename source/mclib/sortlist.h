@@ -66,6 +66,11 @@ public:
 
 	void sort(bool descendingOrder = true);
 
+	//-------------------------------------------------------------
+	// Sorts nodes the caller owns, so code that can run on several
+	// threads at once needn't share a list.
+	static void sortNodes(SortListNode* nodes, uint32_t numNodes, bool descendingOrder = true);
+
 	void destroy(void);
 
 	~SortList(void) { destroy(void); }
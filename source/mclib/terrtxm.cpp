@@ -979,7 +979,8 @@ TerrainTextures::createTransition(uint32_t typeInfo, uint32_t overlayInfo)
 				if (result != (int32_t)fileSize)
 					STOP(("Read Error with Texture %s", testPath));
 				uint8_t* lzBuffer = (uint8_t*)malloc(mipSize * mipSize * sizeof(uint32_t));
-				int32_t bufferSize = LZDecomp(lzBuffer, fileRAM, fileSize);
+				int32_t bufferSize =
+					LZDecomp(lzBuffer, mipSize * mipSize * sizeof(uint32_t), fileRAM, fileSize);
 				if (bufferSize != (int32_t)(mipSize * mipSize * sizeof(uint32_t)))
 					STOP(("Texture not correct size!"));
 				txmFile.close();
@@ -9,6 +9,10 @@
 //===========================================================================//
 #include "stdinc.h"
 
+#ifndef FRAMEARENA_H
+#include "framearena.h"
+#endif
+
 //#include "tgl.h"
 //#include "clip.h"
 //#include "timing.h"
@@ -49,12 +53,6 @@ UserHeapPtr TG_Shape::tglHeap = nullptr;
 
 uint32_t TG_Shape::lighteningLevel = 0;
 
-TG_VertexPool* colorPool = nullptr;
-TG_GOSVertexPool* vertexPool = nullptr;
-TG_DWORDPool* facePool = nullptr;
-TG_ShadowPool* shadowPool = nullptr;
-TG_TrianglePool* trianglePool = nullptr;
-
 //-------------------------------------------------------------------------------
 extern bool useVertexLighting;
 extern bool useFaceLighting;
@@ -134,7 +132,7 @@ GetNameData(const std::wstring_view& rawData, const std::wstring_view& result)
 //-------------------------------------------------------------------------------
 PVOIDTG_TypeNode::operator new(size_t mySize)
 {
-	PVOID result = TG_Shape::tglHeap->Malloc(mySize);
+	PVOID result = TG_Shape::tglHeap->Malloc(mySize, HEAP_CALLER());
 	return result;
 }
 
@@ -1201,7 +1199,7 @@ TG_TypeShape::SetTextureAlpha(uint32_t textureNum, bool alphaFlag)
 // TG_Shape
 PVOIDTG_Shape::operator new(size_t mySize)
 {
-	PVOID result = TG_Shape::tglHeap->Malloc(mySize);
+	PVOID result = TG_Shape::tglHeap->Malloc(mySize, HEAP_CALLER());
 	return result;
 }
 
@@ -1329,13 +1327,14 @@ TG_Shape::MultiTransformShape(Stuff::Matrix4D* shapeToClip, Stuff::Point3D* back
 	}
 	TG_TypeShapePtr theShape = (TG_TypeShapePtr)myType;
 	// At this point, we know we are going to process this shape,
-	// Get memory for its components from the pools!
-	listOfVertices = vertexPool->getVerticesFromPool(numVertices);
-	listOfcolours = colorPool->getcoloursFromPool(numVertices);
-	listOfShadowTVertices = shadowPool->getShadowsFromPool(numVertices);
-	listOfTriangles = trianglePool->getTrianglesFromPool(numTriangles);
-	listOfVisibleFaces = facePool->getFacesFromPool(numTriangles);
-	listOfVisibleShadows = facePool->getFacesFromPool(numTriangles);
+	// Get memory for its components from this frame's arena!
+	listOfVertices = (gos_VERTEX*)frameArena->Malloc(sizeof(gos_VERTEX) * numVertices);
+	listOfcolours = (TG_VertexPtr)frameArena->Malloc(sizeof(TG_Vertex) * numVertices);
+	listOfShadowTVertices =
+		(TG_ShadowVertexTempPtr)frameArena->Malloc(sizeof(TG_ShadowVertexTemp) * numVertices);
+	listOfTriangles = (TG_TrianglePtr)frameArena->Malloc(sizeof(TG_Triangle) * numTriangles);
+	listOfVisibleFaces = (DWORDPtr)frameArena->Malloc(sizeof(uint32_t) * numTriangles);
+	listOfVisibleShadows = (DWORDPtr)frameArena->Malloc(sizeof(uint32_t) * numTriangles);
 	if (!listOfVertices || !listOfcolours || !listOfShadowTVertices || !listOfTriangles || !listOfVisibleFaces || !listOfVisibleShadows)
 		return (1);
 	lastTurnTransformed = turn;
@@ -748,281 +748,6 @@ public:
 
 typedef TG_Shape* TG_ShapePtr;
 
-// Pools are defined here.
-
-class TG_VertexPool
-{
-protected:
-	TG_Vertex* tgVertexPool;
-	TG_Vertex* nextVertex;
-
-	uint32_t totalVertices;
-	uint32_t numVertices;
-
-public:
-	TG_VertexPool(void)
-	{
-		tgVertexPool = nextVertex = nullptr;
-		totalVertices = numVertices = 0;
-	}
-
-	~TG_VertexPool(void) { destroy(void); }
-
-	void destroy(void)
-	{
-		TG_Shape::tglHeap->Free(tgVertexPool);
-		tgVertexPool = nextVertex = nullptr;
-		totalVertices = numVertices = 0;
-	}
-
-	void init(uint32_t maxVertices)
-	{
-		tgVertexPool = (TG_VertexPtr)TG_Shape::tglHeap->Malloc(sizeof(TG_Vertex) * maxVertices);
-		gosASSERT(tgVertexPool != nullptr);
-		nextVertex = tgVertexPool;
-		totalVertices = maxVertices;
-		numVertices = 0;
-	}
-
-	void reset(void)
-	{
-		nextVertex = tgVertexPool;
-		numVertices = 0;
-	}
-
-	TG_VertexPtr getcoloursFromPool(uint32_t numRequested)
-	{
-		TG_VertexPtr result = nullptr;
-		numVertices += numRequested;
-		if (numVertices < totalVertices)
-		{
-			result = nextVertex;
-			nextVertex += numRequested;
-		}
-		return result;
-	}
-};
-
-class TG_GOSVertexPool
-{
-protected:
-	gos_VERTEX* gVertexPool;
-	gos_VERTEX* nextVertex;
-
-	uint32_t totalVertices;
-	uint32_t numVertices;
-
-public:
-	TG_GOSVertexPool(void)
-	{
-		gVertexPool = nextVertex = nullptr;
-		totalVertices = numVertices = 0;
-	}
-
-	~TG_GOSVertexPool(void) { destroy(void); }
-
-	void destroy(void)
-	{
-		TG_Shape::tglHeap->Free(gVertexPool);
-		gVertexPool = nextVertex = nullptr;
-		totalVertices = numVertices = 0;
-	}
-
-	void init(uint32_t maxVertices)
-	{
-		gVertexPool = (gos_VERTEX*)TG_Shape::tglHeap->Malloc(sizeof(gos_VERTEX) * maxVertices);
-		gosASSERT(gVertexPool != nullptr);
-		nextVertex = gVertexPool;
-		totalVertices = maxVertices;
-		numVertices = 0;
-	}
-
-	void reset(void)
-	{
-		nextVertex = gVertexPool;
-		numVertices = 0;
-	}
-
-	gos_VERTEX* getVerticesFromPool(uint32_t numRequested)
-	{
-		gos_VERTEX* result = nullptr;
-		numVertices += numRequested;
-		if (numVertices < totalVertices)
-		{
-			result = nextVertex;
-			nextVertex += numRequested;
-		}
-		return result;
-	}
-};
-
-class TG_TrianglePool
-{
-protected:
-	TG_Triangle* trianglePool;
-	TG_Triangle* nextTriangle;
-
-	uint32_t totalTriangles;
-	uint32_t numTriangles;
-
-public:
-	TG_TrianglePool(void)
-	{
-		trianglePool = nextTriangle = nullptr;
-		totalTriangles = numTriangles = 0;
-	}
-
-	~TG_TrianglePool(void) { destroy(void); }
-
-	void destroy(void)
-	{
-		TG_Shape::tglHeap->Free(trianglePool);
-		trianglePool = nextTriangle = nullptr;
-		totalTriangles = numTriangles = 0;
-	}
-
-	void init(uint32_t maxTriangles)
-	{
-		trianglePool = (TG_Triangle*)TG_Shape::tglHeap->Malloc(sizeof(TG_Triangle) * maxTriangles);
-		gosASSERT(trianglePool != nullptr);
-		nextTriangle = trianglePool;
-		totalTriangles = maxTriangles;
-		numTriangles = 0;
-	}
-
-	void reset(void)
-	{
-		nextTriangle = trianglePool;
-		numTriangles = 0;
-	}
-
-	TG_Triangle* getTrianglesFromPool(uint32_t numRequested)
-	{
-		TG_Triangle* result = nullptr;
-		numTriangles += numRequested;
-		if (numTriangles < totalTriangles)
-		{
-			result = nextTriangle;
-			nextTriangle += numRequested;
-		}
-		return result;
-	}
-};
-
-class TG_ShadowPool
-{
-protected:
-	TG_ShadowVertexTemp* tVertexPool;
-	TG_ShadowVertexTemp* nextVertex;
-
-	uint32_t totalVertices;
-	uint32_t numVertices;
-
-public:
-	TG_ShadowPool(void)
-	{
-		tVertexPool = nextVertex = nullptr;
-		totalVertices = numVertices = 0;
-	}
-
-	~TG_ShadowPool(void) { destroy(void); }
-
-	void destroy(void)
-	{
-		TG_Shape::tglHeap->Free(tVertexPool);
-		tVertexPool = nextVertex = nullptr;
-		totalVertices = numVertices = 0;
-	}
-
-	void init(uint32_t maxVertices)
-	{
-		tVertexPool = (TG_ShadowVertexTempPtr)TG_Shape::tglHeap->Malloc(
-			sizeof(TG_ShadowVertexTemp) * maxVertices);
-		gosASSERT(tVertexPool != nullptr);
-		nextVertex = tVertexPool;
-		totalVertices = maxVertices;
-		numVertices = 0;
-	}
-
-	void reset(void)
-	{
-		nextVertex = tVertexPool;
-		numVertices = 0;
-	}
-
-	TG_ShadowVertexTempPtr getShadowsFromPool(uint32_t numRequested)
-	{
-		TG_ShadowVertexTempPtr result = nullptr;
-		numVertices += numRequested;
-		if (numVertices < totalVertices)
-		{
-			result = nextVertex;
-			nextVertex += numRequested;
-		}
-		return result;
-	}
-};
-
-class TG_DWORDPool
-{
-protected:
-	uint32_t* triPool;
-	uint32_t* nextTri;
-
-	uint32_t totalTriangles;
-	uint32_t numTriangles;
-
-public:
-	TG_DWORDPool(void)
-	{
-		triPool = nextTri = nullptr;
-		totalTriangles = numTriangles = 0;
-	}
-
-	~TG_DWORDPool(void) { destroy(void); }
-
-	void destroy(void)
-	{
-		TG_Shape::tglHeap->Free(triPool);
-		triPool = nextTri = nullptr;
-		totalTriangles = numTriangles = 0;
-	}
-
-	void init(uint32_t maxTriangles)
-	{
-		triPool = (uint32_t*)TG_Shape::tglHeap->Malloc(sizeof(uint32_t) * maxTriangles);
-		gosASSERT(triPool != nullptr);
-		nextTri = triPool;
-		totalTriangles = maxTriangles;
-		numTriangles = 0;
-	}
-
-	void reset(void)
-	{
-		nextTri = triPool;
-		numTriangles = 0;
-	}
-
-	uint32_t* getFacesFromPool(uint32_t numRequested)
-	{
-		uint32_t* result = nullptr;
-		numTriangles += numRequested;
-		if (numTriangles < totalTriangles)
-		{
-			result = nextTri;
-			nextTri += numRequested;
-		}
-		return result;
-	}
-};
-
-//-------------------------------------------------------------------------------
-extern TG_VertexPool* colorPool;
-extern TG_GOSVertexPool* vertexPool;
-extern TG_DWORDPool* facePool;
-extern TG_ShadowPool* shadowPool;
-extern TG_TrianglePool* trianglePool;
-
 //-------------------------------------------------------------------------------
 // ASE File Parse string Macros
 #define ASE_HEADER "*3DSMAX_ASCIIEXPORT\t200"
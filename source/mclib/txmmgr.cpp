@@ -29,7 +29,6 @@
 //---------------------------------------------------------------------------
 // static globals
 MC_TextureManager* mcTextureManager = nullptr;
-gos_VERTEXManager* MC_TextureManager::gvManager = nullptr;
 uint8_t* MC_TextureManager::lzBuffer1 = nullptr;
 uint8_t* MC_TextureManager::lzBuffer2 = nullptr;
 int32_t MC_TextureManager::iBufferRefCount = 0;
@@ -42,33 +41,6 @@ uint32_t compressedTextureSize = 0;
 
 #define MAX_SENDDOWN 10002
 
-//------------------------------------------------------
-// Frees up gos_VERTEX manager memory
-void
-MC_TextureManager::freeVertices(void)
-{
-	if (gvManager)
-	{
-		gvManager->destroy();
-		delete gvManager;
-		gvManager = nullptr;
-	}
-}
-
-//------------------------------------------------------
-// Creates gos_VERTEX Manager and allocates RAM.  Will not allocate if already
-// done!
-void
-MC_TextureManager::startVertices(int32_t maxVertices)
-{
-	if (gvManager == nullptr)
-	{
-		gvManager = new gos_VERTEXManager;
-		gvManager->init(maxVertices);
-		gvManager->reset();
-	}
-}
-
 //----------------------------------------------------------------------
 // Class MC_TextureManager
 void
@@ -1197,7 +1169,7 @@ MC_TextureManager::saveTexture(uint32_t textureIndex, const std::wstring_view& t
 		{
 			//------------------------------------------
 			// Badboys are now LZ Compressed in texture cache.
-			size_t origSize = LZDecomp(MC_TextureManager::lzBuffer2,
+			size_t origSize = LZDecomp(MC_TextureManager::lzBuffer2, MAX_LZ_BUFFER_SIZE,
 				(uint8_t*)masterTextureNodes[textureIndex].textureData,
 				masterTextureNodes[textureIndex].lzCompSize);
 			if (origSize != (masterTextureNodes[textureIndex].width & 0x0fffffff))
@@ -1264,7 +1236,7 @@ MC_TextureNode::get_gosTextureHandle(void) // If texture is not in
 			// Badboys are now LZ Compressed in texture cache.
 			// Uncompress, then memcpy.
 			size_t origSize =
-				LZDecomp(MC_TextureManager::lzBuffer2, (uint8_t*)textureData, lzCompSize);
+				LZDecomp(MC_TextureManager::lzBuffer2, MAX_LZ_BUFFER_SIZE, (uint8_t*)textureData, lzCompSize);
 			if (origSize != (width & 0x0fffffff))
 				STOP(("Decompressed to different size from original!  Txm:%s  "
 					  "width:%d  DecompSize:%d",
@@ -1289,7 +1261,7 @@ MC_TextureNode::get_gosTextureHandle(void) // If texture is not in
 			// Create a block of cache memory to hold this texture.
 			uint32_t txmSize = pTextureData.height * pTextureData.height * sizeof(uint32_t);
 			gosASSERT(textureData);
-			LZDecomp(MC_TextureManager::lzBuffer2, (uint8_t*)textureData, lzCompSize);
+			LZDecomp(MC_TextureManager::lzBuffer2, MAX_LZ_BUFFER_SIZE, (uint8_t*)textureData, lzCompSize);
 			memcpy(pTextureData.pTexture, MC_TextureManager::lzBuffer2, txmSize);
 			//------------------------
 			// Unlock the texture
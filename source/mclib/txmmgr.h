@@ -29,6 +29,10 @@
 #include "heap.h"
 #endif
 
+#ifndef FRAMEARENA_H
+#include "framearena.h"
+#endif
+
 #include <string.h>
 //#include "gameos.hpp"
 //----------------------------------------------------------------------
@@ -158,58 +162,6 @@ public:
 
 } MC_TextureNode;
 
-//---------------------------------------------------------------------------
-class gos_VERTEXManager : public HeapManager
-{
-	// Data Members
-	//-------------
-protected:
-	int32_t totalVertices; // Total number of vertices in pool.
-	int32_t currentVertex; // Pointer to next available vertex in pool.
-
-	// Member Functions
-	//-----------------
-public:
-	void init(void)
-	{
-		HeapManager::init(void);
-		totalVertices = 0;
-		currentVertex = 0;
-	}
-
-	gos_VERTEXManager(void) :
-		HeapManager() { init(void); }
-
-	void destroy(void)
-	{
-		HeapManager::destroy(void);
-		reset(void);
-		totalVertices = 0;
-	}
-
-	~gos_VERTEXManager(void) { destroy(void); }
-
-	void init(int32_t maxVertices)
-	{
-		totalVertices = maxVertices;
-		uint32_t heapSize = totalVertices * sizeof(gos_VERTEX);
-		createHeap(heapSize);
-		commitHeap(void);
-		reset(void);
-	}
-
-	gos_VERTEX* getVertexBlock(uint32_t numVertices)
-	{
-		gos_VERTEX* start = (gos_VERTEX*)getHeapPtr(void);
-		start = &(start[currentVertex]);
-		currentVertex += numVertices;
-		gosASSERT(currentVertex < totalVertices);
-		return start;
-	}
-
-	void reset(void) { currentVertex = 0; }
-};
-
 //----------------------------------------------------------------------
 class MC_TextureManager
 {
@@ -231,8 +183,8 @@ protected:
 		// so no dupes.
 	bool textureManagerInstrumented; // Texture Manager Instrumented.
 	int32_t totalCacheMisses; //NUmber of times flush has been called.\
+	uint32_t numDroppedTriangles; // No vertex block for them this frame.
 
-	static gos_VERTEXManager* gvManager; // Stores arrays of vertices for draw.
 	static uint8_t* lzBuffer1; // Used to compress/decompress textures from cache.
 	static uint8_t* lzBuffer2; // Used to compress/decompress textures from cache.
 	/* iBufferRefCount is used to help determine if lzBuffer1&2 are valid. The
@@ -261,6 +213,7 @@ public:
 		textureStringHeap = nullptr;
 		textureManagerInstrumented = false;
 		totalCacheMisses = 0;
+		numDroppedTriangles = 0;
 		currentUsedTextures = 0;
 		indexArray = nullptr;
 		masterVertexNodes = nullptr;
@@ -313,15 +266,6 @@ public:
 	// Tosses ALL of the textureNodes and frees GOS Handles
 	void flush(bool justTextures = false);
 
-	//------------------------------------------------------
-	// Frees up gos_VERTEX manager memory
-	void freeVertices(void);
-
-	//------------------------------------------------------
-	// Creates gos_VERTEX Manager and allocates RAM.  Will not allocate if
-	// already done!
-	void startVertices(int32_t maxVertices = 30000);
-
 	//------------------------------------------------------
 	// Frees a specific texture.
 	void removeTexture(uint32_t gosTextureHandle);
@@ -451,8 +395,13 @@ public:
 				if (!vertices && !masterTextureNodes[nodeId].vertexData->vertices)
 				{
 					masterTextureNodes[nodeId].vertexData->currentVertex = vertices =
-						masterTextureNodes[nodeId].vertexData->vertices = gvManager->getVertexBlock(
+						masterTextureNodes[nodeId].vertexData->vertices = getVertexBlock(
 							masterTextureNodes[nodeId].vertexData->numVertices);
+					if (!vertices)
+					{
+						numDroppedTriangles++;
+						return;
+					}
 				}
 				if (vertices < (masterTextureNodes[nodeId].vertexData->vertices + masterTextureNodes[nodeId].vertexData->numVertices))
 				{
@@ -496,8 +445,13 @@ public:
 				{
 					masterTextureNodes[nodeId].vertexData2->currentVertex = vertices =
 						masterTextureNodes[nodeId].vertexData2->vertices =
-							gvManager->getVertexBlock(
+							getVertexBlock(
 								masterTextureNodes[nodeId].vertexData2->numVertices);
+					if (!vertices)
+					{
+						numDroppedTriangles++;
+						return;
+					}
 				}
 				if (vertices < (masterTextureNodes[nodeId].vertexData2->vertices + masterTextureNodes[nodeId].vertexData2->numVertices))
 				{
@@ -541,8 +495,13 @@ public:
 				{
 					masterTextureNodes[nodeId].vertexData3->currentVertex = vertices =
 						masterTextureNodes[nodeId].vertexData3->vertices =
-							gvManager->getVertexBlock(
+							getVertexBlock(
 								masterTextureNodes[nodeId].vertexData3->numVertices);
+					if (!vertices)
+					{
+						numDroppedTriangles++;
+						return;
+					}
 				}
 				if (vertices < (masterTextureNodes[nodeId].vertexData3->vertices + masterTextureNodes[nodeId].vertexData3->numVertices))
 				{
@@ -587,7 +546,12 @@ public:
 				if (!vertices && !vertexData->vertices)
 				{
 					vertexData->currentVertex = vertices = vertexData->vertices =
-						gvManager->getVertexBlock(vertexData->numVertices);
+						getVertexBlock(vertexData->numVertices);
+					if (!vertices)
+					{
+						numDroppedTriangles++;
+						return;
+					}
 				}
 				if (vertices <= (vertexData->vertices + vertexData->numVertices))
 				{
@@ -602,7 +566,12 @@ public:
 				if (!vertices && !vertexData2->vertices)
 				{
 					vertexData2->currentVertex = vertices = vertexData2->vertices =
-						gvManager->getVertexBlock(vertexData2->numVertices);
+						getVertexBlock(vertexData2->numVertices);
+					if (!vertices)
+					{
+						numDroppedTriangles++;
+						return;
+					}
 				}
 				if (vertices <= (vertexData2->vertices + vertexData2->numVertices))
 				{
@@ -617,7 +586,12 @@ public:
 				if (!vertices && !vertexData3->vertices)
 				{
 					vertexData3->currentVertex = vertices = vertexData3->vertices =
-						gvManager->getVertexBlock(vertexData3->numVertices);
+						getVertexBlock(vertexData3->numVertices);
+					if (!vertices)
+					{
+						numDroppedTriangles++;
+						return;
+					}
 				}
 				if (vertices <= (vertexData3->vertices + vertexData3->numVertices))
 				{
@@ -632,7 +606,12 @@ public:
 				if (!vertices && !vertexData4->vertices)
 				{
 					vertexData4->currentVertex = vertices = vertexData4->vertices =
-						gvManager->getVertexBlock(vertexData4->numVertices);
+						getVertexBlock(vertexData4->numVertices);
+					if (!vertices)
+					{
+						numDroppedTriangles++;
+						return;
+					}
 				}
 				if (vertices <= (vertexData4->vertices + vertexData4->numVertices))
 				{
@@ -650,6 +629,14 @@ public:
 		}
 	}
 
+	// Vertices for the draw lists come from the frame arena, so they last
+	// until the frame after this one.  Once the arena and its overflow heap
+	// are both used up this is nullptr, and addVertices drops the triangle.
+	gos_VERTEX* getVertexBlock(uint32_t numVertices)
+	{
+		return ((gos_VERTEX*)frameArena->Malloc(sizeof(gos_VERTEX) * numVertices));
+	}
+
 	void clearArrays(void)
 	{
 		for (size_t i = 0; i < MC_MAXTEXTURES; i++)
@@ -659,9 +646,13 @@ public:
 			masterTextureNodes[i].vertexData3 = nullptr;
 		}
 		vertexData = vertexData2 = vertexData3 = vertexData4 = nullptr;
+		if (numDroppedTriangles)
+		{
+			SPEW((0, "Texture Manager dropped %u triangles, out of vertex memory\n", numDroppedTriangles));
+			numDroppedTriangles = 0;
+		}
 		memset(masterVertexNodes, 0, sizeof(MC_VertexArrayNode) * MC_MAXTEXTURES);
 		nextAvailableVertexNode = 0;
-		gvManager->reset(void);
 	}
 
 	// Sends down the triangle lists
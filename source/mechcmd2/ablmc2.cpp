@@ -101,19 +101,23 @@
 #include "logistics.h"
 #endif
 
-MoverGroupPtr CurGroup = nullptr;
-GameObjectPtr CurObject = nullptr;
-int32_t CurObjectClass = 0;
-std::unique_ptr<MechWarrior> CurWarrior = nullptr;
-GameObjectPtr CurContact = nullptr;
-int32_t CurAlarm;
-std::unique_ptr<Mover> moverList[256];
+//---------------------------------------------------------------
+// Per-brain state. Thread local, since brains can think on worker
+// threads (see MechWarrior::runBrains)...
+thread_local MoverGroupPtr CurGroup = nullptr;
+thread_local GameObjectPtr CurObject = nullptr;
+thread_local int32_t CurObjectClass = 0;
+thread_local std::unique_ptr<MechWarrior> CurWarrior = nullptr;
+thread_local GameObjectPtr CurContact = nullptr;
+thread_local int32_t CurAlarm;
+thread_local std::unique_ptr<Mover> moverList[256];
 bool TacOrderOrigin = ORDER_ORIGIN_COMMANDER;
 int32_t CurMultiplayCode = 0;
 int32_t CurMultiplayParam = 0;
 extern float MaxVisualRadius;
 extern float WeaponRange[NUM_FIRERANGES];
 extern GameLog* BugLog;
+extern int32_t ABLProfileInterval;
 
 UserHeapPtr AblStackHeap = nullptr;
 UserHeapPtr AblCodeHeap = nullptr;
@@ -130,6 +134,10 @@ void
 DEBUGWINS_setGameObject(int32_t debugObj, GameObjectPtr obj);
 void
 DEBUGWINS_print(const std::wstring_view& s, int32_t window);
+#ifdef USE_NATIVE_ABL
+void
+registerNativeABLModules(void);
+#endif
 
 //*****************************************************************************
 // MISC AI
@@ -139,15 +147,10 @@ int32_t
 getMoversWithinRadius(std::unique_ptr<Mover>* moverList, Stuff::Vector3D center, float radius,
 	int32_t teamID, int32_t commanderid, bool getEnemies, bool sortDescending, bool ignoreOrder)
 {
-	static float sortValues[MAX_MOVERS];
-	if (!Team::sortList)
-	{
-		Team::sortList = new SortList;
-		if (!Team::sortList)
-			Fatal(0, " Unable to create Team Contact sortList ");
-		Team::sortList->init(MAX_CONTACTS_PER_SENSOR);
-	}
-	Team::sortList->clear(sortDescending);
+	//--------------------------------------------------------
+	// requesttarget runs on brain workers, so this sorts on the
+	// stack rather than in the team's shared list.
+	SortListNode sortNodes[MAX_MOVERS];
 	TeamPtr team = nullptr;
 	if (teamID > -1)
 		team = Team::teams[teamID];
@@ -163,8 +166,8 @@ getMoversWithinRadius(std::unique_ptr<Mover>* moverList, Stuff::Vector3D center,
 					{
 						if (ignoreOrder || (mover->getPilot()->getCurTacOrder()->code == TACTICAL_ORDER_NONE))
 						{
-							Team::sortList->setId(numValidMovers, mover->getHandle());
-							Team::sortList->setValue(numValidMovers, mover->getThreatRating());
+							sortNodes[numValidMovers].id = mover->getHandle();
+							sortNodes[numValidMovers].value = mover->getThreatRating();
 							numValidMovers++;
 						}
 					}
@@ -183,8 +186,8 @@ getMoversWithinRadius(std::unique_ptr<Mover>* moverList, Stuff::Vector3D center,
 						{
 							if (ignoreOrder || (mover->getPilot()->getCurTacOrder()->code == TACTICAL_ORDER_NONE))
 							{
-								Team::sortList->setId(numValidMovers, mover->getHandle());
-								Team::sortList->setValue(numValidMovers, mover->getThreatRating());
+								sortNodes[numValidMovers].id = mover->getHandle();
+								sortNodes[numValidMovers].value = mover->getThreatRating();
 								numValidMovers++;
 							}
 						}
@@ -201,8 +204,8 @@ getMoversWithinRadius(std::unique_ptr<Mover>* moverList, Stuff::Vector3D center,
 						{
 							if (ignoreOrder || (mover->getPilot()->getCurTacOrder()->code == TACTICAL_ORDER_NONE))
 							{
-								Team::sortList->setId(numValidMovers, mover->getHandle());
-								Team::sortList->setValue(numValidMovers, mover->getThreatRating());
+								sortNodes[numValidMovers].id = mover->getHandle();
+								sortNodes[numValidMovers].value = mover->getThreatRating();
 								numValidMovers++;
 							}
 						}
@@ -211,9 +214,9 @@ getMoversWithinRadius(std::unique_ptr<Mover>* moverList, Stuff::Vector3D center,
 	}
 	if (numValidMovers > 0)
 	{
-		Team::sortList->sort(sortDescending);
+		SortList::sortNodes(sortNodes, numValidMovers, sortDescending);
 		for (size_t i = 0; i < numValidMovers; i++)
-			moverList[i] = (std::unique_ptr<Mover>)ObjectManager->get(Team::sortList->getId(i));
+			moverList[i] = (std::unique_ptr<Mover>)ObjectManager->get(sortNodes[i].id);
 	}
 	return (numValidMovers);
 }
@@ -239,9 +242,19 @@ calcAttackPlan(
 		target[i] = nullptr;
 	}
 	//-------------------------------------------------------------------------
-	// Calc who they should attack, trying to spread the wealth, so to speak...
+	// Calc who they should attack, trying to spread the wealth, so to speak.
+	// Ties go to whoever this attacker has the better shot at...
+	int32_t threatRating[MAX_MOVERS];
+	float attackChance[MAX_MOVERS];
 	for (size_t a = 0; a < numAttackers; a++)
 	{
+		TeamPtr team = attackers[a]->getTeam();
+		for (size_t d = 0; d < numDefenders; d++)
+		{
+			TacticalEval eval = team->getTacticalEval((std::unique_ptr<Mover>)attackers[a], defenders[d]);
+			threatRating[d] = eval.threatRating;
+			attackChance[d] = eval.attackChance;
+		}
 		int32_t toughest = numDefenders - 1;
 		for (size_t d = (numDefenders - 2); d > -1; d--)
 		{
@@ -251,10 +264,12 @@ calcAttackPlan(
 			{
 				if (attackTotal[d] > attackTotal[toughest])
 					toughest = d;
+				else if ((attackTotal[d] == attackTotal[toughest]) && (attackChance[d] > attackChance[toughest]))
+					toughest = d;
 			}
 		}
 		attackTotal[toughest] += attackers[a]->getThreatRating();
-		attackRatio[toughest] = attackTotal[toughest] / defenders[toughest]->getThreatRating();
+		attackRatio[toughest] = attackTotal[toughest] / threatRating[toughest];
 		target[a] = defenders[toughest];
 	}
 	//---------------------------------------------
@@ -295,10 +310,18 @@ calcBestTarget(std::unique_ptr<Mover> attacker, int32_t numAttackers, std::uniqu
 				break;
 			}
 	}
+	int32_t threatRating[MAX_MOVERS];
+	float attackChance[MAX_MOVERS];
 	for (size_t d = 0; d < numDefenders; d++)
-		attackRatio[d] = attackTotal[d] / defenders[d]->getThreatRating();
-	//----------------------------------------------
-	// Now, find out who this pilot should attack...
+	{
+		TacticalEval eval = attacker->getTeam()->getTacticalEval(attacker, defenders[d]);
+		threatRating[d] = eval.threatRating;
+		attackChance[d] = eval.attackChance;
+		attackRatio[d] = attackTotal[d] / threatRating[d];
+	}
+	//-------------------------------------------------------------------
+	// Now, find out who this pilot should attack. Ties go to whoever the
+	// pilot has the better shot at...
 	int32_t bestTarget = numDefenders - 1;
 	if (numDefenders > 1)
 		for (d = (numDefenders - 2); d > -1; d--)
@@ -309,10 +332,12 @@ calcBestTarget(std::unique_ptr<Mover> attacker, int32_t numAttackers, std::uniqu
 			{
 				if (attackTotal[d] > attackTotal[bestTarget])
 					bestTarget = d;
+				else if ((attackTotal[d] == attackTotal[bestTarget]) && (attackChance[d] > attackChance[bestTarget]))
+					bestTarget = d;
 			}
 		}
 	attackTotal[bestTarget] += attacker->getThreatRating();
-	attackRatio[bestTarget] = attackTotal[bestTarget] / defenders[bestTarget]->getThreatRating();
+	attackRatio[bestTarget] = attackTotal[bestTarget] / threatRating[bestTarget];
 	return (defenders[bestTarget]);
 }
 
@@ -3195,8 +3220,8 @@ execSetCurrentBRValue(void)
 	//		PARAMS:	integer, integer
 	//
 	//		Returns: None
-	int32_t objectNum = tos->integer;
-	int32_t newBRValue = tos->integer;
+	int32_t objectNum = CurContext->tos->integer;
+	int32_t newBRValue = CurContext->tos->integer;
 	//------------------------------------------------
 	// Code to make this work goes here
 	GameObjectPtr object1 = getObject(objectNum);
@@ -4795,7 +4820,7 @@ execIsGateOpen(void)
 				DebugMissionScriptMessages();
 				Assert(false, NumMissionScriptMessages, " Way too many Mission Script Messages! ");
 			}
-			MissionScriptMessageLog[NumMissionScriptMessages][0] = execLineNumber;
+			MissionScriptMessageLog[NumMissionScriptMessages][0] = CurContext->execLineNumber;
 			MissionScriptMessageLog[NumMissionScriptMessages][1] = CurMultiplayCode;
 			MissionScriptMessageLog[NumMissionScriptMessages][2] = CurMultiplayParam;
 			NumMissionScriptMessages++;
@@ -6329,6 +6354,13 @@ execIsGateOpen(void)
 	{
 		return (((std::unique_ptr<File>)file)->writeString(buffer));
 	}
+	//-----------------------------------------------------------------------------
+	bool ablImageExistsCB(const std::wstring_view& filename)
+	{
+		// Filenames MUST be all lowercase or Hash won't find 'em!
+		CharLower(filename);
+		return (fileExists(filename) != 0);
+	}
 	//*****************************************************************************
 	void ablDebuggerPrintCallback(const std::wstring_view& s)
 	{
@@ -6420,6 +6452,16 @@ execIsGateOpen(void)
 		ABLi_setDebugPrintCallback(ablDebugPrintCallback);
 		ABLi_setRandomCallbacks(ablSeedRandom, RandomNumber);
 		ABLi_setEndlessStateCallback(ablEndlessStateCallback);
+		ABLi_setCompiledModuleCache(true, ablImageExistsCB);
+#ifdef USE_NATIVE_ABL
+		//---------------------------------------------------------
+		// Brains translated to C++ (the ablt -cpp output, added to
+		// the build by hand) bind as each module compiles, if their
+		// sources haven't changed since...
+		registerNativeABLModules();
+#endif
+		if (ABLProfileInterval > 0)
+			ABLi_enableProfiler(true, ABLProfileInterval);
 		ABLi_addFunction("getid", false, nullptr, "i", execGetId);
 		ABLi_addFunction("gettime", false, nullptr, "r", execGetTime);
 		ABLi_addFunction("gettimeleft", false, nullptr, "r", execGetTimeLeft);
@@ -6666,6 +6708,52 @@ execIsGateOpen(void)
 		ABLi_addFunction("incallout", false, nullptr, "b", execInCallout);
 		ABLi_addFunction("setinvulnerable", false, "b", nullptr, execSetInvulnerable);
 		ABLi_addFunction("freezegui", false, "b", nullptr, execFreezeGUI);
+		//------------------------------------------------------------------
+		// Brains run on worker contexts may only read the world, or write
+		// their own pilot's state. Anything else that touches shared state
+		// is queued and replayed after the batch, in warrior order, and the
+		// script carries on with a provisional result (0, unless given
+		// below). A deferred order call that turns out to be done when it's
+		// replayed is skipped on the next tick, as if it had returned 1.
+		// Functions whose real result the brain can't do without need the
+		// main thread, so brains that call them are never batched. The
+		// rest run concurrently, so any scratch they use has to be on the
+		// stack or thread_local, never a static shared by all of them.
+		static const char* deferredFunctions[] = {"objectchangesides",
+			"objectsuicide", "endtimer", "setpilotwounds", "setglobalvalue",
+			"setobjectivepos", "setsensorrange", "settonnage", "setexplosiondamage",
+			"setexplosionradius", "setanimation", "setrevealed", "orderrefit",
+			"setcaptured", "ordercapture", "setcapturable", "setbuildingname",
+			"callstrike", "callstrikeex", "orderloadelementals",
+			"orderdeployelementals", "lockgateopen", "lockgateclosed",
+			"releasegatelock", "repair", "sendmessage", "setdebugstring",
+			"setmoviemode", "endmoviemode", "fadetocolor", "setcameraposition",
+			"setcameragoalposition", "setcamerarotation", "setcameragoalrotation",
+			"setcamerazoom", "setcameragoalzoom", "setcameravelocity",
+			"setcameragoalvelocity", "setcameralookobject", "resettriggerarea",
+			"removetriggerarea", "setmovearea", "setgeneralalarm", "tutorialtext",
+			"stopvoiceover", "setinvulnerable", "freezegui", "settarget",
+			"setchallenger", "orderwait", "ordermoveto", "ordermovetoobject",
+			"ordermovetocontact", "orderpowerdown", "orderpowerup",
+			"orderattackobject", "orderattackcontact", "orderwithdraw",
+			"damageobject", "objectremove", "setobjectivestatus",
+			"playdigitalmusic", "stopmusic", "playsoundeffect", "playvideo",
+			"setradio", "playspeech", "playbetty", "setobjectactive",
+			"setcurrentbrvalue", "setobjectdamage", "setsalvage",
+			"setsalvagestatus", "addprisoner", "newmoveto", "newmovetoobject",
+			"newpower", "newattack", "newcapture", "newscan", "newcontrol",
+			"coremoveto", "coremovetoobject", "corepower", "coreattack",
+			"corecapture", "corescan", "corecontrol", "coreeject",
+			"setdebugwindow", "forcemovieend", "requesthelp", "mcprint",
+			"cleartacorder", "playwave", "animationcallout",
+			"logisticsanimationcallout", nullptr};
+		static const char* mainThreadFunctions[] = {"objectcreate",
+			"createinfantry", "addtriggerarea", "pathexists", "requestshelter",
+			"settimer", "fileopen", "filewrite", "fileclose", "break", nullptr};
+		for (size_t i = 0; deferredFunctions[i]; i++)
+			ABLi_setFunctionMode(deferredFunctions[i], FUNCTION_MODE_DEFERRED);
+		for (size_t i = 0; mainThreadFunctions[i]; i++)
+			ABLi_setFunctionMode(mainThreadFunctions[i], FUNCTION_MODE_MAIN);
 		// static int32_t Godzilla = 120;
 		// static int32_t GodzillaList[5] = {10, 20, 30, 40, 50};
 		// ABLi_registerInteger("godzilla", &Godzilla);
@@ -6674,6 +6762,11 @@ execIsGateOpen(void)
 	//*****************************************************************************
 	void closeABL(void)
 	{
+		//----------------------------------------------------------
+		// The profile covers every brain run since initABL. Write it
+		// out while the module names are still around...
+		if (ABLProfileInterval > 0)
+			ABLi_writeProfile("ablprof.folded", "ablprof.txt", 50);
 		ABLi_close();
 		if (AblSymbolHeap)
 		{
@@ -182,7 +182,7 @@ PVOID
 ArtilleryChunk::operator new(size_t ourSize)
 {
 	PVOID result;
-	result = systemHeap->Malloc(ourSize);
+	result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -308,6 +308,32 @@ ArtilleryType::destroy(void)
 
 //---------------------------------------------------------------------------
 
+void
+ArtilleryType::cook(ObjectTypeRecord& record)
+{
+	ObjectType::cook(record);
+	record.clearPointer(this, &frameList);
+	record.clearPointer(this, &explosionOffsetX);
+	record.clearPointer(this, &explosionOffsetY);
+	record.clearPointer(this, &explosionDelay);
+	record.writeBlock(explosionOffsetX, sizeof(float) * numExplosions);
+	record.writeBlock(explosionOffsetY, sizeof(float) * numExplosions);
+	record.writeBlock(explosionDelay, sizeof(float) * numExplosions);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+ArtilleryType::uncook(ObjectTypeRecord& record)
+{
+	if (!ObjectType::uncook(record))
+		return (false);
+	return (record.readBlock((PVOID&)explosionOffsetX, systemHeap) && record.readBlock((PVOID&)explosionOffsetY, systemHeap) &&
+		record.readBlock((PVOID&)explosionDelay, systemHeap));
+}
+
+//---------------------------------------------------------------------------
+
 int32_t
 ArtilleryType::init(std::unique_ptr<File> objFile, uint32_t fileSize)
 {
@@ -125,6 +125,10 @@ public:
 
 	virtual int32_t init(std::unique_ptr<File> objFile, uint32_t fileSize);
 
+	virtual size_t getCookedSize(void) { return (sizeof(ArtilleryType)); }
+	virtual void cook(ObjectTypeRecord& record);
+	virtual bool uncook(ObjectTypeRecord& record);
+
 	int32_t init(FitIniFilePtr objFile);
 
 	~ArtilleryType(void) { destroy(void); }
@@ -76,6 +76,8 @@ public:
 
 	virtual int32_t init(std::unique_ptr<File> objFile, uint32_t fileSize);
 
+	virtual size_t getCookedSize(void) { return (sizeof(BuildingType)); }
+
 	int32_t init(FitIniFilePtr objFile);
 
 	~BuildingType(void) { destroy(void); }
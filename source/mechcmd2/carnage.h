@@ -201,6 +201,8 @@ public:
 
 	virtual int32_t init(std::unique_ptr<File> objFile, uint32_t fileSize);
 
+	virtual size_t getCookedSize(void) { return (sizeof(FireType)); }
+
 	int32_t init(FitIniFilePtr objFile);
 
 	~FireType(void) { destroy(void); }
@@ -260,6 +262,8 @@ public:
 
 	virtual int32_t init(std::unique_ptr<File> objFile, uint32_t fileSize);
 
+	virtual size_t getCookedSize(void) { return (sizeof(ExplosionType)); }
+
 	int32_t init(FitIniFilePtr objFile);
 
 	~ExplosionType(void) { destroy(void); }
@@ -133,7 +133,7 @@ CollisionGrid::operator new(size_t mySize)
 {
 	PVOID result = nullptr;
 	if (CollisionSystem::collisionHeap && CollisionSystem::collisionHeap->heapReady())
-		result = CollisionSystem::collisionHeap->Malloc(mySize);
+		result = CollisionSystem::collisionHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
@@ -354,7 +354,7 @@ PVOID
 CollisionSystem::operator new(size_t mySize)
 {
 	PVOID result = nullptr;
-	result = systemHeap->Malloc(mySize);
+	result = systemHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
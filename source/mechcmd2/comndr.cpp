@@ -46,7 +46,7 @@ CommanderPtr Commander::home = nullptr;
 PVOID
 Commander::operator new(size_t ourSize)
 {
-	PVOID result = systemHeap->Malloc(ourSize);
+	PVOID result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -63,7 +63,7 @@ PVOID
 ContactInfo::operator new(size_t ourSize)
 {
 	PVOID result;
-	result = missionHeap->Malloc(ourSize);
+	result = missionHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -82,7 +82,7 @@ ContactInfo::operator delete(PVOID us)
 PVOID
 SensorSystem::operator new(size_t mySize)
 {
-	PVOID result = missionHeap->Malloc(mySize);
+	PVOID result = missionHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
@@ -674,7 +674,7 @@ SensorSystem::getTeamContacts(
 PVOID
 TeamSensorSystem::operator new(size_t mySize)
 {
-	PVOID result = missionHeap->Malloc(mySize);
+	PVOID result = missionHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
@@ -891,59 +891,45 @@ TeamSensorSystem::getContacts(
 {
 	if ((sortType != CONTACT_SORT_NONE) && !looker)
 		return (0);
-	static float sortValues[MAX_CONTACTS_PER_SENSOR];
+	//-----------------------------------------------------------
+	// Brains on worker threads call this at once, so the sort is
+	// done on the stack rather than in SensorSystem::sortList.
+	// BIG ASSUMPTION HERE: That a mech will not have more than
+	// MAX_CONTACTS_PER_SENSOR contacts.
+	SortListNode sortNodes[MAX_CONTACTS_PER_SENSOR];
 	float CV = 0;
 	int32_t numValidContacts = 0;
-	int32_t handleList[MAX_CONTACTS_PER_SENSOR];
 	for (size_t i = 0; i < numContacts; i++)
 	{
 		std::unique_ptr<Mover> mover = (std::unique_ptr<Mover>)ObjectManager->get(contacts[i]);
 		if (!meetsCriteria(looker, mover, contactCriteria))
 			continue;
-		handleList[numValidContacts] = mover->getHandle();
+		sortNodes[numValidContacts].id = mover->getHandle();
 		switch (sortType)
 		{
 		case CONTACT_SORT_NONE:
-			sortValues[numValidContacts] = 0.0;
+			sortNodes[numValidContacts].value = 0.0;
 			break;
 		case CONTACT_SORT_CV:
 			CV = (float)mover->getCurCV();
-			sortValues[numValidContacts] = CV;
+			sortNodes[numValidContacts].value = CV;
 			break;
 		case CONTACT_SORT_DISTANCE:
-			sortValues[numValidContacts] = looker->distanceFrom(mover->getPosition());
+			sortNodes[numValidContacts].value = looker->distanceFrom(mover->getPosition());
 			break;
 		}
 		numValidContacts++;
 	}
 	if ((numValidContacts > 0) && (sortType != CONTACT_SORT_NONE))
 	{
-		//---------------------------------------------------------
-		// BIG ASSUMPTION HERE: That a mech will not have more than
-		// MAX_CONTACTS_PER_SENSOR contacts.
-		if (!SensorSystem::sortList)
-		{
-			SensorSystem::sortList = new SortList;
-			if (!SensorSystem::sortList)
-				Fatal(0, " Unable to create Contact sortList ");
-			SensorSystem::sortList->init(MAX_CONTACTS_PER_SENSOR);
-		}
 		bool descendSort = true;
 		if (sortType == CONTACT_SORT_DISTANCE)
 			descendSort = false;
-		SensorSystem::sortList->clear(descendSort);
-		for (size_t contact = 0; contact < numValidContacts; contact++)
-		{
-			SensorSystem::sortList->setId(contact, handleList[contact]);
-			SensorSystem::sortList->setValue(contact, sortValues[contact]);
-		}
-		SensorSystem::sortList->sort(descendSort);
-		for (contact = 0; contact < numValidContacts; contact++)
-			contactList[contact] = SensorSystem::sortList->getId(contact);
+		SortList::sortNodes(sortNodes, numValidContacts, descendSort);
 	}
-	else if (contactList)
+	if (contactList)
 		for (size_t contact = 0; contact < numValidContacts; contact++)
-			contactList[contact] = handleList[contact];
+			contactList[contact] = sortNodes[contact].id;
 	return (numValidContacts);
 }
 
@@ -1177,7 +1163,7 @@ TeamSensorSystem::updateEcmEffects(void)
 PVOID
 SensorSystemManager::operator new(size_t mySize)
 {
-	PVOID result = missionHeap->Malloc(mySize);
+	PVOID result = missionHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
@@ -57,7 +57,8 @@ enum ObjectTypeClass
 	TURRET_TYPE,
 	GATE_TYPE,
 	KLIEG_LIGHT_TYPE,
-	WEAPONBOLT_TYPE
+	WEAPONBOLT_TYPE,
+	NUM_OBJECT_TYPE_CLASSES
 };
 
 /*
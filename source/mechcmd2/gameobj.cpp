@@ -217,7 +217,7 @@ PVOID
 WeaponFireChunk::operator new(size_t ourSize)
 {
 	PVOID result;
-	result = systemHeap->Malloc(ourSize);
+	result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -1120,7 +1120,7 @@ DebugWeaponHitChunk(WeaponHitChunkPtr chunk1, WeaponHitChunkPtr chunk2)
 PVOID
 WeaponHitChunk::operator new(size_t ourSize)
 {
-	PVOID result = systemHeap->Malloc(ourSize);
+	PVOID result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -1489,7 +1489,7 @@ WeaponHitChunk::valid(int32_t from)
 PVOID
 GameObject::operator new(size_t ourSize)
 {
-	PVOID result = ObjectTypeManager::objectCache->Malloc(ourSize);
+	PVOID result = ObjectTypeManager::objectCache->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -73,6 +73,8 @@ public:
 	GateType(void) { init(void); }
 
 	virtual int32_t init(std::unique_ptr<File> objFile, uint32_t fileSize);
+
+	virtual size_t getCookedSize(void) { return (sizeof(GateType)); }
 	int32_t init(FitIniFilePtr objFile);
 
 	~GateType(void) { destroy(void); }
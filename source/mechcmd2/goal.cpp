@@ -42,7 +42,7 @@ int32_t recurseCount = 0;
 PVOID
 GoalObject::operator new(size_t ourSize)
 {
-	PVOID result = missionHeap->Malloc(ourSize);
+	PVOID result = missionHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -121,7 +121,7 @@ GoalObject::addController(GoalObjectPtr gobject)
 PVOID
 GoalManager::operator new(size_t ourSize)
 {
-	PVOID result = missionHeap->Malloc(ourSize);
+	PVOID result = missionHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -77,7 +77,7 @@ GoalMapNode* MoverGroup::goalMap = nullptr;
 PVOID
 MoverGroup::operator new(size_t ourSize)
 {
-	PVOID result = systemHeap->Malloc(ourSize);
+	PVOID result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
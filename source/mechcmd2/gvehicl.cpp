@@ -310,52 +310,30 @@ GroundVehicleType::init(std::unique_ptr<File> objFile, uint32_t fileSize)
 	result = vehicleFile.seekBlock("General");
 	if (result != NO_ERROR)
 		Fatal(result, " GroundVehicle:Init - Unable to find Block General ");
-	result = vehicleFile.readIdLong("MoveType", moveType);
-	if (result != NO_ERROR)
-		moveType = MOVETYPE_GROUND;
-	result = vehicleFile.readIdFloat("LOSFactor", LOSFactor);
-	if (result != NO_ERROR)
-		LOSFactor = 1.0f;
-	result = vehicleFile.readIdUChar("Chassis", chassis);
+	//------------------------------------------------------------------
+	// Everything in General, read in one pass.  Chassis is the only one
+	// that has to be there, the rest get their defaults.
+	static const IniField generalFields[] = {
+		{"MoveType", INI_FIELD_LONG, INI_FIELD_MEMBER(GroundVehicleType, moveType), 0, false, MOVETYPE_GROUND},
+		{"LOSFactor", INI_FIELD_FLOAT, INI_FIELD_MEMBER(GroundVehicleType, LOSFactor), 0, false, 1.0},
+		{"Chassis", INI_FIELD_UCHAR, INI_FIELD_MEMBER(GroundVehicleType, chassis), 0, true, 0.0},
+		// Special Vehicle Info
+		{"RefitPoints", INI_FIELD_LONG, INI_FIELD_MEMBER(GroundVehicleType, refitPoints), 0, false, 0.0},
+		{"ResourcePoints", INI_FIELD_LONG, INI_FIELD_MEMBER(GroundVehicleType, resourcePoints), 0, false, 0.0},
+		{"RecoverPoints", INI_FIELD_LONG, INI_FIELD_MEMBER(GroundVehicleType, recoverPoints), 0, false, 0.0},
+		{"MineSweeper", INI_FIELD_BOOLEAN, INI_FIELD_MEMBER(GroundVehicleType, mineSweeper), 0, false, 0.0},
+		{"MineLayer", INI_FIELD_LONG, INI_FIELD_MEMBER(GroundVehicleType, mineLayer), 0, false, 0.0},
+		{"HoverCraft", INI_FIELD_BOOLEAN, INI_FIELD_MEMBER(GroundVehicleType, hoverCraft), 0, false, 0.0},
+		{"AeroSpaceSpotter", INI_FIELD_BOOLEAN, INI_FIELD_MEMBER(GroundVehicleType, aerospaceSpotter), 0, false, 0.0},
+		{"IsSensorContact", INI_FIELD_BOOLEAN, INI_FIELD_MEMBER(GroundVehicleType, isSensorContact), 0, false, 1.0},
+		// Splash Damage.
+		{"ExplosionRadius", INI_FIELD_FLOAT, INI_FIELD_MEMBER(GroundVehicleType, explRad), 0, false, 0.0},
+		{"ExplosionDamage", INI_FIELD_FLOAT, INI_FIELD_MEMBER(GroundVehicleType, explDmg), 0, false, 0.0},
+		{"PathLocks", INI_FIELD_BOOLEAN, INI_FIELD_MEMBER(GroundVehicleType, pathLocks), 0, false, 1.0},
+	};
+	result = vehicleFile.readFields(generalFields, sizeof(generalFields) / sizeof(generalFields[0]), this);
 	if (result != NO_ERROR)
 		Fatal(result, " GroundVehicle:Init - Unable to find Chassis ");
-	//------------------------------
-	// Check Special Vehicle Info
-	result = vehicleFile.readIdLong("RefitPoints", refitPoints);
-	if (result != NO_ERROR)
-		refitPoints = 0;
-	result = vehicleFile.readIdLong("ResourcePoints", resourcePoints);
-	if (result != NO_ERROR)
-		resourcePoints = 0;
-	result = vehicleFile.readIdLong("RecoverPoints", recoverPoints);
-	if (result != NO_ERROR)
-		recoverPoints = 0;
-	result = vehicleFile.readIdBoolean("MineSweeper", mineSweeper);
-	if (result != NO_ERROR)
-		mineSweeper = false;
-	result = vehicleFile.readIdLong("MineLayer", mineLayer);
-	if (result != NO_ERROR)
-		mineLayer = 0;
-	result = vehicleFile.readIdBoolean("HoverCraft", hoverCraft);
-	if (result != NO_ERROR)
-		hoverCraft = false;
-	result = vehicleFile.readIdBoolean("AeroSpaceSpotter", aerospaceSpotter);
-	if (result != NO_ERROR)
-		aerospaceSpotter = false;
-	result = vehicleFile.readIdBoolean("IsSensorContact", isSensorContact);
-	if (result != NO_ERROR)
-		isSensorContact = true;
-	//------------------------------
-	// Splash Damage.
-	result = vehicleFile.readIdFloat("ExplosionRadius", explRad);
-	if (result != NO_ERROR)
-		explRad = 0.0;
-	result = vehicleFile.readIdFloat("ExplosionDamage", explDmg);
-	if (result != NO_ERROR)
-		explDmg = 0.0;
-	result = vehicleFile.readIdBoolean("PathLocks", pathLocks);
-	if (result != NO_ERROR)
-		pathLocks = true;
 	//------------------------------------------------------------------
 	// Now, read in the max internal structure for each body location...
 	result = vehicleFile.seekBlock("InternalStructure");
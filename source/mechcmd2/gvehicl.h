@@ -138,6 +138,8 @@ public:
 
 	virtual int32_t init(std::unique_ptr<File> objFile, uint32_t fileSize);
 
+	virtual size_t getCookedSize(void) { return (sizeof(GroundVehicleType)); }
+
 	int32_t loadHotSpots(FitIniFilePtr vehicleFile);
 
 	virtual GameObjectPtr createInstance(void);
@@ -25,6 +25,8 @@ LogisticsData.cpp			: Implementation of the LogisticsData component.
 #include "missionresults.h"
 #include "zlib.h"
 
+#include <algorithm>
+
 #ifndef VIEWER
 #include "multPlyr.h"
 #include "chatwindow.h"
@@ -42,6 +44,10 @@ int32_t SaveGameVersionNumber = 10004;
 
 LogisticsData* LogisticsData::instance = nullptr;
 
+bool LogisticsDataLazy = true;
+size_t LogisticsPrefetchBudget = DEFAULT_LOGISTICS_PREFETCH_BUDGET;
+LogisticsDataStats LogisticsDataStatistics;
+
 LogisticsData::LogisticsData()
 {
 	gosASSERT(!instance);
@@ -51,10 +57,15 @@ LogisticsData::LogisticsData()
 	missionInfo = 0;
 	rpJustAdded = false;
 	bNewMechs = bNewWeapons = bNewPilots = 0;
+	numPilotsLoaded = 0;
+	pilotGeneration = 0;
+	prefetchBudgetLeft = 0;
+	prefetchRunning = false;
 }
 
 LogisticsData::~LogisticsData()
 {
+	stopPrefetch();
 	for (VARIANT_LIST::EIterator iter = variants.Begin(); !iter.IsDone(); iter++)
 	{
 		delete (*iter);
@@ -86,6 +97,8 @@ LogisticsData::init()
 	initComponents();
 	initPilots();
 	initVariants();
+	if (LogisticsDataLazy)
+		startPrefetch();
 	missionInfo = new LogisticsMissionInfo;
 	FitIniFile file;
 	if (NO_ERROR != file.open("data\\campaign\\campaign.fit"))
@@ -155,6 +168,15 @@ void
 LogisticsData::initPilots()
 {
 	pilots.Clear();
+	pilotRecords.clear();
+	numPilotsLoaded = 0;
+	pilotGeneration++;
+	{
+		// anything read ahead for the old list is no good now
+		std::lock_guard<std::mutex> lock(prefetchLock);
+		prefetchQueue.clear();
+		prefetchDone.clear();
+	}
 	wchar_t pilotPath[256];
 	strcpy(pilotPath, objectPath);
 	strcat(pilotPath, "pilots.csv");
@@ -167,14 +189,92 @@ LogisticsData::initPilots()
 		int32_t bytesRead = pilotFile.readLine(pilotFileName, 256);
 		if (bytesRead < 2)
 			break;
+		PilotRecord record;
+		strncpy(record.fileName, (const std::wstring_view&)pilotFileName, 63);
+		record.fileName[63] = 0;
+		record.id = id;
+		record.available = false;
+		pilotRecords.push_back(record);
+		id++;
+	}
+	LogisticsDataStatistics.numPilotsIndexed = pilotRecords.size();
+	if (!LogisticsDataLazy)
+		loadPilots();
+}
+
+//----------------------------------------------------------------------
+// Reads the pilots' fit files, in list order, up to count (all of them
+// when it is -1).  Pilots that fail to load are left out, as they
+// always were.
+void
+LogisticsData::loadPilots(int32_t count)
+{
+	if (count < 0 || count > (int32_t)pilotRecords.size())
+		count = pilotRecords.size();
+	while (numPilotsLoaded < count)
+	{
+		PilotRecord& record = pilotRecords[numPilotsLoaded++];
 		LogisticsPilot tmpPilot;
 		pilots.Append(tmpPilot);
 		LogisticsPilot& pilot = pilots.GetTail();
-		pilot.id = id;
-		if (-1 == pilot.init((const std::wstring_view&)pilotFileName))
+		pilot.id = record.id;
+		if (-1 == pilot.init(record.fileName))
+		{
 			pilots.DeleteTail();
-		id++;
+			continue;
+		}
+		pilot.setAvailable(record.available);
+		LogisticsDataStatistics.numPilotsLoaded++;
+	}
+}
+
+bool
+LogisticsData::setPilotAvailable(const std::wstring_view& pilotFileName)
+{
+	bool bFound = false;
+	for (PILOT_LIST::EIterator pIter = pilots.Begin(); !pIter.IsDone(); pIter++)
+	{
+		if ((*pIter).getFileName().Compare(pilotFileName, 0) == 0)
+		{
+			(*pIter).setAvailable(true);
+			bFound = true;
+		}
+	}
+	for (size_t i = numPilotsLoaded; i < pilotRecords.size(); i++)
+	{
+		if (_stricmp(pilotRecords[i].fileName, pilotFileName) == 0)
+		{
+			pilotRecords[i].available = true;
+			bFound = true;
+		}
+	}
+	return bFound;
+}
+
+void
+LogisticsData::clearPilotsAvailable()
+{
+	for (PILOT_LIST::EIterator pIter = pilots.Begin(); !pIter.IsDone(); pIter++)
+		(*pIter).setAvailable(0);
+	for (size_t i = numPilotsLoaded; i < pilotRecords.size(); i++)
+		pilotRecords[i].available = false;
+}
+
+int32_t
+LogisticsData::getAvailablePilotCount()
+{
+	int32_t count = 0;
+	for (PILOT_LIST::EIterator pIter = pilots.Begin(); !pIter.IsDone(); pIter++)
+	{
+		if ((*pIter).isAvailable())
+			count++;
 	}
+	for (size_t i = numPilotsLoaded; i < pilotRecords.size(); i++)
+	{
+		if (pilotRecords[i].available)
+			count++;
+	}
+	return count;
 }
 
 void
@@ -195,7 +295,6 @@ LogisticsData::initVariants()
 		Assert(0, 0, errorStr);
 	}
 	wchar_t variantFileName[256];
-	wchar_t variantFullPath[1024];
 	int32_t chassisID = 0;
 	wchar_t tmpStr[256];
 	int32_t i = 1;
@@ -233,36 +332,110 @@ LogisticsData::initVariants()
 			scale = 1.0;
 		variantFile.readString(i, 1, variantFileName, 256);
 		variantFile.readLong(i, 5, fitID);
-		strcpy(variantFullPath, objectPath);
-		strcat(variantFullPath, variantFileName);
-		strcat(variantFullPath, ".csv");
-		_strlwr(variantFullPath);
-		CSVFile mechFile;
-		if (NO_ERROR != mechFile.open(variantFullPath))
-		{
-			wchar_t error[256];
-			sprintf(error, "couldn't open file %s", variantFullPath);
-			Assert(0, 0, error);
-			return;
-		}
-		LogisticsChassis* chassis = new LogisticsChassis();
-		chassis->init(&mechFile, chassisID++);
-		chassis->setFitID(fitID);
-		chassis->setScale(scale);
-		int32_t row = 23;
-		wchar_t buffer[256];
-		int32_t varCount = 0;
-		while (NO_ERROR == mechFile.readString(row, 2, buffer, 256))
-		{
-			LogisticsVariant* pVariant = new LogisticsVariant;
-			if (0 == pVariant->init(&mechFile, chassis, varCount++))
-				variants.Append(pVariant);
-			else
-				delete pVariant;
-			row += 97;
-		}
+		ChassisRecord record;
+		strcpy(record.fileName, objectPath);
+		strcat(record.fileName, variantFileName);
+		strcat(record.fileName, ".csv");
+		_strlwr(record.fileName);
+		record.chassisID = chassisID++;
+		record.fitID = fitID;
+		record.scale = scale;
+		record.chassis = nullptr;
+		chassisRecords.push_back(record);
 		i++;
 	}
+	LogisticsDataStatistics.numChassisIndexed = chassisRecords.size();
+	if (!LogisticsDataLazy)
+		loadAllChassis();
+}
+
+//----------------------------------------------------------------------
+// Reads a chassis' csv, and its variants with it.
+void
+LogisticsData::loadChassis(ChassisRecord& record, bool sort)
+{
+	if (record.chassis)
+		return;
+	CSVFile mechFile;
+	if (NO_ERROR != mechFile.open(record.fileName))
+	{
+		wchar_t error[256];
+		sprintf(error, "couldn't open file %s", record.fileName);
+		Assert(0, 0, error);
+		return;
+	}
+	LogisticsChassis* chassis = new LogisticsChassis();
+	chassis->init(&mechFile, record.chassisID);
+	chassis->setFitID(record.fitID);
+	chassis->setScale(record.scale);
+	record.chassis = chassis;
+	int32_t row = 23;
+	wchar_t buffer[256];
+	int32_t varCount = 0;
+	while (NO_ERROR == mechFile.readString(row, 2, buffer, 256))
+	{
+		LogisticsVariant* pVariant = new LogisticsVariant;
+		if (0 == pVariant->init(&mechFile, chassis, varCount++))
+			variants.Append(pVariant);
+		else
+			delete pVariant;
+		row += 97;
+	}
+	LogisticsDataStatistics.numChassisLoaded++;
+	if (sort)
+		sortVariants();
+}
+
+// returns whether there were any left to load
+bool
+LogisticsData::loadAllChassis()
+{
+	bool bLoaded = false;
+	for (size_t i = 0; i < chassisRecords.size(); i++)
+	{
+		if (!chassisRecords[i].chassis)
+		{
+			loadChassis(chassisRecords[i], false);
+			bLoaded = true;
+		}
+	}
+	if (bLoaded)
+		sortVariants();
+	return bLoaded;
+}
+
+LogisticsData::ChassisRecord*
+LogisticsData::findChassis(const std::wstring_view& chassisFileName)
+{
+	for (size_t i = 0; i < chassisRecords.size(); i++)
+	{
+		wchar_t realName[256];
+		_splitpath(chassisRecords[i].fileName, nullptr, nullptr, realName, nullptr);
+		if (_stricmp(realName, chassisFileName) == 0)
+			return &chassisRecords[i];
+	}
+	return nullptr;
+}
+
+//----------------------------------------------------------------------
+// Keeps the list in the order it had when every chassis was read up
+// front: designer variants by chassis, then the player's own as they
+// were made.
+void
+LogisticsData::sortVariants()
+{
+	std::vector<LogisticsVariant*> sorted;
+	sorted.reserve(variants.Count());
+	for (VARIANT_LIST::EIterator iter = variants.Begin(); !iter.IsDone(); iter++)
+		sorted.push_back(*iter);
+	std::stable_sort(sorted.begin(), sorted.end(), [](LogisticsVariant* p1, LogisticsVariant* p2) {
+		int32_t key1 = p1->isDesignerMech() ? (p1->getChassisID() & 0xff) : 0x100;
+		int32_t key2 = p2->isDesignerMech() ? (p2->getChassisID() & 0xff) : 0x100;
+		return key1 < key2;
+	});
+	variants.Clear();
+	for (size_t i = 0; i < sorted.size(); i++)
+		variants.Append(sorted[i]);
 }
 
 void
@@ -456,6 +629,9 @@ LogisticsData::createInstanceID(LogisticsVariant* pVar)
 LogisticsVariant*
 LogisticsData::getVariant(int32_t ID)
 {
+	size_t chassisNum = ID & 0xff;
+	if (chassisNum < chassisRecords.size())
+		loadChassis(chassisRecords[chassisNum]);
 	for (VARIANT_LIST::EIterator iter = variants.Begin(); !iter.IsDone(); iter++)
 	{
 		if ((*iter)->getID() == (uint32_t)(ID & 0x00ffffff))
@@ -562,6 +738,7 @@ LogisticsData::removeMechFromForceGroup(LogisticsMech* pMech, bool bRemovePilot)
 LogisticsPilot*
 LogisticsData::getFirstAvailablePilot()
 {
+	loadPilots();
 	for (PILOT_LIST::EIterator iter = pilots.Begin(); !iter.IsDone(); iter++)
 	{
 		bool bIsUsed = false;
@@ -725,6 +902,11 @@ LogisticsData::getVariant(const std::wstring_view& pCSVFileName, int32_t Variant
 {
 	const std::wstring_view& lowerCase = pCSVFileName;
 	lowerCase.MakeLower();
+	for (size_t i = 0; i < chassisRecords.size(); i++)
+	{
+		if (strstr(chassisRecords[i].fileName, lowerCase))
+			loadChassis(chassisRecords[i]);
+	}
 	for (VARIANT_LIST::EIterator iter = variants.Begin(); !iter.IsDone(); iter++)
 	{
 		if (-1 != ((*iter)->getFileName().Find(lowerCase, -1)) && (((*iter)->getVariantID() >> 16) & 0xff) == VariantNum)
@@ -757,8 +939,7 @@ LogisticsData::removeMechsInForceGroup()
 const std::wstring_view&
 LogisticsData::getBestPilot(int32_t mechWeight)
 {
-	if (!pilots.Count())
-		initPilots();
+	loadPilots();
 	LogisticsPilot** pPilots = (LogisticsPilot**)_alloca(pilots.Count() * sizeof(LogisticsPilot*));
 	memset(pPilots, 0, pilots.Count() * sizeof(LogisticsPilot*));
 	int32_t counter = 0;
@@ -801,8 +982,7 @@ LogisticsData::getBestPilot(int32_t mechWeight)
 bool
 LogisticsData::gotPilotsLeft()
 {
-	if (!pilots.Count())
-		initPilots();
+	loadPilots();
 	LogisticsPilot** pPilots = (LogisticsPilot**)_alloca(pilots.Count() * sizeof(LogisticsPilot*));
 	memset(pPilots, 0, pilots.Count() * sizeof(LogisticsPilot*));
 	int32_t counter = 0;
@@ -863,6 +1043,7 @@ int32_t
 LogisticsData::save(FitIniFile& file)
 {
 	int32_t variantCount = 0;
+	loadPilots();
 	// save the player created variants
 	for (VARIANT_LIST::EIterator vIter = variants.Begin(); !vIter.IsDone(); vIter++)
 	{
@@ -966,6 +1147,7 @@ LogisticsData::load(FitIniFile& file)
 		}
 	}
 	// load pilots
+	loadPilots();
 	for (i = 0; i < pilotCount; i++)
 	{
 		sprintf(tmp, "Pilot%ld", i);
@@ -1006,6 +1188,11 @@ LogisticsData::loadVariant(FitIniFile& file)
 {
 	wchar_t tmp[256];
 	file.readIdString("Chassis", tmp, 255);
+	for (size_t i = 0; i < chassisRecords.size(); i++)
+	{
+		if (_stricmp(chassisRecords[i].fileName, tmp) == 0)
+			loadChassis(chassisRecords[i]);
+	}
 	const LogisticsChassis* pChassis = nullptr;
 	// go out and find that chassis
 	for (VARIANT_LIST::EIterator vIter = variants.Begin(); !vIter.IsDone(); vIter++)
@@ -1058,29 +1245,26 @@ LogisticsData::loadMech(FitIniFile& file, int32_t& count)
 {
 	wchar_t tmp[256];
 	file.readIdString("Variant", tmp, 255);
-	for (VARIANT_LIST::EIterator mIter = variants.Begin(); !mIter.IsDone(); mIter++)
+	LogisticsVariant* pVariant = getVariant(tmp);
+	if (!pVariant)
+		return -1; // failed in finding the variant
+	LogisticsMech* pMech = new LogisticsMech(pVariant, count);
+	file.readIdString("Pilot", tmp, 255);
+	inventory.Append(pMech);
+	loadPilots();
+	for (PILOT_LIST::EIterator pIter = pilots.Begin(); !pIter.IsDone(); pIter++)
 	{
-		if ((*mIter)->getName().Compare(tmp, 0) == 0)
+		if ((*pIter).getFileName().Compare(tmp, 0) == 0)
 		{
-			LogisticsMech* pMech = new LogisticsMech((*mIter), count);
-			file.readIdString("Pilot", tmp, 255);
-			inventory.Append(pMech);
-			for (PILOT_LIST::EIterator pIter = pilots.Begin(); !pIter.IsDone(); pIter++)
-			{
-				if ((*pIter).getFileName().Compare(tmp, 0) == 0)
-				{
-					pMech->setPilot(&(*pIter));
-					count++;
-					if (count > -1 && count < 13)
-						pMech->setForceGroup(count);
-					break;
-				}
-			}
-			// it could have had no pilot
-			return 0;
+			pMech->setPilot(&(*pIter));
+			count++;
+			if (count > -1 && count < 13)
+				pMech->setForceGroup(count);
+			break;
 		}
 	}
-	return -1; // failed in finding the variant
+	// it could have had no pilot
+	return 0;
 }
 
 void
@@ -1090,6 +1274,7 @@ LogisticsData::setMissionCompleted()
 	const std::wstring_view& pMissionName = missionInfo->getCurrentMission();
 	missionInfo->setMissionComplete();
 	rpJustAdded = 0;
+	loadPilots();
 	// first set all pilots as not just dead
 	for (PILOT_LIST::EIterator iter = pilots.Begin(); !iter.IsDone(); iter++)
 	{
@@ -1204,6 +1389,7 @@ LogisticsData::removeMechFromInventory(const std::wstring_view& mechName, const
 LogisticsPilot*
 LogisticsData::getPilot(const std::wstring_view& pilotName)
 {
+	loadPilots();
 	// look for available ones first
 	PILOT_LIST::EIterator iter;
 	for (iter = pilots.Begin(); !iter.IsDone(); iter++)
@@ -1229,11 +1415,16 @@ LogisticsData::getPilot(const std::wstring_view& pilotName)
 LogisticsVariant*
 LogisticsData::getVariant(const std::wstring_view& mechName)
 {
-	for (VARIANT_LIST::EIterator iter = variants.Begin(); !iter.IsDone(); iter++)
+	// only a chassis' csv knows its variants' names, so look through
+	// what's in first and read the rest only if it isn't there
+	do
 	{
-		if ((*iter)->getName().Compare(mechName, 0) == 0)
-			return (*iter);
-	}
+		for (VARIANT_LIST::EIterator iter = variants.Begin(); !iter.IsDone(); iter++)
+		{
+			if ((*iter)->getName().Compare(mechName, 0) == 0)
+				return (*iter);
+		}
+	} while (loadAllChassis());
 	return nullptr;
 }
 
@@ -1250,15 +1441,9 @@ LogisticsData::updateAvailability()
 	}
 	int32_t oldMechAvailableCount = 0;
 	int32_t newMechAvailableCount = 0;
-	int32_t oldPilotAvailableCount = 0;
+	int32_t oldPilotAvailableCount = getAvailablePilotCount();
 	int32_t newPilotAvailableCount = 0;
-	PILOT_LIST::EIterator pIter;
-	for (pIter = pilots.Begin(); !pIter.IsDone(); pIter++)
-	{
-		if ((*pIter).bAvailable)
-			oldPilotAvailableCount++;
-		(*pIter).setAvailable(0);
-	}
+	clearPilotsAvailable();
 	// make sure its around and you can open it
 	FitIniFile file;
 	if (NO_ERROR != file.open((const std::wstring_view&)(const std::wstring_view&)purchaseFileName))
@@ -1337,6 +1522,9 @@ LogisticsData::updateAvailability()
 		sprintf(tmp, "Mech%ld", i);
 		if (NO_ERROR != file.readIdString(tmp, chassisFileName, 254))
 			break;
+		ChassisRecord* pRecord = findChassis(chassisFileName);
+		if (pRecord)
+			loadChassis(*pRecord);
 		// go through each variant, if it has the same chassis, check and see if
 		// all of its components are valid
 		for (vIter = variants.Begin(); !vIter.IsDone(); vIter++)
@@ -1382,19 +1570,9 @@ LogisticsData::updateAvailability()
 		sprintf(tmp, "Pilot%ld", i);
 		if (NO_ERROR != file.readIdString(tmp, pilotName, 254))
 			break;
-		for (PILOT_LIST::EIterator pIter = pilots.Begin(); !pIter.IsDone(); pIter++)
-		{
-			if ((*pIter).getFileName().Compare(pilotName, 0) == 0)
-			{
-				(*pIter).setAvailable(true);
-			}
-		}
-	}
-	for (pIter = pilots.Begin(); !pIter.IsDone(); pIter++)
-	{
-		if ((*pIter).bAvailable)
-			newPilotAvailableCount++;
+		setPilotAvailable(pilotName);
 	}
+	newPilotAvailableCount = getAvailablePilotCount();
 	if (oldPilotAvailableCount != newPilotAvailableCount && newPilotAvailableCount > oldPilotAvailableCount)
 		bNewPilots = true;
 	else
@@ -1441,14 +1619,8 @@ LogisticsData::appendAvailability(const std::wstring_view& pFileName, bool* avai
 		sprintf(tmp, "Pilot%ld", i);
 		if (NO_ERROR != file.readIdString(tmp, pilotName, 254))
 			break;
-		for (PILOT_LIST::EIterator pIter = pilots.Begin(); !pIter.IsDone(); pIter++)
-		{
-			if ((*pIter).getFileName().Compare(pilotName, 0) == 0)
-			{
-				(*pIter).setAvailable(true);
-				bNewPilots = true;
-			}
-		}
+		if (setPilotAvailable(pilotName))
+			bNewPilots = true;
 	}
 	file.seekBlock("Mechs");
 	int32_t newAvailableCount = 0;
@@ -1458,6 +1630,9 @@ LogisticsData::appendAvailability(const std::wstring_view& pFileName, bool* avai
 		sprintf(tmp, "Mech%ld", i);
 		if (NO_ERROR != file.readIdString(tmp, chassisFileName, 255))
 			break;
+		ChassisRecord* pRecord = findChassis(chassisFileName);
+		if (pRecord)
+			loadChassis(*pRecord);
 		// go through each variant, if it has the same chassis, check and see if
 		// all of its components are valid
 		for (VARIANT_LIST::EIterator vIter = variants.Begin(); !vIter.IsDone(); vIter++)
@@ -1539,11 +1714,13 @@ LogisticsData::clearInventory()
 int32_t
 LogisticsData::getPilotCount()
 {
+	loadPilots();
 	return pilots.Count();
 }
 int32_t
 LogisticsData::getPilots(LogisticsPilot** pArray, int32_t& count)
 {
+	loadPilots();
 	if (count < pilots.Count())
 	{
 		return NEED_BIGGER_ARRAY;
@@ -1710,7 +1887,7 @@ decryptFile(const std::wstring_view& inputFile, const std::wstring_view& outputF
 		LZData = (uint8_t*)malloc(lzSize);
 		dataFile.read(LZData, lzSize);
 		uint32_t testSize = fileSize;
-		uint32_t test2Size = LZDecomp(zlibData, LZData, lzSize);
+		uint32_t test2Size = LZDecomp(zlibData, zlibSize, LZData, lzSize);
 		if (test2Size != zlibSize)
 			STOP(("Didn't Decompress to same size as started with!!"));
 		uncompress((uint8_t*)rawData, &testSize, zlibData, zlibSize);
@@ -1855,6 +2032,7 @@ LogisticsData::canReplaceVariant(const std::wstring_view& name)
 	}
 	if (nameCount > 1)
 		return 0;
+	loadAllChassis();
 	for (VARIANT_LIST::EIterator vIter = variants.Begin(); !vIter.IsDone(); vIter++)
 	{
 		if ((*vIter)->isDesignerMech() && (*vIter)->getName().Compare(name, 0) == 0)
@@ -2053,6 +2231,7 @@ LogisticsData::getPlayerVariantNames(const std::wstring_view&* array, int32_t& c
 int32_t
 LogisticsData::getEncyclopediaMechs(const LogisticsVariant** pChassis, int32_t& count)
 {
+	loadAllChassis();
 	int32_t retVal = 0;
 	int32_t maxCount = count;
 	count = 0;
@@ -2073,6 +2252,7 @@ LogisticsData::getEncyclopediaMechs(const LogisticsVariant** pChassis, int32_t&
 int32_t
 LogisticsData::getHelicopters(const LogisticsVariant** pChassis, int32_t& count)
 {
+	loadAllChassis();
 	int32_t retVal = 0;
 	int32_t maxCount = count;
 	count = 0;
@@ -2387,4 +2567,100 @@ LogisticsData::getCurrentMissionNum(void)
 	return missionInfo->getCurrentMissionNumber();
 }
 
+//----------------------------------------------------------------------
+// Read ahead.  The thread only ever reads files through; the records
+// are built here, on the caller's thread, a pilot a frame.
+void
+LogisticsData::startPrefetch()
+{
+	prefetchRunning = true;
+	prefetchThread = std::thread(&LogisticsData::prefetchMain, this);
+}
+
+void
+LogisticsData::stopPrefetch()
+{
+	if (!prefetchThread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(prefetchLock);
+		prefetchRunning = false;
+		prefetchQueue.clear();
+	}
+	prefetchWake.notify_all();
+	prefetchThread.join();
+}
+
+void
+LogisticsData::prefetchMain()
+{
+	std::unique_lock<std::mutex> lock(prefetchLock);
+	for (;;)
+	{
+		while (prefetchRunning && prefetchQueue.empty())
+			prefetchWake.wait(lock);
+		if (!prefetchRunning)
+			break;
+		LogisticsPrefetch request = prefetchQueue.front();
+		prefetchQueue.pop_front();
+		if (!prefetchBudgetLeft)
+		{
+			// left for whoever asks for it
+			LogisticsDataStatistics.numPrefetchesDropped++;
+			continue;
+		}
+		lock.unlock();
+		size_t bytesRead = LoadGraphWarmFile(request.fileName);
+		lock.lock();
+		prefetchBudgetLeft -= (bytesRead < prefetchBudgetLeft) ? bytesRead : prefetchBudgetLeft;
+		LogisticsDataStatistics.numPrefetches++;
+		LogisticsDataStatistics.bytesPrefetched += bytesRead;
+		prefetchDone.push_back(request);
+	}
+}
+
+//----------------------------------------------------------------------
+// The pilot screens come after the mech screens; those ask for the
+// pilots not in yet as they start.
+void
+LogisticsData::prefetchPilots()
+{
+	if (!prefetchThread.joinable() || numPilotsLoaded == (int32_t)pilotRecords.size())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(prefetchLock);
+		prefetchQueue.clear();
+		prefetchBudgetLeft = LogisticsPrefetchBudget;
+		for (size_t i = numPilotsLoaded; i < pilotRecords.size(); i++)
+		{
+			LogisticsPrefetch request;
+			request.record = i;
+			request.generation = pilotGeneration;
+			strcpy(request.fileName, warriorPath);
+			strcat(request.fileName, pilotRecords[i].fileName);
+			strcat(request.fileName, ".fit");
+			prefetchQueue.push_back(request);
+		}
+	}
+	prefetchWake.notify_one();
+}
+
+void
+LogisticsData::updatePrefetch()
+{
+	LogisticsPrefetch request;
+	{
+		std::lock_guard<std::mutex> lock(prefetchLock);
+		if (prefetchDone.empty())
+			return;
+		request = prefetchDone.front();
+		prefetchDone.pop_front();
+	}
+	if (request.generation != pilotGeneration || request.record < numPilotsLoaded)
+		return;
+	// pilots go in in order, any before it go in with it
+	loadPilots(request.record + 1);
+	LogisticsDataStatistics.numPrefetchHits++;
+}
+
 // end of file ( LogisticsData.cpp )
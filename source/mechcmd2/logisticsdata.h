@@ -17,10 +17,53 @@ thing holds the inventory lists and the component lists
 //#include "logisticscomponent.h"
 //#include "logisticspilot.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 class FitIniFile;
 class LogisticsMissionInfo;
 class PacketFile;
 
+//---------------------------------------------------------------------------
+// init only indexes the mechs and pilots: the chassis list and the pilot
+// list.  A chassis' csv (and its variants) or a pilot's fit is read the
+// first time something asks for it.  Anything that has to see every one
+// of them (the encyclopedia, a variant looked up by name) loads the rest.
+//
+// A screen can ask for what it will show next ahead of time.  A thread
+// reads those files through, up to the prefetch budget; the records are
+// then built one per frame from updatePrefetch, on the calling thread.
+// Records are never thrown away again -- the screens and the inventory
+// hold on to them -- so the budget holds the read ahead, not the records.
+
+#define DEFAULT_LOGISTICS_PREFETCH_BUDGET (1024 * 1024)
+
+typedef struct _LogisticsPrefetch
+{
+	int32_t record;
+	uint32_t generation; // index it was asked for against
+	wchar_t fileName[256];
+} LogisticsPrefetch;
+
+typedef struct _LogisticsDataStats
+{
+	uint32_t numChassisIndexed;
+	uint32_t numChassisLoaded;
+	uint32_t numPilotsIndexed;
+	uint32_t numPilotsLoaded;
+	uint32_t numPrefetches; // records read ahead
+	uint32_t numPrefetchesDropped; // asked for with the budget spent
+	uint32_t numPrefetchHits; // records built from a read ahead
+	uint32_t bytesPrefetched;
+} LogisticsDataStats;
+
+extern bool LogisticsDataLazy;
+extern size_t LogisticsPrefetchBudget;
+extern LogisticsDataStats LogisticsDataStatistics;
+
 class LogisticsData
 {
 
@@ -197,6 +240,9 @@ public:
 	bool getVideoShown(void);
 	void setVideoShown(void);
 
+	void prefetchPilots(void);
+	void updatePrefetch(void);
+
 	struct Building
 	{
 		int32_t nameID;
@@ -233,6 +279,35 @@ private:
 
 	int32_t resourcePoints; // C-Bills for buying mechs
 
+	struct ChassisRecord
+	{
+		wchar_t fileName[256]; // full path of its csv, lower case
+		int32_t chassisID;
+		int32_t fitID;
+		float scale;
+		LogisticsChassis* chassis; // nullptr until it is loaded
+	};
+
+	struct PilotRecord
+	{
+		wchar_t fileName[64];
+		int32_t id;
+		bool available; // until it is loaded, then the pilot has it
+	};
+
+	std::vector<ChassisRecord> chassisRecords;
+	std::vector<PilotRecord> pilotRecords;
+	int32_t numPilotsLoaded; // pilots are loaded in order
+	uint32_t pilotGeneration; // bumped each time the pilots are indexed
+
+	std::thread prefetchThread;
+	std::mutex prefetchLock;
+	std::condition_variable prefetchWake;
+	std::deque<LogisticsPrefetch> prefetchQueue;
+	std::deque<LogisticsPrefetch> prefetchDone;
+	size_t prefetchBudgetLeft;
+	bool prefetchRunning;
+
 	int32_t loadVariant(FitIniFile& file);
 
 	// HELPERS
@@ -247,6 +322,19 @@ private:
 	int32_t addBuilding(int32_t fitID, PacketFile& objectFile, float scale);
 	void removeDeadWeight(void);
 	void clearVariants(void);
+
+	void loadChassis(ChassisRecord& record, bool sort = true);
+	bool loadAllChassis(void);
+	ChassisRecord* findChassis(const std::wstring_view& chassisFileName);
+	void sortVariants(void);
+	void loadPilots(int32_t count = -1);
+	bool setPilotAvailable(const std::wstring_view& pilotFileName);
+	void clearPilotsAvailable(void);
+	int32_t getAvailablePilotCount(void);
+
+	void startPrefetch(void);
+	void stopPrefetch(void);
+	void prefetchMain(void);
 };
 
 #endif // end of file ( LogisticsData.h )
@@ -583,6 +583,7 @@ BattleMechType::init(void)
 	explRad = 0.0;
 	LOSFactor = 1.0f;
 	destructDamage = 0.0f;
+	profileName[0] = 0;
 }
 
 //--------------------------------------------------------------------------
@@ -602,6 +603,8 @@ BattleMechType::init(std::unique_ptr<File> objFile, uint32_t fileSize)
 	result = mechFile.readIdString("ProfileName", fileType, 511);
 	if (result != NO_ERROR)
 		return (result);
+	strncpy(profileName, fileType, 79);
+	profileName[79] = 0;
 	result = mechFile.readIdLong("MoveType", moveType);
 	if (result != NO_ERROR)
 		moveType = MOVETYPE_GROUND;
@@ -652,6 +655,19 @@ BattleMechType::init(std::unique_ptr<File> objFile, uint32_t fileSize)
 	return (result);
 }
 
+//-----------------------------------------------------------------------------------
+// init reads the mech CSV as well as the packet, so a cooked mech is only
+// good while the CSV is what it was cooked from too.
+bool
+BattleMechType::getDependency(wchar_t* fileName, size_t bufferSize)
+{
+	FullPathFileName mechCSVName;
+	mechCSVName.init(objectPath, profileName, ".csv");
+	strncpy(fileName, mechCSVName, bufferSize - 1);
+	fileName[bufferSize - 1] = 0;
+	return (true);
+}
+
 //-----------------------------------------------------------------------------------
 
 void
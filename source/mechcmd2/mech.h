@@ -226,6 +226,8 @@ public:
 	float LOSFactor;
 	float destructDamage;
 
+	wchar_t profileName[80]; // the mech CSV this type was read from
+
 	//----------------
 	// Member Functions
 
@@ -240,6 +242,9 @@ public:
 
 	virtual int32_t init(std::unique_ptr<File> objFile, uint32_t fileSize);
 
+	virtual size_t getCookedSize(void) { return (sizeof(BattleMechType)); }
+	virtual bool getDependency(wchar_t* fileName, size_t bufferSize);
+
 	virtual GameObjectPtr createInstance(void);
 
 	virtual void destroy(void);
@@ -127,6 +127,7 @@ MechBayScreen::begin()
 	pDragMech = nullptr;
 	mechListBox.removeAllItems(true);
 	reinitMechs();
+	LogisticsData::instance->prefetchPilots();
 	int32_t mechCount[256];
 	memset(mechCount, 0, sizeof(int32_t) * 256);
 	bool bCurMechIsValid = 0;
@@ -291,6 +292,7 @@ MechBayScreen::drawWeightMeter(int32_t xOffset, int32_t yOffset)
 void
 MechBayScreen::update()
 {
+	LogisticsData::instance->updatePrefetch();
 	mechListBox.disableItemsThatCanNotGoInFG();
 	if (!pIcons[0].getMech())
 		getButton(MB_MSG_REMOVE)->disable(true);
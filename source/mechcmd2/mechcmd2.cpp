@@ -100,6 +100,8 @@ uint32_t missionHeapSize = 3072000;
 uint32_t spriteDataHeapSize = 2048000;
 uint32_t spriteHeapSize = 8192000;
 uint32_t polyHeapSize = 1024000;
+uint32_t frameArenaSize = 8388608;
+uint32_t frameOverflowSize = 2097152;
 
 extern float ProcessorSpeed;
 void __stdcall ExitGameOS();
@@ -197,6 +199,19 @@ LineElement* debugLines[10000];
 	y;                    \
 	x = GetCycles() - x;
 extern int64_t MCTimeMultiplayerUpdate;
+extern int64_t MCTimeBootRenderer;
+extern int64_t MCTimeBootEffects;
+extern int64_t MCTimeBootTextures;
+extern int64_t MCTimeBootCursors;
+extern int64_t MCTimeBootSound;
+extern int64_t MCTimeBootInterface;
+extern int64_t MCTimeBootStart;
+extern int64_t MCTimeBootShapes;
+extern int64_t MCTimeBootDialogs;
+extern int64_t MCTimeBootTotal;
+extern int64_t MCTimeBootCriticalPath;
+extern int64_t MCTimeBootStall;
+extern float OneOverProcessorSpeed;
 #else
 #define ProfileTime(x, y) y;
 #endif
@@ -210,6 +225,8 @@ OptionsScreenWrapper* optionsScreenWrapper = nullptr;
 bool bInvokeOptionsScreenFlag = false;
 
 bool SnifferMode = false;
+int32_t ABLProfileInterval = 0; // statements per ABL profiler sample, 0 = off
+wchar_t BootTimelinePath[80] = {0}; // where to write the boot's task timeline
 gos_VERTEX* testVertex = nullptr;
 uint16_t* indexArray = nullptr;
 uint32_t testTextureHandle = 0xffffffff;
@@ -999,6 +1016,11 @@ InitializeGameEngine()
 
 				result = systemFile->readIdULong("logisticsHeapSize", logisticsHeapSize);
 				gosASSERT(SUCCEEDED(result));
+
+				// Optional.  frameArenaSize is each of the frame arena's two
+				// buffers, frameOverflowSize the heap it falls back on.
+				systemFile->readIdULong("frameArenaSize", frameArenaSize);
+				systemFile->readIdULong("frameOverflowSize", frameOverflowSize);
 			}
 
 #ifdef _DEBUG
@@ -1071,6 +1093,114 @@ InitializeGameEngine()
 				int32_t result = systemFile->readIdLong("NumFastFiles", maxFastFiles);
 				if (FAILED(result))
 					maxFastFiles = 0;
+				//-----------------------------------------------------
+				// Fastfiles are memory mapped unless MapFastFiles = 0,
+				// which falls back to reading them through a stream...
+				bool mapFastFiles = true;
+				if (SUCCEEDED(systemFile->readIdBoolean("MapFastFiles", mapFastFiles)))
+					FastFileUseMapping = mapFastFiles;
+				//-----------------------------------------------------
+				// IndexIniFiles = 0 goes back to scanning every block
+				// line by line, to time one against the other...
+				bool indexIniFiles = true;
+				if (SUCCEEDED(systemFile->readIdBoolean("IndexIniFiles", indexIniFiles)))
+					FitIniUseIndex = indexIniFiles;
+				//-----------------------------------------------------
+				// CSV tables are split once on open.  SplitCSVFiles = 0
+				// goes back to reading a line per cell.  CSVCachePath
+				// names a directory to keep the split tables in, so
+				// the next run doesn't have to split them again.
+				bool splitCSVFiles = true;
+				if (SUCCEEDED(systemFile->readIdBoolean("SplitCSVFiles", splitCSVFiles)))
+					CSVFileUseCells = splitCSVFiles;
+				if (systemFile->readIdString("CSVCachePath", CSVCachePath, 79) != NO_ERROR)
+					CSVCachePath[0] = 0;
+				//-----------------------------------------------------
+				// Object types load from their cooked records when
+				// there is one that still matches the object file.
+				// CookObjectTypes rebuilds the records on the first
+				// mission load, ValidateCookedObjectTypes loads every
+				// cooked type from its ini too and compares.
+				bool useCookedObjectTypes = true;
+				if (SUCCEEDED(systemFile->readIdBoolean("UseCookedObjectTypes", useCookedObjectTypes)))
+					ObjectTypeUseCooked = useCookedObjectTypes;
+				bool cookObjectTypes = false;
+				if (SUCCEEDED(systemFile->readIdBoolean("CookObjectTypes", cookObjectTypes)))
+					ObjectTypeCookOnLoad = cookObjectTypes;
+				bool validateCookedObjectTypes = false;
+				if (SUCCEEDED(systemFile->readIdBoolean("ValidateCookedObjectTypes", validateCookedObjectTypes)))
+					ObjectTypeValidateCooked = validateCookedObjectTypes;
+				//-----------------------------------------------------
+				// Packet files are read and unpacked on the packet
+				// reader's threads.  PacketReadBudget is in KB, 0
+				// turns it off.  The reader never goes through a
+				// fastfile, so mapped or streamed doesn't matter...
+				int32_t packetReadBudget = DEFAULT_PACKET_READ_BUDGET / 1024;
+				int32_t packetReadWorkers = -1;
+				systemFile->readIdLong("PacketReadBudget", packetReadBudget);
+				systemFile->readIdLong("PacketReadWorkers", packetReadWorkers);
+				if (packetReadBudget > 0)
+					PacketReaderInit(packetReadWorkers, (size_t)packetReadBudget * 1024);
+				//-----------------------------------------------------
+				// Boot and mission loads run as graphs of tasks.
+				// LoadSerial runs every task on the loading thread,
+				// LoadWorkers caps the pool (-1 picks).  LoadTimeline
+				// and BootTimeline name files to write each load's
+				// and the boot's task timelines to.
+				bool loadSerial = false;
+				if (SUCCEEDED(systemFile->readIdBoolean("LoadSerial", loadSerial)))
+					LoadGraphSerial = loadSerial;
+				systemFile->readIdLong("LoadWorkers", LoadGraphWorkers);
+				if (systemFile->readIdString("LoadTimeline", LoadTimelinePath, 79) != NO_ERROR)
+					LoadTimelinePath[0] = 0;
+				if (systemFile->readIdString("BootTimeline", BootTimelinePath, 79) != NO_ERROR)
+					BootTimelinePath[0] = 0;
+				//-----------------------------------------------------
+				// TileMapData keeps the terrain mesh in packed tiles,
+				// unpacking only what is near the camera and movers.
+				// MapTileBudget is in KB of unpacked tiles.
+				bool tileMapData = false;
+				if (SUCCEEDED(systemFile->readIdBoolean("TileMapData", tileMapData)))
+					MapDataUseTiles = tileMapData;
+				int32_t mapTileBudget = DEFAULT_MAP_TILE_BUDGET / 1024;
+				if (systemFile->readIdLong("MapTileBudget", mapTileBudget) == NO_ERROR && mapTileBudget > 0)
+					MapTileBudget = (size_t)mapTileBudget * 1024;
+				//-----------------------------------------------------
+				// LazyLogistics reads mechs and pilots as the logistics
+				// screens ask for them instead of all up front, and
+				// LogisticsPrefetchBudget (KB) caps each read ahead.
+				bool lazyLogistics = true;
+				if (SUCCEEDED(systemFile->readIdBoolean("LazyLogistics", lazyLogistics)))
+					LogisticsDataLazy = lazyLogistics;
+				int32_t logisticsPrefetchBudget = DEFAULT_LOGISTICS_PREFETCH_BUDGET / 1024;
+				if (systemFile->readIdLong("LogisticsPrefetchBudget", logisticsPrefetchBudget) == NO_ERROR && logisticsPrefetchBudget >= 0)
+					LogisticsPrefetchBudget = (size_t)logisticsPrefetchBudget * 1024;
+				//-----------------------------------------------------
+				// HeapThreadCaches gives each thread a cache of small
+				// blocks on every heap, with a lock behind it.  The
+				// system heap is already up, so it's switched here.
+				// HeapTrace names a file to record every malloc and
+				// free to, for heapbench to replay.
+				bool heapThreadCaches = false;
+				if (SUCCEEDED(systemFile->readIdBoolean("HeapThreadCaches", heapThreadCaches)))
+					UserHeapThreadCaches = heapThreadCaches;
+				systemHeap->setThreadCaches(UserHeapThreadCaches);
+				if (systemFile->readIdString("HeapTrace", HeapTracePath, 79) != NO_ERROR)
+					HeapTracePath[0] = 0;
+				//-----------------------------------------------------
+				// HeapTagging tags every block with the subsystem and
+				// callsite that asked for it, and has each mission end
+				// with a leak report.  HeapTelemetry names a .csv or
+				// .json file to snapshot the heaps to every
+				// HeapTelemetryInterval seconds.
+				bool heapTagging = false;
+				if (SUCCEEDED(systemFile->readIdBoolean("HeapTagging", heapTagging)))
+					UserHeapTagging = heapTagging;
+				if (systemFile->readIdString("HeapTelemetry", HeapTelemetryPath, 79) != NO_ERROR)
+					HeapTelemetryPath[0] = 0;
+				int32_t heapTelemetryInterval = HeapTelemetryInterval;
+				if (systemFile->readIdLong("HeapTelemetryInterval", heapTelemetryInterval) == NO_ERROR && heapTelemetryInterval > 0)
+					HeapTelemetryInterval = heapTelemetryInterval;
 
 #if CONSIDERED_OBSOLETE
 				if (maxFastFiles)
@@ -1151,6 +1281,18 @@ InitializeGameEngine()
 		delete systemFile;
 		systemFile = nullptr;
 
+		if (HeapTracePath[0])
+			UserHeapTraceStart(HeapTracePath);
+		if (HeapTelemetryPath[0])
+			globalHeapList->startTelemetry(HeapTelemetryPath, HeapTelemetryInterval * 1000);
+
+		//--------------------------------------------------------------
+		// Start the Frame Arena.  TGL transforms and the texture
+		// manager's draw lists get their memory from it every frame.
+		frameArena = new FrameArena;
+		gosASSERT(frameArena != nullptr);
+		frameArena->init(frameArenaSize, frameOverflowSize, "FrameArena");
+
 		if (initGameLogs)
 		{
 			GameLog::setup();
@@ -1442,6 +1584,60 @@ InitializeGameEngine()
 		//		DEBUG_STREAM << thing_you_want_to_output
 		//
 		// IMPORTANT NOTE:
+
+		//---------------------------------------------------------------
+		// Boot as a graph of its steps, the same as a mission load.  Each
+		// step registers with managers that sit on the gos heap stack and
+		// our own heaps, none of which may be touched by two threads at
+		// once, so the steps stay on this thread and in this order.  The
+		// pool reads the files they open through ahead of them, and the
+		// graph times each one so what is left serial shows up.
+		FullPathFileName warmEffectsNames[2];
+		warmEffectsNames[0].init(effectsPath, "mc2.fx", "");
+		warmEffectsNames[1].init(objectPath, "Effects", ".csv");
+		FullPathFileName warmCursorsName;
+		warmCursorsName.init(artPath, "cursors", ".fit");
+		FullPathFileName warmSoundNames[3];
+		warmSoundNames[0].init(soundPath, "sound", ".snd");
+		warmSoundNames[1].init(CDsoundPath, "sound", ".pak");
+		warmSoundNames[2].init(CDsoundPath, "Betty", ".pak");
+		float bootProgress = 0.0f;
+		LoadGraph bootGraph;
+		bootGraph.addTask("Warm Effects", 0.0f, [&]() {
+			for (size_t i = 0; i < 2; i++)
+				LoadGraphWarmFile(warmEffectsNames[i]);
+		});
+		bootGraph.addTask("Warm Cursors", 0.0f, [&]() { LoadGraphWarmFile(warmCursorsName); });
+		bootGraph.addTask("Warm Sound", 0.0f, [&]() {
+			for (size_t i = 0; i < 3; i++)
+				LoadGraphWarmFile(warmSoundNames[i]);
+		});
+		int32_t rendererTask = bootGraph.addTask("Renderer", 1.0f);
+		int32_t effectsTask = bootGraph.addTask("Effects", 2.0f);
+		bootGraph.addDependency(effectsTask, rendererTask);
+		int32_t textureTask = bootGraph.addTask("Textures", 1.0f);
+		int32_t cursorTask = bootGraph.addTask("Cursors", 1.0f);
+		bootGraph.addDependency(cursorTask, textureTask);
+		int32_t soundTask = bootGraph.addTask("Sound", 2.0f);
+		int32_t interfaceTask = bootGraph.addTask("Interface", 1.0f);
+		int32_t startTask = bootGraph.addTask("Start", 4.0f);
+		bootGraph.addDependency(startTask, effectsTask);
+		bootGraph.addDependency(startTask, cursorTask);
+		bootGraph.addDependency(startTask, soundTask);
+		bootGraph.addDependency(startTask, interfaceTask);
+		int32_t shapeTask = bootGraph.addTask("Shapes", 4.0f);
+		bootGraph.addDependency(shapeTask, startTask);
+		int32_t dialogTask = bootGraph.addTask("Dialogs", 1.0f);
+		bootGraph.addDependency(dialogTask, shapeTask);
+		//---------------------------------------------------------------
+		// start() clears the graph's stats, so keep the mission load's
+		// for the Load block before the boot takes them over.
+#ifdef LAB_ONLY
+		LoadGraphStats missionLoadStats = LoadGraphStatistics;
+#endif
+		bootGraph.start(bootProgress, 0.0f, 100.0f);
+
+		bootGraph.beginTask(rendererTask);
 		Stuff::InitializeClasses();
 		MidLevelRenderer::InitializeClasses(8192 * 4, 8192, 0, 0, true);
 		gosFX::InitializeClasses();
@@ -1456,9 +1652,11 @@ InitializeGameEngine()
 		theClipper = new MidLevelRenderer::MLRClipper(0, cameraSorter);
 
 		gos_PopCurrentHeap();
+		bootGraph.finishTask(rendererTask);
 
 		//------------------------------------------------------
 		// Start the GOS FX.
+		bootGraph.beginTask(effectsTask);
 		gos_PushCurrentHeap(gosFX::Heap);
 
 		gosFX::EffectLibrary::Instance = new gosFX::EffectLibrary();
@@ -1485,9 +1683,11 @@ InitializeGameEngine()
 		gos_PopCurrentHeap();
 
 		systemHeap->Free(effectsData);
+		bootGraph.finishTask(effectsTask);
 
 		//--------------------------------------------------------------
 		// Start the GUI Heap.
+		bootGraph.beginTask(textureTask);
 		guiHeap = new UserHeap;
 		gosASSERT(guiHeap != nullptr);
 
@@ -1497,22 +1697,28 @@ InitializeGameEngine()
 		// Fire up the MC Texture Manager.
 		mcTextureManager = new MC_TextureManager;
 		mcTextureManager->start();
+		bootGraph.finishTask(textureTask);
 
 		//--------------------------------------------------------------
 		// Load up the mouse cursors
+		bootGraph.beginTask(cursorTask);
 		userInput->initMouseCursors("cursors");
 		userInput->mouseOff();
 		userInput->setMouseCursor(mState_NORMAL);
+		bootGraph.finishTask(cursorTask);
 
 		//------------------------------------------------
 		// Give the Sound System a Whirl!
+		bootGraph.beginTask(soundTask);
 		soundSystem = new GameSoundSystem;
 		soundSystem->init();
 		((SoundSystem*)soundSystem)->init("sound");
 		sndSystem = soundSystem; // for things in the lib that use sound
+		bootGraph.finishTask(soundTask);
 
 		//-----------------------------------------------
 		// Only used by camera to retrieve screen coords.
+		bootGraph.beginTask(interfaceTask);
 		globalPane = new PANE;
 		globalWindow = new WINDOW;
 
@@ -1554,7 +1760,9 @@ InitializeGameEngine()
 #ifdef USE_movie
 		movieSoundUseDirectSound(0);
 #endif
+		bootGraph.finishTask(interfaceTask);
 
+		bootGraph.beginTask(startTask);
 		if (justStartMission)
 		{
 			logistics->setLogisticsState(log_STARTMISSIONFROMCMDLINE);
@@ -1571,10 +1779,38 @@ InitializeGameEngine()
 			if (MPlayer && MPlayer->launchedFromLobby)
 				param = log_ZONE;
 			logistics->start(param); // Always start with logistics in Splash Screen Mode
-			Mission::initBareMinimum();
 		}
+		bootGraph.finishTask(startTask);
+		bootGraph.beginTask(shapeTask);
+		if (!justStartMission)
+			Mission::initBareMinimum();
+		bootGraph.finishTask(shapeTask);
 
+		bootGraph.beginTask(dialogTask);
 		initDialogs();
+		bootGraph.finishTask(dialogTask);
+
+		//---------------------------------------------------------------
+		// Everything the first frame needs is in.  The graph's stats are
+		// the boot's now; put back the mission load's for the Load block.
+		bootGraph.finish();
+		if (BootTimelinePath[0])
+			bootGraph.writeTimeline(BootTimelinePath);
+#ifdef LAB_ONLY
+		MCTimeBootRenderer = bootGraph.getTaskCycles(rendererTask) * OneOverProcessorSpeed;
+		MCTimeBootEffects = bootGraph.getTaskCycles(effectsTask) * OneOverProcessorSpeed;
+		MCTimeBootTextures = bootGraph.getTaskCycles(textureTask) * OneOverProcessorSpeed;
+		MCTimeBootCursors = bootGraph.getTaskCycles(cursorTask) * OneOverProcessorSpeed;
+		MCTimeBootSound = bootGraph.getTaskCycles(soundTask) * OneOverProcessorSpeed;
+		MCTimeBootInterface = bootGraph.getTaskCycles(interfaceTask) * OneOverProcessorSpeed;
+		MCTimeBootStart = bootGraph.getTaskCycles(startTask) * OneOverProcessorSpeed;
+		MCTimeBootShapes = bootGraph.getTaskCycles(shapeTask) * OneOverProcessorSpeed;
+		MCTimeBootDialogs = bootGraph.getTaskCycles(dialogTask) * OneOverProcessorSpeed;
+		MCTimeBootTotal = LoadGraphStatistics.totalCycles * OneOverProcessorSpeed;
+		MCTimeBootCriticalPath = LoadGraphStatistics.criticalPathCycles * OneOverProcessorSpeed;
+		MCTimeBootStall = LoadGraphStatistics.stallCycles * OneOverProcessorSpeed;
+		LoadGraphStatistics = missionLoadStats;
+#endif
 
 		gos_EnableSetting(gos_Set_LoseFocusBehavior, 2);
 
@@ -1756,8 +1992,17 @@ TerminateGameEngine()
 		}
 		delete globalFloatHelp;
 		globalFloatHelp = nullptr;
+		if (frameArena)
+		{
+			frameArena->destroy();
+			delete frameArena;
+			frameArena = nullptr;
+		}
 		//--------------------------------------------------------------
 		// End the SystemHeap and globalHeapList
+		if (globalHeapList)
+			globalHeapList->stopTelemetry();
+		UserHeapTraceStop();
 		if (systemHeap)
 		{
 			systemHeap->destroy();
@@ -1802,6 +2047,7 @@ TerminateGameEngine()
 		// Turn off the fast Files
 		//--------------------------
 		//
+		PacketReaderFini();
 		FastFileFini();
 		//
 		// Just down any global allocations
@@ -1866,7 +2112,10 @@ DoGameLogic()
 #endif
 		if (MPlayer)
 		{
-			ProfileTime(MCTimeMultiplayerUpdate, MPlayer->update());
+			{
+				HeapTagScope heapTag(HEAP_TAG_MULTIPLAYER);
+				ProfileTime(MCTimeMultiplayerUpdate, MPlayer->update());
+			}
 			if (MPlayer->waitingToStartMission)
 			{
 				if (MPlayer->startMission)
@@ -1912,7 +2161,10 @@ DoGameLogic()
 			userInput->update();
 			//----------------------------------------
 			// Update the Sound System for this frame
-			soundSystem->update();
+			{
+				HeapTagScope heapTag(HEAP_TAG_SOUND);
+				soundSystem->update();
+			}
 			//----------------------------------------
 			// Update all of the timers
 			timerManager->update();
@@ -1920,6 +2172,7 @@ DoGameLogic()
 			// Update Mission and Logistics here.
 			if (logistics)
 			{
+				HeapTagScope heapTag(HEAP_TAG_LOGISTICS);
 				int32_t result = logistics->update();
 				if (result == log_DONE)
 				{
@@ -2010,6 +2263,7 @@ DoGameLogic()
 		if (turn > 3)
 			globalHeapList->update();
 #endif
+		globalHeapList->updateTelemetry();
 		//-----------------------------------------------------
 		// Check the TimeBomb to see if we should go away
 		/*
@@ -2316,6 +2570,15 @@ ParseCommandLine(const std::wstring_view& command_line)
 		{
 			SnifferMode = true;
 		}
+		else if (strcmpi(argv[i], "-ablprofile") == 0)
+		{
+			ABLProfileInterval = ABL_PROFILE_DEFAULT_INTERVAL;
+			if (((i + 1) < n_args) && (argv[i + 1][0] != '-'))
+			{
+				i++;
+				ABLProfileInterval = textToLong(argv[i]);
+			}
+		}
 		else if (strcmpi(argv[i], "-braindead") == 0)
 		{
 			i++;
@@ -78,6 +78,7 @@ MechPurchaseScreen::init(FitIniFile& file)
 void
 MechPurchaseScreen::update()
 {
+	LogisticsData::instance->updatePrefetch();
 	if (!MPlayer || !ChatWindow::instance()->pointInside(userInput->getMouseX(), userInput->getMouseY()))
 		LogisticsScreen::update();
 	// update CBills
@@ -208,6 +209,7 @@ MechPurchaseScreen::begin()
 {
 	variantListBox.removeAllItems(true);
 	inventoryListBox.removeAllItems(true);
+	LogisticsData::instance->prefetchPilots();
 	// initialize both the inventory and icon lists
 	EList<LogisticsMech*, LogisticsMech*> mechList;
 	LogisticsData::instance->getInventory(mechList);
@@ -107,6 +107,14 @@
 #include "prefs.h"
 #endif
 
+#ifndef LOADGRAPH_H
+#include "loadgraph.h"
+#endif
+
+#ifndef FRAMEARENA_H
+#include "framearena.h"
+#endif
+
 #include "resource.h"
 
 //#include "gameos.hpp"
@@ -287,6 +295,12 @@ extern int64_t MCTimeObjectiveLoad;
 extern int64_t MCTimeCommanderLoad;
 extern int64_t MCTimeMiscLoad;
 extern int64_t MCTimeGUILoad;
+extern int64_t MCTimeTotalLoad;
+extern int64_t MCTimeObjectTypeLoad;
+extern int64_t MCTimeTypeClassLoad[NUM_OBJECT_TYPE_CLASSES];
+extern int64_t MCTimeLoadCriticalPath;
+extern int64_t MCTimeLoadStall;
+extern uint32_t MCPeakLoadWorkingSet;
 
 extern int64_t x1;
 
@@ -321,6 +335,11 @@ Mission::update(void)
 {
 	if (active)
 	{
+		//---------------------------------------------------
+		// What the frame before last got from the frame arena
+		// (TGL transforms, draw lists) goes now.
+		frameArena->newFrame();
+		HeapTagScope heapTag(HEAP_TAG_MISSION);
 		turn++;
 		memset(ObjectManager->moverLineOfSightTable, -1,
 			ObjectManager->maxMovers * ObjectManager->maxMovers);
@@ -441,10 +460,16 @@ Mission::update(void)
 #endif
 		mcTextureManager->clearArrays();
 		if (missionInterface)
+		{
+			HeapTagScope interfaceTag(HEAP_TAG_INTERFACE);
 			ProfileTime(MCTimeInterfaceUpdate, missionInterface->update());
+		}
 		ProfileTime(MCTimeCameraUpdate, eye->update());
 		missionInterface->updateVTol();
-		ProfileTime(MCTimeTerrainUpdate, land->update());
+		{
+			HeapTagScope terrainTag(HEAP_TAG_TERRAIN);
+			ProfileTime(MCTimeTerrainUpdate, land->update());
+		}
 		// ALWAYS update weather AFTER the camera.  May change the lights!
 		if (useNonWeaponEffects)
 			ProfileTime(MCTimeWeatherUpdate,
@@ -464,18 +489,27 @@ Mission::update(void)
 		// Also reset the object flags because we recalc those during geometry!
 		land->clearObjBlocksActive();
 		land->clearObjVerticesActive();
-		land->terrainTextures->update();
-		ProfileTime(MCTimeTerrainGeometry, land->geometry());
-		if (missionInterface->isPaused() && !MPlayer)
-			ObjectManager->updateAppearancesOnly(true, true, true);
-		else
-			ObjectManager->update(true, true, true);
+		{
+			HeapTagScope terrainTag(HEAP_TAG_TERRAIN);
+			land->terrainTextures->update();
+			ProfileTime(MCTimeTerrainGeometry, land->geometry());
+		}
+		{
+			HeapTagScope objectsTag(HEAP_TAG_OBJECTS);
+			if (missionInterface->isPaused() && !MPlayer)
+				ObjectManager->updateAppearancesOnly(true, true, true);
+			else
+				ObjectManager->update(true, true, true);
+		}
 		ProfileTime(MCTimeCraterUpdate, craterManager->update());
 		// Do not UPDATE the textures during a pause.
 		// This uncaches things which only objectManager->update can cache back
 		// in!!!!!
 		if (!missionInterface->isPaused() || MPlayer)
+		{
+			HeapTagScope texturesTag(HEAP_TAG_TEXTURES);
 			ProfileTime(MCTimeTXMManagerUpdate, mcTextureManager->update());
+		}
 		//--------------------------------------
 		// update sensor and contact managers...
 		if (useSensors && (!missionInterface->isPaused() || MPlayer))
@@ -486,7 +520,10 @@ Mission::update(void)
 		{
 			if (!missionInterface->isPaused() || MPlayer)
 			{
-				ProfileTime(MCTimeMissionScript, missionBrain->execute());
+				{
+					HeapTagScope scriptTag(HEAP_TAG_SCRIPT);
+					ProfileTime(MCTimeMissionScript, missionBrain->execute());
+				}
 				int32_t missionResult = missionBrain->getInteger();
 				if (missionResult == 9999)
 					return (terminationResult = 9999);
@@ -710,12 +747,6 @@ Mission::render(void)
 			eye->ambientGreen = tempAmbientLight[1];
 			eye->ambientBlue = tempAmbientLight[2];
 		}
-		// reset the TGL RAM pools.
-		colorPool->reset();
-		vertexPool->reset();
-		facePool->reset();
-		shadowPool->reset();
-		trianglePool->reset();
 	}
 	return scenarioResult;
 }
@@ -1504,8 +1535,71 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 	// Start finding the Leaks
 	// systemHeap->startHeapMallocLog();
 	// systemHeap->dumpRecordLog();
+	globalHeapList->markMission();
+	HeapTagScope heapTag(HEAP_TAG_MISSION);
+#ifdef LAB_ONLY
+	int64_t loadStart = GetCycles();
+	ObjectTypeLoadStats typeLoadStart = ObjectTypeLoadStatistics;
+#endif
 	loadProgress = 0.0f;
-	loadProgress = 1.0f;
+	//---------------------------------------------------------------
+	// The load as a graph of its steps.  The steps all work on the
+	// game heaps and globals, so they stay on this thread and in this
+	// order; the graph times them, moves the progress bar as they
+	// finish, and checks each one's inputs are done before it starts.
+	// None of them runs alongside another.  What does overlap is
+	// reading: the pool reads loose mission files through ahead of the
+	// steps that open them, and the packet reader unpacks the move
+	// data while the terrain loads.  LoadSerial = 1 in system.cfg runs
+	// the pool's share here instead.
+	FullPathFileName warmTerrainName;
+	warmTerrainName.init(missionPath, missionName, ".pak");
+	FullPathFileName warmLibraryNames[3];
+	warmLibraryNames[0].init(missionPath, "orders", ".abx");
+	warmLibraryNames[1].init(missionPath, "miscfunc", ".abx");
+	warmLibraryNames[2].init(missionPath, "corebrain", ".abx");
+	LoadGraph loadGraph;
+	loadGraph.addTask("Warm Terrain", 0.0f, [&]() { LoadGraphWarmFile(warmTerrainName); });
+	loadGraph.addTask("Warm ABL Libraries", 0.0f, [&]() {
+		for (size_t i = 0; i < 3; i++)
+			LoadGraphWarmFile(warmLibraryNames[i]);
+	});
+	int32_t ablTask = loadGraph.addTask("ABL", 3.0f);
+	int32_t gameSystemTask = loadGraph.addTask("Game System", 6.0f);
+	int32_t teamTask = loadGraph.addTask("Teams", 3.0f);
+	loadGraph.addDependency(teamTask, gameSystemTask);
+	int32_t objectTask = loadGraph.addTask("Objects", 2.0f);
+	loadGraph.addDependency(objectTask, gameSystemTask);
+	int32_t terrainTask = loadGraph.addTask("Terrain", 20.0f);
+	loadGraph.addDependency(terrainTask, objectTask);
+	int32_t moveTask = loadGraph.addTask("Move", 5.0f);
+	loadGraph.addDependency(moveTask, terrainTask);
+	int32_t missionABLTask = loadGraph.addTask("Mission ABL", 1.0f);
+	loadGraph.addDependency(missionABLTask, ablTask);
+	loadGraph.addDependency(missionABLTask, gameSystemTask);
+	int32_t warriorTask = loadGraph.addTask("Warriors", 2.0f);
+	loadGraph.addDependency(warriorTask, missionABLTask);
+	loadGraph.addDependency(warriorTask, objectTask);
+	int32_t moverPartsTask = loadGraph.addTask("Mover Parts", 25.0f);
+	loadGraph.addDependency(moverPartsTask, teamTask);
+	loadGraph.addDependency(moverPartsTask, moveTask);
+	loadGraph.addDependency(moverPartsTask, warriorTask);
+	int32_t terrainObjectTask = loadGraph.addTask("Terrain Objects", 30.0f);
+	loadGraph.addDependency(terrainObjectTask, terrainTask);
+	loadGraph.addDependency(terrainObjectTask, objectTask);
+	int32_t objectiveTask = loadGraph.addTask("Objectives", 0.25f);
+	loadGraph.addDependency(objectiveTask, moverPartsTask);
+	loadGraph.addDependency(objectiveTask, terrainObjectTask);
+	int32_t commanderTask = loadGraph.addTask("Commanders", 0.25f);
+	loadGraph.addDependency(commanderTask, teamTask);
+	loadGraph.addDependency(commanderTask, moverPartsTask);
+	int32_t miscTask = loadGraph.addTask("Weather and Camera", 0.5f);
+	loadGraph.addDependency(miscTask, terrainTask);
+	int32_t guiTask = loadGraph.addTask("GUI", 1.0f);
+	loadGraph.addDependency(guiTask, objectiveTask);
+	loadGraph.addDependency(guiTask, commanderTask);
+	loadGraph.addDependency(guiTask, miscTask);
+	loadGraph.start(loadProgress, 1.0f, 99.0f);
 	if ((loadType == MISSION_LOAD_SP_QUICKSTART) || (loadType == MISSION_LOAD_SP_LOGISTICS))
 	{
 		wchar_t teamRelationsForSP[MAX_TEAMS][MAX_TEAMS] = {{0, 2, 1, 2, 2, 2, 2, 2},
@@ -1536,18 +1630,13 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 	// Always reset turn at scenario start
 	turn = 0;
 	terminationCounterStarted = 0;
-#ifdef LAB_ONLY
-	x = GetCycles();
-#endif
 	//-----------------------
 	// Init the ABL system...
+	loadGraph.beginTask(ablTask);
 	initABL();
-#ifdef LAB_ONLY
-	x1 = GetCycles();
-	MCTimeABLLoad = x1 - x;
-#endif
+	loadGraph.finishTask(ablTask);
+	loadGraph.beginTask(gameSystemTask);
 	initBareMinimum();
-	loadProgress = 4.0f;
 	initTGLForMission();
 	//--------------------------------------------------------------
 	// Start the Mission Heap
@@ -1752,10 +1841,8 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 #endif
 		}
 	}
-#ifdef LAB_ONLY
-	x = GetCycles();
-	MCTimeMiscToTeamLoad = x - x1;
-#endif
+	loadGraph.finishTask(gameSystemTask);
+	loadGraph.beginTask(teamTask);
 	//-----------------------------------
 	// Find the SKY Number and save it.
 	// If no number, i.e. an old mission file,
@@ -1774,7 +1861,6 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 	}
 	//-----------------------------------------
 	// Begin Setting up Teams and Commanders...
-	loadProgress = 10.0f;
 	result = missionFile->seekBlock("Teams");
 	Assert(result == NO_ERROR, result, " Could not find Teams Block ");
 	for (i = 0; i < Team::numTeams; i++)
@@ -1906,10 +1992,8 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 		dropZone.x = -1.f;
 		dropZone.y = -1.f;
 	}
-#ifdef LAB_ONLY
-	x1 = GetCycles();
-	MCTimeTeamLoad = x1 - x;
-#endif
+	loadGraph.finishTask(teamTask);
+	loadGraph.beginTask(objectTask);
 	//-----------------------------------------------------------------
 	// Load the names of the scenario tunes.
 	// result = missionFile->seekBlock("Music");
@@ -1961,21 +2045,17 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 	land = new Terrain;
 	land->getcolourMapName(missionFile);
 	gosASSERT(land != nullptr);
-	loadProgress = 15.0f;
-#ifdef LAB_ONLY
-	x = GetCycles();
-	MCTimeObjectLoad = x - x1;
-#endif
+	loadGraph.finishTask(objectTask);
+	loadGraph.beginTask(terrainTask);
+	if (pakFile.getNumPackets() > 4)
+		pakFile.prefetchPackets(4, pakFile.getNumPackets() - 4);
 	int32_t terrainInitResult = land->init(&pakFile, 0, GameVisibleVertices, loadProgress, 20.0);
 	if (terrainInitResult != NO_ERROR)
 	{
 		STOP(("Could not load terrain.  Probably size was wrong!"));
 	}
-	loadProgress = 35.0f;
-#ifdef LAB_ONLY
-	x1 = GetCycles();
-	MCTimeTerrainLoad = x1 - x;
-#endif
+	loadGraph.finishTask(terrainTask);
+	loadGraph.beginTask(moveTask);
 	land->load(missionFile);
 	loadProgress = 36.0f;
 	//	land->recalcWater();		//Should have already been done in the
@@ -2008,11 +2088,8 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 	PathFindMap[SECTOR_PATHMAP]->forestCost = forestMoveCost;
 	PathFindMap[SIMPLE_PATHMAP]->forestCost = forestMoveCost;
 	PathManager = new MovePathManager;
-	loadProgress = 40.0f;
-#ifdef LAB_ONLY
-	x = GetCycles();
-	MCTimeMoveLoad = x - x1;
-#endif
+	loadGraph.finishTask(moveTask);
+	loadGraph.beginTask(missionABLTask);
 	//----------------------
 	// Load ABL Libraries...
 	int32_t numErrors, numLinesProcessed;
@@ -2052,11 +2129,8 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 	missionBrainParams = new ABLParam;
 	gosASSERT(missionBrainParams != nullptr);
 	missionBrainCallback = missionBrain->findFunction("handlemessage", TRUE);
-#ifdef LAB_ONLY
-	x1 = GetCycles();
-	MCTimeMissionABLLoad = x1 - x;
-#endif
-	loadProgress = 41.0f;
+	loadGraph.finishTask(missionABLTask);
+	loadGraph.beginTask(warriorTask);
 	//-------------------------------------------
 	// Load all MechWarriors for this mission...
 	MechWarrior::setup();
@@ -2136,11 +2210,8 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 			// Parameters ");
 		}
 	}
-#ifdef LAB_ONLY
-	x = GetCycles();
-	MCTimeWarriorLoad = x - x1;
-#endif
-	loadProgress = 43.0f;
+	loadGraph.finishTask(warriorTask);
+	loadGraph.beginTask(moverPartsTask);
 	//-----------------------------------------------------------------
 	// All systems are GO if we reach this point.  Now we need to
 	// parse the scenario file for the Objects we need for this scenario
@@ -2481,13 +2552,11 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 				MechWarrior::freeWarrior(MechWarrior::warriorList[parts[i].pilot]);
 			}
 		}
-#ifdef LAB_ONLY
-	x1 = GetCycles();
-	MCTimeMoverPartsLoad = x1 - x;
-#endif
-	loadProgress = 68.0f;
+	loadGraph.finishTask(moverPartsTask);
+	loadGraph.beginTask(terrainObjectTask);
 	ObjectManager->loadTerrainObjects(&pakFile, loadProgress, 30);
-	loadProgress = 98.0f;
+	loadGraph.finishTask(terrainObjectTask);
+	loadGraph.beginTask(objectiveTask);
 	ObjectManager->buildMoverLists();
 	if (MPlayer)
 		MPlayer->initSpecialBuildings(commandersToLoad);
@@ -2540,10 +2609,8 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 			}
 			ReadNavMarkers(missionFile, Team::home->objectives);
 		*/
-#ifdef LAB_ONLY
-	x = GetCycles();
-	MCTimeObjectiveLoad = x - x1;
-#endif
+	loadGraph.finishTask(objectiveTask);
+	loadGraph.beginTask(commanderTask);
 	//----------------------------
 	// Read in Commander Groups...
 	for (size_t curCommanderId = 0; curCommanderId < MAX_MC_PLAYERS; curCommanderId++)
@@ -2597,10 +2664,8 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 	// mover is player controlled...
 	if (!MPlayer)
 		Commander::home->setLocalMoverId(0);
-#ifdef LAB_ONLY
-	x1 = GetCycles();
-	MCTimeCommanderLoad = x1 - x;
-#endif
+	loadGraph.finishTask(commanderTask);
+	loadGraph.beginTask(miscTask);
 	//-----------------------------------------------------
 	// This tracks time since scenario started in seconds.
 	LastTimeGetTime = 0xffffffff;
@@ -2623,11 +2688,8 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 	result = eye->init(missionFile);
 	gosASSERT(result == NO_ERROR);
 	eye->inMovieMode = false;
-	loadProgress = 99.0;
-#ifdef LAB_ONLY
-	x = GetCycles();
-	MCTimeMiscLoad = x - x1;
-#endif
+	loadGraph.finishTask(miscTask);
+	loadGraph.beginTask(guiTask);
 	//----------------------------------------------------------------------------
 	// Start the Mission GUI
 	missionInterface = new MissionInterfaceManager;
@@ -2643,7 +2705,6 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 	missionLoader.close();
 	//----------------------------------------------------------------------------
 	userInput->setMouseCursor(mState_NORMAL);
-	loadProgress = 100.0;
 	// MechWarrior::initGoalManager(200);
 	if (tempSpecialAreaFootPrints)
 	{
@@ -2669,9 +2730,43 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 	//	}
 	if (CombatLog)
 		MechWarrior::logPilots(CombatLog);
+	loadGraph.finishTask(guiTask);
+	loadGraph.finish();
+	if (LoadTimelinePath[0])
+		loadGraph.writeTimeline(LoadTimelinePath);
 #ifdef LAB_ONLY
-	x1 = GetCycles();
-	MCTimeGUILoad = x1 - x;
+	MCTimeABLLoad = loadGraph.getTaskCycles(ablTask);
+	MCTimeMiscToTeamLoad = loadGraph.getTaskCycles(gameSystemTask);
+	MCTimeTeamLoad = loadGraph.getTaskCycles(teamTask);
+	MCTimeObjectLoad = loadGraph.getTaskCycles(objectTask);
+	MCTimeTerrainLoad = loadGraph.getTaskCycles(terrainTask);
+	MCTimeMoveLoad = loadGraph.getTaskCycles(moveTask);
+	MCTimeMissionABLLoad = loadGraph.getTaskCycles(missionABLTask);
+	MCTimeWarriorLoad = loadGraph.getTaskCycles(warriorTask);
+	MCTimeMoverPartsLoad = loadGraph.getTaskCycles(moverPartsTask);
+	MCTimeObjectiveLoad =
+		loadGraph.getTaskCycles(terrainObjectTask) + loadGraph.getTaskCycles(objectiveTask);
+	MCTimeCommanderLoad = loadGraph.getTaskCycles(commanderTask);
+	MCTimeMiscLoad = loadGraph.getTaskCycles(miscTask);
+	MCTimeGUILoad = loadGraph.getTaskCycles(guiTask);
+	MCTimeLoadCriticalPath = LoadGraphStatistics.criticalPathCycles;
+	MCTimeLoadStall = LoadGraphStatistics.stallCycles;
+	//---------------------------------------------------------------
+	// Whole load, and how big we got doing it. Set MapFastFiles to 0
+	// in system.cfg to compare against the old fastfile stream reads...
+	MCTimeTotalLoad = GetCycles() - loadStart;
+	//---------------------------------------------------------------
+	// Object type loads, by class.  UseCookedObjectTypes = 0 times
+	// the ini loads against the cooked ones...
+	MCTimeObjectTypeLoad = 0;
+	for (size_t i = 0; i < NUM_OBJECT_TYPE_CLASSES; i++)
+	{
+		MCTimeTypeClassLoad[i] = ObjectTypeLoadStatistics.loadCycles[i] - typeLoadStart.loadCycles[i];
+		MCTimeObjectTypeLoad += MCTimeTypeClassLoad[i];
+	}
+	PROCESS_MEMORY_COUNTERS memoryCounters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+		MCPeakLoadWorkingSet = (uint32_t)(memoryCounters.PeakWorkingSetSize / 1024);
 #endif
 #ifdef LAB_ONLY
 	// Add Mission Load statistics to GameOS Debugger screen!
@@ -2688,6 +2783,12 @@ Mission::init(const std::wstring_view& missionName, int32_t loadType, int32_t dr
 	MCTimeCommanderLoad *= OneOverProcessorSpeed;
 	MCTimeMiscLoad *= OneOverProcessorSpeed;
 	MCTimeGUILoad *= OneOverProcessorSpeed;
+	MCTimeTotalLoad *= OneOverProcessorSpeed;
+	MCTimeLoadCriticalPath *= OneOverProcessorSpeed;
+	MCTimeLoadStall *= OneOverProcessorSpeed;
+	MCTimeObjectTypeLoad *= OneOverProcessorSpeed;
+	for (size_t i = 0; i < NUM_OBJECT_TYPE_CLASSES; i++)
+		MCTimeTypeClassLoad[i] *= OneOverProcessorSpeed;
 #endif
 	missionFile->close();
 	delete missionFile;
@@ -2716,37 +2817,6 @@ Mission::initTGLForMission()
 	// End the Tiny Geometry Layer Heap for Logistics
 	if (TG_Shape::tglHeap)
 	{
-		// Shut down the TGL RAM pools.
-		if (colorPool)
-		{
-			colorPool->destroy();
-			delete colorPool;
-			colorPool = nullptr;
-		}
-		if (vertexPool)
-		{
-			vertexPool->destroy();
-			delete vertexPool;
-			vertexPool = nullptr;
-		}
-		if (facePool)
-		{
-			facePool->destroy();
-			delete facePool;
-			facePool = nullptr;
-		}
-		if (shadowPool)
-		{
-			shadowPool->destroy();
-			delete shadowPool;
-			shadowPool = nullptr;
-		}
-		if (trianglePool)
-		{
-			trianglePool->destroy();
-			delete trianglePool;
-			trianglePool = nullptr;
-		}
 		TG_Shape::tglHeap->destroy();
 		delete TG_Shape::tglHeap;
 		TG_Shape::tglHeap = nullptr;
@@ -2760,17 +2830,6 @@ Mission::initTGLForMission()
 		uint32_t tglHeapSize = 40 * 1024 * 1024;
 		TG_Shape::tglHeap = new UserHeap;
 		TG_Shape::tglHeap->init(tglHeapSize, "TinyGeom");
-		// Start up the TGL RAM pools.
-		colorPool = new TG_VertexPool;
-		colorPool->init(30000);
-		vertexPool = new TG_GOSVertexPool;
-		vertexPool->init(30000);
-		facePool = new TG_DWORDPool;
-		facePool->init(40000);
-		shadowPool = new TG_ShadowPool;
-		shadowPool->init(30000);
-		trianglePool = new TG_TrianglePool;
-		trianglePool->init(20000);
 	}
 	loadProgress += 4.0f;
 	// Stupid hack for now.  Should really get from prefs!!
@@ -2943,37 +3002,6 @@ Mission::destroy(bool initLogistics)
 		// End the Tiny Geometry Layer Heap for Logistics
 		if (TG_Shape::tglHeap)
 		{
-			// Shut down the TGL RAM pools.
-			if (colorPool)
-			{
-				colorPool->destroy();
-				delete colorPool;
-				colorPool = nullptr;
-			}
-			if (vertexPool)
-			{
-				vertexPool->destroy();
-				delete vertexPool;
-				vertexPool = nullptr;
-			}
-			if (facePool)
-			{
-				facePool->destroy();
-				delete facePool;
-				facePool = nullptr;
-			}
-			if (shadowPool)
-			{
-				shadowPool->destroy();
-				delete shadowPool;
-				shadowPool = nullptr;
-			}
-			if (trianglePool)
-			{
-				trianglePool->destroy();
-				delete trianglePool;
-				trianglePool = nullptr;
-			}
 			TG_Shape::tglHeap->destroy();
 			delete TG_Shape::tglHeap;
 			TG_Shape::tglHeap = nullptr;
@@ -2987,7 +3015,6 @@ Mission::destroy(bool initLogistics)
 	// The flush below will remove this one.
 	Mover::holdFireIconHandle = 0;
 	mcTextureManager->flush();
-	mcTextureManager->freeVertices();
 	soundSystem->purgeSoundSystem();
 	missionFileName[0] = 0;
 	if (CObjective::s_markerFont)
@@ -3002,6 +3029,7 @@ Mission::destroy(bool initLogistics)
 	//		gos_SetScreenMode(800,600,16,0,0,0,0,false,0,false,0,renderer);
 	// Start finding the Leaks
 	// systemHeap->dumpRecordLog();
+	globalHeapList->leakReport();
 }
 //----------------------------------------------------------------------------------
 void
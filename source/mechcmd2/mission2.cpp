@@ -26,6 +26,24 @@ int64_t MCTimeObjectiveLoad = 0;
 int64_t MCTimeCommanderLoad = 0;
 int64_t MCTimeMiscLoad = 0;
 int64_t MCTimeGUILoad = 0;
+int64_t MCTimeTotalLoad = 0;
+int64_t MCTimeObjectTypeLoad = 0;
+int64_t MCTimeTypeClassLoad[NUM_OBJECT_TYPE_CLASSES];
+int64_t MCTimeLoadCriticalPath = 0;
+int64_t MCTimeLoadStall = 0;
+int64_t MCTimeBootRenderer = 0;
+int64_t MCTimeBootEffects = 0;
+int64_t MCTimeBootTextures = 0;
+int64_t MCTimeBootCursors = 0;
+int64_t MCTimeBootSound = 0;
+int64_t MCTimeBootInterface = 0;
+int64_t MCTimeBootStart = 0;
+int64_t MCTimeBootShapes = 0;
+int64_t MCTimeBootDialogs = 0;
+int64_t MCTimeBootTotal = 0;
+int64_t MCTimeBootCriticalPath = 0;
+int64_t MCTimeBootStall = 0;
+uint32_t MCPeakLoadWorkingSet = 0; // KB, as of the end of the last mission load
 
 int64_t x1;
 
@@ -87,6 +105,10 @@ extern int64_t MCTimeTurretsTL;
 
 extern int64_t MCTimeAnimationCalc;
 
+extern uint32_t BrainTierCount[NUM_BRAIN_TIERS];
+extern uint32_t BrainBudgetOverruns;
+extern uint32_t BrainWakeups;
+
 extern int64_t x;
 
 extern float OneOverProcessorSpeed;
@@ -102,8 +124,6 @@ Mission::initBareMinimum()
 		mcTextureManager = new MC_TextureManager;
 		mcTextureManager->start();
 	}
-	// Startup the vertex array pool
-	mcTextureManager->startVertices(100000);
 	initTGLForLogistics();
 	//----------------------------------------------
 	// Start Appearance Type Lists.
@@ -144,6 +164,7 @@ Mission::initializeStatistics()
 	MCTimeCommanderLoad *= OneOverProcessorSpeed;
 	MCTimeMiscLoad *= OneOverProcessorSpeed;
 	MCTimeGUILoad *= OneOverProcessorSpeed;
+	MCTimeTotalLoad *= OneOverProcessorSpeed;
 	// Add Mission Run statistics to GameOS Debugger screen!
 	StatisticFormat("");
 	StatisticFormat("MechCommander 2 GameLogic");
@@ -195,6 +216,135 @@ Mission::initializeStatistics()
 	AddStatistic("Total LOS Calc Time", "%", gos_timedata, (PVOID)&MCTimeLOSCalc, 0);
 	StatisticFormat("=========================");
 	AddStatistic("Total Anim Calc Time", "%", gos_timedata, (PVOID)&MCTimeAnimationCalc, 0);
+	StatisticFormat("=========================");
+	AddStatistic("Brains Combat", "brains", gos_DWORD, (PVOID)&BrainTierCount[BRAIN_TIER_COMBAT], Stat_AutoReset);
+	AddStatistic("Brains Alert", "brains", gos_DWORD, (PVOID)&BrainTierCount[BRAIN_TIER_ALERT], Stat_AutoReset);
+	AddStatistic("Brains Idle", "brains", gos_DWORD, (PVOID)&BrainTierCount[BRAIN_TIER_IDLE], Stat_AutoReset);
+	AddStatistic("Brains Dormant", "brains", gos_DWORD, (PVOID)&BrainTierCount[BRAIN_TIER_DORMANT], Stat_AutoReset);
+	AddStatistic("Brain Budget Overruns", "brains", gos_DWORD, (PVOID)&BrainBudgetOverruns, Stat_AutoReset);
+	AddStatistic("Brain Wakeups", "brains", gos_DWORD, (PVOID)&BrainWakeups, Stat_AutoReset);
+	StatisticFormat("=========================");
+	AddStatistic("Tactical Cache Hits", "evals", gos_DWORD, (PVOID)&Team::tacticalCacheHits, Stat_AutoReset);
+	AddStatistic("Tactical Cache Misses", "evals", gos_DWORD, (PVOID)&Team::tacticalCacheMisses, Stat_AutoReset);
+	AddStatistic("Tactical Cache Invalidations", "evals", gos_DWORD, (PVOID)&Team::tacticalCacheInvalidations, Stat_AutoReset);
+	StatisticFormat("=========================");
+	AddStatistic("Mission Load Peak RSS", "KB", gos_DWORD, (PVOID)&MCPeakLoadWorkingSet, 0);
+	AddStatistic("FastFiles Mapped", "files", gos_DWORD, (PVOID)&FastFileStatistics.numMappedFiles, 0);
+	AddStatistic("FastFile Mapped Reads", "reads", gos_DWORD, (PVOID)&FastFileStatistics.numMappedReads, 0);
+	AddStatistic("FastFile Stream Reads", "reads", gos_DWORD, (PVOID)&FastFileStatistics.numStreamReads, 0);
+	AddStatistic("FastFile Bytes Streamed", "bytes", gos_DWORD, (PVOID)&FastFileStatistics.bytesStreamed, 0);
+	AddStatistic("FastFile Names Indexed", "files", gos_DWORD, (PVOID)&FastFileStatistics.numIndexed, 0);
+	AddStatistic("FastFile Names Shadowed", "files", gos_DWORD, (PVOID)&FastFileStatistics.numShadowed, 0);
+	AddStatistic("FastFile Lookups", "lookups", gos_DWORD, (PVOID)&FastFileStatistics.numLookups, 0);
+	AddStatistic("FastFile Lookup Hits", "lookups", gos_DWORD, (PVOID)&FastFileStatistics.numLookupHits, 0);
+	AddStatistic("FastFile Lookup Probes", "probes", gos_DWORD, (PVOID)&FastFileStatistics.numLookupProbes, 0);
+	StatisticFormat("=========================");
+	AddStatistic("Packet Reads Queued", "reads", gos_DWORD, (PVOID)&PacketReaderStatistics.numRequests, 0);
+	AddStatistic("Packet Prefetches", "reads", gos_DWORD, (PVOID)&PacketReaderStatistics.numPrefetches, 0);
+	AddStatistic("Packet Prefetch Hits", "reads", gos_DWORD, (PVOID)&PacketReaderStatistics.numPrefetchHits, 0);
+	AddStatistic("Packet Prefetches Dropped", "reads", gos_DWORD, (PVOID)&PacketReaderStatistics.numPrefetchesDropped, 0);
+	AddStatistic("Packet Budget Stalls", "reads", gos_DWORD, (PVOID)&PacketReaderStatistics.numBudgetStalls, 0);
+	AddStatistic("Packet Budget Overruns", "reads", gos_DWORD, (PVOID)&PacketReaderStatistics.numBudgetOverruns, 0);
+	AddStatistic("Packet Wait Stalls", "reads", gos_DWORD, (PVOID)&PacketReaderStatistics.numWaitStalls, 0);
+	AddStatistic("Packet Bytes In Flight", "bytes", gos_DWORD, (PVOID)&PacketReaderStatistics.bytesInFlight, 0);
+	AddStatistic("Packet Peak Bytes In Flight", "bytes", gos_DWORD, (PVOID)&PacketReaderStatistics.peakBytesInFlight, 0);
+	AddStatistic("Packet Bytes Read", "bytes", gos_DWORD, (PVOID)&PacketReaderStatistics.bytesRead, 0);
+	AddStatistic("Packet Bytes Unpacked", "bytes", gos_DWORD, (PVOID)&PacketReaderStatistics.bytesUnpacked, 0);
+	StatisticFormat("=========================");
+	AddStatistic("Ini Blocks Indexed", "blocks", gos_DWORD, (PVOID)&FitIniFileStatistics.numIndexedBlocks, 0);
+	AddStatistic("Ini Ids Indexed", "ids", gos_DWORD, (PVOID)&FitIniFileStatistics.numIndexedIds, 0);
+	AddStatistic("Ini Block Lookups", "lookups", gos_DWORD, (PVOID)&FitIniFileStatistics.numBlockLookups, 0);
+	AddStatistic("Ini Id Lookups", "lookups", gos_DWORD, (PVOID)&FitIniFileStatistics.numIdLookups, 0);
+	AddStatistic("Ini Id Misses", "lookups", gos_DWORD, (PVOID)&FitIniFileStatistics.numIdMisses, 0);
+	AddStatistic("Ini Id Probes", "probes", gos_DWORD, (PVOID)&FitIniFileStatistics.numIdProbes, 0);
+	StatisticFormat("=========================");
+	AddStatistic("CSV Files Split", "files", gos_DWORD, (PVOID)&CSVFileStatistics.numFilesSplit, 0);
+	AddStatistic("CSV Cache Hits", "files", gos_DWORD, (PVOID)&CSVFileStatistics.numCacheHits, 0);
+	AddStatistic("CSV Cache Writes", "files", gos_DWORD, (PVOID)&CSVFileStatistics.numCacheWrites, 0);
+	AddStatistic("CSV Cell Reads", "cells", gos_DWORD, (PVOID)&CSVFileStatistics.numCellReads, 0);
+	AddStatistic("CSV Columns Converted", "columns", gos_DWORD, (PVOID)&CSVFileStatistics.numColumnsConverted, 0);
+	StatisticFormat("=========================");
+	AddStatistic("Object Types From Ini", "types", gos_DWORD, (PVOID)&ObjectTypeLoadStatistics.numIniLoads, 0);
+	AddStatistic("Object Types Cooked", "types", gos_DWORD, (PVOID)&ObjectTypeLoadStatistics.numCookedLoads, 0);
+	AddStatistic("Object Type Records Rejected", "types", gos_DWORD, (PVOID)&ObjectTypeLoadStatistics.numCookedRejected, 0);
+	AddStatistic("Object Type Cooked Files Stale", "files", gos_DWORD, (PVOID)&ObjectTypeLoadStatistics.numCookedFilesStale, 0);
+	AddStatistic("Object Type Validations", "types", gos_DWORD, (PVOID)&ObjectTypeLoadStatistics.numValidations, 0);
+	AddStatistic("Object Type Mismatches", "types", gos_DWORD, (PVOID)&ObjectTypeLoadStatistics.numValidationFailures, 0);
+	AddStatistic("Object Type Records Written", "types", gos_DWORD, (PVOID)&ObjectTypeLoadStatistics.numRecordsCooked, 0);
+	AddStatistic("Object Type Load", "%", gos_timedata, (PVOID)&MCTimeObjectTypeLoad, 0);
+	AddStatistic("   Mech Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[BATTLEMECH_TYPE], 0);
+	AddStatistic("   Vehicle Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[VEHICLE_TYPE], 0);
+	AddStatistic("   Building Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[BUILDING_TYPE], 0);
+	AddStatistic("   TreeBuilding Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[TREEBUILDING_TYPE], 0);
+	AddStatistic("   Tree Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[TREE_TYPE], 0);
+	AddStatistic("   TerrainObject Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[TERRAINOBJECT_TYPE], 0);
+	AddStatistic("   WeaponBolt Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[WEAPONBOLT_TYPE], 0);
+	AddStatistic("   Explosion Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[EXPLOSION_TYPE], 0);
+	AddStatistic("   Fire Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[FIRE_TYPE], 0);
+	AddStatistic("   Turret Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[TURRET_TYPE], 0);
+	AddStatistic("   Gate Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[GATE_TYPE], 0);
+	AddStatistic("   Artillery Types", "%", gos_timedata, (PVOID)&MCTimeTypeClassLoad[ARTILLERY_TYPE], 0);
+	StatisticFormat("=========================");
+	AddStatistic("Load Tasks", "tasks", gos_DWORD, (PVOID)&LoadGraphStatistics.numTasks, 0);
+	AddStatistic("Load Tasks Pooled", "tasks", gos_DWORD, (PVOID)&LoadGraphStatistics.numWorkerTasks, 0);
+	AddStatistic("Load Workers", "threads", gos_DWORD, (PVOID)&LoadGraphStatistics.numWorkers, 0);
+	AddStatistic("Load Dependency Stalls", "tasks", gos_DWORD, (PVOID)&LoadGraphStatistics.numDependencyStalls, 0);
+	AddStatistic("Load Critical Path", "%", gos_timedata, (PVOID)&MCTimeLoadCriticalPath, 0);
+	AddStatistic("Load Stalled", "%", gos_timedata, (PVOID)&MCTimeLoadStall, 0);
+	StatisticFormat("=========================");
+	AddStatistic("Boot Total", "%", gos_timedata, (PVOID)&MCTimeBootTotal, 0);
+	AddStatistic("   Renderer", "%", gos_timedata, (PVOID)&MCTimeBootRenderer, 0);
+	AddStatistic("   Effects", "%", gos_timedata, (PVOID)&MCTimeBootEffects, 0);
+	AddStatistic("   Textures", "%", gos_timedata, (PVOID)&MCTimeBootTextures, 0);
+	AddStatistic("   Cursors", "%", gos_timedata, (PVOID)&MCTimeBootCursors, 0);
+	AddStatistic("   Sound", "%", gos_timedata, (PVOID)&MCTimeBootSound, 0);
+	AddStatistic("   Interface", "%", gos_timedata, (PVOID)&MCTimeBootInterface, 0);
+	AddStatistic("   Start", "%", gos_timedata, (PVOID)&MCTimeBootStart, 0);
+	AddStatistic("   Shapes", "%", gos_timedata, (PVOID)&MCTimeBootShapes, 0);
+	AddStatistic("   Dialogs", "%", gos_timedata, (PVOID)&MCTimeBootDialogs, 0);
+	AddStatistic("Boot Critical Path", "%", gos_timedata, (PVOID)&MCTimeBootCriticalPath, 0);
+	AddStatistic("Boot Stalled", "%", gos_timedata, (PVOID)&MCTimeBootStall, 0);
+	StatisticFormat("=========================");
+	AddStatistic("Map Tiles", "tiles", gos_DWORD, (PVOID)&MapTileStatistics.numTiles, 0);
+	AddStatistic("Map Tiles Resident", "tiles", gos_DWORD, (PVOID)&MapTileStatistics.numResident, 0);
+	AddStatistic("Map Tile Memory", "bytes", gos_DWORD, (PVOID)&MapTileStatistics.residentBytes, 0);
+	AddStatistic("Map Tile Memory Peak", "bytes", gos_DWORD, (PVOID)&MapTileStatistics.peakResidentBytes, 0);
+	AddStatistic("Map Tiles Packed", "bytes", gos_DWORD, (PVOID)&MapTileStatistics.packedBytes, 0);
+	AddStatistic("Map Tile Prefetches", "tiles", gos_DWORD, (PVOID)&MapTileStatistics.numPrefetches, 0);
+	AddStatistic("Map Tile Prefetches Dropped", "tiles", gos_DWORD, (PVOID)&MapTileStatistics.numPrefetchesDropped, 0);
+	AddStatistic("Map Tile Demand Page-Ins", "tiles", gos_DWORD, (PVOID)&MapTileStatistics.numDemandPageIns, 0);
+	AddStatistic("Map Tile Evictions", "tiles", gos_DWORD, (PVOID)&MapTileStatistics.numEvictions, 0);
+	AddStatistic("Map Tile Repacks", "tiles", gos_DWORD, (PVOID)&MapTileStatistics.numRepacks, 0);
+	AddStatistic("Map Tiles Over Budget", "tiles", gos_DWORD, (PVOID)&MapTileStatistics.numOverBudget, 0);
+	AddStatistic("Map Tile Page-In", "%", gos_timedata, (PVOID)&MapTileStatistics.demandCycles, 0);
+	AddStatistic("Map Tile Worst Page-In", "%", gos_timedata, (PVOID)&MapTileStatistics.maxDemandCycles, 0);
+	StatisticFormat("=========================");
+	AddStatistic("File Lines Buffered", "lines", gos_DWORD, (PVOID)&FileReadStatistics.numBufferedLines, 0);
+	AddStatistic("File Buffer Fills", "reads", gos_DWORD, (PVOID)&FileReadStatistics.numFills, 0);
+	AddStatistic("File Bytes Buffered", "bytes", gos_DWORD, (PVOID)&FileReadStatistics.bytesFilled, 0);
+	AddStatistic("File Buffer Flushes", "flushes", gos_DWORD, (PVOID)&FileReadStatistics.numFlushes, 0);
+	StatisticFormat("=========================");
+	AddStatistic("Logistics Chassis Indexed", "chassis", gos_DWORD, (PVOID)&LogisticsDataStatistics.numChassisIndexed, 0);
+	AddStatistic("Logistics Chassis Loaded", "chassis", gos_DWORD, (PVOID)&LogisticsDataStatistics.numChassisLoaded, 0);
+	AddStatistic("Logistics Pilots Indexed", "pilots", gos_DWORD, (PVOID)&LogisticsDataStatistics.numPilotsIndexed, 0);
+	AddStatistic("Logistics Pilots Loaded", "pilots", gos_DWORD, (PVOID)&LogisticsDataStatistics.numPilotsLoaded, 0);
+	AddStatistic("Logistics Prefetches", "files", gos_DWORD, (PVOID)&LogisticsDataStatistics.numPrefetches, 0);
+	AddStatistic("Logistics Prefetches Dropped", "files", gos_DWORD, (PVOID)&LogisticsDataStatistics.numPrefetchesDropped, 0);
+	AddStatistic("Logistics Prefetch Hits", "records", gos_DWORD, (PVOID)&LogisticsDataStatistics.numPrefetchHits, 0);
+	AddStatistic("Logistics Bytes Prefetched", "bytes", gos_DWORD, (PVOID)&LogisticsDataStatistics.bytesPrefetched, 0);
+	StatisticFormat("=========================");
+	AddStatistic("Weapon Bolts In Use", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_WEAPONS].numActive, 0);
+	AddStatistic("Weapon Bolts Peak", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_WEAPONS].peakActive, 0);
+	AddStatistic("Weapon Bolts Turned Away", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_WEAPONS].numExhausted, 0);
+	AddStatistic("Carnage In Use", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_CARNAGE].numActive, 0);
+	AddStatistic("Carnage Peak", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_CARNAGE].peakActive, 0);
+	AddStatistic("Carnage Turned Away", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_CARNAGE].numExhausted, 0);
+	AddStatistic("Lights In Use", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_LIGHTS].numActive, 0);
+	AddStatistic("Lights Peak", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_LIGHTS].peakActive, 0);
+	AddStatistic("Lights Turned Away", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_LIGHTS].numExhausted, 0);
+	AddStatistic("Artillery In Use", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_ARTILLERY].numActive, 0);
+	AddStatistic("Artillery Peak", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_ARTILLERY].peakActive, 0);
+	AddStatistic("Artillery Turned Away", "objects", gos_DWORD, (PVOID)&ObjectPoolStatistics[OBJECT_POOL_ARTILLERY].numExhausted, 0);
 	statisticsInitialized = true;
 	HeapList::initializeStatistics();
 	TerrainTextures::initializeStatistics();
@@ -213,37 +363,6 @@ Mission::initTGLForLogistics()
 	// End the Tiny Geometry Layer Heap for the Mission
 	if (TG_Shape::tglHeap)
 	{
-		// Shut down the TGL RAM pools.
-		if (colorPool)
-		{
-			colorPool->destroy();
-			delete colorPool;
-			colorPool = nullptr;
-		}
-		if (vertexPool)
-		{
-			vertexPool->destroy();
-			delete vertexPool;
-			vertexPool = nullptr;
-		}
-		if (facePool)
-		{
-			facePool->destroy();
-			delete facePool;
-			facePool = nullptr;
-		}
-		if (shadowPool)
-		{
-			shadowPool->destroy();
-			delete shadowPool;
-			shadowPool = nullptr;
-		}
-		if (trianglePool)
-		{
-			trianglePool->destroy();
-			delete trianglePool;
-			trianglePool = nullptr;
-		}
 		TG_Shape::tglHeap->destroy();
 		delete TG_Shape::tglHeap;
 		TG_Shape::tglHeap = nullptr;
@@ -254,17 +373,6 @@ Mission::initTGLForLogistics()
 	{
 		TG_Shape::tglHeap = new UserHeap;
 		TG_Shape::tglHeap->init(tglHeapSize, "TinyGeom");
-		// Start up the TGL RAM pools.
-		colorPool = new TG_VertexPool;
-		colorPool->init(2000);
-		vertexPool = new TG_GOSVertexPool;
-		vertexPool->init(2000);
-		facePool = new TG_DWORDPool;
-		facePool->init(4000);
-		shadowPool = new TG_ShadowPool;
-		shadowPool->init(2000);
-		trianglePool = new TG_TrianglePool;
-		trianglePool->init(2000);
 	}
 }
 
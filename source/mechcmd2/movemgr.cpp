@@ -35,7 +35,7 @@ MovePathManagerPtr PathManager = nullptr;
 PVOID
 MovePathManager::operator new(size_t mySize)
 {
-	PVOID result = systemHeap->Malloc(mySize);
+	PVOID result = systemHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
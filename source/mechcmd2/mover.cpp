@@ -199,6 +199,7 @@ extern float MovementUpdateFrequency;
 extern float CombatUpdateFrequency;
 extern float CommandUpdateFrequency;
 extern float PilotCheckUpdateFrequency;
+extern int32_t BrainsPerFrame;
 extern int32_t PilotCheckModifierTable[2];
 // extern float				ElementalTargetNoJumpDistance;
 extern int32_t MechSalvageChance;
@@ -503,7 +504,7 @@ DebugMoveChunk(std::unique_ptr<Mover> mover, MoveChunkPtr chunk1, MoveChunkPtr c
 PVOID
 MoveChunk::operator new(size_t ourSize)
 {
-	PVOID result = systemHeap->Malloc(ourSize);
+	PVOID result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -1107,7 +1108,7 @@ PVOID
 StatusChunk::operator new(size_t ourSize)
 {
 	PVOID result;
-	result = systemHeap->Malloc(ourSize);
+	result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -1938,6 +1939,10 @@ Mover::loadGameSystem(FitIniFilePtr mechFile, float visualRange)
 	result = mechFile->readIdFloat("PilotCheckUpdateFrequency", PilotCheckUpdateFrequency);
 	if (result != NO_ERROR)
 		return (result);
+	//------------------------------------------------------
+	// Optional, so older gamesys.fit files still load. Keeps
+	// the default if it's not there...
+	mechFile->readIdLong("BrainsPerFrame", BrainsPerFrame);
 	//	result = mechFile->readIdFloatArray("FireOddsTable", FireOddsTable,
 	// NUM_FIREODDS); 	if (result != NO_ERROR) 		return(result);
 	result = mechFile->readIdLong("SkillIncreaseCap", MechWarrior::increaseCap);
@@ -5648,6 +5653,7 @@ int32_t
 Mover::calcFireRanges(void)
 {
 	lastOptimalRangeCalc = scenarioTime;
+	int32_t lastNumFunctionalWeapons = numFunctionalWeapons;
 	//---------------------------
 	// Calc min and max ranges...
 	maxRange = 0;
@@ -5668,6 +5674,10 @@ Mover::calcFireRanges(void)
 			numFunctionalWeapons++;
 		}
 	}
+	//------------------------------------------------------
+	// Lost a weapon (or its ammo), so our cached odds are off...
+	if (numFunctionalWeapons != lastNumFunctionalWeapons)
+		Team::invalidateTacticalEvals(getWatchID());
 	//---------------------------
 	// Now, calc optimal range...
 	float rangeTotals[NUM_WEAPON_RANGE_TYPES] = {0, 0, 0, 0, 0};
@@ -5983,19 +5993,22 @@ Mover::sortWeapons(
 	int32_t aimLocation = -1;
 	if (pilot && pilot->getCurTacOrder()->isCombatOrder())
 		aimLocation = pilot->getCurTacOrder()->attackParams.aimLocation;
-	//----------------------------------------------------------------------
-	// BIG ASSUMPTION HERE: That a mech will not have more than 100 weapons.
-	sortList->clear();
+	//----------------------------------------------------------------
+	// The sortweapons ABL call runs on brain workers, so this sorts on
+	// the stack rather than in Mover::sortList.
+	SortListNode sortNodes[MAX_MOVER_INVENTORY_ITEMS];
+	if (listSize > MAX_MOVER_INVENTORY_ITEMS)
+		listSize = MAX_MOVER_INVENTORY_ITEMS;
 	if (listSize == -1)
 	{
 		for (size_t item = numOther; item < (numOther + numWeapons); item++)
 		{
-			sortList->setId(item - numOther, item);
+			sortNodes[item - numOther].id = item;
 			switch (sortType)
 			{
 			case WEAPONSORT_ATTACKCHANCE:
-				sortList->setValue(item - numOther,
-					calcAttackChance(target, aimLocation, scenarioTime, item, 0.0, nullptr));
+				sortNodes[item - numOther].value =
+					calcAttackChance(target, aimLocation, scenarioTime, item, 0.0, nullptr);
 				break;
 			default:
 				//-----------------
@@ -6004,18 +6017,18 @@ Mover::sortWeapons(
 				return (-3);
 			}
 		}
-		sortList->sort();
+		SortList::sortNodes(sortNodes, numWeapons);
 		for (item = 0; item < numWeapons; item++)
 		{
-			weaponList[item] = sortList->getId(item);
-			valueList[item] = sortList->getValue(item);
+			weaponList[item] = sortNodes[item].id;
+			valueList[item] = sortNodes[item].value;
 		}
 	}
 	else
 	{
 		for (size_t item = 0; item < listSize; item++)
 		{
-			sortList->setId(item, weaponList[item]);
+			sortNodes[item].id = weaponList[item];
 			float sortValue = 0.0;
 			if (weaponList[item] == -1)
 				sortValue = -999.0;
@@ -6032,13 +6045,13 @@ Mover::sortWeapons(
 					NODEFAULT;
 					return (-3);
 				}
-			sortList->setValue(item, sortValue);
+			sortNodes[item].value = sortValue;
 		}
-		sortList->sort();
+		SortList::sortNodes(sortNodes, listSize);
 		for (item = 0; item < listSize; item++)
 		{
-			weaponList[item] = sortList->getId(item);
-			valueList[item] = sortList->getValue(item);
+			weaponList[item] = sortNodes[item].id;
+			valueList[item] = sortNodes[item].value;
 		}
 	}
 	return (NO_ERROR);
@@ -229,7 +229,7 @@ ShutdownNetworking(void)
 PVOID
 WorldChunk::operator new(size_t ourSize)
 {
-	PVOID result = systemHeap->Malloc(ourSize);
+	PVOID result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
@@ -339,7 +339,7 @@ WorldChunk::equalTo(WorldChunkPtr chunk)
 PVOID
 MultiPlayer::operator new(size_t ourSize)
 {
-	PVOID result = systemHeap->Malloc(ourSize);
+	PVOID result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	return (result);
 }
 
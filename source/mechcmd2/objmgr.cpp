@@ -103,6 +103,10 @@
 #include "mission.h"
 #endif
 
+#ifndef WARRIOR_H
+#include "warrior.h"
+#endif
+
 #define BRIDGE_OBJTYPE 448
 #define MINE1 60
 #define MINE2 251
@@ -150,6 +154,7 @@ ObjectQueueNodePtr weaponList = nullptr;
 #define VISIBLE_THRESHOLD 1
 
 GameObjectManagerPtr ObjectManager = nullptr;
+ObjectPoolStats ObjectPoolStatistics[NUM_OBJECT_POOLS];
 GameObjectPtr* collisionList = nullptr;
 int32_t numCollidables = 0;
 //***************************************************************************
@@ -193,7 +198,7 @@ moverInList(int32_t blockNum)
 PVOID
 GameObjectManager::operator new(size_t ourSize)
 {
-	PVOID result = systemHeap->Malloc(ourSize);
+	PVOID result = systemHeap->Malloc(ourSize, HEAP_CALLER());
 	if (!result)
 	{
 		Fatal(0, " GameObjectManager.new: unable to create GameObject Manager ");
@@ -252,10 +257,6 @@ GameObjectManager::init(void)
 	nextReinforcementPartId = MIN_REINFORCEMENT_PART_ID;
 	numRemoved = 0;
 	nextWatchID = 1;
-	currentWeaponsIndex = 0;
-	currentCarnageIndex = 0;
-	currentLightIndex = 0;
-	currentArtilleryIndex = 0;
 	int32_t totalBlocks = Terrain::blocksMapSide * Terrain::blocksMapSide;
 	for (size_t i = 0; i < totalBlocks; i++)
 	{
@@ -480,6 +481,7 @@ GameObjectManager::setNumObjects(int32_t nMechs, int32_t nVehicles, int32_t nEle
 			objList[curHandle++] = artillery[i];
 		}
 	}
+	initPools();
 	useMoverLineOfSightTable = true;
 	moverLineOfSightTable = (const std::wstring_view&)systemHeap->Malloc(maxMovers * maxMovers);
 	if (!moverLineOfSightTable)
@@ -689,17 +691,24 @@ GameObjectManager::getGate(int32_t gateIndex)
 
 //---------------------------------------------------------------------------
 
+void
+GameObjectManager::initPools(void)
+{
+	weaponPool.init(weapons, numWeapons, "WeaponBolts", &ObjectPoolStatistics[OBJECT_POOL_WEAPONS]);
+	carnagePool.init(carnage, numCarnage, "Carnage", &ObjectPoolStatistics[OBJECT_POOL_CARNAGE]);
+	lightPool.init(lights, numLights, "Lights", &ObjectPoolStatistics[OBJECT_POOL_LIGHTS]);
+	artilleryPool.init(
+		artillery, numArtillery, "Artillery", &ObjectPoolStatistics[OBJECT_POOL_ARTILLERY]);
+}
+
+//---------------------------------------------------------------------------
+// An empty pool gives back nullptr.  Weapon bolts and carnage in use are
+// no longer finished early to make room.
+
 WeaponBoltPtr
 GameObjectManager::getWeapon(void)
 {
-	if (!weapons || (currentWeaponsIndex < 0) || (currentWeaponsIndex >= numWeapons))
-		return (nullptr);
-	currentWeaponsIndex++;
-	if (currentWeaponsIndex >= numWeapons)
-		currentWeaponsIndex = 0;
-	// Make sure this weapon has an opportunity to damage its target
-	weapons[currentWeaponsIndex]->finishNow();
-	return (weapons[currentWeaponsIndex]);
+	return (weaponPool.acquire());
 }
 
 //---------------------------------------------------------------------------
@@ -707,14 +716,10 @@ GameObjectManager::getWeapon(void)
 CarnagePtr
 GameObjectManager::getCarnage(CarnageEnumType carnageType)
 {
-	if (!carnage || (currentCarnageIndex < 0) || (currentCarnageIndex >= numCarnage))
-		return (nullptr);
-	currentCarnageIndex++;
-	if (currentCarnageIndex >= numCarnage)
-		currentCarnageIndex = 0;
-	carnage[currentCarnageIndex]->finishNow();
-	carnage[currentCarnageIndex]->init(carnageType);
-	return (carnage[currentCarnageIndex]);
+	CarnagePtr obj = carnagePool.acquire();
+	if (obj)
+		obj->init(carnageType);
+	return (obj);
 }
 
 //---------------------------------------------------------------------------
@@ -724,6 +729,7 @@ GameObjectManager::releaseCarnage(CarnagePtr obj)
 {
 	obj->setExists(false);
 	obj->setOwner(nullptr);
+	carnagePool.release(obj);
 }
 
 //---------------------------------------------------------------------------
@@ -731,14 +737,13 @@ GameObjectManager::releaseCarnage(CarnagePtr obj)
 LightPtr
 GameObjectManager::getLight(void)
 {
-	if (!lights || (currentLightIndex < 0) || (currentLightIndex >= numLights))
-		return (nullptr);
-	if (currentLightIndex >= numLights)
-		currentLightIndex = 0;
-	//	lights[currentLightIndex]->finishNow();
-	lights[currentLightIndex]->init(false);
-	lights[currentLightIndex]->setExists(true);
-	return (lights[currentLightIndex++]);
+	LightPtr obj = lightPool.acquire();
+	if (obj)
+	{
+		obj->init(false);
+		obj->setExists(true);
+	}
+	return (obj);
 }
 
 //---------------------------------------------------------------------------
@@ -748,6 +753,7 @@ GameObjectManager::releaseLight(LightPtr obj)
 {
 	obj->setExists(false);
 	//	obj->setOwner(nullptr);
+	lightPool.release(obj);
 }
 
 //---------------------------------------------------------------------------
@@ -755,18 +761,15 @@ GameObjectManager::releaseLight(LightPtr obj)
 ArtilleryPtr
 GameObjectManager::getArtillery(void)
 {
-	if (!artillery || (currentArtilleryIndex < 0) || (currentArtilleryIndex >= numArtillery))
-		STOP(("Artillery Strikes are out of range in ObjectManager %d", currentArtilleryIndex));
-	currentArtilleryIndex++;
-	if (currentArtilleryIndex >= numArtillery)
-		currentArtilleryIndex = 0;
 	// OK to return nullptr now.  Lets Multiplayer know that there are no more
 	// strikes available.
-	if (artillery[currentArtilleryIndex]->getExists())
-		return nullptr;
-	artillery[currentArtilleryIndex]->init(false);
-	artillery[currentArtilleryIndex]->setExists(true);
-	return (artillery[currentArtilleryIndex]);
+	ArtilleryPtr obj = artilleryPool.acquire();
+	if (obj)
+	{
+		obj->init(false);
+		obj->setExists(true);
+	}
+	return (obj);
 }
 
 //---------------------------------------------------------------------------
@@ -1321,6 +1324,10 @@ GameObjectManager::destroy(void)
 	}
 	gates = nullptr;
 	//--------------------------------------------------------------
+	weaponPool.destroy();
+	carnagePool.destroy();
+	lightPool.destroy();
+	artilleryPool.destroy();
 	if (weapons && numWeapons > 0)
 	{
 		for (i = 0; i < numWeapons; i++)
@@ -1468,39 +1475,29 @@ GameObjectManager::render(bool terrain, bool movers, bool other)
 	{
 		//----------------------------------------
 		// All other objects should be rendered...
-		if (weapons)
+		for (size_t i = 0; i < weaponPool.getNumActive(); i++)
 		{
-			for (size_t i = 0; i < numWeapons; i++)
-			{
-				if (weapons[i] && weapons[i]->getExists())
-					weapons[i]->render();
-			}
+			WeaponBoltPtr obj = weaponPool.getActive(i);
+			if (obj->getExists())
+				obj->render();
 		}
-		if (carnage)
+		for (size_t i = 0; i < carnagePool.getNumActive(); i++)
 		{
-			for (size_t i = 0; i < numCarnage; i++)
-			{
-				if (carnage[i] && carnage[i]->getExists())
-				{
-					carnage[i]->render();
-				}
-			}
+			CarnagePtr obj = carnagePool.getActive(i);
+			if (obj->getExists())
+				obj->render();
 		}
-		if (lights)
+		for (size_t i = 0; i < lightPool.getNumActive(); i++)
 		{
-			for (size_t i = 0; i < numLights; i++)
-			{
-				if (lights[i] && lights[i]->getExists())
-					lights[i]->render();
-			}
+			LightPtr obj = lightPool.getActive(i);
+			if (obj->getExists())
+				obj->render();
 		}
-		if (artillery)
+		for (size_t i = 0; i < artilleryPool.getNumActive(); i++)
 		{
-			for (size_t i = 0; i < numArtillery; i++)
-			{
-				if (artillery[i] && artillery[i]->getExists())
-					artillery[i]->render();
-			}
+			ArtilleryPtr obj = artilleryPool.getActive(i);
+			if (obj->getExists())
+				obj->render();
 		}
 	}
 	gos_SetRenderState(gos_State_Fog, 0);
@@ -1598,13 +1595,11 @@ GameObjectManager::renderShadows(bool terrain, bool movers, bool other)
 	}
 	if (other)
 	{
-		if (carnage)
+		for (size_t i = 0; i < carnagePool.getNumActive(); i++)
 		{
-			for (size_t i = 0; i < numCarnage; i++)
-			{
-				if (carnage[i] && carnage[i]->getExists())
-					carnage[i]->renderShadows();
-			}
+			CarnagePtr obj = carnagePool.getActive(i);
+			if (obj->getExists())
+				obj->renderShadows();
 		}
 	}
 	gos_SetRenderState(gos_State_Fog, 0);
@@ -1731,6 +1726,19 @@ GameObjectManager::update(bool terrain, bool movers, bool other)
 	{
 		static std::unique_ptr<Mover> removeList[MAX_MOVERS];
 		int32_t numRemoved = 0;
+		//-------------------------------------------------------
+		// On a tiled map, get the ground under every mover paged
+		// in before they go looking at it.
+		if (land && land->mapData->isTiled())
+		{
+			for (size_t i = 0; i < numMovers; i++)
+				if (moverList[i] && moverList[i]->getExists())
+					land->mapData->requestArea(moverList[i]->getPosition(), MAP_TILE_SIDE >> 2);
+		}
+		//-------------------------------------------------------
+		// Run every brain that's due in one batch, so they can
+		// think in parallel, before anybody moves...
+		MechWarrior::updateBrains();
 #ifdef LAB_ONLY
 		x = GetCycles();
 #endif
@@ -1819,48 +1827,44 @@ GameObjectManager::update(bool terrain, bool movers, bool other)
 		MCTimeTurretsUpdate = x;
 		x = GetCycles();
 #endif
-		if (weapons)
+		//-------------------------------------------------------
+		// Back to front, since releasing moves the last one in
+		// use into the released one's place.  Whatever stopped
+		// existing on its own goes back too.
+		for (int32_t i = (int32_t)weaponPool.getNumActive() - 1; i >= 0; i--)
 		{
-			for (size_t i = 0; i < numWeapons; i++)
+			WeaponBoltPtr obj = weaponPool.getActive(i);
+			if (!obj->getExists() || !obj->update())
 			{
-				if (weapons[i] && weapons[i]->getExists())
-				{
-					if (!weapons[i]->update())
-						weapons[i]->setExists(false);
-				}
+				obj->setExists(false);
+				weaponPool.release(obj);
 			}
 		}
-		if (carnage)
+		for (int32_t i = (int32_t)carnagePool.getNumActive() - 1; i >= 0; i--)
 		{
-			for (size_t i = 0; i < numCarnage; i++)
+			CarnagePtr obj = carnagePool.getActive(i);
+			if (!obj->getExists() || !obj->update())
 			{
-				if (carnage[i] && carnage[i]->getExists())
-				{
-					if (!carnage[i]->update())
-						carnage[i]->setExists(false);
-				}
+				obj->setExists(false);
+				carnagePool.release(obj);
 			}
 		}
-		if (lights)
+		for (int32_t i = (int32_t)lightPool.getNumActive() - 1; i >= 0; i--)
 		{
-			for (size_t i = 0; i < numLights; i++)
+			LightPtr obj = lightPool.getActive(i);
+			if (!obj->getExists() || !obj->update())
 			{
-				if (lights[i] && lights[i]->getExists())
-				{
-					if (!lights[i]->update())
-						lights[i]->setExists(false);
-				}
+				obj->setExists(false);
+				lightPool.release(obj);
 			}
 		}
-		if (artillery)
+		for (int32_t i = (int32_t)artilleryPool.getNumActive() - 1; i >= 0; i--)
 		{
-			for (size_t i = 0; i < numArtillery; i++)
+			ArtilleryPtr obj = artilleryPool.getActive(i);
+			if (!obj->getExists() || !obj->update())
 			{
-				if (artillery[i] && artillery[i]->getExists())
-				{
-					if (!artillery[i]->update())
-						artillery[i]->setExists(false);
-				}
+				obj->setExists(false);
+				artilleryPool.release(obj);
 			}
 		}
 #ifdef LAB_ONLY
@@ -2850,36 +2854,32 @@ GameObjectManager::updateAppearancesOnly(bool terrain, bool movers, bool other)
 				}
 			}
 		}*/
-		if (lights)
+		for (size_t i = 0; i < lightPool.getNumActive(); i++)
 		{
-			for (size_t i = 0; i < numLights; i++)
+			LightPtr obj = lightPool.getActive(i);
+			if (obj->getExists())
 			{
-				if (lights[i] && lights[i]->getExists())
+				if (obj->getAppearance()->recalcBounds())
 				{
-					if (lights[i]->getAppearance()->recalcBounds())
-					{
-						lights[i]->getAppearance()->update(false);
-						lights[i]->getAppearance()->setInView(1);
-					}
-					else
-						lights[i]->getAppearance()->setInView(0);
+					obj->getAppearance()->update(false);
+					obj->getAppearance()->setInView(1);
 				}
+				else
+					obj->getAppearance()->setInView(0);
 			}
 		}
-		if (artillery)
+		for (size_t i = 0; i < artilleryPool.getNumActive(); i++)
 		{
-			for (size_t i = 0; i < numArtillery; i++)
+			ArtilleryPtr obj = artilleryPool.getActive(i);
+			if (obj->getExists())
 			{
-				if (artillery[i] && artillery[i]->getExists())
+				if (obj->getAppearance()->recalcBounds())
 				{
-					if (artillery[i]->getAppearance()->recalcBounds())
-					{
-						artillery[i]->getAppearance()->update(false);
-						artillery[i]->getAppearance()->setInView(1);
-					}
-					else
-						artillery[i]->getAppearance()->setInView(0);
+					obj->getAppearance()->update(false);
+					obj->getAppearance()->setInView(1);
 				}
+				else
+					obj->getAppearance()->setInView(0);
 			}
 		}
 	}
@@ -3391,6 +3391,7 @@ GameObjectManager::Load(PacketFilePtr file, int32_t packetNum)
 		STOP(("Didn't load %d but instead %d Vehicles", maxVehicles, curVehicleNum));
 	if (curBoltNum != numWeapons)
 		STOP(("Didn't load %d but instead %d WeaponBolts", numWeapons, curBoltNum));
+	initPools();
 	rebuildCollidableList = true;
 	//---------------------------------------------------
 	// Finally, let's build the control building lists...
@@ -31,6 +31,10 @@
 //#include "dgate.h"
 //#include "dcollsn.h"
 
+#ifndef OBJPOOL_H
+#include "objpool.h"
+#endif
+
 class PacketFile;
 
 //---------------------------------------------------------------------------
@@ -150,6 +154,17 @@ typedef struct _ObjectManagerData
 	int32_t nextWatchId;
 } ObjectManagerData;
 
+enum _object_pool : int32_t
+{
+	OBJECT_POOL_WEAPONS,
+	OBJECT_POOL_CARNAGE,
+	OBJECT_POOL_LIGHTS,
+	OBJECT_POOL_ARTILLERY,
+	NUM_OBJECT_POOLS
+};
+
+extern ObjectPoolStats ObjectPoolStatistics[NUM_OBJECT_POOLS];
+
 class GameObjectManager
 {
 
@@ -213,11 +228,13 @@ public:
 	uint32_t nextWatchID;
 	GameObjectPtr* watchList;
 
-	int32_t currentWeaponsIndex; // points to next entry in rotating weapon array.
-	int32_t currentCarnageIndex; // points to next entry in rotating carnage
-		// list
-	int32_t currentLightIndex;
-	int32_t currentArtilleryIndex;
+	//---------------------------------------------------------
+	// Hand out the weapons, carnage, lights and artillery from
+	// the arrays above.  Only what's in use gets updated.
+	ObjectPool<WeaponBolt> weaponPool;
+	ObjectPool<Carnage> carnagePool;
+	ObjectPool<Light> lightPool;
+	ObjectPool<Artillery> artilleryPool;
 
 	bool rebuildCollidableList;
 
@@ -244,6 +261,8 @@ private:
 
 	void countObject(ObjDataLoader* objType);
 
+	void initPools(void);
+
 public:
 	PVOID operator new(size_t mySize);
 
@@ -317,9 +336,10 @@ public:
 
 	ArtilleryPtr getArtillery(void);
 
-	int32_t getNumArtillery(void) { return (numArtillery); }
+	// Only the strikes in use.
+	int32_t getNumArtillery(void) { return (artilleryPool.getNumActive()); }
 
-	ArtilleryPtr getArtillery(int32_t artilleryIndex) { return (artillery[artilleryIndex]); }
+	ArtilleryPtr getArtillery(int32_t artilleryIndex) { return (artilleryPool.getActive(artilleryIndex)); }
 
 	int32_t getNumGateControls(void) { return (numGateControls); }
 
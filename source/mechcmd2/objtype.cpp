@@ -63,9 +63,14 @@
 #include "weaponfx.h"
 #endif
 
+#ifndef FASTFILE_H
+#include "fastfile.h"
+#endif
+
 //---------------------------------------------------------------------------
 
 PacketFilePtr ObjectTypeManager::objectFile = nullptr;
+PacketFilePtr ObjectTypeManager::cookedFile = nullptr;
 UserHeapPtr ObjectTypeManager::objectTypeCache = nullptr;
 UserHeapPtr ObjectTypeManager::objectCache = nullptr;
 int32_t ObjectTypeManager::bridgeTypeHandle = 0xFFFFFFFF;
@@ -78,6 +83,130 @@ uint32_t NextIdNumber = 0x30000001; // Big number to indicate
 // This object is NOT a mission
 // part.  Trust Me. -ffs
 
+bool ObjectTypeUseCooked = true;
+bool ObjectTypeValidateCooked = false;
+bool ObjectTypeCookOnLoad = false;
+ObjectTypeLoadStats ObjectTypeLoadStatistics;
+
+static bool ObjectTypesCooked = false; // once a run is plenty
+
+//---------------------------------------------------------------------------
+// Size and time of a file, without reading it.  Opening one out of a
+// fastfile would unpack it, so those go by the directory's size alone.
+bool
+ObjectTypeGetStamp(const std::wstring_view& fileName, ObjectTypeFileStamp& stamp)
+{
+	struct _stat st;
+	if (_stat(fileName, &st) == 0)
+	{
+		stamp.length = (uint32_t)st.st_size;
+		stamp.modifiedTime = (uint32_t)st.st_mtime;
+		return (true);
+	}
+	size_t realSize = 0;
+	if (FastFileSize(fileName, realSize))
+	{
+		stamp.length = (uint32_t)realSize;
+		stamp.modifiedTime = 0;
+		return (true);
+	}
+	return (false);
+}
+
+//---------------------------------------------------------------------------
+static const char*
+ObjectTypeInitFailure(int32_t objectTypeNum)
+{
+	switch (objectTypeNum)
+	{
+	case BATTLEMECH_TYPE:
+		return (" ObjectTypeManager.load: unable to init Mech type ");
+	case VEHICLE_TYPE:
+		return (" ObjectTypeManager.load: unable to init Vehicle type ");
+	case TREEBUILDING_TYPE:
+	case BUILDING_TYPE:
+		return (" ObjectTypeManager.load: unable to init Building type ");
+	case TREE_TYPE:
+		return (" ObjectTypeManager.load: unable to init "
+				"TerrainObject:Tree type ");
+	case TERRAINOBJECT_TYPE:
+		return (" ObjectTypeManager.load: unable to init TerrainObject type ");
+	case WEAPONBOLT_TYPE:
+		return (" ObjectTypeManager.load: unable to init WeaponBolt type ");
+	case TURRET_TYPE:
+		return (" ObjectTypeManager.load: unable to init Turret type ");
+	case EXPLOSION_TYPE:
+		return (" ObjectTypeManager.load: unable to init Explosion type ");
+	case FIRE_TYPE:
+		return (" ObjectTypeManager.load: unable to init Fire type ");
+	case GATE_TYPE:
+		return (" ObjectTypeManager.load: unable to init Gate type ");
+	case ARTILLERY_TYPE:
+		return (" ObjectTypeManager.load: unable to init Artillery type ");
+	}
+	return (" ObjectTypeManager.load: can't create object ");
+}
+
+//***************************************************************************
+//* OBJECTTYPE RECORD class
+//***************************************************************************
+
+void
+ObjectTypeRecord::write(const void* src, size_t size)
+{
+	const uint8_t* bytes = (const uint8_t*)src;
+	data.insert(data.end(), bytes, bytes + size);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+ObjectTypeRecord::read(void* dest, size_t size)
+{
+	if ((data.size() - readOffset) < size)
+		return (false);
+	memcpy(dest, &data[readOffset], size);
+	readOffset += size;
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+
+void
+ObjectTypeRecord::writeBlock(const void* block, size_t size)
+{
+	uint32_t blockSize = block ? (uint32_t)size : 0;
+	write(&blockSize, sizeof(blockSize));
+	write(block, blockSize);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+ObjectTypeRecord::readBlock(PVOID& block, UserHeapPtr heap)
+{
+	block = nullptr;
+	uint32_t blockSize = 0;
+	if (!read(&blockSize, sizeof(blockSize)) || (blockSize > (data.size() - readOffset)))
+		return (false);
+	if (!blockSize)
+		return (true);
+	block = heap->Malloc(blockSize);
+	if (!block)
+		return (false);
+	return (read(block, blockSize));
+}
+
+//---------------------------------------------------------------------------
+// Pointers in the image are meaningless in another run.  Zero them so two
+// records of the same type compare equal.
+void
+ObjectTypeRecord::clearPointer(const void* objType, const void* member)
+{
+	size_t offset = imageStart + ((const uint8_t*)member - (const uint8_t*)objType) - sizeof(PVOID);
+	memset(&data[offset], 0, sizeof(PVOID));
+}
+
 //***************************************************************************
 //* OBJECTTYPE class
 //***************************************************************************
@@ -85,7 +214,12 @@ uint32_t NextIdNumber = 0x30000001; // Big number to indicate
 PVOID
 ObjectType::operator new(size_t ourSize)
 {
-	PVOID result = ObjectTypeManager::objectTypeCache->Malloc(ourSize);
+	PVOID result = ObjectTypeManager::objectTypeCache->Malloc(ourSize, HEAP_CALLER());
+	//---------------------------------------------------
+	// Start clean, so the padding in a cooked record is
+	// the same every time the type is cooked.
+	if (result)
+		memset(result, 0, ourSize);
 	return (result);
 }
 
@@ -165,6 +299,29 @@ ObjectType::init(FitIniFilePtr objFile)
 	return (NO_ERROR);
 }
 
+//---------------------------------------------------------------------------
+// Everything init left in the type, past the vtable (first thing in the
+// object, we only ever use single inheritance here), then what the pointers
+// point at.  Types that own more than appearName add theirs after this.
+void
+ObjectType::cook(ObjectTypeRecord& record)
+{
+	record.imageStart = record.data.size();
+	record.write((uint8_t*)this + sizeof(PVOID), getCookedSize() - sizeof(PVOID));
+	record.clearPointer(this, &appearName);
+	record.writeBlock(appearName, appearName ? (strlen(appearName) + 1) * sizeof(appearName[0]) : 0);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+ObjectType::uncook(ObjectTypeRecord& record)
+{
+	if (!record.read((uint8_t*)this + sizeof(PVOID), getCookedSize() - sizeof(PVOID)))
+		return (false);
+	return (record.readBlock((PVOID&)appearName, ObjectTypeManager::objectTypeCache));
+}
+
 //---------------------------------------------------------------------------
 
 void
@@ -244,6 +401,32 @@ ObjectTypeManager::init(const std::wstring_view& objectFileName, int32_t objectT
 	for (size_t i = 0; i < numObjectTypes; i++)
 		table[i] = nullptr;
 	//---------------------------------------------------------------------------
+	// The cooked object types live next to the object file.  CookObjectTypes
+	// rebuilds them from the ini data the first time through each run.
+	FullPathFileName cookedName;
+	cookedName.init(objectPath, objectFileName, ".cok");
+	if (ObjectTypeCookOnLoad && !ObjectTypesCooked)
+	{
+		ObjectTypesCooked = true;
+		cook(cookedName);
+	}
+	if (ObjectTypeUseCooked && fileExists(cookedName))
+	{
+		cookedFile = new PacketFile;
+		if (cookedFile->open(cookedName) != NO_ERROR)
+		{
+			delete cookedFile;
+			cookedFile = nullptr;
+		}
+		else if (!checkCooked())
+		{
+			ObjectTypeLoadStatistics.numCookedFilesStale++;
+			cookedFile->close();
+			delete cookedFile;
+			cookedFile = nullptr;
+		}
+	}
+	//---------------------------------------------------------------------------
 	// Since MC1 handled all of these MiscTerrainObjectTypes with one
 	// ObjectType, we set aside 5 separate typeHandles so they can be more
 	// logically managed. If we never have to load MC1/MCX missions, we can
@@ -274,6 +457,12 @@ ObjectTypeManager::destroy(void)
 		delete objectFile;
 		objectFile = nullptr;
 	}
+	if (cookedFile)
+	{
+		cookedFile->close();
+		delete cookedFile;
+		cookedFile = nullptr;
+	}
 	if (objectTypeCache)
 	{
 		delete objectTypeCache;
@@ -309,6 +498,7 @@ ObjectTypeManager::load(ObjectTypeNumber objTypeNum, bool noCacheOut, bool force
 		return nullptr;
 	if (!forceLoad && get(objTypeNum, false))
 		return (nullptr);
+	int64_t loadStart = GetCycles();
 	bool isMiscTerrObj = false;
 	int32_t objectTypeNum = -1;
 	ObjectTypePtr objType = nullptr;
@@ -319,6 +509,14 @@ ObjectTypeManager::load(ObjectTypeNumber objTypeNum, bool noCacheOut, bool force
 		objectTypeNum = TERRAINOBJECT_TYPE;
 		isMiscTerrObj = true;
 	}
+	else if ((objType = loadCooked(objTypeNum, objectTypeNum)) != nullptr)
+	{
+		//--------------------------------------------------------
+		// ValidateCookedObjectTypes loads it from the ini as well
+		// and keeps the ini one if the two don't match.
+		if (ObjectTypeValidateCooked)
+			objType = validateCooked(objType, objTypeNum, objectTypeNum);
+	}
 	else if (objectFile->seekPacket(objTypeNum) == NO_ERROR)
 	{
 		if (objTypeNum == 268)
@@ -329,141 +527,280 @@ ObjectTypeManager::load(ObjectTypeNumber objTypeNum, bool noCacheOut, bool force
 		// All new code here.  This will ask the objectType it is
 		// loading what kind of objectType it is and create it
 		// based on that instead of objTypeNum.
-		FitIniFile objTypeFile;
-		int32_t result = objTypeFile.open(objectFile, objectFile->getPacketSize());
-		if (result != NO_ERROR)
-			Fatal(objTypeNum, " ObjectTypeManager.load: can't create object ");
-		result = objTypeFile.seekBlock("ObjectClass");
-		if (result != NO_ERROR)
-			Fatal(objTypeNum, " ObjectTypeManager.load: can't create object ");
-		result = objTypeFile.readIdLong("ObjectTypeNum", objectTypeNum);
-		if (result != NO_ERROR)
+		objectTypeNum = readObjectClass(objTypeNum);
+		if (objectTypeNum == CRAPPY_OBJECT)
 			Fatal(objTypeNum, " ObjectTypeManager.load: can't create object ");
-		objTypeFile.close();
-		objectFile->seekPacket(objTypeNum);
 	}
 	else
 		Fatal(objTypeNum, " ObjectTypeManager.load: can't create object ");
 	//-----------------------------------------------------
 	// Now that we know what type it is, let's create it...
-	switch (objectTypeNum)
+	if (!objType)
 	{
-	case CRAPPY_OBJECT:
-		//----------------------------------------------
-		// In theory we can't ever get here.
-		// Because we did our jobs correctly!!
-		Fatal(CANT_LOAD_INVALID_OBJECT, " ObjectTypeManager.load: can't create object ");
-		break;
-	case BATTLEMECH_TYPE:
+		objType = loadFromIni(objTypeNum, objectTypeNum, isMiscTerrObj);
+		if (!isMiscTerrObj)
+			ObjectTypeLoadStatistics.numIniLoads++;
+	}
+	if ((objectTypeNum >= 0) && (objectTypeNum < NUM_OBJECT_TYPE_CLASSES))
 	{
-		objType = new BattleMechType;
-		objType->setObjTypeNum(objTypeNum);
-		if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
-			Fatal(objectTypeNum, " ObjectTypeManager.load: unable to init Mech type ");
+		ObjectTypeLoadStatistics.numLoads[objectTypeNum]++;
+		ObjectTypeLoadStatistics.loadCycles[objectTypeNum] += GetCycles() - loadStart;
 	}
-	break;
-	case VEHICLE_TYPE:
+	if (noCacheOut)
 	{
-		objType = new GroundVehicleType;
-		objType->setObjTypeNum(objTypeNum);
-		if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
-			Fatal(objectTypeNum, " ObjectTypeManager.load: unable to init Vehicle type ");
+		//---------------------------------------------------
+		// Do NOT EVER cache this object type out.  FXs, etc.
+		// This means I'm preloading it!!
+		objType->makeLovable();
+		if (objType->getExplosionObject() > 0)
+			load(objType->getExplosionObject());
 	}
-	break;
+	table[objTypeNum] = objType;
+	return (objType);
+}
+
+//---------------------------------------------------------------------------
+
+ObjectTypePtr
+ObjectTypeManager::newObjectType(int32_t objectTypeNum)
+{
+	switch (objectTypeNum)
+	{
+	case BATTLEMECH_TYPE:
+		return (new BattleMechType);
+	case VEHICLE_TYPE:
+		return (new GroundVehicleType);
 	case TREEBUILDING_TYPE:
 	case BUILDING_TYPE:
-	{
-		objType = new BuildingType;
-		objType->setObjTypeNum(objTypeNum);
-		if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
-			Fatal(objectTypeNum, " ObjectTypeManager.load: unable to init Building type ");
-	}
-	break;
+		return (new BuildingType);
 	case TREE_TYPE:
-	{
-		objType = new TerrainObjectType;
-		objType->setObjTypeNum(objTypeNum);
-		if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
-			Fatal(objectTypeNum,
-				" ObjectTypeManager.load: unable to init "
-				"TerrainObject:Tree type ");
-	}
-	break;
 	case TERRAINOBJECT_TYPE:
-	{
-		objType = new TerrainObjectType;
-		objType->setObjTypeNum(objTypeNum);
-		if (isMiscTerrObj)
-			((TerrainObjectTypePtr)objType)->initMiscTerrObj(objTypeNum);
-		else if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
-			Fatal(objectTypeNum, " ObjectTypeManager.load: unable to init TerrainObject type ");
-	}
-	break;
+		return (new TerrainObjectType);
 	case WEAPONBOLT_TYPE:
+		return (new WeaponBoltType);
+	case TURRET_TYPE:
+		return (new TurretType);
+	case EXPLOSION_TYPE:
+		return (new ExplosionType);
+	case FIRE_TYPE:
+		return (new FireType);
+	case GATE_TYPE:
+		return (new GateType);
+	case ARTILLERY_TYPE:
+		return (new ArtilleryType);
+	}
+	return (nullptr);
+}
+
+//---------------------------------------------------------------------------
+// What kind of objectType the packet says it is, CRAPPY_OBJECT if it won't
+// say.  Leaves the object file at the start of the packet.
+int32_t
+ObjectTypeManager::readObjectClass(ObjectTypeNumber objTypeNum)
+{
+	int32_t objectTypeNum = CRAPPY_OBJECT;
+	if (objectFile->seekPacket(objTypeNum) != NO_ERROR)
+		return (CRAPPY_OBJECT);
+	FitIniFile objTypeFile;
+	if ((objTypeFile.open(objectFile, objectFile->getPacketSize()) != NO_ERROR) || (objTypeFile.seekBlock("ObjectClass") != NO_ERROR) || (objTypeFile.readIdLong("ObjectTypeNum", objectTypeNum) != NO_ERROR))
+		objectTypeNum = CRAPPY_OBJECT;
+	objTypeFile.close();
+	objectFile->seekPacket(objTypeNum);
+	return (objectTypeNum);
+}
+
+//---------------------------------------------------------------------------
+// The old way, field by field out of the packet's FitIniFile.  Expects the
+// object file to be at the start of the packet.
+ObjectTypePtr
+ObjectTypeManager::loadFromIni(ObjectTypeNumber objTypeNum, int32_t objectTypeNum, bool isMiscTerrObj, bool mustLoad)
+{
+	ObjectTypePtr objType = newObjectType(objectTypeNum);
+	if (!objType)
 	{
-		objType = new WeaponBoltType;
-		objType->setObjTypeNum(objTypeNum);
-		if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
-			Fatal(objectTypeNum, " ObjectTypeManager.load: unable to init WeaponBolt type ");
+		//----------------------------------------------
+		// In theory we can't ever get here.
+		// Because we did our jobs correctly!!
+		if (mustLoad)
+			Fatal(CANT_LOAD_INVALID_OBJECT, " ObjectTypeManager.load: can't create object ");
+		return (nullptr);
 	}
-	break;
-	case TURRET_TYPE:
+	objType->setObjTypeNum(objTypeNum);
+	if (isMiscTerrObj)
+		((TerrainObjectTypePtr)objType)->initMiscTerrObj(objTypeNum);
+	else if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
 	{
-		objType = new TurretType;
-		objType->setObjTypeNum(objTypeNum);
-		if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
-			Fatal(objectTypeNum, " ObjectTypeManager.load: unable to init Turret type ");
+		if (mustLoad)
+			Fatal(objectTypeNum, ObjectTypeInitFailure(objectTypeNum));
+		delete objType;
+		objType = nullptr;
 	}
-	break;
-	case EXPLOSION_TYPE:
+	return (objType);
+}
+
+//---------------------------------------------------------------------------
+// The one staleness check.  The object file and everything the types read
+// besides must be the size and time they were when cooked; nothing is read
+// or checksummed.  After this the records are loaded on trust.
+bool
+ObjectTypeManager::checkCooked(void)
+{
+	if ((cookedFile->getNumPackets() < 1) || (cookedFile->seekPacket(0) != NO_ERROR) || (cookedFile->getPacketSize() < (int32_t)sizeof(ObjectTypeManifest)))
+		return (false);
+	ObjectTypeRecord record;
+	record.data.resize(cookedFile->getPacketSize());
+	if (cookedFile->readPacket(0, record.data.data()) != (int32_t)record.data.size())
+		return (false);
+	ObjectTypeManifest manifest;
+	ObjectTypeFileStamp stamp;
+	if (!record.read(&manifest, sizeof(manifest)) || (manifest.id != OBJECT_TYPE_MANIFEST_ID) || (manifest.version != OBJECT_TYPE_RECORD_VERSION))
+		return (false);
+	if (!ObjectTypeGetStamp(objectFile->getFilename(), stamp) || memcmp(&stamp, &manifest.objectFile, sizeof(stamp)))
+		return (false);
+	for (size_t i = 0; i < manifest.numDependencies; i++)
 	{
-		objType = new ExplosionType;
-		objType->setObjTypeNum(objTypeNum);
-		if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
-			Fatal(objectTypeNum, " ObjectTypeManager.load: unable to init Explosion type ");
+		ObjectTypeDependency dependency;
+		if (!record.read(&dependency, sizeof(dependency)))
+			return (false);
+		dependency.fileName[MAX_DEPENDENCY_NAME - 1] = 0;
+		if (!ObjectTypeGetStamp(dependency.fileName, stamp) || memcmp(&stamp, &dependency.stamp, sizeof(stamp)))
+			return (false);
 	}
-	break;
-	case FIRE_TYPE:
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+// A type straight out of its cooked record, or nullptr if there isn't one.
+// checkCooked already said the file is current.
+ObjectTypePtr
+ObjectTypeManager::loadCooked(ObjectTypeNumber objTypeNum, int32_t& objectTypeNum)
+{
+	if (!ObjectTypeUseCooked || !cookedFile || (objTypeNum >= cookedFile->getNumPackets()))
+		return (nullptr);
+	if ((cookedFile->seekPacket(objTypeNum) != NO_ERROR) || (cookedFile->getPacketSize() < (int32_t)sizeof(ObjectTypeRecordHeader)))
+		return (nullptr);
+	ObjectTypeRecord record;
+	record.data.resize(cookedFile->getPacketSize());
+	ObjectTypeRecordHeader header;
+	ObjectTypePtr objType = nullptr;
+	if ((cookedFile->readPacket(objTypeNum, record.data.data()) == (int32_t)record.data.size()) && record.read(&header, sizeof(header)) &&
+		(header.id == OBJECT_TYPE_RECORD_ID) && (header.version == OBJECT_TYPE_RECORD_VERSION) && (header.objTypeNum == objTypeNum))
+		objType = newObjectType(header.objectTypeNum);
+	if (objType)
 	{
-		objType = new FireType;
-		objType->setObjTypeNum(objTypeNum);
-		if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
-			Fatal(objectTypeNum, " ObjectTypeManager.load: unable to init Fire type ");
+		if ((objType->getCookedSize() != header.imageSize) || !objType->uncook(record))
+		{
+			delete objType;
+			objType = nullptr;
+		}
 	}
-	break;
-	case GATE_TYPE:
+	if (!objType)
 	{
-		objType = new GateType;
-		objType->setObjTypeNum(objTypeNum);
-		if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
-			Fatal(objectTypeNum, " ObjectTypeManager.load: unable to init Gate type ");
+		ObjectTypeLoadStatistics.numCookedRejected++;
+		return (nullptr);
 	}
-	break;
-	case ARTILLERY_TYPE:
+	objectTypeNum = header.objectTypeNum;
+	ObjectTypeLoadStatistics.numCookedLoads++;
+	return (objType);
+}
+
+//---------------------------------------------------------------------------
+// The ini is the oracle.  Load the type the old way too and compare the two
+// as records.  Whichever survives is returned, the other is deleted.
+ObjectTypePtr
+ObjectTypeManager::validateCooked(ObjectTypePtr cookedType, ObjectTypeNumber objTypeNum, int32_t objectTypeNum)
+{
+	if (objectFile->seekPacket(objTypeNum) != NO_ERROR)
+		return (cookedType);
+	ObjectTypePtr iniType = loadFromIni(objTypeNum, objectTypeNum, false, false);
+	if (!iniType)
+		return (cookedType);
+	ObjectTypeLoadStatistics.numValidations++;
+	ObjectTypeRecord cookedRecord;
+	ObjectTypeRecord iniRecord;
+	cookedType->cook(cookedRecord);
+	iniType->cook(iniRecord);
+	if (cookedRecord.data == iniRecord.data)
 	{
-		objType = new ArtilleryType;
-		objType->setObjTypeNum(objTypeNum);
-		if (objType->init(objectFile, objectFile->getPacketSize()) != NO_ERROR)
-			Fatal(objectTypeNum, " ObjectTypeManager.load: unable to init Artillery type ");
+		delete iniType;
+		return (cookedType);
 	}
-	break;
-	default:
-		// return(nullptr);
-		// Fatal(OBJECT_TYPE_NUMBER_UNDEFINED, " ObjectTypeManager.load:
-		// undefined objType ");
-		NODEFAULT;
+	ObjectTypeLoadStatistics.numValidationFailures++;
+	delete cookedType;
+	return (iniType);
+}
+
+//---------------------------------------------------------------------------
+// Loads every type in the object file from its ini data and writes it out as
+// a record, one packet per type.  Packets that aren't a type we know how to
+// load are written empty, and load the old way.  The manifest goes in packet
+// 0, which has to be written first, so the records are held until the end.
+int32_t
+ObjectTypeManager::cook(const std::wstring_view& cookedFileName)
+{
+	int32_t numPackets = objectFile->getNumPackets();
+	if (numPackets < 1)
+		return (NO_ERROR);
+	std::vector<ObjectTypeRecord> records(numPackets);
+	std::vector<ObjectTypeDependency> dependencies;
+	ObjectTypeLoadStatistics.numRecordsCooked = 0;
+	for (size_t i = 1; i < numPackets; i++)
+	{
+		ObjectTypePtr objType = nullptr;
+		int32_t objectTypeNum = readObjectClass(i);
+		if (objectTypeNum != CRAPPY_OBJECT)
+			objType = loadFromIni(i, objectTypeNum, false, false);
+		if (!objType)
+			continue;
+		ObjectTypeRecordHeader header;
+		header.id = OBJECT_TYPE_RECORD_ID;
+		header.version = OBJECT_TYPE_RECORD_VERSION;
+		header.objTypeNum = i;
+		header.objectTypeNum = objectTypeNum;
+		header.imageSize = objType->getCookedSize();
+		records[i].write(&header, sizeof(header));
+		objType->cook(records[i]);
+		//-----------------------------------------------
+		// Each file read besides goes in the manifest
+		// once, however many types share it.
+		ObjectTypeDependency dependency;
+		memset(&dependency, 0, sizeof(dependency));
+		if (objType->getDependency(dependency.fileName, MAX_DEPENDENCY_NAME) && ObjectTypeGetStamp(dependency.fileName, dependency.stamp))
+		{
+			bool known = false;
+			for (auto& other : dependencies)
+				known = known || (_stricmp(other.fileName, dependency.fileName) == 0);
+			if (!known)
+				dependencies.push_back(dependency);
+		}
+		ObjectTypeLoadStatistics.numRecordsCooked++;
+		delete objType;
 	}
-	if (noCacheOut)
+	ObjectTypeManifest manifest;
+	manifest.id = OBJECT_TYPE_MANIFEST_ID;
+	manifest.version = OBJECT_TYPE_RECORD_VERSION;
+	if (!ObjectTypeGetStamp(objectFile->getFilename(), manifest.objectFile))
+		return (-1);
+	manifest.numDependencies = (uint32_t)dependencies.size();
+	records[0].write(&manifest, sizeof(manifest));
+	records[0].write(dependencies.data(), dependencies.size() * sizeof(ObjectTypeDependency));
+	PacketFile cooked;
+	int32_t result = cooked.create(cookedFileName);
+	if (result != NO_ERROR)
+		return (result);
+	cooked.reserve(numPackets);
+	for (size_t i = 0; i < numPackets; i++)
 	{
-		//---------------------------------------------------
-		// Do NOT EVER cache this object type out.  FXs, etc.
-		// This means I'm preloading it!!
-		objType->makeLovable();
-		if (objType->getExplosionObject() > 0)
-			load(objType->getExplosionObject());
+		if (records[i].data.empty())
+		{
+			uint8_t nothing = 0;
+			cooked.writePacket(i, &nothing, 0, STORAGE_TYPE_NUL);
+		}
+		else
+			cooked.writePacket(i, records[i].data.data(), records[i].data.size());
 	}
-	table[objTypeNum] = objType;
-	return (objType);
+	cooked.close();
+	return (NO_ERROR);
 }
 
 //---------------------------------------------------------------------------
@@ -22,6 +22,90 @@
 
 #define MAX_NAME 25
 
+//---------------------------------------------------------------------------
+// Cooked object types.  A record is one fully initialized type, everything
+// init left in it past the vtable, followed by whatever its pointers point
+// at.  The cooked file holds one record per packet of the object file, so a
+// type loads with a copy instead of a trip through its FitIniFile.
+//
+// Packet 0 (never a type) is the manifest: the size and time of the object
+// file and of every other file a type read (the mech CSVs) when it was
+// cooked.  It's checked once when the cooked file opens; a stale file is
+// dropped whole and the records themselves are taken on trust.
+
+#define OBJECT_TYPE_RECORD_ID 0x4B4F4F43 // 'COOK'
+#define OBJECT_TYPE_MANIFEST_ID 0x5453464D // 'MFST'
+#define OBJECT_TYPE_RECORD_VERSION 2
+#define MAX_DEPENDENCY_NAME 256
+
+typedef struct _ObjectTypeRecordHeader
+{
+	uint32_t id;
+	uint32_t version;
+	int32_t objTypeNum;
+	int32_t objectTypeNum; // class, from the ObjectClass block
+	uint32_t imageSize;
+} ObjectTypeRecordHeader;
+
+typedef struct _ObjectTypeFileStamp
+{
+	uint32_t length;
+	uint32_t modifiedTime; // zero for a file out of a fastfile
+} ObjectTypeFileStamp;
+
+typedef struct _ObjectTypeDependency
+{
+	wchar_t fileName[MAX_DEPENDENCY_NAME];
+	ObjectTypeFileStamp stamp;
+} ObjectTypeDependency;
+
+typedef struct _ObjectTypeManifest
+{
+	uint32_t id;
+	uint32_t version;
+	ObjectTypeFileStamp objectFile;
+	uint32_t numDependencies; // ObjectTypeDependency entries follow
+} ObjectTypeManifest;
+
+class ObjectTypeRecord
+{
+public:
+	std::vector<uint8_t> data;
+	size_t imageStart; // where the type itself starts in data
+	size_t readOffset;
+
+public:
+	ObjectTypeRecord(void)
+	{
+		imageStart = 0;
+		readOffset = 0;
+	}
+
+	void write(const void* src, size_t size);
+	bool read(void* dest, size_t size);
+
+	void writeBlock(const void* block, size_t size);
+	bool readBlock(PVOID& block, UserHeapPtr heap);
+
+	void clearPointer(const void* objType, const void* member);
+};
+
+typedef struct _ObjectTypeLoadStats
+{
+	uint32_t numIniLoads;
+	uint32_t numCookedLoads;
+	uint32_t numCookedRejected; // records that didn't fit their type, fell back to the ini
+	uint32_t numCookedFilesStale; // cooked files dropped on open
+	uint32_t numValidations;
+	uint32_t numValidationFailures; // cooked and ini types didn't match
+	uint32_t numRecordsCooked;
+	uint32_t numLoads[NUM_OBJECT_TYPE_CLASSES];
+	int64_t loadCycles[NUM_OBJECT_TYPE_CLASSES];
+} ObjectTypeLoadStats;
+
+bool
+ObjectTypeGetStamp(const std::wstring_view& fileName, ObjectTypeFileStamp& stamp);
+
 //---------------------------------------------------------------------------
 // Classes
 
@@ -69,6 +153,14 @@ public:
 
 	virtual ~ObjectType(void) { destroy(void); }
 
+	virtual size_t getCookedSize(void) { return (sizeof(ObjectType)); }
+
+	virtual void cook(ObjectTypeRecord& record);
+
+	virtual bool uncook(ObjectTypeRecord& record);
+
+	virtual bool getDependency(wchar_t* fileName, size_t bufferSize) { return (false); }
+
 	virtual void destroy(void);
 
 	virtual GameObjectPtr createInstance(void);
@@ -138,6 +230,7 @@ public:
 	static UserHeapPtr objectTypeCache;
 	static UserHeapPtr objectCache;
 	static PacketFilePtr objectFile;
+	static PacketFilePtr cookedFile;
 
 	//--------------------------------------------------------
 	// Following is done to maintain compatibility with MC1...
@@ -165,10 +258,31 @@ public:
 
 	ObjectTypePtr load(ObjectTypeNumber objTypeNum, bool noCacheOut = true, bool forceLoad = false);
 
+	ObjectTypePtr newObjectType(int32_t objectTypeNum);
+
+	int32_t readObjectClass(ObjectTypeNumber objTypeNum);
+
+	ObjectTypePtr loadFromIni(ObjectTypeNumber objTypeNum, int32_t objectTypeNum, bool isMiscTerrObj, bool mustLoad = true);
+
+	bool checkCooked(void);
+
+	ObjectTypePtr loadCooked(ObjectTypeNumber objTypeNum, int32_t& objectTypeNum);
+
+	ObjectTypePtr validateCooked(ObjectTypePtr cookedType, ObjectTypeNumber objTypeNum, int32_t objectTypeNum);
+
+	int32_t cook(const std::wstring_view& cookedFileName);
+
 	ObjectTypePtr get(ObjectTypeNumber objTypeNum, bool loadIt = true);
 
 	GameObjectPtr create(ObjectTypeNumber objTypeNum);
 };
 
+//---------------------------------------------------------------------------
+
+extern bool ObjectTypeUseCooked;
+extern bool ObjectTypeValidateCooked;
+extern bool ObjectTypeCookOnLoad;
+extern ObjectTypeLoadStats ObjectTypeLoadStatistics;
+
 //---------------------------------------------------------------------------
 #endif
@@ -184,18 +184,10 @@ SimpleCamera::update()
 	if (pObject)
 	{
 		turn++; // Must increment this now or matrices NEVER change!!
-		// reset the TGL RAM pools.
-		colorPool->reset();
-		vertexPool->reset();
-		facePool->reset();
-		shadowPool->reset();
-		trianglePool->reset();
-		// reset the TGL RAM pools.
-		colorPool->reset();
-		vertexPool->reset();
-		facePool->reset();
-		shadowPool->reset();
-		trianglePool->reset();
+		// Nobody else starts frames in logistics.  In a mission,
+		// Mission::update does.
+		if (!bIsInMission)
+			frameArena->newFrame();
 		mcTextureManager->clearArrays();
 		mcTextureManager->update();
 		Camera::update();
@@ -152,7 +152,7 @@ int32_t AttitudeEffectOnMovePath[NUM_ATTITUDES][3] = {
 PVOID
 TacticalOrder::operator new(size_t mySize)
 {
-	PVOID result = systemHeap->Malloc(mySize);
+	PVOID result = systemHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
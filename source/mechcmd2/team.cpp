@@ -36,6 +36,9 @@ TeamPtr Team::home = nullptr;
 TeamPtr Team::teams[MAX_TEAMS] = {
 	nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
 SortListPtr Team::sortList = nullptr;
+std::atomic<uint32_t> Team::tacticalCacheHits = 0;
+std::atomic<uint32_t> Team::tacticalCacheMisses = 0;
+std::atomic<uint32_t> Team::tacticalCacheInvalidations = 0;
 
 bool useRealLOS = true;
 #ifdef LAB_ONLY
@@ -47,6 +50,8 @@ extern LineElement* debugLines[];
 extern float maxVisualRange;
 extern int32_t visualRangeTable[];
 extern uint32_t MaxTreeLOSCellBlock;
+extern int32_t turn;
+extern float MapCellDiagonal;
 
 //***************************************************************************
 // TEAM class
@@ -59,6 +64,7 @@ Team::init(void)
 	rosterSize = 0;
 	objectives.Clear();
 	numPrimaryObjectives = 0;
+	clearTacticalCache();
 	// numMechs = 0;
 	// numVehicles = 0;
 	// numElementals = 0;
@@ -200,6 +206,90 @@ Team::getContacts(
 
 //---------------------------------------------------------------------------
 
+void
+Team::clearTacticalCache(void)
+{
+	std::lock_guard<std::mutex> lock(tacticalLock);
+	for (size_t i = 0; i < TACTICAL_CACHE_SIZE; i++)
+		tacticalCache[i].frame = -1;
+}
+
+//---------------------------------------------------------------------------
+
+TacticalEval
+Team::getTacticalEval(std::unique_ptr<Mover> attacker, GameObjectPtr target)
+{
+	//-------------------------------------------------------------
+	// Direct mapped. A stale entry, one from another range bucket,
+	// or someone else's pair in our slot all just get recalced...
+	GameObjectWatchID attackerWID = attacker->getWatchID();
+	GameObjectWatchID targetWID = target->getWatchID();
+	float distance = attacker->distanceFrom(target->getPosition());
+	int32_t rangeBucket = (int32_t)(distance / TACTICAL_RANGE_BUCKET);
+	TacticalEval* slot =
+		&tacticalCache[((attackerWID * 31) ^ targetWID) & (TACTICAL_CACHE_SIZE - 1)];
+	{
+		std::lock_guard<std::mutex> lock(tacticalLock);
+		if ((slot->frame == turn) && (slot->attackerWID == attackerWID) && (slot->targetWID == targetWID) && (slot->rangeBucket == rangeBucket))
+		{
+			tacticalCacheHits++;
+			return (*slot);
+		}
+		tacticalCacheMisses++;
+	}
+	//--------------------------------------------------------
+	// Worked out without the lock, since it's the slow part...
+	TacticalEval eval;
+	eval.frame = turn;
+	eval.attackerWID = attackerWID;
+	eval.targetWID = targetWID;
+	eval.rangeBucket = rangeBucket;
+	eval.threatRating = target->getThreatRating();
+	eval.bestWeaponRange = attacker->getOptimalFireRange();
+	eval.attackChance = 0.0;
+	//-----------------------------------------------------------
+	// Same weapon-fit tests calcWeaponsStatus() makes, short of
+	// facing and line-of-sight, which change too fast to cache...
+	if (attacker->canFireWeapons() && (distance > attacker->getMinFireRange()) && (distance < attacker->getMaxFireRange()))
+		for (size_t curWeapon = 0; curWeapon < attacker->numWeapons; curWeapon++)
+		{
+			int32_t weaponIndex = attacker->numOther + curWeapon;
+			if (!attacker->isWeaponWorking(weaponIndex))
+				continue;
+			if (!attacker->weaponInRange(weaponIndex, distance, MapCellDiagonal))
+				continue;
+			float odds =
+				attacker->calcAttackChance(target, -1, scenarioTime, weaponIndex, 0.0, nullptr);
+			if (odds > eval.attackChance)
+				eval.attackChance = odds;
+		}
+	std::lock_guard<std::mutex> lock(tacticalLock);
+	*slot = eval;
+	return (eval);
+}
+
+//---------------------------------------------------------------------------
+
+void
+Team::invalidateTacticalEvals(GameObjectWatchID objectWID)
+{
+	for (size_t i = 0; i < MAX_TEAMS; i++)
+	{
+		if (!teams[i])
+			continue;
+		std::lock_guard<std::mutex> lock(teams[i]->tacticalLock);
+		TacticalEval* cache = teams[i]->tacticalCache;
+		for (size_t j = 0; j < TACTICAL_CACHE_SIZE; j++)
+			if ((cache[j].frame != -1) && ((cache[j].attackerWID == objectWID) || (cache[j].targetWID == objectWID)))
+			{
+				cache[j].frame = -1;
+				tacticalCacheInvalidations++;
+			}
+	}
+}
+
+//---------------------------------------------------------------------------
+
 bool
 Team::hasSensorContact(int32_t teamID)
 {
@@ -40,6 +40,31 @@ typedef struct _TeamData
 	GameObjectWatchID roster[MAX_MOVERS_PER_TEAM];
 } TeamData;
 
+//---------------------------------------------------------------------------
+// Per-frame tactical evaluations. calcAttackPlan(), calcBestTarget() and
+// friends ask the same attacker/target questions over and over, for every
+// pilot on the team, several times a brain tick. Each team caches the
+// answers it has worked out this frame (turn), keyed by attacker, target
+// and range bucket. An entry is dropped early if either side takes damage
+// or loses a weapon...
+//
+// requesttarget asks from brain workers, so the cache is only touched
+// under the team's tacticalLock and callers get a copy of the entry.
+
+#define TACTICAL_CACHE_SIZE 256 // must be a power of 2
+#define TACTICAL_RANGE_BUCKET 30.0 // meters
+
+typedef struct _TacticalEval
+{
+	int32_t frame; // turn it was made, or -1 if unused
+	GameObjectWatchID attackerWID;
+	GameObjectWatchID targetWID;
+	int32_t rangeBucket;
+	int32_t threatRating; // the target's
+	float bestWeaponRange; // attacker's optimal fire range
+	float attackChance; // best single weapon's chance, 0.0 if none can fire
+} TacticalEval;
+
 typedef struct _TeamStaticData
 {
 	int32_t numTeams;
@@ -63,6 +88,11 @@ public:
 	CObjectives objectives;
 	int32_t numPrimaryObjectives;
 
+	//---------------
+	// tactical cache
+	TacticalEval tacticalCache[TACTICAL_CACHE_SIZE];
+	std::mutex tacticalLock;
+
 	//------------------
 	// static class info
 	static int32_t numTeams;
@@ -71,6 +101,9 @@ public:
 	static SortListPtr sortList;
 	static wchar_t relations[MAX_TEAMS][MAX_TEAMS];
 	static bool noPain[MAX_TEAMS];
+	static std::atomic<uint32_t> tacticalCacheHits; // all teams, from any thread
+	static std::atomic<uint32_t> tacticalCacheMisses;
+	static std::atomic<uint32_t> tacticalCacheInvalidations;
 
 public:
 	virtual void init(void);
@@ -112,6 +145,12 @@ public:
 
 	void addToGUI(void);
 
+	TacticalEval getTacticalEval(std::unique_ptr<Mover> attacker, GameObjectPtr target);
+
+	void clearTacticalCache(void);
+
+	static void invalidateTacticalEvals(GameObjectWatchID objectWID);
+
 	Stuff::Vector3D calcEscapeVector(std::unique_ptr<Mover> mover, float threatRange);
 
 	void statusCount(int32_t* statusTally);
@@ -68,6 +68,8 @@ public:
 
 	virtual int32_t init(std::unique_ptr<File> objFile, uint32_t fileSize);
 
+	virtual size_t getCookedSize(void) { return (sizeof(TerrainObjectType)); }
+
 	int32_t init(FitIniFilePtr objFile);
 
 	~TerrainObjectType(void) { destroy(void); }
@@ -84,6 +84,8 @@ public:
 
 	virtual int32_t init(std::unique_ptr<File> objFile, uint32_t fileSize);
 
+	virtual size_t getCookedSize(void) { return (sizeof(TurretType)); }
+
 	int32_t init(FitIniFilePtr objFile);
 
 	~TurretType(void) { destroy(void); }
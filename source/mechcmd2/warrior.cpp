@@ -32,6 +32,11 @@
 #include "turret.h"
 #include "bldng.h"
 #include "elemntl.h"
+#include "framearena.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #define TESTING_WITH_PLAYER 1
 
@@ -105,6 +110,23 @@ float CommandUpdateFrequency = 6.0;
 float PilotCheckUpdateFrequency = 1.0;
 float ThreatAnalysisFrequency = 5.0;
 
+//---------------------------------------------------------------
+// Brain scheduling. Each tier scales BrainUpdateFrequency, and no
+// more than BrainsPerFrame brains out of combat run in one frame
+// (0 is no limit). Combat brains are never held back...
+float BrainTierScale[NUM_BRAIN_TIERS] = {1.0, 1.5, 2.0, 4.0};
+float BrainAlertRange = 1500.0;
+float BrainDormantRange = 4000.0;
+float BrainRecentDamageTime = 10.0;
+int32_t BrainsPerFrame = 8;
+int32_t BrainFrame = -1;
+int32_t BrainsRunThisFrame = 0;
+int32_t BrainPassTurn = -1; // turn updateBrains last ran the brains in
+
+uint32_t BrainTierCount[NUM_BRAIN_TIERS] = {0, 0, 0, 0};
+uint32_t BrainBudgetOverruns = 0;
+uint32_t BrainWakeups = 0;
+
 int32_t PilotCheckModifierTable[2] = {25, 25};
 
 float SkillWeightings[Skill::numberofskills] = {1.0, 1.0, 1.0};
@@ -136,8 +158,8 @@ float MechWarrior::minSkill = 1;
 float MechWarrior::maxSkill = 100;
 int32_t MechWarrior::increaseCap = 100;
 float MechWarrior::maxVisualRadius = 100.0;
-int32_t MechWarrior::curEventID = 0;
-int32_t MechWarrior::curEventTrigger = 0;
+thread_local int32_t MechWarrior::curEventID = 0;
+thread_local int32_t MechWarrior::curEventTrigger = 0;
 MechWarrior* MechWarrior::warriorList[MAX_WARRIORS];
 
 int32_t LastMoveCalcErr = 0;
@@ -156,12 +178,12 @@ extern wchar_t AttitudeEffect[NUM_ATTITUDES][6];
 extern TeamPtr homeTeam;
 #endif
 // extern GlobalMapPtr GlobalMoveMap[2];
-extern MoverGroupPtr CurGroup;
-extern GameObjectPtr CurObject;
-extern int32_t CurObjectClass;
-extern std::unique_ptr<MechWarrior> CurWarrior;
-extern GameObjectPtr CurContact;
-extern int32_t CurAlarm;
+extern thread_local MoverGroupPtr CurGroup;
+extern thread_local GameObjectPtr CurObject;
+extern thread_local int32_t CurObjectClass;
+extern thread_local std::unique_ptr<MechWarrior> CurWarrior;
+extern thread_local GameObjectPtr CurContact;
+extern thread_local int32_t CurAlarm;
 extern float MapCellDiagonal;
 extern float WeaponRanges[NUM_WEAPON_RANGE_TYPES][2];
 
@@ -246,7 +268,7 @@ GetMissionTurn(void)
 PVOID
 TargetPriorityList::operator new(size_t mySize)
 {
-	PVOID result = missionHeap->Malloc(mySize);
+	PVOID result = missionHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
@@ -744,7 +766,7 @@ TargetPriorityList::calcTarget(
 PVOID
 MechWarrior::operator new(size_t mySize)
 {
-	PVOID result = missionHeap->Malloc(mySize);
+	PVOID result = missionHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
@@ -839,6 +861,8 @@ MechWarrior::init(bool create)
 	for (i = 0; i < NUM_PILOT_DEBUG_STRINGS; i++)
 		debugStrings[i][0] = nullptr;
 	brainUpdate = (float)(numWarriors % 30) * 0.2;
+	brainTier = BRAIN_TIER_COMBAT;
+	brainWake = false;
 	combatUpdate = (float)(numWarriors % 15) * 0.1;
 	movementUpdate = (float)(numWarriors % 15) * 0.2;
 	for (size_t w = 0; w < MAX_WEAPONS_PER_MOVER; w++)
@@ -1298,6 +1322,8 @@ MechWarrior::clear(void)
 	for (i = 0; i < NUM_PILOT_DEBUG_STRINGS; i++)
 		debugStrings[i][0] = nullptr;
 	// brainUpdate = (float)(numWarriors % 30) * 0.2;
+	brainTier = BRAIN_TIER_COMBAT;
+	brainWake = false;
 	// combatUpdate = (float)(numWarriors % 15) * 0.1;
 	// movementUpdate = (float)(numWarriors % 15) * 0.2;
 	for (size_t w = 0; w < MAX_WEAPONS_PER_MOVER; w++)
@@ -1966,14 +1992,9 @@ MechWarrior::setBrain(int32_t brainHandle)
 //---------------------------------------------------------------------------
 extern int64_t MCTimeRunBrainUpdate;
 
-int32_t
-MechWarrior::runBrain(void)
+void
+MechWarrior::thinkBrain(void)
 {
-	//	if (teamId  > -1)
-	//		if (teamId != Team::home->getId())
-	//		return(0);
-	if (!brain)
-		return (0);
 	//----------------------------------
 	// Param 1 is the ID of this mech...
 	// ABLi_setIntegerParam(brainParams, 0, ((BattleMechPtr)owner)->ID);
@@ -1996,6 +2017,28 @@ MechWarrior::runBrain(void)
 	ModuleInfo moduleInfo;
 	brain->getInfo(&moduleInfo);
 	brain->execute();
+	CurGroup = nullptr;
+	CurObject = nullptr;
+	CurObjectClass = 0;
+	CurWarrior = nullptr;
+	CurContact = nullptr;
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+MechWarrior::applyBrain(ABLCommandBuffer* deferredCalls)
+{
+	CurGroup = getGroup();
+	CurObject = (GameObjectPtr)getVehicle();
+	CurObjectClass = getVehicle()->getObjectClass();
+	CurWarrior = this;
+	CurContact = nullptr;
+	//----------------------------------------------------
+	// If the brain ran on a worker context, replay the
+	// side-effecting calls it queued up, in script order...
+	if (deferredCalls)
+		ABLi_applyDeferredCalls(deferredCalls);
 #ifdef LAB_ONLY
 	int64_t startTime = GetCycles();
 #endif
@@ -2051,6 +2094,366 @@ MechWarrior::runBrain(void)
 
 //---------------------------------------------------------------------------
 
+int32_t
+MechWarrior::runBrain(void)
+{
+	//	if (teamId  > -1)
+	//		if (teamId != Team::home->getId())
+	//		return(0);
+	if (!brain)
+		return (0);
+	thinkBrain();
+	return (applyBrain(nullptr));
+}
+
+//---------------------------------------------------------------------------
+// Runs a batch of brains at once. Each worker thread has one ABL exec
+// context it keeps, and takes the next warrior off the list; the brains
+// only read the world while they think (side-effecting natives are queued,
+// see initABL). Every place in the batch has a command buffer of its own,
+// so once every brain has finished, the queued calls and goal planning are
+// applied here, in list order, and the results don't depend on which
+// worker ran which brain. Brains that need the main thread (see
+// ABLModule::isMainThreadOnly) think and apply in their turn, in the same
+// pass.
+//
+// The workers are started by the first batch and wait between batches
+// until shutdownBrainWorkers. The main thread is worker 0.
+
+#define MAX_BRAIN_WORKERS 8
+#define BRAIN_COMMAND_BUFFER_SIZE 4096
+
+std::thread BrainWorkers[MAX_BRAIN_WORKERS];
+ABLExecContext* BrainContexts[MAX_BRAIN_WORKERS];
+int32_t NumBrainWorkers = 0; // 0 until the first batch starts them
+std::vector<ABLCommandBuffer*> BrainCommandBuffers; // one per place in a batch
+std::mutex BrainLock;
+std::condition_variable BrainWake; // a batch is ready, or time to quit
+std::condition_variable BrainDone; // a worker finished its share
+int32_t BrainBatchNumber = 0;
+int32_t BrainWorkersBusy = 0;
+bool BrainWorkersQuit = false;
+MechWarrior** BrainBatch = nullptr;
+uint32_t* BrainSeeds = nullptr; // 0 for a brain that needs the main thread
+int32_t BrainBatchSize = 0;
+std::atomic<int32_t> NextBrain(0);
+
+//---------------------------------------------------------------------------
+
+static void
+thinkBrainBatch(int32_t worker)
+{
+	ABLExecContext* context = BrainContexts[worker];
+	ABLi_setExecContext(context);
+	int32_t curWarrior;
+	while ((curWarrior = NextBrain++) < BrainBatchSize)
+		if (BrainSeeds[curWarrior])
+		{
+			ABLi_resetExecContext(context, BrainCommandBuffers[curWarrior], BrainSeeds[curWarrior]);
+			BrainBatch[curWarrior]->thinkBrain();
+		}
+	ABLi_setExecContext(nullptr);
+}
+
+//---------------------------------------------------------------------------
+
+static void
+brainWorkerThread(int32_t worker)
+{
+	int32_t lastBatch = 0;
+	std::unique_lock<std::mutex> lock(BrainLock);
+	while (true)
+	{
+		while (!BrainWorkersQuit && (BrainBatchNumber == lastBatch))
+			BrainWake.wait(lock);
+		if (BrainWorkersQuit)
+			return;
+		lastBatch = BrainBatchNumber;
+		lock.unlock();
+		thinkBrainBatch(worker);
+		lock.lock();
+		if (--BrainWorkersBusy == 0)
+			BrainDone.notify_one();
+	}
+}
+
+//---------------------------------------------------------------------------
+
+void
+MechWarrior::runBrains(MechWarrior** warriors, int32_t numWarriors)
+{
+	if (!NumBrainWorkers)
+	{
+		NumBrainWorkers = (int32_t)std::thread::hardware_concurrency();
+		if (NumBrainWorkers > MAX_BRAIN_WORKERS)
+			NumBrainWorkers = MAX_BRAIN_WORKERS;
+		if (NumBrainWorkers < 1)
+			NumBrainWorkers = 1;
+		for (size_t i = 0; i < NumBrainWorkers; i++)
+			BrainContexts[i] = ABLi_createExecContext(0);
+		BrainWorkersQuit = false;
+		for (size_t i = 1; i < NumBrainWorkers; i++)
+			BrainWorkers[i] = std::thread(brainWorkerThread, (int32_t)i);
+	}
+	//------------------------------------------------------------
+	// The debugger steps through one module at a time, so it gets
+	// the old serial path...
+	if ((NumBrainWorkers < 2) || (numWarriors < 2) || debugger)
+	{
+		for (size_t i = 0; i < numWarriors; i++)
+			if (warriors[i]->brain)
+				warriors[i]->runBrain();
+		return;
+	}
+	//-------------------------------------------------------------
+	// Seeds are drawn here, in list order, so each brain's random
+	// numbers don't depend on the worker that runs it...
+	uint32_t* seeds = (uint32_t*)frameArena->Malloc(sizeof(uint32_t) * numWarriors);
+	gosASSERT(seeds != nullptr);
+	while (BrainCommandBuffers.size() < numWarriors)
+		BrainCommandBuffers.push_back(ABLi_createCommandBuffer(BRAIN_COMMAND_BUFFER_SIZE));
+	for (size_t i = 0; i < numWarriors; i++)
+	{
+		seeds[i] = 0;
+		if (warriors[i]->brain && !warriors[i]->brain->isMainThreadOnly())
+			seeds[i] = RandomNumber(0x7fff) + 1;
+	}
+	{
+		std::lock_guard<std::mutex> lock(BrainLock);
+		BrainBatch = warriors;
+		BrainSeeds = seeds;
+		BrainBatchSize = numWarriors;
+		NextBrain = 0;
+		BrainWorkersBusy = NumBrainWorkers - 1;
+		BrainBatchNumber++;
+	}
+	BrainWake.notify_all();
+	thinkBrainBatch(0);
+	{
+		std::unique_lock<std::mutex> lock(BrainLock);
+		while (BrainWorkersBusy > 0)
+			BrainDone.wait(lock);
+	}
+	for (size_t i = 0; i < numWarriors; i++)
+		if (seeds[i])
+			warriors[i]->applyBrain(BrainCommandBuffers[i]);
+		else if (warriors[i]->brain)
+			warriors[i]->runBrain();
+}
+
+//---------------------------------------------------------------------------
+
+void
+MechWarrior::shutdownBrainWorkers(void)
+{
+	if (!NumBrainWorkers)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(BrainLock);
+		BrainWorkersQuit = true;
+	}
+	BrainWake.notify_all();
+	for (size_t i = 1; i < NumBrainWorkers; i++)
+		BrainWorkers[i].join();
+	for (size_t i = 0; i < NumBrainWorkers; i++)
+	{
+		ABLi_destroyExecContext(BrainContexts[i]);
+		BrainContexts[i] = nullptr;
+	}
+	for (size_t i = 0; i < BrainCommandBuffers.size(); i++)
+		ABLi_destroyCommandBuffer(BrainCommandBuffers[i]);
+	BrainCommandBuffers.clear();
+	NumBrainWorkers = 0;
+}
+
+//---------------------------------------------------------------------------
+// Called from the mover update, before any mover moves. Gathers every AI
+// pilot whose brain is due this frame and runs them all through runBrains,
+// so mainDecisionTree finds its brain already run.
+
+void
+MechWarrior::updateBrains(void)
+{
+	int32_t numMovers = ObjectManager->getNumMovers();
+	if (numMovers == 0)
+		return;
+	MechWarrior** warriors = (MechWarrior**)frameArena->Malloc(sizeof(MechWarrior*) * numMovers);
+	gosASSERT(warriors != nullptr);
+	int32_t numWarriors = 0;
+	for (size_t i = 0; i < numMovers; i++)
+	{
+		//------------------------------------------------------------
+		// Same test the movers' updateAIControl makes before calling
+		// mainDecisionTree...
+		std::unique_ptr<Mover> mover = ObjectManager->getMover(i);
+		if (!mover || !mover->getExists() || (mover->control.type != CONTROL_AI) || !mover->getAwake() ||
+			mover->isDisabled() || (mover->getTeamId() < 0))
+			continue;
+		MechWarrior* pilot = mover->getPilot();
+		if (!pilot || !pilot->alive() || pilot->hasEjected() || !pilot->brain)
+			continue;
+		if ((pilot->teamId == -1) || !brainsEnabled[pilot->teamId])
+			continue;
+		if (!pilot->brainDue())
+			continue;
+		pilot->prepareBrain();
+		warriors[numWarriors++] = pilot;
+	}
+	BrainPassTurn = turn;
+	runBrains(warriors, numWarriors);
+	for (size_t i = 0; i < numWarriors; i++)
+		warriors[i]->finishBrain();
+}
+
+//---------------------------------------------------------------------------
+// Where a team's enemies are this frame, for calcBrainTier. Gathered the
+// first time a pilot on the team asks, so every pilot after that only
+// measures distances. The last list is for pilots with no team, to whom
+// everyone is an enemy.
+
+std::vector<Stuff::Vector3D> BrainEnemies[MAX_TEAMS + 1];
+int32_t BrainEnemiesTurn[MAX_TEAMS + 1] = {0}; // turn + 1 they were gathered
+
+std::vector<Stuff::Vector3D>&
+MechWarrior::getBrainEnemies(TeamPtr team)
+{
+	int32_t list = team ? team->getId() : MAX_TEAMS;
+	if (BrainEnemiesTurn[list] == (turn + 1))
+		return (BrainEnemies[list]);
+	BrainEnemiesTurn[list] = turn + 1;
+	BrainEnemies[list].clear();
+	for (size_t i = 0; i < ObjectManager->getNumMovers(); i++)
+	{
+		std::unique_ptr<Mover> mover = ObjectManager->getMover(i);
+		if (!mover || mover->isDestroyed() || mover->isDisabled() || !mover->getTeam())
+			continue;
+		if (team && !team->isEnemy(mover->getTeam()))
+			continue;
+		BrainEnemies[list].push_back(mover->getPosition());
+	}
+	return (BrainEnemies[list]);
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+MechWarrior::calcBrainTier(void)
+{
+	std::unique_ptr<Mover> myVehicle = getVehicle();
+	if (!myVehicle)
+		return (BRAIN_TIER_COMBAT);
+	//-------------------------------------------------------------
+	// Anyone fighting, seeing the enemy, or hit lately gets the full
+	// rate...
+	uint32_t attackerList[MAX_ATTACKERS];
+	if (getLastTarget() || (curTacOrder.code == TACTICAL_ORDER_ATTACK_OBJECT) || (curTacOrder.code == TACTICAL_ORDER_ATTACK_POINT))
+		return (BRAIN_TIER_COMBAT);
+	if (getAttackers(attackerList, BrainRecentDamageTime) > 0)
+		return (BRAIN_TIER_COMBAT);
+	int32_t contactList[MAX_MOVERS];
+	if (myVehicle->getContacts(contactList, CONTACT_CRITERIA_ENEMY, CONTACT_SORT_NONE) > 0)
+		return (BRAIN_TIER_COMBAT);
+	//--------------------------------------------------
+	// Otherwise, it's how close the nearest enemy is...
+	std::vector<Stuff::Vector3D>& enemies = getBrainEnemies(getTeam());
+	float nearestEnemy = 999999.0;
+	for (size_t i = 0; (i < enemies.size()) && (nearestEnemy >= BrainAlertRange); i++)
+	{
+		float distance = myVehicle->distanceFrom(enemies[i]);
+		if (distance < nearestEnemy)
+			nearestEnemy = distance;
+	}
+	bool hasOrders = (curTacOrder.code != TACTICAL_ORDER_NONE) || (numTacOrdersQueued > 0);
+	for (size_t i = 0; i < NUM_ORDERSTATES; i++)
+		hasOrders = hasOrders || newTacOrderReceived[i];
+	if (hasOrders || (nearestEnemy < BrainAlertRange))
+		return (BRAIN_TIER_ALERT);
+	if (nearestEnemy < BrainDormantRange)
+		return (BRAIN_TIER_IDLE);
+	return (BRAIN_TIER_DORMANT);
+}
+
+//---------------------------------------------------------------------------
+
+void
+MechWarrior::wakeBrain(void)
+{
+	//------------------------------------------------------------
+	// Only a brain ticking slower than normal needs waking. One in
+	// combat already runs at the old rate...
+	if (brainTier == BRAIN_TIER_COMBAT)
+		return;
+	brainTier = BRAIN_TIER_COMBAT;
+	brainWake = true;
+	if (brainUpdate > scenarioTime)
+		brainUpdate = scenarioTime;
+	BrainWakeups++;
+}
+
+//---------------------------------------------------------------------------
+
+bool
+MechWarrior::brainDue(void)
+{
+	if (BrainFrame != turn)
+	{
+		BrainFrame = turn;
+		BrainsRunThisFrame = 0;
+	}
+	BrainTierCount[brainTier]++;
+	if (brainUpdate > scenarioTime)
+		return (false);
+	brainWake = false;
+	//-----------------------------------------------------------
+	// Brains in combat, woken ones included, always run on time,
+	// and don't count against the budget...
+	if (brainTier == BRAIN_TIER_COMBAT)
+		return (true);
+	//----------------------------------------------------------------
+	// Over this frame's budget, so wait a frame. Brains put off stay
+	// due, and most of the ones that ran this frame won't be, so the
+	// backlog drains over the next few frames...
+	if ((BrainsPerFrame > 0) && (BrainsRunThisFrame >= BrainsPerFrame))
+	{
+		BrainBudgetOverruns++;
+		return (false);
+	}
+	BrainsRunThisFrame++;
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+
+void
+MechWarrior::updateBrain(void)
+{
+	//-----------------------------------------------------------
+	// If updateBrains already ran this frame's brains, we're done
+	// (a pilot it skipped wasn't due)...
+	if (BrainPassTurn == turn)
+		return;
+	if (!brainDue())
+		return;
+	runBrain();
+	finishBrain();
+}
+
+//---------------------------------------------------------------------------
+
+void
+MechWarrior::finishBrain(void)
+{
+	brainTier = calcBrainTier();
+	//--------------------------------------------------------------
+	// Keep the phase we were staggered with, unless we fell behind...
+	float brainFrequency = BrainUpdateFrequency * BrainTierScale[brainTier];
+	brainUpdate += brainFrequency;
+	if (brainUpdate <= scenarioTime)
+		brainUpdate = scenarioTime + brainFrequency;
+}
+
+//---------------------------------------------------------------------------
+
 int32_t
 MechWarrior::getVehicleStatus(void)
 {
@@ -2181,6 +2584,7 @@ MechWarrior::getLastTarget(void)
 		if (clearTarget)
 		{
 			setLastTarget(nullptr);
+			wakeBrain();
 			lastTargetTime = -1.0;
 			lastTargetObliterate = false;
 			lastTargetFriendly = false;
@@ -4547,6 +4951,7 @@ MechWarrior::setGeneralTacOrder(TacticalOrder newTacOrder)
 {
 	tacOrder[ORDERSTATE_GENERAL] = newTacOrder;
 	newTacOrderReceived[ORDERSTATE_GENERAL] = true;
+	wakeBrain();
 }
 
 //---------------------------------------------------------------------------
@@ -4559,6 +4964,7 @@ MechWarrior::setPlayerTacOrder(TacticalOrder newTacOrder, bool fromQueue)
 	curPlayerOrderFromQueue = fromQueue;
 	if (!fromQueue)
 		clearTacOrderQueue();
+	wakeBrain();
 }
 
 //---------------------------------------------------------------------------
@@ -4585,6 +4991,25 @@ MechWarrior::triggerAlarm(int32_t alarmCode, uint32_t triggerId)
 		return (-1);
 	alarm[alarmCode].trigger[alarm[alarmCode].numTriggers++] = triggerId;
 	alarmHistory[alarmCode].trigger[alarmHistory[alarmCode].numTriggers++] = triggerId;
+	//--------------------------------------------------------------
+	// Getting shot at, or told what to do, shouldn't wait on a brain
+	// that's ticking slowly...
+	switch (alarmCode)
+	{
+	case PILOT_ALARM_HIT_BY_WEAPONFIRE:
+	case PILOT_ALARM_DAMAGE_TAKEN_RATE:
+		//--------------------------------------------------
+		// Damage changes everyone's odds for and against us...
+		if (getVehicle())
+			Team::invalidateTacticalEvals(getVehicle()->getWatchID());
+	case PILOT_ALARM_TARGET_OF_WEAPONFIRE:
+	case PILOT_ALARM_ATTACK_ORDER:
+	case PILOT_ALARM_PLAYER_ORDER:
+	case PILOT_ALARM_KILLED_TARGET:
+	case PILOT_ALARM_GUARD_RADIUS_BREACH:
+		wakeBrain();
+		break;
+	}
 	return (NO_ERROR);
 }
 
@@ -4930,19 +5355,14 @@ MechWarrior::updateActions(void)
 // extern L_INTEGER endCk;
 // extern int32_t		 srWAblUpd;
 //---------------------------------------------------------------------------
+// Everything the brain expects to be current when it runs: the tac order
+// queue, the weapons status and a legit target. updateBrains calls this for
+// the brains it batches, and mainDecisionTree calls it again later in the
+// frame, which is harmless since nothing here changes the second time.
 
-int32_t
-MechWarrior::mainDecisionTree(void)
+void
+MechWarrior::prepareBrain(void)
 {
-	Assert(moveOrders.path != nullptr, 0, " bad warrior path ");
-	if ((teamId == -1) || !brainsEnabled[teamId])
-	{
-		clearCurTacOrder(false);
-		tacOrder[ORDERSTATE_GENERAL].init();
-		tacOrder[ORDERSTATE_PLAYER].init();
-		tacOrder[ORDERSTATE_ALARM].init();
-		setMainGoal(GOAL_ACTION_NONE, nullptr, nullptr, -1.0);
-	}
 	//---------------------------------------------------------------------------
 	// If we currently have no order, check if we have any player orders
 	// queued...
@@ -5017,16 +5437,30 @@ MechWarrior::mainDecisionTree(void)
 	}
 	if ((curTacOrder.code == TACTICAL_ORDER_ATTACK_OBJECT) && (target != tacOrderTarget))
 		setLastTarget(tacOrderTarget);
-	//----------------------
-	// Update pilot brain...
-	if ((brainUpdate <= scenarioTime) && ((teamId == -1) || brainsEnabled[teamId]))
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+MechWarrior::mainDecisionTree(void)
+{
+	Assert(moveOrders.path != nullptr, 0, " bad warrior path ");
+	if ((teamId == -1) || !brainsEnabled[teamId])
 	{
-		runBrain();
-		brainUpdate += BrainUpdateFrequency;
+		clearCurTacOrder(false);
+		tacOrder[ORDERSTATE_GENERAL].init();
+		tacOrder[ORDERSTATE_PLAYER].init();
+		tacOrder[ORDERSTATE_ALARM].init();
+		setMainGoal(GOAL_ACTION_NONE, nullptr, nullptr, -1.0);
 	}
+	prepareBrain();
+	//----------------------
+	// Update pilot brain...
+	if ((teamId == -1) || brainsEnabled[teamId])
+		updateBrain();
 	//------------------------------------------------------------------
 	// In case the brain set a new target, let's recalc weaponsStatus...
-	target = getLastTarget(); // getAttackTarget(OrderType::current);
+	GameObjectPtr target = getLastTarget(); // getAttackTarget(OrderType::current);
 	if (target && (lastTargetTime /*getLastTargetTime()*/ == scenarioTime))
 		weaponsStatusResult = calcWeaponsStatus(target, weaponsStatus, nullptr);
 	//------------
@@ -7492,6 +7926,7 @@ MechWarrior::changeAttackRange(int32_t newRange)
 void
 MechWarrior::shutdown(void)
 {
+	shutdownBrainWorkers();
 	for (size_t i = 0; i < MAX_WARRIORS; i++)
 	{
 		if (warriorList[i])
@@ -8292,6 +8727,8 @@ MechWarrior::copyFromData(MechWarriorData& data)
 	memcpy(debugStrings, data.debugStrings,
 		sizeof(wchar_t) * NUM_PILOT_DEBUG_STRINGS * MAXLEN_PILOT_DEBUG_STRING);
 	brainUpdate = data.brainUpdate;
+	brainTier = BRAIN_TIER_COMBAT;
+	brainWake = false;
 	combatUpdate = data.combatUpdate;
 	movementUpdate = data.movementUpdate;
 	memcpy(weaponsStatus, data.weaponsStatus, sizeof(int32_t) * MAX_WEAPONS_PER_MOVER);
@@ -243,6 +243,18 @@ enum class MoveStateType
 	NUM_MOVESTATES
 } MoveStateType;
 
+//------------------------------------------------------------------
+// How often a pilot's brain runs, fastest first. The combat tier is
+// the old fixed BrainUpdateFrequency; the others stretch it...
+enum class BrainTierType
+{
+	BRAIN_TIER_COMBAT, // has a target, contacts, or was just hit
+	BRAIN_TIER_ALERT, // has orders, or enemies within alert range
+	BRAIN_TIER_IDLE, // enemies somewhere within dormant range
+	BRAIN_TIER_DORMANT, // nothing anywhere near
+	NUM_BRAIN_TIERS
+} BrainTierType;
+
 //---------------------------------------------------------------------------
 
 #define MAX_ALARM_TRIGGERS 15
@@ -835,6 +847,8 @@ protected:
 
 	// Orders
 	float brainUpdate;
+	int32_t brainTier;
+	bool brainWake; // woken early, so skips the brain budget
 	float combatUpdate;
 	float movementUpdate;
 	int32_t weaponsStatus[MAX_WEAPONS_PER_MOVER];
@@ -904,8 +918,8 @@ public:
 	static float maxSkill;
 	static int32_t increaseCap;
 	static float maxVisualRadius;
-	static int32_t curEventID;
-	static int32_t curEventTrigger;
+	static thread_local int32_t curEventID;
+	static thread_local int32_t curEventTrigger;
 
 	static MechWarrior* warriorList[MAX_WARRIORS];
 	static GoalManager* goalManager;
@@ -1258,6 +1272,32 @@ public:
 
 	int32_t runBrain(void);
 
+	void thinkBrain(void);
+
+	int32_t applyBrain(ABLCommandBuffer* deferredCalls);
+
+	static void runBrains(MechWarrior** warriors, int32_t numWarriors);
+
+	static void shutdownBrainWorkers(void);
+
+	static void updateBrains(void);
+
+	void prepareBrain(void);
+
+	bool brainDue(void);
+
+	void updateBrain(void);
+
+	void finishBrain(void);
+
+	int32_t calcBrainTier(void);
+
+	static std::vector<Stuff::Vector3D>& getBrainEnemies(TeamPtr team);
+
+	void wakeBrain(void);
+
+	int32_t getBrainTier(void) { return (brainTier); }
+
 	int32_t loadBrainParameters(FitIniFile* brainFile, int32_t warriorId);
 
 	bool injure(float numWounds, bool checkEject = true);
@@ -72,6 +72,24 @@ WeaponBoltType::destroy(void)
 	ObjectType::destroy();
 }
 
+//---------------------------------------------------------------------------
+void
+WeaponBoltType::cook(ObjectTypeRecord& record)
+{
+	ObjectType::cook(record);
+	record.clearPointer(this, &textureName);
+	record.writeBlock(textureName, textureName ? (strlen(textureName) + 1) * sizeof(textureName[0]) : 0);
+}
+
+//---------------------------------------------------------------------------
+bool
+WeaponBoltType::uncook(ObjectTypeRecord& record)
+{
+	if (!ObjectType::uncook(record))
+		return (false);
+	return (record.readBlock((PVOID&)textureName, ObjectTypeManager::objectCache));
+}
+
 //---------------------------------------------------------------------------
 uint32_t
 bgrTorgb(uint32_t frontRGB);
@@ -105,6 +105,10 @@ public:
 	virtual int32_t init(std::unique_ptr<File> objFile, uint32_t fileSize);
 	int32_t init(FitIniFilePtr objFile);
 
+	virtual size_t getCookedSize(void) { return (sizeof(WeaponBoltType)); }
+	virtual void cook(ObjectTypeRecord& record);
+	virtual bool uncook(ObjectTypeRecord& record);
+
 	~WeaponBoltType(void) { destroy(void); }
 
 	virtual void destroy(void);
@@ -134,6 +134,7 @@ MSDISABLE_WARNING_PUSH(4061 4191 4365 4668 4820 5039 5045 6011 6387 28204 28251)
 #include <d3d11_1.h>
 
 #include <imagehlp.h>
+#include <psapi.h>
 #include <mmsystem.h>
 #include <d3dtypes.h>
 #include <ddraw.h>
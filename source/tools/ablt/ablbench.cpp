@@ -0,0 +1,610 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+//***************************************************************************
+//
+//								ABLBENCH.CPP
+//
+//***************************************************************************
+#include "stdinc.h"
+
+//#include "ablgen.h"
+//#include "ablerr.h"
+//#include "ablsymt.h"
+//#include "ablexec.h"
+//#include "ablenv.h"
+
+//-------------------------------------------------------
+// Counted by ablt's malloc callbacks (see ablmc2.cpp)...
+extern int32_t BenchNumAllocations;
+extern int32_t BenchAllocatedBytes;
+
+namespace mclib::abl {
+
+//***************************************************************************
+
+//---------------------------------------------------------------------------
+// Headless brain benchmark (ablt -bench). The game natives registered by
+// ablmc2.cpp have no code in ablt, so here they get stubs against a small
+// scripted world: two teams of movers circling their own rally points,
+// which close on each other as the ticks go by, so brains see no contacts,
+// then a few, then a brawl. Everything is driven off the tick count, so two
+// runs of the same brains do exactly the same work. Natives the world
+// doesn't model just eat their params and hand back zero.
+
+#define BENCH_NUM_MOVERS 16
+#define BENCH_FIRST_MOVER_ID 1000
+#define BENCH_WARRIORS_PER_MODULE 4
+#define BENCH_TICK_TIME 0.5
+#define BENCH_SENSOR_RANGE 1200.0
+#define BENCH_ATTACK_RANGE 600.0
+#define BENCH_NUM_MEMORY_CELLS 60
+#define BENCH_MAX_BRAINS 256
+
+typedef struct _BenchMover
+{
+	int32_t id;
+	int32_t team;
+	float position[3];
+	float phase;
+	int32_t status;
+	int32_t targetId;
+	int32_t lastAttackerId;
+	float lastAttackTime;
+	int32_t integerMemory[BENCH_NUM_MEMORY_CELLS];
+	float realMemory[BENCH_NUM_MEMORY_CELLS];
+} BenchMover;
+
+//--------
+// GLOBALS
+BenchMover BenchMovers[BENCH_NUM_MOVERS];
+BenchMover* BenchCurObject = nullptr;
+BenchMover* BenchCurWarrior = nullptr;
+BenchMover* BenchCurContact = nullptr;
+float BenchTime = 0.0;
+int64_t BenchNumNativeCalls = 0;
+
+//***************************************************************************
+// WORLD routines
+//***************************************************************************
+
+BenchMover*
+benchGetMover(int32_t id)
+{
+	int32_t index = id - BENCH_FIRST_MOVER_ID;
+	if ((index < 0) || (index >= BENCH_NUM_MOVERS))
+		return (nullptr);
+	return (&BenchMovers[index]);
+}
+
+//---------------------------------------------------------------------------
+
+float
+benchDistance(BenchMover* mover1, BenchMover* mover2)
+{
+	float dx = mover1->position[0] - mover2->position[0];
+	float dy = mover1->position[1] - mover2->position[1];
+	return ((float)sqrt(dx * dx + dy * dy));
+}
+
+//---------------------------------------------------------------------------
+
+bool
+benchIsContact(BenchMover* mover, BenchMover* other)
+{
+	return ((other->team != mover->team) && (other->status == 0) && (benchDistance(mover, other) < BENCH_SENSOR_RANGE));
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchInitWorld(void)
+{
+	memset(BenchMovers, 0, sizeof(BenchMovers));
+	for (size_t i = 0; i < BENCH_NUM_MOVERS; i++)
+	{
+		BenchMovers[i].id = BENCH_FIRST_MOVER_ID + i;
+		BenchMovers[i].team = i & 1;
+		BenchMovers[i].phase = (float)i * 0.7f;
+		BenchMovers[i].lastAttackTime = -1000.0;
+	}
+	BenchTime = 0.0;
+	BenchNumNativeCalls = 0;
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchUpdateWorld(int32_t tick)
+{
+	//------------------------------------------------------------
+	// The rally points start 6000 apart and close to 600 apart by
+	// tick 216, then hold...
+	BenchTime = tick * BENCH_TICK_TIME;
+	float rallyX = 3000.0f - (tick * 12.5f);
+	if (rallyX < 300.0f)
+		rallyX = 300.0f;
+	for (size_t i = 0; i < BENCH_NUM_MOVERS; i++)
+	{
+		BenchMover* mover = &BenchMovers[i];
+		float angle = mover->phase + (BenchTime * 0.1f);
+		float radius = 150.0f + (i * 20.0f);
+		mover->position[0] = (mover->team ? rallyX : -rallyX) + (radius * (float)cos(angle));
+		mover->position[1] = radius * (float)sin(angle);
+		mover->position[2] = 0.0;
+	}
+	//-----------------------------------------------------------
+	// Anyone with an enemy in range gets shot at now and then...
+	for (size_t i = 0; i < BENCH_NUM_MOVERS; i++)
+		if (((tick + i) % 5) == 0)
+			for (size_t j = 0; j < BENCH_NUM_MOVERS; j++)
+				if ((BenchMovers[j].team != BenchMovers[i].team) && (benchDistance(&BenchMovers[i], &BenchMovers[j]) < BENCH_ATTACK_RANGE))
+				{
+					BenchMovers[i].lastAttackerId = BenchMovers[j].id;
+					BenchMovers[i].lastAttackTime = BenchTime;
+					break;
+				}
+}
+
+//***************************************************************************
+// NATIVE stubs
+//***************************************************************************
+
+void
+benchPopParams(void)
+{
+	//-------------------------------------------------------------
+	// The interpreter has read the '(' if there are any params, and
+	// each pop leaves us on the ',' or ')' after it...
+	if (CurContext->codeToken != TKN_LPAREN)
+		return;
+	ABLStackItem value;
+	do
+		ABLi_popAnything(&value);
+	while (CurContext->codeToken == TKN_COMMA);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchReturnNone(void)
+{
+	BenchNumNativeCalls++;
+	benchPopParams();
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchReturnInteger(void)
+{
+	BenchNumNativeCalls++;
+	benchPopParams();
+	ABLi_pushInteger(0);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchReturnReal(void)
+{
+	BenchNumNativeCalls++;
+	benchPopParams();
+	ABLi_pushReal(0.0);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchReturnBoolean(void)
+{
+	BenchNumNativeCalls++;
+	benchPopParams();
+	ABLi_pushBoolean(false);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetId(void)
+{
+	BenchNumNativeCalls++;
+	ABLi_pushInteger(BenchCurObject ? BenchCurObject->id : 0);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetTime(void)
+{
+	BenchNumNativeCalls++;
+	ABLi_pushReal(BenchTime);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetTimeLeft(void)
+{
+	BenchNumNativeCalls++;
+	ABLi_pushReal(3600.0f - BenchTime);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchSelectObject(void)
+{
+	BenchNumNativeCalls++;
+	int32_t objectId = ABLi_peekInteger();
+	int32_t curObjectId = BenchCurObject ? BenchCurObject->id : 0;
+	BenchMover* newObject = benchGetMover(objectId);
+	if (newObject)
+	{
+		BenchCurObject = newObject;
+		ABLi_pokeInteger(curObjectId);
+	}
+	else
+		ABLi_pokeInteger(-1);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetContacts(void)
+{
+	BenchNumNativeCalls++;
+	int32_t* contactList = ABLi_popIntegerPtr();
+	ABLi_popInteger();
+	ABLi_popInteger();
+	//------------------------------------------
+	// Always sorted by distance, nearest first...
+	int32_t numContacts = 0;
+	if (BenchCurObject)
+		for (size_t i = 0; i < BENCH_NUM_MOVERS; i++)
+			if (benchIsContact(BenchCurObject, &BenchMovers[i]))
+			{
+				float distance = benchDistance(BenchCurObject, &BenchMovers[i]);
+				int32_t slot = numContacts++;
+				while ((slot > 0) && (benchDistance(BenchCurObject, benchGetMover(contactList[slot - 1])) > distance))
+				{
+					contactList[slot] = contactList[slot - 1];
+					slot--;
+				}
+				contactList[slot] = BenchMovers[i].id;
+			}
+	ABLi_pushInteger(numContacts);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetEnemyCount(void)
+{
+	BenchNumNativeCalls++;
+	BenchMover* object = benchGetMover(ABLi_popInteger());
+	int32_t result = -1;
+	if (object)
+	{
+		result = 0;
+		for (size_t i = 0; i < BENCH_NUM_MOVERS; i++)
+			if (benchIsContact(object, &BenchMovers[i]))
+				result++;
+	}
+	ABLi_pushInteger(result);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchSelectContact(void)
+{
+	BenchNumNativeCalls++;
+	ABLi_popInteger();
+	BenchMover* object = benchGetMover(ABLi_popInteger());
+	int32_t code = 1;
+	if (BenchCurObject && object && benchIsContact(BenchCurObject, object))
+	{
+		BenchCurContact = object;
+		code = 0;
+	}
+	ABLi_pushInteger(code);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetContactId(void)
+{
+	BenchNumNativeCalls++;
+	ABLi_pushInteger(BenchCurContact ? BenchCurContact->id : 0);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchSetTarget(void)
+{
+	BenchNumNativeCalls++;
+	BenchMover* attacker = benchGetMover(ABLi_popInteger());
+	int32_t targetId = ABLi_popInteger();
+	if (attacker)
+		attacker->targetId = benchGetMover(targetId) ? targetId : 0;
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetTarget(void)
+{
+	BenchNumNativeCalls++;
+	BenchMover* object = benchGetMover(ABLi_popInteger());
+	ABLi_pushInteger(object ? object->targetId : 0);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetObjectPosition(void)
+{
+	BenchNumNativeCalls++;
+	BenchMover* object = benchGetMover(ABLi_popInteger());
+	float* coordList = ABLi_popRealPtr();
+	coordList[0] = object ? object->position[0] : 0.0f;
+	coordList[1] = object ? object->position[1] : 0.0f;
+	coordList[2] = object ? object->position[2] : 0.0f;
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchDistanceToObject(void)
+{
+	BenchNumNativeCalls++;
+	BenchMover* object1 = benchGetMover(ABLi_popInteger());
+	BenchMover* object2 = benchGetMover(ABLi_popInteger());
+	ABLi_pushReal((object1 && object2) ? benchDistance(object1, object2) : -1.0f);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchDistanceToPosition(void)
+{
+	BenchNumNativeCalls++;
+	BenchMover* object = benchGetMover(ABLi_popInteger());
+	float* coordList = ABLi_popRealPtr();
+	float distance = -1.0;
+	if (object)
+	{
+		float dx = object->position[0] - coordList[0];
+		float dy = object->position[1] - coordList[1];
+		distance = (float)sqrt(dx * dx + dy * dy);
+	}
+	ABLi_pushReal(distance);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchObjectStatus(void)
+{
+	BenchNumNativeCalls++;
+	BenchMover* object = benchGetMover(ABLi_popInteger());
+	ABLi_pushInteger(object ? object->status : -1);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchObjectExists(void)
+{
+	BenchNumNativeCalls++;
+	ABLi_pushInteger(benchGetMover(ABLi_popInteger()) ? 1 : 0);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchObjectSide(void)
+{
+	BenchNumNativeCalls++;
+	BenchMover* object = benchGetMover(ABLi_popInteger());
+	ABLi_pushInteger(object ? object->team : -1);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetIntegerMemory(void)
+{
+	BenchNumNativeCalls++;
+	int32_t index = ABLi_popInteger();
+	int32_t value = 0;
+	if (BenchCurWarrior && (index >= 0) && (index < BENCH_NUM_MEMORY_CELLS))
+		value = BenchCurWarrior->integerMemory[index];
+	ABLi_pushInteger(value);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchSetIntegerMemory(void)
+{
+	BenchNumNativeCalls++;
+	int32_t index = ABLi_popInteger();
+	int32_t value = ABLi_popInteger();
+	if (BenchCurWarrior && (index >= 0) && (index < BENCH_NUM_MEMORY_CELLS))
+		BenchCurWarrior->integerMemory[index] = value;
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetRealMemory(void)
+{
+	BenchNumNativeCalls++;
+	int32_t index = ABLi_popInteger();
+	float value = 0.0;
+	if (BenchCurWarrior && (index >= 0) && (index < BENCH_NUM_MEMORY_CELLS))
+		value = BenchCurWarrior->realMemory[index];
+	ABLi_pushReal(value);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchSetRealMemory(void)
+{
+	BenchNumNativeCalls++;
+	int32_t index = ABLi_popInteger();
+	float value = ABLi_popReal();
+	if (BenchCurWarrior && (index >= 0) && (index < BENCH_NUM_MEMORY_CELLS))
+		BenchCurWarrior->realMemory[index] = value;
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetAttackers(void)
+{
+	BenchNumNativeCalls++;
+	int32_t* attackerList = ABLi_popIntegerPtr();
+	float seconds = ABLi_popReal();
+	int32_t count = 0;
+	if (BenchCurWarrior && BenchCurWarrior->lastAttackerId && (BenchCurWarrior->lastAttackTime >= (BenchTime - seconds)))
+		attackerList[count++] = BenchCurWarrior->lastAttackerId;
+	ABLi_pushInteger(count);
+}
+
+//---------------------------------------------------------------------------
+
+void
+benchGetVisualRange(void)
+{
+	BenchNumNativeCalls++;
+	ABLi_popInteger();
+	ABLi_pushReal(BENCH_SENSOR_RANGE);
+}
+
+//***************************************************************************
+
+void
+setBenchNative(const std::wstring_view& name, void (*callback)(void))
+{
+	const std::unique_ptr<SymTableNode>& routineIdPtr = searchSymTableForFunction(name, SymTableDisplay[0]);
+	if (routineIdPtr && (routineIdPtr->defn.info.routine.key < NumStandardFunctions))
+		FunctionCallbackTable[routineIdPtr->defn.info.routine.key] = callback;
+}
+
+//---------------------------------------------------------------------------
+
+void
+setBenchNatives(void)
+{
+	setBenchNative("getid", benchGetId);
+	setBenchNative("gettime", benchGetTime);
+	setBenchNative("gettimeleft", benchGetTimeLeft);
+	setBenchNative("selectobject", benchSelectObject);
+	setBenchNative("selectwarrior", benchSelectObject);
+	setBenchNative("getcontacts", benchGetContacts);
+	setBenchNative("getenemycount", benchGetEnemyCount);
+	setBenchNative("selectcontact", benchSelectContact);
+	setBenchNative("getcontactid", benchGetContactId);
+	setBenchNative("settarget", benchSetTarget);
+	setBenchNative("gettarget", benchGetTarget);
+	setBenchNative("getobjectposition", benchGetObjectPosition);
+	setBenchNative("distancetoobject", benchDistanceToObject);
+	setBenchNative("distancetoposition", benchDistanceToPosition);
+	setBenchNative("objectstatus", benchObjectStatus);
+	setBenchNative("objectexists", benchObjectExists);
+	setBenchNative("objectside", benchObjectSide);
+	setBenchNative("objectteam", benchObjectSide);
+	setBenchNative("getintegermemory", benchGetIntegerMemory);
+	setBenchNative("setintegermemory", benchSetIntegerMemory);
+	setBenchNative("getrealmemory", benchGetRealMemory);
+	setBenchNative("setrealmemory", benchSetRealMemory);
+	setBenchNative("getattackers", benchGetAttackers);
+	setBenchNative("getvisualrange", benchGetVisualRange);
+	//-------------------------------------------------------------
+	// Everything else registered without code gets a stub that at
+	// least leaves the stack the way the real one would...
+	for (size_t i = 0; i < NumStandardFunctions; i++)
+		if (!FunctionCallbackTable[i])
+			switch (FunctionInfoTable[i].returnType)
+			{
+			case RETURN_TYPE_INTEGER:
+				FunctionCallbackTable[i] = benchReturnInteger;
+				break;
+			case RETURN_TYPE_REAL:
+				FunctionCallbackTable[i] = benchReturnReal;
+				break;
+			case RETURN_TYPE_BOOLEAN:
+				FunctionCallbackTable[i] = benchReturnBoolean;
+				break;
+			default:
+				FunctionCallbackTable[i] = benchReturnNone;
+				break;
+			}
+}
+
+//***************************************************************************
+
+int32_t
+runABLBenchmark(int32_t numTicks, int32_t* moduleHandles, int32_t numModules)
+{
+	setBenchNatives();
+	benchInitWorld();
+	//-------------------------------------------------------------
+	// A few warriors per brain, each driving its own mover, so the
+	// brains don't all see the same world...
+	ABLModule* brains[BENCH_MAX_BRAINS];
+	BenchMover* brainMovers[BENCH_MAX_BRAINS];
+	int32_t numBrains = 0;
+	for (size_t i = 0; i < numModules; i++)
+		for (size_t j = 0; (j < BENCH_WARRIORS_PER_MODULE) && (numBrains < BENCH_MAX_BRAINS); j++)
+		{
+			ABLModule* brain = new ABLModule;
+			if (brain->init(moduleHandles[i]) != ABL_NO_ERR)
+			{
+				delete brain;
+				break;
+			}
+			brainMovers[numBrains] = &BenchMovers[numBrains % BENCH_NUM_MOVERS];
+			brains[numBrains++] = brain;
+		}
+	if (numBrains == 0)
+		return (-1);
+	int32_t startAllocations = BenchNumAllocations;
+	int32_t startAllocatedBytes = BenchAllocatedBytes;
+	int64_t numStatements = 0;
+	LARGE_INTEGER frequency, startTime, endTime;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&startTime);
+	for (size_t tick = 0; tick < numTicks; tick++)
+	{
+		benchUpdateWorld(tick);
+		for (size_t i = 0; i < numBrains; i++)
+		{
+			BenchCurObject = BenchCurWarrior = brainMovers[i];
+			BenchCurContact = nullptr;
+			numStatements += brains[i]->execute();
+		}
+	}
+	QueryPerformanceCounter(&endTime);
+	double seconds = (double)(endTime.QuadPart - startTime.QuadPart) / (double)frequency.QuadPart;
+	if (seconds <= 0.0)
+		seconds = 1.0e-9;
+	printf("Benchmark: %d brains (%d modules) for %d ticks in %.3f sec\n", numBrains, numModules, numTicks, seconds);
+	printf("     Statements:   %lld (%.0f/sec)\n", numStatements, numStatements / seconds);
+	printf("     Native calls: %lld (%.0f/sec)\n", BenchNumNativeCalls, BenchNumNativeCalls / seconds);
+	printf("     Allocations:  %d (%d bytes)\n", BenchNumAllocations - startAllocations,
+		BenchAllocatedBytes - startAllocatedBytes);
+	for (size_t i = 0; i < numBrains; i++)
+		delete brains[i];
+	return (ABL_NO_ERR);
+}
+
+//***************************************************************************
+
+} // namespace mclib::abl
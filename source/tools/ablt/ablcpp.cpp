@@ -0,0 +1,1249 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+//***************************************************************************
+//
+//								ABLCPP.CPP
+//
+//***************************************************************************
+#include "stdinc.h"
+
+//#include "ablgen.h"
+//#include "ablerr.h"
+//#include "ablsymt.h"
+//#include "ablexec.h"
+//#include "ablenv.h"
+//#include "ablnative.h"
+
+namespace mclib::abl {
+
+//***************************************************************************
+
+//---------------------------------------------------------------------------
+// ABL to C++ translator (ablt -cpp). Each compiled routine's code segment is
+// walked exactly the way the executor walks it, and the same work is written
+// out as C++ against the helpers in ablnative.h. Anything that can't be shown
+// to match the interpreter--chars, strings, registered or foreign library
+// variables, odd type mixes--goes back to the interpreter, one expression or
+// statement at a time. Calls, returns and transitions always do.
+//
+// The game doesn't link any translated brains out of the box. To use them,
+// add the generated file to the mechcmd2 build and define USE_NATIVE_ABL.
+
+#define MAX_CPP_LINE 1024
+#define MAX_CPP_VALUE 64
+#define MAX_CPP_NAME 128
+
+//--------
+// GLOBALS
+wchar_t* CppCode = nullptr;
+size_t CppCodeLength = 0;
+size_t CppCodeMax = 0;
+int32_t CppIndent = 0;
+int32_t CppNumTemps = 0;
+bool CppExprFailed = false; // current expression needs the interpreter
+bool CppRoutineFailed = false; // current routine stays interpreted
+bool CppDelegated = false; // current statement ran something interpreted
+bool CppCalledInterpreter = false; // ...or called into the interpreter at all
+SymTableNode* CppRoutineIdPtr = nullptr;
+Address CppCodeSegment = nullptr;
+Address CppCodeSegmentEnd = nullptr;
+
+//----------
+// EXTERNALS
+
+extern const std::unique_ptr<Type>& IntegerTypePtr;
+extern const std::unique_ptr<Type>& CharTypePtr;
+extern const std::unique_ptr<Type>& RealTypePtr;
+extern const std::unique_ptr<Type>& BooleanTypePtr;
+extern const std::unique_ptr<ModuleEntry>& ModuleRegistry;
+extern int32_t NumModulesRegistered;
+extern bool IncludeDebugInfo;
+
+const std::unique_ptr<Type>&
+cppExpression(wchar_t* value);
+
+//***************************************************************************
+// OUTPUT routines
+//***************************************************************************
+
+void
+cppAppend(const wchar_t* text)
+{
+	size_t length = strlen(text);
+	if ((CppCodeLength + length + 1) > CppCodeMax)
+	{
+		CppCodeMax = (CppCodeLength + length + 1) * 2;
+		CppCode = (wchar_t*)realloc(CppCode, CppCodeMax * sizeof(wchar_t));
+		if (!CppCode)
+			ABL_Fatal(0, " ABL: unable to realloc translator buffer ");
+	}
+	memcpy(&CppCode[CppCodeLength], text, (length + 1) * sizeof(wchar_t));
+	CppCodeLength += length;
+}
+
+//---------------------------------------------------------------------------
+
+void
+cppEmit(const wchar_t* format, ...)
+{
+	wchar_t line[MAX_CPP_LINE];
+	size_t length = 0;
+	for (size_t i = 0; i < CppIndent; i++)
+		line[length++] = '\t';
+	va_list args;
+	va_start(args, format);
+	vsprintf(&line[length], format, args);
+	va_end(args);
+	strcat(line, "\n");
+	cppAppend(line);
+}
+
+//---------------------------------------------------------------------------
+
+void
+cppRollback(size_t mark)
+{
+	CppCodeLength = mark;
+	if (CppCode)
+		CppCode[mark] = nullptr;
+}
+
+//---------------------------------------------------------------------------
+
+int32_t
+cppOffset(Address codePtr)
+{
+	return ((int32_t)(codePtr - CppCodeSegment));
+}
+
+//---------------------------------------------------------------------------
+
+void
+cppIdentifier(const std::wstring_view& name, wchar_t* identifier)
+{
+	size_t length = 0;
+	for (size_t i = 0; name[i] && (length < (MAX_CPP_NAME - 16)); i++)
+		identifier[length++] = isalnum(name[i]) ? name[i] : '_';
+	identifier[length] = nullptr;
+}
+
+//***************************************************************************
+// VALUE routines
+//***************************************************************************
+
+bool
+cppIsInteger(const std::unique_ptr<Type>& ptype)
+{
+	//------------------------------------------------------
+	// Everything the interpreter keeps in StackItem.integer...
+	return (ptype && ((ptype == IntegerTypePtr) || (ptype->form == FRM_ENUM)));
+}
+
+//---------------------------------------------------------------------------
+
+void
+cppNewTemp(wchar_t* value, const wchar_t* cppType, const wchar_t* expression)
+{
+	sprintf(value, "t%d", CppNumTemps++);
+	cppEmit("const %s %s = %s;", cppType, value, expression);
+}
+
+//---------------------------------------------------------------------------
+
+void
+cppIntegerLiteral(int32_t literal, wchar_t* value)
+{
+	if (literal == INT32_MIN)
+		sprintf(value, "(-2147483647 - 1)");
+	else if (literal < 0)
+		sprintf(value, "(%d)", literal);
+	else
+		sprintf(value, "%d", literal);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+cppRealLiteral(float literal, wchar_t* value)
+{
+	if (!isfinite(literal))
+		return (false);
+	wchar_t digits[MAX_CPP_VALUE];
+	sprintf(digits, "%.9g", literal);
+	if (!strchr(digits, '.') && !strchr(digits, 'e'))
+		strcat(digits, ".0");
+	if (literal < 0.0)
+		sprintf(value, "(%sf)", digits);
+	else
+		sprintf(value, "%sf", digits);
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+
+void
+cppStackItemValue(const std::unique_ptr<Type>& ptype, const wchar_t* item, wchar_t* value)
+{
+	//------------------------------------------------------------
+	// How the interpreter would read this type off the stack. An
+	// empty value means it's not something C++ can hold for us...
+	if (cppIsInteger(ptype))
+		sprintf(value, "%s.integer", item);
+	else if (ptype == RealTypePtr)
+		sprintf(value, "%s.real", item);
+	else if (ptype == CharTypePtr)
+		sprintf(value, "%s.byte", item);
+	else
+		value[0] = nullptr;
+}
+
+//---------------------------------------------------------------------------
+
+bool
+cppPromoteToReal(const std::unique_ptr<Type>& ptype, const wchar_t* operand, wchar_t* real)
+{
+	//------------------------------------------------------------
+	// Same as promoteOperandsToReal(). Anything that isn't integer
+	// or real would have its bits reinterpreted, so don't try...
+	if (ptype == IntegerTypePtr)
+		sprintf(real, "(float)%s", operand);
+	else if (ptype == RealTypePtr)
+		strcpy(real, operand);
+	else
+		return (false);
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+
+const std::unique_ptr<Type>&
+cppReturnType(const std::unique_ptr<SymTableNode>& routineIdPtr)
+{
+	if (routineIdPtr->defn.info.routine.key == RTN_DECLARED)
+		return ((const std::unique_ptr<Type>&)(routineIdPtr->ptype));
+	switch (routineIdPtr->defn.info.routine.key)
+	{
+	case RTN_RETURN:
+	case RTN_PRINT:
+		return (nullptr);
+	case RTN_CONCAT:
+		return (IntegerTypePtr);
+	}
+	switch (FunctionInfoTable[routineIdPtr->defn.info.routine.key].returnType)
+	{
+	case RETURN_TYPE_INTEGER:
+		return (IntegerTypePtr);
+	case RETURN_TYPE_REAL:
+		return (RealTypePtr);
+	case RETURN_TYPE_BOOLEAN:
+		return (BooleanTypePtr);
+	}
+	return (nullptr);
+}
+
+//***************************************************************************
+// EXPRESSION routines
+//***************************************************************************
+
+const std::unique_ptr<Type>&
+cppSkipCall(const std::unique_ptr<SymTableNode>& routineIdPtr)
+{
+	//-------------------------------------------------------------
+	// Calls run in the interpreter, so just walk past the actual
+	// params. Standard and declared routines crunch them the same
+	// way: ( expr , expr ... )
+	size_t mark = CppCodeLength;
+	bool wasExprFailed = CppExprFailed;
+	getCodeToken();
+	if (CurContext->codeToken == TKN_LPAREN)
+	{
+		do
+		{
+			wchar_t param[MAX_CPP_VALUE];
+			getCodeToken();
+			cppExpression(param);
+		} while (CurContext->codeToken == TKN_COMMA);
+		getCodeToken();
+	}
+	cppRollback(mark);
+	CppExprFailed = wasExprFailed;
+	return (cppReturnType(routineIdPtr));
+}
+
+//---------------------------------------------------------------------------
+
+const std::unique_ptr<Type>&
+cppSubscripts(const std::unique_ptr<Type>& ptype, wchar_t* address)
+{
+	while (CurContext->codeToken == TKN_LBRACKET)
+	{
+		do
+		{
+			wchar_t index[MAX_CPP_VALUE];
+			wchar_t expression[MAX_CPP_LINE];
+			getCodeToken();
+			const std::unique_ptr<Type>& indexTypePtr = cppExpression(index);
+			if (!cppIsInteger(indexTypePtr) || !index[0])
+				CppExprFailed = true;
+			sprintf(expression, "nativeSubscript(%s, %s, %d, %d)", address, index, ptype->info.array.elementCount,
+				ptype->info.array.elementTypePtr->size);
+			cppNewTemp(address, "Address", expression);
+			if (CurContext->codeToken == TKN_COMMA)
+				ptype = ptype->info.array.elementTypePtr;
+		} while (CurContext->codeToken == TKN_COMMA);
+		getCodeToken();
+		if (CurContext->codeToken == TKN_LBRACKET)
+			ptype = ptype->info.array.elementTypePtr;
+	}
+	return (ptype->info.array.elementTypePtr);
+}
+
+//---------------------------------------------------------------------------
+
+const std::unique_ptr<Type>&
+cppVariable(const std::unique_ptr<SymTableNode>& idPtr, UseType use, wchar_t* value)
+{
+	const std::unique_ptr<Type>& ptype = (const std::unique_ptr<Type>&)(idPtr->ptype);
+	wchar_t address[MAX_CPP_VALUE];
+	wchar_t expression[MAX_CPP_LINE];
+	int32_t offset = idPtr->defn.info.data.offset;
+	switch (idPtr->defn.info.data.varType)
+	{
+	case VAR_TYPE_NORMAL:
+		sprintf(expression, "(Address)nativeVariable(%d, %d)", (int32_t)idPtr->level, offset);
+		break;
+	case VAR_TYPE_ETERNAL:
+		sprintf(expression, "(Address)(stack + %d)", offset);
+		break;
+	case VAR_TYPE_STATIC:
+		//---------------------------------------------------------
+		// Another library's statics mean swapping static data
+		// spaces, which we leave to the interpreter...
+		if (idPtr->library != CppRoutineIdPtr->library)
+			CppExprFailed = true;
+		sprintf(expression, "(Address)(CurContext->staticDataPtr + %d)", offset);
+		break;
+	default:
+		CppExprFailed = true;
+		sprintf(expression, "nullptr");
+		break;
+	}
+	cppNewTemp(address, "Address", expression);
+	//---------------------------------------------------------------
+	// Reference params point to the actual item, and arrays keep a
+	// pointer to their data...
+	if (((idPtr->defn.key == DFN_REFPARAM) && (ptype->form != FRM_ARRAY)) || (ptype->form == FRM_ARRAY))
+	{
+		sprintf(expression, "((StackItem*)%s)->address", address);
+		cppNewTemp(address, "Address", expression);
+	}
+	getCodeToken();
+	while (CurContext->codeToken == TKN_LBRACKET)
+		ptype = cppSubscripts(ptype, address);
+	if ((use != USE_TARGET) && (use != USE_REFPARAM) && (ptype->form != FRM_ARRAY))
+	{
+		if (cppIsInteger(ptype))
+		{
+			sprintf(expression, "*((int32_t*)%s)", address);
+			cppNewTemp(value, "int32_t", expression);
+		}
+		else if (ptype == RealTypePtr)
+		{
+			sprintf(expression, "*((float*)%s)", address);
+			cppNewTemp(value, "float", expression);
+		}
+		else
+		{
+			CppExprFailed = true;
+			value[0] = nullptr;
+		}
+	}
+	else
+		strcpy(value, address);
+	return (ptype);
+}
+
+//---------------------------------------------------------------------------
+
+const std::unique_ptr<Type>&
+cppConstant(const std::unique_ptr<SymTableNode>& idPtr, wchar_t* value)
+{
+	const std::unique_ptr<Type>& ptype = idPtr->ptype;
+	if (cppIsInteger(ptype))
+		cppIntegerLiteral(idPtr->defn.info.constant.value.integer, value);
+	else if (ptype == RealTypePtr)
+	{
+		if (!cppRealLiteral(idPtr->defn.info.constant.value.real, value))
+			CppExprFailed = true;
+	}
+	else
+	{
+		//-------------------------------------------------
+		// Char constants are pushed as integers, but typed
+		// as chars. Strings are addresses...
+		CppExprFailed = true;
+		value[0] = nullptr;
+	}
+	getCodeToken();
+	return (ptype);
+}
+
+//---------------------------------------------------------------------------
+
+const std::unique_ptr<Type>&
+cppFactor(wchar_t* value)
+{
+	const std::unique_ptr<Type>& resultTypePtr = nullptr;
+	int32_t offset = cppOffset(CurContext->codeSegmentPtr - 1);
+	wchar_t expression[MAX_CPP_LINE];
+	value[0] = nullptr;
+	switch (CurContext->codeToken)
+	{
+	case TKN_IDENTIFIER:
+	{
+		const std::unique_ptr<SymTableNode>& idPtr = getCodeSymTableNodePtr();
+		if (idPtr->defn.key == DFN_FUNCTION)
+		{
+			resultTypePtr = cppSkipCall(idPtr);
+			wchar_t item[MAX_CPP_VALUE];
+			sprintf(item, "t%d", CppNumTemps++);
+			cppEmit("const StackItem %s = nativeEvalFactor(%d);", item, offset);
+			cppStackItemValue(resultTypePtr, item, value);
+			CppCalledInterpreter = true;
+			if (!value[0])
+				CppExprFailed = true;
+		}
+		else if (idPtr->defn.key == DFN_CONST)
+			resultTypePtr = cppConstant(idPtr, value);
+		else
+			resultTypePtr = cppVariable(idPtr, USE_EXPR, value);
+	}
+	break;
+	case TKN_NUMBER:
+	{
+		const std::unique_ptr<SymTableNode>& numberPtr = getCodeSymTableNodePtr();
+		if (numberPtr->ptype == IntegerTypePtr)
+		{
+			cppIntegerLiteral(numberPtr->defn.info.constant.value.integer, value);
+			resultTypePtr = IntegerTypePtr;
+		}
+		else
+		{
+			if (!cppRealLiteral(numberPtr->defn.info.constant.value.real, value))
+				CppExprFailed = true;
+			resultTypePtr = RealTypePtr;
+		}
+		getCodeToken();
+	}
+	break;
+	case TKN_STRING:
+	{
+		const std::unique_ptr<SymTableNode>& nodePtr = getCodeSymTableNodePtr();
+		if (strlen(nodePtr->name) > 1)
+			resultTypePtr = nodePtr->ptype;
+		else
+			resultTypePtr = CharTypePtr;
+		CppExprFailed = true;
+		getCodeToken();
+	}
+	break;
+	case TKN_NOT:
+	{
+		wchar_t operand[MAX_CPP_VALUE];
+		getCodeToken();
+		resultTypePtr = cppFactor(operand);
+		//--------------------------------------
+		// Following flips 1 to 0, and 0 to 1...
+		if (cppIsInteger(resultTypePtr))
+		{
+			sprintf(expression, "(1 - %s)", operand);
+			cppNewTemp(value, "int32_t", expression);
+		}
+		else
+			CppExprFailed = true;
+	}
+	break;
+	case TKN_LPAREN:
+		getCodeToken();
+		resultTypePtr = cppExpression(value);
+		getCodeToken();
+		break;
+	default:
+		CppExprFailed = true;
+		CppRoutineFailed = true;
+		break;
+	}
+	return (resultTypePtr);
+}
+
+//---------------------------------------------------------------------------
+
+const std::unique_ptr<Type>&
+cppTerm(wchar_t* value)
+{
+	wchar_t operand1[MAX_CPP_VALUE];
+	wchar_t operand2[MAX_CPP_VALUE];
+	wchar_t real1[MAX_CPP_VALUE];
+	wchar_t real2[MAX_CPP_VALUE];
+	wchar_t expression[MAX_CPP_LINE];
+	const std::unique_ptr<Type>& resultTypePtr = cppFactor(operand1);
+	//----------------------------------------------
+	// Process the factors separated by operators...
+	while ((CurContext->codeToken == TKN_STAR) || (CurContext->codeToken == TKN_FSLASH) || (CurContext->codeToken == TKN_DIV) || (CurContext->codeToken == TKN_MOD) || (CurContext->codeToken == TKN_AND))
+	{
+		TokenCodeType op = CurContext->codeToken;
+		getCodeToken();
+		const std::unique_ptr<Type>& type2Ptr = cppFactor(operand2);
+		bool bothInteger = (resultTypePtr == IntegerTypePtr) && (type2Ptr == IntegerTypePtr);
+		const wchar_t* cppType = "int32_t";
+		switch (op)
+		{
+		case TKN_AND:
+			if (!cppIsInteger(resultTypePtr) || !cppIsInteger(type2Ptr))
+				CppExprFailed = true;
+			sprintf(expression, "(%s && %s)", operand1, operand2);
+			resultTypePtr = BooleanTypePtr;
+			break;
+		case TKN_STAR:
+			if (bothInteger)
+				sprintf(expression, "(%s * %s)", operand1, operand2);
+			else
+			{
+				if (!cppPromoteToReal(resultTypePtr, operand1, real1) || !cppPromoteToReal(type2Ptr, operand2, real2))
+					CppExprFailed = true;
+				sprintf(expression, "(%s * %s)", real1, real2);
+				cppType = "float";
+			}
+			resultTypePtr = bothInteger ? IntegerTypePtr : RealTypePtr;
+			break;
+		case TKN_FSLASH:
+			if (bothInteger)
+				sprintf(expression, "nativeDivide(%s, %s)", operand1, operand2);
+			else
+			{
+				if (!cppPromoteToReal(resultTypePtr, operand1, real1) || !cppPromoteToReal(type2Ptr, operand2, real2))
+					CppExprFailed = true;
+				sprintf(expression, "nativeRealDivide(%s, %s)", real1, real2);
+				cppType = "float";
+			}
+			resultTypePtr = bothInteger ? IntegerTypePtr : RealTypePtr;
+			break;
+		case TKN_DIV:
+		case TKN_MOD:
+			if (!cppIsInteger(resultTypePtr) || !cppIsInteger(type2Ptr))
+				CppExprFailed = true;
+			sprintf(expression, "%s(%s, %s)", (op == TKN_DIV) ? "nativeDivide" : "nativeModulo", operand1, operand2);
+			resultTypePtr = IntegerTypePtr;
+			break;
+		}
+		if (!CppExprFailed)
+			cppNewTemp(operand1, cppType, expression);
+	}
+	strcpy(value, operand1);
+	return (resultTypePtr);
+}
+
+//---------------------------------------------------------------------------
+
+const std::unique_ptr<Type>&
+cppSimpleExpression(wchar_t* value)
+{
+	wchar_t operand1[MAX_CPP_VALUE];
+	wchar_t operand2[MAX_CPP_VALUE];
+	wchar_t real1[MAX_CPP_VALUE];
+	wchar_t real2[MAX_CPP_VALUE];
+	wchar_t expression[MAX_CPP_LINE];
+	TokenCodeType unaryOp = TKN_PLUS;
+	if ((CurContext->codeToken == TKN_PLUS) || (CurContext->codeToken == TKN_MINUS))
+	{
+		unaryOp = CurContext->codeToken;
+		getCodeToken();
+	}
+	const std::unique_ptr<Type>& resultTypePtr = cppTerm(operand1);
+	if (unaryOp == TKN_MINUS)
+	{
+		sprintf(expression, "-(%s)", operand1);
+		if (resultTypePtr == IntegerTypePtr)
+			cppNewTemp(operand1, "int32_t", expression);
+		else if (resultTypePtr == RealTypePtr)
+			cppNewTemp(operand1, "float", expression);
+		else
+			CppExprFailed = true;
+	}
+	while ((CurContext->codeToken == TKN_PLUS) || (CurContext->codeToken == TKN_MINUS) || (CurContext->codeToken == TKN_OR))
+	{
+		TokenCodeType op = CurContext->codeToken;
+		getCodeToken();
+		const std::unique_ptr<Type>& type2Ptr = cppTerm(operand2);
+		const wchar_t* cppOp = (op == TKN_PLUS) ? "+" : "-";
+		const wchar_t* cppType = "int32_t";
+		if (op == TKN_OR)
+		{
+			if (!cppIsInteger(resultTypePtr) || !cppIsInteger(type2Ptr))
+				CppExprFailed = true;
+			sprintf(expression, "(%s || %s)", operand1, operand2);
+			resultTypePtr = BooleanTypePtr;
+		}
+		else if ((resultTypePtr == IntegerTypePtr) && (type2Ptr == IntegerTypePtr))
+		{
+			sprintf(expression, "(%s %s %s)", operand1, cppOp, operand2);
+			resultTypePtr = IntegerTypePtr;
+		}
+		else
+		{
+			if (!cppPromoteToReal(resultTypePtr, operand1, real1) || !cppPromoteToReal(type2Ptr, operand2, real2))
+				CppExprFailed = true;
+			sprintf(expression, "(%s %s %s)", real1, cppOp, real2);
+			cppType = "float";
+			resultTypePtr = RealTypePtr;
+		}
+		if (!CppExprFailed)
+			cppNewTemp(operand1, cppType, expression);
+	}
+	strcpy(value, operand1);
+	return (resultTypePtr);
+}
+
+//---------------------------------------------------------------------------
+
+const std::unique_ptr<Type>&
+cppExpression(wchar_t* value)
+{
+	//-----------------------------------------------------------
+	// Remember where this expression starts, in case we have to
+	// hand the whole thing back to the interpreter...
+	int32_t offset = cppOffset(CurContext->codeSegmentPtr - 1);
+	size_t mark = CppCodeLength;
+	bool wasExprFailed = CppExprFailed;
+	CppExprFailed = false;
+	wchar_t operand1[MAX_CPP_VALUE];
+	wchar_t operand2[MAX_CPP_VALUE];
+	wchar_t real1[MAX_CPP_VALUE];
+	wchar_t real2[MAX_CPP_VALUE];
+	wchar_t expression[MAX_CPP_LINE];
+	const std::unique_ptr<Type>& resultTypePtr = cppSimpleExpression(operand1);
+	if ((CurContext->codeToken == TKN_EQUALEQUAL) || (CurContext->codeToken == TKN_LT) || (CurContext->codeToken == TKN_GT) || (CurContext->codeToken == TKN_NE) || (CurContext->codeToken == TKN_LE) || (CurContext->codeToken == TKN_GE))
+	{
+		TokenCodeType op = CurContext->codeToken;
+		const wchar_t* cppOp = "==";
+		switch (op)
+		{
+		case TKN_LT:
+			cppOp = "<";
+			break;
+		case TKN_GT:
+			cppOp = ">";
+			break;
+		case TKN_NE:
+			cppOp = "!=";
+			break;
+		case TKN_LE:
+			cppOp = "<=";
+			break;
+		case TKN_GE:
+			cppOp = ">=";
+			break;
+		}
+		getCodeToken();
+		const std::unique_ptr<Type>& type2Ptr = cppSimpleExpression(operand2);
+		if (!resultTypePtr || !type2Ptr)
+			CppExprFailed = true;
+		else if (((resultTypePtr == IntegerTypePtr) && (type2Ptr == IntegerTypePtr)) || (resultTypePtr->form == FRM_ENUM))
+		{
+			if (!cppIsInteger(type2Ptr))
+				CppExprFailed = true;
+			sprintf(expression, "(%s %s %s)", operand1, cppOp, operand2);
+		}
+		else if ((resultTypePtr == CharTypePtr) || (resultTypePtr->form == FRM_ARRAY))
+			CppExprFailed = true;
+		else if ((resultTypePtr == RealTypePtr) || (type2Ptr == RealTypePtr))
+		{
+			if (!cppPromoteToReal(resultTypePtr, operand1, real1) || !cppPromoteToReal(type2Ptr, operand2, real2))
+				CppExprFailed = true;
+			sprintf(expression, "(%s %s %s)", real1, cppOp, real2);
+		}
+		else
+		{
+			//--------------------------------------------
+			// The interpreter compares nothing, and says
+			// false...
+			sprintf(expression, "0");
+		}
+		if (!CppExprFailed)
+			cppNewTemp(operand1, "int32_t", expression);
+		resultTypePtr = BooleanTypePtr;
+	}
+	strcpy(value, operand1);
+	if (!CppExprFailed && !cppIsInteger(resultTypePtr) && (resultTypePtr != RealTypePtr))
+		CppExprFailed = true;
+	if (CppExprFailed)
+	{
+		cppRollback(mark);
+		wchar_t item[MAX_CPP_VALUE];
+		sprintf(item, "t%d", CppNumTemps++);
+		cppEmit("const StackItem %s = nativeEvalExpression(%d);", item, offset);
+		cppStackItemValue(resultTypePtr, item, value);
+		CppCalledInterpreter = true;
+	}
+	//-----------------------------------------------------------
+	// If even the interpreter can't give us something C++ can
+	// hold, whoever wanted this value has to fall back, too...
+	CppExprFailed = wasExprFailed || !value[0];
+	return (resultTypePtr);
+}
+
+//***************************************************************************
+// STATEMENT routines
+//***************************************************************************
+
+void
+cppStatement(bool topLevel);
+
+//---------------------------------------------------------------------------
+
+void
+cppBlock(TokenCodeType endToken1, TokenCodeType endToken2)
+{
+	CppIndent++;
+	while ((CurContext->codeToken != endToken1) && (CurContext->codeToken != endToken2) && !CppRoutineFailed)
+	{
+		Address statementPtr = CurContext->codeSegmentPtr;
+		cppStatement(false);
+		if ((CurContext->codeSegmentPtr == statementPtr) || (CurContext->codeSegmentPtr >= CppCodeSegmentEnd))
+			CppRoutineFailed = true;
+	}
+	CppIndent--;
+}
+
+//---------------------------------------------------------------------------
+
+bool
+cppAssignmentStatement(const std::unique_ptr<SymTableNode>& idPtr)
+{
+	wchar_t target[MAX_CPP_VALUE];
+	wchar_t value[MAX_CPP_VALUE];
+	bool wasExprFailed = CppExprFailed;
+	CppExprFailed = false;
+	const std::unique_ptr<Type>& targetTypePtr = cppVariable(idPtr, USE_TARGET, target);
+	bool translated = !CppExprFailed;
+	CppExprFailed = wasExprFailed;
+	getCodeToken();
+	const std::unique_ptr<Type>& expressionTypePtr = cppExpression(value);
+	if (!translated || !value[0])
+		return (false);
+	if ((targetTypePtr == RealTypePtr) && (expressionTypePtr == IntegerTypePtr))
+		cppEmit("*((float*)%s) = (float)%s;", target, value);
+	else if (cppIsInteger(targetTypePtr) && cppIsInteger(expressionTypePtr))
+		cppEmit("*((int32_t*)%s) = %s;", target, value);
+	else if ((targetTypePtr == RealTypePtr) && (expressionTypePtr == RealTypePtr))
+		cppEmit("*((float*)%s) = %s;", target, value);
+	else
+	{
+		//-------------------------------------------------
+		// Arrays, chars, and anything reinterpreting bits...
+		return (false);
+	}
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+cppSwitchStatement(void)
+{
+	getCodeToken();
+	Address branchTableLocation = getCodeAddressMarker();
+	getCodeToken();
+	wchar_t value[MAX_CPP_VALUE];
+	const std::unique_ptr<Type>& switchExpressionTypePtr = cppExpression(value);
+	bool translated = value[0] && (cppIsInteger(switchExpressionTypePtr) || (switchExpressionTypePtr == CharTypePtr));
+	//-------------------------
+	// Read the branch table...
+	CurContext->codeSegmentPtr = branchTableLocation;
+	getCodeToken();
+	int32_t caseLabelCount = getCodeInteger();
+	std::vector<int32_t> caseLabels;
+	std::vector<Address> caseLocations;
+	for (size_t i = 0; i < caseLabelCount; i++)
+	{
+		int32_t caseLabelValue = getCodeInteger();
+		for (size_t j = 0; j < caseLabels.size(); j++)
+			if (caseLabels[j] == caseLabelValue)
+				translated = false;
+		caseLabels.push_back(caseLabelValue);
+		caseLocations.push_back(getCodeAddress());
+	}
+	Address switchEndLocation = CurContext->codeSegmentPtr;
+	if (translated)
+	{
+		cppEmit("switch (%s)", value);
+		cppEmit("{");
+		for (size_t i = 0; i < caseLocations.size(); i++)
+		{
+			//----------------------------------------------
+			// Labels sharing a branch share one case block...
+			bool seen = false;
+			for (size_t j = 0; j < i; j++)
+				seen = seen || (caseLocations[j] == caseLocations[i]);
+			if (seen)
+				continue;
+			for (size_t j = i; j < caseLocations.size(); j++)
+				if (caseLocations[j] == caseLocations[i])
+					cppEmit("case %d:", caseLabels[j]);
+			cppEmit("{");
+			CurContext->codeSegmentPtr = caseLocations[i];
+			getCodeToken();
+			cppBlock(TKN_END_CASE, TKN_END_CASE);
+			cppEmit("}");
+			cppEmit("break;");
+			getCodeToken();
+			getCodeToken();
+			if ((CurContext->codeToken != TKN_ADDRESS_MARKER) || (getCodeAddressMarker() != switchEndLocation))
+				CppRoutineFailed = true;
+		}
+		cppEmit("}");
+	}
+	//-------------------------------------------------------------
+	// Every case block jumps to the semi-colon after the table, so
+	// both of the interpreter's ways out end up at the same place...
+	CurContext->codeSegmentPtr = switchEndLocation;
+	getCodeToken();
+	if (CurContext->codeToken != TKN_SEMICOLON)
+		CppRoutineFailed = true;
+	getCodeToken();
+	return (translated);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+cppForStatement(void)
+{
+	getCodeToken();
+	Address loopEndLocation = getCodeAddressMarker();
+	getCodeToken();
+	const std::unique_ptr<SymTableNode>& controlIdPtr = getCodeSymTableNodePtr();
+	wchar_t control[MAX_CPP_VALUE];
+	bool wasExprFailed = CppExprFailed;
+	CppExprFailed = false;
+	const std::unique_ptr<Type>& controlTypePtr = cppVariable(controlIdPtr, USE_TARGET, control);
+	bool translated = !CppExprFailed;
+	CppExprFailed = wasExprFailed;
+	//---------------------------------------------------
+	// The interpreter reads the bounds as integers, or as
+	// bytes for an enum control variable...
+	wchar_t initialValue[MAX_CPP_VALUE];
+	wchar_t finalValue[MAX_CPP_VALUE];
+	getCodeToken();
+	const std::unique_ptr<Type>& initialTypePtr = cppExpression(initialValue);
+	int32_t deltaValue = (CurContext->codeToken == TKN_TO) ? 1 : -1;
+	getCodeToken();
+	const std::unique_ptr<Type>& finalTypePtr = cppExpression(finalValue);
+	translated = translated && initialValue[0] && finalValue[0] && cppIsInteger(initialTypePtr) && cppIsInteger(finalTypePtr);
+	int32_t loopIndex = CppNumTemps++;
+	if (translated)
+	{
+		const wchar_t* cast = (controlTypePtr == IntegerTypePtr) ? "" : "(uint8_t)";
+		cppEmit("int32_t iterations%d = 0;", loopIndex);
+		cppEmit("for (int32_t control%d = %s%s; control%d %s %s%s; control%d%s)", loopIndex, cast, initialValue,
+			loopIndex, (deltaValue == 1) ? "<=" : ">=", cast, finalValue, loopIndex, (deltaValue == 1) ? "++" : "--");
+		cppEmit("{");
+		if (controlTypePtr == IntegerTypePtr)
+			cppEmit("\t((StackItem*)%s)->integer = control%d;", control, loopIndex);
+		else
+			cppEmit("\t((StackItem*)%s)->byte = (uint8_t)control%d;", control, loopIndex);
+	}
+	getCodeToken();
+	cppBlock(TKN_END_FOR, TKN_END_FOR);
+	if (translated)
+	{
+		cppEmit("\tnativeLoopCheck(iterations%d);", loopIndex);
+		cppEmit("}");
+	}
+	CurContext->codeSegmentPtr = loopEndLocation;
+	getCodeToken();
+	return (translated);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+cppIfStatement(void)
+{
+	getCodeToken();
+	Address falseLocation = getCodeAddressMarker();
+	getCodeToken();
+	wchar_t test[MAX_CPP_VALUE];
+	const std::unique_ptr<Type>& testTypePtr = cppExpression(test);
+	bool translated = test[0] && cppIsInteger(testTypePtr);
+	//-------------------------------------------------------
+	// Like the interpreter, true means 1 (not just non-zero)...
+	cppEmit("if (%s == 1)", test);
+	cppEmit("{");
+	getCodeToken();
+	cppBlock(TKN_END_IF, TKN_ELSE);
+	cppEmit("}");
+	if ((CurContext->codeSegmentPtr - 1) != falseLocation)
+		CppRoutineFailed = true;
+	if (CurContext->codeToken == TKN_ELSE)
+	{
+		getCodeToken();
+		Address ifEndLocation = getCodeAddressMarker();
+		getCodeToken();
+		cppEmit("else");
+		cppEmit("{");
+		cppBlock(TKN_END_IF, TKN_END_IF);
+		cppEmit("}");
+		if ((CurContext->codeSegmentPtr - 1) != ifEndLocation)
+			CppRoutineFailed = true;
+	}
+	getCodeToken();
+	return (translated);
+}
+
+//---------------------------------------------------------------------------
+
+bool
+cppRepeatStatement(void)
+{
+	int32_t loopIndex = CppNumTemps++;
+	cppEmit("int32_t iterations%d = 0;", loopIndex);
+	cppEmit("while (true)");
+	cppEmit("{");
+	getCodeToken();
+	cppBlock(TKN_UNTIL, TKN_UNTIL);
+	CppIndent++;
+	cppEmit("nativeLoopCheck(iterations%d);", loopIndex);
+	getCodeToken();
+	wchar_t test[MAX_CPP_VALUE];
+	const std::unique_ptr<Type>& testTypePtr = cppExpression(test);
+	cppEmit("if (%s != 0)", test);
+	cppEmit("\tbreak;");
+	CppIndent--;
+	cppEmit("}");
+	return (test[0] && cppIsInteger(testTypePtr));
+}
+
+//---------------------------------------------------------------------------
+
+bool
+cppWhileStatement(void)
+{
+	getCodeToken();
+	Address loopEndLocation = getCodeAddressMarker();
+	int32_t loopIndex = CppNumTemps++;
+	cppEmit("int32_t iterations%d = 0;", loopIndex);
+	cppEmit("while (true)");
+	cppEmit("{");
+	CppIndent++;
+	getCodeToken();
+	wchar_t test[MAX_CPP_VALUE];
+	const std::unique_ptr<Type>& testTypePtr = cppExpression(test);
+	cppEmit("if (%s == 0)", test);
+	cppEmit("\tbreak;");
+	CppIndent--;
+	getCodeToken();
+	cppBlock(TKN_END_WHILE, TKN_END_WHILE);
+	cppEmit("\tnativeLoopCheck(iterations%d);", loopIndex);
+	cppEmit("}");
+	CurContext->codeSegmentPtr = loopEndLocation;
+	getCodeToken();
+	return (test[0] && cppIsInteger(testTypePtr));
+}
+
+//---------------------------------------------------------------------------
+
+void
+cppStatement(bool topLevel)
+{
+	//------------------------------------------------------------
+	// Same bookkeeping execStatement() does, and the offset we'd
+	// hand back to it if this statement has to be interpreted...
+	int32_t statementOffset = -1;
+	if (CurContext->codeToken == TKN_STATEMENT_MARKER)
+	{
+		int32_t lineNumber = getCodeStatementMarker();
+		int32_t fileNumber = IncludeDebugInfo ? CurContext->fileNumber : -1;
+		statementOffset = cppOffset(CurContext->codeSegmentPtr);
+		cppEmit("nativeStatement(%d, %d, %d);", fileNumber, lineNumber, statementOffset);
+		getCodeToken();
+	}
+	if ((CurContext->codeToken == TKN_SEMICOLON) || (CurContext->codeToken == TKN_ELSE) || (CurContext->codeToken == TKN_UNTIL))
+	{
+		while (CurContext->codeToken == TKN_SEMICOLON)
+			getCodeToken();
+		return;
+	}
+	size_t mark = CppCodeLength;
+	int32_t indent = CppIndent;
+	bool wasDelegated = CppDelegated;
+	bool wasCalledInterpreter = CppCalledInterpreter;
+	CppDelegated = false;
+	CppCalledInterpreter = false;
+	bool translated = false;
+	cppEmit("{");
+	CppIndent++;
+	switch (CurContext->codeToken)
+	{
+	case TKN_IDENTIFIER:
+	{
+		const std::unique_ptr<SymTableNode>& idPtr = getCodeSymTableNodePtr();
+		if (idPtr->defn.key == DFN_FUNCTION)
+		{
+			//------------------------------------------------------
+			// Order calls carry their order flag index. The call
+			// itself, and what the order returns, is left to the
+			// interpreter...
+			if (idPtr->defn.info.routine.flags & ROUTINE_FLAG_ORDER)
+			{
+				getCodeByte();
+				getCodeByte();
+			}
+			cppSkipCall(idPtr);
+		}
+		else
+			translated = cppAssignmentStatement(idPtr);
+	}
+	break;
+	case TKN_FOR:
+		translated = cppForStatement();
+		break;
+	case TKN_IF:
+		translated = cppIfStatement();
+		break;
+	case TKN_REPEAT:
+		translated = cppRepeatStatement();
+		break;
+	case TKN_WHILE:
+		translated = cppWhileStatement();
+		break;
+	case TKN_SWITCH:
+		translated = cppSwitchStatement();
+		break;
+	case TKN_TRANS:
+		getCodeToken();
+		getCodeToken();
+		getCodeSymTableNodePtr();
+		getCodeToken();
+		break;
+	case TKN_TRANS_BACK:
+		getCodeToken();
+		break;
+	default:
+		CppRoutineFailed = true;
+		break;
+	}
+	CppIndent = indent;
+	if (translated)
+		cppEmit("}");
+	else
+	{
+		cppRollback(mark);
+		if (statementOffset < 0)
+			CppRoutineFailed = true;
+		cppEmit("nativeExecStatement(%d);", statementOffset);
+		CppDelegated = true;
+		CppCalledInterpreter = true;
+	}
+	while (CurContext->codeToken == TKN_SEMICOLON)
+		getCodeToken();
+	//-------------------------------------------------------------
+	// Nested blocks only bail on a return. The routine's own block
+	// also stops once a new state is set...
+	if (topLevel && CppCalledInterpreter)
+	{
+		cppEmit("if (CurContext->exitWithReturn || CurContext->newStateSet)");
+		cppEmit("\tgoto exitCode;");
+	}
+	else if (!topLevel && CppDelegated)
+	{
+		cppEmit("if (CurContext->exitWithReturn)");
+		cppEmit("\tgoto exitCode;");
+	}
+	CppDelegated = CppDelegated || wasDelegated;
+	CppCalledInterpreter = CppCalledInterpreter || wasCalledInterpreter;
+}
+
+//***************************************************************************
+// ROUTINE routines
+//***************************************************************************
+
+bool
+cppRoutine(const std::unique_ptr<SymTableNode>& routineIdPtr, const wchar_t* cppName)
+{
+	size_t mark = CppCodeLength;
+	CppRoutineIdPtr = routineIdPtr;
+	CppCodeSegment = routineIdPtr->defn.info.routine.codeSegment;
+	CppCodeSegmentEnd = CppCodeSegment + routineIdPtr->defn.info.routine.codeSegmentSize;
+	CppNumTemps = 0;
+	CppIndent = 0;
+	CppExprFailed = false;
+	CppRoutineFailed = false;
+	CppDelegated = false;
+	CppCalledInterpreter = false;
+	if (!CppCodeSegment)
+		return (false);
+	CurContext->codeSegmentPtr = CppCodeSegment;
+	getCodeToken();
+	if (CurContext->codeToken != TKN_CODE)
+		return (false);
+	cppEmit("//---------------------------------------------------------------------------");
+	cppEmit("");
+	cppEmit("static void");
+	cppEmit("%s(void)", cppName);
+	cppEmit("{");
+	CppIndent++;
+	cppEmit("bool wasAutoReturnFromOrders = nativeEnterCode();");
+	cppEmit("if (CurContext->newStateSet)");
+	cppEmit("\tgoto exitCode;");
+	getCodeToken();
+	while (!CppRoutineFailed)
+	{
+		TokenCodeType token = CurContext->codeToken;
+		if ((token == TKN_END_FUNCTION) || (token == TKN_END_ORDER) || (token == TKN_END_STATE) || (token == TKN_END_MODULE) || (token == TKN_END_LIBRARY) || (token == TKN_END_FSM))
+			break;
+		Address statementPtr = CurContext->codeSegmentPtr;
+		cppStatement(true);
+		if ((CurContext->codeSegmentPtr == statementPtr) || (CurContext->codeSegmentPtr >= CppCodeSegmentEnd))
+			CppRoutineFailed = true;
+	}
+	CppIndent--;
+	cppEmit("exitCode:");
+	cppEmit("\tnativeExitCode(wasAutoReturnFromOrders);");
+	cppEmit("}");
+	cppEmit("");
+	if (CppRoutineFailed)
+	{
+		cppRollback(mark);
+		return (false);
+	}
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+
+void
+cppSymTable(const std::unique_ptr<SymTableNode>& curSymbol, const wchar_t* moduleName,
+	std::vector<SymTableNode*>& routines)
+{
+	if (curSymbol)
+	{
+		cppSymTable(curSymbol->left, moduleName, routines);
+		if ((curSymbol->defn.key == DFN_FUNCTION) && (curSymbol->defn.info.routine.key == RTN_DECLARED))
+		{
+			wchar_t routineName[MAX_CPP_NAME];
+			wchar_t cppName[MAX_CPP_NAME * 2];
+			cppIdentifier(curSymbol->name, routineName);
+			sprintf(cppName, "%s_%s", moduleName, routineName);
+			if (cppRoutine(curSymbol, cppName))
+				routines.push_back(curSymbol);
+		}
+		cppSymTable(curSymbol->right, moduleName, routines);
+	}
+}
+
+//***************************************************************************
+
+int32_t
+writeNativeABLModules(const std::wstring_view& fileName, int32_t* numModules, int32_t* numRoutines)
+{
+	ABLFile* cppFile = new ABLFile;
+	if (!cppFile)
+		ABL_Fatal(0, " unable to malloc ABL translator file ");
+	if (cppFile->create(fileName) != ABL_NO_ERR)
+	{
+		delete cppFile;
+		return (-1);
+	}
+	*numModules = 0;
+	*numRoutines = 0;
+	//-------------------------------------------------------------
+	// We walk the code with the main context's code pointer, same
+	// as the executor, so put it back when we're done...
+	Address saveCodeSegmentPtr = CurContext->codeSegmentPtr;
+	TokenCodeType saveCodeToken = CurContext->codeToken;
+	int32_t saveFileNumber = CurContext->fileNumber;
+	cppFile->writeString("//===========================================================================//\n");
+	cppFile->writeString("// Generated by ablt -cpp from the compiled ABL modules. Do not edit.        //\n");
+	cppFile->writeString("//===========================================================================//\n");
+	cppFile->writeString("#include \"stdinc.h\"\n\n");
+	cppFile->writeString("namespace mclib::abl {\n\n");
+	cppFile->writeString("//***************************************************************************\n\n");
+	wchar_t moduleNames[MAX_NATIVE_MODULES][MAX_CPP_NAME];
+	for (size_t i = 0; (i < NumModulesRegistered) && (*numModules < MAX_NATIVE_MODULES); i++)
+	{
+		const std::unique_ptr<SymTableNode>& moduleIdPtr = ModuleRegistry[i].moduleIdPtr;
+		wchar_t moduleName[MAX_CPP_NAME];
+		cppIdentifier(moduleIdPtr->name, moduleName);
+		//-------------------------------------------------------
+		// Modules bind by name, so only the first one counts...
+		bool duplicate = false;
+		for (size_t j = 0; j < *numModules; j++)
+			duplicate = duplicate || (strcmp(moduleNames[j], moduleName) == 0);
+		if (duplicate)
+			continue;
+		cppRollback(0);
+		std::vector<SymTableNode*> routines;
+		if ((moduleIdPtr->defn.info.routine.flags & ROUTINE_FLAG_FSM) == 0)
+		{
+			wchar_t cppName[MAX_CPP_NAME * 2];
+			sprintf(cppName, "%s_module", moduleName);
+			if (cppRoutine(moduleIdPtr, cppName))
+				routines.push_back(moduleIdPtr);
+		}
+		cppSymTable(moduleIdPtr->defn.info.routine.localSymTable, moduleName, routines);
+		if (routines.empty())
+			continue;
+		wchar_t s[MAX_CPP_LINE];
+		sprintf(s, "//***************************************************************************\n// %s\n", ModuleRegistry[i].fileName);
+		cppFile->writeString(s);
+		cppFile->writeString("//***************************************************************************\n\n");
+		cppFile->writeString(CppCode);
+		sprintf(s, "static const ABLNativeRoutine %sNativeRoutines[] = {\n", moduleName);
+		cppFile->writeString(s);
+		for (size_t j = 0; j < routines.size(); j++)
+		{
+			wchar_t routineName[MAX_CPP_NAME];
+			cppIdentifier(routines[j]->name, routineName);
+			if (routines[j] == moduleIdPtr)
+				strcpy(routineName, "module");
+			sprintf(s, "\t{\"%s\", %d, %s_%s},\n", routines[j]->name, routines[j]->defn.info.routine.codeSegmentSize,
+				moduleName, routineName);
+			cppFile->writeString(s);
+		}
+		cppFile->writeString("};\n\n");
+		sprintf(s, "static const ABLNativeModule %sNativeModule = {\"%s\", 0x%08x, %s, %d, %sNativeRoutines};\n\n",
+			moduleName, moduleIdPtr->name, hashABLModuleSources(i), IncludeDebugInfo ? "true" : "false",
+			(int32_t)routines.size(), moduleName);
+		cppFile->writeString(s);
+		strcpy(moduleNames[*numModules], moduleName);
+		(*numModules)++;
+		*numRoutines += (int32_t)routines.size();
+	}
+	cppFile->writeString("//***************************************************************************\n\n");
+	cppFile->writeString("} // namespace mclib::abl\n\n");
+	cppFile->writeString("//***************************************************************************\n\n");
+	cppFile->writeString("void\nregisterNativeABLModules(void)\n{\n");
+	for (size_t i = 0; i < *numModules; i++)
+	{
+		wchar_t s[MAX_CPP_LINE];
+		sprintf(s, "\tmclib::abl::ABLi_registerNativeModule(&mclib::abl::%sNativeModule);\n", moduleNames[i]);
+		cppFile->writeString(s);
+	}
+	cppFile->writeString("}\n");
+	cppFile->close();
+	delete cppFile;
+	free(CppCode);
+	CppCode = nullptr;
+	CppCodeLength = 0;
+	CppCodeMax = 0;
+	CurContext->codeSegmentPtr = saveCodeSegmentPtr;
+	CurContext->codeToken = saveCodeToken;
+	CurContext->fileNumber = saveFileNumber;
+	return (ABL_NO_ERR);
+}
+
+//***************************************************************************
+
+} // namespace mclib::abl
@@ -3024,8 +3024,8 @@ execSetCurrentBRValue(void)
 	// PARAMS: integer, integer
 	//
 	// Returns: None
-	int32_t objectNum = tos->integer;
-	int32_t newBRValue = tos->integer;
+	int32_t objectNum = CurContext->tos->integer;
+	int32_t newBRValue = CurContext->tos->integer;
 	//------------------------------------------------
 	// Code to make this work goes here
 	GameObjectPtr object1 = getObject(objectNum);
@@ -4632,7 +4632,7 @@ execSendMessage(void)
 			DebugMissionScriptMessages();
 			Assert(false, NumMissionScriptMessages, " Way too many Mission Script Messages! ");
 		}
-		MissionScriptMessageLog[NumMissionScriptMessages][0] = execLineNumber;
+		MissionScriptMessageLog[NumMissionScriptMessages][0] = CurContext->execLineNumber;
 		MissionScriptMessageLog[NumMissionScriptMessages][1] = CurMultiplayCode;
 		MissionScriptMessageLog[NumMissionScriptMessages][2] = CurMultiplayParam;
 		NumMissionScriptMessages++;
@@ -6333,9 +6333,15 @@ closeABL(void)
 }
 #else
 //*****************************************************************************
+// Every ABL allocation, for the -bench report...
+int32_t BenchNumAllocations = 0;
+int32_t BenchAllocatedBytes = 0;
+//*****************************************************************************
 PVOID
 ablSystemMallocCallback(uint32_t memSize)
 {
+	BenchNumAllocations++;
+	BenchAllocatedBytes += memSize;
 	const std::wstring_view& mem = new wchar_t[memSize];
 	return (mem);
 }
@@ -6343,6 +6349,8 @@ ablSystemMallocCallback(uint32_t memSize)
 PVOID
 ablStackMallocCallback(uint32_t memSize)
 {
+	BenchNumAllocations++;
+	BenchAllocatedBytes += memSize;
 	const std::wstring_view& mem = new wchar_t[memSize];
 	return (mem);
 }
@@ -6350,6 +6358,8 @@ ablStackMallocCallback(uint32_t memSize)
 PVOID
 ablCodeMallocCallback(uint32_t memSize)
 {
+	BenchNumAllocations++;
+	BenchAllocatedBytes += memSize;
 	const std::wstring_view& mem = new wchar_t[memSize];
 	return (mem);
 }
@@ -6357,6 +6367,8 @@ ablCodeMallocCallback(uint32_t memSize)
 PVOID
 ablSymbolMallocCallback(uint32_t memSize)
 {
+	BenchNumAllocations++;
+	BenchAllocatedBytes += memSize;
 	const std::wstring_view& mem = new wchar_t[memSize];
 	return (mem);
 }
@@ -14,11 +14,38 @@ initABL(void);
 void
 closeABL(void);
 
+namespace mclib::abl {
+int32_t
+writeNativeABLModules(const std::wstring_view& fileName, int32_t* numModules, int32_t* numRoutines);
+int32_t
+runABLBenchmark(int32_t numTicks, int32_t* moduleHandles, int32_t numModules);
+}
+
+#define MAX_BENCH_MODULES 64
+
 extern "C" int __cdecl main(
 	_In_ int argc, _In_reads_(argc) _Pre_z_ wchar_t* argv[], _In_z_ wchar_t** envp)
 {
 	(void)envp;
 
+	//-------------------------------------------------------------
+	// ablt -cpp <file.cpp> ... translates everything it compiles
+	// to C++ afterwards (see ablcpp.cpp). ablt -bench <ticks> ...
+	// runs every module it compiles against stub natives for that
+	// many ticks (see ablbench.cpp)...
+	wchar_t* cppFileName = nullptr;
+	int32_t benchTicks = 0;
+	while ((argc > 2) && (argv[1][0] == '-'))
+	{
+		if (strcmp(argv[1], "-cpp") == 0)
+			cppFileName = argv[2];
+		else if (strcmp(argv[1], "-bench") == 0)
+			benchTicks = atoi(argv[2]);
+		else
+			break;
+		argv += 2;
+		argc -= 2;
+	}
 	if ((argc < 2) || (argc > 3))
 	{
 		printf("Try again.\n");
@@ -33,6 +60,14 @@ extern "C" int __cdecl main(
 	int32_t numErrs = 0;
 	int32_t numLines = 0;
 	int32_t numFiles = 0;
+	//--------------------------------------------------------------
+	// Compile throughput, over everything this run preprocesses...
+	int32_t totalLines = 0;
+	int32_t moduleHandles[MAX_BENCH_MODULES];
+	int32_t numModuleHandles = 0;
+	LARGE_INTEGER frequency, startTime, endTime;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&startTime);
 	if (argc == 3)
 	{
 		//------------------------
@@ -58,11 +93,15 @@ extern "C" int __cdecl main(
 				handle =
 					(int32_t)ABLi_loadLibrary((const std::wstring_view&)&s[2], &numErrs, &numLines, &numFiles, false);
 				printf("     Loaded: %s [%d lines, %d files]\n", &s[2], numLines, numFiles);
+				totalLines += numLines;
 			}
 			else if ((s[0] == 'm') && (s[1] == ' '))
 			{
 				handle = ABLi_preProcess((const std::wstring_view&)&s[2], &numErrs, &numLines, &numFiles, false);
 				printf("     Loaded: %s [%d lines, %d files]\n", &s[2], numLines, numFiles);
+				totalLines += numLines;
+				if ((handle >= 0) && (numModuleHandles < MAX_BENCH_MODULES))
+					moduleHandles[numModuleHandles++] = handle;
 			}
 		}
 		bFile->close();
@@ -75,6 +114,28 @@ extern "C" int __cdecl main(
 	numFiles = 0;
 	handle = ABLi_preProcess(argv[argc - 1], &numErrs, &numLines, &numFiles, false);
 	printf("SUCCESS: %s [%d lines, %d files]\n", argv[argc - 1], numLines, numFiles);
+	if ((handle >= 0) && (numModuleHandles < MAX_BENCH_MODULES))
+		moduleHandles[numModuleHandles++] = handle;
+	QueryPerformanceCounter(&endTime);
+	totalLines += numLines;
+	double seconds = (double)(endTime.QuadPart - startTime.QuadPart) / (double)frequency.QuadPart;
+	printf("Compiled %d lines in %.3f sec (%.0f lines/sec, %d images loaded)\n", totalLines, seconds,
+		(seconds > 0.0) ? (totalLines / seconds) : 0.0, CompiledModuleStats.numLoaded);
+	if (cppFileName)
+	{
+		int32_t numModules = 0;
+		int32_t numRoutines = 0;
+		if (mclib::abl::writeNativeABLModules(cppFileName, &numModules, &numRoutines) != 0)
+			printf("Cannot create %s\n", cppFileName);
+		else
+			printf("Translated %d routines in %d modules to %s\n", numRoutines, numModules, cppFileName);
+	}
+	if (benchTicks > 0)
+	{
+		printf("\n");
+		if (mclib::abl::runABLBenchmark(benchTicks, moduleHandles, numModuleHandles) != 0)
+			printf("Nothing to benchmark\n");
+	}
 	scanf(" ");
 	closeABL();
 	return (0);
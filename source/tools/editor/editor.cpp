@@ -134,12 +134,8 @@ UpdateRenderers()
 	globalFloatHelp->renderAll();
 	turn++;
 	reloadBounds = false;
-	// reset the TGL RAM pools.
-	colorPool->reset();
-	vertexPool->reset();
-	facePool->reset();
-	shadowPool->reset();
-	trianglePool->reset();
+	// Start a new frame in the frame arena.
+	frameArena->newFrame();
 }
 
 bool statisticsInitialized = false;
@@ -522,24 +518,14 @@ InitializeGameEngine()
 	// Start the Tiny Geometry Layer Heap.
 	TG_Shape::tglHeap = new UserHeap;
 	TG_Shape::tglHeap->init(tglHeapSize, "TinyGeom");
-	// Start up the TGL RAM pools.
-	colorPool = new TG_VertexPool;
-	colorPool->init(20000);
-	vertexPool = new TG_GOSVertexPool;
-	vertexPool->init(20000);
-	facePool = new TG_DWORDPool;
-	facePool->init(40000);
-	shadowPool = new TG_ShadowPool;
-	shadowPool->init(20000);
-	trianglePool = new TG_TrianglePool;
-	trianglePool->init(20000);
 	//--------------------------------------------------------------
 	//------------------------------------------------
 	// Fire up the MC Texture Manager.
 	mcTextureManager = new MC_TextureManager;
 	mcTextureManager->start();
-	// Startup the vertex array pool
-	mcTextureManager->startVertices(500000);
+	// Startup the frame arena for the TGL transforms and vertex arrays
+	frameArena = new FrameArena;
+	frameArena->init(16 * 1024 * 1024, 4 * 1024 * 1024, "FrameArena");
 	//--------------------------------------------------------------
 	// Load up the mouse cursors
 	godMode = true;
@@ -604,46 +590,20 @@ TerminateGameEngine()
 	// shutdown the MC Texture Manager.
 	if (mcTextureManager)
 	{
-		mcTextureManager->freeVertices();
 		mcTextureManager->destroy();
 		delete mcTextureManager;
 		mcTextureManager = nullptr;
 	}
+	if (frameArena)
+	{
+		frameArena->destroy();
+		delete frameArena;
+		frameArena = nullptr;
+	}
 	//---------------------------------------------------------
 	// End the Tiny Geometry Layer Heap.
 	if (TG_Shape::tglHeap)
 	{
-		// Shut down the TGL RAM pools.
-		if (colorPool)
-		{
-			colorPool->destroy();
-			delete colorPool;
-			colorPool = nullptr;
-		}
-		if (vertexPool)
-		{
-			vertexPool->destroy();
-			delete vertexPool;
-			vertexPool = nullptr;
-		}
-		if (facePool)
-		{
-			facePool->destroy();
-			delete facePool;
-			facePool = nullptr;
-		}
-		if (shadowPool)
-		{
-			shadowPool->destroy();
-			delete shadowPool;
-			shadowPool = nullptr;
-		}
-		if (trianglePool)
-		{
-			trianglePool->destroy();
-			delete trianglePool;
-			trianglePool = nullptr;
-		}
 		TG_Shape::tglHeap->destroy();
 		delete TG_Shape::tglHeap;
 		TG_Shape::tglHeap = nullptr;
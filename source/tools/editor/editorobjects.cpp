@@ -48,7 +48,7 @@ PVOID
 EditorObject::operator new(size_t mySize)
 {
 	PVOID result = nullptr;
-	result = systemHeap->Malloc(mySize);
+	result = systemHeap->Malloc(mySize, HEAP_CALLER());
 	return (result);
 }
 
@@ -0,0 +1,536 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+// heapbench.cpp : Replays heap allocation traces (HeapTrace in system.cfg)
+//  against the User Heap allocators and reports how fast each one ran and
+//  how badly it fragmented.
+//
+
+#include "stdinc.h"
+
+#include "sizeheap.h"
+
+#include <chrono>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+//---------------------------------------------------------------------------
+typedef struct _TraceHeap
+{
+	char name[HEAP_TRACE_NAME_LENGTH];
+	size_t size; // replay size, zero in the trace for GOS heaps
+	size_t peakBytes; // most asked for at once
+} TraceHeap;
+
+typedef struct _ReplayResult
+{
+	double seconds;
+	uint32_t numOps;
+	uint32_t numFailed; // mallocs that didn't fit
+	double fragmentation; // mean of 1 - largest free / total free
+	double worstFragmentation;
+	size_t worstHeap;
+} ReplayResult;
+
+std::vector<HeapTraceRecord> traceRecords;
+std::vector<TraceHeap> traceHeaps;
+uint32_t traceNumIds = 0;
+
+#define FRAGMENTATION_SAMPLE 512 // ops between samples
+#define MIN_REPLAY_HEAP (256 * 1024)
+
+//---------------------------------------------------------------------------
+// The allocator the User Heaps had before the size class heap: one free
+// list, smallest first, searched from the front for the first block that
+// fits.  The original was x86 assembly; this follows it step for step so
+// the two can be replayed side by side.
+class ListHeap
+{
+protected:
+	HeapBlockPtr heapStart;
+	HeapBlockPtr heapEnd;
+	HeapBlockPtr firstBlock;
+
+public:
+	ListHeap(void)
+	{
+		heapStart = heapEnd = firstBlock = nullptr;
+	}
+
+	//---------------------------------------------------------------------------
+	bool init(PVOID heapMemory, size_t heapSize)
+	{
+		uintptr_t bottom = ((uintptr_t)heapMemory + sizeof(size_t) - 1) & ~(uintptr_t)(sizeof(size_t) - 1);
+		uintptr_t top = ((uintptr_t)heapMemory + heapSize - sizeof(HeapBlock)) & ~(uintptr_t)(sizeof(size_t) - 1);
+		if (top < bottom + HEAP_MIN_BLOCK)
+			return (false);
+		heapStart = (HeapBlockPtr)bottom;
+		heapEnd = (HeapBlockPtr)top;
+		heapStart->blockSize = top - bottom;
+		heapStart->upperBlock = nullptr;
+		heapEnd->blockSize = 1;
+		heapEnd->upperBlock = heapStart;
+		firstBlock = nullptr;
+		relink(heapStart);
+		return (true);
+	}
+
+	//---------------------------------------------------------------------------
+	PVOID Malloc(size_t memSize)
+	{
+		size_t blockSize = (memSize + HEAP_HEADER_SIZE + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+		if (blockSize < HEAP_MIN_BLOCK)
+			blockSize = HEAP_MIN_BLOCK;
+		HeapBlockPtr block = firstBlock;
+		if (!block)
+			return (nullptr);
+		while (block->blockSize < blockSize)
+		{
+			block = block->next;
+			if (block == firstBlock)
+				return (nullptr);
+		}
+		size_t rest = block->blockSize - blockSize;
+		if (rest < HEAP_MIN_BLOCK)
+		{
+			unlink(block);
+			block->blockSize |= 1;
+			return ((uint8_t*)block + HEAP_HEADER_SIZE);
+		}
+		//----------------------------------------------------
+		// The new block comes off the bottom of the free one,
+		// which stays put, smaller, and moves up the list.
+		HeapBlockPtr newBlock = (HeapBlockPtr)((uint8_t*)block + rest);
+		((HeapBlockPtr)((uint8_t*)block + block->blockSize))->upperBlock = newBlock;
+		block->blockSize = rest;
+		newBlock->blockSize = blockSize | 1;
+		newBlock->upperBlock = block;
+		shrunk(block);
+		return ((uint8_t*)newBlock + HEAP_HEADER_SIZE);
+	}
+
+	//---------------------------------------------------------------------------
+	bool Free(PVOID memBlock)
+	{
+		HeapBlockPtr block = (HeapBlockPtr)((uint8_t*)memBlock - HEAP_HEADER_SIZE);
+		if (!(block->blockSize & 1))
+			return (false);
+		block->blockSize &= ~1;
+		HeapBlockPtr lower = (HeapBlockPtr)((uint8_t*)block + block->blockSize);
+		if (!(lower->blockSize & 1))
+		{
+			unlink(lower);
+			block->blockSize += lower->blockSize;
+			((HeapBlockPtr)((uint8_t*)block + block->blockSize))->upperBlock = block;
+		}
+		HeapBlockPtr upper = block->upperBlock;
+		if (upper && !(upper->blockSize & 1))
+		{
+			upper->blockSize += block->blockSize;
+			((HeapBlockPtr)((uint8_t*)upper + upper->blockSize))->upperBlock = upper;
+			grown(upper);
+			return (true);
+		}
+		relink(block);
+		return (true);
+	}
+
+	//---------------------------------------------------------------------------
+	size_t totalFree(void)
+	{
+		size_t result = 0;
+		HeapBlockPtr block = firstBlock;
+		if (block)
+		{
+			do
+			{
+				result += block->blockSize - HEAP_HEADER_SIZE;
+				block = block->next;
+			} while (block != firstBlock);
+		}
+		return (result);
+	}
+
+	size_t largestFree(void)
+	{
+		return (firstBlock ? (firstBlock->previous->blockSize - HEAP_HEADER_SIZE) : 0);
+	}
+
+protected:
+	//---------------------------------------------------------------------------
+	void relink(HeapBlockPtr block)
+	{
+		if (!firstBlock)
+		{
+			firstBlock = block->previous = block->next = block;
+			return;
+		}
+		HeapBlockPtr after = firstBlock;
+		bool smallest = true;
+		while (after->blockSize < block->blockSize)
+		{
+			after = after->next;
+			smallest = false;
+			if (after == firstBlock)
+				break;
+		}
+		insertBefore(block, after);
+		if (smallest)
+			firstBlock = block;
+	}
+
+	//---------------------------------------------------------------------------
+	void unlink(HeapBlockPtr block)
+	{
+		if (block->next == block)
+		{
+			firstBlock = nullptr;
+			return;
+		}
+		if (block == firstBlock)
+			firstBlock = block->next;
+		block->previous->next = block->next;
+		block->next->previous = block->previous;
+	}
+
+	//---------------------------------------------------------------------------
+	void insertBefore(HeapBlockPtr block, HeapBlockPtr after)
+	{
+		block->next = after;
+		block->previous = after->previous;
+		after->previous->next = block;
+		after->previous = block;
+	}
+
+	//---------------------------------------------------------------------------
+	// A block got smaller: walk it back toward the front.
+	void shrunk(HeapBlockPtr block)
+	{
+		if ((block == firstBlock) || (block->previous->blockSize <= block->blockSize))
+			return;
+		HeapBlockPtr after = block->previous;
+		unlink(block);
+		while ((after != firstBlock) && (after->previous->blockSize > block->blockSize))
+			after = after->previous;
+		insertBefore(block, after);
+		if (after == firstBlock)
+			firstBlock = block;
+	}
+
+	//---------------------------------------------------------------------------
+	// A block got bigger: walk it on toward the back.
+	void grown(HeapBlockPtr block)
+	{
+		if ((block->next == firstBlock) || (block->next->blockSize >= block->blockSize))
+			return;
+		HeapBlockPtr after = block->next;
+		unlink(block);
+		do
+			after = after->next;
+		while ((after != firstBlock) && (after->blockSize < block->blockSize));
+		insertBefore(block, after);
+	}
+};
+
+//---------------------------------------------------------------------------
+bool
+readTrace(const wchar_t* fileName)
+{
+	FILE* file = fopen(fileName, "rb");
+	if (!file)
+	{
+		printf("Can't open %s\n", fileName);
+		return (false);
+	}
+	char magic[8];
+	uint32_t version = 0;
+	if ((fread(magic, 1, 8, file) != 8) || memcmp(magic, "MC2HEAPT", 8) || (fread(&version, sizeof(version), 1, file) != 1) || (version != HEAP_TRACE_VERSION))
+	{
+		printf("%s is not a heap trace\n", fileName);
+		fclose(file);
+		return (false);
+	}
+	HeapTraceRecord record;
+	while (fread(&record, sizeof(record), 1, file) == 1)
+	{
+		if (record.op == HEAP_TRACE_HEAP)
+		{
+			TraceHeap heap;
+			memset(&heap, 0, sizeof(heap));
+			if (fread(heap.name, 1, HEAP_TRACE_NAME_LENGTH, file) != HEAP_TRACE_NAME_LENGTH)
+				break;
+			heap.name[HEAP_TRACE_NAME_LENGTH - 1] = 0;
+			heap.size = record.size;
+			if (record.heap >= traceHeaps.size())
+				traceHeaps.resize(record.heap + 1);
+			traceHeaps[record.heap] = heap;
+			continue;
+		}
+		if ((record.op != HEAP_TRACE_MALLOC) && (record.op != HEAP_TRACE_FREE))
+		{
+			printf("%s is damaged\n", fileName);
+			break;
+		}
+		if (record.id >= traceNumIds)
+			traceNumIds = record.id + 1;
+		traceRecords.push_back(record);
+	}
+	fclose(file);
+	return (traceRecords.size() != 0);
+}
+
+//---------------------------------------------------------------------------
+// Something like the game's own mix: lots of small blocks of a few sizes
+// that come and go, some odd sizes, a few big ones, and a share of blocks
+// that stay for the whole run.
+void
+makeSyntheticTrace(uint32_t numOps, uint32_t seed)
+{
+	static const uint32_t commonSizes[] = {12, 16, 24, 32, 40, 48, 64, 96, 128, 192, 256};
+	std::mt19937 random(seed);
+	typedef std::pair<uint32_t, uint32_t> PendingFree; // when, id
+	std::priority_queue<PendingFree, std::vector<PendingFree>, std::greater<PendingFree>> pending;
+	TraceHeap heap;
+	memset(&heap, 0, sizeof(heap));
+	strcpy(heap.name, "SYNTHETIC");
+	heap.size = 0; // sized like a GOS heap
+	traceHeaps.push_back(heap);
+	for (uint32_t op = 0; traceRecords.size() < numOps; op++)
+	{
+		HeapTraceRecord record;
+		record.heap = 0;
+		if (!pending.empty() && (pending.top().first <= op))
+		{
+			record.op = HEAP_TRACE_FREE;
+			record.id = pending.top().second;
+			record.size = 0;
+			pending.pop();
+			traceRecords.push_back(record);
+			continue;
+		}
+		uint32_t kind = random() % 100;
+		record.op = HEAP_TRACE_MALLOC;
+		record.id = traceNumIds++;
+		if (kind < 60)
+			record.size = commonSizes[random() % (sizeof(commonSizes) / sizeof(commonSizes[0]))];
+		else if (kind < 90)
+			record.size = 1 + random() % 1024;
+		else if (kind < 99)
+			record.size = 1024 + random() % (16 * 1024);
+		else
+			record.size = 16 * 1024 + random() % (240 * 1024);
+		traceRecords.push_back(record);
+		uint32_t lifetime = random() % 100;
+		if (lifetime < 75)
+			pending.push(PendingFree(op + 1 + random() % 200, record.id));
+		else if (lifetime < 99)
+			pending.push(PendingFree(op + 1 + random() % 20000, record.id));
+	}
+}
+
+//---------------------------------------------------------------------------
+// GOS heaps have no size in the trace; they get twice what they ever had
+// out.  Everything else gets its own size, scaled by -shrink.
+void
+sizeTraceHeaps(uint32_t percent)
+{
+	std::vector<size_t> live(traceHeaps.size(), 0);
+	std::vector<uint32_t> sizes(traceNumIds, 0);
+	for (size_t i = 0; i < traceRecords.size(); i++)
+	{
+		const HeapTraceRecord& record = traceRecords[i];
+		if (record.heap >= traceHeaps.size())
+			traceHeaps.resize(record.heap + 1);
+		if (record.op == HEAP_TRACE_MALLOC)
+		{
+			sizes[record.id] = record.size + HEAP_GRANULE * 2;
+			live[record.heap] += sizes[record.id];
+			if (live[record.heap] > traceHeaps[record.heap].peakBytes)
+				traceHeaps[record.heap].peakBytes = live[record.heap];
+		}
+		else
+			live[record.heap] -= sizes[record.id];
+	}
+	for (size_t i = 0; i < traceHeaps.size(); i++)
+	{
+		TraceHeap& heap = traceHeaps[i];
+		if (!heap.size)
+			heap.size = heap.peakBytes * 2;
+		heap.size = (size_t)((double)heap.size * percent / 100.0);
+		if (heap.size < MIN_REPLAY_HEAP)
+			heap.size = MIN_REPLAY_HEAP;
+		if (heap.size > MAX_SIZE_HEAP)
+			heap.size = MAX_SIZE_HEAP;
+	}
+}
+
+//---------------------------------------------------------------------------
+void
+setThreadCaches(std::vector<std::unique_ptr<ListHeap>>& heaps, bool threadCaches)
+{
+	(void)heaps;
+	(void)threadCaches;
+}
+
+void
+setThreadCaches(std::vector<std::unique_ptr<SizeClassHeap>>& heaps, bool threadCaches)
+{
+	for (size_t i = 0; i < heaps.size(); i++)
+		heaps[i]->setThreadCaches(threadCaches);
+}
+
+//---------------------------------------------------------------------------
+// Runs the trace twice: once timed, once stopping every so often to see
+// how broken up each heap's free space is.
+template <class Heap>
+void
+replayTrace(std::vector<std::vector<uint8_t>>& memory, bool threadCaches, ReplayResult& result,
+	std::vector<double>& heapFragmentation)
+{
+	memset(&result, 0, sizeof(result));
+	heapFragmentation.assign(traceHeaps.size(), 0.0);
+	std::vector<uint32_t> heapSamples(traceHeaps.size(), 0);
+	std::vector<PVOID> blocks(traceNumIds, nullptr);
+	uint32_t numSamples = 0;
+	for (size_t pass = 0; pass < 2; pass++)
+	{
+		bool sampling = (pass == 1);
+		std::vector<std::unique_ptr<Heap>> heaps(traceHeaps.size());
+		for (size_t i = 0; i < traceHeaps.size(); i++)
+		{
+			heaps[i].reset(new Heap);
+			heaps[i]->init(memory[i].data(), traceHeaps[i].size);
+		}
+		setThreadCaches(heaps, threadCaches);
+		std::fill(blocks.begin(), blocks.end(), nullptr);
+		uint32_t numFailed = 0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < traceRecords.size(); i++)
+		{
+			const HeapTraceRecord& record = traceRecords[i];
+			Heap* heap = heaps[record.heap].get();
+			if (record.op == HEAP_TRACE_MALLOC)
+			{
+				blocks[record.id] = heap->Malloc(record.size);
+				if (!blocks[record.id])
+					numFailed++;
+			}
+			else if (blocks[record.id])
+			{
+				heap->Free(blocks[record.id]);
+				blocks[record.id] = nullptr;
+			}
+			if (sampling && ((i % FRAGMENTATION_SAMPLE) == 0))
+			{
+				size_t totalFree = heap->totalFree();
+				double fragmentation = totalFree ? (1.0 - (double)heap->largestFree() / (double)totalFree) : 0.0;
+				result.fragmentation += fragmentation;
+				heapFragmentation[record.heap] += fragmentation;
+				heapSamples[record.heap]++;
+				numSamples++;
+				if (fragmentation > result.worstFragmentation)
+				{
+					result.worstFragmentation = fragmentation;
+					result.worstHeap = record.heap;
+				}
+			}
+		}
+		if (!sampling)
+		{
+			result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			result.numOps = (uint32_t)traceRecords.size();
+			result.numFailed = numFailed;
+		}
+	}
+	if (numSamples)
+		result.fragmentation /= numSamples;
+	for (size_t i = 0; i < traceHeaps.size(); i++)
+		if (heapSamples[i])
+			heapFragmentation[i] /= heapSamples[i];
+}
+
+//---------------------------------------------------------------------------
+void
+printResult(const wchar_t* name, const ReplayResult& result)
+{
+	printf("%-18s %10.3f %10.2f %8d %9.1f%% %9.1f%%  %s\n", name, result.seconds,
+		(result.seconds > 0.0) ? (result.numOps / result.seconds / 1000000.0) : 0.0, result.numFailed,
+		100.0 * result.fragmentation, 100.0 * result.worstFragmentation,
+		traceHeaps.size() ? traceHeaps[result.worstHeap].name : "");
+}
+
+//---------------------------------------------------------------------------
+extern "C" int __cdecl main(
+	_In_ int argc, _In_reads_(argc) _Pre_z_ wchar_t* argv[], _In_z_ wchar_t** envp)
+{
+	(void)envp;
+
+	//-------------------------------------------------------------
+	// heapbench <trace> replays a trace written with HeapTrace set
+	// in system.cfg.  heapbench -synthetic <ops> [seed] makes one
+	// up instead.  -shrink <percent> runs every heap at that
+	// percent of its size, to see which allocator runs out first.
+	// -heaps prints fragmentation heap by heap.
+	uint32_t shrink = 100;
+	bool perHeap = false;
+	while ((argc > 1) && (argv[1][0] == '-') && (strcmp(argv[1], "-synthetic") != 0))
+	{
+		if ((strcmp(argv[1], "-shrink") == 0) && (argc > 2))
+		{
+			shrink = atoi(argv[2]);
+			argv++;
+			argc--;
+		}
+		else if (strcmp(argv[1], "-heaps") == 0)
+			perHeap = true;
+		else
+			argc = 0;
+		argv++;
+		argc--;
+	}
+	if ((argc < 2) || !shrink)
+	{
+		printf("usage: heapbench [-shrink <percent>] [-heaps] <trace>\n");
+		printf("       heapbench [-shrink <percent>] [-heaps] -synthetic <ops> [seed]\n");
+		return (1);
+	}
+	printf("HEAPBENCH - MechCommander 2 Heap Trace Replay v0.1\n");
+	printf("\n");
+	if (strcmp(argv[1], "-synthetic") == 0)
+		makeSyntheticTrace((argc > 2) ? atoi(argv[2]) : 1000000, (argc > 3) ? atoi(argv[3]) : 1);
+	else if (!readTrace(argv[1]))
+		return (1);
+	sizeTraceHeaps(shrink);
+	uint32_t numMallocs = 0;
+	for (size_t i = 0; i < traceRecords.size(); i++)
+		if (traceRecords[i].op == HEAP_TRACE_MALLOC)
+			numMallocs++;
+	printf("%zu heaps, %d mallocs, %zu frees\n\n", traceHeaps.size(), numMallocs,
+		traceRecords.size() - numMallocs);
+	std::vector<std::vector<uint8_t>> memory(traceHeaps.size());
+	for (size_t i = 0; i < traceHeaps.size(); i++)
+		memory[i].resize(traceHeaps[i].size);
+
+	ReplayResult listResult, sizeResult, cacheResult;
+	std::vector<double> listHeaps, sizeHeaps, cacheHeaps;
+	replayTrace<ListHeap>(memory, false, listResult, listHeaps);
+	replayTrace<SizeClassHeap>(memory, false, sizeResult, sizeHeaps);
+	replayTrace<SizeClassHeap>(memory, true, cacheResult, cacheHeaps);
+
+	printf("%-18s %10s %10s %8s %10s %10s  %s\n", "allocator", "seconds", "Mops/s", "failed",
+		"frag mean", "frag worst", "worst heap");
+	printResult("list (old)", listResult);
+	printResult("size class", sizeResult);
+	printResult("size class+cache", cacheResult);
+	if (perHeap)
+	{
+		printf("\n%-32s %10s %10s %10s %10s\n", "heap", "size", "list", "size class", "+cache");
+		for (size_t i = 0; i < traceHeaps.size(); i++)
+			printf("%-32s %10zu %9.1f%% %9.1f%% %9.1f%%\n", traceHeaps[i].name, traceHeaps[i].size,
+				100.0 * listHeaps[i], 100.0 * sizeHeaps[i], 100.0 * cacheHeaps[i]);
+	}
+	return (0);
+}
@@ -0,0 +1,690 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+// repack.cpp : Rewrites packet files (.pak) and fastfiles (.fst) with LZ
+//  block compression, times how fast archives unpack, and benchmarks and
+//  fuzzes LZDecomp against the reference decoder.
+//
+
+#include "stdinc.h"
+
+#include <zlib.h>
+
+//---------------------------------------------------------------------------
+// Globals the mclib file code expects from its host.
+UserHeapPtr systemHeap = nullptr;
+
+//---------------------------------------------------------------------------
+// A fastfile on disk: version, entry count, the entries, then the data.
+// Positions are from the start of the file.
+#pragma pack(1)
+typedef struct _FastFileDiskEntry
+{
+	int32_t position;
+	int32_t size; // packed size
+	int32_t realSize; // unpacked size
+	uint32_t hash;
+	char name[250];
+} FastFileDiskEntry;
+#pragma pack()
+
+typedef struct _RepackStats
+{
+	double oldBytes; // packed bytes before
+	double newBytes; // packed bytes after
+	double unpackedBytes;
+	double oldSeconds; // time spent unpacking the original
+	double newSeconds; // time spent unpacking the repacked one
+} RepackStats;
+
+LARGE_INTEGER timerFrequency;
+
+//---------------------------------------------------------------------------
+double
+timerSeconds(const LARGE_INTEGER& startTime)
+{
+	LARGE_INTEGER endTime;
+	QueryPerformanceCounter(&endTime);
+	return ((double)(endTime.QuadPart - startTime.QuadPart) / (double)timerFrequency.QuadPart);
+}
+
+//---------------------------------------------------------------------------
+uint8_t*
+readWholeFile(const wchar_t* fileName, size_t& size)
+{
+	size = 0;
+	FILE* file = fopen(fileName, "rb");
+	if (!file)
+		return nullptr;
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	uint8_t* data = (uint8_t*)malloc(size ? size : 1);
+	if (data && (fread(data, 1, size, file) != size))
+	{
+		free(data);
+		data = nullptr;
+	}
+	fclose(file);
+	return data;
+}
+
+//---------------------------------------------------------------------------
+// Unpacks one entry of an original (zLib or old LZ) fastfile.
+size_t
+unpackFastEntry(uint32_t version, uint8_t* dest, const FastFileDiskEntry& entry, const uint8_t* packet)
+{
+	if (version == FASTFILE_VERSION_LZ)
+		return LZDecomp(dest, (uint8_t*)packet, entry.size);
+	if (version == FASTFILE_VERSION_LZB)
+	{
+		if (entry.size == entry.realSize)
+		{
+			memcpy(dest, packet, entry.size);
+			return entry.size;
+		}
+		return LZBDecomp(dest, entry.realSize, packet, entry.size);
+	}
+	uint32_t decompLength = entry.realSize;
+	if (uncompress(dest, &decompLength, packet, entry.size) != Z_OK)
+		return 0;
+	return decompLength;
+}
+
+//---------------------------------------------------------------------------
+// Walks every entry of a fastfile image, unpacking each.  Returns false
+// if anything is out of bounds or doesn't unpack to its real size.
+bool
+timeFastFile(const uint8_t* image, size_t imageSize, RepackStats& stats, double& seconds)
+{
+	uint32_t version = ((const uint32_t*)image)[0];
+	int32_t numFiles = ((const int32_t*)image)[1];
+	const FastFileDiskEntry* entries = (const FastFileDiskEntry*)(image + sizeof(int32_t) * 2);
+	uint8_t* buffer = nullptr;
+	size_t bufferSize = 0;
+	bool ok = true;
+	LARGE_INTEGER startTime;
+	QueryPerformanceCounter(&startTime);
+	for (size_t i = 0; ok && (i < numFiles); i++)
+	{
+		const FastFileDiskEntry& entry = entries[i];
+		if ((entry.position < 0) || (entry.size < 0) || ((size_t)entry.position + entry.size > imageSize))
+		{
+			ok = false;
+			break;
+		}
+		if (bufferSize < (size_t)entry.realSize)
+		{
+			free(buffer);
+			bufferSize = entry.realSize;
+			buffer = (uint8_t*)malloc(bufferSize);
+		}
+		ok = (unpackFastEntry(version, buffer, entry, image + entry.position) == (size_t)entry.realSize);
+		stats.unpackedBytes += entry.realSize;
+	}
+	seconds += timerSeconds(startTime);
+	free(buffer);
+	return ok;
+}
+
+//---------------------------------------------------------------------------
+bool
+isFastFileImage(const uint8_t* image, size_t imageSize)
+{
+	if (imageSize < sizeof(int32_t) * 2)
+		return false;
+	uint32_t version = ((const uint32_t*)image)[0];
+	if ((version != FASTFILE_VERSION) && (version != FASTFILE_VERSION_LZ) && (version != FASTFILE_VERSION_LZB))
+		return false;
+	int32_t numFiles = ((const int32_t*)image)[1];
+	return ((numFiles >= 0) && ((sizeof(int32_t) * 2 + numFiles * sizeof(FastFileDiskEntry)) <= imageSize));
+}
+
+//---------------------------------------------------------------------------
+int32_t
+repackFastFile(const wchar_t* inName, const wchar_t* outName, RepackStats& stats)
+{
+	size_t imageSize = 0;
+	uint8_t* image = readWholeFile(inName, imageSize);
+	if (!image || !isFastFileImage(image, imageSize))
+	{
+		printf("%s is not a fastfile\n", inName);
+		free(image);
+		return (-1);
+	}
+	uint32_t version = ((const uint32_t*)image)[0];
+	int32_t numFiles = ((const int32_t*)image)[1];
+	const FastFileDiskEntry* entries = (const FastFileDiskEntry*)(image + sizeof(int32_t) * 2);
+	RepackStats oldStats = {0};
+	if (!timeFastFile(image, imageSize, oldStats, stats.oldSeconds))
+	{
+		printf("%s is damaged\n", inName);
+		free(image);
+		return (-1);
+	}
+	//---------------------------------------------------------
+	// Unpack each entry and pack it again.  Entries that don't
+	// get smaller are stored as is, which the loader spots by
+	// size == realSize.
+	size_t headerSize = sizeof(int32_t) * 2 + numFiles * sizeof(FastFileDiskEntry);
+	size_t outCapacity = headerSize;
+	for (size_t i = 0; i < numFiles; i++)
+		outCapacity += LZBCompressBound(entries[i].realSize);
+	uint8_t* outImage = (uint8_t*)malloc(outCapacity);
+	((uint32_t*)outImage)[0] = FASTFILE_VERSION_LZB;
+	((int32_t*)outImage)[1] = numFiles;
+	FastFileDiskEntry* outEntries = (FastFileDiskEntry*)(outImage + sizeof(int32_t) * 2);
+	size_t outSize = headerSize;
+	uint8_t* unpacked = nullptr;
+	size_t unpackedSize = 0;
+	for (size_t i = 0; i < numFiles; i++)
+	{
+		const FastFileDiskEntry& entry = entries[i];
+		if (unpackedSize < (size_t)entry.realSize)
+		{
+			free(unpacked);
+			unpackedSize = entry.realSize;
+			unpacked = (uint8_t*)malloc(unpackedSize);
+		}
+		unpackFastEntry(version, unpacked, entry, image + entry.position);
+		outEntries[i] = entry;
+		outEntries[i].position = (int32_t)outSize;
+		size_t packedSize =
+			LZBCompress(outImage + outSize, outCapacity - outSize, unpacked, entry.realSize);
+		if (!packedSize || (packedSize >= (size_t)entry.realSize))
+		{
+			memcpy(outImage + outSize, unpacked, entry.realSize);
+			packedSize = entry.realSize;
+		}
+		outEntries[i].size = (int32_t)packedSize;
+		outSize += packedSize;
+	}
+	free(unpacked);
+	//-------------------------------------------------------
+	// Unpack the new image and compare it against the old one
+	// before anything goes to disk.
+	RepackStats newStats = {0};
+	bool verified = timeFastFile(outImage, outSize, newStats, stats.newSeconds);
+	uint8_t* oldData = nullptr;
+	uint8_t* newData = nullptr;
+	for (size_t i = 0; verified && (i < numFiles); i++)
+	{
+		size_t realSize = entries[i].realSize;
+		oldData = (uint8_t*)realloc(oldData, realSize ? realSize : 1);
+		newData = (uint8_t*)realloc(newData, realSize ? realSize : 1);
+		unpackFastEntry(version, oldData, entries[i], image + entries[i].position);
+		unpackFastEntry(FASTFILE_VERSION_LZB, newData, outEntries[i], outImage + outEntries[i].position);
+		verified = (memcmp(oldData, newData, realSize) == 0);
+	}
+	free(oldData);
+	free(newData);
+	int32_t result = -1;
+	if (!verified)
+	{
+		printf("%s did not survive repacking.  Nothing written.\n", inName);
+	}
+	else
+	{
+		FILE* outFile = fopen(outName, "wb");
+		if (outFile && (fwrite(outImage, 1, outSize, outFile) == outSize))
+			result = 0;
+		else
+			printf("Cannot write %s\n", outName);
+		if (outFile)
+			fclose(outFile);
+	}
+	stats.oldBytes += imageSize;
+	stats.newBytes += outSize;
+	stats.unpackedBytes += oldStats.unpackedBytes;
+	free(outImage);
+	free(image);
+	return (result);
+}
+
+//---------------------------------------------------------------------------
+// Reads every packet through PacketFile, the way the game does.
+bool
+timePacketFile(PacketFile& packetFile, RepackStats& stats, double& seconds)
+{
+	uint8_t* buffer = nullptr;
+	size_t bufferSize = 0;
+	bool ok = true;
+	LARGE_INTEGER startTime;
+	QueryPerformanceCounter(&startTime);
+	for (size_t i = 0; ok && (i < packetFile.getNumPackets()); i++)
+	{
+		packetFile.seekPacket(i);
+		size_t packetSize = packetFile.getPacketSize();
+		if ((packetFile.getStorageType() == STORAGE_TYPE_NUL) || !packetSize)
+			continue;
+		if (bufferSize < packetSize)
+		{
+			free(buffer);
+			bufferSize = packetSize;
+			buffer = (uint8_t*)malloc(bufferSize);
+		}
+		ok = (packetFile.readPacket(i, buffer) == (int32_t)packetSize);
+		stats.unpackedBytes += packetSize;
+	}
+	seconds += timerSeconds(startTime);
+	free(buffer);
+	return ok;
+}
+
+//---------------------------------------------------------------------------
+int32_t
+repackPacketFile(const wchar_t* inName, const wchar_t* outName, RepackStats& stats)
+{
+	PacketFile inFile;
+	if (inFile.open(inName) != NO_ERROR)
+	{
+		printf("%s is not a packet file\n", inName);
+		return (-1);
+	}
+	RepackStats oldStats = {0};
+	if (!timePacketFile(inFile, oldStats, stats.oldSeconds))
+	{
+		printf("%s is damaged\n", inName);
+		return (-1);
+	}
+	PacketFile outFile;
+	if (outFile.create(outName) != NO_ERROR)
+	{
+		printf("Cannot create %s\n", outName);
+		return (-1);
+	}
+	//---------------------------------------------------------
+	// Files within files are copied as they are.  Everything
+	// else is offered to the LZ block codec; writePacket keeps
+	// it RAW if it doesn't get any smaller.
+	int32_t numPackets = inFile.getNumPackets();
+	outFile.reserve(numPackets, inFile.getUsesCheckSum());
+	uint8_t* buffer = nullptr;
+	size_t bufferSize = 0;
+	for (size_t i = 0; i < numPackets; i++)
+	{
+		inFile.seekPacket(i);
+		int32_t storageType = inFile.getStorageType();
+		size_t packetSize = inFile.getPacketSize();
+		if ((storageType == STORAGE_TYPE_NUL) || !packetSize)
+		{
+			outFile.writePacket(i, buffer, 0, STORAGE_TYPE_NUL);
+			continue;
+		}
+		if (bufferSize < packetSize)
+		{
+			free(buffer);
+			bufferSize = packetSize;
+			buffer = (uint8_t*)malloc(bufferSize);
+		}
+		inFile.readPacket(i, buffer);
+		outFile.writePacket(i, buffer, packetSize,
+			(storageType == STORAGE_TYPE_FWF) ? STORAGE_TYPE_FWF : STORAGE_TYPE_LZB);
+	}
+	free(buffer);
+	outFile.close();
+	//-------------------------------------------------------
+	// Read the new one back and compare, packet by packet.
+	int32_t result = 0;
+	if ((outFile.open(outName) != NO_ERROR) || (outFile.getNumPackets() != numPackets))
+	{
+		printf("Cannot reopen %s\n", outName);
+		return (-1);
+	}
+	RepackStats newStats = {0};
+	bool verified = timePacketFile(outFile, newStats, stats.newSeconds);
+	uint8_t* oldData = nullptr;
+	uint8_t* newData = nullptr;
+	for (size_t i = 0; verified && (i < numPackets); i++)
+	{
+		inFile.seekPacket(i);
+		outFile.seekPacket(i);
+		size_t packetSize = inFile.getPacketSize();
+		verified = (outFile.getPacketSize() == (int32_t)packetSize);
+		if (!verified || !packetSize || (inFile.getStorageType() == STORAGE_TYPE_NUL))
+			continue;
+		oldData = (uint8_t*)realloc(oldData, packetSize);
+		newData = (uint8_t*)realloc(newData, packetSize);
+		inFile.readPacket(i, oldData);
+		outFile.readPacket(i, newData);
+		verified = (memcmp(oldData, newData, packetSize) == 0);
+	}
+	free(oldData);
+	free(newData);
+	if (!verified)
+	{
+		printf("%s did not survive repacking.  Remove %s.\n", inName, outName);
+		result = -1;
+	}
+	stats.oldBytes += inFile.getLength();
+	stats.newBytes += outFile.getLength();
+	stats.unpackedBytes += oldStats.unpackedBytes;
+	outFile.close();
+	inFile.close();
+	return (result);
+}
+
+//---------------------------------------------------------------------------
+int32_t
+timeArchive(const wchar_t* fileName, RepackStats& stats)
+{
+	size_t imageSize = 0;
+	uint8_t* image = readWholeFile(fileName, imageSize);
+	if (!image)
+	{
+		printf("Cannot open %s\n", fileName);
+		return (-1);
+	}
+	bool ok = false;
+	double seconds = 0.0;
+	if (isFastFileImage(image, imageSize))
+	{
+		ok = timeFastFile(image, imageSize, stats, seconds);
+	}
+	else
+	{
+		PacketFile packetFile;
+		if (packetFile.open(fileName) == NO_ERROR)
+			ok = timePacketFile(packetFile, stats, seconds);
+	}
+	free(image);
+	stats.oldBytes += imageSize;
+	stats.oldSeconds += seconds;
+	printf("%-40s %10d bytes %8.3f sec %s\n", fileName, (int32_t)imageSize, seconds, ok ? "" : "DAMAGED");
+	return (ok ? 0 : -1);
+}
+
+//---------------------------------------------------------------------------
+double
+megabytesPerSecond(double bytes, double seconds)
+{
+	return ((seconds > 0.0) ? (bytes / (1024.0 * 1024.0) / seconds) : 0.0);
+}
+
+//---------------------------------------------------------------------------
+// LZ codec bench.  Every LZ stream we can find in the archives (old LZ
+// fastfile entries and LZD packets as stored, everything else packed
+// with LZCompress first) is decoded by both the reference decoder and
+// LZDecomp, and both are checked against the unpacked data.
+typedef struct _LZStream
+{
+	uint8_t* packed;
+	size_t packedSize;
+	uint8_t* unpacked;
+	size_t unpackedSize;
+} LZStream;
+
+std::vector<LZStream> lzStreams;
+
+//---------------------------------------------------------------------------
+void
+addLZStream(const uint8_t* unpacked, size_t unpackedSize, const uint8_t* packed, size_t packedSize)
+{
+	LZStream stream;
+	stream.unpackedSize = unpackedSize;
+	stream.unpacked = (uint8_t*)malloc(unpackedSize ? unpackedSize : 1);
+	memcpy(stream.unpacked, unpacked, unpackedSize);
+	if (packed)
+	{
+		stream.packedSize = packedSize;
+		stream.packed = (uint8_t*)malloc(packedSize ? packedSize : 1);
+		memcpy(stream.packed, packed, packedSize);
+	}
+	else
+	{
+		//----------------------------------------------
+		// Twelve bit codes for single bytes at worst,
+		// plus the CLEAR/EOF codes and their slack.
+		stream.packed = (uint8_t*)malloc((unpackedSize * 2) + 1024);
+		stream.packedSize = LZCompress(stream.packed, stream.unpacked, unpackedSize);
+	}
+	lzStreams.push_back(stream);
+}
+
+//---------------------------------------------------------------------------
+int32_t
+collectLZStreams(const wchar_t* fileName)
+{
+	size_t imageSize = 0;
+	uint8_t* image = readWholeFile(fileName, imageSize);
+	if (!image)
+	{
+		printf("Cannot open %s\n", fileName);
+		return (-1);
+	}
+	if (isFastFileImage(image, imageSize))
+	{
+		uint32_t version = ((const uint32_t*)image)[0];
+		int32_t numFiles = ((const int32_t*)image)[1];
+		const FastFileDiskEntry* entries = (const FastFileDiskEntry*)(image + sizeof(int32_t) * 2);
+		for (size_t i = 0; i < numFiles; i++)
+		{
+			const FastFileDiskEntry& entry = entries[i];
+			if ((entry.position < 0) || (entry.size < 0) || ((size_t)entry.position + entry.size > imageSize))
+				break;
+			uint8_t* unpacked = (uint8_t*)malloc(entry.realSize ? entry.realSize : 1);
+			if (unpackFastEntry(version, unpacked, entry, image + entry.position) == (size_t)entry.realSize)
+				addLZStream(unpacked, entry.realSize,
+					(version == FASTFILE_VERSION_LZ) ? (image + entry.position) : nullptr, entry.size);
+			free(unpacked);
+		}
+	}
+	else
+	{
+		PacketFile packetFile;
+		if (packetFile.open(fileName) == NO_ERROR)
+		{
+			for (size_t i = 0; i < packetFile.getNumPackets(); i++)
+			{
+				packetFile.seekPacket(i);
+				int32_t storageType = packetFile.getStorageType();
+				size_t packetSize = packetFile.getPacketSize();
+				size_t packedSize = packetFile.getPackedPacketSize();
+				if ((storageType == STORAGE_TYPE_NUL) || (storageType == STORAGE_TYPE_FWF) || !packetSize)
+					continue;
+				uint8_t* unpacked = (uint8_t*)malloc(packetSize);
+				uint8_t* packed = (uint8_t*)malloc(packedSize);
+				if (packetFile.readPacket(i, unpacked) == (int32_t)packetSize)
+				{
+					if (storageType == STORAGE_TYPE_LZD)
+					{
+						packetFile.readPackedPacket(i, packed);
+						addLZStream(unpacked, packetSize, packed, packedSize - sizeof(int32_t));
+					}
+					else
+					{
+						addLZStream(unpacked, packetSize, nullptr, 0);
+					}
+				}
+				free(packed);
+				free(unpacked);
+			}
+		}
+	}
+	free(image);
+	return (0);
+}
+
+//---------------------------------------------------------------------------
+int32_t
+benchLZStreams(void)
+{
+	double packedBytes = 0.0;
+	double unpackedBytes = 0.0;
+	double referenceSeconds = 0.0;
+	double newSeconds = 0.0;
+	int32_t numBad = 0;
+	for (size_t i = 0; i < lzStreams.size(); i++)
+	{
+		const LZStream& stream = lzStreams[i];
+		//----------------------------------------------------
+		// The reference trusts its input, so give it room
+		// for a stream that says it's bigger than it is.
+		uint8_t* referenceData = (uint8_t*)malloc(stream.unpackedSize + 65536);
+		uint8_t* newData = (uint8_t*)malloc(stream.unpackedSize ? stream.unpackedSize : 1);
+		LARGE_INTEGER startTime;
+		QueryPerformanceCounter(&startTime);
+		size_t referenceSize = LZDecompReference(referenceData, stream.packed, stream.packedSize);
+		referenceSeconds += timerSeconds(startTime);
+		QueryPerformanceCounter(&startTime);
+		size_t newSize = LZDecomp(newData, stream.unpackedSize, stream.packed, stream.packedSize);
+		newSeconds += timerSeconds(startTime);
+		if ((referenceSize != stream.unpackedSize) || (newSize != stream.unpackedSize)
+			|| (memcmp(referenceData, stream.unpacked, stream.unpackedSize) != 0)
+			|| (memcmp(newData, stream.unpacked, stream.unpackedSize) != 0))
+		{
+			printf("  stream %d: reference %d bytes, LZDecomp %d bytes, expected %d\n", (int32_t)i,
+				(int32_t)referenceSize, (int32_t)newSize, (int32_t)stream.unpackedSize);
+			numBad++;
+		}
+		packedBytes += stream.packedSize;
+		unpackedBytes += stream.unpackedSize;
+		free(newData);
+		free(referenceData);
+	}
+	printf("%d LZ streams, %.0f bytes packed, %.0f unpacked, %d mismatched\n",
+		(int32_t)lzStreams.size(), packedBytes, unpackedBytes, numBad);
+	printf("  reference: %8.3f sec %8.1f MB/s\n", referenceSeconds,
+		megabytesPerSecond(unpackedBytes, referenceSeconds));
+	printf("  LZDecomp:  %8.3f sec %8.1f MB/s\n", newSeconds,
+		megabytesPerSecond(unpackedBytes, newSeconds));
+	return (numBad ? -1 : 0);
+}
+
+//---------------------------------------------------------------------------
+// Feeds damaged copies of the real streams to LZDecomp.  Each gets a dest
+// buffer of exactly the right size, so running this under a checked heap
+// (page heap, ASan) catches any read or write out of bounds.
+int32_t
+fuzzLZStreams(int32_t numIterations)
+{
+	if (lzStreams.empty())
+		return (0);
+	int32_t numRejected = 0;
+	srand(0x4C5A);
+	for (size_t i = 0; i < numIterations; i++)
+	{
+		const LZStream& stream = lzStreams[rand() % lzStreams.size()];
+		size_t packedSize = stream.packedSize;
+		uint8_t* packed = (uint8_t*)malloc(packedSize ? packedSize : 1);
+		memcpy(packed, stream.packed, packedSize);
+		int32_t numDamaged = 1 + (rand() % 8);
+		for (size_t j = 0; packedSize && (j < numDamaged); j++)
+		{
+			switch (rand() % 3)
+			{
+			case 0:
+				packed[rand() % packedSize] ^= (uint8_t)(1 << (rand() % 8));
+				break;
+			case 1:
+				packed[rand() % packedSize] = (uint8_t)rand();
+				break;
+			case 2:
+				packedSize = rand() % packedSize;
+				break;
+			}
+		}
+		size_t destLen = stream.unpackedSize;
+		if (rand() & 1)
+			destLen = rand() % (destLen + 1);
+		uint8_t* dest = (uint8_t*)malloc(destLen ? destLen : 1);
+		size_t result = LZDecomp(dest, destLen, packed, packedSize);
+		if (result > destLen)
+		{
+			printf("  iteration %d: LZDecomp claims %d bytes into %d\n", (int32_t)i, (int32_t)result,
+				(int32_t)destLen);
+			free(dest);
+			free(packed);
+			return (-1);
+		}
+		if ((result != stream.unpackedSize) || memcmp(dest, stream.unpacked, result))
+			numRejected++;
+		free(dest);
+		free(packed);
+	}
+	printf("%d damaged streams, %d came out different or were rejected, none overran\n",
+		numIterations, numRejected);
+	return (0);
+}
+
+//---------------------------------------------------------------------------
+extern "C" int __cdecl main(
+	_In_ int argc, _In_reads_(argc) _Pre_z_ wchar_t* argv[], _In_z_ wchar_t** envp)
+{
+	(void)envp;
+
+	//-------------------------------------------------------------
+	// repack <in> <out> rewrites one archive with the LZ block
+	// codec.  repack -time <archive> ... only unpacks archives,
+	// old or new, and reports how long it took.  repack -lzbench
+	// checks LZDecomp against the reference decoder on every LZ
+	// stream in the archives, and -lzfuzz <count> then feeds it
+	// that many damaged copies of them...
+	int32_t numFuzz = 0;
+	bool lzBench = false;
+	if ((argc > 3) && (strcmp(argv[1], "-lzfuzz") == 0))
+	{
+		numFuzz = atoi(argv[2]);
+		lzBench = true;
+		argv++;
+		argc--;
+	}
+	else if ((argc > 2) && (strcmp(argv[1], "-lzbench") == 0))
+	{
+		lzBench = true;
+	}
+	if ((argc < 3) || (!lzBench && (strcmp(argv[1], "-time") != 0) && (argc != 3)))
+	{
+		printf("usage: repack <in.pak|in.fst> <out>\n");
+		printf("       repack -time <archive> [archive...]\n");
+		printf("       repack -lzbench <archive> [archive...]\n");
+		printf("       repack -lzfuzz <count> <archive> [archive...]\n");
+		return (1);
+	}
+	printf("REPACK - MechCommander 2 Archive Repacker v0.1\n");
+	printf("\n");
+	QueryPerformanceFrequency(&timerFrequency);
+	globalHeapList = new HeapList;
+	systemHeap = new UserHeap;
+	systemHeap->init(2048000);
+	RepackStats stats = {0};
+	int32_t result = 0;
+	if (lzBench)
+	{
+		for (size_t i = 2; i < argc; i++)
+			collectLZStreams(argv[i]);
+		if (benchLZStreams() != 0)
+			result = 1;
+		if (numFuzz && (fuzzLZStreams(numFuzz) != 0))
+			result = 1;
+		return (result);
+	}
+	if (strcmp(argv[1], "-time") == 0)
+	{
+		for (size_t i = 2; i < argc; i++)
+			if (timeArchive(argv[i], stats) != 0)
+				result = 1;
+		printf("\n");
+		printf("Unpacked %.0f bytes from %.0f in %.3f sec (%.1f MB/s)\n", stats.unpackedBytes,
+			stats.oldBytes, stats.oldSeconds, megabytesPerSecond(stats.unpackedBytes, stats.oldSeconds));
+		return (result);
+	}
+	size_t imageSize = 0;
+	uint8_t* image = readWholeFile(argv[1], imageSize);
+	bool fastFile = image && isFastFileImage(image, imageSize);
+	free(image);
+	if (fastFile)
+		result = repackFastFile(argv[1], argv[2], stats);
+	else
+		result = repackPacketFile(argv[1], argv[2], stats);
+	if (result != 0)
+		return (1);
+	printf("%s: %.0f -> %.0f bytes (%.1f%%)\n", argv[1], stats.oldBytes, stats.newBytes,
+		(stats.oldBytes > 0.0) ? (100.0 * stats.newBytes / stats.oldBytes) : 0.0);
+	printf("  unpack before: %8.3f sec %8.1f MB/s\n", stats.oldSeconds,
+		megabytesPerSecond(stats.unpackedBytes, stats.oldSeconds));
+	printf("  unpack after:  %8.3f sec %8.1f MB/s\n", stats.newSeconds,
+		megabytesPerSecond(stats.unpackedBytes, stats.newSeconds));
+	return (0);
+}
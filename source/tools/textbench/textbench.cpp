@@ -0,0 +1,265 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+// textbench.cpp : Reads the game's text files (ABL, FIT, CSV and lists) a
+//  line at a time through MechFile::readLine, and the way readLine used to
+//  before it had a read window, and reports how fast each went and how many
+//  reads and seeks each line cost.  Every line is checked against the old
+//  reader.
+//
+
+#include "stdinc.h"
+
+#include "file.h"
+
+#include <chrono>
+#include <fcntl.h>
+#include <io.h>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// Globals the mclib file code expects from its host.
+UserHeapPtr systemHeap = nullptr;
+
+#define TEXTBENCH_LINE 512 // longest line the game's loaders ask for
+
+typedef struct _TextFile
+{
+	stdfs::path path;
+	size_t length;
+	std::vector<uint8_t> image; // the whole file, to check binary reads
+	std::vector<std::string> lines; // as the old reader gave them
+	std::vector<size_t> lineStarts;
+} TextFile;
+
+typedef struct _TextStats
+{
+	double seconds;
+	double bytes;
+	double numLines;
+	double numCalls; // reads and seeks that went to the file
+} TextStats;
+
+std::vector<TextFile> textFiles;
+
+//---------------------------------------------------------------------------
+bool
+isTextFile(const stdfs::path& path)
+{
+	static const wchar_t* extensions[] = {".abl", ".fit", ".csv", ".txt", ".lst"};
+	std::wstring extension = path.extension().wstring();
+	for (size_t i = 0; i < ELEMENTS(extensions); i++)
+		if (_wcsicmp(extension.c_str(), extensions[i]) == 0)
+			return (true);
+	return (false);
+}
+
+//---------------------------------------------------------------------------
+// readLine the way it was: read as much as the line could be, look for the
+// end of it, then seek back to just after it.  Returns how many lines it
+// read, and counts every read and seek.
+size_t
+readLinesOld(TextFile& textFile, bool keepLines, double& numCalls)
+{
+	int32_t handle = _wopen(textFile.path.c_str(), _O_RDONLY | _O_BINARY);
+	if (handle == -1)
+		return (0);
+	uint8_t buffer[TEXTBENCH_LINE + 2];
+	size_t logicalPosition = 0;
+	size_t numLines = 0;
+	while (logicalPosition < textFile.length)
+	{
+		memset(buffer, 0, sizeof(buffer));
+		int32_t maxLength = TEXTBENCH_LINE;
+		int32_t bytesRead = _read(handle, buffer, maxLength);
+		if (maxLength > bytesRead)
+			maxLength = bytesRead;
+		int32_t i = 0;
+		while ((i < maxLength) && (buffer[i] != '\r'))
+			i++;
+		buffer[i++] = 0;
+		if (keepLines)
+		{
+			textFile.lineStarts.push_back(logicalPosition);
+			textFile.lines.push_back((const char*)buffer);
+		}
+		logicalPosition += i;
+		if (buffer[i] == '\n')
+			logicalPosition += 1;
+		_lseek(handle, logicalPosition, SEEK_SET);
+		numCalls += 2;
+		numLines++;
+	}
+	_close(handle);
+	return (numLines);
+}
+
+//---------------------------------------------------------------------------
+// The same lines through MechFile and its read window.  Returns false if
+// any of them came out different.
+bool
+readLinesNew(TextFile& textFile)
+{
+	MechFile file;
+	if (file.open(textFile.path) != NO_ERROR)
+		return (false);
+	uint8_t buffer[TEXTBENCH_LINE + 2];
+	bool passed = true;
+	for (size_t i = 0; i < textFile.lines.size(); i++)
+	{
+		file.readLine(buffer, TEXTBENCH_LINE);
+		if (strcmp((const char*)buffer, textFile.lines[i].c_str()) != 0)
+		{
+			printf("%s line %zu is wrong\n", textFile.path.string().c_str(), i + 1);
+			passed = false;
+			break;
+		}
+	}
+	file.close();
+	return (passed);
+}
+
+//---------------------------------------------------------------------------
+// Jumps about the file, forwards and back, the way the FIT and CSV code
+// does, mixing lines with binary reads so the window has to be dropped.
+bool
+seekLinesNew(TextFile& textFile)
+{
+	MechFile file;
+	if (file.open(textFile.path) != NO_ERROR)
+		return (false);
+	uint8_t buffer[TEXTBENCH_LINE + 2];
+	size_t numLines = textFile.lines.size();
+	bool passed = true;
+	for (size_t step = 0; passed && (step < numLines); step += 7)
+	{
+		size_t line = (step * 31) % numLines;
+		file.seek(textFile.lineStarts[line]);
+		file.readLine(buffer, TEXTBENCH_LINE);
+		passed = (strcmp((const char*)buffer, textFile.lines[line].c_str()) == 0);
+		if (passed && (line + 1 < numLines) && (textFile.lineStarts[line + 1] + 4 <= textFile.length))
+		{
+			//------------------------------------------------------
+			// Whatever starts the next line, as a long, then back to
+			// read that line...
+			int32_t value = file.readLong();
+			passed = (memcmp(&value, &textFile.image[textFile.lineStarts[line + 1]], sizeof(value)) == 0);
+			file.seek(textFile.lineStarts[line + 1]);
+			file.readLine(buffer, TEXTBENCH_LINE);
+			passed = passed && (strcmp((const char*)buffer, textFile.lines[line + 1].c_str()) == 0);
+		}
+		if (!passed)
+			printf("%s line %zu is wrong after a seek\n", textFile.path.string().c_str(), line + 1);
+	}
+	file.close();
+	return (passed);
+}
+
+//---------------------------------------------------------------------------
+void
+findTextFiles(const stdfs::path& path)
+{
+	if (stdfs::is_directory(path))
+	{
+		for (const stdfs::directory_entry& entry : stdfs::recursive_directory_iterator(path))
+			if (entry.is_regular_file() && isTextFile(entry.path()))
+				findTextFiles(entry.path());
+		return;
+	}
+	TextFile textFile;
+	textFile.path = path;
+	textFile.length = (size_t)stdfs::file_size(path);
+	if (!textFile.length)
+		return;
+	textFile.image.resize(textFile.length);
+	FILE* file = _wfopen(path.c_str(), L"rb");
+	if (!file)
+		return;
+	size_t bytesRead = fread(textFile.image.data(), 1, textFile.length, file);
+	fclose(file);
+	if (bytesRead != textFile.length)
+		return;
+	double numCalls = 0.0;
+	if (readLinesOld(textFile, true, numCalls))
+		textFiles.push_back(std::move(textFile));
+}
+
+//---------------------------------------------------------------------------
+void
+printStats(const wchar_t* name, const TextStats& stats)
+{
+	printf("  %s %8.3f sec %8.1f MB/s %6.2f calls per line\n", name, stats.seconds,
+		(stats.seconds > 0.0) ? (stats.bytes / (1024.0 * 1024.0) / stats.seconds) : 0.0,
+		(stats.numLines > 0.0) ? (stats.numCalls / stats.numLines) : 0.0);
+}
+
+//---------------------------------------------------------------------------
+extern "C" int __cdecl main(
+	_In_ int argc, _In_reads_(argc) _Pre_z_ wchar_t* argv[], _In_z_ wchar_t** envp)
+{
+	(void)envp;
+
+	//-------------------------------------------------------------
+	// textbench [-passes <count>] <file|directory> ...  Directories
+	// are searched for .abl, .fit, .csv, .txt and .lst files; point
+	// it at game/data.
+	int32_t numPasses = 20;
+	if ((argc > 3) && (strcmp(argv[1], "-passes") == 0))
+	{
+		numPasses = atoi(argv[2]);
+		argv += 2;
+		argc -= 2;
+	}
+	if ((argc < 2) || (numPasses < 1))
+	{
+		printf("usage: textbench [-passes <count>] <file|directory> [...]\n");
+		return (1);
+	}
+	printf("TEXTBENCH - MechCommander 2 Text Read Benchmark v0.1\n");
+	printf("\n");
+	globalHeapList = new HeapList;
+	systemHeap = new UserHeap;
+	systemHeap->init(2048000);
+	for (size_t i = 1; i < argc; i++)
+		findTextFiles(argv[i]);
+	TextStats oldStats = {0};
+	TextStats newStats = {0};
+	for (size_t i = 0; i < textFiles.size(); i++)
+	{
+		oldStats.bytes += textFiles[i].length;
+		oldStats.numLines += textFiles[i].lines.size();
+	}
+	oldStats.bytes *= numPasses;
+	oldStats.numLines *= numPasses;
+	newStats.bytes = oldStats.bytes;
+	newStats.numLines = oldStats.numLines;
+	printf("%zu files, %.0f lines, %.0f bytes a pass, %d passes\n\n", textFiles.size(),
+		oldStats.numLines / numPasses, oldStats.bytes / numPasses, numPasses);
+	//---------------------------------------------------------
+	// Old way first, then the window.  Both read each file from
+	// the top, line after line, the way the loaders do.
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (size_t pass = 0; pass < numPasses; pass++)
+		for (size_t i = 0; i < textFiles.size(); i++)
+			readLinesOld(textFiles[i], false, oldStats.numCalls);
+	oldStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	bool passed = true;
+	memset(&FileReadStatistics, 0, sizeof(FileReadStatistics));
+	start = std::chrono::steady_clock::now();
+	for (size_t pass = 0; passed && (pass < numPasses); pass++)
+		for (size_t i = 0; passed && (i < textFiles.size()); i++)
+			passed = readLinesNew(textFiles[i]);
+	newStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	newStats.numCalls = FileReadStatistics.numFills + FileReadStatistics.numFlushes;
+	printStats("readLine before:", oldStats);
+	printStats("readLine after: ", newStats);
+	//-------------------------------------------------
+	// Then positions have to hold up under seeks and
+	// binary reads in between lines...
+	for (size_t i = 0; passed && (i < textFiles.size()); i++)
+		passed = seekLinesNew(textFiles[i]);
+	printf("\n%s\n", passed ? "ok" : "FAILED");
+	return (passed ? 0 : 1);
+}
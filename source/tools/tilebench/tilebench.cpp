@@ -0,0 +1,214 @@
+//===========================================================================//
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+//===========================================================================//
+
+// tilebench.cpp : Runs a made up map four times the side of a big mission
+//  map through MapTiles: a lighting pass a row at a time, then frames of
+//  camera and mover motion.  Reports resident memory and page-in times
+//  against the budget, and checks every vertex read against a flat copy.
+//
+
+#include "stdinc.h"
+
+#include "maptiles.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+//---------------------------------------------------------------------------
+// Globals the mclib heap code expects from its host.
+UserHeapPtr systemHeap = nullptr;
+
+#define TILEBENCH_SIDE 480 // 4x the side of a 120 vertex map
+#define TILEBENCH_VIEW 30 // vertices from the camera to the edge of the screen
+#define TILEBENCH_MOVERS 4
+
+std::vector<PostcompVertex> flatMap;
+
+//---------------------------------------------------------------------------
+// Rolling hills, with terrain and textures in patches, so it packs about
+// the way a real map does.
+void
+makeMap(void)
+{
+	flatMap.resize(TILEBENCH_SIDE * TILEBENCH_SIDE);
+	for (size_t y = 0; y < TILEBENCH_SIDE; y++)
+	{
+		for (size_t x = 0; x < TILEBENCH_SIDE; x++)
+		{
+			PostcompVertex& vertex = flatMap[x + (y * TILEBENCH_SIDE)];
+			memset(&vertex, 0, sizeof(PostcompVertex));
+			vertex.elevation = floorf(100.0f * sinf(x * 0.05f) * cosf(y * 0.04f));
+			vertex.vertexNormal.z = 1.0f;
+			vertex.textureData = 0xffff0000 | (((x / 8) + (y / 8)) & 31);
+			vertex.terrainType = ((x / 20) + (y / 30)) % 4;
+			vertex.localRGBLight = 0xffffffff;
+			vertex.water = (vertex.elevation < -50.0f);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+void
+printStats(const wchar_t* name, double seconds)
+{
+	MapTileStats& stats = MapTileStatistics;
+	printf("%s: %.3f sec\n", name, seconds);
+	printf("  resident %u tiles, %u bytes, peak %u bytes, packed %u bytes\n", stats.numResident,
+		stats.residentBytes, stats.peakResidentBytes, stats.packedBytes);
+	printf("  %u prefetched, %u dropped, %u demand page-ins, worst %lld kcycles\n", stats.numPrefetches,
+		stats.numPrefetchesDropped, stats.numDemandPageIns, stats.maxDemandCycles / 1000);
+	printf("  %u evictions, %u repacked, %u slots over budget\n", stats.numEvictions, stats.numRepacks,
+		stats.numOverBudget);
+}
+
+//---------------------------------------------------------------------------
+// Counts start again for each part of the run; what is resident carries on.
+void
+resetStats(void)
+{
+	MapTileStats& stats = MapTileStatistics;
+	stats.peakResidentBytes = stats.residentBytes;
+	stats.numPrefetches = 0;
+	stats.numPrefetchesDropped = 0;
+	stats.numDemandPageIns = 0;
+	stats.numEvictions = 0;
+	stats.numRepacks = 0;
+	stats.numOverBudget = 0;
+	stats.maxDemandCycles = 0;
+}
+
+//---------------------------------------------------------------------------
+// Touches each vertex and its eight neighbours a row at a time, the way
+// MapData::calcLight does, and writes the centre one.
+bool
+lightPass(MapTiles& tiles)
+{
+	for (size_t y = 1; y < (TILEBENCH_SIDE - 1); y++)
+	{
+		tiles.advanceFrame();
+		for (size_t x = 1; x < (TILEBENCH_SIDE - 1); x++)
+		{
+			float elevation = 0.0f;
+			for (int32_t dy = -1; dy <= 1; dy++)
+				for (int32_t dx = -1; dx <= 1; dx++)
+					elevation += tiles.getVertex(x + dx, y + dy)->elevation;
+			PostcompVertex& vertex = flatMap[x + (y * TILEBENCH_SIDE)];
+			vertex.vertexNormal.x = elevation / 9.0f - vertex.elevation;
+			tiles.getVertex(x, y, true)->vertexNormal.x = vertex.vertexNormal.x;
+		}
+	}
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+// The camera drifts across the map and the movers wander around it.  The
+// screen is read every frame, and each mover changes the vertex under it.
+bool
+playFrames(MapTiles& tiles, int32_t numFrames)
+{
+	uint32_t seed = 1;
+	for (size_t frame = 0; frame < numFrames; frame++)
+	{
+		tiles.beginFrame();
+		int32_t cameraX = (int32_t)((TILEBENCH_SIDE / 2) + ((TILEBENCH_SIDE / 2) - 40) * sinf(frame * 0.003f));
+		int32_t cameraY = (int32_t)((TILEBENCH_SIDE / 2) + ((TILEBENCH_SIDE / 2) - 40) * cosf(frame * 0.0021f));
+		tiles.requestArea(cameraX, cameraY, TILEBENCH_VIEW + MAP_TILE_SIDE);
+		int32_t moverX[TILEBENCH_MOVERS];
+		int32_t moverY[TILEBENCH_MOVERS];
+		for (size_t i = 0; i < TILEBENCH_MOVERS; i++)
+		{
+			moverX[i] = (cameraX + ((i * 97) + (frame / 3)) % 200 - 100 + TILEBENCH_SIDE) % TILEBENCH_SIDE;
+			moverY[i] = (cameraY + ((i * 53) + (frame / 5)) % 160 - 80 + TILEBENCH_SIDE) % TILEBENCH_SIDE;
+			tiles.requestArea(moverX[i], moverY[i], MAP_TILE_SIDE >> 2);
+		}
+		for (int32_t y = cameraY - TILEBENCH_VIEW; y < (cameraY + TILEBENCH_VIEW); y++)
+		{
+			for (int32_t x = cameraX - TILEBENCH_VIEW; x < (cameraX + TILEBENCH_VIEW); x++)
+			{
+				if ((x < 0) || (y < 0) || (x >= TILEBENCH_SIDE) || (y >= TILEBENCH_SIDE))
+					continue;
+				if (memcmp(tiles.getVertex(x, y), &flatMap[x + (y * TILEBENCH_SIDE)], sizeof(PostcompVertex)))
+				{
+					printf("vertex %d,%d is wrong in frame %zu\n", x, y, frame);
+					return (false);
+				}
+			}
+		}
+		for (size_t i = 0; i < TILEBENCH_MOVERS; i++)
+		{
+			seed = (seed * 1103515245) + 12345;
+			PostcompVertexPtr vertex = tiles.getVertex(moverX[i], moverY[i], true);
+			vertex->shadow = (seed >> 16) & 1;
+			vertex->elevation += 1.0f;
+			flatMap[moverX[i] + (moverY[i] * TILEBENCH_SIDE)] = *vertex;
+		}
+	}
+	return (true);
+}
+
+//---------------------------------------------------------------------------
+extern "C" int __cdecl main(
+	_In_ int argc, _In_reads_(argc) _Pre_z_ wchar_t* argv[], _In_z_ wchar_t** envp)
+{
+	(void)envp;
+
+	//-------------------------------------------------------------
+	// tilebench [-budget <KB>] [-frames <count>].  The budget is
+	// MapTileBudget in system.cfg; the default is the game's.
+	size_t budget = DEFAULT_MAP_TILE_BUDGET;
+	int32_t numFrames = 2000;
+	while ((argc > 2) && (argv[1][0] == '-'))
+	{
+		if (strcmp(argv[1], "-budget") == 0)
+			budget = (size_t)atoi(argv[2]) * 1024;
+		else if (strcmp(argv[1], "-frames") == 0)
+			numFrames = atoi(argv[2]);
+		else
+			argc = 0;
+		argv += 2;
+		argc -= 2;
+	}
+	if ((argc != 1) || !budget)
+	{
+		printf("usage: tilebench [-budget <KB>] [-frames <count>]\n");
+		return (1);
+	}
+	printf("TILEBENCH - MechCommander 2 Map Tile Benchmark v0.1\n");
+	printf("\n");
+	globalHeapList = new HeapList;
+	systemHeap = new UserHeap;
+	systemHeap->init(2048000);
+	UserHeapPtr tileHeap = new UserHeap;
+	tileHeap->init((uint32_t)(budget * 2) + (TILEBENCH_SIDE * TILEBENCH_SIDE * sizeof(PostcompVertex)), "TILES");
+	makeMap();
+	MapTiles tiles;
+	if (tiles.init(flatMap.data(), TILEBENCH_SIDE, budget, tileHeap) != NO_ERROR)
+	{
+		printf("no room for the tiles\n");
+		return (1);
+	}
+	printf("%dx%d map, %zu bytes flat, %u bytes packed, budget %zu bytes\n\n", TILEBENCH_SIDE,
+		TILEBENCH_SIDE, flatMap.size() * sizeof(PostcompVertex), MapTileStatistics.packedBytes, budget);
+	resetStats();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	bool passed = lightPass(tiles);
+	printStats("lighting pass", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	resetStats();
+	start = std::chrono::steady_clock::now();
+	passed = passed && playFrames(tiles, numFrames);
+	printStats("frames", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	//----------------------------------------------------
+	// Whatever was written has to come back out flat...
+	std::vector<PostcompVertex> unpacked(flatMap.size());
+	tiles.unpack(unpacked.data());
+	if (passed && memcmp(unpacked.data(), flatMap.data(), flatMap.size() * sizeof(PostcompVertex)))
+	{
+		printf("unpacked map is wrong\n");
+		passed = false;
+	}
+	tiles.destroy();
+	printf("\n%s\n", passed ? "ok" : "FAILED");
+	return (passed ? 0 : 1);
+}
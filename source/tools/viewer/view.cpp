@@ -438,8 +438,9 @@ void __stdcall InitializeGameEngine()
 	// Fire up the MC Texture Manager.
 	mcTextureManager = new MC_TextureManager;
 	mcTextureManager->start();
-	// Startup the vertex array pool
-	mcTextureManager->startVertices(500000);
+	// Startup the frame arena for the TGL transforms and vertex arrays
+	frameArena = new FrameArena;
+	frameArena->init(16 * 1024 * 1024, 4 * 1024 * 1024, "FrameArena");
 	//--------------------------------------------------
 	// Setup Mouse Parameters from Prefs.CFG
 	userInput = new UserInput;
@@ -480,6 +481,12 @@ void __stdcall TerminateGameEngine()
 		delete mcTextureManager;
 		mcTextureManager = nullptr;
 	}
+	if (frameArena)
+	{
+		frameArena->destroy();
+		delete frameArena;
+		frameArena = nullptr;
+	}
 	//--------------------------------------------------------------
 	// End the SystemHeap and globalHeapList
 	if (systemHeap)